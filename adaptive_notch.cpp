@@ -0,0 +1,200 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "adaptive_notch.h"
+#include <math.h>
+
+static const float NOTCH_TWO_PI = 6.28318530718f;
+// Power averages span roughly twenty loop samples, about two seconds at the default update rate.
+static const float NOTCH_POWER_ALPHA = 0.05f;
+// Engagement fades in over about twenty samples so the correction never steps when the notch switches in.
+static const float NOTCH_ENGAGE_STEP = 0.05f;
+// Once engaged, the centre only keeps adapting while some tone is still visible; otherwise noise would walk it away.
+static const float NOTCH_ENGAGED_ADAPT_RATIO = 1.5f;
+// Detection must hold for about three seconds so start-up ringing does not engage a half-converged centre.
+static const uint16_t NOTCH_DETECT_HOLD = 30;
+// An engaged notch that sees error power grow this far with no tone at its centre is doing harm and is released.
+static const float NOTCH_RELEASE_GROWTH = 4.0f;
+static const float NOTCH_EPSILON = 1e-9f;
+
+AdaptiveNotchStage::AdaptiveNotchStage() {
+    _params.sampleHz = 10.0f;
+    _params.bandwidthHz = 0.3f;
+    _params.minHz = 0.3f;
+    _params.maxHz = 4.0f;
+    _params.adaptRate = 0.02f;
+    _params.detectRatio = 2.0f;
+    _r = 0.9f;
+    _minA = -2.0f;
+    _maxA = 2.0f;
+    _a = 0.0f;
+    resetState();
+}
+
+void AdaptiveNotchStage::configure(const AdaptiveNotchParams& params) {
+    _params = params;
+    float fs = params.sampleHz > 0.0f ? params.sampleHz : 1.0f;
+    float maxHz = params.maxHz;
+    if (maxHz > fs * 0.45f) maxHz = fs * 0.45f;
+    float minHz = params.minHz;
+    if (minHz < fs * 0.005f) minHz = fs * 0.005f;
+    if (minHz > maxHz) minHz = maxHz;
+    // cos() falls with frequency, so the highest frequency gives the smallest coefficient.
+    _minA = 2.0f * cosf(NOTCH_TWO_PI * maxHz / fs);
+    _maxA = 2.0f * cosf(NOTCH_TWO_PI * minHz / fs);
+
+    float r = 1.0f - ((NOTCH_TWO_PI * 0.5f) * params.bandwidthHz / fs);
+    if (r < 0.5f) r = 0.5f;
+    if (r > 0.995f) r = 0.995f;
+    _r = r;
+    clampCoefficient();
+}
+
+void AdaptiveNotchStage::resetState() {
+    _trackX1 = 0.0f;
+    _trackX2 = 0.0f;
+    _trackPower = 0.0f;
+    _inPower = 0.0f;
+    _outPower = 0.0f;
+    _applyIn1 = 0.0f;
+    _applyIn2 = 0.0f;
+    _applyOut1 = 0.0f;
+    _applyOut2 = 0.0f;
+    _weight = 0.0f;
+    _engaging = false;
+    _detectCount = 0;
+    _engagedPower = 0.0f;
+}
+
+void AdaptiveNotchStage::resetFrequency() {
+    _a = 0.5f * (_minA + _maxA);
+    resetState();
+}
+
+void AdaptiveNotchStage::clampCoefficient() {
+    if (!isfinite(_a)) _a = 0.5f * (_minA + _maxA);
+    if (_a < _minA) _a = _minA;
+    if (_a > _maxA) _a = _maxA;
+}
+
+float AdaptiveNotchStage::track(float error) {
+    if (!isfinite(error)) error = 0.0f;
+    float r = _r;
+    float x = error + (r * _a * _trackX1) - (r * r * _trackX2);
+    float y = x - (_a * _trackX1) + _trackX2;
+
+    float ratio = getPowerRatio();
+    bool adapt = !_engaging || ratio >= NOTCH_ENGAGED_ADAPT_RATIO;
+    _trackPower += NOTCH_POWER_ALPHA * ((_trackX1 * _trackX1) - _trackPower);
+    if (adapt) {
+        // d(y^2)/da is -2*y*x[n-1]; the step is normalised by the recent power so it does not depend on error scale.
+        _a += _params.adaptRate * y * _trackX1 / (_trackPower + NOTCH_EPSILON);
+        clampCoefficient();
+    }
+    _trackX2 = _trackX1;
+    _trackX1 = x;
+    if (!isfinite(_trackX1) || !isfinite(_trackX2)) {
+        _trackX1 = 0.0f;
+        _trackX2 = 0.0f;
+    }
+
+    float dcGain = (1.0f - (r * _a) + (r * r)) / (2.0f - _a);
+    float residual = y * dcGain;
+    _inPower += NOTCH_POWER_ALPHA * ((error * error) - _inPower);
+    _outPower += NOTCH_POWER_ALPHA * ((residual * residual) - _outPower);
+
+    // Engagement holds until reset: a working notch removes the tone that justified it, which must not switch it back out.
+    // It is only dropped when the error grows while nothing remains at the notch centre.
+    float powerRatio = getPowerRatio();
+    if (!_engaging) {
+        if (powerRatio >= _params.detectRatio) {
+            if (_detectCount < NOTCH_DETECT_HOLD) _detectCount++;
+        } else {
+            _detectCount = 0;
+        }
+        if (_detectCount >= NOTCH_DETECT_HOLD) {
+            _engaging = true;
+            _engagedPower = _inPower;
+        }
+    } else if (powerRatio < NOTCH_ENGAGED_ADAPT_RATIO && _inPower > (_engagedPower * NOTCH_RELEASE_GROWTH)) {
+        _engaging = false;
+        _detectCount = 0;
+    }
+
+    if (_engaging) {
+        _weight += NOTCH_ENGAGE_STEP;
+        if (_weight > 1.0f) _weight = 1.0f;
+    } else {
+        _weight -= NOTCH_ENGAGE_STEP;
+        if (_weight < 0.0f) _weight = 0.0f;
+    }
+    return residual;
+}
+
+float AdaptiveNotchStage::apply(float correction) {
+    if (!isfinite(correction)) correction = 0.0f;
+    float r = _r;
+    float dcGain = (1.0f - (r * _a) + (r * r)) / (2.0f - _a);
+    float out = (dcGain * (correction - (_a * _applyIn1) + _applyIn2)) + (r * _a * _applyOut1) - (r * r * _applyOut2);
+    if (!isfinite(out)) {
+        out = correction;
+        _applyOut1 = correction;
+        _applyOut2 = correction;
+    }
+    _applyIn2 = _applyIn1;
+    _applyIn1 = correction;
+    _applyOut2 = _applyOut1;
+    _applyOut1 = out;
+    // The filter always runs so its state is warm when engagement fades in.
+    return correction + (_weight * (out - correction));
+}
+
+float AdaptiveNotchStage::getCentreHz() const {
+    float c = 0.5f * _a;
+    if (c > 1.0f) c = 1.0f;
+    if (c < -1.0f) c = -1.0f;
+    return acosf(c) * _params.sampleHz / NOTCH_TWO_PI;
+}
+
+float AdaptiveNotchStage::getPowerRatio() const {
+    if (_inPower <= NOTCH_EPSILON) return 1.0f;
+    return _inPower / (_outPower + NOTCH_EPSILON);
+}
+
+AdaptiveNotchBank::AdaptiveNotchBank() {
+    _stages = 1;
+}
+
+void AdaptiveNotchBank::configure(const AdaptiveNotchParams& params, uint8_t stages) {
+    if (stages < 1) stages = 1;
+    if (stages > MAX_STAGES) stages = MAX_STAGES;
+    bool changed = stages != _stages;
+    _stages = stages;
+    for (uint8_t i = 0; i < MAX_STAGES; i++) _stage[i].configure(params);
+    if (changed) resetFrequency();
+}
+
+void AdaptiveNotchBank::resetState() {
+    for (uint8_t i = 0; i < MAX_STAGES; i++) _stage[i].resetState();
+}
+
+void AdaptiveNotchBank::resetFrequency() {
+    for (uint8_t i = 0; i < MAX_STAGES; i++) _stage[i].resetFrequency();
+}
+
+float AdaptiveNotchBank::track(float error) {
+    float residual = error;
+    for (uint8_t i = 0; i < _stages; i++) residual = _stage[i].track(residual);
+    return residual;
+}
+
+float AdaptiveNotchBank::apply(float correction) {
+    float out = correction;
+    for (uint8_t i = 0; i < _stages; i++) out = _stage[i].apply(out);
+    return out;
+}
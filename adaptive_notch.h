@@ -0,0 +1,102 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef ADAPTIVE_NOTCH_H
+#define ADAPTIVE_NOTCH_H
+
+#include <stdint.h>
+
+/*
+ * Adaptive notch for the closed-loop speed correction.
+ *
+ * Belt stretch and sprung sub-chassis form lightly damped resonances that the
+ * PID sees as a sustained oscillation in speed error. Each stage runs a
+ * constrained second-order notch over the error signal and adapts its centre
+ * by normalised gradient descent on the notch output power:
+ *
+ *     x[n] = e[n] + r*a*x[n-1] - r^2*x[n-2]
+ *     y[n] = x[n] - a*x[n-1] + x[n-2]          a = 2*cos(w0)
+ *
+ * A matching biquad with the same centre is applied to the correction. It is
+ * scaled for unity gain at DC so the integral term passes untouched, and it is
+ * blended in only while the tracked tone carries a clear share of the error
+ * energy. Stages are cascaded: later stages track what the earlier ones leave.
+ *
+ * Frequencies are in loop samples, so the owner passes the controller update
+ * rate. No Arduino headers are used so resonant plants can be simulated on a host.
+ */
+struct AdaptiveNotchParams {
+    float sampleHz;
+    float bandwidthHz;  // -3 dB width of each notch
+    float minHz;
+    float maxHz;
+    float adaptRate;    // Normalised gradient step, 0-1
+    float detectRatio;  // Error power over residual power needed to engage
+};
+
+class AdaptiveNotchStage {
+public:
+    AdaptiveNotchStage();
+
+    void configure(const AdaptiveNotchParams& params);
+    void resetState();
+    void resetFrequency();
+    // Adapts on one error sample and returns the residual with the tracked tone removed.
+    float track(float error);
+    // Filters one correction sample through the current notch, blended by engagement.
+    float apply(float correction);
+
+    float getCentreHz() const;
+    float getEngagement() const { return _weight; }
+    float getPowerRatio() const;
+    bool isEngaged() const { return _engaging; }
+
+private:
+    void clampCoefficient();
+
+    AdaptiveNotchParams _params;
+    float _a;
+    float _r;
+    float _minA;
+    float _maxA;
+    float _trackX1;
+    float _trackX2;
+    float _trackPower;
+    float _inPower;
+    float _outPower;
+    float _applyIn1;
+    float _applyIn2;
+    float _applyOut1;
+    float _applyOut2;
+    float _weight;
+    bool _engaging;
+    uint16_t _detectCount;
+    float _engagedPower;
+};
+
+class AdaptiveNotchBank {
+public:
+    static const uint8_t MAX_STAGES = 3;
+
+    AdaptiveNotchBank();
+
+    void configure(const AdaptiveNotchParams& params, uint8_t stages);
+    void resetState();
+    void resetFrequency();
+    float track(float error);
+    float apply(float correction);
+
+    uint8_t getStageCount() const { return _stages; }
+    const AdaptiveNotchStage& getStage(uint8_t index) const { return _stage[index]; }
+
+private:
+    AdaptiveNotchStage _stage[MAX_STAGES];
+    uint8_t _stages;
+};
+
+#endif // ADAPTIVE_NOTCH_H
@@ -76,7 +76,14 @@ void AmplifierMonitor::update() {
 }
 
 float AmplifierMonitor::readTmp36C() {
+#if SENSORLESS_SPEED_ENABLE
+    // The sensorless sampling timer switches the shared ADC mux; keep it out until this conversion has been read.
+    noInterrupts();
     int raw = analogRead(PIN_AMP_TEMP);
+    interrupts();
+#else
+    int raw = analogRead(PIN_AMP_TEMP);
+#endif
     // Arduino-Pico uses 10-bit analog reads by default. TMP36 is 500 mV at 0 C with a 10 mV/C slope.
     float voltage = (raw * 3.3f) / 1023.0f;
     return (voltage - 0.5f) * 100.0f;
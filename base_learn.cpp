@@ -0,0 +1,155 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "base_learn.h"
+#include <math.h>
+#include <string.h>
+
+// Two standard errors, roughly a 95% interval once a handful of sessions are in.
+static const float BASE_LEARN_INTERVAL_SIGMAS = 2.0f;
+
+void baseLearnReset(BaseLearnSpeed& speed) {
+    memset(&speed, 0, sizeof(speed));
+}
+
+void baseLearnForgetEstimate(BaseLearnSpeed& speed) {
+    speed.ratioRpmPerHz = 0.0f;
+    speed.ratioSpread = 0.0f;
+    speed.weight = 0.0f;
+}
+
+float baseLearnHalfWidth(const BaseLearnSpeed& speed) {
+    if (!(speed.weight > 0.0f) || !(speed.ratioRpmPerHz > 0.0f)) return -1.0f;
+    // Standard error of a weighted mean, with the faded weight standing in for the session count.
+    float variance = speed.ratioSpread / speed.weight;
+    float standardError = sqrtf(variance / speed.weight);
+    return BASE_LEARN_INTERVAL_SIGMAS * standardError / speed.ratioRpmPerHz;
+}
+
+bool baseLearnSharedRatio(const BaseLearnSpeed speeds[3], float& ratioRpmPerHz, float& halfWidthFraction, float& weight) {
+    ratioRpmPerHz = 0.0f;
+    halfWidthFraction = -1.0f;
+    weight = 0.0f;
+    float weightedSum = 0.0f;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!(speeds[i].weight > 0.0f) || !(speeds[i].ratioRpmPerHz > 0.0f)) continue;
+        weight += speeds[i].weight;
+        weightedSum += speeds[i].weight * speeds[i].ratioRpmPerHz;
+    }
+    if (!(weight > 0.0f)) return false;
+    ratioRpmPerHz = weightedSum / weight;
+
+    // Spread within each speed plus the spread between speeds, so speeds that disagree widen the shared interval.
+    float spread = 0.0f;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (!(speeds[i].weight > 0.0f) || !(speeds[i].ratioRpmPerHz > 0.0f)) continue;
+        float offset = speeds[i].ratioRpmPerHz - ratioRpmPerHz;
+        spread += speeds[i].ratioSpread + speeds[i].weight * offset * offset;
+    }
+    float standardError = sqrtf((spread / weight) / weight);
+    halfWidthFraction = BASE_LEARN_INTERVAL_SIGMAS * standardError / ratioRpmPerHz;
+    return true;
+}
+
+static void addRatio(BaseLearnSpeed& speed, float ratio, float weight, float forget) {
+    // West's weighted update with exponential forgetting.
+    float previousMean = speed.ratioRpmPerHz;
+    speed.weight = (speed.weight * forget) + weight;
+    speed.ratioSpread *= forget;
+    if (!(previousMean > 0.0f)) {
+        speed.ratioRpmPerHz = ratio;
+        return;
+    }
+    speed.ratioRpmPerHz = previousMean + (weight / speed.weight) * (ratio - previousMean);
+    speed.ratioSpread += weight * (ratio - previousMean) * (ratio - speed.ratioRpmPerHz);
+    if (speed.ratioSpread < 0.0f) speed.ratioSpread = 0.0f;
+}
+
+BaseLearnResult baseLearnSession(BaseLearnSpeed speeds[3], uint8_t index, const BaseLearnSession& session, const BaseLearnParams& params) {
+    BaseLearnResult result;
+    memset(&result, 0, sizeof(result));
+    result.baseHz = session.baseHz;
+    if (index > 2 || !(session.baseHz > 0.0f) || !(session.weight > 0.0f) || !isfinite(session.correctionHz)) return result;
+    BaseLearnSpeed& speed = speeds[index];
+
+    // A base that moved since the learner last ran was set by the user; it becomes the new anchor and ends any probation.
+    float baseTolerance = session.baseHz * 1e-5f;
+    if (speed.lastHz > 0.0f && fabsf(session.baseHz - speed.lastHz) > baseTolerance) {
+        speed.anchorHz = session.baseHz;
+        speed.previousHz = 0.0f;
+        speed.probationAbsHz = 0.0f;
+    }
+    if (!(speed.anchorHz > 0.0f)) speed.anchorHz = session.baseHz;
+    speed.lastHz = session.baseHz;
+
+    float absCorrectionHz = fabsf(session.correctionHz);
+    if (speed.probationAbsHz > 0.0f) {
+        if (absCorrectionHz > speed.probationAbsHz + params.rollbackMarginHz && speed.previousHz > 0.0f) {
+            // The estimate that chose the step is suspect, so it goes with the step.
+            result.action = BASE_LEARN_ROLLBACK;
+            result.baseHz = speed.previousHz;
+            speed.lastHz = speed.previousHz;
+            speed.previousHz = 0.0f;
+            speed.probationAbsHz = 0.0f;
+            baseLearnForgetEstimate(speed);
+            return result;
+        }
+        speed.probationAbsHz = 0.0f;
+    }
+
+    float neededHz = session.openLoopHz + session.correctionHz;
+    if (!(neededHz > 0.0f) || !(session.targetRpm > 0.0f)) return result;
+    addRatio(speed, session.targetRpm / neededHz, session.weight, params.forget);
+    result.action = BASE_LEARN_LEARNING;
+
+    float ratio = speed.ratioRpmPerHz;
+    float halfWidth = baseLearnHalfWidth(speed);
+    bool confident = speed.weight >= params.minWeight && halfWidth >= 0.0f && halfWidth <= params.confidenceFraction;
+    if (!confident) {
+        float sharedRatio;
+        float sharedHalfWidth;
+        float sharedWeight;
+        if (!baseLearnSharedRatio(speeds, sharedRatio, sharedHalfWidth, sharedWeight) ||
+            sharedWeight < params.minWeight || sharedHalfWidth > params.confidenceFraction) {
+            return result;
+        }
+        ratio = sharedRatio;
+        halfWidth = sharedHalfWidth;
+        result.usedShared = true;
+    }
+
+    // Open-loop drive scales with the base, so the base that needs no correction is the target speed over the ratio.
+    float scale = session.openLoopHz > 0.0f ? session.baseHz / session.openLoopHz : 1.0f;
+    float proposedHz = (session.targetRpm / ratio) * scale;
+    // Inside the interval the estimate cannot tell the proposal from the current base.
+    if (fabsf(proposedHz - session.baseHz) <= halfWidth * session.baseHz) return result;
+
+    float maxStepHz = session.baseHz * params.maxStepFraction;
+    float nextHz = proposedHz;
+    if (nextHz > session.baseHz + maxStepHz) nextHz = session.baseHz + maxStepHz;
+    if (nextHz < session.baseHz - maxStepHz) nextHz = session.baseHz - maxStepHz;
+    float lowHz = speed.anchorHz * (1.0f - params.maxTotalFraction);
+    float highHz = speed.anchorHz * (1.0f + params.maxTotalFraction);
+    if (session.minHz > lowHz) lowHz = session.minHz;
+    if (session.maxHz > 0.0f && session.maxHz < highHz) highHz = session.maxHz;
+    if (nextHz < lowHz) nextHz = lowHz;
+    if (nextHz > highHz) nextHz = highHz;
+    result.bounded = nextHz != proposedHz;
+    // Pinned at a limit already: nothing to step.
+    if (fabsf(nextHz - session.baseHz) <= baseTolerance) return result;
+
+    result.action = BASE_LEARN_STEP;
+    result.baseHz = nextHz;
+    result.ratioRpmPerHz = ratio;
+    result.halfWidthFraction = halfWidth;
+    speed.previousHz = session.baseHz;
+    // A session that needed almost no correction still leaves the margin to judge the step by.
+    speed.probationAbsHz = absCorrectionHz > 1e-4f ? absCorrectionHz : 1e-4f;
+    speed.lastHz = nextHz;
+    return result;
+}
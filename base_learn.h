@@ -0,0 +1,93 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef BASE_LEARN_H
+#define BASE_LEARN_H
+
+#include <stdint.h>
+
+/*
+ * Continuous base-frequency learning from locked closed-loop sessions.
+ *
+ * A locked session's mean correction says what drive frequency actually held
+ * the target speed, so each session gives one measurement of the drive ratio:
+ * platter RPM per drive hertz, pulley ratio and belt creep included. The ratio
+ * does not depend on the base frequency in use, so measurements stay valid
+ * after the base moves.
+ *
+ * - Estimate: a weighted mean and spread per speed, with older sessions
+ *   faded so a stretching belt is followed. Longer sessions weigh more.
+ * - Shared ratio: the speeds' estimates pooled, with the spread between them
+ *   counted, so a speed that is rarely used can borrow the others' ratio when
+ *   they agree.
+ * - Step: once the confidence interval is tight, the base moves toward the
+ *   frequency the ratio predicts. Each step is limited, and the total is
+ *   limited around the anchor, the base the user last set.
+ * - Rollback: a step is on probation until the next session. If that session
+ *   needs more correction than the one before the step, the step is undone
+ *   and the speed's estimate is discarded.
+ *
+ * No Arduino headers are used so bounds and rollback can be exercised on a host.
+ */
+struct BaseLearnParams {
+    float forget;             // Weight kept by older sessions at each new one, 0-1
+    float minWeight;          // Session weight needed before an estimate is trusted
+    float confidenceFraction; // Largest confidence half-width, as a share of the ratio, that allows a step
+    float maxStepFraction;    // Largest single step, as a share of the base
+    float maxTotalFraction;   // Largest total move from the anchor, as a share of the anchor
+    float rollbackMarginHz;   // Extra correction after a step, over the session before it, that undoes the step
+};
+
+// One speed's learner. Mirrors the persisted per-speed record field for field.
+struct BaseLearnSpeed {
+    float ratioRpmPerHz;   // Weighted mean platter RPM per drive hertz
+    float ratioSpread;     // Weighted sum of squared deviations about the mean
+    float weight;          // Faded session weight behind the estimate
+    float anchorHz;        // Base the user last set; steps stay within the total limit of it. 0 until learning starts
+    float lastHz;          // Base after the learner last ran; a different base means the user changed it
+    float previousHz;      // Base before the step on probation
+    float probationAbsHz;  // Mean absolute correction of the session before the step; 0 when no step is on probation
+};
+
+enum BaseLearnAction : uint8_t {
+    BASE_LEARN_NONE = 0,   // Session not usable
+    BASE_LEARN_LEARNING,   // Session added; estimate not yet confident, or the base is already within it
+    BASE_LEARN_STEP,       // Base moved; the new base is on probation
+    BASE_LEARN_ROLLBACK    // Step on probation made correction worse and was undone
+};
+
+struct BaseLearnSession {
+    float targetRpm;     // Closed-loop target held through the session
+    float openLoopHz;    // Drive frequency before correction
+    float correctionHz;  // Mean closed-loop correction while locked
+    float weight;        // Session weight, 1 for a full-length session
+    float baseHz;        // Speed's base frequency setting now
+    float minHz;         // Speed's frequency limits
+    float maxHz;
+};
+
+struct BaseLearnResult {
+    uint8_t action;
+    float baseHz;              // Base to use from now on; unchanged unless action is STEP or ROLLBACK
+    float ratioRpmPerHz;       // Ratio behind a step, 0 otherwise
+    float halfWidthFraction;   // Confidence half-width of that ratio
+    bool usedShared;           // Step used the shared ratio because this speed's own was not yet confident
+    bool bounded;              // Step was cut short by the step, total or frequency limit
+};
+
+void baseLearnReset(BaseLearnSpeed& speed);
+// Forgets the ratio estimate; anchor and probation state are kept.
+void baseLearnForgetEstimate(BaseLearnSpeed& speed);
+// Confidence half-width of a speed's ratio as a share of the ratio; negative when there is no estimate.
+float baseLearnHalfWidth(const BaseLearnSpeed& speed);
+// Pools the three speeds. Returns false when none has an estimate.
+bool baseLearnSharedRatio(const BaseLearnSpeed speeds[3], float& ratioRpmPerHz, float& halfWidthFraction, float& weight);
+// Feeds one finished session for one speed, and decides whether that speed's base moves.
+BaseLearnResult baseLearnSession(BaseLearnSpeed speeds[3], uint8_t speed, const BaseLearnSession& session, const BaseLearnParams& params);
+
+#endif // BASE_LEARN_H
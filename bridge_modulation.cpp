@@ -0,0 +1,41 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "bridge_modulation.h"
+#include <math.h>
+
+int32_t bridgeModulationCounts(float ns, float periodHz, int32_t top) {
+    float counts = ns * 1e-9f * periodHz * ((float)top + 1.0f);
+    if (!isfinite(counts) || counts <= 0.0f) return 0;
+    return (int32_t)ceilf(counts);
+}
+
+float bridgeModulationPeakLimit(const BridgeModulationParams& params, int32_t top, const float* phaseDegrees, uint8_t legs) {
+    int32_t low = params.minOnCounts > 0 ? params.minOnCounts : 0;
+    int32_t high = top - (params.minOffCounts > 0 ? params.minOffCounts : 0);
+    if (high < low) high = low;
+    int32_t mid = (top + 1) / 2;
+    float unit = (float)(mid - 1);
+    if (!(unit > 0.0f)) return 0.0f;
+    int32_t perLeg = mid - low < high - mid ? mid - low : high - mid;
+    float legLimit = perLeg > 0 ? (float)perLeg / unit : 0.0f;
+    if (params.mode == BRIDGE_MODULATION_SINE || legs < 2) return legLimit;
+
+    // The widest spread between unit sines over a cycle is that of the pair furthest apart: 2 |sin(difference / 2)|.
+    float widest = 0.0f;
+    for (uint8_t i = 0; i < legs; i++) {
+        for (uint8_t j = (uint8_t)(i + 1); j < legs; j++) {
+            float spread = 2.0f * fabsf(sinf((phaseDegrees[i] - phaseDegrees[j]) * 3.14159265f / 360.0f));
+            if (spread > widest) widest = spread;
+        }
+    }
+    // Legs in phase are never moved, so only the per-leg window applies to them. Rounding each leg to a count can
+    // widen the spread by one.
+    if (widest < 1e-3f || high - low < 1) return legLimit;
+    return (float)(high - low - 1) / (widest * unit);
+}
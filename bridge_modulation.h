@@ -0,0 +1,139 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef BRIDGE_MODULATION_H
+#define BRIDGE_MODULATION_H
+
+#include <stdint.h>
+
+/*
+ * Duty limits and common-mode placement for the 3PWM bridge.
+ *
+ * The motor is wired only between bridge legs, so what drives it are the
+ * differences between leg duties. Adding the same offset to every leg leaves
+ * each line-to-line voltage unchanged. A plain sine about 50% wastes that
+ * freedom: at high modulation one leg's peak approaches 100% duty. There the
+ * low-side switch barely turns on, so the bootstrap capacitor feeding the
+ * high-side gate drive is not recharged, and the driver emits pulses narrower
+ * than it can reproduce.
+ *
+ * Every leg is kept either fully off or inside [minOn, top - minOff]:
+ *
+ * - Sine: the legacy placement about 50%, clamped to the window per leg.
+ * - Centred: the offset puts the midpoint of the highest and lowest leg in
+ *   the middle of the window. For three phases this is the min-max
+ *   injection equivalent to space-vector modulation, and gives 2/sqrt(3) the
+ *   line-to-line voltage of a sine in the same window.
+ * - Bottom clamp: the lowest leg is held fully off, so its low side conducts
+ *   the whole period and its bootstrap is refreshed. Each leg also switches
+ *   for only two thirds of the cycle. Where that would leave another leg
+ *   with a narrow pulse or above the window, the centred placement is used
+ *   for that sample instead.
+ *
+ * When the spread between legs exceeds the window, the deviations are scaled
+ * down together about their midpoint. This reduces every line-to-line voltage
+ * by the same ratio, so the direction of the drive vector is kept. Legs that
+ * are all equal, the zero-amplitude neutral hold included, are left where
+ * they are.
+ *
+ * No Arduino headers are used so the placement and the resulting line-to-line voltages can be checked on a host.
+ */
+enum BridgeModulationMode : uint8_t {
+    BRIDGE_MODULATION_SINE = 0,
+    BRIDGE_MODULATION_CENTRED,
+    BRIDGE_MODULATION_BOTTOM_CLAMP
+};
+
+struct BridgeModulationParams {
+    uint8_t mode;          // BridgeModulationMode
+    int32_t minOnCounts;   // Shortest high-side pulse the driver reproduces
+    int32_t minOffCounts;  // Low-side time every period needs for the bootstrap to recharge
+};
+
+static inline void bridgeCentreLegs(int32_t* duty, uint8_t legs, int32_t low, int32_t high, int32_t minDuty, int32_t maxDuty, uint8_t& clipped) {
+    int32_t spread = maxDuty - minDuty;
+    int32_t window = high - low;
+    // Doubled midpoints keep the half-count exact until the final shift.
+    int32_t centre2 = low + high;
+    int32_t mid2 = minDuty + maxDuty;
+    if (spread > window) {
+        // The highest and lowest legs are the ones held at the window's edges.
+        for (uint8_t i = 0; i < legs; i++) {
+            if (duty[i] == minDuty || duty[i] == maxDuty) clipped |= (uint8_t)(1u << i);
+            int32_t scaled = ((2 * duty[i] - mid2) * window) / spread;
+            duty[i] = (centre2 + scaled) / 2;
+        }
+        return;
+    }
+    // Rounding down keeps both extremes inside the window whatever the parity.
+    int32_t offset = (centre2 - mid2) >> 1;
+    for (uint8_t i = 0; i < legs; i++) duty[i] += offset;
+}
+
+// Places the legs' duties, in counts of a period of top + 1, in place. Returns a mask, bit i for leg i, of the legs held
+// at a limit, so it is zero unless a line-to-line voltage had to be reduced to fit. Legs must number at most 8.
+// Inline because it runs for every sample in the RAM-resident buffer fill.
+static inline uint8_t bridgeModulate(int32_t* duty, uint8_t legs, int32_t top, const BridgeModulationParams& params) {
+    if (legs == 0) return 0;
+    int32_t low = params.minOnCounts > 0 ? params.minOnCounts : 0;
+    int32_t high = top - (params.minOffCounts > 0 ? params.minOffCounts : 0);
+    if (high < low) high = low;
+
+    int32_t minDuty = duty[0];
+    int32_t maxDuty = duty[0];
+    for (uint8_t i = 1; i < legs; i++) {
+        if (duty[i] < minDuty) minDuty = duty[i];
+        if (duty[i] > maxDuty) maxDuty = duty[i];
+    }
+
+    uint8_t clipped = 0;
+    if (params.mode == BRIDGE_MODULATION_SINE || minDuty == maxDuty) {
+        // Nothing to place: only the per-leg window applies.
+    } else if (params.mode == BRIDGE_MODULATION_BOTTOM_CLAMP) {
+        int32_t spread = maxDuty - minDuty;
+        bool fits = spread <= high;
+        for (uint8_t i = 0; i < legs && fits; i++) {
+            int32_t above = duty[i] - minDuty;
+            if (above > 0 && above < low) fits = false;
+        }
+        if (fits) {
+            for (uint8_t i = 0; i < legs; i++) duty[i] -= minDuty;
+            return 0;
+        }
+        bridgeCentreLegs(duty, legs, low, high, minDuty, maxDuty, clipped);
+    } else {
+        bridgeCentreLegs(duty, legs, low, high, minDuty, maxDuty, clipped);
+    }
+
+    // Sine placement clamps here; centred legs are already inside the window.
+    for (uint8_t i = 0; i < legs; i++) {
+        if (duty[i] < low) {
+            duty[i] = low;
+            clipped |= (uint8_t)(1u << i);
+        } else if (duty[i] > high) {
+            duty[i] = high;
+            clipped |= (uint8_t)(1u << i);
+        }
+    }
+    return clipped;
+}
+
+/*
+ * Largest sine peak each leg can be given, as a fraction of the sine's full
+ * scale of mid - 1 counts about mid = (top + 1) / 2, before placement has to
+ * reduce anything. Legs are equal sines at phaseDegrees. Sine placement
+ * allows the per-leg window. Centred and bottom-clamp placement only need
+ * the spread between legs to fit the window: 2/sqrt(3) of the sine limit
+ * for three phases 120 degrees apart.
+ */
+float bridgeModulationPeakLimit(const BridgeModulationParams& params, int32_t top, const float* phaseDegrees, uint8_t legs);
+
+// Converts a time to counts of the PWM counter, rounded up so the limit is never shortened.
+int32_t bridgeModulationCounts(float ns, float periodHz, int32_t top);
+
+#endif // BRIDGE_MODULATION_H
@@ -0,0 +1,113 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "bus_voltage.h"
+#include <math.h>
+
+BusVoltageSupervisor::BusVoltageSupervisor() {
+    _params.nominalV = 12.0f;
+    _params.filterSec = 0.2f;
+    _params.fastSec = 0.005f;
+    _params.minScale = 0.6f;
+    _params.maxScale = 1.3f;
+    _params.overVoltageV = 16.0f;
+    _params.underVoltageV = 9.0f;
+    _params.hysteresisV = 0.5f;
+    _params.rideThroughSec = 0.2f;
+    reset();
+}
+
+void BusVoltageSupervisor::configure(const BusVoltageParams& params) {
+    _params = params;
+    if (!(_params.nominalV > 0.0f)) _params.nominalV = 12.0f;
+    if (!(_params.filterSec > 0.0f)) _params.filterSec = 0.2f;
+    if (!(_params.fastSec > 0.0f)) _params.fastSec = 0.005f;
+    if (!(_params.minScale > 0.0f) || _params.minScale > 1.0f) _params.minScale = 1.0f;
+    if (!(_params.maxScale >= 1.0f)) _params.maxScale = 1.0f;
+    if (!(_params.hysteresisV >= 0.0f)) _params.hysteresisV = 0.0f;
+    if (!(_params.rideThroughSec >= 0.0f)) _params.rideThroughSec = 0.0f;
+}
+
+void BusVoltageSupervisor::reset() {
+    _primed = false;
+    _state = BUS_VOLTAGE_NORMAL;
+    _slowV = 0.0f;
+    _fastV = 0.0f;
+    _scale = 1.0f;
+    _minV = 0.0f;
+    _maxV = 0.0f;
+    _dipSec = 0.0f;
+    _longestDipSec = 0.0f;
+    _dipsRiddenThrough = 0;
+    _underVoltageEvents = 0;
+    _overVoltageEvents = 0;
+}
+
+BusVoltageState BusVoltageSupervisor::update(float volts, float dtSec) {
+    if (!isfinite(volts)) return _state;
+    if (!_primed) {
+        _slowV = volts;
+        _fastV = volts;
+        _minV = volts;
+        _maxV = volts;
+        _primed = true;
+        dtSec = 0.0f;
+    } else {
+        if (!(dtSec > 0.0f)) return _state;
+        _fastV += (dtSec / (_params.fastSec + dtSec)) * (volts - _fastV);
+    }
+    if (_fastV < _minV) _minV = _fastV;
+    if (_fastV > _maxV) _maxV = _fastV;
+
+    if (_fastV >= _params.overVoltageV) {
+        if (_state != BUS_VOLTAGE_OVERVOLTAGE) _overVoltageEvents++;
+        _state = BUS_VOLTAGE_OVERVOLTAGE;
+    } else if (_state == BUS_VOLTAGE_OVERVOLTAGE) {
+        if (_fastV <= _params.overVoltageV - _params.hysteresisV) _state = BUS_VOLTAGE_NORMAL;
+    } else if (_state == BUS_VOLTAGE_NORMAL) {
+        if (_fastV < _params.underVoltageV) {
+            _state = BUS_VOLTAGE_DIP;
+            _dipSec = 0.0f;
+        }
+    } else {
+        bool recovered = _fastV >= _params.underVoltageV + _params.hysteresisV;
+        if (_state == BUS_VOLTAGE_DIP) {
+            _dipSec += dtSec;
+            if (_dipSec > _longestDipSec) _longestDipSec = _dipSec;
+            if (recovered) {
+                _dipsRiddenThrough++;
+                _state = BUS_VOLTAGE_NORMAL;
+            } else if (_dipSec >= _params.rideThroughSec) {
+                _underVoltageEvents++;
+                _state = BUS_VOLTAGE_UNDERVOLTAGE;
+            }
+        } else if (recovered) {
+            _state = BUS_VOLTAGE_NORMAL;
+        }
+    }
+
+    // A dip freezes the feed-forward so recovery resumes from the pre-dip scale instead of a boost sized for the sag.
+    if (_state == BUS_VOLTAGE_NORMAL || _state == BUS_VOLTAGE_OVERVOLTAGE) {
+        if (dtSec > 0.0f) _slowV += (dtSec / (_params.filterSec + dtSec)) * (volts - _slowV);
+        _scale = targetScale();
+    }
+    return _state;
+}
+
+float BusVoltageSupervisor::targetScale() const {
+    if (!(_slowV > 0.0f)) return _params.maxScale;
+    float scale = _params.nominalV / _slowV;
+    if (scale < _params.minScale) scale = _params.minScale;
+    if (scale > _params.maxScale) scale = _params.maxScale;
+    return scale;
+}
+
+float busVoltageFromAdc(int raw, float dividerRatio) {
+    // Arduino-Pico analog reads are 10-bit by default.
+    return ((float)raw * 3.3f / 1023.0f) * dividerRatio;
+}
@@ -0,0 +1,93 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef BUS_VOLTAGE_H
+#define BUS_VOLTAGE_H
+
+#include <stdint.h>
+
+/*
+ * DC bus supervision and supply feed-forward for a PWM bridge.
+ *
+ * Bridge phase voltage is duty times bus voltage, so a sagging supply or a
+ * different power brick changes motor torque at the same commanded
+ * amplitude. The supervisor keeps two filters of the sampled bus: a slow one
+ * that sets a feed-forward scale of nominal over measured, and a fast one for
+ * limit checks.
+ *
+ * Over-voltage is reported as soon as the fast filter crosses the limit,
+ * typically regenerated braking energy with nowhere to go. An undervoltage
+ * first counts as a dip: the scale is frozen at its pre-dip value so drive
+ * does not chase a collapsing supply, and only a dip longer than the
+ * ride-through time becomes an undervoltage fault. Both clear with
+ * hysteresis.
+ *
+ * No Arduino headers are used so recorded or synthetic bus traces can be replayed on a host.
+ */
+struct BusVoltageParams {
+    float nominalV;      // Bus voltage the tune was made at; the scale is 1 here
+    float filterSec;     // Time constant of the feed-forward filter
+    float fastSec;       // Time constant of the limit-check filter
+    float minScale;      // Floor for the scale when the bus is high
+    float maxScale;      // Ceiling for the scale when the bus sags
+    float overVoltageV;
+    float underVoltageV;
+    float hysteresisV;   // Distance back inside a limit before it clears
+    float rideThroughSec;
+};
+
+enum BusVoltageState : uint8_t {
+    BUS_VOLTAGE_NORMAL = 0,
+    BUS_VOLTAGE_DIP,          // Under the limit, still inside the ride-through time
+    BUS_VOLTAGE_UNDERVOLTAGE, // Dip outlasted the ride-through time
+    BUS_VOLTAGE_OVERVOLTAGE
+};
+
+class BusVoltageSupervisor {
+public:
+    BusVoltageSupervisor();
+
+    void configure(const BusVoltageParams& params);
+    void reset();
+    // Returns the state after this sample. dtSec is the time since the previous sample.
+    BusVoltageState update(float volts, float dtSec);
+
+    BusVoltageState getState() const { return _state; }
+    float getScale() const { return _scale; }
+    float getFilteredV() const { return _slowV; }
+    float getFastV() const { return _fastV; }
+    float getMinV() const { return _minV; }
+    float getMaxV() const { return _maxV; }
+    float getDipSec() const { return _dipSec; }
+    float getLongestDipSec() const { return _longestDipSec; }
+    uint32_t getDipsRiddenThrough() const { return _dipsRiddenThrough; }
+    uint32_t getUnderVoltageEvents() const { return _underVoltageEvents; }
+    uint32_t getOverVoltageEvents() const { return _overVoltageEvents; }
+
+private:
+    float targetScale() const;
+
+    BusVoltageParams _params;
+    bool _primed;
+    BusVoltageState _state;
+    float _slowV;
+    float _fastV;
+    float _scale;
+    float _minV;
+    float _maxV;
+    float _dipSec;
+    float _longestDipSec;
+    uint32_t _dipsRiddenThrough;
+    uint32_t _underVoltageEvents;
+    uint32_t _overVoltageEvents;
+};
+
+// Bus volts for a 10-bit ADC reading referenced to the 3.3 V supply, behind a divider of dividerRatio bus volts per pin volt.
+float busVoltageFromAdc(int raw, float dividerRatio);
+
+#endif // BUS_VOLTAGE_H
@@ -0,0 +1,25 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "closed_loop_bumpless.h"
+#include <math.h>
+
+float bumplessIntegralHz(const BumplessGains& gains, float correctionHz, float errorRpm) {
+    if (gains.ki <= 0.0f || gains.integralLimitHz <= 0.0f) return 0.0f;
+    // The PID applies the same deadband, so the proportional share is taken on the error it will actually see.
+    if (fabs(errorRpm) < gains.deadbandRpm) errorRpm = 0.0f;
+    float integralHz = correctionHz - gains.kp * errorRpm;
+    if (integralHz > gains.integralLimitHz) integralHz = gains.integralLimitHz;
+    if (integralHz < -gains.integralLimitHz) integralHz = -gains.integralLimitHz;
+    return integralHz;
+}
+
+float bumplessCarryHz(float correctionHz, float fromOpenLoopHz, float toOpenLoopHz) {
+    if (!(fromOpenLoopHz > 0.0f) || !(toOpenLoopHz > 0.0f)) return 0.0f;
+    return correctionHz * (toOpenLoopHz / fromOpenLoopHz);
+}
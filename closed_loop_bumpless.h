@@ -0,0 +1,39 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef CLOSED_LOOP_BUMPLESS_H
+#define CLOSED_LOOP_BUMPLESS_H
+
+/*
+ * Bumpless transfer for the closed-loop speed PID.
+ *
+ * Whenever the loop takes over a correction it did not form itself, on
+ * engaging, at the end of a ramp, after a settings edit or a pitch jump, the
+ * integral is back-calculated so that the next output equals the correction
+ * already applied. The integral takes whatever the proportional term does
+ * not, clamped to its limit. Without an integral term there is nothing to
+ * hold the correction, and the loop starts from zero as before.
+ *
+ * Across a speed change the correction is carried to the new drive
+ * frequency in proportion, since slip and pulley error scale with it.
+ *
+ * No Arduino headers are used so speed handovers can be simulated on a host.
+ */
+struct BumplessGains {
+    float kp;
+    float ki;
+    float deadbandRpm;
+    float integralLimitHz;
+};
+
+// Integral that makes the PID's output equal correctionHz at errorRpm, or 0 when the integral term is off.
+float bumplessIntegralHz(const BumplessGains& gains, float correctionHz, float errorRpm);
+// Correction carried from one open-loop drive frequency to another, or 0 when either is not positive.
+float bumplessCarryHz(float correctionHz, float fromOpenLoopHz, float toOpenLoopHz);
+
+#endif // CLOSED_LOOP_BUMPLESS_H
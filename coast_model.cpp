@@ -0,0 +1,151 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "coast_model.h"
+#include <math.h>
+
+// Rates below these limits are treated as absent so the closed-form timings never divide by numerical noise.
+static const double COAST_FIT_MIN_DETERMINANT = 1e-12;
+static const float COAST_MODEL_MIN_RATE = 1e-6f;
+// A purely viscous decay never reaches zero; report the time to fall to 1% of the starting speed instead.
+static const float COAST_MODEL_VISCOUS_STOP_LOG = 4.6051702f; // ln(100)
+
+CoastDownFit::CoastDownFit() {
+    reset();
+}
+
+void CoastDownFit::reset() {
+    _sampleCount = 0;
+    _startTimeSec = 0.0f;
+    _startRpm = 0.0f;
+    _lastTimeSec = 0.0f;
+    _lastRpm = 0.0f;
+    _integral = 0.0;
+    _sumII = 0.0;
+    _sumIT = 0.0;
+    _sumTT = 0.0;
+    _sumYI = 0.0;
+    _sumYT = 0.0;
+    _sumY = 0.0;
+    _sumYY = 0.0;
+}
+
+void CoastDownFit::addSample(float timeSec, float rpm) {
+    if (!isfinite(timeSec) || !isfinite(rpm) || rpm < 0.0f) return;
+    if (_sampleCount == 0) {
+        _startTimeSec = timeSec;
+        _startRpm = rpm;
+        _lastTimeSec = timeSec;
+        _lastRpm = rpm;
+        _sampleCount = 1;
+        return;
+    }
+    if (timeSec <= _lastTimeSec || _sampleCount == UINT16_MAX) return;
+
+    // Trapezoidal integration keeps the regressor smooth even when individual RPM samples are quantised.
+    _integral += 0.5 * ((double)rpm + (double)_lastRpm) * (double)(timeSec - _lastTimeSec);
+    double t = (double)(timeSec - _startTimeSec);
+    double y = (double)rpm - (double)_startRpm;
+    _sumII += _integral * _integral;
+    _sumIT += _integral * t;
+    _sumTT += t * t;
+    _sumYI += y * _integral;
+    _sumYT += y * t;
+    _sumY += y;
+    _sumYY += y * y;
+
+    _lastTimeSec = timeSec;
+    _lastRpm = rpm;
+    _sampleCount++;
+}
+
+bool CoastDownFit::solve(CoastDownFitResult& out) const {
+    out.valid = false;
+    out.viscousPerSec = 0.0f;
+    out.coulombRpmPerSec = 0.0f;
+    out.startRpm = _startRpm;
+    out.durationSec = _sampleCount > 1 ? _lastTimeSec - _startTimeSec : 0.0f;
+    out.rSquared = 0.0f;
+    out.sampleCount = _sampleCount;
+    if (_sampleCount < 3 || _sumTT <= 0.0 || _sumII <= 0.0) return false;
+
+    // Normal equations for y = -b*I - c*t. Negative terms are physically meaningless, so each is dropped in turn and the other refitted alone.
+    double b = 0.0;
+    double c = 0.0;
+    double det = (_sumII * _sumTT) - (_sumIT * _sumIT);
+    if (fabs(det) > COAST_FIT_MIN_DETERMINANT * _sumII * _sumTT) {
+        b = -((_sumYI * _sumTT) - (_sumYT * _sumIT)) / det;
+        c = -((_sumYT * _sumII) - (_sumYI * _sumIT)) / det;
+    }
+    if (b <= 0.0 || c < 0.0) {
+        double viscousOnly = -_sumYI / _sumII;
+        double coulombOnly = -_sumYT / _sumTT;
+        double sseViscous = _sumYY + (2.0 * viscousOnly * _sumYI) + (viscousOnly * viscousOnly * _sumII);
+        double sseCoulomb = _sumYY + (2.0 * coulombOnly * _sumYT) + (coulombOnly * coulombOnly * _sumTT);
+        if (viscousOnly > 0.0 && (coulombOnly <= 0.0 || sseViscous <= sseCoulomb)) {
+            b = viscousOnly;
+            c = 0.0;
+        } else if (coulombOnly > 0.0) {
+            b = 0.0;
+            c = coulombOnly;
+        } else {
+            return false;
+        }
+    }
+
+    double sse = _sumYY + (2.0 * b * _sumYI) + (2.0 * c * _sumYT) +
+        (b * b * _sumII) + (2.0 * b * c * _sumIT) + (c * c * _sumTT);
+    double n = (double)(_sampleCount - 1);
+    double sst = _sumYY - ((_sumY * _sumY) / n);
+    out.viscousPerSec = (float)b;
+    out.coulombRpmPerSec = (float)c;
+    out.rSquared = sst > 0.0 ? (float)(1.0 - (sse / sst)) : 0.0f;
+    if (out.rSquared < 0.0f) out.rSquared = 0.0f;
+    out.valid = isfinite(out.viscousPerSec) && isfinite(out.coulombRpmPerSec) &&
+        (out.viscousPerSec > COAST_MODEL_MIN_RATE || out.coulombRpmPerSec > COAST_MODEL_MIN_RATE);
+    return out.valid;
+}
+
+float coastDownDecelRpmPerSec(const CoastDownFitResult& model, float rpm) {
+    if (!model.valid) return 0.0f;
+    return (model.viscousPerSec * fabsf(rpm)) + model.coulombRpmPerSec;
+}
+
+float coastDownStopSeconds(const CoastDownFitResult& model, float rpm) {
+    float w = fabsf(rpm);
+    float b = model.viscousPerSec;
+    float c = model.coulombRpmPerSec;
+    if (!model.valid || w <= 0.0f) return 0.0f;
+    if (c > COAST_MODEL_MIN_RATE) {
+        return b > COAST_MODEL_MIN_RATE ? logf(1.0f + ((b * w) / c)) / b : w / c;
+    }
+    return b > COAST_MODEL_MIN_RATE ? COAST_MODEL_VISCOUS_STOP_LOG / b : 0.0f;
+}
+
+float coastDownSpinUpSeconds(const CoastDownFitResult& model, float rpm, float torqueMargin) {
+    // Drive torque is torqueMargin times the running loss; the net surplus shrinks as viscous drag rises with speed.
+    float w = fabsf(rpm);
+    float b = model.viscousPerSec;
+    float c = model.coulombRpmPerSec;
+    if (!model.valid || w <= 0.0f || !(torqueMargin > 1.0f)) return 0.0f;
+    float drive = (torqueMargin * coastDownDecelRpmPerSec(model, w)) - c;
+    if (drive <= 0.0f) return 0.0f;
+    if (b <= COAST_MODEL_MIN_RATE) return w / drive;
+    return -logf(1.0f - ((b * w) / drive)) / b;
+}
+
+float coastDownBrakeSeconds(const CoastDownFitResult& model, float rpm, float torqueMargin) {
+    // Braking torque adds to both friction terms, so the stop is always shorter than a free coast.
+    float w = fabsf(rpm);
+    float b = model.viscousPerSec;
+    if (!model.valid || w <= 0.0f || torqueMargin < 0.0f) return 0.0f;
+    float constantDecel = (torqueMargin * coastDownDecelRpmPerSec(model, w)) + model.coulombRpmPerSec;
+    if (constantDecel <= COAST_MODEL_MIN_RATE) return coastDownStopSeconds(model, w);
+    if (b <= COAST_MODEL_MIN_RATE) return w / constantDecel;
+    return logf(1.0f + ((b * w) / constantDecel)) / b;
+}
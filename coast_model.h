@@ -0,0 +1,76 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef COAST_MODEL_H
+#define COAST_MODEL_H
+
+#include <stdint.h>
+
+/*
+ * Coast-down model for a free-running platter:
+ *
+ *     J * dw/dt = -B * w - Tc
+ *
+ * A passive coast cannot separate inertia from torque, so the fit reports the
+ * inertia-normalised terms: the viscous rate B/J (1/s, the inverse of the
+ * mechanical time constant) and the Coulomb deceleration Tc/J (rpm/s). Those
+ * ratios are all the start/stop timing seeds need.
+ *
+ * This file deliberately avoids Arduino headers so the fit can be compiled on
+ * a host and run against recorded or synthetic decay curves.
+ */
+struct CoastDownFitResult {
+    bool valid;
+    float viscousPerSec;     // B/J
+    float coulombRpmPerSec;  // Tc/J
+    float startRpm;
+    float durationSec;       // Span of the samples used by the fit
+    float rSquared;          // Fit quality of the integrated decay curve
+    uint16_t sampleCount;
+};
+
+/*
+ * Incremental least-squares fit. Each sample is integrated against the first
+ * one, w(t) - w(0) = -b * integral(w dt) - c * t, which is linear in b and c
+ * and avoids differentiating a noisy tachometer signal. Only running sums are
+ * kept, so memory use does not grow with coast length.
+ */
+class CoastDownFit {
+public:
+    CoastDownFit();
+
+    void reset();
+    void addSample(float timeSec, float rpm);
+    bool solve(CoastDownFitResult& out) const;
+    uint16_t getSampleCount() const { return _sampleCount; }
+    float getStartRpm() const { return _startRpm; }
+    float getLastRpm() const { return _lastRpm; }
+
+private:
+    uint16_t _sampleCount;
+    float _startTimeSec;
+    float _startRpm;
+    float _lastTimeSec;
+    float _lastRpm;
+    double _integral;
+    double _sumII;
+    double _sumIT;
+    double _sumTT;
+    double _sumYI;
+    double _sumYT;
+    double _sumY;
+    double _sumYY;
+};
+
+// Prediction helpers shared by the firmware and host tools. Rates come from a fit; torqueMargin is drive or brake torque as a multiple of the running loss.
+float coastDownDecelRpmPerSec(const CoastDownFitResult& model, float rpm);
+float coastDownStopSeconds(const CoastDownFitResult& model, float rpm);
+float coastDownSpinUpSeconds(const CoastDownFitResult& model, float rpm, float torqueMargin);
+float coastDownBrakeSeconds(const CoastDownFitResult& model, float rpm, float torqueMargin);
+
+#endif // COAST_MODEL_H
@@ -202,6 +202,69 @@
 #ifndef PWM_CARRIER_FREQUENCY_HZ
 #define PWM_CARRIER_FREQUENCY_HZ 50000.0f
 #endif
+/*
+ * The phase accumulator is 32.32 fixed point. With rational synthesis a
+ * frequency that is a small fraction, such as 50, 67.5 or 100/3 Hz, is
+ * worked out exactly against the PWM clock divider and the leftover below
+ * the accumulator LSB is carried between buffers, so absolute phase never
+ * drifts from the crystal.
+ */
+#ifndef DDS_RATIONAL_SYNTHESIS_ENABLE
+#define DDS_RATIONAL_SYNTHESIS_ENABLE 1
+#endif
+#ifndef DDS_RATIONAL_MAX_DENOMINATOR
+#define DDS_RATIONAL_MAX_DENOMINATOR 1000 // Largest frequency denominator treated as exact
+#endif
+/*
+ * DMA block lengths in samples, whole multiples of 16. A new tune reaches the
+ * output within two blocks, so start, kick, ramps, braking and sweeps use the
+ * short length (32 samples is about 0.6 ms at the default carrier). Steady
+ * running uses the long one to cut Core 1 IRQ and refill overhead.
+ */
+#ifndef DMA_BLOCK_SHORT_SAMPLES
+#define DMA_BLOCK_SHORT_SAMPLES 32
+#endif
+#ifndef DMA_BLOCK_LONG_SAMPLES
+#define DMA_BLOCK_LONG_SAMPLES 512
+#endif
+/*
+ * Spread-spectrum carrier. Each DMA block runs at its own PWM period, drawn
+ * pseudo-randomly within PWM_DITHER_PERCENT either side of the carrier, so
+ * the carrier tone and its acoustic whine spread across a band. Duty and
+ * DDS phase steps are rescaled per block, so the sine does not change.
+ */
+#ifndef PWM_DITHER_ENABLE
+#define PWM_DITHER_ENABLE 0
+#endif
+#ifndef PWM_DITHER_PERCENT
+#define PWM_DITHER_PERCENT 4.0f // Largest period change either side of the carrier
+#endif
+/*
+ * The soft limiter holds each channel's peak at the ceiling when amplitude,
+ * supply feed-forward and channel gain would otherwise clip. The ceiling is
+ * a fraction of the largest peak the output stage can place: PWM full scale,
+ * or about 2/sqrt(3) of it for a three-phase bridge with centred or
+ * bottom-clamp placement. It lowers gain before the buffer that would clip
+ * and releases it over SOFT_LIMITER_RELEASE_MS.
+ */
+#ifndef SOFT_LIMITER_ENABLE
+#define SOFT_LIMITER_ENABLE 1
+#endif
+#ifndef SOFT_LIMITER_CEILING
+#define SOFT_LIMITER_CEILING 1.0f
+#endif
+#ifndef SOFT_LIMITER_RELEASE_MS
+#define SOFT_LIMITER_RELEASE_MS 100.0f
+#endif
+/*
+ * FIR output filters are designed on the device from a cutoff, a transition
+ * width and a tap budget of 4 to 32. The stopband target shapes the window;
+ * a kernel capped by its budget keeps this attenuation and widens its
+ * transition instead.
+ */
+#ifndef FIR_DESIGN_STOPBAND_DB
+#define FIR_DESIGN_STOPBAND_DB 50.0f
+#endif
 
 /*
  * --- Output Stage ---
@@ -261,6 +324,29 @@
 #ifndef POWER_STAGE_NEUTRAL_BUFFER_COUNT
 #define POWER_STAGE_NEUTRAL_BUFFER_COUNT 2
 #endif
+#ifndef POWER_STAGE_DEADTIME_NS
+#define POWER_STAGE_DEADTIME_NS 0 // Factory bridge dead time for duty compensation; 0 leaves duty uncompensated
+#endif
+#ifndef POWER_STAGE_DEADTIME_SOFT_DEG
+#define POWER_STAGE_DEADTIME_SOFT_DEG 5.0f // Electrical angle either side of the current zero over which compensation ramps through zero
+#endif
+/*
+ * Bridge leg duty limits. Each leg is either fully off or between the
+ * minimum on-time and the period less the minimum off-time, so the driver
+ * never gets a pulse narrower than it reproduces and every high-side
+ * bootstrap is recharged each period. The common-mode placement keeps the
+ * line-to-line voltages while doing so. The defaults keep the plain sine
+ * with no limits; set the times from the driver datasheet.
+ */
+#ifndef BRIDGE_MODULATION_MODE
+#define BRIDGE_MODULATION_MODE 0 // 0=Sine about 50%, 1=Centred (min-max common mode), 2=Bottom clamp (discontinuous)
+#endif
+#ifndef BRIDGE_MIN_ON_NS
+#define BRIDGE_MIN_ON_NS 0 // Shortest high-side pulse the driver reproduces; 0 for no limit
+#endif
+#ifndef BRIDGE_MIN_OFF_NS
+#define BRIDGE_MIN_OFF_NS 0 // Low-side time each period needs to recharge the high-side bootstrap; 0 for no limit
+#endif
 
 /*
  * --- Preset Management ---
@@ -335,9 +421,270 @@
 #ifndef CLOSED_LOOP_SPEED_ENABLE
 #define CLOSED_LOOP_SPEED_ENABLE 0 // Enable optional tachometer/quadrature speed feedback
 #endif
+#ifndef CLOSED_LOOP_BUMPLESS_ENABLE
+#define CLOSED_LOOP_BUMPLESS_ENABLE 1 // Back-calculate the integral on engage, handover and pitch jumps instead of zeroing it
+#endif
 #ifndef CLOSED_LOOP_TREND_SIZE
 #define CLOSED_LOOP_TREND_SIZE 24  // Rolling runtime samples retained for closed-loop trend diagnostics
 #endif
+#ifndef CLOSED_LOOP_NOTCH_STAGES
+#define CLOSED_LOOP_NOTCH_STAGES 1 // Cascaded adaptive notch stages on the correction path, one per resonance to track
+#endif
+#ifndef CLOSED_LOOP_NOTCH_ADAPT_RATE
+#define CLOSED_LOOP_NOTCH_ADAPT_RATE 0.02f // Normalised gradient step used to steer each notch centre
+#endif
+#ifndef CLOSED_LOOP_NOTCH_DETECT_RATIO
+#define CLOSED_LOOP_NOTCH_DETECT_RATIO 2.0f // Error power over notch residual power needed before a notch engages
+#endif
+#ifndef LOAD_STEP_SLOPE_WINDOW
+#define LOAD_STEP_SLOPE_WINDOW 3 // Closed-loop samples spanned by the load-step slope estimate
+#endif
+#ifndef LOAD_STEP_CONFIRM_SAMPLES
+#define LOAD_STEP_CONFIRM_SAMPLES 3 // Consecutive steep samples needed to confirm a needle drop or lift
+#endif
+#ifndef LOAD_STEP_MIN_ERROR_RPM
+#define LOAD_STEP_MIN_ERROR_RPM 0.03f // Speed error that must already show before a load step is confirmed
+#endif
+#ifndef LOAD_STEP_SETTLE_MS
+#define LOAD_STEP_SETTLE_MS 2000 // Settled lock that arms detection and ends a step measurement
+#endif
+#ifndef LOAD_STEP_TIMEOUT_MS
+#define LOAD_STEP_TIMEOUT_MS 30000UL // A step measurement ends here even if lock has not returned
+#endif
+#ifndef LOAD_STEP_LEARN_RATE
+#define LOAD_STEP_LEARN_RATE 0.5f // Share of each new measurement blended into the learned step
+#endif
+#ifndef STARTUP_KICK_HOLD_MS
+#define STARTUP_KICK_HOLD_MS 200 // Time the platter must stay pulled in before an adaptive kick ends
+#endif
+#ifndef STARTUP_KICK_SLIP_PERCENT
+#define STARTUP_KICK_SLIP_PERCENT 10 // Kick ramp tracking error, as a share of the expected speed, that stretches the next ramp
+#endif
+#ifndef STARTUP_KICK_LEARN_RATE
+#define STARTUP_KICK_LEARN_RATE 0.5f // Share of each new pull-in time blended into the learned kick length
+#endif
+#ifndef STARTUP_KICK_RAMP_GROWTH
+#define STARTUP_KICK_RAMP_GROWTH 1.25f // Stretch applied to the learned kick ramp after it slipped
+#endif
+#ifndef STARTUP_LOCK_TIMEOUT_MS
+#define STARTUP_LOCK_TIMEOUT_MS 60000UL // Time-to-lock is not reported for a start that has not locked by here
+#endif
+#ifndef HEALTH_HISTORY_RECORDS
+#define HEALTH_HISTORY_RECORDS 192 // Per-session health records kept on LittleFS, shared by all speeds
+#endif
+#ifndef HEALTH_MIN_LOCKED_SEC
+#define HEALTH_MIN_LOCKED_SEC 60 // Locked running a session needs before it is recorded
+#endif
+#ifndef HEALTH_TREND_MIN_SESSIONS
+#define HEALTH_TREND_MIN_SESSIONS 12 // Sessions at a speed before its health trend can raise a drift warning
+#endif
+#ifndef HEALTH_TREND_T_STAT
+#define HEALTH_TREND_T_STAT 4.0f // Slope t statistic a health trend must reach to count as drift
+#endif
+#ifndef HEALTH_MIN_CORRECTION_CHANGE_HZ
+#define HEALTH_MIN_CORRECTION_CHANGE_HZ 0.05f // Mean correction rise across the history treated as belt stretch
+#endif
+#ifndef HEALTH_MIN_AMPLITUDE_CHANGE
+#define HEALTH_MIN_AMPLITUDE_CHANGE 0.03f // Lock amplitude rise, as a share of full scale, treated as bearing drag
+#endif
+#ifndef HEALTH_MIN_LOCK_TIME_CHANGE_SEC
+#define HEALTH_MIN_LOCK_TIME_CHANGE_SEC 1.0f // Time-to-lock rise treated as bearing drag
+#endif
+#ifndef HEALTH_MIN_ERROR_RMS_CHANGE_RPM
+#define HEALTH_MIN_ERROR_RMS_CHANGE_RPM 0.01f // Locked speed error RMS rise treated as lost stability
+#endif
+#ifndef HEALTH_MIN_COAST_CHANGE_SEC
+#define HEALTH_MIN_COAST_CHANGE_SEC 3.0f // Coast-down shortening treated as bearing drag
+#endif
+#ifndef BASE_LEARN_SESSION_SEC
+#define BASE_LEARN_SESSION_SEC 600 // Locked time that gives a session full weight in base-frequency learning
+#endif
+#ifndef BASE_LEARN_FORGET
+#define BASE_LEARN_FORGET 0.9f // Weight older sessions keep at each new one, so a stretching belt is followed
+#endif
+#ifndef BASE_LEARN_MIN_WEIGHT
+#define BASE_LEARN_MIN_WEIGHT 3.0f // Full-length sessions behind an estimate before it can move the base
+#endif
+#ifndef BASE_LEARN_CONFIDENCE_PPM
+#define BASE_LEARN_CONFIDENCE_PPM 500 // Largest ratio confidence half-width, in ppm, that allows a base step
+#endif
+#ifndef BASE_LEARN_MAX_STEP_PERCENT
+#define BASE_LEARN_MAX_STEP_PERCENT 0.5f // Largest single learned base step
+#endif
+#ifndef BASE_LEARN_MAX_TOTAL_PERCENT
+#define BASE_LEARN_MAX_TOTAL_PERCENT 3.0f // Largest learned move from the base the user last set
+#endif
+#ifndef BASE_LEARN_ROLLBACK_MARGIN_HZ
+#define BASE_LEARN_ROLLBACK_MARGIN_HZ 0.02f // Extra mean correction after a step, over the session before it, that undoes the step
+#endif
+#ifndef COAST_DOWN_TIMEOUT_MS
+#define COAST_DOWN_TIMEOUT_MS 180000UL // Longest free coast the identification bench will wait for
+#endif
+#ifndef COAST_DOWN_END_PERCENT
+#define COAST_DOWN_END_PERCENT 5.0f    // Coast capture ends once speed falls below this share of the start speed
+#endif
+#ifndef COAST_DOWN_DRIVE_TORQUE_MARGIN
+#define COAST_DOWN_DRIVE_TORQUE_MARGIN 8.0f // Assumed start torque as a multiple of running friction for the rough soft-start estimate
+#endif
+#ifndef COAST_DOWN_BRAKE_TORQUE_MARGIN
+#define COAST_DOWN_BRAKE_TORQUE_MARGIN 4.0f // Assumed braking torque as a multiple of running friction for the rough brake time estimate
+#endif
+#ifndef BRAKE_TACH_TIMEOUT_MS
+#define BRAKE_TACH_TIMEOUT_MS 20000UL // Tach braking gives up and cuts drive if no stop is seen or predicted by then
+#endif
+#ifndef BRAKE_TACH_STANDSTILL_RPM
+#define BRAKE_TACH_STANDSTILL_RPM 0.5f // Measured platter speed treated as stopped
+#endif
+#ifndef BRAKE_TACH_TAPER_PERCENT
+#define BRAKE_TACH_TAPER_PERCENT 30.0f // Below this share of the starting speed, reverse torque falls in proportion to speed
+#endif
+#ifndef BRAKE_TACH_MIN_DRIVE_PERCENT
+#define BRAKE_TACH_MIN_DRIVE_PERCENT 10.0f // Smallest share of the drive envelope applied while still turning
+#endif
+#ifndef BRAKE_TACH_SETTLE_MS
+#define BRAKE_TACH_SETTLE_MS 1500 // Post-stop watch window for reverse rotation or rebound
+#endif
+#ifndef MOTOR_THERMAL_UPDATE_MS
+#define MOTOR_THERMAL_UPDATE_MS 100 // Winding thermal model integration step
+#endif
+#ifndef MOTOR_THERMAL_DERATE_SLEW_PER_SEC
+#define MOTOR_THERMAL_DERATE_SLEW_PER_SEC 0.02f // Fastest thermal derate change, as a fraction of drive per second
+#endif
+#ifndef SENSORLESS_SPEED_ENABLE
+#define SENSORLESS_SPEED_ENABLE 0   // Adds a back-EMF zero-crossing speed source on PIN_SENSORLESS_SENSE; requires CLOSED_LOOP_SPEED_ENABLE
+#endif
+#ifndef SENSORLESS_SAMPLE_HZ
+#define SENSORLESS_SAMPLE_HZ 4000   // ADC sample rate for the sensorless estimator
+#endif
+#ifndef SENSORLESS_BUFFER_SIZE
+#define SENSORLESS_BUFFER_SIZE 256  // Samples queued between the sampling timer and the Core 0 estimator
+#endif
+#ifndef SENSORLESS_WINDOW_CYCLES
+#define SENSORLESS_WINDOW_CYCLES 6  // Electrical cycles averaged into each sensorless frequency estimate
+#endif
+#ifndef SENSORLESS_HYSTERESIS
+#define SENSORLESS_HYSTERESIS 0.2f  // Share of the sensed amplitude the signal must fall below before a rising crossing counts
+#endif
+#ifndef SENSORLESS_MIN_AMPLITUDE
+#define SENSORLESS_MIN_AMPLITUDE 20.0f // Sensed peak, in 12-bit ADC counts, below which there is no usable signal
+#endif
+#ifndef SENSORLESS_MAX_PERIOD_RATIO
+#define SENSORLESS_MAX_PERIOD_RATIO 1.6f // Longest accepted crossing interval as a multiple of the drive period
+#endif
+#ifndef BUS_VOLTAGE_SENSE_ENABLE
+#define BUS_VOLTAGE_SENSE_ENABLE 0  // Samples the DC bus on PIN_BUS_VOLTAGE_SENSE for supply feed-forward and over/undervoltage supervision
+#endif
+#ifndef BUS_VOLTAGE_DIVIDER_RATIO
+#define BUS_VOLTAGE_DIVIDER_RATIO 11.0f // Bus volts per volt at the ADC pin; 100k over 10k gives 11
+#endif
+#ifndef BUS_VOLTAGE_NOMINAL_V
+#define BUS_VOLTAGE_NOMINAL_V 12.0f // Bus voltage the motor tune was set at; feed-forward is unity here
+#endif
+#ifndef BUS_VOLTAGE_SAMPLE_MS
+#define BUS_VOLTAGE_SAMPLE_MS 2     // Bus sampling interval from the Core 0 motor loop
+#endif
+#ifndef BUS_VOLTAGE_FILTER_MS
+#define BUS_VOLTAGE_FILTER_MS 200   // Feed-forward filter time constant; slow enough to ignore PWM ripple and short transients
+#endif
+#ifndef BUS_VOLTAGE_FAST_FILTER_MS
+#define BUS_VOLTAGE_FAST_FILTER_MS 5 // Limit-check filter time constant
+#endif
+#ifndef BUS_VOLTAGE_MIN_SCALE
+#define BUS_VOLTAGE_MIN_SCALE 0.6f  // Smallest feed-forward multiplier on a high bus
+#endif
+#ifndef BUS_VOLTAGE_MAX_SCALE
+#define BUS_VOLTAGE_MAX_SCALE 1.3f  // Largest feed-forward multiplier on a sagging bus
+#endif
+#ifndef BUS_OVERVOLTAGE_V
+#define BUS_OVERVOLTAGE_V 16.0f     // Ends active braking and blocks starts; set below the bus capacitor and driver ratings
+#endif
+#ifndef BUS_UNDERVOLTAGE_V
+#define BUS_UNDERVOLTAGE_V 9.0f     // Below this a dip is timed against BUS_RIDE_THROUGH_MS
+#endif
+#ifndef BUS_VOLTAGE_HYSTERESIS_V
+#define BUS_VOLTAGE_HYSTERESIS_V 0.5f // Distance back inside a limit before it clears
+#endif
+#ifndef BUS_RIDE_THROUGH_MS
+#define BUS_RIDE_THROUGH_MS 200     // Longest undervoltage dip held through before the motor is stopped
+#endif
+#ifndef BUS_VOLTAGE_GUARDS_REGEN
+#define BUS_VOLTAGE_GUARDS_REGEN 1  // Bridge builds: allow active braking without Regen Safe while bus supervision can end it on over-voltage
+#endif
+#ifndef DC_OFFSET_NULL_ENABLE
+#define DC_OFFSET_NULL_ENABLE 0     // Linear builds: measures each channel's DC offset on PIN_DC_OFFSET_SENSE and nulls it in the duty
+#endif
+#ifndef DC_OFFSET_SAMPLE_MS
+#define DC_OFFSET_SAMPLE_MS 1       // Sense sampling interval from the Core 0 motor loop while nulling
+#endif
+#ifndef DC_OFFSET_SETTLE_MS
+#define DC_OFFSET_SETTLE_MS 300     // Wait after a relay or duty change for the relays, amplifier and sense filter
+#endif
+#ifndef DC_OFFSET_AVERAGE_MS
+#define DC_OFFSET_AVERAGE_MS 400    // Sense readings averaged into each measurement
+#endif
+#ifndef DC_OFFSET_PROBE_COUNTS
+#define DC_OFFSET_PROBE_COUNTS 8.0f // Duty step, in PWM counts, that measures each channel's sense gain
+#endif
+#ifndef DC_OFFSET_TOLERANCE_COUNTS
+#define DC_OFFSET_TOLERANCE_COUNTS 0.1f // Residual offset, in PWM counts, accepted as nulled
+#endif
+#ifndef DC_OFFSET_MAX_COUNTS
+#define DC_OFFSET_MAX_COUNTS 40.0f  // Largest correction; a channel further off than this has a fault, not an offset
+#endif
+#ifndef DC_OFFSET_MIN_GAIN
+#define DC_OFFSET_MIN_GAIN 0.2f     // Sense ADC counts per PWM count below which a channel is not reaching the sense
+#endif
+#ifndef DC_OFFSET_MAX_ITERATIONS
+#define DC_OFFSET_MAX_ITERATIONS 6  // Corrections tried per channel after the gain probe
+#endif
+#ifndef SPEED_DEBOUNCE_ADAPTIVE_ENABLE
+#define SPEED_DEBOUNCE_ADAPTIVE_ENABLE 1 // Tach debounce follows the expected edge interval at the target speed; 0 keeps the fixed window
+#endif
+#ifndef SPEED_DEBOUNCE_PERIOD_FRACTION
+#define SPEED_DEBOUNCE_PERIOD_FRACTION 0.25f // Share of the expected pin-change interval used as the debounce window
+#endif
+#ifndef SPEED_DEBOUNCE_MAX_FRACTION
+#define SPEED_DEBOUNCE_MAX_FRACTION 0.5f // Share of that interval no window may reach, the configured debounce included
+#endif
+#ifndef SPEED_DUTY_TRACK_ENABLE
+#define SPEED_DUTY_TRACK_ENABLE 1 // Pulse mode times both edges and tracks each slot's duty cycle for sensor health
+#endif
+#ifndef SPEED_DUTY_BUFFER_SIZE
+#define SPEED_DUTY_BUFFER_SIZE 64 // Pulse high/period pairs queued between the tach ISR and Core 0
+#endif
+#ifndef SPEED_DUTY_ALPHA
+#define SPEED_DUTY_ALPHA 0.05f // Filter weight of each new duty sample
+#endif
+#ifndef SPEED_DUTY_BASELINE_SAMPLES
+#define SPEED_DUTY_BASELINE_SAMPLES 256 // Pulses measured after boot before the duty baseline is taken
+#endif
+#ifndef SPEED_DUTY_DRIFT_LIMIT
+#define SPEED_DUTY_DRIFT_LIMIT 0.08f // Change in mean duty or slot spread, as a fraction, that raises a warning
+#endif
+#ifndef SPEED_DUTY_MARGIN
+#define SPEED_DUTY_MARGIN 0.1f // Slot duty this close to 0% or 100% is reported as a marginal signal
+#endif
+#ifndef SPEED_ESTIMATOR_MODE
+#define SPEED_ESTIMATOR_MODE 2 // Outlier stage before the RPM filter: 0 off, 1 median, 2 Hampel, 3 trimmed mean
+#endif
+#ifndef SPEED_ESTIMATOR_WINDOW
+#define SPEED_ESTIMATOR_WINDOW 5 // Feedback windows kept by the outlier stage
+#endif
+#ifndef SPEED_ESTIMATOR_HAMPEL_K
+#define SPEED_ESTIMATOR_HAMPEL_K 3.0f // Scaled deviations from the median before a window reading is replaced
+#endif
+#ifndef SPEED_ESTIMATOR_MIN_SPREAD
+#define SPEED_ESTIMATOR_MIN_SPREAD 0.002f // Share of the median RPM below which the Hampel spread is never taken
+#endif
+#ifndef CPR_DETECT_SAMPLES
+#define CPR_DETECT_SAMPLES 1024     // Edge intervals captured for counts/rev detection; detectable counts/rev is about a third of this
+#endif
+#ifndef CPR_DETECT_REVOLUTIONS
+#define CPR_DETECT_REVOLUTIONS 8    // Expected platter revolutions captured before analysis starts
+#endif
+#ifndef CPR_DETECT_BUDGET
+#define CPR_DETECT_BUDGET 1024      // Autocorrelation multiply-accumulates allowed per feedback update
+#endif
 
 // The active channel count is derived once so waveform, menu, and diagnostics code can share the same feature-gated boundary.
 #if ENABLE_4_CHANNEL_SUPPORT
@@ -447,6 +794,50 @@
 #define PIN_SPEED_SENSOR_B 7
 #define PIN_AMP_TEMP 26
 #define PIN_AMP_THERM_OK 27
+/*
+ * ADC sense inputs.
+ *
+ * GP26-GP28 are the ADC inputs every supported board leaves free; GP29 is VSYS
+ * sensing on a Pico and wireless on a Pico W. The amplifier monitor claims GP26
+ * and GP27, and an SPI display claims GP28 for D/C. A sense input left at its
+ * default takes the first ADC input nothing else enabled has claimed. A build
+ * with more sense inputs than free ADC inputs fails the pin checks below and
+ * must place one by hand.
+ */
+#define TT_ADC_CLAIMED_BY_BOARD(pin) \
+    ((AMP_MONITOR_ENABLE && ((pin) == PIN_AMP_TEMP || (pin) == PIN_AMP_THERM_OK)) || \
+     (DISPLAY_TRANSPORT != DISPLAY_TRANSPORT_I2C && (pin) == PIN_DISPLAY_DC))
+#ifndef PIN_SENSORLESS_SENSE
+#if !TT_ADC_CLAIMED_BY_BOARD(28)
+#define PIN_SENSORLESS_SENSE 28     // ADC input for the sensorless back-EMF or current sense; must be GP26-GP29
+#elif !TT_ADC_CLAIMED_BY_BOARD(27)
+#define PIN_SENSORLESS_SENSE 27
+#else
+#define PIN_SENSORLESS_SENSE 26
+#endif
+#endif
+#define TT_ADC_CLAIMED_BEFORE_BUS(pin) \
+    (TT_ADC_CLAIMED_BY_BOARD(pin) || (SENSORLESS_SPEED_ENABLE && (pin) == PIN_SENSORLESS_SENSE))
+#ifndef PIN_BUS_VOLTAGE_SENSE
+#if !TT_ADC_CLAIMED_BEFORE_BUS(28)
+#define PIN_BUS_VOLTAGE_SENSE 28    // ADC input for the divided DC bus; must be GP26-GP29
+#elif !TT_ADC_CLAIMED_BEFORE_BUS(27)
+#define PIN_BUS_VOLTAGE_SENSE 27
+#else
+#define PIN_BUS_VOLTAGE_SENSE 26
+#endif
+#endif
+#define TT_ADC_CLAIMED_BEFORE_DC_OFFSET(pin) \
+    (TT_ADC_CLAIMED_BEFORE_BUS(pin) || (BUS_VOLTAGE_SENSE_ENABLE && (pin) == PIN_BUS_VOLTAGE_SENSE))
+#ifndef PIN_DC_OFFSET_SENSE
+#if !TT_ADC_CLAIMED_BEFORE_DC_OFFSET(28)
+#define PIN_DC_OFFSET_SENSE 28      // ADC input for the shared output offset sense; must be GP26-GP29
+#elif !TT_ADC_CLAIMED_BEFORE_DC_OFFSET(27)
+#define PIN_DC_OFFSET_SENSE 27
+#else
+#define PIN_DC_OFFSET_SENSE 26
+#endif
+#endif
 
 /*
  * Default controller-free DRV8313/SimpleFOC-style bridge interface. Boards
@@ -511,13 +902,16 @@
  * struct changes, bump SETTINGS_SCHEMA_VERSION and add migration code before
  * changing the expected size.
  */
-#define SETTINGS_SCHEMA_VERSION 12
+#define SETTINGS_SCHEMA_VERSION 13
 #define SETTINGS_FILE_FORMAT_VERSION 1
 #define SETTINGS_FILE_MAGIC 0x54544353UL // "TTCS"
 #define PRESET_FILE_MAGIC 0x54544350UL   // "TTCP"
+#define HEALTH_FILE_MAGIC 0x54544348UL   // "TTCH"
 #define SPEED_SETTINGS_STORAGE_SIZE 56
 #define CLOSED_LOOP_TUNING_STORAGE_SIZE 44
-#define GLOBAL_SETTINGS_STORAGE_SIZE 620
+#define COAST_DOWN_MODEL_STORAGE_SIZE 20
+#define BASE_LEARN_MODEL_STORAGE_SIZE 28
+#define GLOBAL_SETTINGS_STORAGE_SIZE 908
 
 // --- Default Values ---
 #define DEFAULT_PHASE_MODE 3 // 3-phase
@@ -654,6 +1048,39 @@
 #if (CLOSED_LOOP_SPEED_ENABLE != 0 && CLOSED_LOOP_SPEED_ENABLE != 1)
 #error "CLOSED_LOOP_SPEED_ENABLE must be 0 or 1."
 #endif
+#if (CLOSED_LOOP_BUMPLESS_ENABLE != 0 && CLOSED_LOOP_BUMPLESS_ENABLE != 1)
+#error "CLOSED_LOOP_BUMPLESS_ENABLE must be 0 or 1."
+#endif
+#if (SENSORLESS_SPEED_ENABLE != 0 && SENSORLESS_SPEED_ENABLE != 1)
+#error "SENSORLESS_SPEED_ENABLE must be 0 or 1."
+#endif
+#if SENSORLESS_SPEED_ENABLE && !CLOSED_LOOP_SPEED_ENABLE
+#error "SENSORLESS_SPEED_ENABLE feeds the closed-loop controller and requires CLOSED_LOOP_SPEED_ENABLE."
+#endif
+#if SENSORLESS_SPEED_ENABLE && (PIN_SENSORLESS_SENSE < 26 || PIN_SENSORLESS_SENSE > 29)
+#error "PIN_SENSORLESS_SENSE must be an ADC-capable GPIO, GP26-GP29."
+#endif
+#if (BUS_VOLTAGE_SENSE_ENABLE != 0 && BUS_VOLTAGE_SENSE_ENABLE != 1)
+#error "BUS_VOLTAGE_SENSE_ENABLE must be 0 or 1."
+#endif
+#if (BUS_VOLTAGE_GUARDS_REGEN != 0 && BUS_VOLTAGE_GUARDS_REGEN != 1)
+#error "BUS_VOLTAGE_GUARDS_REGEN must be 0 or 1."
+#endif
+#if BUS_VOLTAGE_SENSE_ENABLE && (PIN_BUS_VOLTAGE_SENSE < 26 || PIN_BUS_VOLTAGE_SENSE > 29)
+#error "PIN_BUS_VOLTAGE_SENSE must be an ADC-capable GPIO, GP26-GP29."
+#endif
+#if (DC_OFFSET_NULL_ENABLE != 0 && DC_OFFSET_NULL_ENABLE != 1)
+#error "DC_OFFSET_NULL_ENABLE must be 0 or 1."
+#endif
+#if DC_OFFSET_NULL_ENABLE && OUTPUT_STAGE_TYPE != OUTPUT_STAGE_LINEAR_PWM
+#error "DC_OFFSET_NULL_ENABLE nulls linear amplifier offsets and requires OUTPUT_STAGE_LINEAR_PWM."
+#endif
+#if DC_OFFSET_NULL_ENABLE && (!ENABLE_MUTE_RELAYS || ENABLE_DPDT_RELAYS)
+#error "DC_OFFSET_NULL_ENABLE connects one channel at a time to the sense and requires per-phase mute relays."
+#endif
+#if DC_OFFSET_NULL_ENABLE && (PIN_DC_OFFSET_SENSE < 26 || PIN_DC_OFFSET_SENSE > 29)
+#error "PIN_DC_OFFSET_SENSE must be an ADC-capable GPIO, GP26-GP29."
+#endif
 #if (OUTPUT_STAGE_TYPE != OUTPUT_STAGE_LINEAR_PWM && OUTPUT_STAGE_TYPE != OUTPUT_STAGE_3PWM_BRIDGE)
 #error "OUTPUT_STAGE_TYPE must select OUTPUT_STAGE_LINEAR_PWM or OUTPUT_STAGE_3PWM_BRIDGE."
 #endif
@@ -717,9 +1144,28 @@ static_assert(MIN_OUTPUT_FREQUENCY_HZ > 0.0f, "Minimum output frequency must be
 static_assert(MAX_OUTPUT_FREQUENCY_HZ > MIN_OUTPUT_FREQUENCY_HZ, "Maximum output frequency must exceed minimum output frequency.");
 static_assert(MAX_OUTPUT_FREQUENCY_HZ <= 2000.0f, "Review waveform timing before allowing output frequencies above 2 kHz.");
 static_assert(PWM_CARRIER_FREQUENCY_HZ >= 20000.0f && PWM_CARRIER_FREQUENCY_HZ <= 100000.0f, "PWM carrier must remain inside the supported power-stage range.");
+static_assert(SOFT_LIMITER_CEILING > 0.5f && SOFT_LIMITER_CEILING <= 1.0f, "Soft limiter ceiling must be a fraction of full scale above one half.");
+static_assert(SOFT_LIMITER_RELEASE_MS > 0.0f && SOFT_LIMITER_RELEASE_MS <= 5000.0f, "Soft limiter release must be positive and at most five seconds.");
+static_assert(FIR_DESIGN_STOPBAND_DB >= 21.0f && FIR_DESIGN_STOPBAND_DB <= 90.0f, "FIR stopband target must be between 21 and 90 dB.");
+static_assert(DMA_BLOCK_SHORT_SAMPLES >= 16 && DMA_BLOCK_SHORT_SAMPLES % 16 == 0, "Short DMA blocks must be a positive multiple of 16 samples.");
+static_assert(DMA_BLOCK_LONG_SAMPLES >= DMA_BLOCK_SHORT_SAMPLES && DMA_BLOCK_LONG_SAMPLES <= 1024 && DMA_BLOCK_LONG_SAMPLES % 16 == 0, "Long DMA blocks must be a multiple of 16 samples between the short length and 1024.");
+static_assert(PWM_DITHER_PERCENT >= 0.0f && PWM_DITHER_PERCENT <= 10.0f, "PWM dither band must be between 0 and 10 percent of the carrier period.");
+static_assert(PWM_CARRIER_FREQUENCY_HZ / (1.0f + PWM_DITHER_PERCENT / 100.0f) >= 20000.0f && PWM_CARRIER_FREQUENCY_HZ / (1.0f - PWM_DITHER_PERCENT / 100.0f) <= 100000.0f, "Dithered PWM carrier must remain inside the supported power-stage range.");
+static_assert(DC_OFFSET_PROBE_COUNTS >= 1.0f && DC_OFFSET_PROBE_COUNTS <= 64.0f, "DC offset probe must be between 1 and 64 PWM counts.");
+static_assert(DC_OFFSET_TOLERANCE_COUNTS > 0.0f && DC_OFFSET_TOLERANCE_COUNTS < DC_OFFSET_PROBE_COUNTS, "DC offset tolerance must be positive and below the probe step.");
+static_assert(DC_OFFSET_MAX_COUNTS >= DC_OFFSET_PROBE_COUNTS && DC_OFFSET_MAX_COUNTS <= 100.0f, "Largest DC offset correction must cover the probe and stay within 100 PWM counts.");
+static_assert(DC_OFFSET_MIN_GAIN > 0.0f, "DC offset minimum sense gain must be positive.");
+static_assert(DC_OFFSET_MAX_ITERATIONS >= 1 && DC_OFFSET_MAX_ITERATIONS <= 20, "DC offset iterations must be between 1 and 20.");
+static_assert(DC_OFFSET_SAMPLE_MS >= 1 && DC_OFFSET_AVERAGE_MS >= 10 * DC_OFFSET_SAMPLE_MS, "DC offset averaging must cover at least ten sense samples.");
+static_assert(DDS_RATIONAL_MAX_DENOMINATOR >= 1 && DDS_RATIONAL_MAX_DENOMINATOR <= 10000, "Rational DDS denominator must keep the exact increment inside 64-bit arithmetic.");
 static_assert(POWER_STAGE_WAKE_DELAY_MS <= 1000, "Power-stage wake delay must remain non-blocking and reasonably short.");
 static_assert(POWER_STAGE_RESET_PULSE_MS <= 1000, "Power-stage reset pulse must remain non-blocking.");
 static_assert(POWER_STAGE_PHASE_ENABLE_DELAY_MS <= 1000, "Power-stage phase-enable delay must remain non-blocking.");
+static_assert(POWER_STAGE_DEADTIME_NS >= 0 && POWER_STAGE_DEADTIME_NS <= 2000, "Bridge dead time must stay between 0 and 2000 ns.");
+static_assert(POWER_STAGE_DEADTIME_SOFT_DEG > 0.0f && POWER_STAGE_DEADTIME_SOFT_DEG <= 45.0f, "Dead-time soft zone must be a small positive angle.");
+static_assert(BRIDGE_MODULATION_MODE >= 0 && BRIDGE_MODULATION_MODE <= 2, "Bridge modulation mode must be 0, 1, or 2.");
+static_assert(BRIDGE_MIN_ON_NS >= 0 && BRIDGE_MIN_OFF_NS >= 0, "Bridge minimum on and off times cannot be negative.");
+static_assert((BRIDGE_MIN_ON_NS + BRIDGE_MIN_OFF_NS) * 1e-9f * PWM_CARRIER_FREQUENCY_HZ <= 0.2f, "Bridge minimum on and off times must leave most of the PWM period for modulation.");
 static_assert(POWER_STAGE_NEUTRAL_BUFFER_COUNT >= 1 && POWER_STAGE_NEUTRAL_BUFFER_COUNT <= 8, "Neutral buffer confirmation count is unreasonable.");
 static_assert((LUT_MAX_SIZE & (LUT_MAX_SIZE - 1)) == 0, "LUT_MAX_SIZE must be a power of two.");
 static_assert(LUT_MAX_SIZE >= 1024, "LUT_MAX_SIZE is too small for the DDS phase accumulator.");
@@ -731,6 +1177,66 @@ static_assert(AMP_TEMP_MIN_SHUTDOWN_MARGIN_C > 0.0f, "Amplifier thermal shutdown
 static_assert(SETTINGS_SCHEMA_VERSION > 0, "Settings schema version must be positive.");
 static_assert(SETTINGS_FILE_FORMAT_VERSION == 1, "Update settings file load/save code when changing the file format.");
 static_assert(CLOSED_LOOP_TREND_SIZE > 0 && CLOSED_LOOP_TREND_SIZE <= 64, "Closed-loop trend size must stay small and non-zero.");
+static_assert(CLOSED_LOOP_NOTCH_STAGES >= 1 && CLOSED_LOOP_NOTCH_STAGES <= 3, "Closed-loop notch supports one to three stages.");
+static_assert(CLOSED_LOOP_NOTCH_ADAPT_RATE > 0.0f && CLOSED_LOOP_NOTCH_ADAPT_RATE <= 0.2f, "Closed-loop notch adaptation step must be small and positive.");
+static_assert(CLOSED_LOOP_NOTCH_DETECT_RATIO > 1.0f, "Closed-loop notch detection ratio must exceed unity.");
+static_assert(LOAD_STEP_SLOPE_WINDOW >= 1 && LOAD_STEP_SLOPE_WINDOW <= 8, "Load-step slope window must span one to eight samples.");
+static_assert(LOAD_STEP_CONFIRM_SAMPLES >= 1 && LOAD_STEP_CONFIRM_SAMPLES <= 20, "Load-step confirmation must be a short run of samples.");
+static_assert(LOAD_STEP_MIN_ERROR_RPM >= 0.0f, "Load-step minimum error cannot be negative.");
+static_assert(LOAD_STEP_TIMEOUT_MS > LOAD_STEP_SETTLE_MS, "Load-step measurement timeout must exceed the settle time.");
+static_assert(LOAD_STEP_LEARN_RATE > 0.0f && LOAD_STEP_LEARN_RATE <= 1.0f, "Load-step learning rate must be in (0, 1].");
+static_assert(STARTUP_KICK_HOLD_MS <= 2000, "Startup kick pull-in hold must be short next to the kick itself.");
+static_assert(STARTUP_KICK_SLIP_PERCENT >= 1 && STARTUP_KICK_SLIP_PERCENT <= 50, "Startup kick slip threshold must be between 1 and 50 percent.");
+static_assert(STARTUP_KICK_LEARN_RATE > 0.0f && STARTUP_KICK_LEARN_RATE <= 1.0f, "Startup kick learning rate must be in (0, 1].");
+static_assert(STARTUP_KICK_RAMP_GROWTH >= 1.0f && STARTUP_KICK_RAMP_GROWTH <= 2.0f, "Startup kick ramp growth must be between 1 and 2.");
+static_assert(HEALTH_HISTORY_RECORDS >= 16 && HEALTH_HISTORY_RECORDS <= 512, "Health history must hold 16 to 512 sessions.");
+static_assert(HEALTH_MIN_LOCKED_SEC >= 10 && HEALTH_MIN_LOCKED_SEC <= 3600, "Health sessions need ten seconds to an hour of lock.");
+static_assert(HEALTH_TREND_MIN_SESSIONS >= 4 && HEALTH_TREND_MIN_SESSIONS <= HEALTH_HISTORY_RECORDS, "Health trends need at least four sessions and no more than the history holds.");
+static_assert(HEALTH_TREND_T_STAT >= 2.0f, "Health trend threshold below a t of 2 would flag ordinary scatter.");
+static_assert(BASE_LEARN_SESSION_SEC >= HEALTH_MIN_LOCKED_SEC, "A full-weight learning session cannot be shorter than a recorded one.");
+static_assert(BASE_LEARN_FORGET > 0.5f && BASE_LEARN_FORGET <= 1.0f, "Base learning must keep more than half the weight of older sessions.");
+static_assert(BASE_LEARN_MIN_WEIGHT >= 1.0f, "Base learning needs at least one full session before stepping.");
+static_assert(BASE_LEARN_CONFIDENCE_PPM >= 50 && BASE_LEARN_CONFIDENCE_PPM <= 5000, "Base learning confidence must be 50-5000 ppm.");
+static_assert(BASE_LEARN_MAX_STEP_PERCENT > 0.0f && BASE_LEARN_MAX_STEP_PERCENT <= BASE_LEARN_MAX_TOTAL_PERCENT, "A learned base step cannot exceed the total learned move.");
+static_assert(BASE_LEARN_MAX_TOTAL_PERCENT <= 10.0f, "Learned base moves are limited to 10% of the user's base.");
+static_assert(BASE_LEARN_ROLLBACK_MARGIN_HZ >= 0.0f, "Base learning rollback margin cannot be negative.");
+static_assert(COAST_DOWN_END_PERCENT > 0.0f && COAST_DOWN_END_PERCENT < 50.0f, "Coast-down end speed must be a small share of the start speed.");
+static_assert(COAST_DOWN_DRIVE_TORQUE_MARGIN > 1.0f, "Coast-down drive torque margin must exceed running friction.");
+static_assert(COAST_DOWN_BRAKE_TORQUE_MARGIN >= 0.0f, "Coast-down brake torque margin cannot be negative.");
+static_assert(BRAKE_TACH_TIMEOUT_MS >= 1000, "Tach braking timeout must allow at least one second of braking.");
+static_assert(BRAKE_TACH_STANDSTILL_RPM > 0.0f && BRAKE_TACH_STANDSTILL_RPM < 10.0f, "Tach braking standstill speed must be a small positive RPM.");
+static_assert(BRAKE_TACH_TAPER_PERCENT > 0.0f && BRAKE_TACH_TAPER_PERCENT <= 100.0f, "Tach braking taper must be a share of the starting speed.");
+static_assert(BRAKE_TACH_MIN_DRIVE_PERCENT > 0.0f && BRAKE_TACH_MIN_DRIVE_PERCENT <= 100.0f, "Tach braking minimum drive must be a positive share of the envelope.");
+static_assert(BRAKE_TACH_SETTLE_MS <= 10000, "Tach braking settle window should stay short.");
+static_assert(MOTOR_THERMAL_UPDATE_MS >= 10 && MOTOR_THERMAL_UPDATE_MS <= 1000, "Motor thermal update step must stay between 10 ms and 1 s.");
+static_assert(MOTOR_THERMAL_DERATE_SLEW_PER_SEC > 0.0f && MOTOR_THERMAL_DERATE_SLEW_PER_SEC <= 1.0f, "Motor thermal derate slew must be positive and at most full scale per second.");
+static_assert(SENSORLESS_SAMPLE_HZ >= 1000 && SENSORLESS_SAMPLE_HZ <= 20000, "Sensorless sampling must stay between 1 and 20 kHz.");
+static_assert(SENSORLESS_BUFFER_SIZE >= 32 && SENSORLESS_BUFFER_SIZE <= 1024, "Sensorless sample queue must hold 32 to 1024 samples.");
+static_assert(SENSORLESS_WINDOW_CYCLES >= 1 && SENSORLESS_WINDOW_CYCLES <= 16, "Sensorless estimate must span one to sixteen cycles.");
+static_assert(SENSORLESS_HYSTERESIS > 0.0f && SENSORLESS_HYSTERESIS < 1.0f, "Sensorless hysteresis must be a share of the sensed amplitude.");
+static_assert(SENSORLESS_MAX_PERIOD_RATIO > 1.0f && SENSORLESS_MAX_PERIOD_RATIO <= 3.0f, "Sensorless period ratio must exceed unity and stay modest.");
+static_assert(BUS_VOLTAGE_DIVIDER_RATIO >= 1.0f, "Bus voltage divider ratio is bus volts per ADC volt and cannot be below one.");
+static_assert(BUS_UNDERVOLTAGE_V > 0.0f && BUS_UNDERVOLTAGE_V < BUS_VOLTAGE_NOMINAL_V && BUS_VOLTAGE_NOMINAL_V < BUS_OVERVOLTAGE_V, "Bus limits must bracket the nominal voltage.");
+static_assert(BUS_OVERVOLTAGE_V <= BUS_VOLTAGE_DIVIDER_RATIO * 3.3f, "Bus over-voltage limit must be inside the divided ADC range.");
+static_assert(BUS_VOLTAGE_HYSTERESIS_V >= 0.0f && BUS_UNDERVOLTAGE_V + BUS_VOLTAGE_HYSTERESIS_V < BUS_OVERVOLTAGE_V - BUS_VOLTAGE_HYSTERESIS_V, "Bus limit hysteresis must leave a normal band.");
+static_assert(BUS_VOLTAGE_MIN_SCALE > 0.0f && BUS_VOLTAGE_MIN_SCALE <= 1.0f && BUS_VOLTAGE_MAX_SCALE >= 1.0f && BUS_VOLTAGE_MAX_SCALE <= 2.0f, "Bus feed-forward limits must bracket unity.");
+static_assert(BUS_VOLTAGE_SAMPLE_MS >= 1 && BUS_VOLTAGE_SAMPLE_MS <= 50, "Bus sampling must stay between 1 and 50 ms.");
+static_assert(BUS_VOLTAGE_FAST_FILTER_MS >= 1 && BUS_VOLTAGE_FAST_FILTER_MS < BUS_VOLTAGE_FILTER_MS, "Bus limit filter must be faster than the feed-forward filter.");
+static_assert(BUS_RIDE_THROUGH_MS <= 2000, "Bus ride-through must stay short; longer dips should stop the motor.");
+static_assert(SPEED_DEBOUNCE_ADAPTIVE_ENABLE == 0 || SPEED_DEBOUNCE_ADAPTIVE_ENABLE == 1, "SPEED_DEBOUNCE_ADAPTIVE_ENABLE must be 0 or 1.");
+static_assert(SPEED_DEBOUNCE_PERIOD_FRACTION > 0.0f && SPEED_DEBOUNCE_PERIOD_FRACTION <= SPEED_DEBOUNCE_MAX_FRACTION && SPEED_DEBOUNCE_MAX_FRACTION < 1.0f, "Debounce fractions must satisfy 0 < period share <= largest share < 1.");
+static_assert(SPEED_DUTY_TRACK_ENABLE == 0 || SPEED_DUTY_TRACK_ENABLE == 1, "SPEED_DUTY_TRACK_ENABLE must be 0 or 1.");
+static_assert(SPEED_DUTY_BUFFER_SIZE >= 8 && SPEED_DUTY_BUFFER_SIZE <= 512, "Duty sample queue must hold 8 to 512 samples.");
+static_assert(SPEED_DUTY_ALPHA > 0.0f && SPEED_DUTY_ALPHA <= 1.0f, "SPEED_DUTY_ALPHA must be above 0 and at most 1.");
+static_assert(SPEED_DUTY_DRIFT_LIMIT > 0.0f && SPEED_DUTY_DRIFT_LIMIT < 0.5f, "SPEED_DUTY_DRIFT_LIMIT must be between 0 and 0.5.");
+static_assert(SPEED_DUTY_MARGIN >= 0.0f && SPEED_DUTY_MARGIN < 0.5f, "SPEED_DUTY_MARGIN must be at least 0 and below 0.5.");
+static_assert(SPEED_ESTIMATOR_MODE >= 0 && SPEED_ESTIMATOR_MODE <= 3, "SPEED_ESTIMATOR_MODE must be 0 to 3.");
+static_assert(SPEED_ESTIMATOR_WINDOW >= 3 && SPEED_ESTIMATOR_WINDOW <= 9, "SPEED_ESTIMATOR_WINDOW must be 3 to 9.");
+static_assert(SPEED_ESTIMATOR_HAMPEL_K > 0.0f, "SPEED_ESTIMATOR_HAMPEL_K must be positive.");
+static_assert(SPEED_ESTIMATOR_MIN_SPREAD >= 0.0f && SPEED_ESTIMATOR_MIN_SPREAD < 0.1f, "SPEED_ESTIMATOR_MIN_SPREAD must be 0 to 0.1.");
+static_assert(CPR_DETECT_SAMPLES >= 64 && CPR_DETECT_SAMPLES <= 4096, "Counts/rev detection buffer must stay between 64 and 4096 intervals.");
+static_assert(CPR_DETECT_REVOLUTIONS >= 3, "Counts/rev detection needs at least three revolutions to see a repeat.");
+static_assert(CPR_DETECT_BUDGET >= 64, "Counts/rev detection budget is too small to finish in reasonable time.");
 
 // Pin uniqueness checks cover the always-present wiring first, then add checks for feature-gated hardware blocks below.
 #define TT_PIN_ASSERT_DISTINCT(a, b) static_assert((a) != (b), #a " must not share a GPIO with " #b)
@@ -1157,6 +1663,54 @@ TT_PIN_ASSERT_DISTINCT(PIN_AMP_THERM_OK, PIN_PWM_PHASE_C);
 TT_PIN_ASSERT_DISTINCT(PIN_AMP_THERM_OK, PIN_PWM_PHASE_D);
 #endif
 
+#if SENSORLESS_SPEED_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_SENSORLESS_SENSE, PIN_SPEED_SENSOR_A);
+TT_PIN_ASSERT_DISTINCT(PIN_SENSORLESS_SENSE, PIN_SPEED_SENSOR_B);
+#if DISPLAY_TRANSPORT != DISPLAY_TRANSPORT_I2C
+TT_PIN_ASSERT_DISTINCT(PIN_SENSORLESS_SENSE, PIN_DISPLAY_DC);
+#endif
+#if AMP_MONITOR_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_SENSORLESS_SENSE, PIN_AMP_TEMP);
+TT_PIN_ASSERT_DISTINCT(PIN_SENSORLESS_SENSE, PIN_AMP_THERM_OK);
+#endif
+#endif
+
+#if BUS_VOLTAGE_SENSE_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_BUS_VOLTAGE_SENSE, PIN_SPEED_SENSOR_A);
+TT_PIN_ASSERT_DISTINCT(PIN_BUS_VOLTAGE_SENSE, PIN_SPEED_SENSOR_B);
+#if DISPLAY_TRANSPORT != DISPLAY_TRANSPORT_I2C
+TT_PIN_ASSERT_DISTINCT(PIN_BUS_VOLTAGE_SENSE, PIN_DISPLAY_DC);
+#endif
+#if AMP_MONITOR_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_BUS_VOLTAGE_SENSE, PIN_AMP_TEMP);
+TT_PIN_ASSERT_DISTINCT(PIN_BUS_VOLTAGE_SENSE, PIN_AMP_THERM_OK);
+#endif
+#if SENSORLESS_SPEED_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_BUS_VOLTAGE_SENSE, PIN_SENSORLESS_SENSE);
+#endif
+#endif
+
+#if DC_OFFSET_NULL_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_SPEED_SENSOR_A);
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_SPEED_SENSOR_B);
+#if DISPLAY_TRANSPORT != DISPLAY_TRANSPORT_I2C
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_DISPLAY_DC);
+#endif
+#if AMP_MONITOR_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_AMP_TEMP);
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_AMP_THERM_OK);
+#endif
+#if SENSORLESS_SPEED_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_SENSORLESS_SENSE);
+#endif
+#if BUS_VOLTAGE_SENSE_ENABLE
+TT_PIN_ASSERT_DISTINCT(PIN_DC_OFFSET_SENSE, PIN_BUS_VOLTAGE_SENSE);
+#endif
+#endif
+
 #undef TT_PIN_ASSERT_DISTINCT
+#undef TT_ADC_CLAIMED_BY_BOARD
+#undef TT_ADC_CLAIMED_BEFORE_BUS
+#undef TT_ADC_CLAIMED_BEFORE_DC_OFFSET
 
 #endif // CONFIG_H
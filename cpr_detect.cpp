@@ -0,0 +1,217 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "cpr_detect.h"
+#include <math.h>
+
+// Peaks are only searched within this share of the expected count.
+static const float CPR_DETECT_TOLERANCE = 0.15f;
+static const float CPR_DETECT_MIN_CORRELATION = 0.2f;
+static const float CPR_DETECT_EXPECTED_ONLY_CONFIDENCE = 0.6f;
+// Without a repeat, the expected count is used only when it lies this close to a whole count.
+static const float CPR_DETECT_ROUNDING_COUNTS = 0.15f;
+static const float CPR_DETECT_AMBIGUOUS_RATIO = 0.95f;
+static const uint16_t CPR_DETECT_MAX_COUNTS = 20000;
+// An interval further from the mean than this share of it, or this many mean absolute deviations if more, is a glitch.
+static const float CPR_DETECT_GLITCH_FRACTION = 0.25f;
+static const uint32_t CPR_DETECT_GLITCH_SPREADS = 4;
+
+CprDetector::CprDetector() {
+    _x = nullptr;
+    _samples = 0;
+    _maxLag = 0;
+    _lag = 0;
+    _index = 0;
+    _expectedCounts = 0.0f;
+    _zeroLagSum = 0;
+    _lagSum = 0;
+    _prevScore = 0.0f;
+    _prevPrevScore = 0.0f;
+    _bestLag = 0;
+    _bestScore = 0.0f;
+    _runnerUpScore = 0.0f;
+    _globalLag = 0;
+    _globalScore = 0.0f;
+    _finished = false;
+    _detectedCounts = 0;
+    _correlation = 0.0f;
+    _confidence = 0.0f;
+    _message = "";
+}
+
+bool CprDetector::begin(uint32_t* intervalsUs, uint16_t count, float expectedRpm) {
+    _finished = false;
+    _detectedCounts = 0;
+    _correlation = 0.0f;
+    _confidence = 0.0f;
+    _samples = 0;
+    _maxLag = 0;
+    if (count == 0 || !(expectedRpm > 0.0f)) {
+        _message = "Too few edges; check the sensor signal";
+        return false;
+    }
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < count; i++) sum += intervalsUs[i];
+    uint32_t meanUs = (uint32_t)(sum / count);
+    if (meanUs == 0) {
+        _message = "Edge intervals are too short to measure";
+        return false;
+    }
+
+    // A missed or doubled edge moves an interval by half a mean or more, far beyond the few percent of a once-per-rev
+    // defect, and would outweigh it in the correlation. Such intervals count as no deviation at all. A sensor whose
+    // intervals legitimately spread that far, a pulse counted on both edges at an uneven duty, keeps them clamped to
+    // one mean either way instead.
+    uint64_t absSum = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t d = (int32_t)intervalsUs[i] - (int32_t)meanUs;
+        absSum += (uint64_t)(d < 0 ? -d : d);
+    }
+    uint64_t spread = (CPR_DETECT_GLITCH_SPREADS * absSum) / count;
+    uint64_t glitch = (uint64_t)(meanUs * CPR_DETECT_GLITCH_FRACTION);
+    if (spread > glitch) glitch = spread;
+    bool dropGlitches = glitch < meanUs;
+    int32_t limit = dropGlitches ? (int32_t)glitch : (int32_t)meanUs;
+    int32_t* x = (int32_t*)intervalsUs;
+    _zeroLagSum = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t d = (int32_t)intervalsUs[i] - (int32_t)meanUs;
+        if (d > limit) d = dropGlitches ? 0 : limit;
+        if (d < -limit) d = dropGlitches ? 0 : -limit;
+        x[i] = d;
+        _zeroLagSum += (int64_t)d * d;
+    }
+
+    _x = x;
+    _samples = count;
+    _expectedCounts = (60000000.0f / expectedRpm) / (float)meanUs;
+    _maxLag = count / 3;
+    _lag = 1;
+    _index = 0;
+    _lagSum = 0;
+    _prevScore = 0.0f;
+    _prevPrevScore = 0.0f;
+    _bestLag = 0;
+    _bestScore = 0.0f;
+    _runnerUpScore = 0.0f;
+    _globalLag = 0;
+    _globalScore = 0.0f;
+    _message = "Analysing edge intervals";
+    if (_zeroLagSum == 0) finish();
+    return true;
+}
+
+bool CprDetector::analyse(uint32_t budget) {
+    if (_finished) return true;
+    if (_x == nullptr) return false;
+
+    // Each call spends a bounded number of multiply-accumulates, resuming mid-lag where the previous call stopped.
+    float zeroLag = (float)_zeroLagSum / (float)_samples;
+    while (budget > 0 && _lag <= _maxLag) {
+        uint16_t span = _samples - _lag;
+        uint16_t steps = span - _index;
+        if (steps > budget) steps = (uint16_t)budget;
+        const int32_t* a = &_x[_index];
+        const int32_t* b = &_x[_index + _lag];
+        int64_t acc = _lagSum;
+        for (uint16_t i = 0; i < steps; i++) acc += (int64_t)a[i] * b[i];
+        _lagSum = acc;
+        _index += steps;
+        budget -= steps;
+        if (_index < span) break;
+
+        float score = ((float)_lagSum / (float)span) / zeroLag;
+        // The previous lag is a peak when it is at least as strong as both neighbours; lag 1 has no usable left neighbour.
+        uint16_t previousLag = _lag - 1;
+        if (previousLag >= 1 && _prevScore >= score && (previousLag == 1 || _prevScore >= _prevPrevScore) &&
+            _prevScore >= CPR_DETECT_MIN_CORRELATION) {
+            float window = _expectedCounts * CPR_DETECT_TOLERANCE;
+            if (window < 1.0f) window = 1.0f;
+            if (_prevScore > _globalScore) {
+                _globalScore = _prevScore;
+                _globalLag = previousLag;
+            }
+            if (fabsf((float)previousLag - _expectedCounts) <= window) {
+                if (_prevScore > _bestScore) {
+                    _runnerUpScore = _bestScore;
+                    _bestScore = _prevScore;
+                    _bestLag = previousLag;
+                } else if (_prevScore > _runnerUpScore) {
+                    _runnerUpScore = _prevScore;
+                }
+            }
+        }
+        _prevPrevScore = _prevScore;
+        _prevScore = score;
+        _lag++;
+        _index = 0;
+        _lagSum = 0;
+    }
+
+    if (_lag > _maxLag) finish();
+    return _finished;
+}
+
+uint8_t CprDetector::getProgressPercent() const {
+    if (_finished) return 100;
+    if (_maxLag == 0 || _lag == 0) return 0;
+    return (uint8_t)((100U * (_lag - 1U)) / _maxLag);
+}
+
+void CprDetector::finish() {
+    float expected = _expectedCounts;
+    float span = expected * CPR_DETECT_TOLERANCE;
+    float window = span < 1.0f ? 1.0f : span;
+    // The expected count stands alone when it is close to one whole count and the pulley tolerance cannot reach the next one.
+    long rounded = lroundf(expected);
+    float residual = fabsf(expected - (float)rounded);
+    bool expectedIsUnique = rounded >= 1 && residual <= CPR_DETECT_ROUNDING_COUNTS && (1.0f - residual) > span;
+
+    float expectedConfidence = expectedIsUnique ? CPR_DETECT_EXPECTED_ONLY_CONFIDENCE * (1.0f - residual) : 0.0f;
+
+    // A repeat near the expected count is the strongest evidence; agreement with the pulley estimate scales how far it is trusted.
+    float repeatConfidence = 0.0f;
+    bool ambiguous = false;
+    if (_bestLag > 0) {
+        float agreement = 1.0f - (fabsf((float)_bestLag - expected) / window);
+        if (agreement < 0.0f) agreement = 0.0f;
+        repeatConfidence = (_bestScore > 1.0f ? 1.0f : _bestScore) * (0.5f + (0.5f * agreement));
+        ambiguous = _runnerUpScore >= _bestScore * CPR_DETECT_AMBIGUOUS_RATIO;
+        if (ambiguous) repeatConfidence *= 0.5f;
+    }
+
+    _detectedCounts = 0;
+    _correlation = 0.0f;
+    _confidence = 0.0f;
+    // A coarse sensor's short capture can throw up a weak chance repeat, which is no better evidence than the expectation alone.
+    if (_bestLag > 0 && repeatConfidence >= expectedConfidence) {
+        _detectedCounts = _bestLag;
+        _correlation = _bestScore;
+        _confidence = repeatConfidence;
+        _message = ambiguous ? "Several similar repeats near expected count" : "Repeat found near expected count";
+    } else if (expectedIsUnique) {
+        // Coarse sensors repeat too rarely within the capture to correlate, so the rounded expectation is offered at reduced confidence.
+        _detectedCounts = (uint16_t)rounded;
+        _confidence = expectedConfidence;
+        _message = "No repeat pattern; using expected count";
+    } else if (_globalLag > 0) {
+        _detectedCounts = _globalLag;
+        _correlation = _globalScore;
+        _message = "Repeat disagrees with pulley ratio";
+    } else if (expected > (float)_maxLag) {
+        _message = "Too few intervals for this counts/rev";
+    } else {
+        _message = "No repeat pattern in edge intervals";
+    }
+
+    if (_detectedCounts > CPR_DETECT_MAX_COUNTS) {
+        _detectedCounts = 0;
+        _confidence = 0.0f;
+    }
+    _finished = true;
+}
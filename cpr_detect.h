@@ -0,0 +1,82 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef CPR_DETECT_H
+#define CPR_DETECT_H
+
+#include <stdint.h>
+
+/*
+ * Counts/rev detection from a running platter's edge intervals.
+ *
+ * Every sensor has some once-per-revolution pattern in its edge spacing: a
+ * slot cut slightly wide, an encoder mounted a little off centre, a magnet
+ * set a fraction out of line. The intervals therefore repeat every
+ * revolution, and the lag of the strongest repeat is the counts/rev.
+ *
+ * - Intervals become deviations from their mean. One far outside the usual
+ *   spread, a missed or doubled edge, counts as no deviation, so it cannot
+ *   outweigh a defect of a few percent.
+ * - The normalised autocorrelation is scored lag by lag up to a third of
+ *   the capture, within a budget of multiply-accumulates per call, so the
+ *   analysis can run a slice at a time from a control loop.
+ * - Local peaks within the pulley tolerance of the expected count compete;
+ *   agreement with the expectation scales the confidence, and a second
+ *   peak nearly as strong halves it.
+ * - A coarse sensor repeats too rarely to correlate. When the expected count
+ *   lies close to one whole count and the tolerance cannot reach the next,
+ *   that count is offered at reduced confidence instead.
+ *
+ * No Arduino headers are used so synthetic interval streams can be analysed on a host.
+ */
+class CprDetector {
+public:
+    CprDetector();
+
+    // Starts analysis of count intervals in microseconds, which are turned into deviations in place and must stay
+    // untouched until it finishes. Returns false with a message when they cannot be analysed.
+    bool begin(uint32_t* intervalsUs, uint16_t count, float expectedRpm);
+    // Spends up to budget multiply-accumulates; returns true once the result is ready.
+    bool analyse(uint32_t budget);
+
+    bool isFinished() const { return _finished; }
+    uint16_t getDetectedCounts() const { return _detectedCounts; }
+    float getExpectedCounts() const { return _expectedCounts; }
+    float getCorrelation() const { return _correlation; }
+    float getConfidence() const { return _confidence; }
+    const char* getMessage() const { return _message; }
+    uint16_t getSamples() const { return _samples; }
+    // Share of the lags scored so far, 0 to 100.
+    uint8_t getProgressPercent() const;
+
+private:
+    void finish();
+
+    const int32_t* _x;
+    uint16_t _samples;
+    uint16_t _maxLag;
+    uint16_t _lag;
+    uint16_t _index;
+    float _expectedCounts;
+    int64_t _zeroLagSum;
+    int64_t _lagSum;
+    float _prevScore;
+    float _prevPrevScore;
+    uint16_t _bestLag;
+    float _bestScore;
+    float _runnerUpScore;
+    uint16_t _globalLag;
+    float _globalScore;
+    bool _finished;
+    uint16_t _detectedCounts;
+    float _correlation;
+    float _confidence;
+    const char* _message;
+};
+
+#endif // CPR_DETECT_H
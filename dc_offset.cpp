@@ -0,0 +1,191 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "dc_offset.h"
+#include <math.h>
+#include <string.h>
+
+DcOffsetCalibrator::DcOffsetCalibrator() {
+    memset(&_params, 0, sizeof(_params));
+    _step = DC_OFFSET_IDLE;
+    _channels = 0;
+    _channel = 0;
+    memset(_start, 0, sizeof(_start));
+    memset(_applied, 0, sizeof(_applied));
+    memset(_results, 0, sizeof(_results));
+    _zero = 0.0f;
+    _windowStartMs = 0;
+    _windowSum = 0.0f;
+    _windowCount = 0;
+    _lastOffset = 0.0f;
+    _lastError = 0.0f;
+}
+
+void DcOffsetCalibrator::begin(const DcOffsetParams& params, uint8_t channels, const float startCounts[4], uint32_t nowMs) {
+    _params = params;
+    _channels = channels > 4 ? 4 : channels;
+    for (uint8_t i = 0; i < 4; i++) {
+        _start[i] = isfinite(startCounts[i]) ? startCounts[i] : 0.0f;
+        _applied[i] = _start[i];
+        memset(&_results[i], 0, sizeof(_results[i]));
+        _results[i].offsetCounts = _start[i];
+    }
+    _zero = 0.0f;
+    _channel = 0;
+    if (_channels == 0) {
+        _step = DC_OFFSET_IDLE;
+        return;
+    }
+    _step = DC_OFFSET_ZERO;
+    startWindow(nowMs);
+}
+
+void DcOffsetCalibrator::cancel() {
+    if (_step == DC_OFFSET_IDLE) return;
+    uint8_t first = _step == DC_OFFSET_ZERO ? 0 : _channel;
+    for (uint8_t i = first; i < _channels; i++) {
+        _applied[i] = _start[i];
+        _results[i].offsetCounts = _start[i];
+        _results[i].outcome = DC_OFFSET_CANCELLED;
+    }
+    _step = DC_OFFSET_IDLE;
+}
+
+int8_t DcOffsetCalibrator::getSelectedChannel() const {
+    if (_step == DC_OFFSET_MEASURE || _step == DC_OFFSET_PROBE) return (int8_t)_channel;
+    return -1;
+}
+
+bool DcOffsetCalibrator::succeeded() const {
+    if (_step != DC_OFFSET_IDLE || _channels == 0) return false;
+    for (uint8_t i = 0; i < _channels; i++) {
+        if (_results[i].outcome != DC_OFFSET_NULLED) return false;
+    }
+    return true;
+}
+
+void DcOffsetCalibrator::startWindow(uint32_t nowMs) {
+    _windowStartMs = nowMs;
+    _windowSum = 0.0f;
+    _windowCount = 0;
+}
+
+void DcOffsetCalibrator::startChannel(uint8_t channel, uint32_t nowMs) {
+    _channel = channel;
+    _applied[channel] = _start[channel];
+    _step = DC_OFFSET_MEASURE;
+    startWindow(nowMs);
+}
+
+void DcOffsetCalibrator::finishChannel(uint8_t outcome, uint32_t nowMs) {
+    DcOffsetChannel& result = _results[_channel];
+    result.outcome = outcome;
+    if (outcome != DC_OFFSET_NULLED) _applied[_channel] = _start[_channel];
+    result.offsetCounts = _applied[_channel];
+    if (_channel + 1 < _channels) {
+        startChannel(_channel + 1, nowMs);
+    } else {
+        _step = DC_OFFSET_IDLE;
+    }
+}
+
+bool DcOffsetCalibrator::update(float senseCounts, uint32_t nowMs) {
+    if (_step == DC_OFFSET_IDLE) return false;
+    uint32_t elapsed = nowMs - _windowStartMs;
+    if (elapsed < _params.settleMs) return true;
+    if (isfinite(senseCounts)) {
+        _windowSum += senseCounts;
+        _windowCount++;
+    }
+    if (elapsed < _params.settleMs + _params.averageMs || _windowCount == 0) return true;
+    float mean = _windowSum / (float)_windowCount;
+
+    if (_step == DC_OFFSET_ZERO) {
+        _zero = mean;
+        startChannel(0, nowMs);
+    } else if (_step == DC_OFFSET_PROBE) {
+        DcOffsetChannel& result = _results[_channel];
+        float error = mean - _zero;
+        float gain = (error - _lastError) / _params.probeCounts;
+        if (!(fabsf(gain) >= _params.minGain)) {
+            finishChannel(DC_OFFSET_NO_RESPONSE, nowMs);
+            return isRunning();
+        }
+        result.gain = gain;
+        result.residualCounts = _lastError / gain;
+        _lastOffset = _applied[_channel];
+        _lastError = error;
+        float next = _applied[_channel] - error / gain;
+        if (fabsf(next) > _params.maxCounts) {
+            finishChannel(DC_OFFSET_OUT_OF_RANGE, nowMs);
+            return isRunning();
+        }
+        _applied[_channel] = next;
+        _step = DC_OFFSET_MEASURE;
+        startWindow(nowMs);
+    } else {
+        measured(mean - _zero, nowMs);
+    }
+    return isRunning();
+}
+
+void DcOffsetCalibrator::measured(float errorCounts, uint32_t nowMs) {
+    DcOffsetChannel& result = _results[_channel];
+    float offset = _applied[_channel];
+    if (result.gain == 0.0f) {
+        // First reading of this channel; the probe that follows gives the gain.
+        _lastOffset = offset;
+        _lastError = errorCounts;
+        _applied[_channel] = offset + _params.probeCounts;
+        _step = DC_OFFSET_PROBE;
+        startWindow(nowMs);
+        return;
+    }
+
+    result.iterations++;
+    result.residualCounts = errorCounts / result.gain;
+    if (fabsf(result.residualCounts) <= _params.toleranceCounts) {
+        finishChannel(DC_OFFSET_NULLED, nowMs);
+        return;
+    }
+    if (result.iterations >= _params.maxIterations) {
+        finishChannel(DC_OFFSET_NOT_CONVERGED, nowMs);
+        return;
+    }
+
+    // Secant refinement of the gain. A step that is too small or disagrees wildly is noise, and the probe's gain is kept.
+    float moved = offset - _lastOffset;
+    if (fabsf(moved) > 0.25f * _params.toleranceCounts) {
+        float gain = (errorCounts - _lastError) / moved;
+        float ratio = gain / result.gain;
+        if (ratio >= 0.5f && ratio <= 2.0f) result.gain = gain;
+    }
+    _lastOffset = offset;
+    _lastError = errorCounts;
+    float next = offset - errorCounts / result.gain;
+    if (fabsf(next) > _params.maxCounts) {
+        finishChannel(DC_OFFSET_OUT_OF_RANGE, nowMs);
+        return;
+    }
+    _applied[_channel] = next;
+    startWindow(nowMs);
+}
+
+int16_t dcOffsetToStored(float counts, float maxCounts) {
+    if (!isfinite(counts)) return 0;
+    if (counts > maxCounts) counts = maxCounts;
+    if (counts < -maxCounts) counts = -maxCounts;
+    float stored = roundf(counts * 256.0f);
+    if (stored > 32767.0f) stored = 32767.0f;
+    if (stored < -32768.0f) stored = -32768.0f;
+    return (int16_t)stored;
+}
+
+float dcOffsetFromStored(int16_t stored) {
+    return (float)stored / 256.0f;
+}
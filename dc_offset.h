@@ -0,0 +1,126 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef DC_OFFSET_H
+#define DC_OFFSET_H
+
+#include <stdint.h>
+
+/*
+ * DC offset nulling for linear amplifier channels.
+ *
+ * A linear amplifier that sits a little off zero at neutral drives a steady
+ * current through its winding: heat, and a torque pulse once per electrical
+ * cycle that the speed loop then has to fight. The fix is a small constant
+ * duty added to that channel.
+ *
+ * One sense input serves every channel. The mute relays connect one channel
+ * at a time, so the sense sees that channel alone:
+ *
+ * - Zero: every channel muted, the sense reading with no output.
+ * - Measure: a channel connected at neutral with its current correction.
+ * - Probe: the same with a known extra duty, which gives the sense gain in
+ *   ADC counts per duty count. No sense scaling has to be configured, and
+ *   an inverting amplifier is handled by a negative gain.
+ * - Iterate: the correction moves by the remaining error over the gain,
+ *   with the gain refined from successive measurements, until the residual
+ *   is inside the tolerance.
+ *
+ * Each reading is an average over a window that starts only after relays,
+ * amplifier and sense filter have settled. A channel that does not respond,
+ * needs more than the largest correction, or does not converge keeps the
+ * correction it started with.
+ *
+ * Corrections are stored in 1/256 duty-count steps; the waveform carries the
+ * fraction from sample to sample so the average duty matches exactly.
+ *
+ * No Arduino headers are used so the measurement loop can be run against a simulated sense on a host.
+ */
+struct DcOffsetParams {
+    uint32_t settleMs;       // Wait after a relay or duty change before readings count
+    uint32_t averageMs;      // Reading window after the settle time
+    float probeCounts;       // Extra duty used to measure the sense gain
+    float toleranceCounts;   // Residual offset, in duty counts, that ends a channel
+    float maxCounts;         // Largest correction; beyond it the channel has a fault, not an offset
+    float minGain;           // Sense counts per duty count below which a channel is not reaching the sense
+    uint8_t maxIterations;   // Corrections tried per channel after the probe
+};
+
+enum DcOffsetStep : uint8_t {
+    DC_OFFSET_IDLE = 0,
+    DC_OFFSET_ZERO,      // All channels muted
+    DC_OFFSET_MEASURE,   // One channel connected at its correction
+    DC_OFFSET_PROBE      // One channel connected with the probe duty added
+};
+
+enum DcOffsetOutcome : uint8_t {
+    DC_OFFSET_NOT_RUN = 0,
+    DC_OFFSET_NULLED,
+    DC_OFFSET_NO_RESPONSE,   // Probe did not move the sense
+    DC_OFFSET_OUT_OF_RANGE,  // Needed more than the largest correction
+    DC_OFFSET_NOT_CONVERGED, // Residual still over the tolerance after every iteration
+    DC_OFFSET_CANCELLED
+};
+
+struct DcOffsetChannel {
+    float offsetCounts;    // Correction to keep: the new one when nulled, otherwise the starting one
+    float residualCounts;  // Offset left at the last reading, in duty counts
+    float gain;            // Sense counts per duty count, 0 before the probe
+    uint8_t iterations;
+    uint8_t outcome;
+};
+
+class DcOffsetCalibrator {
+public:
+    DcOffsetCalibrator();
+
+    void begin(const DcOffsetParams& params, uint8_t channels, const float startCounts[4], uint32_t nowMs);
+    // Restores every unfinished channel's starting correction.
+    void cancel();
+    // Feeds one sense reading in ADC counts. Returns true while calibration is still running.
+    bool update(float senseCounts, uint32_t nowMs);
+
+    bool isRunning() const { return _step != DC_OFFSET_IDLE; }
+    uint8_t getStep() const { return _step; }
+    uint8_t getChannelCount() const { return _channels; }
+    // Channel the relays should connect now, or -1 for none.
+    int8_t getSelectedChannel() const;
+    // Correction the waveform should apply to a channel now.
+    float getAppliedCounts(uint8_t channel) const { return channel < 4 ? _applied[channel] : 0.0f; }
+    const DcOffsetChannel& getChannel(uint8_t channel) const { return _results[channel < 4 ? channel : 0]; }
+    float getZeroCounts() const { return _zero; }
+    // True once every channel has finished and all of them nulled.
+    bool succeeded() const;
+
+private:
+    void startWindow(uint32_t nowMs);
+    void startChannel(uint8_t channel, uint32_t nowMs);
+    void finishChannel(uint8_t outcome, uint32_t nowMs);
+    void measured(float errorCounts, uint32_t nowMs);
+
+    DcOffsetParams _params;
+    uint8_t _step;
+    uint8_t _channels;
+    uint8_t _channel;
+    float _start[4];
+    float _applied[4];
+    DcOffsetChannel _results[4];
+    float _zero;
+    uint32_t _windowStartMs;
+    float _windowSum;
+    uint32_t _windowCount;
+    // The previous reading of the current channel, for the probe and the secant gain update.
+    float _lastOffset;
+    float _lastError;
+};
+
+// 1/256 duty-count storage, clamped to the largest correction.
+int16_t dcOffsetToStored(float counts, float maxCounts);
+float dcOffsetFromStored(int16_t stored);
+
+#endif // DC_OFFSET_H
@@ -0,0 +1,87 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "dds_increment.h"
+#include <float.h>
+#include <math.h>
+
+static const double DDS_ACCUMULATOR_SCALE_64 = 18446744073709551616.0;
+
+double ddsSampleRateHz(const DdsClock& clock) {
+    if (clock.clockHz == 0 || clock.divider16 == 0 || clock.periodCounts == 0) return 0.0;
+    return ((double)clock.clockHz * 16.0) / ((double)clock.divider16 * (double)clock.periodCounts);
+}
+
+uint64_t ddsRoundedIncrement(float freq, double sampleRateHz) {
+    if (!isfinite(freq) || !(sampleRateHz > 0.0)) return 0;
+    // A double holds the 32.32 increment to within a few fraction LSBs, far below the float frequency's own resolution.
+    double incD = (double)freq * (DDS_ACCUMULATOR_SCALE_64 / sampleRateHz);
+    if (!isfinite(incD) || fabs(incD) >= 9.0e18) return 0;
+    return (uint64_t)llround(incD);
+}
+
+bool ddsRationalFrequency(float freq, uint32_t maxDenominator, uint64_t& numerator, uint64_t& denominator) {
+    if (!isfinite(freq)) return false;
+    /*
+     * Walk the continued-fraction convergents of the frequency and take the
+     * first one the float cannot tell apart from it. A stored 33.333332 is
+     * then 100/3 Hz, while a frequency with no small fraction keeps the
+     * rounded path.
+     */
+    double x = fabs((double)freq);
+    double tolerance = x * (double)FLT_EPSILON;
+    double rest = x - floor(x);
+    uint64_t h = (uint64_t)floor(x);
+    uint64_t k = 1;
+    uint64_t hPrev = 1;
+    uint64_t kPrev = 0;
+    for (int term = 0; term < 24; term++) {
+        if (fabs((double)h / (double)k - x) <= tolerance) {
+            numerator = h;
+            denominator = k;
+            return true;
+        }
+        if (rest < 1e-12) break;
+        double inverse = 1.0 / rest;
+        double a = floor(inverse);
+        rest = inverse - a;
+        uint64_t hNext = (uint64_t)a * h + hPrev;
+        uint64_t kNext = (uint64_t)a * k + kPrev;
+        if (kNext > maxDenominator) break;
+        hPrev = h;
+        kPrev = k;
+        h = hNext;
+        k = kNext;
+    }
+    return false;
+}
+
+bool ddsRationalIncrement(uint64_t numerator, uint64_t denominator, bool reverse, const DdsClock& clock,
+                          uint32_t unitSamples, DdsRationalIncrement& result) {
+    if (denominator == 0 || clock.clockHz == 0 || clock.divider16 == 0 || clock.periodCounts == 0) return false;
+    uint64_t top = numerator * (uint64_t)clock.divider16 * (uint64_t)clock.periodCounts;
+    uint64_t bottom = denominator * (uint64_t)clock.clockHz * 16u;
+    if (top >= bottom) return false;
+    uint64_t inc = 0;
+    uint64_t remainder = top;
+    for (int bit = 0; bit < 64; bit++) {
+        remainder <<= 1;
+        inc <<= 1;
+        if (remainder >= bottom) {
+            remainder -= bottom;
+            inc |= 1u;
+        }
+    }
+
+    uint64_t perUnit = remainder * (uint64_t)unitSamples;
+    result.increment = reverse ? (uint64_t)0 - inc : inc;
+    result.denominator = remainder != 0 ? bottom : 0;
+    result.unitCarry = (uint32_t)(perUnit / bottom);
+    result.unitRemainder = perUnit % bottom;
+    return true;
+}
@@ -0,0 +1,84 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef DDS_INCREMENT_H
+#define DDS_INCREMENT_H
+
+#include <stdint.h>
+
+/*
+ * Phase increments for the 32.32 master DDS accumulator.
+ *
+ * The upper word of the accumulator is the LUT phase and the lower word a
+ * fraction of it, so one full cycle is 2^64. The sample rate is the system
+ * clock over the 8.4 PWM divider and the PWM period, which makes the ideal
+ * increment for a rational frequency h/k Hz the exact quotient
+ *
+ *   h * divider16 * period * 2^64 / (k * clock * 16)
+ *
+ * of integers below 2^48. Long division gives the 64-bit increment and a
+ * remainder; carrying that remainder per block of samples keeps the phase
+ * exact over any run length. Frequencies with no small fraction use a
+ * rounded increment instead.
+ *
+ * No Arduino headers are used so billions of samples can be run on a host
+ * and the accumulated phase compared with the exact target.
+ */
+struct DdsClock {
+    uint32_t clockHz;       // System clock feeding the PWM slices
+    uint16_t divider16;     // PWM divider in 8.4 fixed point, as programmed
+    uint32_t periodCounts;  // PWM counts per sample, wrap + 1
+};
+
+struct DdsRationalIncrement {
+    uint64_t increment;      // 32.32 increment per sample; two's complement when running in reverse
+    uint64_t denominator;    // Remainder denominator; 0 when the increment is exact
+    uint32_t unitCarry;      // Whole fraction LSBs the remainder adds per block unit
+    uint64_t unitRemainder;  // What is left per block unit, over denominator
+};
+
+// Sample rate the DDS runs at for a programmed clock and divider.
+double ddsSampleRateHz(const DdsClock& clock);
+
+// 32.32 increment rounded from double precision. Out-of-range frequencies give 0.
+uint64_t ddsRoundedIncrement(float freq, double sampleRateHz);
+
+// First continued-fraction convergent of |freq| that a float cannot tell apart from it, with a denominator of at most
+// maxDenominator. Returns false when there is none.
+bool ddsRationalFrequency(float freq, uint32_t maxDenominator, uint64_t& numerator, uint64_t& denominator);
+
+// Exact increment for numerator/denominator Hz, with the remainder split per block of unitSamples. Returns false when
+// the frequency is at or above the sample rate.
+bool ddsRationalIncrement(uint64_t numerator, uint64_t denominator, bool reverse, const DdsClock& clock,
+                          uint32_t unitSamples, DdsRationalIncrement& result);
+
+// Advances the 32.32 accumulator by one sample. Inline because it runs for every sample in the RAM-resident buffer fill.
+static inline void ddsAdvance(uint32_t& phase, uint32_t& frac, uint32_t inc, uint32_t incFrac) {
+    uint32_t next = frac + incFrac;
+    phase += inc + (next < frac ? 1u : 0u);
+    frac = next;
+}
+
+// Remainder LSBs a block of whole units adds, with the leftover below one LSB kept in remainderAcc for the next block.
+// Only compares and subtracts, so no 64-bit division runs in the IRQ.
+static inline uint32_t ddsBlockCarry(uint32_t unitCarry, uint64_t unitRemainder, uint64_t denominator, int units,
+                                     uint64_t& remainderAcc) {
+    uint32_t carry = 0;
+    if (denominator == 0) return 0;
+    for (int unit = 0; unit < units; unit++) {
+        carry += unitCarry;
+        remainderAcc += unitRemainder;
+        if (remainderAcc >= denominator) {
+            remainderAcc -= denominator;
+            carry++;
+        }
+    }
+    return carry;
+}
+
+#endif // DDS_INCREMENT_H
@@ -0,0 +1,26 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "dead_time.h"
+#include <math.h>
+
+int32_t deadTimeSoftLut(float softDegrees, int32_t lutPeak) {
+    int32_t soft = (int32_t)((float)lutPeak * sinf(softDegrees * 3.14159265f / 180.0f));
+    return soft < 1 ? 1 : soft;
+}
+
+float deadTimeCounts(float ns, float periodHz, int32_t top) {
+    float counts = ns * 1e-9f * periodHz * ((float)top + 1.0f);
+    if (!isfinite(counts) || counts < 0.0f) return 0.0f;
+    return counts;
+}
+
+int32_t deadTimeScaleQ16(float counts, int32_t softLut) {
+    if (!(counts > 0.0f) || softLut < 1) return 0;
+    return (int32_t)((counts * 65536.0f) / (float)softLut);
+}
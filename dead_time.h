@@ -0,0 +1,50 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef DEAD_TIME_H
+#define DEAD_TIME_H
+
+#include <stdint.h>
+
+/*
+ * Dead-time compensation for the 3PWM bridge.
+ *
+ * During dead time both switches of a leg are off and the freewheel diodes
+ * set the phase voltage by current direction: current out of the leg loses
+ * the dead time from the high-side pulse, current into it gains it. The loss
+ * flips with the current, so it adds a square wave that distorts the drive
+ * around every current zero, where a slow synchronous motor is most
+ * sensitive.
+ *
+ * The board has no current sense, so the current is taken to be the drive
+ * sine delayed by a tuned lag. The correction is the dead time with the sign
+ * of that sine. Near its zero crossing the sign is uncertain, so inside a
+ * soft zone the correction follows the sine linearly instead of stepping.
+ *
+ * No Arduino headers are used so the correction can be run against a
+ * simulated inductive load on a host.
+ */
+
+// Soft zone half-width in LUT units: the value a sine of peak lutPeak reaches softDegrees after its zero.
+int32_t deadTimeSoftLut(float softDegrees, int32_t lutPeak);
+
+// Converts a dead time to counts of the PWM counter. Negative or non-finite results give 0.
+float deadTimeCounts(float ns, float periodHz, int32_t top);
+
+// Q16 scale turning a LUT value at the edge of the soft zone into the full correction.
+int32_t deadTimeScaleQ16(float counts, int32_t softLut);
+
+// Correction in duty counts for a leg whose estimated current is currentShape, a LUT sample at the lagged phase.
+// Inline because it runs for every sample in the RAM-resident buffer fill.
+static inline int32_t deadTimeCorrection(int32_t currentShape, int32_t softLut, int32_t scaleQ16) {
+    if (currentShape > softLut) currentShape = softLut;
+    else if (currentShape < -softLut) currentShape = -softLut;
+    return (currentShape * scaleQ16) >> 16;
+}
+
+#endif // DEAD_TIME_H
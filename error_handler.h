@@ -27,7 +27,11 @@ enum ErrorCode {
     ERR_RESET_CAUSE = 8,
     ERR_WAVEFORM_HEALTH = 9,
     ERR_SETTINGS_ROLLBACK = 10,
-    ERR_POWER_STAGE_FAULT = 11
+    ERR_POWER_STAGE_FAULT = 11,
+    ERR_MOTOR_THERMAL = 12,
+    ERR_BUS_VOLTAGE = 13,
+    ERR_MOTOR_HEALTH = 14,
+    ERR_OUTPUT_OFFSET = 15
 };
 
 /**
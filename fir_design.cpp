@@ -0,0 +1,116 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "fir_design.h"
+#include <math.h>
+#include <string.h>
+
+static const double FIR_PI = 3.14159265358979323846;
+// Below 21 dB the Kaiser window is a plain rectangle; above 90 dB Q15 rounding sets the floor anyway.
+static const float FIR_MIN_STOPBAND_DB = 21.0f;
+static const float FIR_MAX_STOPBAND_DB = 90.0f;
+// Band edges are kept off DC and Nyquist so the sinc stays well defined at every supported carrier.
+static const double FIR_MIN_EDGE = 0.005;
+static const double FIR_MAX_CUTOFF = 0.45;
+static const double FIR_MAX_TRANSITION = 0.5;
+
+// Zeroth-order modified Bessel function of the first kind, by its power series.
+static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+    for (int k = 1; k < 50; k++) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+static double kaiserBeta(double stopbandDb) {
+    if (stopbandDb > 50.0) return 0.1102 * (stopbandDb - 8.7);
+    return 0.5842 * pow(stopbandDb - 21.0, 0.4) + 0.07886 * (stopbandDb - 21.0);
+}
+
+bool designLowPassFir(const FirDesignParams& params, float sampleRateHz, FirKernel& kernel) {
+    memset(&kernel, 0, sizeof(kernel));
+    if (!(sampleRateHz > 0.0f) || !isfinite(sampleRateHz)) return false;
+
+    double fs = sampleRateHz;
+    double cutoff = isfinite(params.cutoffHz) ? params.cutoffHz / fs : FIR_MAX_CUTOFF;
+    double transition = isfinite(params.transitionHz) ? params.transitionHz / fs : FIR_MAX_TRANSITION;
+    if (cutoff < FIR_MIN_EDGE) cutoff = FIR_MIN_EDGE;
+    if (cutoff > FIR_MAX_CUTOFF) cutoff = FIR_MAX_CUTOFF;
+    if (transition < FIR_MIN_EDGE) transition = FIR_MIN_EDGE;
+    if (transition > FIR_MAX_TRANSITION) transition = FIR_MAX_TRANSITION;
+    float stopbandDb = params.stopbandDb;
+    if (!(stopbandDb >= FIR_MIN_STOPBAND_DB)) stopbandDb = FIR_MIN_STOPBAND_DB;
+    if (stopbandDb > FIR_MAX_STOPBAND_DB) stopbandDb = FIR_MAX_STOPBAND_DB;
+    uint8_t budget = params.tapBudget;
+    if (budget < FIR_MIN_TAPS) budget = FIR_MIN_TAPS;
+    if (budget > FIR_MAX_TAPS) budget = FIR_MAX_TAPS;
+
+    // Kaiser's length estimate: the window shape fixes attenuation, length buys transition width.
+    double widthFactor = (stopbandDb - 7.95) / 2.285;
+    double wanted = ceil(widthFactor / (2.0 * FIR_PI * transition)) + 1.0;
+    uint8_t taps = wanted > (double)budget ? budget : (uint8_t)wanted;
+    if (taps < FIR_MIN_TAPS) taps = FIR_MIN_TAPS;
+
+    double beta = kaiserBeta(stopbandDb);
+    double norm = besselI0(beta);
+    double centre = (taps - 1) * 0.5;
+    uint8_t halfCount = (uint8_t)((taps + 1) / 2);
+    double h[FIR_MAX_HALF_TAPS];
+    double sum = 0.0;
+    for (uint8_t i = 0; i < halfCount; i++) {
+        double t = (double)i - centre;
+        double x = 2.0 * cutoff * t;
+        double sinc = (fabs(x) < 1e-12) ? 1.0 : sin(FIR_PI * x) / (FIR_PI * x);
+        double r = t / centre;
+        double window = besselI0(beta * sqrt(fmax(0.0, 1.0 - r * r))) / norm;
+        h[i] = 2.0 * cutoff * sinc * window;
+        bool centreTap = (taps & 1) && i == halfCount - 1;
+        sum += centreTap ? h[i] : 2.0 * h[i];
+    }
+
+    // Round to Q15, then put the rounding error back on the centre so the DC gain stays at one. An even kernel's total is always even, so its error splits exactly across the inner pair.
+    int32_t total = 0;
+    for (uint8_t i = 0; i < halfCount; i++) {
+        int32_t q = (int32_t)lround(h[i] / sum * 32768.0);
+        kernel.half[i] = (int16_t)q;
+        bool centreTap = (taps & 1) && i == halfCount - 1;
+        total += centreTap ? q : 2 * q;
+    }
+    int32_t error = 32768 - total;
+    int32_t last = kernel.half[halfCount - 1];
+    last += (taps & 1) ? error : error / 2;
+    if (last > 32767) last = 32767;
+    kernel.half[halfCount - 1] = (int16_t)last;
+
+    kernel.taps = taps;
+    kernel.stopbandDb = stopbandDb;
+    kernel.transitionHz = (float)(widthFactor / (2.0 * FIR_PI * (taps - 1)) * fs);
+    return true;
+}
+
+float firResponseDb(const FirKernel& kernel, float freqHz, float sampleRateHz) {
+    if (kernel.taps == 0 || !(sampleRateHz > 0.0f)) return 0.0f;
+    // A symmetric kernel's response is a cosine series about its centre; the linear-phase term has unit magnitude.
+    double w = 2.0 * FIR_PI * (double)freqHz / (double)sampleRateHz;
+    double centre = (kernel.taps - 1) * 0.5;
+    uint8_t halfCount = (uint8_t)((kernel.taps + 1) / 2);
+    double amplitude = 0.0;
+    for (uint8_t i = 0; i < halfCount; i++) {
+        double c = kernel.half[i] / 32768.0;
+        bool centreTap = (kernel.taps & 1) && i == halfCount - 1;
+        amplitude += centreTap ? c : 2.0 * c * cos(w * (centre - (double)i));
+    }
+    amplitude = fabs(amplitude);
+    if (amplitude < 1e-9) amplitude = 1e-9;
+    return (float)(20.0 * log10(amplitude));
+}
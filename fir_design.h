@@ -0,0 +1,54 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef FIR_DESIGN_H
+#define FIR_DESIGN_H
+
+#include <stdint.h>
+
+/*
+ * Low-pass FIR design for the waveform output filter.
+ *
+ * Kernels are Kaiser-windowed sincs. The stopband target sets the window
+ * shape; the length is the shortest that reaches the requested transition
+ * width, capped by the tap budget. A capped kernel keeps its attenuation and
+ * widens the transition instead, and the width it actually reaches is
+ * reported with the kernel. Kaiser's estimates are loose for short kernels:
+ * below about 16 taps the stopband can sit up to 5 dB above the target.
+ *
+ * Kernels are linear phase, so only half the coefficients are stored and the
+ * filter adds each mirrored pair of samples before multiplying. Coefficients
+ * are Q15 and sum to exactly 32768, so DC and the drive frequency pass at
+ * unity gain whatever the length.
+ *
+ * No Arduino headers are used so designs can be checked against reference filters on a host.
+ */
+static const uint8_t FIR_MIN_TAPS = 4;
+static const uint8_t FIR_MAX_TAPS = 32;
+static const uint8_t FIR_MAX_HALF_TAPS = FIR_MAX_TAPS / 2;
+
+struct FirDesignParams {
+    float cutoffHz;      // Middle of the transition band, where the response is -6 dB
+    float transitionHz;  // Width from the passband edge to the stopband edge
+    uint8_t tapBudget;   // Longest kernel allowed, FIR_MIN_TAPS to FIR_MAX_TAPS
+    float stopbandDb;    // Attenuation the window is shaped for
+};
+
+struct FirKernel {
+    uint8_t taps;                       // Zero until a design has been loaded
+    int16_t half[FIR_MAX_HALF_TAPS];    // Q15, outer tap first; the last entry is the centre tap when taps is odd
+    float transitionHz;                 // Width reached at this length
+    float stopbandDb;
+};
+
+// Returns false, leaving taps at zero so the filter passes samples through, when the sample rate is unusable.
+bool designLowPassFir(const FirDesignParams& params, float sampleRateHz, FirKernel& kernel);
+// Magnitude of the quantised kernel at freqHz, in dB relative to DC.
+float firResponseDb(const FirKernel& kernel, float freqHz, float sampleRateHz);
+
+#endif // FIR_DESIGN_H
@@ -0,0 +1,108 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "health_trend.h"
+#include <math.h>
+#include <string.h>
+
+static_assert(sizeof(HealthRecord) == 32, "HealthRecord is stored on flash and must stay 32 bytes.");
+
+// Wear direction for each metric: +1 when a rising value means wear, -1 when a falling one does.
+static const int8_t HEALTH_WEAR_SIGN[HEALTH_METRIC_COUNT] = { 1, 1, 1, 1, -1 };
+
+static float metricValue(const HealthRecord& record, uint8_t metric) {
+    switch (metric) {
+        case HEALTH_CORRECTION: return record.correctionHz;
+        case HEALTH_LOCK_AMPLITUDE: return record.lockAmplitude;
+        case HEALTH_TIME_TO_LOCK: return record.timeToLockSec;
+        case HEALTH_ERROR_RMS: return record.errorRmsRpm;
+        default: return record.coastSec;
+    }
+}
+
+// Time to lock and coast-down are only present on some sessions; zero marks a missing value for them.
+static bool metricPresent(const HealthRecord& record, uint8_t metric, float value) {
+    if (!isfinite(value)) return false;
+    if (metric == HEALTH_TIME_TO_LOCK || metric == HEALTH_COAST) return value > 0.0f;
+    (void)record;
+    return true;
+}
+
+static void fitMetric(const HealthRecord* records, uint16_t count, uint8_t speed, uint8_t metric,
+                      const HealthTrendParams& params, HealthMetricTrend& trend) {
+    memset(&trend, 0, sizeof(trend));
+    // Sums are taken about the first point so runtimes in the millions of seconds do not swamp the fit in single precision.
+    double x0 = -1.0;
+    double n = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, syy = 0.0;
+    double minX = 0.0, maxX = 0.0;
+    for (uint16_t i = 0; i < count; i++) {
+        const HealthRecord& record = records[i];
+        if (!record.valid || record.speed != speed) continue;
+        float value = metricValue(record, metric);
+        if (!metricPresent(record, metric, value)) continue;
+        if (x0 < 0.0) x0 = record.runtimeSec;
+        double x = ((double)record.runtimeSec - x0) / 3600.0;
+        double y = value;
+        if (n == 0.0 || x < minX) minX = x;
+        if (n == 0.0 || x > maxX) maxX = x;
+        n += 1.0;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        syy += y * y;
+    }
+    trend.samples = (uint16_t)n;
+    if (n < 1.0) return;
+    trend.mean = (float)(sy / n);
+    if (n < 3.0) return;
+
+    double vxx = sxx - sx * sx / n;
+    double vxy = sxy - sx * sy / n;
+    double vyy = syy - sy * sy / n;
+    if (!(vxx > 1e-9)) return;
+    double slope = vxy / vxx;
+    trend.slopePerHour = (float)slope;
+    trend.change = (float)(slope * (maxX - minX));
+
+    // A perfect fit has no residual, so its t statistic is unbounded; report it as very large rather than dividing by zero.
+    double residual = vyy - slope * vxy;
+    if (residual < 0.0) residual = 0.0;
+    double standardError = sqrt(residual / (n - 2.0) / vxx);
+    double t = standardError > 0.0 ? slope / standardError : (slope != 0.0 ? (slope > 0.0 ? 1e6 : -1e6) : 0.0);
+    trend.tStat = (float)t;
+
+    trend.significant = n >= params.minSessions &&
+        fabs(t) >= params.minTStat &&
+        fabsf(trend.change) >= params.minChange[metric];
+    trend.worsening = trend.significant && trend.change * HEALTH_WEAR_SIGN[metric] > 0.0f;
+}
+
+void analyseHealthTrend(const HealthRecord* records, uint16_t count, uint8_t speed,
+                        const HealthTrendParams& params, HealthTrendResult& result) {
+    memset(&result, 0, sizeof(result));
+    uint32_t firstSec = 0;
+    uint32_t lastSec = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        if (!records[i].valid || records[i].speed != speed) continue;
+        if (result.sessions == 0 || records[i].runtimeSec < firstSec) firstSec = records[i].runtimeSec;
+        if (result.sessions == 0 || records[i].runtimeSec > lastSec) lastSec = records[i].runtimeSec;
+        result.sessions++;
+    }
+    result.spanHours = (float)(lastSec - firstSec) / 3600.0f;
+    for (uint8_t m = 0; m < HEALTH_METRIC_COUNT; m++) {
+        fitMetric(records, count, speed, m, params, result.metric[m]);
+    }
+
+    const HealthMetricTrend* t = result.metric;
+    if (t[HEALTH_CORRECTION].worsening) result.drift |= HEALTH_DRIFT_BELT;
+    if (t[HEALTH_LOCK_AMPLITUDE].worsening || t[HEALTH_TIME_TO_LOCK].worsening || t[HEALTH_COAST].worsening) {
+        result.drift |= HEALTH_DRIFT_BEARING;
+    }
+    if (t[HEALTH_ERROR_RMS].worsening && result.drift == HEALTH_DRIFT_NONE) result.drift |= HEALTH_DRIFT_STABILITY;
+}
@@ -0,0 +1,93 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef HEALTH_TREND_H
+#define HEALTH_TREND_H
+
+#include <stdint.h>
+
+/*
+ * Long-term belt and bearing health from per-session records.
+ *
+ * Each record summarises one running session at one speed: what the closed
+ * loop needed to hold lock, how long lock took, how steady it was, and the
+ * coast-down time when one was measured. Records are stamped with total motor
+ * runtime, so the trend axis is wear rather than calendar time.
+ *
+ * For each metric a least-squares line is fitted against runtime. A trend is
+ * significant when the slope's t statistic clears the threshold and the
+ * change it predicts across the history is larger than the metric's floor, so
+ * neither a noisy slope nor a tiny but consistent one raises a flag.
+ *
+ * - Belt stretch: the platter turns slower per drive hertz, so the mean
+ *   correction climbs.
+ * - Bearing wear: more drag, so lock needs more amplitude or takes longer,
+ *   and the platter coasts to a stop sooner.
+ * - Stability: the speed error RMS grows without either pattern.
+ *
+ * No Arduino headers are used so synthetic multi-month histories can be analysed on a host.
+ */
+enum HealthMetric : uint8_t {
+    HEALTH_CORRECTION = 0,
+    HEALTH_LOCK_AMPLITUDE,
+    HEALTH_TIME_TO_LOCK,
+    HEALTH_ERROR_RMS,
+    HEALTH_COAST,
+    HEALTH_METRIC_COUNT
+};
+
+// Bit flags, since a deck can show more than one kind of wear.
+enum HealthDrift : uint8_t {
+    HEALTH_DRIFT_NONE = 0,
+    HEALTH_DRIFT_BELT = 1,
+    HEALTH_DRIFT_BEARING = 2,
+    HEALTH_DRIFT_STABILITY = 4
+};
+
+// Stored on LittleFS as-is, so the layout is fixed at 32 bytes.
+struct HealthRecord {
+    uint32_t runtimeSec;   // Total motor runtime at the end of the session
+    float correctionHz;    // Mean closed-loop correction while locked
+    float lockAmplitude;   // Mean drive amplitude while locked, 0-1
+    float timeToLockSec;   // 0 when the start was not tracked to lock
+    float errorRmsRpm;     // RMS speed error while locked
+    float coastSec;        // Coast to a stop from run speed, 0 unless measured this session
+    uint16_t lockedSec;    // Locked time behind the means
+    uint8_t speed;         // 0-2 for 33, 45, 78
+    uint8_t valid;
+    uint32_t reserved;
+};
+
+struct HealthTrendParams {
+    uint8_t minSessions;                    // Fewer records than this are never flagged
+    float minTStat;                         // Slope t statistic needed to call a trend real
+    float minChange[HEALTH_METRIC_COUNT];   // Smallest predicted change across the history worth flagging
+};
+
+struct HealthMetricTrend {
+    uint16_t samples;
+    float mean;
+    float slopePerHour;  // Change per hour of motor runtime
+    float tStat;
+    float change;        // Change the fitted line predicts from the first to the last record
+    bool significant;
+    bool worsening;      // Significant and in the direction wear would move it
+};
+
+struct HealthTrendResult {
+    uint16_t sessions;
+    float spanHours;
+    HealthMetricTrend metric[HEALTH_METRIC_COUNT];
+    uint8_t drift;       // HealthDrift flags
+};
+
+// Analyses the records for one speed, in any order. Records for other speeds and invalid records are skipped.
+void analyseHealthTrend(const HealthRecord* records, uint16_t count, uint8_t speed,
+                        const HealthTrendParams& params, HealthTrendResult& result);
+
+#endif // HEALTH_TREND_H
@@ -0,0 +1,133 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "load_step.h"
+#include <math.h>
+
+LoadStepDetector::LoadStepDetector() {
+    _params.slopeRpmPerSec = 0.06f;
+    _params.slopeWindow = 3;
+    _params.minErrorRpm = 0.03f;
+    _params.confirmSamples = 3;
+    _params.armSec = 3.0f;
+    _params.settleSec = 2.0f;
+    _params.timeoutSec = 30.0f;
+    reset();
+}
+
+void LoadStepDetector::configure(const LoadStepParams& params) {
+    _params = params;
+    if (_params.confirmSamples < 1) _params.confirmSamples = 1;
+    if (_params.slopeWindow < 1) _params.slopeWindow = 1;
+    if (_params.slopeWindow > MAX_WINDOW) _params.slopeWindow = MAX_WINDOW;
+}
+
+void LoadStepDetector::reset() {
+    for (uint8_t i = 0; i <= MAX_WINDOW; i++) {
+        _errorHistory[i] = 0.0f;
+        _dtHistory[i] = 0.0f;
+    }
+    _historyNext = 0;
+    _historyCount = 0;
+    _confirmCount = 0;
+    _confirmSign = 0;
+    _integralBeforeHz = 0.0f;
+    _lockedSec = 0.0f;
+    _measuring = false;
+    _measureEvent = LOAD_STEP_NONE;
+    _measureSec = 0.0f;
+    _measurementReady = false;
+    _measurementSettled = false;
+    _measuredHz = 0.0f;
+    _loaded = false;
+}
+
+LoadStepEvent LoadStepDetector::update(float errorRpm, float dtSec, bool locked, float integralHz) {
+    if (!isfinite(errorRpm) || !(dtSec > 0.0f)) return LOAD_STEP_NONE;
+    _errorHistory[_historyNext] = errorRpm;
+    _dtHistory[_historyNext] = dtSec;
+    _historyNext = (uint8_t)((_historyNext + 1) % (MAX_WINDOW + 1));
+    if (_historyCount < MAX_WINDOW + 1) _historyCount++;
+    float slope = 0.0f;
+    uint8_t window = _params.slopeWindow;
+    if (_historyCount > window) {
+        // Walk back across the window: the span is the sum of the newer sample spacings.
+        float spanSec = 0.0f;
+        uint8_t index = _historyNext;
+        for (uint8_t i = 0; i < window; i++) {
+            index = (uint8_t)((index + MAX_WINDOW) % (MAX_WINDOW + 1));
+            spanSec += _dtHistory[index];
+        }
+        uint8_t oldest = (uint8_t)((index + MAX_WINDOW) % (MAX_WINDOW + 1));
+        if (spanSec > 0.0f) slope = (errorRpm - _errorHistory[oldest]) / spanSec;
+    }
+
+    // Arming is judged before this sample: by the time a step is confirmed the loop has usually already dropped out of lock.
+    bool wasArmed = isArmed();
+    if (locked) {
+        _lockedSec += dtSec;
+    } else {
+        _lockedSec = 0.0f;
+    }
+
+    if (_measuring) {
+        _measureSec += dtSec;
+        bool settled = _lockedSec >= _params.settleSec;
+        if (settled || _measureSec >= _params.timeoutSec) {
+            // A slow integral may still be climbing at the timeout; the partial change is still reported so learning can bootstrap.
+            _measuredHz = integralHz - _integralBeforeHz;
+            _measurementSettled = settled;
+            _measurementReady = true;
+            _measuring = false;
+        }
+        return LOAD_STEP_NONE;
+    }
+
+    int8_t sign = errorRpm >= 0.0f ? 1 : -1;
+    // A step drives error away from zero, so its slope shares the error's sign. Recovery and noise crossings do not.
+    bool growing = fabsf(slope) >= _params.slopeRpmPerSec && ((slope > 0.0f) == (sign > 0));
+    if (growing && (_confirmCount == 0 ? wasArmed : sign == _confirmSign)) {
+        if (_confirmCount == 0) {
+            _confirmSign = sign;
+            _integralBeforeHz = integralHz;
+        }
+        if (_confirmCount < 255) _confirmCount++;
+    } else {
+        _confirmCount = 0;
+    }
+
+    if (_confirmCount < _params.confirmSamples || fabsf(errorRpm) < _params.minErrorRpm) return LOAD_STEP_NONE;
+
+    LoadStepEvent event = sign > 0 ? LOAD_STEP_DROP : LOAD_STEP_LIFT;
+    _confirmCount = 0;
+    _loaded = event == LOAD_STEP_DROP;
+    _measuring = true;
+    _measureEvent = event;
+    _measureSec = 0.0f;
+    _lockedSec = 0.0f;
+    return event;
+}
+
+bool LoadStepDetector::takeMeasurement(LoadStepEvent& event, float& stepHz, bool& settled) {
+    if (!_measurementReady) return false;
+    _measurementReady = false;
+    event = _measureEvent;
+    stepHz = _measuredHz;
+    settled = _measurementSettled;
+    return true;
+}
+
+float loadStepSlewLimit(float previousHz, float requestedHz, float maxStepHz, float feedForwardHz) {
+    if (!(maxStepHz > 0.0f)) return requestedHz;
+    // The feed-forward moves the starting point, so only the PID's own change is rate limited.
+    float baseHz = previousHz + feedForwardHz;
+    float delta = requestedHz - baseHz;
+    if (delta > maxStepHz) return baseHz + maxStepHz;
+    if (delta < -maxStepHz) return baseHz - maxStepHz;
+    return requestedHz;
+}
@@ -0,0 +1,88 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef LOAD_STEP_H
+#define LOAD_STEP_H
+
+#include <stdint.h>
+
+/*
+ * Stylus-drag load step detection and step-size measurement.
+ *
+ * A needle drop is a near-instant increase in drag. While the loop is settled,
+ * speed error is noise around zero. After a drop the platter decelerates at a
+ * rate set by the added drag, so error and its slope share a sign and
+ * persist. A lift is the mirror image. The detector watches consecutive
+ * closed-loop samples for that pattern, and only while armed by a settled
+ * lock so ramps, engagement pull-in and hunting do not look like steps.
+ *
+ * After an event the loop is left to settle. The change in the PID integral
+ * from just before the step to the next settled lock is the correction that
+ * the step really needed, which the owner learns and replays as feed-forward.
+ *
+ * No Arduino headers are used so recorded transients can be replayed on a host.
+ */
+struct LoadStepParams {
+    float slopeRpmPerSec;  // Error slope, taken across the slope window, that counts towards a step
+    uint8_t slopeWindow;   // Samples spanned by the slope estimate, 1 to MAX_WINDOW
+    float minErrorRpm;     // Error that must already show before a step is confirmed
+    uint8_t confirmSamples;
+    float armSec;          // Settled lock needed before detection is armed
+    float settleSec;       // Settled lock that ends a measurement
+    float timeoutSec;      // Measurement abandoned if lock does not return
+};
+
+enum LoadStepEvent : uint8_t {
+    LOAD_STEP_NONE = 0,
+    LOAD_STEP_DROP,
+    LOAD_STEP_LIFT
+};
+
+class LoadStepDetector {
+public:
+    static const uint8_t MAX_WINDOW = 8;
+
+    LoadStepDetector();
+
+    void configure(const LoadStepParams& params);
+    void reset();
+    // errorRpm is target minus measured, so added drag drives it positive. integralHz is the PID integral before this sample's update.
+    LoadStepEvent update(float errorRpm, float dtSec, bool locked, float integralHz);
+    // Returns true once per finished measurement with the integral change across it. settled is false when lock did not
+    // return in time, in which case the change is a lower bound on what the step needed.
+    bool takeMeasurement(LoadStepEvent& event, float& stepHz, bool& settled);
+
+    bool isArmed() const { return !_measuring && _lockedSec >= _params.armSec; }
+    bool isMeasuring() const { return _measuring; }
+    bool isLoaded() const { return _loaded; }
+
+private:
+    LoadStepParams _params;
+    // Short history of error and sample spacing; a slope across several samples rejects sensor noise that a single difference would not.
+    float _errorHistory[MAX_WINDOW + 1];
+    float _dtHistory[MAX_WINDOW + 1];
+    uint8_t _historyNext;
+    uint8_t _historyCount;
+    uint8_t _confirmCount;
+    int8_t _confirmSign;
+    float _integralBeforeHz;
+    float _lockedSec;
+    bool _measuring;
+    LoadStepEvent _measureEvent;
+    float _measureSec;
+    bool _measurementReady;
+    bool _measurementSettled;
+    float _measuredHz;
+    bool _loaded;
+};
+
+// Slew limits a correction change to maxStepHz, except for a feed-forward step injected this update, which passes
+// whole. Left to the slew limit, a learned step would arrive no faster than the integral could have wound up on its own.
+float loadStepSlewLimit(float previousHz, float requestedHz, float maxStepHz, float feedForwardHz);
+
+#endif // LOAD_STEP_H
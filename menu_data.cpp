@@ -22,6 +22,10 @@ extern MotorController motor;
 
 // Per-speed shadow editing. Speed pages edit menuShadowSettings; Save writes it into settings, Cancel reloads persisted settings.
 char speedLabelBuffer[32];
+// Custom FIR inputs are per-speed arrays in GlobalSettings, so they are shadowed alongside menuShadowSettings.
+static float menuShadowFirCutoffHz = 5000.0f;
+static float menuShadowFirTransitionHz = 5000.0f;
+static uint8_t menuShadowFirTaps = FIR_MAX_TAPS;
 MenuItem* menuSpeedSelector = nullptr;
 MenuPage* pageNetwork = nullptr;
 MenuPage* pageClosedLoop = nullptr;
@@ -70,10 +74,10 @@ static const char* const motorTopologyLabels[] = {"Custom", "Twin Sync", "3-Phas
 static const char* const sweepParameterLabels[] = {"Sym Phase", "Phase A", "Phase B", "Phase C", "Phase D", "Gain A", "Gain B", "Gain C", "Gain D"};
 // Menu labels are deliberately short enough for the compact 128x64 layout.
 static const char* const filterLabels[] = {"None", "IIR", "FIR"};
-static const char* const firLabels[] = {"Gentle", "Medium", "Agg"};
+static const char* const firLabels[] = {"Gentle", "Medium", "Agg", "Custom"};
 static const char* const softStartCurveLabels[] = {"Linear", "Log", "Exp"};
 static const char* const rampTypeLabels[] = {"Linear", "S-Curve"};
-static const char* const brakeModeLabels[] = {"Off", "Pulse", "Ramp", "Soft"};
+static const char* const brakeModeLabels[] = {"Off", "Pulse", "Ramp", "Soft", "Tach"};
 static const char* const saverModeLabels[] = {"Bounce", "Matrix", "Liss"};
 static const char* const sleepDelayLabels[] = {"Off", "10s", "20s", "30s", "1m", "5m", "10m"};
 static const char* const bootSpeedLabels[] = {"33", "45", "78", "Last"};
@@ -82,13 +86,14 @@ static const char* const networkStandbyLabels[] = {"Network", "Eco"};
 static const char* const webHomeLabels[] = {"Dash", "Control", "Settings", "Cal", "Network", "Presets", "Bench", "Diag", "Errors"};
 #if CLOSED_LOOP_SPEED_ENABLE
 static const char* const closedLoopControlLabels[] = {"Monitor", "Correct"};
-static const char* const closedLoopSensorLabels[] = {"Pulse", "Quad"};
+static const char* const closedLoopSensorLabels[] = {"Pulse", "Quad", "Sensorless"};
 static const char* const closedLoopEdgeLabels[] = {"Rise", "Fall", "Change"};
 static const char* const closedLoopQuadLabels[] = {"x1", "x2", "x4"};
 static const char* const closedLoopFaultLabels[] = {"Ignore", "Warn", "Stop"};
 static const char* const closedLoopDropLabels[] = {"Open", "Hold", "Stop"};
 static const char* const closedLoopRampLabels[] = {"Off", "Track"};
 static const char* const closedLoopAmpRecoveryLabels[] = {"Off", "Warn", "Restore"};
+static const char* const closedLoopSlipLabels[] = {"Ignore", "Warn", "Boost", "Stop"};
 static const char* const closedLoopPitchTargetLabels[] = {"Fixed", "Follow"};
 #endif
 
@@ -155,10 +160,18 @@ void updateSpeedLabel() {
     }
 }
 
+void loadMenuShadowSettings() {
+    GlobalSettings& g = settings.get();
+    menuShadowSettings = g.speeds[menuShadowSpeedIndex];
+    menuShadowFirCutoffHz = g.firCutoffHz[menuShadowSpeedIndex];
+    menuShadowFirTransitionHz = g.firTransitionHz[menuShadowSpeedIndex];
+    menuShadowFirTaps = g.firTaps[menuShadowSpeedIndex];
+}
+
 void initMenuState() {
     // Called when the menu opens so edits begin from the currently selected motor speed.
     menuShadowSpeedIndex = (int)motor.getSpeed();
-    menuShadowSettings = settings.get().speeds[menuShadowSpeedIndex];
+    loadMenuShadowSettings();
     updateSpeedLabel();
 }
 
@@ -176,7 +189,7 @@ void actionNextSpeed() {
     }
 
     // Load new speed settings into shadow
-    menuShadowSettings = settings.get().speeds[menuShadowSpeedIndex];
+    loadMenuShadowSettings();
     updateSpeedLabel();
 }
 
@@ -184,7 +197,11 @@ void actionNextSpeed() {
 void commitMenuShadowSettings() {
     // Commit only the speed currently represented by menuShadowSettings.
     if (menuShadowSpeedIndex >= 0 && menuShadowSpeedIndex < 3) {
-        settings.get().speeds[menuShadowSpeedIndex] = menuShadowSettings;
+        GlobalSettings& g = settings.get();
+        g.speeds[menuShadowSpeedIndex] = menuShadowSettings;
+        g.firCutoffHz[menuShadowSpeedIndex] = menuShadowFirCutoffHz;
+        g.firTransitionHz[menuShadowSpeedIndex] = menuShadowFirTransitionHz;
+        g.firTaps[menuShadowSpeedIndex] = menuShadowFirTaps;
     }
 }
 
@@ -453,7 +470,7 @@ void actionEnterSweep() {
     pageSweep->addItem(new MenuFloat("Maximum", &sweepMaximum, 1.0, -360.0, 360.0));
     pageSweep->addItem(new MenuFloat("Speed/s", &sweepSpeed, 0.1, 0.1, 10.0));
     pageSweep->addItem(new MenuAction("Start Sweep", [](){
-        settings.get().speeds[menuShadowSpeedIndex] = menuShadowSettings;
+        commitMenuShadowSettings();
         motor.setSpeed((SpeedMode)menuShadowSpeedIndex);
         if (!motor.startOutputSweep((MotorController::OutputSweepParameter)sweepParameter,
                 sweepMinimum, sweepMaximum, sweepSpeed)) {
@@ -515,7 +532,7 @@ void actionEnterBrakeTune() {
     pageBrakeTune->clear();
 
     pageBrakeTune->addItem(new MenuInfo("Tune, Test, Save"));
-    pageBrakeTune->addItem(new MenuByte("Mode", &settings.get().brakeMode, 0, 3, brakeModeLabels, 4));
+    pageBrakeTune->addItem(new MenuByte("Mode", &settings.get().brakeMode, 0, 4, brakeModeLabels, 5));
 
     MenuItem* brakeDuration = new MenuFloat("Duration", &settings.get().brakeDuration, 0.1, 0.0, 10.0);
     brakeDuration->setVisibleWhen([](){ return settings.get().brakeMode != BRAKE_OFF; });
@@ -526,11 +543,11 @@ void actionEnterBrakeTune() {
     pageBrakeTune->addItem(brakePulse);
 
     MenuItem* brakeStart = new MenuFloat("Start Hz", &settings.get().brakeStartFreq, 1.0, 10.0, 200.0);
-    brakeStart->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP; });
+    brakeStart->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP || settings.get().brakeMode == BRAKE_TACH; });
     pageBrakeTune->addItem(brakeStart);
 
     MenuItem* brakeStop = new MenuFloat("Stop Hz", &settings.get().brakeStopFreq, 1.0, 0.0, 50.0);
-    brakeStop->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP; });
+    brakeStop->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP || settings.get().brakeMode == BRAKE_TACH; });
     pageBrakeTune->addItem(brakeStop);
 
     MenuItem* brakeCutoff = new MenuFloat("Cutoff Hz", &settings.get().softStopCutoff, 1.0, 0.0, 50.0);
@@ -698,8 +715,9 @@ void actionClosedLoopStatus() {
 }
 
 void actionClosedLoopSetupStart() {
-    speedFeedback.beginSetupCapture();
-    ui.showMessage("Rotate 1 Rev", 1500);
+    float expectedRpm = motor.getSynchronousPlatterRpm();
+    speedFeedback.beginSetupCapture(expectedRpm);
+    ui.showMessage(expectedRpm > 0.0f ? "Detecting CPR" : "Rotate 1 Rev", 1500);
 }
 
 void actionClosedLoopSetupStatus() {
@@ -707,6 +725,10 @@ void actionClosedLoopSetupStatus() {
     char msg[32];
     if (!setup.active) {
         snprintf(msg, sizeof(msg), "Setup Idle");
+    } else if (setup.autoDetect && setup.autoState < CPR_DETECT_DONE) {
+        snprintf(msg, sizeof(msg), "Detect %u%%", setup.autoProgressPercent);
+    } else if (setup.autoDetect && setup.suggestedCountsPerRev == 0) {
+        snprintf(msg, sizeof(msg), "CPR ? %u %.0f%%", setup.autoDetectedCountsPerRev, setup.autoConfidence * 100.0f);
     } else if (setup.suggestedCountsPerRev > 0) {
         snprintf(msg, sizeof(msg), "CPR %u %s", setup.suggestedCountsPerRev,
             setup.correctedDirection == SPEED_FEEDBACK_DIR_REVERSE ? "REV" : "FWD");
@@ -794,6 +816,33 @@ void actionClosedLoopBaseSave() {
     else ui.showError(safeModeActive ? "Safe Mode Read Only" : "Save Failed", 2000);
 }
 
+void actionClosedLoopBaseUndo() {
+    char msg[96];
+    if (!motor.rollbackBaseLearning(msg, sizeof(msg))) {
+        ui.showError(msg, 2500);
+        return;
+    }
+    if (settings.save(false, true)) ui.showMessage("Learned Base Undone", 2000);
+    else ui.showError(safeModeActive ? "Safe Mode Read Only" : "Save Failed", 2000);
+}
+
+void actionCoastDownStart() {
+    char msg[120];
+    if (motor.beginCoastDown(msg, sizeof(msg))) ui.showMessage("Coasting", 1500);
+    else ui.showError(msg, 2500);
+}
+
+void actionCoastDownStatus() {
+    CoastDownStatus coast = motor.getCoastDownStatus();
+    ui.showMessage(coast.message, 3000);
+}
+
+void actionCoastDownApply() {
+    char msg[120];
+    if (motor.applyCoastDownSeeds(msg, sizeof(msg))) ui.showMessage(msg, 2500);
+    else ui.showError(msg, 2500);
+}
+
 void actionEnterClosedLoop() {
     // Closed-loop pages are rebuilt because the currently edited speed selects which per-speed tuning block is shown.
     rebuildMenuPage(pageClosedLoop, "Closed Loop");
@@ -839,14 +888,18 @@ void actionEnterClosedLoop() {
     addClosedLoopItem(pageClosedLoopControl, controlMode);
 
     MenuItem* sensorMode = new MenuByte("Sensor", &settings.get().closedLoopSensorMode,
-        CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_QUADRATURE, closedLoopSensorLabels, 2);
+        CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_LAST, closedLoopSensorLabels, CLOSED_LOOP_SENSOR_LAST + 1);
     addClosedLoopItem(pageClosedLoopSensor, sensorMode);
 
     MenuItem* targetRpm = new MenuFloat("Target RPM", &settings.get().closedLoopTargetRpm[speedIndex], 0.01, 1.0, 120.0);
     addClosedLoopItem(pageClosedLoopControl, targetRpm);
 
     MenuItem* counts = new MenuUInt16("Counts/Rev", &settings.get().closedLoopCountsPerRev, 1, 1, 20000);
-    addClosedLoopItem(pageClosedLoopSensor, counts);
+    counts->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().closedLoopSensorMode != CLOSED_LOOP_SENSOR_SENSORLESS;
+    });
+    pageClosedLoopSensor->addItem(counts);
 
     MenuItem* edge = new MenuByte("Pulse Edge", &settings.get().closedLoopPulseEdge,
         CLOSED_LOOP_EDGE_RISING, CLOSED_LOOP_EDGE_CHANGE, closedLoopEdgeLabels, 3);
@@ -934,6 +987,36 @@ void actionEnterClosedLoop() {
     MenuItem* slew = new MenuFloat("Slew Hz/s", &tuning.slewLimitHzPerSec, 0.1, 0.0, 100.0);
     addClosedLoopItem(pageClosedLoopPid, slew);
 
+    MenuItem* notch = new MenuBool("Notch", &settings.get().closedLoopNotchEnabled);
+    addClosedLoopItem(pageClosedLoopPid, notch);
+
+    MenuItem* notchMin = new MenuFloat("Notch Lo Hz", &settings.get().closedLoopNotchMinHz, 0.05, 0.05, 20.0);
+    notchMin->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().closedLoopNotchEnabled;
+    });
+    pageClosedLoopPid->addItem(notchMin);
+
+    MenuItem* notchMax = new MenuFloat("Notch Hi Hz", &settings.get().closedLoopNotchMaxHz, 0.05, 0.15, 25.0);
+    notchMax->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().closedLoopNotchEnabled;
+    });
+    pageClosedLoopPid->addItem(notchMax);
+
+    MenuItem* loadStep = new MenuBool("Needle FF", &settings.get().loadStepEnabled);
+    addClosedLoopItem(pageClosedLoopPid, loadStep);
+
+    MenuItem* loadStepBoost = new MenuByte("Drop Boost %", &settings.get().loadStepBoostPercent, 0, 50);
+    loadStepBoost->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().loadStepEnabled;
+    });
+    pageClosedLoopPid->addItem(loadStepBoost);
+
+    MenuItem* learnBase = new MenuBool("Learn Base", &settings.get().baseLearnEnabled);
+    addClosedLoopItem(pageClosedLoopPid, learnBase);
+
     MenuItem* dropout = new MenuByte("Dropout", &settings.get().closedLoopDropoutAction,
         CLOSED_LOOP_DROPOUT_OPEN_LOOP, CLOSED_LOOP_DROPOUT_STOP, closedLoopDropLabels, 3);
     addClosedLoopItem(pageClosedLoopSafety, dropout);
@@ -1009,6 +1092,31 @@ void actionEnterClosedLoop() {
     });
     pageClosedLoopSafety->addItem(ampRecoveryDelay);
 
+    MenuItem* slipAction = new MenuByte("Slip Act", &settings.get().closedLoopSlipAction,
+        CLOSED_LOOP_SLIP_IGNORE, CLOSED_LOOP_SLIP_STOP, closedLoopSlipLabels, 4);
+    addClosedLoopItem(pageClosedLoopSafety, slipAction);
+
+    MenuItem* slipPercent = new MenuFloat("Slip %", &settings.get().closedLoopSlipThresholdPercent, 0.5, 0.5, 50.0);
+    slipPercent->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().closedLoopSlipAction != CLOSED_LOOP_SLIP_IGNORE;
+    });
+    pageClosedLoopSafety->addItem(slipPercent);
+
+    MenuItem* pullOutPercent = new MenuFloat("Pull-out %", &settings.get().closedLoopPullOutThresholdPercent, 1.0, 0.0, 100.0);
+    pullOutPercent->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().closedLoopSlipAction != CLOSED_LOOP_SLIP_IGNORE;
+    });
+    pageClosedLoopSafety->addItem(pullOutPercent);
+
+    MenuItem* slipMs = new MenuUInt16("Slip ms", &settings.get().closedLoopSlipDetectMs, 50, 50, 10000);
+    slipMs->setVisibleWhen([](){
+        return settings.get().closedLoopEnabled &&
+               settings.get().closedLoopSlipAction != CLOSED_LOOP_SLIP_IGNORE;
+    });
+    pageClosedLoopSafety->addItem(slipMs);
+
     pageClosedLoopActions->addItem(new MenuAction("Apply", actionApplyClosedLoopSettings));
     pageClosedLoopActions->addItem(new MenuAction("Reset PID", [](){
         motor.resetClosedLoop();
@@ -1018,6 +1126,10 @@ void actionEnterClosedLoop() {
     pageClosedLoopActions->addItem(new MenuAction("Base Preview", actionClosedLoopBasePreview));
     pageClosedLoopActions->addItem(new MenuAction("Base Apply", actionClosedLoopBaseApply));
     pageClosedLoopActions->addItem(new MenuAction("Base Save", actionClosedLoopBaseSave));
+    pageClosedLoopActions->addItem(new MenuAction("Base Undo", actionClosedLoopBaseUndo));
+    pageClosedLoopActions->addItem(new MenuAction("Coast Start", actionCoastDownStart));
+    pageClosedLoopActions->addItem(new MenuAction("Coast Stat", actionCoastDownStatus));
+    pageClosedLoopActions->addItem(new MenuAction("Coast Est.", actionCoastDownApply));
 
     pageClosedLoopSetup->addItem(new MenuAction("Setup Start", actionClosedLoopSetupStart));
     pageClosedLoopSetup->addItem(new MenuAction("Setup Stat", actionClosedLoopSetupStatus));
@@ -1059,9 +1171,18 @@ void buildMenuSystem() {
     MenuItem* iirAlpha = new MenuFloat("IIR Alpha", &menuShadowSettings.iirAlpha, 0.01, 0.01, 0.99);
     iirAlpha->setVisibleWhen([](){ return menuShadowSettings.filterType == FILTER_IIR; });
     pageSpeedTuning->addItem(iirAlpha);
-    MenuItem* firProfile = new MenuByte("FIR Prof", &menuShadowSettings.firProfile, 0, 2, firLabels, 3);
+    MenuItem* firProfile = new MenuByte("FIR Prof", &menuShadowSettings.firProfile, 0, FIR_CUSTOM, firLabels, 4);
     firProfile->setVisibleWhen([](){ return menuShadowSettings.filterType == FILTER_FIR; });
     pageSpeedTuning->addItem(firProfile);
+    MenuItem* firCutoff = new MenuFloat("FIR Cut Hz", &menuShadowFirCutoffHz, 100.0, 100.0, 45000.0);
+    firCutoff->setVisibleWhen([](){ return menuShadowSettings.filterType == FILTER_FIR && menuShadowSettings.firProfile == FIR_CUSTOM; });
+    pageSpeedTuning->addItem(firCutoff);
+    MenuItem* firTransition = new MenuFloat("FIR Width", &menuShadowFirTransitionHz, 100.0, 100.0, 50000.0);
+    firTransition->setVisibleWhen([](){ return menuShadowSettings.filterType == FILTER_FIR && menuShadowSettings.firProfile == FIR_CUSTOM; });
+    pageSpeedTuning->addItem(firTransition);
+    MenuItem* firTaps = new MenuByte("FIR Taps", &menuShadowFirTaps, FIR_MIN_TAPS, FIR_MAX_TAPS);
+    firTaps->setVisibleWhen([](){ return menuShadowSettings.filterType == FILTER_FIR && menuShadowSettings.firProfile == FIR_CUSTOM; });
+    pageSpeedTuning->addItem(firTaps);
     pageSpeedTuning->addItem(new MenuAction("Back", [](){ ui.back(); }));
 
     /* Output configuration separates electrical layout, per-speed tuning,
@@ -1118,6 +1239,10 @@ void buildMenuSystem() {
     pageOutputTuning->addItem(new MenuFloat("Gain Slew", &settings.get().gainSlewPercentPerSecond, 5.0, 0.0, 1000.0));
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     pageOutputTuning->addItem(new MenuBool("Regen Safe", &settings.get().activeBrakingAllowed));
+    pageOutputTuning->addItem(new MenuUInt16("Dead Time ns", &settings.get().bridgeDeadTimeNs, 10, 0, 2000));
+    pageOutputTuning->addItem(new MenuFloat("DT Lag 33", &settings.get().bridgeDeadTimeLagDeg[SPEED_33], 1.0, 0.0, 89.0));
+    pageOutputTuning->addItem(new MenuFloat("DT Lag 45", &settings.get().bridgeDeadTimeLagDeg[SPEED_45], 1.0, 0.0, 89.0));
+    pageOutputTuning->addItem(new MenuFloat("DT Lag 78", &settings.get().bridgeDeadTimeLagDeg[SPEED_78], 1.0, 0.0, 89.0));
 #endif
     addBackItem(pageOutputTuning);
 
@@ -1146,6 +1271,11 @@ void buildMenuSystem() {
     MenuItem* kickRamp = new MenuFloat("Kick Ramp", &menuShadowSettings.startupKickRampDuration, 0.1, 0.0, 15.0);
     kickRamp->setVisibleWhen([](){ return menuShadowSettings.startupKick > 1; });
     pageMotorStartup->addItem(kickRamp);
+#if CLOSED_LOOP_SPEED_ENABLE
+    MenuItem* adaptiveKick = new MenuBool("Adapt Kick", &settings.get().adaptiveKickEnabled);
+    adaptiveKick->setVisibleWhen([](){ return menuShadowSettings.startupKick > 1; });
+    pageMotorStartup->addItem(adaptiveKick);
+#endif
     addBackItem(pageMotorStartup);
 
     pageMotorAmplitude->addItem(new MenuByte("Red. Amp %", &menuShadowSettings.reducedAmplitude, 10, 100));
@@ -1167,6 +1297,17 @@ void buildMenuSystem() {
     vfBaseHz->setVisibleWhen([](){ return settings.get().vfBlend > 0; });
     pageMotorAmplitude->addItem(vfBaseHz);
     pageMotorAmplitude->addItem(new MenuByte("Max Amp %", &settings.get().maxAmplitude, 0, 100));
+    // Thermal model constants are bench-tuned over serial or web; the menu only exposes the derate band.
+    pageMotorAmplitude->addItem(new MenuBool("Th Derate", &settings.get().thermalDerateEnabled));
+    MenuItem* thermalStart = new MenuFloat("Th Start C", &settings.get().thermalDerateStartC, 1.0, 1.0, 150.0);
+    thermalStart->setVisibleWhen([](){ return settings.get().thermalDerateEnabled; });
+    pageMotorAmplitude->addItem(thermalStart);
+    MenuItem* thermalLimit = new MenuFloat("Th Limit C", &settings.get().thermalDerateLimitC, 1.0, 2.0, 160.0);
+    thermalLimit->setVisibleWhen([](){ return settings.get().thermalDerateEnabled; });
+    pageMotorAmplitude->addItem(thermalLimit);
+    MenuItem* thermalFloor = new MenuByte("Th Floor %", &settings.get().thermalMinDerate, 10, 100);
+    thermalFloor->setVisibleWhen([](){ return settings.get().thermalDerateEnabled; });
+    pageMotorAmplitude->addItem(thermalFloor);
     addBackItem(pageMotorAmplitude);
 
     pageMotorRamping->addItem(new MenuByte("Ramp Type", &settings.get().rampType, 0, 1, rampTypeLabels, 2));
@@ -1180,7 +1321,7 @@ void buildMenuSystem() {
     pageMotorRamping->addItem(new MenuBool("Auto Start", &settings.get().autoStart));
     addBackItem(pageMotorRamping);
 
-    pageMotorBraking->addItem(new MenuByte("Brake Mode", &settings.get().brakeMode, 0, 3, brakeModeLabels, 4));
+    pageMotorBraking->addItem(new MenuByte("Brake Mode", &settings.get().brakeMode, 0, 4, brakeModeLabels, 5));
     MenuItem* brakeDuration = new MenuFloat("Brake Dur", &settings.get().brakeDuration, 0.1, 0.0, 10.0);
     brakeDuration->setVisibleWhen([](){ return settings.get().brakeMode != BRAKE_OFF; });
     pageMotorBraking->addItem(brakeDuration);
@@ -1188,10 +1329,10 @@ void buildMenuSystem() {
     brakePulse->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_PULSE; });
     pageMotorBraking->addItem(brakePulse);
     MenuItem* brakeStart = new MenuFloat("Brk StartF", &settings.get().brakeStartFreq, 1.0, 10.0, 200.0);
-    brakeStart->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP; });
+    brakeStart->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP || settings.get().brakeMode == BRAKE_TACH; });
     pageMotorBraking->addItem(brakeStart);
     MenuItem* brakeStop = new MenuFloat("Brk StopF", &settings.get().brakeStopFreq, 1.0, 0.0, 50.0);
-    brakeStop->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP; });
+    brakeStop->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_RAMP || settings.get().brakeMode == BRAKE_TACH; });
     pageMotorBraking->addItem(brakeStop);
     MenuItem* brakeCutoff = new MenuFloat("Brk Cutoff", &settings.get().softStopCutoff, 1.0, 0.0, 50.0);
     brakeCutoff->setVisibleWhen([](){ return settings.get().brakeMode == BRAKE_SOFT_STOP; });
@@ -39,6 +39,7 @@ extern int menuShadowSpeedIndex;
 void buildMenuSystem();
 void initMenuState();
 void commitMenuShadowSettings();
+void loadMenuShadowSettings();
 void saveMenuChangesAndExit();
 void cancelMenuChangesAndExit();
 
@@ -36,13 +36,53 @@ static bool deadlinePending(uint32_t now, uint32_t deadline) {
     return deadline != 0 && (int32_t)(now - deadline) < 0;
 }
 
-static BrakeMode effectiveBrakeMode() {
+// Coast-down speed is measured across windows of at least this many counts, so low-resolution tachometers still give usable RPM at the slow end.
+static const int32_t COAST_DOWN_MIN_WINDOW_COUNTS = 4;
+// Fits that explain less of the decay than this are reported but not stored.
+static const float COAST_DOWN_MIN_R_SQUARED = 0.9f;
+// Braking windows run edge to edge; this keeps millisecond edge timing small against each window.
+static const uint32_t BRAKE_TACH_MIN_WINDOW_MS = 100;
+// Deceleration is measured over at least this span, and a count gap this long always counts as a stop.
+static const uint32_t BRAKE_TACH_SLOPE_MS = 200;
+static const uint32_t BRAKE_TACH_MIN_GAP_MS = 500;
+
+static BrakeMode effectiveBrakeMode(bool busGuarded) {
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
-    if (!settings.get().activeBrakingAllowed) return BRAKE_OFF;
+    if (!settings.get().activeBrakingAllowed && !busGuarded) return BRAKE_OFF;
+#else
+    (void)busGuarded;
 #endif
     return (BrakeMode)settings.get().brakeMode;
 }
 
+#if BUS_VOLTAGE_SENSE_ENABLE
+static float readBusVoltage() {
+#if SENSORLESS_SPEED_ENABLE
+    // The sensorless sampling timer switches the shared ADC mux; keep it out until this conversion has been read.
+    noInterrupts();
+    int raw = analogRead(PIN_BUS_VOLTAGE_SENSE);
+    interrupts();
+#else
+    int raw = analogRead(PIN_BUS_VOLTAGE_SENSE);
+#endif
+    return busVoltageFromAdc(raw, BUS_VOLTAGE_DIVIDER_RATIO);
+}
+#endif
+
+#if DC_OFFSET_NULL_ENABLE
+static float readDcOffsetSense() {
+#if SENSORLESS_SPEED_ENABLE
+    noInterrupts();
+    int raw = analogRead(PIN_DC_OFFSET_SENSE);
+    interrupts();
+#else
+    int raw = analogRead(PIN_DC_OFFSET_SENSE);
+#endif
+    // Raw counts are enough: the calibrator measures the sense gain itself.
+    return (float)raw;
+}
+#endif
+
 MotorController::MotorController() {
     _state = ENABLE_STANDBY ? STATE_STANDBY : STATE_STOPPED;
     _currentSpeedMode = SPEED_33;
@@ -57,6 +97,11 @@ MotorController::MotorController() {
     _startDuration = 0.0;
     _isKicking = false;
     _kickEndTime = 0;
+    _kickDeadlineEnd = KICK_END_TIMEOUT;
+    _startupKickSpeed = 0;
+    _startupKickStarts = 0;
+    _startupKickPullIns = 0;
+    memset(_startupTimeToLockSec, 0, sizeof(_startupTimeToLockSec));
     _waitingForPowerStage = false;
     _ampReductionStartTime = 0;
     _isReducedAmp = false;
@@ -69,6 +114,11 @@ MotorController::MotorController() {
     _activeBrakeStopFreq = 0.0f;
     _activeSoftStopCutoff = 0.0f;
     _activeBrakeMuteOnComplete = false;
+    memset(&_brakeMetrics, 0, sizeof(_brakeMetrics));
+    _brakeTachLastCount = 0;
+    _brakeTachSettling = false;
+    _brakeTachSettleStartMs = 0;
+    _brakeTachSettleCount = 0;
     _relaysActive = false;
     _relayActivationPending = false;
     _relayStageTime = 0;
@@ -78,6 +128,8 @@ MotorController::MotorController() {
     _isSpeedRamping = false;
     _rampStartFreq = 0.0;
     _rampTargetFreq = 0.0;
+    _rampCarryHz = 0.0f;
+    _rampFromSpeedMode = SPEED_33;
     _rampStartTime = 0;
     _rampDuration = 0.0;
     _isKickRamping = false;
@@ -91,6 +143,7 @@ MotorController::MotorController() {
     _closedLoopCorrectionHz = 0.0;
     _closedLoopIntegralHz = 0.0;
     _closedLoopLastErrorRpm = 0.0;
+    _closedLoopDerivativeRebase = false;
     _closedLoopLastUpdate = 0;
     _closedLoopTargetLastUpdate = 0;
     _closedLoopEngageTime = 0;
@@ -104,6 +157,73 @@ MotorController::MotorController() {
     _closedLoopAmpOutOfLockStart = 0;
     _closedLoopAmpRecoveryActive = false;
     _closedLoopAmpRecoveryLatched = false;
+    for (int i = 0; i < 3; i++) {
+        _closedLoopSlipRatio[i].rpmPerHz = 0.0f;
+        _closedLoopSlipRatio[i].learned = false;
+    }
+    _closedLoopSlipLatched = false;
+    _closedLoopSlipLastSampleSequence = 0;
+    _closedLoopSlipSumPercent = 0.0f;
+    _coastDownActive = false;
+    _coastDownSpeed = SPEED_33;
+    _coastDownStartMs = 0;
+    _coastDownLastSequence = 0;
+    _coastDownWindowCount = 0;
+    _coastDownWindowMs = 0;
+    memset(&_coastDownResult, 0, sizeof(_coastDownResult));
+    _coastDownMessage[0] = 0;
+    _thermalLastMs = 0;
+    _thermalAccumMs = 0;
+    _thermalDriveSquaredMs = 0.0f;
+    _thermalDerating = false;
+    _thermalDerateEvents = 0;
+    BusVoltageParams busParams;
+    busParams.nominalV = BUS_VOLTAGE_NOMINAL_V;
+    busParams.filterSec = BUS_VOLTAGE_FILTER_MS / 1000.0f;
+    busParams.fastSec = BUS_VOLTAGE_FAST_FILTER_MS / 1000.0f;
+    busParams.minScale = BUS_VOLTAGE_MIN_SCALE;
+    busParams.maxScale = BUS_VOLTAGE_MAX_SCALE;
+    busParams.overVoltageV = BUS_OVERVOLTAGE_V;
+    busParams.underVoltageV = BUS_UNDERVOLTAGE_V;
+    busParams.hysteresisV = BUS_VOLTAGE_HYSTERESIS_V;
+    busParams.rideThroughSec = BUS_RIDE_THROUGH_MS / 1000.0f;
+    _bus.configure(busParams);
+    _busLastSampleMs = 0;
+    _busRideThrough = false;
+    _busBrakeAborts = 0;
+    _dcOffsetActive = false;
+    _dcOffsetSelected = -1;
+    _dcOffsetLastSampleMs = 0;
+    _dcOffsetLastSucceeded = false;
+    _dcOffsetRuns = 0;
+    _healthSessionActive = false;
+    _healthSpeed = 0;
+    _healthLockedMs = 0;
+    _healthSamples = 0;
+    _healthCorrectionSum = 0.0f;
+    _healthAmplitudeSum = 0.0f;
+    _healthErrorSquaredSum = 0.0f;
+    _healthTimeToLockSec = 0.0f;
+    memset(_healthCoastSec, 0, sizeof(_healthCoastSec));
+    memset(_healthTrend, 0, sizeof(_healthTrend));
+    memset(_healthReportedDrift, 0, sizeof(_healthReportedDrift));
+    _healthLastSaveMs = 0;
+    _healthPitched = false;
+    memset(_baseLearnLastAction, 0, sizeof(_baseLearnLastAction));
+    memset(_baseLearnLastShared, 0, sizeof(_baseLearnLastShared));
+    memset(_baseLearnLastBounded, 0, sizeof(_baseLearnLastBounded));
+    _baseLearnSteps = 0;
+    _baseLearnRollbacks = 0;
+    _loadStepLoaded = false;
+    _loadStepAppliedHz = 0.0f;
+    _loadStepDrops = 0;
+    _loadStepLifts = 0;
+    _loadStepMeasurements = 0;
+    _loadStepLastEventMs = 0;
+    _loadStepLastMeasuredHz = 0.0f;
+    _loadStepLastSettled = false;
+    _loadStepBoostStartMs = 0;
+    _loadStepBoost = 1.0f;
     _rampStartRpm = 0.0;
     _rampTargetRpm = 0.0;
     memset(&_closedLoopMetrics, 0, sizeof(_closedLoopMetrics));
@@ -165,6 +285,12 @@ void MotorController::begin() {
     _powerOnTime = hal.getMillis();
     setRelays(false);
     speedFeedback.begin();
+#if BUS_VOLTAGE_SENSE_ENABLE
+    hal.setPinMode(PIN_BUS_VOLTAGE_SENSE, INPUT);
+#endif
+#if DC_OFFSET_NULL_ENABLE
+    hal.setPinMode(PIN_DC_OFFSET_SENSE, INPUT);
+#endif
 
     _state = (ENABLE_STANDBY && !settings.get().autoBoot) ? STATE_STANDBY : STATE_STOPPED;
 
@@ -179,6 +305,8 @@ void MotorController::begin() {
     }
     settings.get().currentSpeed = _currentSpeedMode;
     applySettings();
+    // Drift already in the stored history is shown in status but not alerted again on every boot.
+    for (uint8_t i = 0; i < 3; i++) refreshHealthTrend(i, false);
     setStandbyRelay(_state != STATE_STANDBY);
     currentMotorState = _state;
 
@@ -189,7 +317,7 @@ void MotorController::begin() {
 }
 
 bool MotorController::startOutputSweep(OutputSweepParameter parameter, float minimum, float maximum, float speed) {
-    if (_relayTestMode || errorHandler.hasCriticalError()) return false;
+    if (_relayTestMode || _dcOffsetActive || errorHandler.hasCriticalError()) return false;
     if (minimum >= maximum || speed <= 0.0f) return false;
     if (parameter > SWEEP_GAIN_D) return false;
     if (parameter >= SWEEP_GAIN_A && (minimum < 50.0f || maximum > 150.0f)) return false;
@@ -239,6 +367,9 @@ void MotorController::stopOutputSweep(bool keepCurrentValue) {
 
 void MotorController::update() {
     uint32_t now = hal.getMillis();
+    updateThermalModel(now);
+    updateBusVoltage(now);
+    updateDcOffsetNull(now);
 
     // --- Main State Machine ---
     switch (_state) {
@@ -261,24 +392,10 @@ void MotorController::update() {
                 _stateStartTime = now;
             }
 
-            // 1. Startup Kick Logic (High torque start)
-            if (_isKicking) {
-                if (!deadlinePending(now, _kickEndTime)) {
-                    _isKicking = false;
-
-                    // Transition from Kick frequency to Target frequency
-                    SpeedSettings& s = settings.getCurrentSpeedSettings();
-                    if (s.startupKickRampDuration > 0) {
-                        // Ramp down frequency smoothly
-                        _kickRampDuration = s.startupKickRampDuration * 1000.0;
-                        _kickRampStartTime = now;
-                        _kickRampStartFreq = waveform.getFrequency();
-                        _isKickRamping = true;
-                    } else {
-                        // Jump immediately to target
-                        setCommandedFrequency(_targetFreq);
-                    }
-                }
+            // 1. Startup Kick Logic (High torque start). With speed feedback an adaptive kick ends at pull-in; the deadline is the fallback.
+            updateStartupKick(now, true);
+            if (_isKicking && !deadlinePending(now, _kickEndTime)) {
+                endStartupKick(now, _kickDeadlineEnd);
             }
 
             // 2. Kick Ramp Logic
@@ -287,6 +404,7 @@ void MotorController::update() {
                 if (elapsed >= _kickRampDuration) {
                     _isKickRamping = false;
                     setCommandedFrequency(_targetFreq);
+                    finishStartupKickRamp(now);
                 } else {
                     float t = elapsed / _kickRampDuration;
                     float currentF = _kickRampStartFreq - ((_kickRampStartFreq - _targetFreq) * t);
@@ -335,13 +453,21 @@ void MotorController::update() {
                     if (elapsed >= _rampDuration) {
                         _isSpeedRamping = false;
                         _closedLoopRampTargetRpm = 0.0f;
-                        _currentFreq = _rampTargetFreq;
+                        float heldCorrectionHz = 0.0f;
+#if CLOSED_LOOP_SPEED_ENABLE && CLOSED_LOOP_BUMPLESS_ENABLE
+                        // The main loop takes over from the correction the ramp finished on rather than from zero.
+                        heldCorrectionHz = _rampCarryHz + _closedLoopCorrectionHz;
+#endif
+                        _rampCarryHz = 0.0f;
+                        _currentFreq = heldCorrectionHz != 0.0f ? clampToCurrentSpeedRange(_rampTargetFreq + heldCorrectionHz) : _rampTargetFreq;
                         setCommandedFrequency(_currentFreq);
+                        // Publishing the full tune ends the crossfade at the point it had already reached.
+                        waveform.updateSettings(_currentFreq, settings.getCurrentSpeedSettings(), settings.get().phaseMode);
                         speedFeedback.reset();
-                        scheduleClosedLoopEngage(now);
+                        scheduleClosedLoopEngage(now, heldCorrectionHz);
                     } else {
                         float t = _rampDuration > 0.0f ? elapsed / _rampDuration : 1.0f;
-                        float openLoopFreq = _rampStartFreq + ((_rampTargetFreq - _rampStartFreq) * t);
+                        float openLoopFreq = _rampStartFreq + ((_rampTargetFreq - _rampStartFreq) + _rampCarryHz) * t;
                         float commandedFreq = openLoopFreq;
 #if CLOSED_LOOP_SPEED_ENABLE
                         float rampTargetRpm = _rampStartRpm + ((_rampTargetRpm - _rampStartRpm) * t);
@@ -359,6 +485,7 @@ void MotorController::update() {
 #endif
                         _currentFreq = commandedFreq;
                         setCommandedFrequency(_currentFreq);
+                        waveform.crossfadeTune(_rampFromSpeedMode, _currentSpeedMode, t);
                     }
                 } else {
                     float commandedFreq = _targetFreq;
@@ -396,9 +523,12 @@ void MotorController::update() {
                 {
                     SpeedFeedbackStatus feedback = speedFeedback.getStatus();
                     updateClosedLoopAmpRecovery(now, feedback);
+                    updateClosedLoopSlip(now, feedback);
+                    if (_state != STATE_RUNNING) break;
                     recordClosedLoopMetrics(now, feedback);
                 }
 #endif
+                updateStartupKick(now, false);
 
                 // Runtime is counted only while the motor is running.
                 settings.updateRuntime();
@@ -443,6 +573,7 @@ void MotorController::update() {
                 }
 
                 // Re-evaluate the curve even when frequency is steady so live settings changes take effect without restarting the motor.
+                updateLoadStepBoost(now);
                 applyDriveAmplitude();
             }
             break;
@@ -453,10 +584,18 @@ void MotorController::update() {
             break;
     }
 
+#if CLOSED_LOOP_SPEED_ENABLE
+    // The coast-down bench outlives the stop it triggered, so it is serviced outside the state machine.
+    if (_coastDownActive) updateCoastDown(now);
+    if (_brakeTachSettling) updateTachBrakeSettle(now);
+#endif
+
     // Update global state for UI/Core 1 visibility.
     currentMotorState = _state;
+    // Start, kick, ramps, braking and sweeps change the drive every loop, so they get short DMA blocks.
+    waveform.setLowLatency(_state == STATE_STARTING || _state == STATE_STOPPING || _isSpeedRamping || _isSweepingMode);
 
-    if (!_relayTestMode && _relayActivationPending) {
+    if (!_relayTestMode && !_dcOffsetActive && _relayActivationPending) {
         uint32_t delayMs = settings.get().powerOnRelayDelay * 1000;
         if (now - _powerOnTime >= delayMs) {
             _powerOnDelayActive = false;
@@ -470,7 +609,7 @@ void MotorController::update() {
      * Relay activation is deliberately staggered to avoid current spikes and
      * contact chatter when unmuting several phase outputs.
      */
-    if (!_relayTestMode && ENABLE_MUTE_RELAYS && _relaysActive) {
+    if (!_relayTestMode && !_dcOffsetActive && ENABLE_MUTE_RELAYS && _relaysActive) {
         bool activeHigh = settings.get().relayActiveHigh;
 
         if (ENABLE_DPDT_RELAYS) {
@@ -533,13 +672,24 @@ void MotorController::update() {
             _settingsDirty = false;
         }
     }
+
+    // Health records reach flash only while the motor is idle, and a failing write is retried on the same quiet period.
+    if (settings.isHealthHistoryDirty() && !isMoving() && !_coastDownActive && now - _healthLastSaveMs > 2000) {
+        _healthLastSaveMs = now;
+        settings.saveHealthHistory();
+    }
 }
 
 void MotorController::start() {
-    if (_relayTestMode) return;
+    if (_relayTestMode || _dcOffsetActive) return;
     if (errorHandler.hasCriticalError()) return;
     if (powerStage.hasFault()) return;
+#if BUS_VOLTAGE_SENSE_ENABLE
+    if (_bus.getState() == BUS_VOLTAGE_UNDERVOLTAGE || _bus.getState() == BUS_VOLTAGE_OVERVOLTAGE) return;
+#endif
     if (_state == STATE_RUNNING || _state == STATE_STARTING || _state == STATE_STOPPING) return;
+    if (_coastDownActive) cancelCoastDown();
+    _brakeTachSettling = false;
 
     if (_state == STATE_STANDBY) {
         _state = STATE_STOPPED;
@@ -562,16 +712,8 @@ void MotorController::start() {
     _currentAmp = 0.0;
     _isReducedAmp = false;
 
-    // Startup kick starts above target frequency for extra torque, optionally ramping down into the normal target frequency.
-    SpeedSettings& s = settings.getCurrentSpeedSettings();
-    if (s.startupKick > 1) {
-        _isKicking = true;
-        _kickEndTime = hal.getMillis() + (s.startupKickDuration * 1000);
-        setCommandedFrequency(_targetFreq * s.startupKick);
-    } else {
-        _isKicking = false;
-        setCommandedFrequency(_targetFreq);
-    }
+    beginStartupKick(hal.getMillis());
+    beginHealthSession();
 
     setOutputAmplitude(0.0f);
     waveform.setEnabled(true);
@@ -595,12 +737,14 @@ void MotorController::stop() {
     _state = STATE_STOPPING;
     powerStage.notifyStopping();
     _stateStartTime = hal.getMillis();
+    finishHealthSession();
     resetClosedLoopControl(false);
+    _startupKick.abandon();
 
     // Snapshot every parameter used by the active stop. Settings may be edited
     // remotely while braking, but an in-progress hardware sequence must remain
     // internally consistent until the outputs have been interlocked off.
-    _activeBrakeMode = effectiveBrakeMode();
+    _activeBrakeMode = effectiveBrakeMode(busGuardsRegen());
     _activeBrakeDurationMs = settings.get().brakeDuration * 1000.0f;
     _activeBrakePulseGapMs = settings.get().brakePulseGap * 1000.0f;
     _activeBrakeStartFreq = settings.get().brakeStartFreq;
@@ -609,6 +753,11 @@ void MotorController::stop() {
     _activeBrakeMuteOnComplete = settings.get().muteRelayLinkStartStop;
 
     // Configure braking before entering the periodic braking handler.
+    if (_activeBrakeMode == BRAKE_TACH && !beginTachBraking(_stateStartTime)) {
+        // Without a usable speed signal, reverse torque has no end point, so the stop uses the fixed-duration frequency ramp instead.
+        _brakeMetrics.fallbacks++;
+        _activeBrakeMode = BRAKE_RAMP;
+    }
     if (_activeBrakeMode == BRAKE_PULSE) {
         _brakePulseState = true;
         _brakePulseLastToggle = hal.getMillis();
@@ -625,24 +774,33 @@ void MotorController::stop() {
     }
 }
 
+void MotorController::finishBraking() {
+    _state = STATE_STOPPED;
+    _currentAmp = 0.0;
+    setOutputAmplitude(0.0f);
+    powerStage.disable();
+    waveform.setEnabled(false);
+
+    if (_activeBrakeMuteOnComplete) {
+        setRelays(false); // Mute
+    }
+
+    // Reset frequency to positive so the next start does not inherit reverse braking direction.
+    setCommandedFrequency(fabsf(_targetFreq));
+}
+
 void MotorController::handleBraking(uint32_t now) {
+    if (_activeBrakeMode == BRAKE_TACH) {
+        handleTachBraking(now);
+        return;
+    }
+
     float duration = _activeBrakeDurationMs;
     float elapsed = now - _stateStartTime;
 
     // Check if braking is complete
     if (elapsed >= duration) {
-        _state = STATE_STOPPED;
-        _currentAmp = 0.0;
-        setOutputAmplitude(0.0f);
-        powerStage.disable();
-        waveform.setEnabled(false);
-
-        if (_activeBrakeMuteOnComplete) {
-            setRelays(false); // Mute
-        }
-
-        // Reset frequency to positive so the next start does not inherit reverse braking direction.
-        setCommandedFrequency(fabsf(_targetFreq));
+        finishBraking();
         return;
     }
 
@@ -702,6 +860,138 @@ void MotorController::handleBraking(uint32_t now) {
     }
 }
 
+bool MotorController::beginTachBraking(uint32_t now) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+    if (!settings.get().closedLoopEnabled || settings.get().closedLoopCountsPerRev == 0 ||
+        !feedback.signalValid || feedback.filteredRpm <= 0.0f || feedback.lastPulseAgeMs == UINT32_MAX) {
+        return false;
+    }
+
+    TachBrakeParams params;
+    params.countsPerRev = (float)settings.get().closedLoopCountsPerRev;
+    params.standstillRpm = BRAKE_TACH_STANDSTILL_RPM;
+    params.taperPercent = BRAKE_TACH_TAPER_PERCENT;
+    params.minDrivePercent = BRAKE_TACH_MIN_DRIVE_PERCENT;
+    params.updateMs = settings.get().closedLoopUpdateIntervalMs;
+    params.slopeMs = BRAKE_TACH_SLOPE_MS;
+    params.minGapMs = BRAKE_TACH_MIN_GAP_MS;
+    params.minWindowMs = BRAKE_TACH_MIN_WINDOW_MS;
+    _brakeTach.begin(params, feedback.filteredRpm, feedback.count, now - feedback.lastPulseAgeMs, now);
+    _brakeTachLastCount = feedback.count;
+    _brakeTachSettling = false;
+    _brakeMetrics.lastResult = BRAKE_RESULT_NONE;
+    _brakeMetrics.lastStartRpm = feedback.filteredRpm;
+    _brakeMetrics.currentRpm = feedback.filteredRpm;
+
+    // A reversed field gives near-constant plugging torque on synchronous and hysteresis rotors; amplitude is what sets it.
+    setCommandedFrequency(-fabsf(_targetFreq));
+    _currentAmp = _targetAmp;
+    applyDriveAmplitude();
+    return true;
+#else
+    (void)now;
+    return false;
+#endif
+}
+
+void MotorController::handleTachBraking(uint32_t now) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    // The running loop stops sampling the sensor once braking begins, so the brake drives SpeedFeedback itself.
+    speedFeedback.update(0.0f);
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+    uint32_t pulseAgeMs = feedback.lastPulseAgeMs == UINT32_MAX ? 0 : feedback.lastPulseAgeMs;
+    if (feedback.count != _brakeTachLastCount) {
+        _brakeTachLastCount = feedback.count;
+        _brakeTach.addSample(feedback.count, now - pulseAgeMs);
+    }
+    TachBrakeDecision decision = _brakeTach.update(now, pulseAgeMs);
+    _brakeMetrics.currentRpm = _brakeTach.getRpm();
+
+    // Quadrature direction is only trusted near the end of the stop, where a reversal is the expected failure.
+    bool quadratureReversed = settings.get().closedLoopSensorMode == CLOSED_LOOP_SENSOR_QUADRATURE &&
+        feedback.direction == SPEED_FEEDBACK_DIR_REVERSE && _brakeTach.getRpm() <= _brakeTach.getTaperRpm();
+    if (decision == TACH_BRAKE_REVERSED || quadratureReversed) {
+        completeTachBraking(now, BRAKE_RESULT_REVERSED, feedback.count);
+        return;
+    }
+    if (decision == TACH_BRAKE_STANDSTILL) {
+        completeTachBraking(now, BRAKE_RESULT_STANDSTILL, feedback.count);
+        return;
+    }
+    if (decision == TACH_BRAKE_PREDICTED) {
+        completeTachBraking(now, BRAKE_RESULT_PREDICTED, feedback.count);
+        return;
+    }
+    if (decision == TACH_BRAKE_NO_PULSE) {
+        completeTachBraking(now, BRAKE_RESULT_NO_PULSE, feedback.count);
+        return;
+    }
+    if (now - _stateStartTime >= BRAKE_TACH_TIMEOUT_MS) {
+        completeTachBraking(now, BRAKE_RESULT_TIMEOUT, feedback.count);
+        return;
+    }
+
+    // Full torque while fast, then torque proportional to speed so the rotor arrives at zero instead of being driven through it.
+    _currentAmp = _targetAmp * _brakeTach.getDriveShare();
+    applyDriveAmplitude();
+#else
+    (void)now;
+    finishBraking();
+#endif
+}
+
+void MotorController::completeTachBraking(uint32_t now, BrakeStopResult result, int32_t count) {
+    uint32_t stopMs = now - _stateStartTime;
+    _brakeMetrics.stops++;
+    if (result == BRAKE_RESULT_TIMEOUT) _brakeMetrics.timeouts++;
+    _brakeMetrics.lastResult = result;
+    _brakeMetrics.lastReversed = result == BRAKE_RESULT_REVERSED;
+    _brakeMetrics.lastStopMs = stopMs;
+    if (result != BRAKE_RESULT_TIMEOUT && (_brakeMetrics.bestStopMs == 0 || stopMs < _brakeMetrics.bestStopMs)) {
+        _brakeMetrics.bestStopMs = stopMs;
+    }
+    _brakeMetrics.currentRpm = 0.0f;
+    _brakeMetrics.lastOvershootDeg = 0.0f;
+    _brakeMetrics.lastOvershootRpm = 0.0f;
+
+    _brakeTachSettling = true;
+    _brakeTachSettleStartMs = now;
+    _brakeTachSettleCount = count;
+    finishBraking();
+}
+
+void MotorController::updateTachBrakeSettle(uint32_t now) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    speedFeedback.update(0.0f);
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+    uint32_t elapsedMs = now - _brakeTachSettleStartMs;
+    int32_t counts = abs(feedback.count - _brakeTachSettleCount);
+    if (counts > 0 && settings.get().closedLoopCountsPerRev > 0) {
+        float revolutions = (float)counts / (float)settings.get().closedLoopCountsPerRev;
+        _brakeMetrics.lastOvershootDeg = revolutions * 360.0f;
+        float rpm = revolutions * (60000.0f / (float)(elapsedMs > 0 ? elapsedMs : 1));
+        if (rpm > _brakeMetrics.lastOvershootRpm) _brakeMetrics.lastOvershootRpm = rpm;
+        if (rpm > _brakeMetrics.peakOvershootRpm) _brakeMetrics.peakOvershootRpm = rpm;
+        if (settings.get().closedLoopSensorMode == CLOSED_LOOP_SENSOR_QUADRATURE &&
+            feedback.direction == SPEED_FEEDBACK_DIR_REVERSE) {
+            _brakeMetrics.lastReversed = true;
+        }
+    }
+    if (elapsedMs >= BRAKE_TACH_SETTLE_MS) _brakeTachSettling = false;
+#else
+    (void)now;
+    _brakeTachSettling = false;
+#endif
+}
+
+BrakeMetrics MotorController::getBrakeMetrics() const {
+    BrakeMetrics metrics = _brakeMetrics;
+    metrics.active = _state == STATE_STOPPING && _activeBrakeMode == BRAKE_TACH;
+    metrics.settling = _brakeTachSettling;
+    return metrics;
+}
+
 float MotorController::calculateSoftStartAmp(float elapsed, float duration) {
     // All curves map elapsed time to 0..target amplitude; waveform amplitude clamping is still handled by WaveformGenerator.
     float t = elapsed / duration;
@@ -761,7 +1051,319 @@ float MotorController::calculateVfScale(float frequency) const {
 }
 
 void MotorController::applyDriveAmplitude() {
-    setOutputAmplitude(_currentAmp * calculateVfScale(_currentFreq));
+    float loadStepBoost = _state == STATE_RUNNING ? _loadStepBoost : 1.0f;
+    setOutputAmplitude(_currentAmp * calculateVfScale(_currentFreq) * thermalDerateFactor() * loadStepBoost);
+}
+
+float MotorController::thermalDerateFactor() const {
+    // Starting, kick, and braking torque are never trimmed; derating only eases the long running phase where heat builds up.
+    if (_state != STATE_RUNNING || !settings.get().thermalDerateEnabled) return 1.0f;
+    return _thermalModel.getDerate();
+}
+
+void MotorController::updateThermalModel(uint32_t now) {
+    if (_thermalLastMs == 0) {
+        _thermalLastMs = now;
+        return;
+    }
+    uint32_t elapsedMs = now - _thermalLastMs;
+    _thermalLastMs = now;
+    _thermalDriveSquaredMs += _appliedAmp * _appliedAmp * (float)elapsedMs;
+    _thermalAccumMs += elapsedMs;
+    if (_thermalAccumMs < MOTOR_THERMAL_UPDATE_MS) return;
+
+    const GlobalSettings& g = settings.get();
+    MotorThermalParams params;
+    params.windingTauSec = g.thermalWindingTauSec;
+    params.frameTauSec = g.thermalFrameTauSec;
+    params.fullScaleRiseC = g.thermalFullScaleRiseC;
+    params.windingShare = (float)g.thermalWindingShare / 100.0f;
+    params.derateStartC = g.thermalDerateStartC;
+    params.derateLimitC = g.thermalDerateLimitC;
+    // With derating disabled the multiplier is steered back to unity, so enabling it later eases in rather than stepping.
+    params.minDerate = g.thermalDerateEnabled ? (float)g.thermalMinDerate / 100.0f : 1.0f;
+    params.derateSlewPerSec = MOTOR_THERMAL_DERATE_SLEW_PER_SEC;
+    _thermalModel.configure(params);
+    _thermalModel.update((float)_thermalAccumMs / 1000.0f, sqrtf(_thermalDriveSquaredMs / (float)_thermalAccumMs));
+    _thermalAccumMs = 0;
+    _thermalDriveSquaredMs = 0.0f;
+
+    bool derating = g.thermalDerateEnabled && _thermalModel.getDerate() < 0.995f;
+    if (derating && !_thermalDerating) {
+        _thermalDerateEvents++;
+        char message[80];
+        snprintf(message, sizeof(message), "Motor thermal derate: est. rise %.1f C", _thermalModel.getRiseC());
+        errorHandler.report(ERR_MOTOR_THERMAL, message, false);
+    }
+    _thermalDerating = derating;
+}
+
+MotorThermalStatus MotorController::getThermalStatus() const {
+    MotorThermalStatus status;
+    status.derateEnabled = settings.get().thermalDerateEnabled;
+    status.derating = _thermalDerating;
+    status.driveLevel = _thermalModel.getDrive();
+    status.windingRiseC = _thermalModel.getWindingRiseC();
+    status.frameRiseC = _thermalModel.getFrameRiseC();
+    status.totalRiseC = _thermalModel.getRiseC();
+    status.steadyRiseC = _thermalModel.getSteadyRiseC();
+    status.derate = thermalDerateFactor();
+    status.derateEvents = _thermalDerateEvents;
+    return status;
+}
+
+void MotorController::resetThermalModel() {
+    // For bench use after the motor has been left to cool; the estimate cannot see ambient, so it restarts from cold.
+    _thermalModel.reset();
+    _thermalAccumMs = 0;
+    _thermalDriveSquaredMs = 0.0f;
+    _thermalDerating = false;
+}
+
+void MotorController::updateBusVoltage(uint32_t now) {
+#if BUS_VOLTAGE_SENSE_ENABLE
+    if (_busLastSampleMs != 0 && now - _busLastSampleMs < BUS_VOLTAGE_SAMPLE_MS) return;
+    float dtSec = _busLastSampleMs == 0 ? 0.0f : (float)(now - _busLastSampleMs) / 1000.0f;
+    _busLastSampleMs = now;
+
+    BusVoltageState previous = _bus.getState();
+    BusVoltageState state = _bus.update(readBusVoltage(), dtSec);
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    // Only a bridge delivers duty times bus voltage; a linear amplifier already regulates its own output swing.
+    waveform.setSupplyScale(_bus.getScale());
+#endif
+    _busRideThrough = state == BUS_VOLTAGE_DIP && (_state == STATE_RUNNING || _state == STATE_STARTING);
+    if (state == previous) return;
+
+    char message[72];
+    if (state == BUS_VOLTAGE_OVERVOLTAGE) {
+        snprintf(message, sizeof(message), "Bus over-voltage: %.1f V", _bus.getFastV());
+        errorHandler.report(ERR_BUS_VOLTAGE, message, false);
+        // Braking energy is the usual cause, so active braking ends at once and the stop completes unbraked.
+        if (_state == STATE_STOPPING && _activeBrakeMode != BRAKE_OFF) {
+            _busBrakeAborts++;
+            _activeBrakeMode = BRAKE_OFF;
+            finishBraking();
+        }
+    } else if (state == BUS_VOLTAGE_UNDERVOLTAGE) {
+        snprintf(message, sizeof(message), "Bus undervoltage: %.1f V for %lu ms",
+            _bus.getFastV(), (unsigned long)(_bus.getDipSec() * 1000.0f));
+        errorHandler.report(ERR_BUS_VOLTAGE, message, false);
+        if (_state == STATE_RUNNING || _state == STATE_STARTING) emergencyStop();
+    }
+#else
+    (void)now;
+#endif
+}
+
+bool MotorController::busGuardsRegen() const {
+#if BUS_VOLTAGE_SENSE_ENABLE && BUS_VOLTAGE_GUARDS_REGEN
+    return _bus.getState() == BUS_VOLTAGE_NORMAL;
+#else
+    return false;
+#endif
+}
+
+BusVoltageStatus MotorController::getBusVoltageStatus() const {
+    BusVoltageStatus status;
+    status.enabled = BUS_VOLTAGE_SENSE_ENABLE != 0;
+    status.state = _bus.getState();
+    status.volts = _bus.getFilteredV();
+    status.fastVolts = _bus.getFastV();
+    status.scale = _bus.getScale();
+    status.minVolts = _bus.getMinV();
+    status.maxVolts = _bus.getMaxV();
+    status.dipMs = _bus.getState() == BUS_VOLTAGE_NORMAL || _bus.getState() == BUS_VOLTAGE_OVERVOLTAGE ? 0.0f : _bus.getDipSec() * 1000.0f;
+    status.longestDipMs = _bus.getLongestDipSec() * 1000.0f;
+    status.dipsRiddenThrough = _bus.getDipsRiddenThrough();
+    status.underVoltageEvents = _bus.getUnderVoltageEvents();
+    status.overVoltageEvents = _bus.getOverVoltageEvents();
+    status.brakeAborts = _busBrakeAborts;
+    status.regenGuarded = busGuardsRegen();
+    return status;
+}
+
+bool MotorController::beginDcOffsetNull(char* out, size_t outSize) {
+#if DC_OFFSET_NULL_ENABLE
+    if (out && outSize > 0) out[0] = 0;
+    if (_dcOffsetActive) {
+        if (out && outSize > 0) snprintf(out, outSize, "Offset nulling is already running.");
+        return false;
+    }
+    if (_state != STATE_STOPPED || _relayTestMode || _isSweepingMode) {
+        if (out && outSize > 0) snprintf(out, outSize, "Stop the motor and leave relay test first.");
+        return false;
+    }
+    if (errorHandler.hasCriticalError()) {
+        if (out && outSize > 0) snprintf(out, outSize, "Clear the critical error first.");
+        return false;
+    }
+    uint32_t now = hal.getMillis();
+    // Connecting a channel is an unmute, so the power-on relay delay applies here too.
+    if (_powerOnDelayActive && now - _powerOnTime < settings.get().powerOnRelayDelay * 1000) {
+        if (out && outSize > 0) snprintf(out, outSize, "Wait for the power-on relay delay to finish.");
+        return false;
+    }
+
+    DcOffsetParams params;
+    params.settleMs = DC_OFFSET_SETTLE_MS;
+    params.averageMs = DC_OFFSET_AVERAGE_MS;
+    params.probeCounts = DC_OFFSET_PROBE_COUNTS;
+    params.toleranceCounts = DC_OFFSET_TOLERANCE_COUNTS;
+    params.maxCounts = DC_OFFSET_MAX_COUNTS;
+    params.minGain = DC_OFFSET_MIN_GAIN;
+    params.maxIterations = DC_OFFSET_MAX_ITERATIONS;
+    float start[4];
+    for (int ch = 0; ch < 4; ch++) start[ch] = dcOffsetFromStored(settings.get().dcOffsetNull[ch]);
+    uint8_t channels = settings.get().phaseMode;
+    if (channels > MAX_ACTIVE_PHASE_OUTPUTS) channels = MAX_ACTIVE_PHASE_OUTPUTS;
+
+    // Mute everything before the neutral waveform starts; from here the calibration owns the relays.
+    setRelays(false);
+    _dcOffsetActive = true;
+    _dcOffsetSelected = -1;
+    _dcOffsetLastSampleMs = 0;
+    _dcOffsetRuns++;
+    _dcOffset.begin(params, channels, start, now);
+    applyDcOffsetNull();
+    setOutputAmplitude(0.0f);
+    waveform.setEnabled(true);
+    if (out && outSize > 0) snprintf(out, outSize, "Nulling %u channel offsets.", (unsigned)channels);
+    return true;
+#else
+    if (out && outSize > 0) snprintf(out, outSize, "DC offset nulling is not compiled in.");
+    return false;
+#endif
+}
+
+void MotorController::cancelDcOffsetNull() {
+    finishDcOffsetNull(true);
+}
+
+void MotorController::clearDcOffsetNull() {
+    if (_dcOffsetActive) return;
+    memset(settings.get().dcOffsetNull, 0, sizeof(settings.get().dcOffsetNull));
+    applyDcOffsetNull();
+    _settingsDirty = true;
+    _lastSettingsChange = hal.getMillis();
+}
+
+DcOffsetStatus MotorController::getDcOffsetStatus() const {
+    DcOffsetStatus status;
+    memset(&status, 0, sizeof(status));
+    status.enabled = DC_OFFSET_NULL_ENABLE != 0;
+    status.active = _dcOffsetActive;
+    status.step = _dcOffset.getStep();
+    status.selectedChannel = _dcOffset.getSelectedChannel();
+    status.channels = _dcOffset.getChannelCount();
+    status.zeroCounts = _dcOffset.getZeroCounts();
+    for (int ch = 0; ch < 4; ch++) {
+        status.storedCounts[ch] = dcOffsetFromStored(settings.get().dcOffsetNull[ch]);
+        status.appliedCounts[ch] = dcOffsetFromStored(waveform.getDcOffsetNull(ch));
+        status.result[ch] = _dcOffset.getChannel(ch);
+    }
+    status.lastSucceeded = _dcOffsetLastSucceeded;
+    status.runs = _dcOffsetRuns;
+    return status;
+}
+
+void MotorController::updateDcOffsetNull(uint32_t now) {
+#if DC_OFFSET_NULL_ENABLE
+    if (!_dcOffsetActive) return;
+    if (errorHandler.hasCriticalError()) {
+        finishDcOffsetNull(true);
+        return;
+    }
+    if (_dcOffsetLastSampleMs != 0 && now - _dcOffsetLastSampleMs < DC_OFFSET_SAMPLE_MS) return;
+    _dcOffsetLastSampleMs = now;
+
+    bool running = _dcOffset.update(readDcOffsetSense(), now);
+    if (!running) {
+        finishDcOffsetNull(false);
+        return;
+    }
+    // The calibrator restarts its settle time on every change, so the duty and relay follow it in the same pass.
+    applyDcOffsetNull();
+    selectDcOffsetChannel(_dcOffset.getSelectedChannel());
+#else
+    (void)now;
+#endif
+}
+
+void MotorController::finishDcOffsetNull(bool cancelled) {
+#if DC_OFFSET_NULL_ENABLE
+    if (!_dcOffsetActive) return;
+    if (cancelled) _dcOffset.cancel();
+    _dcOffsetActive = false;
+    _dcOffsetLastSucceeded = _dcOffset.succeeded();
+
+    // Mute before the idle duty returns; a disabled linear waveform sits at zero duty, not at neutral.
+    selectDcOffsetChannel(-1);
+    waveform.setEnabled(false);
+
+    // Channels that nulled keep their new correction even if another failed; the rest keep the one they started with.
+    bool changed = false;
+    uint8_t nulled = 0;
+    uint8_t channels = _dcOffset.getChannelCount();
+    for (uint8_t ch = 0; ch < channels; ch++) {
+        const DcOffsetChannel& result = _dcOffset.getChannel(ch);
+        int16_t stored = dcOffsetToStored(result.offsetCounts, DC_OFFSET_MAX_COUNTS);
+        if (stored != settings.get().dcOffsetNull[ch]) changed = true;
+        settings.get().dcOffsetNull[ch] = stored;
+        if (result.outcome == DC_OFFSET_NULLED) nulled++;
+    }
+    applyDcOffsetNull();
+    if (changed) {
+        _settingsDirty = true;
+        _lastSettingsChange = hal.getMillis();
+    }
+
+    char message[64];
+    if (cancelled) {
+        snprintf(message, sizeof(message), "Offset null cancelled, %u of %u channels nulled", (unsigned)nulled, (unsigned)channels);
+        errorHandler.logEvent(ERR_OUTPUT_OFFSET, message);
+    } else if (nulled == channels) {
+        snprintf(message, sizeof(message), "Offset null: %u channels nulled", (unsigned)channels);
+        errorHandler.logEvent(ERR_OUTPUT_OFFSET, message);
+    } else {
+        // A channel that will not null usually has a wiring or amplifier fault, so this one is raised as a warning.
+        snprintf(message, sizeof(message), "Offset null: %u of %u channels nulled", (unsigned)nulled, (unsigned)channels);
+        errorHandler.report(ERR_OUTPUT_OFFSET, message, false);
+    }
+
+    if (_state == STATE_STOPPED && settings.get().muteRelayLinkStandby && !settings.get().muteRelayLinkStartStop) {
+        setRelays(true);
+    } else {
+        setRelays(false);
+    }
+#else
+    (void)cancelled;
+#endif
+}
+
+void MotorController::applyDcOffsetNull() {
+#if DC_OFFSET_NULL_ENABLE
+    for (int ch = 0; ch < 4; ch++) {
+        // While calibrating, the probe may sit past the largest correction that is stored.
+        int16_t steps = _dcOffsetActive ? dcOffsetToStored(_dcOffset.getAppliedCounts(ch), DC_OFFSET_MAX_COUNTS + DC_OFFSET_PROBE_COUNTS) : settings.get().dcOffsetNull[ch];
+        waveform.setDcOffsetNull(ch, steps);
+    }
+#endif
+}
+
+void MotorController::selectDcOffsetChannel(int8_t channel) {
+#if DC_OFFSET_NULL_ENABLE
+    if (channel == _dcOffsetSelected) return;
+    _dcOffsetSelected = channel;
+    writeRelayOutput(PIN_MUTE_PHASE_A, channel == 0);
+    writeRelayOutput(PIN_MUTE_PHASE_B, channel == 1);
+    writeRelayOutput(PIN_MUTE_PHASE_C, channel == 2);
+#if ENABLE_4_CHANNEL_SUPPORT
+    writeRelayOutput(PIN_MUTE_PHASE_D, channel == 3);
+#endif
+#else
+    (void)channel;
+#endif
 }
 
 void MotorController::setOutputAmplitude(float amplitude) {
@@ -778,7 +1380,7 @@ void MotorController::toggleStartStop() {
 }
 
 void MotorController::toggleStandby() {
-    if (_relayTestMode) return;
+    if (_relayTestMode || _dcOffsetActive) return;
     if (!ENABLE_STANDBY) return;
     if (_state == STATE_STOPPING) return;
     if (_state == STATE_STANDBY && errorHandler.hasCriticalError()) return;
@@ -820,6 +1422,7 @@ void MotorController::toggleStandby() {
 }
 
 void MotorController::emergencyStop() {
+    if (_dcOffsetActive) finishDcOffsetNull(true);
     if (_relayTestMode) {
         setRelayTestStage(0);
         _relayTestMode = false;
@@ -829,6 +1432,7 @@ void MotorController::emergencyStop() {
     _state = ENABLE_STANDBY ? STATE_STANDBY : STATE_STOPPED;
     currentMotorState = _state;
 
+    if (_coastDownActive) cancelCoastDown();
     restoreSweepTuning();
     clearMotionState();
     resetClosedLoopControl(true);
@@ -874,6 +1478,7 @@ void MotorController::setSpeed(SpeedMode mode) {
 
     SpeedMode previousSpeedMode = _currentSpeedMode;
     float previousTargetRpm = calculateClosedLoopTargetRpmForSpeed(previousSpeedMode);
+    finishHealthSession();
 
     _currentSpeedMode = mode;
     settings.get().currentSpeed = mode;
@@ -882,6 +1487,9 @@ void MotorController::setSpeed(SpeedMode mode) {
     // Calculate new target frequency including pitch and per-speed limits.
     float newTarget = calculatePitchAdjustedFrequencyForSpeed(mode);
 
+    // The correction the old speed needed, scaled to the new drive frequency, is the best first guess for the new speed.
+    float carriedCorrectionHz = closedLoopCarryHz(_targetFreq, newTarget);
+
     if (_state == STATE_RUNNING) {
         if (settings.get().smoothSwitching) {
             // Initiate smooth frequency ramp
@@ -893,15 +1501,19 @@ void MotorController::setSpeed(SpeedMode mode) {
             _rampStartRpm = previousTargetRpm;
             _rampTargetRpm = calculateClosedLoopTargetRpmForSpeed(mode);
             _targetFreq = newTarget;
+            _rampFromSpeedMode = previousSpeedMode;
             resetClosedLoopControl(false);
-            waveform.updateSettings(_rampStartFreq, s, settings.get().phaseMode);
+            // The ramp starts from the frequency actually played, old correction included, and ends on the carried one.
+            _rampCarryHz = carriedCorrectionHz;
+            // The new speed's tune is blended in with the ramp rather than switched here.
+            waveform.crossfadeTune(previousSpeedMode, mode, 0.0f);
         } else {
             // Instant switch
             _isSpeedRamping = false;
             _targetFreq = newTarget;
-            _currentFreq = _targetFreq;
+            _currentFreq = carriedCorrectionHz != 0.0f ? clampToCurrentSpeedRange(_targetFreq + carriedCorrectionHz) : _targetFreq;
             currentFrequency = _currentFreq;
-            scheduleClosedLoopEngage(hal.getMillis());
+            scheduleClosedLoopEngage(hal.getMillis(), carriedCorrectionHz);
             waveform.updateSettings(_currentFreq, s, settings.get().phaseMode);
         }
     } else {
@@ -912,6 +1524,9 @@ void MotorController::setSpeed(SpeedMode mode) {
         waveform.updateSettings(_currentFreq, s, settings.get().phaseMode);
     }
 
+    // A speed change mid-run starts a new session at the new speed.
+    if (isRunning()) beginHealthSession();
+
     // Defer save to avoid blocking
     _settingsDirty = true;
     _lastSettingsChange = hal.getMillis();
@@ -963,12 +1578,14 @@ void MotorController::applySettings() {
 
     speedFeedback.configure();
     if (_state == STATE_RUNNING) {
-        scheduleClosedLoopEngage(hal.getMillis());
+        // A settings edit, gains or control mode included, hands the loop over at the correction already applied.
+        scheduleClosedLoopEngage(hal.getMillis(), _closedLoopCorrectionHz);
     } else {
         resetClosedLoopControl(false);
     }
     waveform.updateSettings(_currentFreq, s, settings.get().phaseMode);
     powerStage.refreshPhaseEnables();
+    applyDcOffsetNull();
 }
 
 void MotorController::resetClosedLoop() {
@@ -983,7 +1600,7 @@ void MotorController::beginClosedLoopTuning() {
     _closedLoopTuneStep = CLOSED_LOOP_TUNE_SENSOR;
     resetClosedLoopControl(true);
     speedFeedback.configure();
-    speedFeedback.beginSetupCapture();
+    speedFeedback.beginSetupCapture(getSynchronousPlatterRpm());
 #endif
 }
 
@@ -1157,7 +1774,7 @@ const char* MotorController::closedLoopTuneStepName(uint8_t step) const {
 const char* MotorController::closedLoopTuneInstruction(uint8_t step) const {
     switch (step) {
         case CLOSED_LOOP_TUNE_SENSOR:
-            return "Rotate exactly one platter revolution, then advance.";
+            return "Run at speed to detect counts/rev, or turn one revolution by hand, then advance.";
         case CLOSED_LOOP_TUNE_MONITOR:
             return "Run the motor and confirm stable measured RPM.";
         case CLOSED_LOOP_TUNE_KP:
@@ -1191,6 +1808,10 @@ uint8_t MotorController::buildClosedLoopRecommendation(char* out, size_t outSize
             setup.suggestedReverseDirection ? ", reverse direction" : "");
         return CLOSED_LOOP_SUGGEST_APPLY_SETUP;
     }
+    if (setup.active && setup.autoDetect) {
+        snprintf(out, outSize, "Counts/rev detection: %s (%u%%).", setup.autoMessage, setup.autoProgressPercent);
+        return CLOSED_LOOP_SUGGEST_NONE;
+    }
     if (setup.active) {
         snprintf(out, outSize, "Rotate one full revolution; captured %ld counts.",
             (long)setup.countDelta);
@@ -1311,15 +1932,38 @@ bool MotorController::getClosedLoopTrendPoint(uint8_t index, ClosedLoopTrendPoin
     return true;
 }
 
+ClosedLoopNotchStatus MotorController::getClosedLoopNotchStatus() const {
+    ClosedLoopNotchStatus status;
+    memset(&status, 0, sizeof(status));
+    status.enabled = settings.get().closedLoopNotchEnabled;
+    status.stages = _closedLoopNotch.getStageCount();
+    for (uint8_t i = 0; i < status.stages; i++) {
+        const AdaptiveNotchStage& stage = _closedLoopNotch.getStage(i);
+        status.centreHz[i] = stage.getCentreHz();
+        status.engagement[i] = stage.getEngagement();
+        status.powerRatio[i] = stage.getPowerRatio();
+    }
+    return status;
+}
+
 float MotorController::clampToCurrentSpeedRange(float freq) const {
     SpeedSettings& s = settings.getCurrentSpeedSettings();
     return clampToSpeedSettings(clampOutputFrequency(freq), s);
 }
 
-void MotorController::scheduleClosedLoopEngage(uint32_t now) {
+void MotorController::scheduleClosedLoopEngage(uint32_t now, float heldCorrectionHz) {
     // Delay engagement after starts and speed changes so feedback has time to settle and the PID state starts from clean measurements.
     _closedLoopActive = false;
+#if CLOSED_LOOP_SPEED_ENABLE && CLOSED_LOOP_BUMPLESS_ENABLE
+    // A held correction stays applied through the delay; engagement then back-calculates the integral from it.
+    float limitHz = settings.getCurrentClosedLoopTuning().correctionLimitHz;
+    if (heldCorrectionHz > limitHz) heldCorrectionHz = limitHz;
+    if (heldCorrectionHz < -limitHz) heldCorrectionHz = -limitHz;
+    _closedLoopCorrectionHz = closedLoopControlAllowed() ? heldCorrectionHz : 0.0f;
+#else
+    (void)heldCorrectionHz;
     _closedLoopCorrectionHz = 0.0f;
+#endif
     resetClosedLoopPidState();
     _closedLoopTargetLastUpdate = 0;
     _closedLoopEngageTime = now + settings.get().closedLoopEngageDelayMs;
@@ -1333,6 +1977,7 @@ void MotorController::scheduleClosedLoopEngage(uint32_t now) {
     _closedLoopAmpOutOfLockStart = 0;
     _closedLoopAmpRecoveryActive = false;
     _closedLoopAmpRecoveryLatched = false;
+    resetClosedLoopSlipState();
 }
 
 void MotorController::resetClosedLoopControl(bool resetFeedback) {
@@ -1341,6 +1986,7 @@ void MotorController::resetClosedLoopControl(bool resetFeedback) {
     _closedLoopRequestedTargetRpm = 0.0f;
     _closedLoopRampTargetRpm = 0.0f;
     _closedLoopCorrectionHz = 0.0f;
+    _rampCarryHz = 0.0f;
     resetClosedLoopPidState();
     _closedLoopTargetLastUpdate = 0;
     _closedLoopEngageTime = 0;
@@ -1354,9 +2000,18 @@ void MotorController::resetClosedLoopControl(bool resetFeedback) {
     _closedLoopAmpOutOfLockStart = 0;
     _closedLoopAmpRecoveryActive = false;
     _closedLoopAmpRecoveryLatched = false;
+    resetClosedLoopSlipState();
     if (resetFeedback) {
+        // A stop or feedback reset may follow a sensor or pulley change, so the learned slip ratios start again from nominal.
+        for (int i = 0; i < 3; i++) {
+            _closedLoopSlipRatio[i].rpmPerHz = 0.0f;
+            _closedLoopSlipRatio[i].learned = false;
+        }
         speedFeedback.reset();
         resetClosedLoopMetrics();
+        // Resonances move with belt tension and load, so the search restarts from mid-band rather than a stale centre.
+        configureClosedLoopNotch(settings.get());
+        _closedLoopNotch.resetFrequency();
     }
 }
 
@@ -1368,7 +2023,7 @@ float MotorController::updateClosedLoopTarget(uint32_t now, float requestedRpm)
     if (_closedLoopTargetLastUpdate == 0 || _closedLoopTargetRpm <= 0.0f || g.closedLoopPitchSlewRpmPerSec <= 0.0f) {
         if (g.closedLoopPitchResetThresholdRpm > 0.0f &&
             fabs(requestedRpm - _closedLoopTargetRpm) >= g.closedLoopPitchResetThresholdRpm) {
-            resetClosedLoopPidState();
+            rebaseClosedLoopIntegral();
         }
         _closedLoopTargetRpm = requestedRpm;
         _closedLoopTargetLastUpdate = now;
@@ -1379,10 +2034,10 @@ float MotorController::updateClosedLoopTarget(uint32_t now, float requestedRpm)
     float delta = requestedRpm - _closedLoopTargetRpm;
     if (g.closedLoopPitchResetThresholdRpm > 0.0f &&
         fabs(delta) >= g.closedLoopPitchResetThresholdRpm) {
-        resetClosedLoopPidState();
+        rebaseClosedLoopIntegral();
     }
 
-    // Slew the target for smooth pitch changes. Large target jumps can still reset the PID state to avoid integral wind-up.
+    // Slew the target for smooth pitch changes. Large target jumps still rebase the PID state so the jump is not integrated as wind-up.
     float maxStep = g.closedLoopPitchSlewRpmPerSec * (elapsedMs / 1000.0f);
     if (maxStep <= 0.0f || fabs(delta) <= maxStep) {
         _closedLoopTargetRpm = requestedRpm;
@@ -1404,8 +2059,11 @@ float MotorController::updateClosedLoopTarget(uint32_t now, float requestedRpm)
 
 bool MotorController::closedLoopControlAllowed() const {
 #if CLOSED_LOOP_SPEED_ENABLE
+    // Sensorless speed is the rotor's electrical frequency, which equals the drive frequency while the rotor holds step.
+    // It has no speed error to correct, so that mode only supervises slip and pull-out.
     return settings.get().closedLoopEnabled &&
-           settings.get().closedLoopControlMode == CLOSED_LOOP_CONTROL_CORRECT;
+           settings.get().closedLoopControlMode == CLOSED_LOOP_CONTROL_CORRECT &&
+           settings.get().closedLoopSensorMode != CLOSED_LOOP_SENSOR_SENSORLESS;
 #else
     return false;
 #endif
@@ -1414,8 +2072,598 @@ bool MotorController::closedLoopControlAllowed() const {
 void MotorController::resetClosedLoopPidState() {
     _closedLoopIntegralHz = 0.0f;
     _closedLoopLastErrorRpm = 0.0f;
+    _closedLoopDerivativeRebase = false;
     _closedLoopLastUpdate = 0;
     _closedLoopSaturationStart = 0;
+    _closedLoopNotch.resetState();
+    resetLoadStepState();
+}
+
+#if CLOSED_LOOP_SPEED_ENABLE && CLOSED_LOOP_BUMPLESS_ENABLE
+static BumplessGains bumplessGains(const ClosedLoopSpeedTuning& tuning) {
+    BumplessGains gains;
+    gains.kp = tuning.kp;
+    gains.ki = tuning.ki;
+    gains.deadbandRpm = tuning.deadbandRpm;
+    gains.integralLimitHz = tuning.integralLimitHz;
+    return gains;
+}
+#endif
+
+void MotorController::rebaseClosedLoopIntegral() {
+#if CLOSED_LOOP_SPEED_ENABLE && CLOSED_LOOP_BUMPLESS_ENABLE
+    if (_closedLoopLastUpdate != 0) {
+        // The open-loop frequency already follows the new pitch, so the load share of the applied correction still holds.
+        // Only the share formed on the old error is dropped, and the error step is kept out of the derivative.
+        _closedLoopIntegralHz = bumplessIntegralHz(bumplessGains(settings.getCurrentClosedLoopTuning()), _closedLoopCorrectionHz, _closedLoopLastErrorRpm);
+        _closedLoopDerivativeRebase = true;
+        _closedLoopSaturationStart = 0;
+        return;
+    }
+#endif
+    resetClosedLoopPidState();
+}
+
+float MotorController::closedLoopCarryHz(float fromOpenLoopHz, float toOpenLoopHz) const {
+#if CLOSED_LOOP_SPEED_ENABLE && CLOSED_LOOP_BUMPLESS_ENABLE
+    // Only a correction the loop is actually applying is worth carrying to the new speed.
+    if (!_closedLoopActive || !closedLoopControlAllowed()) return 0.0f;
+    return bumplessCarryHz(_closedLoopCorrectionHz, fromOpenLoopHz, toOpenLoopHz);
+#else
+    (void)fromOpenLoopHz;
+    (void)toOpenLoopHz;
+    return 0.0f;
+#endif
+}
+
+void MotorController::resetLoadStepState() {
+    // The injected step lives in the integral, so whenever the integral is cleared the detector must forget it was loaded.
+    _loadStep.reset();
+    _loadStepLoaded = false;
+    _loadStepAppliedHz = 0.0f;
+}
+
+// Returns the feed-forward added to the integral this update, so the slew limit can let it through whole.
+float MotorController::updateLoadStep(uint32_t now, const SpeedFeedbackStatus& feedback, float dt, const ClosedLoopSpeedTuning& tuning) {
+    GlobalSettings& g = settings.get();
+    // Without an integral term there is nothing to carry the feed-forward, and nothing to measure the step from.
+    if (!g.loadStepEnabled || tuning.ki <= 0.0f || tuning.integralLimitHz <= 0.0f) {
+        resetLoadStepState();
+        return 0.0f;
+    }
+
+    LoadStepParams params;
+    params.slopeRpmPerSec = g.loadStepSlopeRpmPerSec;
+    params.slopeWindow = LOAD_STEP_SLOPE_WINDOW;
+    params.minErrorRpm = tuning.deadbandRpm > LOAD_STEP_MIN_ERROR_RPM ? tuning.deadbandRpm : LOAD_STEP_MIN_ERROR_RPM;
+    params.confirmSamples = LOAD_STEP_CONFIRM_SAMPLES;
+    params.armSec = LOAD_STEP_SETTLE_MS / 1000.0f;
+    params.settleSec = LOAD_STEP_SETTLE_MS / 1000.0f;
+    params.timeoutSec = LOAD_STEP_TIMEOUT_MS / 1000.0f;
+    _loadStep.configure(params);
+
+    uint8_t speed = (uint8_t)_currentSpeedMode;
+    float learnedHz = g.loadStepLearnedHz[speed];
+    LoadStepEvent event = _loadStep.update(feedback.rpmError, dt, feedback.locked, _closedLoopIntegralHz);
+    float integralBeforeHz = _closedLoopIntegralHz;
+    if (event == LOAD_STEP_DROP) {
+        _loadStepDrops++;
+        _loadStepLastEventMs = now;
+        if (learnedHz > 0.0f) {
+            _closedLoopIntegralHz += learnedHz;
+            _loadStepAppliedHz = learnedHz;
+            _loadStepLoaded = true;
+        }
+        if (g.loadStepBoostPercent > 0 && g.loadStepBoostMs > 0) _loadStepBoostStartMs = now;
+    } else if (event == LOAD_STEP_LIFT) {
+        _loadStepLifts++;
+        _loadStepLastEventMs = now;
+        if (_loadStepLoaded) _closedLoopIntegralHz -= _loadStepAppliedHz;
+        _loadStepLoaded = false;
+        _loadStepAppliedHz = 0.0f;
+    }
+    if (_closedLoopIntegralHz > tuning.integralLimitHz) {
+        _closedLoopIntegralHz = tuning.integralLimitHz;
+    } else if (_closedLoopIntegralHz < -tuning.integralLimitHz) {
+        _closedLoopIntegralHz = -tuning.integralLimitHz;
+    }
+    float feedForwardHz = _closedLoopIntegralHz - integralBeforeHz;
+
+    LoadStepEvent measuredEvent;
+    float stepHz;
+    bool settled;
+    if (!_loadStep.takeMeasurement(measuredEvent, stepHz, settled)) return feedForwardHz;
+    _loadStepMeasurements++;
+    _loadStepLastMeasuredHz = stepHz;
+    _loadStepLastSettled = settled;
+    float magnitudeHz = measuredEvent == LOAD_STEP_DROP ? stepHz : -stepHz;
+    // A timed-out measurement only shows how far the integral had climbed, so it may raise the learned step but never lower it.
+    if (!(magnitudeHz > 0.0f) || magnitudeHz > tuning.integralLimitHz) return feedForwardHz;
+    if (!settled && magnitudeHz <= learnedHz) return feedForwardHz;
+    float updatedHz = learnedHz > 0.0f ? learnedHz + (LOAD_STEP_LEARN_RATE * (magnitudeHz - learnedHz)) : magnitudeHz;
+    g.loadStepLearnedHz[speed] = updatedHz;
+    // Persist through the deferred save, but only for real changes so repeated drops of the same cartridge do not keep writing flash.
+    if (learnedHz <= 0.0f || fabs(updatedHz - learnedHz) >= learnedHz * 0.1f) {
+        _settingsDirty = true;
+        _lastSettingsChange = now;
+    }
+    return feedForwardHz;
+}
+
+void MotorController::updateLoadStepBoost(uint32_t now) {
+    const GlobalSettings& g = settings.get();
+    _loadStepBoost = 1.0f;
+    if (_loadStepBoostStartMs == 0 || !g.loadStepEnabled || g.loadStepBoostMs == 0) {
+        _loadStepBoostStartMs = 0;
+        return;
+    }
+    uint32_t elapsedMs = now - _loadStepBoostStartMs;
+    if (elapsedMs >= g.loadStepBoostMs) {
+        _loadStepBoostStartMs = 0;
+        return;
+    }
+    // The boost fades linearly so drive returns to the running level without a step of its own.
+    _loadStepBoost = 1.0f + ((float)g.loadStepBoostPercent / 100.0f) * (1.0f - ((float)elapsedMs / (float)g.loadStepBoostMs));
+}
+
+LoadStepStatus MotorController::getLoadStepStatus() const {
+    LoadStepStatus status;
+    const GlobalSettings& g = settings.get();
+    status.enabled = g.loadStepEnabled;
+    status.armed = _loadStep.isArmed();
+    status.measuring = _loadStep.isMeasuring();
+    status.loaded = _loadStepLoaded;
+    status.drops = _loadStepDrops;
+    status.lifts = _loadStepLifts;
+    status.measurements = _loadStepMeasurements;
+    status.lastEventMs = _loadStepLastEventMs;
+    status.lastMeasuredHz = _loadStepLastMeasuredHz;
+    status.lastSettled = _loadStepLastSettled;
+    for (uint8_t i = 0; i < 3; i++) status.learnedHz[i] = g.loadStepLearnedHz[i];
+    status.boost = _state == STATE_RUNNING ? _loadStepBoost : 1.0f;
+    return status;
+}
+
+void MotorController::clearLoadStepLearning() {
+    // For a cartridge or tracking-force change; the caller decides whether to save.
+    memset(settings.get().loadStepLearnedHz, 0, sizeof(settings.get().loadStepLearnedHz));
+    resetLoadStepState();
+    _loadStepMeasurements = 0;
+    _loadStepLastMeasuredHz = 0.0f;
+    _loadStepLastSettled = false;
+}
+
+void MotorController::beginStartupKick(uint32_t now) {
+    const GlobalSettings& g = settings.get();
+    SpeedSettings& s = settings.getCurrentSpeedSettings();
+    const ClosedLoopSpeedTuning& tuning = settings.getCurrentClosedLoopTuning();
+    uint8_t speed = (uint8_t)_currentSpeedMode;
+
+    StartupKickParams params;
+    params.pullInFraction = g.kickPullInPercent / 100.0f;
+    params.holdSec = STARTUP_KICK_HOLD_MS / 1000.0f;
+    params.slipFraction = STARTUP_KICK_SLIP_PERCENT / 100.0f;
+    // The speed filter is one exponential step per sample, so its lag is the sample interval scaled by (1 - alpha) / alpha.
+    float alpha = g.closedLoopFilterAlpha;
+    params.feedbackLagSec = (alpha > 0.0f && alpha < 1.0f) ? (g.closedLoopUpdateIntervalMs / 1000.0f) * (1.0f - alpha) / alpha : 0.0f;
+    params.lockToleranceRpm = tuning.lockToleranceRpm;
+    params.lockHoldSec = tuning.lockTimeMs / 1000.0f;
+    params.learnRate = STARTUP_KICK_LEARN_RATE;
+    params.rampGrowth = STARTUP_KICK_RAMP_GROWTH;
+    params.maxRampSec = 15.0f;
+    _startupKick.configure(params);
+
+    float targetRpm = calculateClosedLoopTargetRpm();
+    _startupKick.begin(s.startupKick > 1 ? targetRpm * s.startupKick : 0.0f, targetRpm);
+    _startupKickSpeed = speed;
+    _startupKickStarts++;
+
+    // Startup kick starts above target frequency for extra torque, optionally ramping down into the normal target frequency.
+    if (s.startupKick > 1) {
+        uint32_t kickMs = s.startupKickDuration * 1000UL;
+        _kickDeadlineEnd = KICK_END_TIMEOUT;
+        bool feedbackConfigured = false;
+#if CLOSED_LOOP_SPEED_ENABLE
+        feedbackConfigured = speedFeedback.getStatus().configured;
+#endif
+        // Without feedback to end the kick at pull-in, a length learned on earlier watched starts stands in for it.
+        if (g.adaptiveKickEnabled && !feedbackConfigured && g.kickLearnedMs[speed] > 0 && g.kickLearnedMs[speed] < kickMs) {
+            kickMs = g.kickLearnedMs[speed];
+            _kickDeadlineEnd = KICK_END_LEARNED;
+        }
+        _isKicking = true;
+        _kickEndTime = now + kickMs;
+        setCommandedFrequency(_targetFreq * s.startupKick);
+    } else {
+        _isKicking = false;
+        setCommandedFrequency(_targetFreq);
+    }
+}
+
+void MotorController::endStartupKick(uint32_t now, StartupKickEnd reason) {
+    _isKicking = false;
+    const GlobalSettings& g = settings.get();
+    SpeedSettings& s = settings.getCurrentSpeedSettings();
+    uint8_t speed = (uint8_t)_currentSpeedMode;
+
+    // Transition from Kick frequency to Target frequency. A learned ramp replaces the configured one, but a speed set to jump keeps jumping.
+    float rampSec = s.startupKickRampDuration;
+    if (g.adaptiveKickEnabled && rampSec > 0.0f && g.kickRampLearnedMs[speed] > 0) rampSec = g.kickRampLearnedMs[speed] / 1000.0f;
+    if (rampSec > 0.0f) {
+        // Ramp down frequency smoothly
+        _kickRampDuration = rampSec * 1000.0f;
+        _kickRampStartTime = now;
+        _kickRampStartFreq = waveform.getFrequency();
+        _isKickRamping = true;
+    } else {
+        // Jump immediately to target
+        setCommandedFrequency(_targetFreq);
+    }
+    _startupKick.endKick((now - _stateStartTime) / 1000.0f, reason, rampSec);
+}
+
+// Learned lengths persist through the deferred save, but only for real changes so every start does not write flash.
+static bool learnedLengthChanged(uint16_t previousMs, uint16_t learnedMs) {
+    if (previousMs == 0) return learnedMs != 0;
+    return abs((int32_t)learnedMs - (int32_t)previousMs) * 10 >= previousMs;
+}
+
+void MotorController::finishStartupKickRamp(uint32_t now) {
+    if (_startupKick.getPhase() != KICK_PHASE_RAMP) return;
+    _startupKick.endRamp();
+    GlobalSettings& g = settings.get();
+    // Only a ramp that started in synchronism says anything about how fast the platter can follow.
+    if (!g.adaptiveKickEnabled || !_startupKick.isPulledIn()) return;
+    uint8_t speed = _startupKickSpeed;
+    uint16_t previousMs = g.kickRampLearnedMs[speed];
+    uint16_t learnedMs = (uint16_t)constrain(lroundf(_startupKick.learnedRampSec() * 1000.0f), 0L, 15000L);
+    g.kickRampLearnedMs[speed] = learnedMs;
+    if (learnedLengthChanged(previousMs, learnedMs)) {
+        _settingsDirty = true;
+        _lastSettingsChange = now;
+    }
+}
+
+void MotorController::updateStartupKick(uint32_t now, bool sampleFeedback) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (!_startupKick.isTracking()) return;
+    float elapsedSec = (now - _stateStartTime) / 1000.0f;
+    if (_state == STATE_RUNNING) {
+        // Soft start can finish before the kick or its ramp; the rest of the start is then plain settling.
+        if (_startupKick.getPhase() == KICK_PHASE_KICK) _startupKick.endKick(elapsedSec, _kickDeadlineEnd, 0.0f);
+        _startupKick.endRamp();
+        // A speed change, sweep or a start that never settles has no time-to-lock worth reporting.
+        if (_isSpeedRamping || _isSweepingMode || (uint8_t)_currentSpeedMode != _startupKickSpeed || now - _stateStartTime > STARTUP_LOCK_TIMEOUT_MS) {
+            _startupKick.abandon();
+            return;
+        }
+    }
+
+    // Expected speed follows the drive frequency, so it is the kick's synchronous speed during the kick and falls with the ramp.
+    float targetRpm = calculateClosedLoopTargetRpm();
+    float expectedRpm = _targetFreq > 0.0f ? targetRpm * fabsf(_currentFreq) / _targetFreq : targetRpm;
+    if (sampleFeedback) speedFeedback.update(expectedRpm);
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+    if (!feedback.configured) {
+        if (_state == STATE_RUNNING) _startupKick.abandon();
+        return;
+    }
+    if (!_startupKick.update(elapsedSec, feedback.filteredRpm, feedback.signalValid, expectedRpm)) return;
+
+    if (_startupKick.isLocked()) {
+        _startupTimeToLockSec[_startupKickSpeed] = _startupKick.getTimeToLockSec();
+        if (_healthSessionActive && _healthSpeed == _startupKickSpeed) _healthTimeToLockSec = _startupKick.getTimeToLockSec();
+        return;
+    }
+
+    _startupKickPullIns++;
+    GlobalSettings& g = settings.get();
+    if (!g.adaptiveKickEnabled) return;
+    uint8_t speed = _startupKickSpeed;
+    uint16_t previousMs = g.kickLearnedMs[speed];
+    float learnedSec = _startupKick.learnedKickSec(previousMs / 1000.0f);
+    uint16_t learnedMs = (uint16_t)constrain(lroundf(learnedSec * 1000.0f), 1L, 15000L);
+    g.kickLearnedMs[speed] = learnedMs;
+    if (learnedLengthChanged(previousMs, learnedMs)) {
+        _settingsDirty = true;
+        _lastSettingsChange = now;
+    }
+    if (_isKicking) endStartupKick(now, KICK_END_PULL_IN);
+#else
+    (void)now;
+    (void)sampleFeedback;
+#endif
+}
+
+StartupKickStatus MotorController::getStartupKickStatus() const {
+    StartupKickStatus status;
+    const GlobalSettings& g = settings.get();
+    status.enabled = g.adaptiveKickEnabled;
+    status.tracking = _startupKick.isTracking();
+    status.phase = _startupKick.getPhase();
+    status.lastEnd = _startupKick.getKickEnd();
+    status.lastKickSec = _startupKick.getKickSec();
+    status.lastPullInSec = _startupKick.isPulledIn() ? _startupKick.getPullInSec() : 0.0f;
+    status.lastRampSec = _startupKick.getRampSec();
+    status.lastRampSlipped = _startupKick.rampSlipped();
+    status.starts = _startupKickStarts;
+    status.pullIns = _startupKickPullIns;
+    for (uint8_t i = 0; i < 3; i++) {
+        status.timeToLockSec[i] = _startupTimeToLockSec[i];
+        status.learnedKickSec[i] = g.kickLearnedMs[i] / 1000.0f;
+        status.learnedRampSec[i] = g.kickRampLearnedMs[i] / 1000.0f;
+    }
+    return status;
+}
+
+void MotorController::clearStartupKickLearning() {
+    // For a motor, belt or bearing service; the caller decides whether to save.
+    memset(settings.get().kickLearnedMs, 0, sizeof(settings.get().kickLearnedMs));
+    memset(settings.get().kickRampLearnedMs, 0, sizeof(settings.get().kickRampLearnedMs));
+    memset(_startupTimeToLockSec, 0, sizeof(_startupTimeToLockSec));
+}
+
+void MotorController::beginHealthSession() {
+    _healthSessionActive = true;
+    _healthSpeed = (uint8_t)_currentSpeedMode;
+    _healthLockedMs = 0;
+    _healthSamples = 0;
+    _healthCorrectionSum = 0.0f;
+    _healthAmplitudeSum = 0.0f;
+    _healthErrorSquaredSum = 0.0f;
+    _healthPitched = false;
+    // Only a session that began with a start has a time to lock; a speed change mid-run leaves it unmeasured.
+    _healthTimeToLockSec = 0.0f;
+}
+
+void MotorController::recordHealthSample(const SpeedFeedbackStatus& feedback, uint32_t elapsedMs) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    // Ramps and sweeps are deliberate disturbances, not the deck's steady-state effort.
+    if (!_healthSessionActive || _isSpeedRamping || _isSweepingMode || (uint8_t)_currentSpeedMode != _healthSpeed) return;
+    _healthLockedMs += elapsedMs;
+    _healthSamples++;
+    _healthCorrectionSum += _closedLoopCorrectionHz;
+    _healthAmplitudeSum += _appliedAmp;
+    _healthErrorSquaredSum += feedback.rpmError * feedback.rpmError;
+    if (currentPitchPercent != 0.0f) _healthPitched = true;
+#else
+    (void)feedback;
+    (void)elapsedMs;
+#endif
+}
+
+void MotorController::finishHealthSession() {
+    if (!_healthSessionActive) return;
+    _healthSessionActive = false;
+#if CLOSED_LOOP_SPEED_ENABLE
+    // Short sessions are dominated by the start and would add scatter rather than trend.
+    if (_healthSamples == 0 || _healthLockedMs < (uint32_t)HEALTH_MIN_LOCKED_SEC * 1000UL) return;
+
+    uint8_t speed = _healthSpeed;
+    HealthRecord record;
+    memset(&record, 0, sizeof(record));
+    record.runtimeSec = settings.getTotalRuntime();
+    record.correctionHz = _healthCorrectionSum / (float)_healthSamples;
+    record.lockAmplitude = _healthAmplitudeSum / (float)_healthSamples;
+    record.timeToLockSec = _healthTimeToLockSec;
+    record.errorRmsRpm = sqrtf(_healthErrorSquaredSum / (float)_healthSamples);
+    record.coastSec = _healthCoastSec[speed];
+    uint32_t lockedSec = _healthLockedMs / 1000UL;
+    record.lockedSec = (uint16_t)(lockedSec > 65535UL ? 65535UL : lockedSec);
+    record.speed = speed;
+    _healthCoastSec[speed] = 0.0f;
+    settings.appendHealthRecord(record);
+    refreshHealthTrend(speed, true);
+    learnBaseFrequency(speed, record.correctionHz, _healthLockedMs);
+#endif
+}
+
+void MotorController::refreshHealthTrend(uint8_t speed, bool reportNewDrift) {
+    if (speed > SPEED_78) return;
+    HealthTrendParams params;
+    params.minSessions = HEALTH_TREND_MIN_SESSIONS;
+    params.minTStat = HEALTH_TREND_T_STAT;
+    params.minChange[HEALTH_CORRECTION] = HEALTH_MIN_CORRECTION_CHANGE_HZ;
+    params.minChange[HEALTH_LOCK_AMPLITUDE] = HEALTH_MIN_AMPLITUDE_CHANGE;
+    params.minChange[HEALTH_TIME_TO_LOCK] = HEALTH_MIN_LOCK_TIME_CHANGE_SEC;
+    params.minChange[HEALTH_ERROR_RMS] = HEALTH_MIN_ERROR_RMS_CHANGE_RPM;
+    params.minChange[HEALTH_COAST] = HEALTH_MIN_COAST_CHANGE_SEC;
+    analyseHealthTrend(settings.getHealthRecords(), HEALTH_HISTORY_RECORDS, speed, params, _healthTrend[speed]);
+
+    // Alert once per kind of drift; one that clears and later returns is reported again.
+    uint8_t drift = _healthTrend[speed].drift;
+    uint8_t newDrift = drift & ~_healthReportedDrift[speed];
+    _healthReportedDrift[speed] = drift;
+    if (!reportNewDrift || newDrift == HEALTH_DRIFT_NONE) return;
+
+    static const char* const speedNames[3] = { "33", "45", "78" };
+    char message[96];
+    snprintf(message, sizeof(message), "%s rpm health drift:%s%s%s over %.0f h",
+        speedNames[speed],
+        (newDrift & HEALTH_DRIFT_BELT) ? " belt stretch" : "",
+        (newDrift & HEALTH_DRIFT_BEARING) ? " bearing wear" : "",
+        (newDrift & HEALTH_DRIFT_STABILITY) ? " speed stability" : "",
+        _healthTrend[speed].spanHours);
+    errorHandler.report(ERR_MOTOR_HEALTH, message, false);
+}
+
+MotorHealthStatus MotorController::getHealthStatus() const {
+    MotorHealthStatus status;
+    memset(&status, 0, sizeof(status));
+    status.sessionActive = _healthSessionActive;
+    status.sessionSpeed = _healthSpeed;
+    status.sessionLockedSec = _healthLockedMs / 1000.0f;
+    status.records = settings.getHealthRecordCount();
+    for (uint8_t i = 0; i < 3; i++) status.trend[i] = _healthTrend[i];
+    return status;
+}
+
+bool MotorController::clearHealthHistory() {
+    memset(_healthCoastSec, 0, sizeof(_healthCoastSec));
+    memset(_healthTrend, 0, sizeof(_healthTrend));
+    memset(_healthReportedDrift, 0, sizeof(_healthReportedDrift));
+    return settings.clearHealthHistory();
+}
+
+static void loadBaseLearnSpeed(const BaseLearnSpeedModel& source, BaseLearnSpeed& target) {
+    target.ratioRpmPerHz = source.ratioRpmPerHz;
+    target.ratioSpread = source.ratioSpread;
+    target.weight = source.weight;
+    target.anchorHz = source.anchorHz;
+    target.lastHz = source.lastHz;
+    target.previousHz = source.previousHz;
+    target.probationAbsHz = source.probationAbsHz;
+}
+
+static void storeBaseLearnSpeed(const BaseLearnSpeed& source, BaseLearnSpeedModel& target) {
+    target.ratioRpmPerHz = source.ratioRpmPerHz;
+    target.ratioSpread = source.ratioSpread;
+    target.weight = source.weight;
+    target.anchorHz = source.anchorHz;
+    target.lastHz = source.lastHz;
+    target.previousHz = source.previousHz;
+    target.probationAbsHz = source.probationAbsHz;
+}
+
+void MotorController::learnBaseFrequency(uint8_t speed, float correctionHz, uint32_t lockedMs) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    GlobalSettings& g = settings.get();
+    if (!g.baseLearnEnabled || speed > SPEED_78) return;
+    // Hold mode and pitched sessions run away from the base on purpose, so only plain correction at zero pitch says where the base belongs.
+    if (!g.closedLoopEnabled || g.closedLoopControlMode != CLOSED_LOOP_CONTROL_CORRECT || _healthPitched) return;
+
+    BaseLearnSpeed learners[3];
+    for (uint8_t i = 0; i < 3; i++) loadBaseLearnSpeed(g.baseLearn[i], learners[i]);
+
+    SpeedSettings& s = g.speeds[speed];
+    BaseLearnSession session;
+    session.targetRpm = g.closedLoopTargetRpm[speed];
+    session.openLoopHz = clampToSpeedSettings(clampOutputFrequency(s.frequency), s);
+    session.correctionHz = correctionHz;
+    session.weight = (lockedMs / 1000.0f) / (float)BASE_LEARN_SESSION_SEC;
+    if (session.weight > 1.0f) session.weight = 1.0f;
+    session.baseHz = s.frequency;
+    session.minHz = s.minFrequency;
+    session.maxHz = s.maxFrequency;
+
+    BaseLearnParams params;
+    params.forget = BASE_LEARN_FORGET;
+    params.minWeight = BASE_LEARN_MIN_WEIGHT;
+    params.confidenceFraction = BASE_LEARN_CONFIDENCE_PPM / 1000000.0f;
+    params.maxStepFraction = BASE_LEARN_MAX_STEP_PERCENT / 100.0f;
+    params.maxTotalFraction = BASE_LEARN_MAX_TOTAL_PERCENT / 100.0f;
+    params.rollbackMarginHz = BASE_LEARN_ROLLBACK_MARGIN_HZ;
+    BaseLearnResult result = baseLearnSession(learners, speed, session, params);
+
+    for (uint8_t i = 0; i < 3; i++) storeBaseLearnSpeed(learners[i], g.baseLearn[i]);
+    _baseLearnLastAction[speed] = result.action;
+    _baseLearnLastShared[speed] = result.usedShared;
+    _baseLearnLastBounded[speed] = result.bounded;
+    // Every usable session changes the estimate, so it is saved on the usual quiet period whether or not the base moved.
+    _settingsDirty = true;
+    _lastSettingsChange = hal.getMillis();
+    if (result.action != BASE_LEARN_STEP && result.action != BASE_LEARN_ROLLBACK) return;
+
+    // Sessions end on stop or speed change, so the new base is picked up by the next start or switch to this speed.
+    float fromHz = s.frequency;
+    s.frequency = result.baseHz;
+    settings.normalize();
+    if (result.action == BASE_LEARN_STEP) {
+        _baseLearnSteps++;
+    } else {
+        _baseLearnRollbacks++;
+    }
+
+    static const char* const speedNames[3] = { "33", "45", "78" };
+    char message[96];
+    snprintf(message, sizeof(message), "%s rpm base %s %.3f -> %.3f Hz%s",
+        speedNames[speed],
+        result.action == BASE_LEARN_STEP ? "learned" : "rolled back",
+        fromHz,
+        s.frequency,
+        result.usedShared ? " (shared ratio)" : "");
+    errorHandler.logEvent(ERR_MOTOR_HEALTH, message);
+#else
+    (void)speed;
+    (void)correctionHz;
+    (void)lockedMs;
+#endif
+}
+
+BaseLearnStatus MotorController::getBaseLearnStatus() const {
+    BaseLearnStatus status;
+    memset(&status, 0, sizeof(status));
+    const GlobalSettings& g = settings.get();
+    status.enabled = g.baseLearnEnabled;
+    status.steps = _baseLearnSteps;
+    status.rollbacks = _baseLearnRollbacks;
+
+    BaseLearnSpeed learners[3];
+    for (uint8_t i = 0; i < 3; i++) loadBaseLearnSpeed(g.baseLearn[i], learners[i]);
+    float sharedWeight;
+    float sharedHalfWidth;
+    if (baseLearnSharedRatio(learners, status.sharedRatioRpmPerHz, sharedHalfWidth, sharedWeight)) {
+        status.sharedHalfWidthPpm = sharedHalfWidth * 1000000.0f;
+    } else {
+        status.sharedHalfWidthPpm = -1.0f;
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        BaseLearnSpeedStatus& out = status.speed[i];
+        float halfWidth = baseLearnHalfWidth(learners[i]);
+        out.ratioRpmPerHz = learners[i].ratioRpmPerHz;
+        out.halfWidthPpm = halfWidth < 0.0f ? -1.0f : halfWidth * 1000000.0f;
+        out.weight = learners[i].weight;
+        out.anchorHz = learners[i].anchorHz;
+        out.baseHz = g.speeds[i].frequency;
+        out.onProbation = learners[i].probationAbsHz > 0.0f;
+        out.lastAction = _baseLearnLastAction[i];
+        out.lastShared = _baseLearnLastShared[i];
+        out.lastBounded = _baseLearnLastBounded[i];
+    }
+    return status;
+}
+
+bool MotorController::rollbackBaseLearning(char* out, size_t outSize) {
+    if (isMoving()) {
+        if (out && outSize > 0) snprintf(out, outSize, "Stop the motor before undoing learned base frequencies.");
+        return false;
+    }
+    // Each speed goes back to the base the user last set; the estimates that moved it go too.
+    GlobalSettings& g = settings.get();
+    uint8_t restored = 0;
+    for (uint8_t i = 0; i < 3; i++) {
+        BaseLearnSpeedModel& m = g.baseLearn[i];
+        if (m.anchorHz > 0.0f && fabsf(g.speeds[i].frequency - m.anchorHz) > m.anchorHz * 1e-5f) {
+            g.speeds[i].frequency = m.anchorHz;
+            restored++;
+        }
+        float anchorHz = m.anchorHz;
+        memset(&m, 0, sizeof(m));
+        m.anchorHz = anchorHz;
+        m.lastHz = anchorHz;
+    }
+    memset(_baseLearnLastAction, 0, sizeof(_baseLearnLastAction));
+    settings.normalize();
+    applySettings();
+    if (out && outSize > 0) snprintf(out, outSize, "Restored %u learned base frequencies in RAM.", (unsigned)restored);
+    return true;
+}
+
+void MotorController::clearBaseLearning() {
+    // The bases stay where learning left them and become the new anchors; only the estimates are forgotten. The caller decides whether to save.
+    memset(settings.get().baseLearn, 0, sizeof(settings.get().baseLearn));
+    memset(_baseLearnLastAction, 0, sizeof(_baseLearnLastAction));
+}
+
+void MotorController::configureClosedLoopNotch(const GlobalSettings& g) {
+    AdaptiveNotchParams params;
+    params.sampleHz = 1000.0f / (float)(g.closedLoopUpdateIntervalMs > 0 ? g.closedLoopUpdateIntervalMs : 1);
+    params.bandwidthHz = g.closedLoopNotchBandwidthHz;
+    params.minHz = g.closedLoopNotchMinHz;
+    params.maxHz = g.closedLoopNotchMaxHz;
+    params.adaptRate = CLOSED_LOOP_NOTCH_ADAPT_RATE;
+    params.detectRatio = CLOSED_LOOP_NOTCH_DETECT_RATIO;
+    _closedLoopNotch.configure(params, CLOSED_LOOP_NOTCH_STAGES);
 }
 
 void MotorController::resetClosedLoopMetrics() {
@@ -1424,6 +2672,7 @@ void MotorController::resetClosedLoopMetrics() {
     _closedLoopErrorSumRpm = 0.0f;
     _closedLoopAbsErrorSumRpm = 0.0f;
     _closedLoopCorrectionSumHz = 0.0f;
+    _closedLoopSlipSumPercent = 0.0f;
     _closedLoopMetricsLastSampleSequence = 0;
     _closedLoopMetricsLastSampleMs = 0;
     _closedLoopLastErrorSign = 0;
@@ -1489,6 +2738,7 @@ void MotorController::recordClosedLoopMetrics(uint32_t now, const SpeedFeedbackS
     if (feedback.locked) {
         _closedLoopMetrics.lockedSamples++;
         _closedLoopMetrics.lockedMs += elapsedMs;
+        recordHealthSample(feedback, elapsedMs);
     }
 
     float error = feedback.rpmError;
@@ -1576,10 +2826,194 @@ bool MotorController::applyBaseFrequencyCalibration(char* out, size_t outSize) {
     applySettings();
     resetClosedLoopControl(true);
     if (_state == STATE_RUNNING) scheduleClosedLoopEngage(hal.getMillis());
+    // Corrections so far were against the old base; the learner sees the new one as a user setting and re-anchors on it.
+    if (_healthSessionActive) beginHealthSession();
     if (out && outSize > 0) snprintf(out, outSize, "Applied base frequency %.3f Hz in RAM.", proposedHz);
     return true;
 }
 
+bool MotorController::beginCoastDown(char* out, size_t outSize) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (out && outSize > 0) out[0] = 0;
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+    if (_coastDownActive) {
+        if (out && outSize > 0) snprintf(out, outSize, "Coast-down is already running.");
+        return false;
+    }
+    if (_state != STATE_RUNNING || _isSpeedRamping || _isSweepingMode || !settings.get().closedLoopEnabled) {
+        if (out && outSize > 0) snprintf(out, outSize, "Run at a steady speed with closed-loop feedback enabled first.");
+        return false;
+    }
+    if (!feedback.signalValid || feedback.filteredRpm <= 0.0f || settings.get().closedLoopCountsPerRev == 0) {
+        if (out && outSize > 0) snprintf(out, outSize, "Wait for a valid speed signal before cutting drive.");
+        return false;
+    }
+
+    uint32_t now = hal.getMillis();
+    _coastDownActive = true;
+    _coastDownSpeed = _currentSpeedMode;
+    _coastDownStartMs = now;
+    _coastDownLastSequence = feedback.sampleSequence;
+    _coastDownWindowCount = feedback.count;
+    _coastDownWindowMs = feedback.sampleTimeMs;
+    _coastDownFit.reset();
+    // The filtered running speed is the best estimate at the instant drive is cut; later points come from raw count windows.
+    _coastDownFit.addSample(0.0f, feedback.filteredRpm);
+    memset(&_coastDownResult, 0, sizeof(_coastDownResult));
+    snprintf(_coastDownMessage, sizeof(_coastDownMessage), "Coasting from %.2f rpm.", feedback.filteredRpm);
+
+    // Cut drive through the normal stop path with an instant, unbraked release so the power stage is interlocked off as usual.
+    finishHealthSession();
+    _state = STATE_STOPPING;
+    powerStage.notifyStopping();
+    _stateStartTime = now;
+    resetClosedLoopControl(false);
+    _activeBrakeMode = BRAKE_OFF;
+    _activeBrakeDurationMs = 0.0f;
+    _activeBrakeMuteOnComplete = settings.get().muteRelayLinkStartStop;
+    if (out && outSize > 0) snprintf(out, outSize, "%s", _coastDownMessage);
+    return true;
+#else
+    if (out && outSize > 0) snprintf(out, outSize, "Closed loop is not compiled in.");
+    return false;
+#endif
+}
+
+void MotorController::cancelCoastDown() {
+    if (!_coastDownActive) return;
+    _coastDownActive = false;
+    snprintf(_coastDownMessage, sizeof(_coastDownMessage), "Coast-down cancelled.");
+}
+
+void MotorController::updateCoastDown(uint32_t now) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    // Nothing else samples the sensor once the motor is stopped, so the bench drives SpeedFeedback itself.
+    speedFeedback.update(_coastDownFit.getStartRpm());
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+
+    if (feedback.sampleSequence != _coastDownLastSequence) {
+        _coastDownLastSequence = feedback.sampleSequence;
+        int32_t counts = abs(feedback.count - _coastDownWindowCount);
+        uint32_t windowMs = feedback.sampleTimeMs - _coastDownWindowMs;
+        if (feedback.signalValid && counts >= COAST_DOWN_MIN_WINDOW_COUNTS && windowMs > 0) {
+            // Window-average speed is assigned to the window midpoint, where it best matches the instantaneous decaying speed.
+            float revolutions = (float)counts / (float)settings.get().closedLoopCountsPerRev;
+            float rpm = revolutions * (60000.0f / (float)windowMs);
+            float midSec = ((float)(_coastDownWindowMs - _coastDownStartMs) + ((float)windowMs * 0.5f)) / 1000.0f;
+            _coastDownFit.addSample(midSec, rpm);
+            _coastDownWindowCount = feedback.count;
+            _coastDownWindowMs = feedback.sampleTimeMs;
+        }
+    }
+
+    float endRpm = _coastDownFit.getStartRpm() * (COAST_DOWN_END_PERCENT / 100.0f);
+    if (_coastDownFit.getSampleCount() > 1 && _coastDownFit.getLastRpm() <= endRpm) {
+        finishCoastDown("reached end speed");
+    } else if (!feedback.signalValid && (now - _coastDownStartMs) > settings.get().closedLoopTimeoutMs) {
+        // Pulses stopping is the normal end for coarse sensors, which never report a window below the end speed.
+        finishCoastDown("signal ended");
+    } else if (now - _coastDownStartMs >= COAST_DOWN_TIMEOUT_MS) {
+        finishCoastDown("timed out");
+    }
+#else
+    (void)now;
+    _coastDownActive = false;
+#endif
+}
+
+void MotorController::finishCoastDown(const char* reason) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    _coastDownActive = false;
+    bool solved = _coastDownFit.solve(_coastDownResult);
+    if (!solved || _coastDownResult.sampleCount < 4 || _coastDownResult.rSquared < COAST_DOWN_MIN_R_SQUARED) {
+        snprintf(_coastDownMessage, sizeof(_coastDownMessage), "Coast-down %s; fit rejected (%u samples, R2 %.2f).",
+            reason, (unsigned)_coastDownResult.sampleCount, _coastDownResult.rSquared);
+        return;
+    }
+
+    CoastDownSpeedModel& model = settings.get().coastDownModel[_coastDownSpeed];
+    model.viscousPerSec = _coastDownResult.viscousPerSec;
+    model.coulombRpmPerSec = _coastDownResult.coulombRpmPerSec;
+    model.startRpm = _coastDownResult.startRpm;
+    model.rSquared = _coastDownResult.rSquared;
+    model.sampleCount = _coastDownResult.sampleCount;
+    model.valid = 1;
+    model.reserved = 0;
+    settings.normalize();
+    _healthCoastSec[_coastDownSpeed] = coastDownStopSeconds(_coastDownResult, _coastDownResult.startRpm);
+    snprintf(_coastDownMessage, sizeof(_coastDownMessage), "Coast-down %s; stop %.1f s from %.2f rpm, stored in RAM.",
+        reason, coastDownStopSeconds(_coastDownResult, _coastDownResult.startRpm), _coastDownResult.startRpm);
+#else
+    (void)reason;
+    _coastDownActive = false;
+#endif
+}
+
+CoastDownStatus MotorController::getCoastDownStatus() const {
+    CoastDownStatus status;
+    memset(&status, 0, sizeof(status));
+    status.active = _coastDownActive;
+    status.speed = _coastDownSpeed;
+    status.elapsedMs = _coastDownActive ? hal.getMillis() - _coastDownStartMs : 0;
+    status.sampleCount = _coastDownFit.getSampleCount();
+    status.startRpm = _coastDownFit.getStartRpm();
+    status.lastRpm = _coastDownFit.getLastRpm();
+    if (_coastDownActive) {
+        _coastDownFit.solve(status.fit);
+    } else {
+        status.fit = _coastDownResult;
+    }
+    snprintf(status.message, sizeof(status.message), "%s", _coastDownMessage[0] ? _coastDownMessage : "Idle");
+    return status;
+}
+
+bool MotorController::getCoastDownModel(SpeedMode speed, CoastDownFitResult& out) const {
+    memset(&out, 0, sizeof(out));
+    if (speed > SPEED_78) return false;
+    const CoastDownSpeedModel& model = settings.get().coastDownModel[speed];
+    out.valid = model.valid == 1;
+    out.viscousPerSec = model.viscousPerSec;
+    out.coulombRpmPerSec = model.coulombRpmPerSec;
+    out.startRpm = model.startRpm;
+    out.rSquared = model.rSquared;
+    out.sampleCount = model.sampleCount;
+    return out.valid;
+}
+
+bool MotorController::applyCoastDownSeeds(char* out, size_t outSize) {
+    // The fit identifies friction only. Drive and brake torque are the assumed margins, so these timings are rough estimates for the user to review.
+    GlobalSettings& g = settings.get();
+    uint8_t seeded = 0;
+    float brakeSeconds = 0.0f;
+    for (uint8_t i = 0; i < 3; i++) {
+        CoastDownFitResult model;
+        if (!getCoastDownModel((SpeedMode)i, model)) continue;
+        SpeedSettings& speed = g.speeds[i];
+        float spinUp = coastDownSpinUpSeconds(model, model.startRpm, COAST_DOWN_DRIVE_TORQUE_MARGIN);
+        speed.softStartDuration = constrain(roundf(spinUp * 10.0f) / 10.0f, 0.1f, 10.0f);
+        if (speed.startupKick > 1) {
+            // The kick only needs to cover the high-slip first half of the run-up.
+            speed.startupKickDuration = (uint8_t)constrain(lroundf(spinUp * 0.5f), 1L, 15L);
+        }
+        float stop = coastDownBrakeSeconds(model, model.startRpm, COAST_DOWN_BRAKE_TORQUE_MARGIN);
+        if (stop > brakeSeconds) brakeSeconds = stop;
+        seeded++;
+    }
+    if (seeded == 0) {
+        if (out && outSize > 0) snprintf(out, outSize, "No coast-down model stored. Run a coast-down at each speed first.");
+        return false;
+    }
+
+    g.brakeDuration = constrain(roundf(brakeSeconds * 10.0f) / 10.0f, 0.1f, 10.0f);
+    settings.normalize();
+    applySettings();
+    if (out && outSize > 0) {
+        snprintf(out, outSize, "Estimated %u speed%s from assumed torque: soft-start %.1f s, brake %.1f s in RAM. Review before saving.",
+            (unsigned)seeded, seeded == 1 ? "" : "s", settings.getCurrentSpeedSettings().softStartDuration, g.brakeDuration);
+    }
+    return true;
+}
+
 void MotorController::reportClosedLoopAction(const char* message, uint8_t action, bool& latch) {
     reportClosedLoopAction(message, action, latch, nullptr);
 }
@@ -1727,9 +3161,16 @@ float MotorController::applyClosedLoopCorrection(uint32_t now, float openLoopFre
 
     if (deadlinePending(now, _closedLoopEngageTime)) {
         _closedLoopActive = false;
+        // Only a correction handed over by scheduleClosedLoopEngage() is non-zero here.
+        if (_closedLoopCorrectionHz != 0.0f) return clampToCurrentSpeedRange(openLoopFreq + _closedLoopCorrectionHz);
         return openLoopFreq;
     }
 
+    // During a bus dip the platter slows for lack of torque, not a wrong frequency; integrating that would overshoot on recovery.
+    if (_busRideThrough) {
+        return clampToCurrentSpeedRange(openLoopFreq + _closedLoopCorrectionHz);
+    }
+
     SpeedFeedbackStatus feedback = speedFeedback.getStatus();
     if (g.closedLoopRequireSignalBeforeEngage && _closedLoopLastUpdate == 0 && !feedback.signalValid) {
         _closedLoopActive = false;
@@ -1790,6 +3231,10 @@ float MotorController::applyClosedLoopCorrection(uint32_t now, float openLoopFre
     if (_closedLoopLastUpdate == 0) {
         _closedLoopLastUpdate = now;
         _closedLoopLastErrorRpm = feedback.rpmError;
+#if CLOSED_LOOP_BUMPLESS_ENABLE
+        // Engaging from monitor mode, a ramp, a settings edit or a start continues from the correction already applied, zero included.
+        _closedLoopIntegralHz = bumplessIntegralHz(bumplessGains(tuning), _closedLoopCorrectionHz, feedback.rpmError);
+#endif
         _closedLoopActive = true;
         return clampToCurrentSpeedRange(openLoopFreq + _closedLoopCorrectionHz);
     }
@@ -1799,6 +3244,8 @@ float MotorController::applyClosedLoopCorrection(uint32_t now, float openLoopFre
     }
 
     float dt = elapsedMs / 1000.0f;
+    // Load steps are detected on the raw error and injected into the integral before this update's PID terms are formed.
+    float feedForwardHz = updateLoadStep(now, feedback, dt, tuning);
     float errorRpm = feedback.rpmError;
     if (fabs(errorRpm) < tuning.deadbandRpm) errorRpm = 0.0f;
 
@@ -1815,12 +3262,22 @@ float MotorController::applyClosedLoopCorrection(uint32_t now, float openLoopFre
     }
 
     float derivativeHz = 0.0f;
-    if (dt > 0.0f && tuning.kd > 0.0f) {
+    if (dt > 0.0f && tuning.kd > 0.0f && !_closedLoopDerivativeRebase) {
         derivativeHz = tuning.kd * ((errorRpm - _closedLoopLastErrorRpm) / dt);
     }
+    _closedLoopDerivativeRebase = false;
 
     // Correction is expressed in Hz because the actuator is waveform frequency.
     float requestedCorrection = proportionalHz + _closedLoopIntegralHz + derivativeHz;
+    if (g.closedLoopNotchEnabled) {
+        // The notch learns from the raw error so the deadband cannot hide a small resonance, then filters the full PID sum.
+        // Its unity DC gain leaves the integral path alone; only the oscillation the loop would otherwise feed is removed.
+        configureClosedLoopNotch(g);
+        _closedLoopNotch.track(feedback.rpmError);
+        requestedCorrection = _closedLoopNotch.apply(requestedCorrection);
+    } else {
+        _closedLoopNotch.resetState();
+    }
     if (requestedCorrection > tuning.correctionLimitHz) {
         requestedCorrection = tuning.correctionLimitHz;
     } else if (requestedCorrection < -tuning.correctionLimitHz) {
@@ -1845,12 +3302,12 @@ float MotorController::applyClosedLoopCorrection(uint32_t now, float openLoopFre
     }
 
     if (tuning.slewLimitHzPerSec > 0.0f) {
-        float maxStep = tuning.slewLimitHzPerSec * dt;
-        float delta = requestedCorrection - _closedLoopCorrectionHz;
-        if (delta > maxStep) {
-            requestedCorrection = _closedLoopCorrectionHz + maxStep;
-        } else if (delta < -maxStep) {
-            requestedCorrection = _closedLoopCorrectionHz - maxStep;
+        // A needle-drop feed-forward passes whole; only the PID's own change is rate limited.
+        requestedCorrection = loadStepSlewLimit(_closedLoopCorrectionHz, requestedCorrection, tuning.slewLimitHzPerSec * dt, feedForwardHz);
+        if (requestedCorrection > tuning.correctionLimitHz) {
+            requestedCorrection = tuning.correctionLimitHz;
+        } else if (requestedCorrection < -tuning.correctionLimitHz) {
+            requestedCorrection = -tuning.correctionLimitHz;
         }
     }
 
@@ -1911,8 +3368,102 @@ void MotorController::updateClosedLoopAmpRecovery(uint32_t now, const SpeedFeedb
 #endif
 }
 
+float MotorController::getSynchronousPlatterRpm() const {
+#if CLOSED_LOOP_SPEED_ENABLE
+    // Counts/rev detection cannot trust measured RPM, so the expected speed comes from the output frequency and configured pulley ratio alone.
+    if (_state != STATE_RUNNING || _isSpeedRamping || _isSweepingMode) return 0.0f;
+    return fabsf(_currentFreq) * nominalClosedLoopSlipRatio(_currentSpeedMode);
+#else
+    return 0.0f;
+#endif
+}
+
+float MotorController::nominalClosedLoopSlipRatio(SpeedMode speed) const {
+    // Until a locked run has been observed, the configured target RPM and base frequency are the best estimate of platter RPM per output Hz.
+    const GlobalSettings& g = settings.get();
+    float baseHz = g.speeds[speed].frequency;
+    if (!isfinite(baseHz) || baseHz <= 0.0f) return 0.0f;
+    return g.closedLoopTargetRpm[speed] / baseHz;
+}
+
+void MotorController::resetClosedLoopSlipState() {
+    _closedLoopSlipWindow.reset();
+    _closedLoopSlipLatched = false;
+    _closedLoopSlipLastSampleSequence = 0;
+}
+
+void MotorController::updateClosedLoopSlip(uint32_t now, const SpeedFeedbackStatus& feedback) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    // The commanded output frequency sets the synchronous platter speed. A sustained shortfall means the belt is slipping or the rotor has pulled out of step.
+    GlobalSettings& g = settings.get();
+    if (!g.closedLoopEnabled || !feedback.signalValid || _isSpeedRamping || _isSweepingMode ||
+        deadlinePending(now, _closedLoopEngageTime)) {
+        resetClosedLoopSlipState();
+        return;
+    }
+    if (feedback.sampleSequence == _closedLoopSlipLastSampleSequence) return;
+    _closedLoopSlipLastSampleSequence = feedback.sampleSequence;
+
+    float outputHz = fabsf(_currentFreq);
+    SlipRatio& ratio = _closedLoopSlipRatio[_currentSpeedMode];
+    slipRatioUpdate(ratio, nominalClosedLoopSlipRatio(_currentSpeedMode), outputHz, feedback.filteredRpm, feedback.locked);
+    if (ratio.rpmPerHz <= 0.0f || outputHz <= 0.0f) return;
+
+    float slip = slipPercent(ratio.rpmPerHz, outputHz, feedback.filteredRpm);
+    _closedLoopMetrics.lastSlipPercent = slip;
+    _closedLoopMetrics.slipRatioRpmPerHz = ratio.rpmPerHz;
+    _closedLoopMetrics.slipSamples++;
+    _closedLoopSlipSumPercent += slip;
+    _closedLoopMetrics.averageSlipPercent = _closedLoopSlipSumPercent / _closedLoopMetrics.slipSamples;
+    if (slip > _closedLoopMetrics.peakSlipPercent) _closedLoopMetrics.peakSlipPercent = slip;
+
+    SlipDetectParams params;
+    params.slipThresholdPercent = g.closedLoopSlipThresholdPercent;
+    params.pullOutThresholdPercent = g.closedLoopPullOutThresholdPercent;
+    params.detectMs = g.closedLoopSlipDetectMs;
+    SlipDetectState state = _closedLoopSlipWindow.update(now, slip, feedback.locked, ratio.learned, params);
+    if (state == SLIP_DETECT_CLEAR) _closedLoopSlipLatched = false;
+    if (state == SLIP_DETECT_CLEAR || state == SLIP_DETECT_PENDING) return;
+
+    uint8_t action = g.closedLoopSlipAction;
+    if (action == CLOSED_LOOP_SLIP_IGNORE) return;
+
+    bool pullOut = state == SLIP_DETECT_PULL_OUT;
+    if (!_closedLoopSlipLatched) {
+        if (pullOut) {
+            _closedLoopMetrics.pullOutEvents++;
+        } else {
+            _closedLoopMetrics.slipEvents++;
+        }
+    }
+
+    char message[64];
+    if (action == CLOSED_LOOP_SLIP_BOOST && _isReducedAmp) {
+        // Restoring full drive is the only torque increase available; reduced amplitude resumes after the normal delay.
+        _isReducedAmp = false;
+        _currentAmp = _targetAmp;
+        applyDriveAmplitude();
+        _ampReductionStartTime = now;
+        snprintf(message, sizeof(message), "%s %.1f%%, full amplitude restored",
+            pullOut ? "Rotor pull-out" : "Platter slip", _closedLoopSlipWindow.getPeakPercent());
+    } else {
+        snprintf(message, sizeof(message), "%s %.1f%%",
+            pullOut ? "Rotor pull-out" : "Platter slip", _closedLoopSlipWindow.getPeakPercent());
+    }
+    reportClosedLoopAction(message,
+        action == CLOSED_LOOP_SLIP_STOP ? CLOSED_LOOP_FAULT_STOP : CLOSED_LOOP_FAULT_WARN,
+        _closedLoopSlipLatched, &feedback);
+#else
+    (void)now;
+    (void)feedback;
+#endif
+}
+
 void MotorController::clearMotionState() {
     _isKicking = false;
+    _startupKick.abandon();
+    // Emergency stops, standby and faults end a session without recording it.
+    _healthSessionActive = false;
     _isKickRamping = false;
     _isSpeedRamping = false;
     _isSweepingMode = false;
@@ -1937,7 +3488,7 @@ void MotorController::forceDriveOutputsOff() {
 
 void MotorController::setRelays(bool active) {
     if (!ENABLE_MUTE_RELAYS) return;
-    if (_relayTestMode) return;
+    if (_relayTestMode || _dcOffsetActive) return;
 
     bool activeHigh = settings.get().relayActiveHigh;
     bool requestedActive = active;
@@ -2020,7 +3571,7 @@ bool MotorController::beginRelayTest() {
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     return false;
 #else
-    if (errorHandler.hasCriticalError()) return false;
+    if (errorHandler.hasCriticalError() || _dcOffsetActive) return false;
     if (_state == STATE_STARTING || _state == STATE_RUNNING || _state == STATE_STOPPING) {
         return false;
     }
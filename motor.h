@@ -13,6 +13,18 @@
 #include "config.h"
 #include "types.h"
 #include "globals.h"
+#include "slip_detect.h"
+#include "closed_loop_bumpless.h"
+#include "tach_brake.h"
+#include "coast_model.h"
+#include "thermal_model.h"
+#include "adaptive_notch.h"
+#include "load_step.h"
+#include "bus_voltage.h"
+#include "startup_kick.h"
+#include "health_trend.h"
+#include "base_learn.h"
+#include "dc_offset.h"
 
 struct SpeedFeedbackStatus;
 
@@ -52,12 +64,19 @@ struct ClosedLoopMetrics {
     uint32_t plausibilityEvents;
     uint32_t lockTimeoutEvents;
     uint32_t ampRecoveryEvents;
+    uint32_t slipEvents;
+    uint32_t pullOutEvents;
+    uint32_t slipSamples;
     uint32_t errorSignChanges;
     float averageErrorRpm;
     float averageAbsErrorRpm;
     float peakAbsErrorRpm;
     float lastErrorRpm;
     float averageCorrectionHz;
+    float lastSlipPercent;
+    float averageSlipPercent;
+    float peakSlipPercent;
+    float slipRatioRpmPerHz; // Learned platter RPM per output Hz; zero until a nominal ratio is available
 };
 
 // Circular trend sample used by the web dashboard for recent closed-loop motion.
@@ -83,6 +102,164 @@ struct ClosedLoopTuningStatus {
     ClosedLoopMetrics metrics;
 };
 
+// Coast-down bench snapshot. The model fields describe the speed being captured while active, otherwise the last finished run.
+struct CoastDownStatus {
+    bool active;
+    uint8_t speed;
+    uint32_t elapsedMs;
+    uint16_t sampleCount;
+    float startRpm;
+    float lastRpm;
+    CoastDownFitResult fit;
+    char message[96];
+};
+
+// Winding thermal estimate. Rises are above ambient; derate is the multiplier currently applied to running drive.
+struct MotorThermalStatus {
+    bool derateEnabled;
+    bool derating;
+    float driveLevel;
+    float windingRiseC;
+    float frameRiseC;
+    float totalRiseC;
+    float steadyRiseC;
+    float derate;
+    uint32_t derateEvents;
+};
+
+// Closed-loop notch snapshot, one entry per configured stage. Engagement is the 0-1 blend currently applied to the correction.
+struct ClosedLoopNotchStatus {
+    bool enabled;
+    uint8_t stages;
+    float centreHz[AdaptiveNotchBank::MAX_STAGES];
+    float engagement[AdaptiveNotchBank::MAX_STAGES];
+    float powerRatio[AdaptiveNotchBank::MAX_STAGES];
+};
+
+// Needle-drop feed-forward counters. Learned steps are the persisted per-speed values; boost is the drive multiplier now applied.
+struct LoadStepStatus {
+    bool enabled;
+    bool armed;
+    bool measuring;
+    bool loaded;
+    uint32_t drops;
+    uint32_t lifts;
+    uint32_t measurements;
+    uint32_t lastEventMs;
+    float lastMeasuredHz;
+    bool lastSettled;
+    float learnedHz[3];
+    float boost;
+};
+
+// Adaptive startup kick results. Learned lengths are the persisted per-speed values; time to lock is the latest start at each speed, 0 until one has locked.
+struct StartupKickStatus {
+    bool enabled;
+    bool tracking;
+    uint8_t phase;
+    uint8_t lastEnd;
+    float lastKickSec;
+    float lastPullInSec;
+    float lastRampSec;
+    bool lastRampSlipped;
+    uint32_t starts;
+    uint32_t pullIns;
+    float timeToLockSec[3];
+    float learnedKickSec[3];
+    float learnedRampSec[3];
+};
+
+// Long-term health. The session fields cover the run in progress; trends are fitted over the stored history for each speed.
+struct MotorHealthStatus {
+    bool sessionActive;
+    uint8_t sessionSpeed;
+    float sessionLockedSec;
+    uint16_t records;
+    HealthTrendResult trend[3];
+};
+
+// Base-frequency learning for one speed. The half-width is the ratio's confidence interval in ppm, negative before anything is learned.
+struct BaseLearnSpeedStatus {
+    float ratioRpmPerHz;
+    float halfWidthPpm;
+    float weight;
+    float anchorHz;
+    float baseHz;
+    bool onProbation;
+    uint8_t lastAction; // BaseLearnAction from the last session at this speed
+    bool lastShared;
+    bool lastBounded;
+};
+
+struct BaseLearnStatus {
+    bool enabled;
+    float sharedRatioRpmPerHz; // 0 until a speed has an estimate
+    float sharedHalfWidthPpm;
+    uint32_t steps;            // Since boot
+    uint32_t rollbacks;
+    BaseLearnSpeedStatus speed[3];
+};
+
+// Linear-amplifier DC offset nulling. Stored corrections are what the waveform applies outside calibration; applied ones are live while it runs.
+struct DcOffsetStatus {
+    bool enabled;
+    bool active;
+    uint8_t step;            // DcOffsetStep
+    int8_t selectedChannel;  // Channel connected to the sense, -1 for none
+    uint8_t channels;
+    float zeroCounts;        // Sense reading with every channel muted
+    float storedCounts[4];
+    float appliedCounts[4];
+    DcOffsetChannel result[4];
+    bool lastSucceeded;
+    uint32_t runs;           // Since boot
+};
+
+enum BrakeStopResult : uint8_t {
+    BRAKE_RESULT_NONE = 0,
+    BRAKE_RESULT_STANDSTILL,
+    BRAKE_RESULT_REVERSED,
+    BRAKE_RESULT_TIMEOUT,
+    BRAKE_RESULT_PREDICTED,
+    BRAKE_RESULT_NO_PULSE
+};
+
+// Tach-guided braking results. Overshoot is rotation the sensor still saw after drive was removed.
+struct BrakeMetrics {
+    bool active;
+    bool settling;
+    uint8_t lastResult;
+    bool lastReversed;
+    uint32_t stops;
+    uint32_t timeouts;
+    uint32_t fallbacks;
+    uint32_t lastStopMs;
+    uint32_t bestStopMs;
+    float lastStartRpm;
+    float currentRpm;
+    float lastOvershootDeg;
+    float lastOvershootRpm;
+    float peakOvershootRpm;
+};
+
+// DC bus supervision. scale is the supply feed-forward applied to the waveform; regenGuarded means active braking is permitted by supervision.
+struct BusVoltageStatus {
+    bool enabled;
+    BusVoltageState state;
+    float volts;
+    float fastVolts;
+    float scale;
+    float minVolts;
+    float maxVolts;
+    float dipMs;
+    float longestDipMs;
+    uint32_t dipsRiddenThrough;
+    uint32_t underVoltageEvents;
+    uint32_t overVoltageEvents;
+    uint32_t brakeAborts;
+    bool regenGuarded;
+};
+
 /**
  * @brief Manages the high-level state of the motor.
  * 
@@ -140,6 +317,7 @@ public:
     bool isClosedLoopActive() { return _closedLoopActive; }
     bool isClosedLoopAmpRecoveryActive() { return _closedLoopAmpRecoveryActive; }
     bool isClosedLoopSaturated() { return _closedLoopSaturationStart != 0; }
+    bool isClosedLoopSlipping() { return _closedLoopSlipWindow.isOpen(); }
     MotorState getState() { return _state; }
     SpeedMode getSpeed() { return _currentSpeedMode; }
     float getCurrentFrequency() { return _currentFreq; }
@@ -150,10 +328,18 @@ public:
     float getClosedLoopCorrectionHz() { return _closedLoopCorrectionHz; }
     float getClosedLoopReferenceTargetRpm();
     float getClosedLoopPitchOffsetRpm();
+    float getSynchronousPlatterRpm() const;
     ClosedLoopMetrics getClosedLoopMetrics() { return _closedLoopMetrics; }
     ClosedLoopTuningStatus getClosedLoopTuningStatus();
     uint8_t getClosedLoopTrendCount() const { return _closedLoopTrendCount; }
     bool getClosedLoopTrendPoint(uint8_t index, ClosedLoopTrendPoint& out) const;
+    ClosedLoopNotchStatus getClosedLoopNotchStatus() const;
+    LoadStepStatus getLoadStepStatus() const;
+    void clearLoadStepLearning();
+    StartupKickStatus getStartupKickStatus() const;
+    void clearStartupKickLearning();
+    MotorHealthStatus getHealthStatus() const;
+    bool clearHealthHistory();
     float getMotionProgress();
     void resetClosedLoop();
     void beginClosedLoopTuning();
@@ -161,7 +347,25 @@ public:
     bool applyClosedLoopTuningSuggestion(char* out, size_t outSize);
     bool getBaseFrequencyCalibration(float& currentHz, float& proposedHz, float& averageCorrectionHz, char* out, size_t outSize);
     bool applyBaseFrequencyCalibration(char* out, size_t outSize);
+    BaseLearnStatus getBaseLearnStatus() const;
+    bool rollbackBaseLearning(char* out, size_t outSize);
+    void clearBaseLearning();
     void cancelClosedLoopTuning();
+    bool beginCoastDown(char* out, size_t outSize);
+    void cancelCoastDown();
+    bool isCoastDownActive() const { return _coastDownActive; }
+    CoastDownStatus getCoastDownStatus() const;
+    bool getCoastDownModel(SpeedMode speed, CoastDownFitResult& out) const;
+    bool applyCoastDownSeeds(char* out, size_t outSize);
+    MotorThermalStatus getThermalStatus() const;
+    void resetThermalModel();
+    BrakeMetrics getBrakeMetrics() const;
+    BusVoltageStatus getBusVoltageStatus() const;
+    bool beginDcOffsetNull(char* out, size_t outSize);
+    void cancelDcOffsetNull();
+    void clearDcOffsetNull();
+    bool isDcOffsetNullActive() const { return _dcOffsetActive; }
+    DcOffsetStatus getDcOffsetStatus() const;
     
     // --- Relay Control ---
     void setRelays(bool active);
@@ -202,6 +406,13 @@ private:
     // Startup Kick
     bool _isKicking;
     uint32_t _kickEndTime;
+    // Pull-in and time-to-lock tracking for the start in progress; the learned lengths live in settings.
+    StartupKickTracker _startupKick;
+    StartupKickEnd _kickDeadlineEnd;
+    uint8_t _startupKickSpeed;
+    uint32_t _startupKickStarts;
+    uint32_t _startupKickPullIns;
+    float _startupTimeToLockSec[3];
     bool _waitingForPowerStage;
     
     // Amplitude Reduction
@@ -218,6 +429,13 @@ private:
     float _activeBrakeStopFreq;
     float _activeSoftStopCutoff;
     bool _activeBrakeMuteOnComplete;
+    // Tach braking estimates speed from edge-to-edge count windows and cuts drive at the predicted stop.
+    BrakeMetrics _brakeMetrics;
+    TachBrakeEstimator _brakeTach;
+    int32_t _brakeTachLastCount;
+    bool _brakeTachSettling;
+    uint32_t _brakeTachSettleStartMs;
+    int32_t _brakeTachSettleCount;
     
     // Relay Control
     bool _relaysActive;
@@ -235,6 +453,8 @@ private:
     bool _isSpeedRamping;
     float _rampStartFreq;
     float _rampTargetFreq;
+    float _rampCarryHz;           // Correction carried to the new speed, phased in over the ramp
+    SpeedMode _rampFromSpeedMode; // Speed whose tune the ramp is crossfading away from
     uint32_t _rampStartTime;
     float _rampDuration;
     
@@ -252,6 +472,7 @@ private:
     float _closedLoopCorrectionHz;
     float _closedLoopIntegralHz;
     float _closedLoopLastErrorRpm;
+    bool _closedLoopDerivativeRebase; // Next update skips the derivative after the error jumped with the target
     uint32_t _closedLoopLastUpdate;
     uint32_t _closedLoopTargetLastUpdate;
     uint32_t _closedLoopEngageTime;
@@ -265,9 +486,78 @@ private:
     uint32_t _closedLoopAmpOutOfLockStart;
     bool _closedLoopAmpRecoveryActive;
     bool _closedLoopAmpRecoveryLatched;
+    // Slip detection learns platter RPM per output Hz for each speed while locked, so normal belt creep is not reported as slip.
+    SlipRatio _closedLoopSlipRatio[3];
+    SlipWindow _closedLoopSlipWindow;
+    bool _closedLoopSlipLatched;
+    uint32_t _closedLoopSlipLastSampleSequence;
+    float _closedLoopSlipSumPercent;
+    // Coast-down bench: drive is cut through the normal stop path, then the free deceleration is fitted from tachometer counts.
+    bool _coastDownActive;
+    SpeedMode _coastDownSpeed;
+    uint32_t _coastDownStartMs;
+    uint32_t _coastDownLastSequence;
+    int32_t _coastDownWindowCount;
+    uint32_t _coastDownWindowMs;
+    CoastDownFit _coastDownFit;
+    CoastDownFitResult _coastDownResult;
+    char _coastDownMessage[96];
+    // Thermal model input is the mean square of applied drive over each integration step, not a single sample.
+    MotorThermalModel _thermalModel;
+    uint32_t _thermalLastMs;
+    uint32_t _thermalAccumMs;
+    float _thermalDriveSquaredMs;
+    bool _thermalDerating;
+    uint32_t _thermalDerateEvents;
+    // A bus dip inside the ride-through time holds closed-loop state rather than integrating a torque loss it cannot correct.
+    BusVoltageSupervisor _bus;
+    uint32_t _busLastSampleMs;
+    bool _busRideThrough;
+    uint32_t _busBrakeAborts;
+    // DC offset nulling holds the relays like the relay test, with the waveform enabled at neutral so each channel's idle offset reaches the sense.
+    DcOffsetCalibrator _dcOffset;
+    bool _dcOffsetActive;
+    int8_t _dcOffsetSelected;
+    uint32_t _dcOffsetLastSampleMs;
+    bool _dcOffsetLastSucceeded;
+    uint32_t _dcOffsetRuns;
+    // Health session: locked-running means for one speed, written to the history when the session ends.
+    bool _healthSessionActive;
+    uint8_t _healthSpeed;
+    uint32_t _healthLockedMs;
+    uint32_t _healthSamples;
+    float _healthCorrectionSum;
+    float _healthAmplitudeSum;
+    float _healthErrorSquaredSum;
+    float _healthTimeToLockSec;
+    // A coast-down is measured after drive is cut, so it is carried to the next record at its speed.
+    float _healthCoastSec[3];
+    HealthTrendResult _healthTrend[3];
+    uint8_t _healthReportedDrift[3];
+    uint32_t _healthLastSaveMs;
+    // Pitch moved the drive off the base during the session, so the session cannot teach the base.
+    bool _healthPitched;
+    uint8_t _baseLearnLastAction[3];
+    bool _baseLearnLastShared[3];
+    bool _baseLearnLastBounded[3];
+    uint32_t _baseLearnSteps;
+    uint32_t _baseLearnRollbacks;
     float _rampStartRpm;
     float _rampTargetRpm;
     ClosedLoopMetrics _closedLoopMetrics;
+    AdaptiveNotchBank _closedLoopNotch;
+    // Needle-drop feed-forward: the injected step is carried by the PID integral, so the hand-over to feedback is bumpless.
+    LoadStepDetector _loadStep;
+    bool _loadStepLoaded;
+    float _loadStepAppliedHz;
+    uint32_t _loadStepDrops;
+    uint32_t _loadStepLifts;
+    uint32_t _loadStepMeasurements;
+    uint32_t _loadStepLastEventMs;
+    float _loadStepLastMeasuredHz;
+    bool _loadStepLastSettled;
+    uint32_t _loadStepBoostStartMs;
+    float _loadStepBoost;
     float _closedLoopErrorSumRpm;
     float _closedLoopAbsErrorSumRpm;
     float _closedLoopCorrectionSumHz;
@@ -295,6 +585,21 @@ private:
     bool closedLoopControlAllowed() const;
     bool closedLoopSafetyAllowsCorrection(uint32_t now, const SpeedFeedbackStatus& feedback);
     void resetClosedLoopPidState();
+    void rebaseClosedLoopIntegral();
+    float closedLoopCarryHz(float fromOpenLoopHz, float toOpenLoopHz) const;
+    void configureClosedLoopNotch(const GlobalSettings& g);
+    float updateLoadStep(uint32_t now, const SpeedFeedbackStatus& feedback, float dt, const ClosedLoopSpeedTuning& tuning);
+    void resetLoadStepState();
+    void updateLoadStepBoost(uint32_t now);
+    void beginStartupKick(uint32_t now);
+    void endStartupKick(uint32_t now, StartupKickEnd reason);
+    void finishStartupKickRamp(uint32_t now);
+    void updateStartupKick(uint32_t now, bool sampleFeedback);
+    void beginHealthSession();
+    void finishHealthSession();
+    void recordHealthSample(const SpeedFeedbackStatus& feedback, uint32_t elapsedMs);
+    void refreshHealthTrend(uint8_t speed, bool reportNewDrift);
+    void learnBaseFrequency(uint8_t speed, float correctionHz, uint32_t lockedMs);
     void reportClosedLoopAction(const char* message, uint8_t action, bool& latch);
     void reportClosedLoopAction(const char* message, uint8_t action, bool& latch, const SpeedFeedbackStatus* feedback);
     void resetClosedLoopMetrics();
@@ -304,8 +609,26 @@ private:
     void recordClosedLoopTrend(const SpeedFeedbackStatus& feedback);
     uint8_t buildClosedLoopRecommendation(char* out, size_t outSize);
     void updateClosedLoopAmpRecovery(uint32_t now, const SpeedFeedbackStatus& feedback);
+    float nominalClosedLoopSlipRatio(SpeedMode speed) const;
+    void resetClosedLoopSlipState();
+    void updateClosedLoopSlip(uint32_t now, const SpeedFeedbackStatus& feedback);
+    void updateCoastDown(uint32_t now);
+    void finishCoastDown(const char* reason);
+    void finishBraking();
+    bool beginTachBraking(uint32_t now);
+    void handleTachBraking(uint32_t now);
+    void completeTachBraking(uint32_t now, BrakeStopResult result, int32_t count);
+    void updateTachBrakeSettle(uint32_t now);
+    void updateThermalModel(uint32_t now);
+    void updateBusVoltage(uint32_t now);
+    void updateDcOffsetNull(uint32_t now);
+    void finishDcOffsetNull(bool cancelled);
+    void applyDcOffsetNull();
+    void selectDcOffsetChannel(int8_t channel);
+    bool busGuardsRegen() const;
+    float thermalDerateFactor() const;
     float applyClosedLoopCorrection(uint32_t now, float openLoopFreq);
-    void scheduleClosedLoopEngage(uint32_t now);
+    void scheduleClosedLoopEngage(uint32_t now, float heldCorrectionHz = 0.0f);
     void resetClosedLoopControl(bool resetFeedback);
     float clampToCurrentSpeedRange(float freq) const;
     void setStandbyRelay(bool active);
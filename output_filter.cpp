@@ -0,0 +1,39 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "output_filter.h"
+
+uint32_t crossfadePhaseOffset(uint32_t fromAcc, uint32_t toAcc, float progress) {
+    if (!(progress > 0.0f)) return fromAcc;
+    if (progress >= 1.0f) return toAcc;
+    // Offsets move the short way round the circle, so a 350 to 10 degree trim passes through zero rather than 180.
+    int32_t delta = (int32_t)(toAcc - fromAcc);
+    return fromAcc + (uint32_t)(int32_t)((float)delta * progress);
+}
+
+float crossfadeLevel(float from, float to, float progress) {
+    if (!(progress > 0.0f)) return from;
+    if (progress >= 1.0f) return to;
+    return from + ((to - from) * progress);
+}
+
+OutputFilter::OutputFilter() {
+    reset();
+}
+
+void OutputFilter::reset() {
+    for (int i = 0; i < 2 * FIR_MAX_TAPS; i++) _history[i] = 0;
+    _index = 0;
+    _iir = 0.0f;
+    _iirFrom = 0.0f;
+}
+
+void OutputFilter::beginCrossfade(uint8_t fromType, float lastOutput) {
+    _iirFrom = _iir;
+    if (fromType != OUTPUT_FILTER_IIR) _iir = lastOutput;
+}
@@ -0,0 +1,100 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef OUTPUT_FILTER_H
+#define OUTPUT_FILTER_H
+
+#include <stdint.h>
+#include "fir_design.h"
+
+/*
+ * Per-channel output filter and the per-speed tune crossfade.
+ *
+ * Each channel runs one of three filters: none, a one-pole IIR, or a
+ * linear-phase FIR from fir_design. During a smooth speed change the tune of
+ * the outgoing speed is blended into the incoming one with the ramp's
+ * progress. Phase offsets move the short way round, levels linearly, and
+ * when the two speeds use different filters both run and their outputs are
+ * mixed. The outgoing filter carries on from the running state and an
+ * incoming IIR starts from the last output, so neither a filter reset nor an
+ * abrupt trim lands mid-ramp.
+ *
+ * No Arduino headers are used so a ramp can be replayed on a host and its
+ * torque compared with a tune that switches at once.
+ */
+enum OutputFilterType : uint8_t {
+    OUTPUT_FILTER_NONE = 0,  // Values match FilterType
+    OUTPUT_FILTER_IIR,
+    OUTPUT_FILTER_FIR
+};
+
+// Phase offset in accumulator units at progress 0-1 from fromAcc to toAcc, the short way round.
+uint32_t crossfadePhaseOffset(uint32_t fromAcc, uint32_t toAcc, float progress);
+// Level at progress 0-1 from one value to another.
+float crossfadeLevel(float from, float to, float progress);
+
+class OutputFilter {
+public:
+    OutputFilter();
+
+    void reset();
+    // Starts a crossfade: the outgoing filter keeps the running IIR state, and the incoming IIR starts from lastOutput
+    // unless the outgoing filter was already an IIR.
+    void beginCrossfade(uint8_t fromType, float lastOutput);
+
+    // Filters one sample with the incoming tune. A blend below 1 mixes the outgoing filter in by 1 - blend; both read
+    // the same FIR history, since it holds the unfiltered input. Inline because it runs for every sample in the
+    // RAM-resident buffer fill.
+    inline float process(float val, uint8_t type, float iirAlpha, const FirKernel& kernel,
+                         uint8_t fromType, float fromIirAlpha, const FirKernel& fromKernel, float blend) {
+        bool crossfading = blend < 1.0f;
+        if (type == OUTPUT_FILTER_FIR || (crossfading && fromType == OUTPUT_FILTER_FIR)) {
+            // Each sample is written twice so any kernel reads one contiguous window.
+            _index = (uint8_t)((_index - 1) & (FIR_MAX_TAPS - 1));
+            _history[_index] = (int16_t)val;
+            _history[_index + FIR_MAX_TAPS] = (int16_t)val;
+        }
+        if (type == OUTPUT_FILTER_NONE && !crossfading) return val;
+        float out = run(type, iirAlpha, kernel, val, _iir);
+        if (crossfading) {
+            float from = run(fromType, fromIirAlpha, fromKernel, val, _iirFrom);
+            out = from + ((out - from) * blend);
+        }
+        return out;
+    }
+
+private:
+    inline float run(uint8_t type, float iirAlpha, const FirKernel& kernel, float val, float& iirState) const {
+        if (type == OUTPUT_FILTER_IIR) {
+            // Lightweight one-pole smoothing for users who need gentler edges.
+            float out = iirAlpha * val + (1.0f - iirAlpha) * iirState;
+            iirState = out;
+            return out;
+        }
+        if (type == OUTPUT_FILTER_FIR && kernel.taps > 0) {
+            // Mirrored samples share a coefficient, so each pair is added before the one integer multiply.
+            const int16_t* x = &_history[_index];
+            uint8_t last = kernel.taps - 1;
+            uint8_t pairs = kernel.taps >> 1;
+            int32_t acc = 0;
+            for (uint8_t i = 0; i < pairs; i++) {
+                acc += (int32_t)kernel.half[i] * ((int32_t)x[i] + (int32_t)x[last - i]);
+            }
+            if (kernel.taps & 1) acc += (int32_t)kernel.half[pairs] * (int32_t)x[pairs];
+            return (float)acc * (1.0f / 32768.0f);
+        }
+        return val;
+    }
+
+    int16_t _history[2 * FIR_MAX_TAPS];  // Newest at _index
+    uint8_t _index;
+    float _iir;
+    float _iirFrom;  // IIR state of the outgoing filter during a crossfade
+};
+
+#endif // OUTPUT_FILTER_H
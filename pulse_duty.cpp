@@ -0,0 +1,112 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "pulse_duty.h"
+#include <math.h>
+#include <string.h>
+
+PulseDutyTracker::PulseDutyTracker() {
+    memset(&_params, 0, sizeof(_params));
+    _params.alpha = 0.05f;
+    reset();
+}
+
+void PulseDutyTracker::configure(const PulseDutyParams& params) {
+    _params = params;
+    if (_params.slots > PULSE_DUTY_MAX_SLOTS) _params.slots = 0;
+    if (!(_params.alpha > 0.0f) || _params.alpha > 1.0f) _params.alpha = 0.05f;
+    reset();
+}
+
+void PulseDutyTracker::reset() {
+    // A negative duty marks a slot with no sample yet.
+    for (uint8_t i = 0; i < PULSE_DUTY_MAX_SLOTS; i++) _slotDuty[i] = -1.0f;
+    _slot = 0;
+    _meanDuty = -1.0f;
+    _lastPeriodUs = 0;
+    _samples = 0;
+    _rejected = 0;
+    _baselineValid = false;
+    _baselineDuty = 0.0f;
+    _baselineSpread = 0.0f;
+}
+
+void PulseDutyTracker::addSample(uint32_t highUs, uint32_t periodUs, uint32_t expectedPeriodUs) {
+    uint32_t referenceUs = expectedPeriodUs != 0 ? expectedPeriodUs : _lastPeriodUs;
+    _lastPeriodUs = periodUs;
+    // The first period has nothing to be checked against.
+    if (referenceUs == 0) return;
+    // A turning platter's pulses stay close to the reference; outside half again either way the pulse train was broken.
+    bool periodJump = (uint64_t)periodUs * 2u > (uint64_t)referenceUs * 3u ||
+        (uint64_t)referenceUs * 2u > (uint64_t)periodUs * 3u;
+    if (highUs == 0 || highUs >= periodUs || periodJump) {
+        _rejected++;
+        return;
+    }
+    float duty = (float)highUs / (float)periodUs;
+    _meanDuty = _meanDuty < 0.0f ? duty : _meanDuty + (duty - _meanDuty) * _params.alpha;
+    if (_params.slots > 0) {
+        float& slotDuty = _slotDuty[_slot];
+        slotDuty = slotDuty < 0.0f ? duty : slotDuty + (duty - slotDuty) * _params.alpha;
+        _slot = (uint8_t)((_slot + 1) % _params.slots);
+    }
+    _samples++;
+
+    if (!_baselineValid && _samples >= _params.baselineSamples) {
+        float minDuty;
+        float maxDuty;
+        slotRange(minDuty, maxDuty);
+        _baselineDuty = _meanDuty;
+        _baselineSpread = maxDuty - minDuty;
+        _baselineValid = true;
+    }
+}
+
+void PulseDutyTracker::slotRange(float& minDuty, float& maxDuty) const {
+    minDuty = _meanDuty < 0.0f ? 0.0f : _meanDuty;
+    maxDuty = minDuty;
+    bool any = false;
+    for (uint8_t i = 0; i < _params.slots; i++) {
+        float duty = _slotDuty[i];
+        if (duty < 0.0f) continue;
+        if (!any || duty < minDuty) minDuty = duty;
+        if (!any || duty > maxDuty) maxDuty = duty;
+        any = true;
+    }
+}
+
+uint8_t PulseDutyTracker::getWarnings() const {
+    if (_meanDuty < 0.0f) return 0;
+    uint8_t warnings = 0;
+    float minDuty;
+    float maxDuty;
+    slotRange(minDuty, maxDuty);
+    if (minDuty < _params.marginLow || maxDuty > _params.marginHigh) warnings |= PULSE_DUTY_WARN_MARGINAL;
+    if (_baselineValid) {
+        if (fabsf(_meanDuty - _baselineDuty) > _params.driftLimit) warnings |= PULSE_DUTY_WARN_DRIFT;
+        if ((maxDuty - minDuty) - _baselineSpread > _params.driftLimit) warnings |= PULSE_DUTY_WARN_SPREAD;
+    }
+    return warnings;
+}
+
+PulseDutyStatus PulseDutyTracker::getStatus() const {
+    PulseDutyStatus status;
+    memset(&status, 0, sizeof(status));
+    status.samples = _samples;
+    status.rejected = _rejected;
+    status.slots = _params.slots;
+    status.baselineValid = _baselineValid;
+    status.meanDuty = _meanDuty < 0.0f ? 0.0f : _meanDuty;
+    status.baselineDuty = _baselineDuty;
+    status.drift = _baselineValid ? status.meanDuty - _baselineDuty : 0.0f;
+    slotRange(status.minSlotDuty, status.maxSlotDuty);
+    status.slotSpread = status.maxSlotDuty - status.minSlotDuty;
+    status.baselineSpread = _baselineSpread;
+    status.warnings = getWarnings();
+    return status;
+}
@@ -0,0 +1,103 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef PULSE_DUTY_H
+#define PULSE_DUTY_H
+
+#include <stdint.h>
+
+/*
+ * Duty cycle tracking for a pulse tachometer.
+ *
+ * Edge intervals stay healthy until a sensor is close to failing: a strobe
+ * ring gathering dust, a reflective sensor drifting out of alignment or a
+ * comparator threshold creeping towards one rail all shorten one half of
+ * each pulse first. The high time over the rising-to-rising period shows
+ * that long before an edge goes missing.
+ *
+ * Each sample is one high time and its period. The tracker keeps:
+ *
+ * - A filtered duty for every slot, counted round by rising edges. There is
+ *   no index pulse, so slot numbers are arbitrary and shift by one after a
+ *   missed edge; the spread between slots does not depend on that.
+ * - A filtered duty over all slots, and a baseline of it and of the slot
+ *   spread taken once the first samples have settled.
+ *
+ * A period far from the one expected at the target speed, or from the one
+ * before when no target is given, spans a stop, a missed edge or chatter,
+ * and its duty means nothing, so it is rejected.
+ *
+ * Warnings are raised when the mean drifts from its baseline, when the slot
+ * spread grows beyond its baseline, or when any slot comes close to always
+ * high or always low, where the next step is a lost edge.
+ *
+ * No Arduino headers are used so marginal and degrading signals can be simulated on a host.
+ */
+static const uint8_t PULSE_DUTY_MAX_SLOTS = 64;
+
+enum PulseDutyWarning : uint8_t {
+    PULSE_DUTY_WARN_DRIFT = 0x01,    // Mean duty has moved from its baseline
+    PULSE_DUTY_WARN_SPREAD = 0x02,   // One or more slots have moved apart from the rest
+    PULSE_DUTY_WARN_MARGINAL = 0x04  // A slot is close to 0% or 100% duty
+};
+
+struct PulseDutyParams {
+    uint8_t slots;            // Pulses per revolution, or 0 to track the mean only
+    float alpha;              // Filter weight of each new sample
+    uint32_t baselineSamples; // Samples before the baseline is taken
+    float driftLimit;         // Duty change, as a fraction, that raises a drift or spread warning
+    float marginLow;          // Slot duty below which the signal is marginal
+    float marginHigh;         // Slot duty above which the signal is marginal
+};
+
+struct PulseDutyStatus {
+    uint32_t samples;
+    uint32_t rejected;        // Samples with no high or low time, or a period far from the one before
+    uint8_t slots;
+    bool baselineValid;
+    float meanDuty;
+    float baselineDuty;
+    float drift;              // Mean duty minus its baseline
+    float minSlotDuty;
+    float maxSlotDuty;
+    float slotSpread;
+    float baselineSpread;
+    uint8_t warnings;         // PulseDutyWarning bits
+};
+
+class PulseDutyTracker {
+public:
+    PulseDutyTracker();
+
+    void configure(const PulseDutyParams& params);
+    // Forgets every slot and the baseline.
+    void reset();
+    // expectedPeriodUs is the pulse period at the target speed, or 0 to compare with the previous period instead.
+    void addSample(uint32_t highUs, uint32_t periodUs, uint32_t expectedPeriodUs = 0);
+
+    PulseDutyStatus getStatus() const;
+    uint8_t getWarnings() const;
+    // Filtered duty over all slots, or a negative value before the first sample.
+    float getMeanDuty() const { return _meanDuty; }
+
+private:
+    void slotRange(float& minDuty, float& maxDuty) const;
+
+    PulseDutyParams _params;
+    float _slotDuty[PULSE_DUTY_MAX_SLOTS];
+    uint8_t _slot;
+    float _meanDuty;
+    uint32_t _lastPeriodUs;
+    uint32_t _samples;
+    uint32_t _rejected;
+    bool _baselineValid;
+    float _baselineDuty;
+    float _baselineSpread;
+};
+
+#endif // PULSE_DUTY_H
@@ -0,0 +1,50 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "pwm_dither.h"
+
+PwmDither::PwmDither() {
+    _state = 0x2545F491u;
+    _periodBits = 10;
+    _spanCounts = 0;
+}
+
+void PwmDither::configure(const PwmDitherParams& params, uint32_t seed) {
+    _periodBits = params.periodBits;
+    if (_periodBits < 4) _periodBits = 4;
+    if (_periodBits > 15) _periodBits = 15;
+    // The band may not reach half the nominal period, so a dithered top always leaves room for the duty range.
+    uint16_t maxSpan = (uint16_t)((1u << _periodBits) / 4u);
+    _spanCounts = params.spanCounts > maxSpan ? maxSpan : params.spanCounts;
+    _state = seed != 0 ? seed : 0x2545F491u;
+}
+
+uint16_t PwmDither::nextWrap() {
+    if (_spanCounts == 0) return nominalWrap();
+    _state ^= _state << 13;
+    _state ^= _state >> 17;
+    _state ^= _state << 5;
+    // The modulo bias over a 32-bit draw is below one part in a million for any band this allows.
+    uint32_t choices = 2u * _spanCounts + 1u;
+    int32_t offset = (int32_t)(_state % choices) - (int32_t)_spanCounts;
+    return (uint16_t)((int32_t)nominalWrap() + offset);
+}
+
+uint32_t pwmDitherDutyScaleQ16(uint16_t wrap, uint8_t periodBits) {
+    return ((uint32_t)wrap + 1u) << (16 - periodBits);
+}
+
+uint64_t pwmDitherScaleStep(uint64_t step, uint16_t wrap, uint8_t periodBits, uint32_t& remainder) {
+    // step * (wrap + 1) >> periodBits in two 32-bit halves; the high half's product fits because a drive step is far below a cycle per sample.
+    uint64_t period = (uint64_t)wrap + 1u;
+    uint64_t high = (step >> 32) * period;
+    uint64_t low = (step & 0xFFFFFFFFull) * period;
+    uint64_t mask = ((uint64_t)1 << periodBits) - 1u;
+    remainder = (uint32_t)(low & mask);
+    return (high << (32 - periodBits)) + (low >> periodBits);
+}
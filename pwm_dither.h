@@ -0,0 +1,68 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef PWM_DITHER_H
+#define PWM_DITHER_H
+
+#include <stdint.h>
+
+/*
+ * Spread-spectrum PWM carrier.
+ *
+ * A fixed carrier puts its energy, and the magnetostrictive buzz of the motor
+ * and its wiring, into one tone and its harmonics. Here each DMA block runs
+ * at its own counter top, drawn pseudo-randomly from a band around the
+ * nominal, so over time the same energy is spread across the band.
+ *
+ * The synthesised sine must not notice. A duty written for the nominal period
+ * is rescaled to the same fraction of the block's period, and the DDS phase
+ * step, which is a share of a cycle per sample, is rescaled to the block's
+ * sample duration. The part of the scaled step below the accumulator LSB is
+ * returned so the caller can carry it, keeping absolute phase exact.
+ *
+ * The nominal period is a power of two counts, so rescaling needs only
+ * multiplies and shifts.
+ *
+ * No Arduino headers are used so the generator and the rescaling can be checked on a host.
+ */
+struct PwmDitherParams {
+    uint8_t periodBits;   // Nominal period is 1 << periodBits counts; the nominal top is one less
+    uint16_t spanCounts;  // Largest change of the top either side of the nominal; 0 disables dithering
+};
+
+class PwmDither {
+public:
+    PwmDither();
+    void configure(const PwmDitherParams& params, uint32_t seed);
+    // Counter top for the next block, uniformly distributed over the band.
+    uint16_t nextWrap();
+    uint16_t nominalWrap() const { return (uint16_t)((1u << _periodBits) - 1u); }
+    uint8_t periodBits() const { return _periodBits; }
+
+private:
+    uint32_t _state; // xorshift32; never zero
+    uint8_t _periodBits;
+    uint16_t _spanCounts;
+};
+
+// Q16 factor taking a duty on the nominal period to the same duty fraction of a period of wrap + 1 counts.
+uint32_t pwmDitherDutyScaleQ16(uint16_t wrap, uint8_t periodBits);
+
+// Duty in counts on the nominal period, rescaled with a factor from pwmDitherDutyScaleQ16 and rounded.
+static inline int32_t pwmDitherScaleDuty(int32_t duty, uint32_t scaleQ16) {
+    return (int32_t)(((int64_t)duty * (int64_t)scaleQ16 + 0x8000) >> 16);
+}
+
+/*
+ * Rescales a 32.32 phase step magnitude from the nominal period to a period
+ * of wrap + 1 counts. The remainder is what truncation dropped, in units of
+ * 2^-periodBits of the step's LSB.
+ */
+uint64_t pwmDitherScaleStep(uint64_t step, uint16_t wrap, uint8_t periodBits, uint32_t& remainder);
+
+#endif // PWM_DITHER_H
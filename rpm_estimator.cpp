@@ -0,0 +1,86 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "rpm_estimator.h"
+#include <math.h>
+#include <string.h>
+
+// Median absolute deviation to standard deviation for normally distributed readings.
+static const float MAD_TO_SIGMA = 1.4826f;
+
+RpmEstimator::RpmEstimator() {
+    memset(&_params, 0, sizeof(_params));
+    _params.window = 5;
+    _params.hampelK = 3.0f;
+    reset();
+}
+
+void RpmEstimator::configure(const RpmEstimatorParams& params) {
+    _params = params;
+    if (_params.window < 3) _params.window = 3;
+    if (_params.window > RPM_ESTIMATOR_MAX_WINDOW) _params.window = RPM_ESTIMATOR_MAX_WINDOW;
+    reset();
+}
+
+void RpmEstimator::reset() {
+    memset(_history, 0, sizeof(_history));
+    _count = 0;
+    _next = 0;
+    _lastRejected = false;
+}
+
+float RpmEstimator::median(float* values, uint8_t count) const {
+    // Insertion sort; the history is a handful of readings.
+    for (uint8_t i = 1; i < count; i++) {
+        float v = values[i];
+        int8_t j = (int8_t)i - 1;
+        while (j >= 0 && values[j] > v) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = v;
+    }
+    if (count & 1) return values[count / 2];
+    return 0.5f * (values[count / 2 - 1] + values[count / 2]);
+}
+
+float RpmEstimator::update(float rpm, float quantumRpm) {
+    _lastRejected = false;
+    if (_params.mode == RPM_ESTIMATOR_OFF || !isfinite(rpm)) return rpm;
+
+    _history[_next] = rpm;
+    _next = (uint8_t)((_next + 1) % _params.window);
+    if (_count < _params.window) _count++;
+    // Until the history holds three readings there is no majority to judge by.
+    if (_count < 3) return rpm;
+
+    float sorted[RPM_ESTIMATOR_MAX_WINDOW];
+    memcpy(sorted, _history, sizeof(float) * _count);
+    float centre = median(sorted, _count);
+
+    if (_params.mode == RPM_ESTIMATOR_MEDIAN) return centre;
+
+    if (_params.mode == RPM_ESTIMATOR_TRIMMED_MEAN) {
+        // sorted[] is in order after median().
+        float sum = 0.0f;
+        for (uint8_t i = 1; i + 1 < _count; i++) sum += sorted[i];
+        return sum / (float)(_count - 2);
+    }
+
+    float deviation[RPM_ESTIMATOR_MAX_WINDOW];
+    for (uint8_t i = 0; i < _count; i++) deviation[i] = fabsf(_history[i] - centre);
+    float spread = MAD_TO_SIGMA * median(deviation, _count);
+    float floorRpm = fabsf(centre) * _params.minSpreadFraction;
+    if (spread < floorRpm) spread = floorRpm;
+    if (spread < quantumRpm) spread = quantumRpm;
+    if (fabsf(rpm - centre) <= _params.hampelK * spread) return rpm;
+
+    // The outlier stays in the history: if the speed really moved, the median follows within half a window.
+    _lastRejected = true;
+    return centre;
+}
@@ -0,0 +1,84 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef RPM_ESTIMATOR_H
+#define RPM_ESTIMATOR_H
+
+#include <stdint.h>
+
+/*
+ * Outlier rejection for per-window RPM readings.
+ *
+ * Each feedback window turns a count delta into RPM. A missed or doubled
+ * edge makes one window read a whole count high or low, and on a coarse
+ * sensor that is several percent. Fed straight into the exponential filter,
+ * one such window drags the filtered speed far enough to draw a correction
+ * or trip a plausibility check, and a lower filter alpha that hides it slows
+ * every real response as well.
+ *
+ * This stage sits in front of the exponential filter and keeps the last few
+ * window readings:
+ *
+ * - Median: the median of the history. Rejects any single glitch, but every
+ *   reading is delayed by half the history.
+ * - Hampel: the newest reading passes unchanged unless it is further from
+ *   the history median than a multiple of the median absolute deviation, in
+ *   which case the median replaces it. Steady readings see no delay.
+ * - Trimmed mean: the mean of the history without its highest and lowest
+ *   readings.
+ *
+ * A quiet signal can have a median absolute deviation of zero, and would
+ * then reject a one-count step. The spread is floored at the spread the
+ * caller expects from count quantisation and at a small share of the median.
+ *
+ * Median and trimmed mean pick from whole-count readings, so on a count
+ * based sensor they settle on the nearest count rather than the average
+ * between counts. Hampel passes inliers untouched and keeps that average.
+ *
+ * No Arduino headers are used so variance, latency and glitch rejection can be benchmarked on a host.
+ */
+enum RpmEstimatorMode : uint8_t {
+    RPM_ESTIMATOR_OFF = 0,   // Readings pass unchanged
+    RPM_ESTIMATOR_MEDIAN,
+    RPM_ESTIMATOR_HAMPEL,
+    RPM_ESTIMATOR_TRIMMED_MEAN
+};
+
+static const uint8_t RPM_ESTIMATOR_MAX_WINDOW = 9;
+
+struct RpmEstimatorParams {
+    uint8_t mode;              // RpmEstimatorMode
+    uint8_t window;            // Readings kept, 3 to RPM_ESTIMATOR_MAX_WINDOW
+    float hampelK;             // Scaled deviations a reading may sit from the median before it is replaced
+    float minSpreadFraction;   // Share of the median below which the spread is never taken
+};
+
+class RpmEstimator {
+public:
+    RpmEstimator();
+
+    void configure(const RpmEstimatorParams& params);
+    // Forgets the history; the next reading passes unchanged.
+    void reset();
+    // Takes one window reading and returns the reading to filter. quantumRpm is the spread count quantisation alone causes, or 0 when readings are continuous.
+    float update(float rpm, float quantumRpm);
+
+    // True when the last reading was replaced as an outlier.
+    bool lastRejected() const { return _lastRejected; }
+
+private:
+    float median(float* values, uint8_t count) const;
+
+    RpmEstimatorParams _params;
+    float _history[RPM_ESTIMATOR_MAX_WINDOW];
+    uint8_t _count;
+    uint8_t _next;
+    bool _lastRejected;
+};
+
+#endif // RPM_ESTIMATOR_H
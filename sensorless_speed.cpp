@@ -0,0 +1,158 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "sensorless_speed.h"
+#include <math.h>
+
+static const float SENSORLESS_TWO_PI = 6.28318530718f;
+static const float SENSORLESS_PHASE_SCALE = 1.0f / 4294967296.0f;
+// Bias and amplitude follow the signal over about half a second, slow enough that one cycle of a 16 Hz drive barely moves them.
+static const float SENSORLESS_TRACK_SEC = 0.5f;
+// The per-sample drive frequency is exact apart from timestamp jitter, so it only needs light smoothing.
+static const float SENSORLESS_DRIVE_ALPHA = 0.05f;
+// Below this the drive is treated as off and crossings are checked against each other instead.
+static const float SENSORLESS_MIN_DRIVE_HZ = 1.0f;
+// Sensed phase averages over roughly four crossings so hunting stays visible.
+static const float SENSORLESS_PHASE_ALPHA = 0.25f;
+
+SensorlessSpeedEstimator::SensorlessSpeedEstimator() {
+    _params.sampleHz = 4000.0f;
+    _params.hysteresis = 0.2f;
+    _params.minAmplitude = 20.0f;
+    _params.windowCycles = 6;
+    _params.maxPeriodRatio = 1.6f;
+    reset();
+}
+
+void SensorlessSpeedEstimator::configure(const SensorlessSpeedParams& params) {
+    _params = params;
+    if (!(_params.sampleHz > 0.0f)) _params.sampleHz = 4000.0f;
+    if (_params.windowCycles < 1) _params.windowCycles = 1;
+    if (_params.windowCycles > MAX_WINDOW) _params.windowCycles = MAX_WINDOW;
+    if (!(_params.maxPeriodRatio > 1.0f)) _params.maxPeriodRatio = 1.6f;
+}
+
+void SensorlessSpeedEstimator::reset() {
+    _primed = false;
+    _bias = 0.0f;
+    _meanAbs = 0.0f;
+    _amplitude = 0.0f;
+    _previousValue = 0.0f;
+    _previousPhase = 0;
+    _previousUs = 0;
+    _driveHz = 0.0f;
+    _armed = false;
+    _haveCrossing = false;
+    _lastCrossSampleUs = 0;
+    _lastCrossOffsetUs = 0.0f;
+    for (uint8_t i = 0; i < MAX_WINDOW; i++) _intervals[i] = 0.0f;
+    _intervalNext = 0;
+    _intervalCount = 0;
+    _intervalSumUs = 0.0f;
+    _lastIntervalUs = 0.0f;
+    _electricalHz = 0.0f;
+    _phaseCos = 0.0f;
+    _phaseSin = 0.0f;
+    _crossings = 0;
+    _rejected = 0;
+}
+
+void SensorlessSpeedEstimator::addSample(float value, uint32_t drivePhase, uint32_t timeUs) {
+    if (!isfinite(value)) return;
+    if (!_primed) {
+        _bias = value;
+        _previousValue = 0.0f;
+        _previousPhase = drivePhase;
+        _previousUs = timeUs;
+        _primed = true;
+        return;
+    }
+    float dtUs = (float)(uint32_t)(timeUs - _previousUs);
+    if (!(dtUs > 0.0f)) return;
+
+    float alpha = 1.0f / (_params.sampleHz * SENSORLESS_TRACK_SEC);
+    if (alpha > 1.0f) alpha = 1.0f;
+    _bias += alpha * (value - _bias);
+    float x = value - _bias;
+    _meanAbs += alpha * (fabsf(x) - _meanAbs);
+    // The mean absolute value of a sine is 2/pi of its peak.
+    _amplitude = _meanAbs * (SENSORLESS_TWO_PI * 0.25f);
+
+    uint32_t phaseStep = drivePhase - _previousPhase;
+    float stepHz = ((float)phaseStep * SENSORLESS_PHASE_SCALE) / (dtUs * 1e-6f);
+    _driveHz += SENSORLESS_DRIVE_ALPHA * (stepHz - _driveHz);
+
+    if (_amplitude < _params.minAmplitude) {
+        _armed = false;
+    } else if (x < -_params.hysteresis * _amplitude) {
+        _armed = true;
+    } else if (_armed && x >= 0.0f && _previousValue < 0.0f) {
+        // Interpolate inside the sample pair; the drive phase is interpolated by the same fraction.
+        float fraction = -_previousValue / (x - _previousValue);
+        uint32_t crossPhase = _previousPhase + (uint32_t)(fraction * (float)phaseStep);
+        acceptCrossing(_previousUs, fraction * dtUs, crossPhase);
+        _armed = false;
+    }
+
+    _previousValue = x;
+    _previousPhase = drivePhase;
+    _previousUs = timeUs;
+}
+
+void SensorlessSpeedEstimator::acceptCrossing(uint32_t sampleUs, float offsetUs, uint32_t drivePhase) {
+    _crossings++;
+    if (_haveCrossing) {
+        float intervalUs = (float)(uint32_t)(sampleUs - _lastCrossSampleUs) + offsetUs - _lastCrossOffsetUs;
+        float referenceUs = 0.0f;
+        if (_driveHz > SENSORLESS_MIN_DRIVE_HZ) {
+            referenceUs = 1000000.0f / _driveHz;
+        } else if (_lastIntervalUs > 0.0f) {
+            referenceUs = _lastIntervalUs;
+        }
+        bool plausible = intervalUs > 0.0f &&
+            (referenceUs <= 0.0f ||
+             (intervalUs <= referenceUs * _params.maxPeriodRatio && intervalUs * _params.maxPeriodRatio >= referenceUs));
+        if (!plausible) {
+            // A missed or extra crossing corrupts every interval it touches, so the window starts again from this crossing.
+            _rejected++;
+            _intervalNext = 0;
+            _intervalCount = 0;
+            _intervalSumUs = 0.0f;
+            _lastIntervalUs = 0.0f;
+        } else {
+            _intervals[_intervalNext] = intervalUs;
+            _intervalNext = (uint8_t)((_intervalNext + 1) % _params.windowCycles);
+            if (_intervalCount < _params.windowCycles) _intervalCount++;
+            float sumUs = 0.0f;
+            for (uint8_t i = 0; i < _intervalCount; i++) sumUs += _intervals[i];
+            _intervalSumUs = sumUs;
+            _lastIntervalUs = intervalUs;
+            if (sumUs > 0.0f) _electricalHz = ((float)_intervalCount * 1000000.0f) / sumUs;
+        }
+    }
+
+    float angle = (float)drivePhase * SENSORLESS_PHASE_SCALE * SENSORLESS_TWO_PI;
+    _phaseCos += SENSORLESS_PHASE_ALPHA * (cosf(angle) - _phaseCos);
+    _phaseSin += SENSORLESS_PHASE_ALPHA * (sinf(angle) - _phaseSin);
+    _haveCrossing = true;
+    _lastCrossSampleUs = sampleUs;
+    _lastCrossOffsetUs = offsetUs;
+}
+
+bool SensorlessSpeedEstimator::isValid() const {
+    if (_intervalCount < _params.windowCycles || _lastIntervalUs <= 0.0f) return false;
+    if (_amplitude < _params.minAmplitude) return false;
+    // Three missing cycles in a row means the rotor has stopped or the signal is gone.
+    float ageUs = (float)(uint32_t)(_previousUs - _lastCrossSampleUs) - _lastCrossOffsetUs;
+    return ageUs < _lastIntervalUs * 3.0f;
+}
+
+float SensorlessSpeedEstimator::getPhaseDegrees() const {
+    if (_phaseCos == 0.0f && _phaseSin == 0.0f) return 0.0f;
+    return atan2f(_phaseSin, _phaseCos) * (360.0f / SENSORLESS_TWO_PI);
+}
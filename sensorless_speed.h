@@ -0,0 +1,94 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef SENSORLESS_SPEED_H
+#define SENSORLESS_SPEED_H
+
+#include <stdint.h>
+
+/*
+ * Rotor speed from a sensed motor waveform, for decks without a tachometer.
+ *
+ * The input is a back-EMF sense winding, an undriven terminal, or a phase
+ * current shunt, sampled on an ADC. Each sample carries the DDS master phase
+ * at the same instant. The estimator removes the ADC bias, tracks amplitude,
+ * and finds rising zero crossings with hysteresis, interpolating both the
+ * crossing time and the drive phase between samples.
+ *
+ * Crossing intervals give the rotor electrical frequency. The drive phase at
+ * each crossing is the angle between the sensed waveform and the drive. On a
+ * synchronous motor that angle is the load angle plus a fixed sense-network
+ * shift: it drifts steadily when the rotor slips and swings when it hunts.
+ *
+ * Intervals far from the drive period are rejected as noise or a missed
+ * crossing, and the window restarts. With the drive off, intervals are only
+ * checked against each other so a coasting rotor can still be followed.
+ *
+ * No Arduino headers are used so simulated motor waveforms can be replayed on a host.
+ */
+struct SensorlessSpeedParams {
+    float sampleHz;        // Nominal sample rate, used for the bias and amplitude trackers
+    float hysteresis;      // Share of tracked amplitude the signal must fall below before a rising crossing counts
+    float minAmplitude;    // Tracked peak, in input units, below which there is no usable signal
+    uint8_t windowCycles;  // Crossing intervals averaged into one frequency estimate, 1 to MAX_WINDOW
+    float maxPeriodRatio;  // Longest accepted interval as a multiple of the drive period; the shortest is its inverse
+};
+
+class SensorlessSpeedEstimator {
+public:
+    static const uint8_t MAX_WINDOW = 16;
+
+    SensorlessSpeedEstimator();
+
+    void configure(const SensorlessSpeedParams& params);
+    void reset();
+    // drivePhase is the DDS master accumulator, 2^32 per electrical cycle, at timeUs.
+    void addSample(float value, uint32_t drivePhase, uint32_t timeUs);
+
+    bool isValid() const;
+    float getElectricalHz() const { return _electricalHz; }
+    float getDriveHz() const { return _driveHz; }
+    float getSlipHz() const { return _driveHz - _electricalHz; }
+    float getPhaseDegrees() const;
+    float getAmplitude() const { return _amplitude; }
+    float getLastIntervalUs() const { return _lastIntervalUs; }
+    uint32_t getLastCrossingUs() const { return _lastCrossSampleUs + (uint32_t)_lastCrossOffsetUs; }
+    uint32_t getCrossings() const { return _crossings; }
+    uint32_t getRejectedCrossings() const { return _rejected; }
+
+private:
+    void acceptCrossing(uint32_t sampleUs, float offsetUs, uint32_t drivePhase);
+
+    SensorlessSpeedParams _params;
+    bool _primed;
+    float _bias;
+    float _meanAbs;
+    float _amplitude;
+    float _previousValue;
+    uint32_t _previousPhase;
+    uint32_t _previousUs;
+    float _driveHz;
+    bool _armed;
+
+    // Crossing times are kept as a whole-microsecond sample time plus a fractional offset so long run times do not erode float precision.
+    bool _haveCrossing;
+    uint32_t _lastCrossSampleUs;
+    float _lastCrossOffsetUs;
+    float _intervals[MAX_WINDOW];
+    uint8_t _intervalNext;
+    uint8_t _intervalCount;
+    float _intervalSumUs;
+    float _lastIntervalUs;
+    float _electricalHz;
+    float _phaseCos;
+    float _phaseSin;
+    uint32_t _crossings;
+    uint32_t _rejected;
+};
+
+#endif // SENSORLESS_SPEED_H
@@ -65,6 +65,8 @@ static const SerialSettingRule SERIAL_SETTING_RULES[] = {
     {"motor_topology", SERIAL_SETTING_INT, MOTOR_TOPOLOGY_CUSTOM, MOTOR_TOPOLOGY_THREE_PHASE},
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     {"active_braking", SERIAL_SETTING_BOOL, 0, 1},
+    {"deadtime_ns", SERIAL_SETTING_INT, 0, 2000},
+    {"deadtime_lag", SERIAL_SETTING_FLOAT, 0, 89},
 #endif
     {"phase_slew", SERIAL_SETTING_FLOAT, 0, 3600},
     {"gain_slew", SERIAL_SETTING_FLOAT, 0, 1000},
@@ -75,10 +77,18 @@ static const SerialSettingRule SERIAL_SETTING_RULES[] = {
     {"vf_mid_freq", SERIAL_SETTING_FLOAT, 0.0f, 100.0f},
     {"vf_mid_level", SERIAL_SETTING_INT, 0, 100},
     {"vf_base_freq", SERIAL_SETTING_FLOAT, MIN_OUTPUT_FREQUENCY_HZ, MAX_OUTPUT_FREQUENCY_HZ},
+    {"thermal_derate", SERIAL_SETTING_BOOL, 0, 1},
+    {"thermal_winding_tau", SERIAL_SETTING_FLOAT, 5.0f, 3600.0f},
+    {"thermal_frame_tau", SERIAL_SETTING_FLOAT, 5.0f, 36000.0f},
+    {"thermal_full_rise", SERIAL_SETTING_FLOAT, 5.0f, 200.0f},
+    {"thermal_winding_share", SERIAL_SETTING_INT, 0, 90},
+    {"thermal_derate_start", SERIAL_SETTING_FLOAT, 1.0f, 150.0f},
+    {"thermal_derate_limit", SERIAL_SETTING_FLOAT, 2.0f, 160.0f},
+    {"thermal_min_derate", SERIAL_SETTING_INT, 10, 100},
 #if CLOSED_LOOP_SPEED_ENABLE
     {"cl_enable", SERIAL_SETTING_BOOL, 0, 1},
     {"cl_control", SERIAL_SETTING_INT, CLOSED_LOOP_CONTROL_MONITOR, CLOSED_LOOP_CONTROL_CORRECT},
-    {"cl_mode", SERIAL_SETTING_INT, CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_QUADRATURE},
+    {"cl_mode", SERIAL_SETTING_INT, CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_LAST},
     {"cl_target_rpm", SERIAL_SETTING_FLOAT, 1.0f, 120.0f},
     {"cl_counts", SERIAL_SETTING_INT, 1, 20000},
     {"cl_edge", SERIAL_SETTING_INT, CLOSED_LOOP_EDGE_RISING, CLOSED_LOOP_EDGE_CHANGE},
@@ -118,6 +128,21 @@ static const SerialSettingRule SERIAL_SETTING_RULES[] = {
     {"cl_lock_action", SERIAL_SETTING_INT, CLOSED_LOOP_FAULT_IGNORE, CLOSED_LOOP_FAULT_STOP},
     {"cl_amp_recovery", SERIAL_SETTING_INT, CLOSED_LOOP_AMP_RECOVERY_OFF, CLOSED_LOOP_AMP_RECOVERY_RESTORE},
     {"cl_amp_recovery_ms", SERIAL_SETTING_INT, 0, 30000},
+    {"cl_slip_action", SERIAL_SETTING_INT, CLOSED_LOOP_SLIP_IGNORE, CLOSED_LOOP_SLIP_STOP},
+    {"cl_slip_ms", SERIAL_SETTING_INT, 50, 10000},
+    {"cl_slip_pct", SERIAL_SETTING_FLOAT, 0.5f, 50.0f},
+    {"cl_pullout_pct", SERIAL_SETTING_FLOAT, 0.0f, 100.0f},
+    {"cl_notch", SERIAL_SETTING_BOOL, 0, 1},
+    {"cl_notch_bw", SERIAL_SETTING_FLOAT, 0.05f, 2.0f},
+    {"cl_notch_min", SERIAL_SETTING_FLOAT, 0.05f, 20.0f},
+    {"cl_notch_max", SERIAL_SETTING_FLOAT, 0.15f, 25.0f},
+    {"load_step", SERIAL_SETTING_BOOL, 0, 1},
+    {"load_step_slope", SERIAL_SETTING_FLOAT, 0.01f, 10.0f},
+    {"load_step_boost", SERIAL_SETTING_INT, 0, 50},
+    {"load_step_boost_ms", SERIAL_SETTING_INT, 0, 10000},
+    {"adaptive_kick", SERIAL_SETTING_BOOL, 0, 1},
+    {"kick_pull_in", SERIAL_SETTING_INT, 70, 99},
+    {"base_learn", SERIAL_SETTING_BOOL, 0, 1},
 #endif
 #if AMP_MONITOR_ENABLE
     {"amp_warn", SERIAL_SETTING_FLOAT, AMP_TEMP_MIN_C, AMP_TEMP_MAX_C},
@@ -125,7 +150,7 @@ static const SerialSettingRule SERIAL_SETTING_RULES[] = {
 #endif
     {"smooth_switch", SERIAL_SETTING_BOOL, 0, 1},
     {"switch_ramp", SERIAL_SETTING_INT, 1, 5},
-    {"brake_mode", SERIAL_SETTING_INT, 0, 3},
+    {"brake_mode", SERIAL_SETTING_INT, BRAKE_OFF, BRAKE_TACH},
     {"brake_duration", SERIAL_SETTING_FLOAT, 0.0f, 10.0f},
     {"brake_pulse_gap", SERIAL_SETTING_FLOAT, 0.1f, 2.0f},
     {"brake_start_freq", SERIAL_SETTING_FLOAT, 10.0f, 200.0f},
@@ -152,6 +177,10 @@ static const SerialSettingRule SERIAL_SETTING_RULES[] = {
     {"kick", SERIAL_SETTING_INT, 1, 4},
     {"kick_dur", SERIAL_SETTING_INT, 0, 15},
     {"filter", SERIAL_SETTING_INT, 0, 2},
+    {"fir_profile", SERIAL_SETTING_INT, FIR_GENTLE, FIR_CUSTOM},
+    {"fir_cutoff", SERIAL_SETTING_FLOAT, 100.0f, 45000.0f},
+    {"fir_width", SERIAL_SETTING_FLOAT, 100.0f, 50000.0f},
+    {"fir_taps", SERIAL_SETTING_INT, FIR_MIN_TAPS, FIR_MAX_TAPS},
     {"reduced_amp", SERIAL_SETTING_INT, 10, 100},
     {"amp_delay", SERIAL_SETTING_INT, 0, 60},
     {"pitch", SERIAL_SETTING_FLOAT, -100.0f, 100.0f}
@@ -165,6 +194,7 @@ static const char* speedName(SpeedMode speed) {
 
 static const char* motorStateName() {
     if (motor.isRelayTestMode()) return "RELAY TEST";
+    if (motor.isDcOffsetNullActive()) return "OFFSET NULL";
     switch (motor.getState()) {
         case STATE_STANDBY: return "STANDBY";
         case STATE_STOPPED: return "STOPPED";
@@ -181,10 +211,22 @@ static const char* brakeModeName(uint8_t mode) {
         case BRAKE_PULSE: return "Pulse";
         case BRAKE_RAMP: return "Ramp";
         case BRAKE_SOFT_STOP: return "Soft Stop";
+        case BRAKE_TACH: return "Tach";
     }
     return "Invalid";
 }
 
+static const char* brakeResultName(uint8_t result) {
+    switch (result) {
+        case BRAKE_RESULT_STANDSTILL: return "standstill";
+        case BRAKE_RESULT_REVERSED: return "reversal";
+        case BRAKE_RESULT_TIMEOUT: return "timeout";
+        case BRAKE_RESULT_PREDICTED: return "predicted stop";
+        case BRAKE_RESULT_NO_PULSE: return "no pulse";
+    }
+    return "none";
+}
+
 static const char* filterName(uint8_t filter) {
     switch (filter) {
         case FILTER_NONE: return "None";
@@ -200,6 +242,7 @@ static const char* rampTypeName(uint8_t ramp) {
 
 #if CLOSED_LOOP_SPEED_ENABLE
 static const char* closedLoopSensorName(uint8_t mode) {
+    if (mode == CLOSED_LOOP_SENSOR_SENSORLESS) return "Sensorless";
     return mode == CLOSED_LOOP_SENSOR_QUADRATURE ? "Quadrature" : "Pulse";
 }
 
@@ -229,6 +272,13 @@ static const char* closedLoopAmpRecoveryName(uint8_t mode) {
     return "Off";
 }
 
+static const char* closedLoopSlipActionName(uint8_t action) {
+    if (action == CLOSED_LOOP_SLIP_STOP) return "Stop";
+    if (action == CLOSED_LOOP_SLIP_BOOST) return "Boost";
+    if (action == CLOSED_LOOP_SLIP_WARN) return "Warn";
+    return "Ignore";
+}
+
 static const char* closedLoopPitchTargetName(uint8_t mode) {
     return mode == CLOSED_LOOP_PITCH_TARGET_FIXED ? "Fixed" : "Follow pitch";
 }
@@ -244,6 +294,10 @@ static void printPresetList();
 static void printSettingsDump();
 static void handlePresetCommand(const String& input);
 static void handleRelayTestCommand(const String& input);
+#if DC_OFFSET_NULL_ENABLE
+static void handleOffsetCommand(const String& input);
+static void printDcOffsetStatus();
+#endif
 static void handleWifiCommand(const String& input);
 static void updateWifiSerialTasks();
 static void printSafetyDiagnostic();
@@ -252,7 +306,12 @@ static void printClosedLoopStatus();
 static void handleClosedLoopCommand(const String& input);
 static void printClosedLoopSetupStatus();
 static void printClosedLoopHealth();
+static void printLoadStepStatus();
+static void printStartupKickStatus();
+static void printWearStatus();
+static void printBaseLearnStatus();
 static void printClosedLoopTrend();
+static void printCoastDownStatus();
 #endif
 
 static int clampInt(int value, int minValue, int maxValue) {
@@ -1269,6 +1328,23 @@ void initCLI() {
             if (parseBoolValue(v, parsed)) settings.get().activeBrakingAllowed = parsed;
         }
     });
+
+    registry.push_back({ "deadtime_ns",
+        []() { return String(settings.get().bridgeDeadTimeNs); },
+        [](String v) {
+            settings.get().bridgeDeadTimeNs = (uint16_t)clampInt(v.toInt(), 0, 2000);
+            motor.applySettings();
+        }
+    });
+
+    // Lag is per speed because the current phase angle grows with drive frequency.
+    registry.push_back({ "deadtime_lag",
+        []() { return String(settings.get().bridgeDeadTimeLagDeg[(uint8_t)motor.getSpeed()], 1); },
+        [](String v) {
+            settings.get().bridgeDeadTimeLagDeg[(uint8_t)motor.getSpeed()] = clampFloat(v.toFloat(), 0.0f, 89.0f);
+            motor.applySettings();
+        }
+    });
 #endif
 
     registry.push_back({ "phase_slew",
@@ -1337,6 +1413,61 @@ void initCLI() {
         }
     });
 
+    registry.push_back({ "thermal_derate",
+        []() { return String(settings.get().thermalDerateEnabled); },
+        [](String v) {
+            bool parsed = false;
+            if (parseBoolValue(v, parsed)) settings.get().thermalDerateEnabled = parsed;
+        }
+    });
+
+    registry.push_back({ "thermal_winding_tau",
+        []() { return String(settings.get().thermalWindingTauSec); },
+        [](String v) {
+            settings.get().thermalWindingTauSec = clampFloat(v.toFloat(), 5.0f, 3600.0f);
+            settings.normalize();
+        }
+    });
+
+    registry.push_back({ "thermal_frame_tau",
+        []() { return String(settings.get().thermalFrameTauSec); },
+        [](String v) {
+            settings.get().thermalFrameTauSec = clampFloat(v.toFloat(), 5.0f, 36000.0f);
+            settings.normalize();
+        }
+    });
+
+    registry.push_back({ "thermal_full_rise",
+        []() { return String(settings.get().thermalFullScaleRiseC); },
+        [](String v) { settings.get().thermalFullScaleRiseC = clampFloat(v.toFloat(), 5.0f, 200.0f); }
+    });
+
+    registry.push_back({ "thermal_winding_share",
+        []() { return String(settings.get().thermalWindingShare); },
+        [](String v) { settings.get().thermalWindingShare = (uint8_t)clampInt(v.toInt(), 0, 90); }
+    });
+
+    registry.push_back({ "thermal_derate_start",
+        []() { return String(settings.get().thermalDerateStartC); },
+        [](String v) {
+            settings.get().thermalDerateStartC = clampFloat(v.toFloat(), 1.0f, 150.0f);
+            settings.normalize();
+        }
+    });
+
+    registry.push_back({ "thermal_derate_limit",
+        []() { return String(settings.get().thermalDerateLimitC); },
+        [](String v) {
+            settings.get().thermalDerateLimitC = clampFloat(v.toFloat(), 2.0f, 160.0f);
+            settings.normalize();
+        }
+    });
+
+    registry.push_back({ "thermal_min_derate",
+        []() { return String(settings.get().thermalMinDerate); },
+        [](String v) { settings.get().thermalMinDerate = (uint8_t)clampInt(v.toInt(), 10, 100); }
+    });
+
 #if CLOSED_LOOP_SPEED_ENABLE
     registry.push_back({ "cl_enable",
         []() { return String(settings.get().closedLoopEnabled); },
@@ -1360,7 +1491,7 @@ void initCLI() {
     registry.push_back({ "cl_mode",
         []() { return String(settings.get().closedLoopSensorMode); },
         [](String v) {
-            settings.get().closedLoopSensorMode = (uint8_t)clampInt(v.toInt(), CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_QUADRATURE);
+            settings.get().closedLoopSensorMode = (uint8_t)clampInt(v.toInt(), CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_LAST);
             motor.applySettings();
         }
     });
@@ -1629,6 +1760,84 @@ void initCLI() {
         []() { return String(settings.get().closedLoopAmpRecoveryDelayMs); },
         [](String v) { settings.get().closedLoopAmpRecoveryDelayMs = (uint16_t)clampInt(v.toInt(), 0, 30000); }
     });
+    registry.push_back({ "cl_slip_action",
+        []() { return String(settings.get().closedLoopSlipAction); },
+        [](String v) { settings.get().closedLoopSlipAction = (uint8_t)clampInt(v.toInt(), CLOSED_LOOP_SLIP_IGNORE, CLOSED_LOOP_SLIP_STOP); }
+    });
+    registry.push_back({ "cl_slip_ms",
+        []() { return String(settings.get().closedLoopSlipDetectMs); },
+        [](String v) { settings.get().closedLoopSlipDetectMs = (uint16_t)clampInt(v.toInt(), 50, 10000); }
+    });
+    registry.push_back({ "cl_slip_pct",
+        []() { return String(settings.get().closedLoopSlipThresholdPercent, 2); },
+        [](String v) { settings.get().closedLoopSlipThresholdPercent = clampFloat(v.toFloat(), 0.5f, 50.0f); }
+    });
+    registry.push_back({ "cl_pullout_pct",
+        []() { return String(settings.get().closedLoopPullOutThresholdPercent, 2); },
+        [](String v) { settings.get().closedLoopPullOutThresholdPercent = clampFloat(v.toFloat(), 0.0f, 100.0f); }
+    });
+    registry.push_back({ "cl_notch",
+        []() { return String(settings.get().closedLoopNotchEnabled); },
+        [](String v) {
+            bool parsed = false;
+            if (parseBoolValue(v, parsed)) settings.get().closedLoopNotchEnabled = parsed;
+        }
+    });
+    registry.push_back({ "cl_notch_bw",
+        []() { return String(settings.get().closedLoopNotchBandwidthHz, 2); },
+        [](String v) { settings.get().closedLoopNotchBandwidthHz = clampFloat(v.toFloat(), 0.05f, 2.0f); }
+    });
+    registry.push_back({ "cl_notch_min",
+        []() { return String(settings.get().closedLoopNotchMinHz, 2); },
+        [](String v) {
+            settings.get().closedLoopNotchMinHz = clampFloat(v.toFloat(), 0.05f, 20.0f);
+            settings.normalize();
+        }
+    });
+    registry.push_back({ "cl_notch_max",
+        []() { return String(settings.get().closedLoopNotchMaxHz, 2); },
+        [](String v) {
+            settings.get().closedLoopNotchMaxHz = clampFloat(v.toFloat(), 0.15f, 25.0f);
+            settings.normalize();
+        }
+    });
+    registry.push_back({ "load_step",
+        []() { return String(settings.get().loadStepEnabled); },
+        [](String v) {
+            bool parsed = false;
+            if (parseBoolValue(v, parsed)) settings.get().loadStepEnabled = parsed;
+        }
+    });
+    registry.push_back({ "load_step_slope",
+        []() { return String(settings.get().loadStepSlopeRpmPerSec, 3); },
+        [](String v) { settings.get().loadStepSlopeRpmPerSec = clampFloat(v.toFloat(), 0.01f, 10.0f); }
+    });
+    registry.push_back({ "load_step_boost",
+        []() { return String(settings.get().loadStepBoostPercent); },
+        [](String v) { settings.get().loadStepBoostPercent = (uint8_t)clampInt(v.toInt(), 0, 50); }
+    });
+    registry.push_back({ "load_step_boost_ms",
+        []() { return String(settings.get().loadStepBoostMs); },
+        [](String v) { settings.get().loadStepBoostMs = (uint16_t)clampInt(v.toInt(), 0, 10000); }
+    });
+    registry.push_back({ "adaptive_kick",
+        []() { return String(settings.get().adaptiveKickEnabled); },
+        [](String v) {
+            bool parsed = false;
+            if (parseBoolValue(v, parsed)) settings.get().adaptiveKickEnabled = parsed;
+        }
+    });
+    registry.push_back({ "kick_pull_in",
+        []() { return String(settings.get().kickPullInPercent); },
+        [](String v) { settings.get().kickPullInPercent = (uint8_t)clampInt(v.toInt(), 70, 99); }
+    });
+    registry.push_back({ "base_learn",
+        []() { return String(settings.get().baseLearnEnabled); },
+        [](String v) {
+            bool parsed = false;
+            if (parseBoolValue(v, parsed)) settings.get().baseLearnEnabled = parsed;
+        }
+    });
 #endif
 
 #if AMP_MONITOR_ENABLE
@@ -1667,7 +1876,7 @@ void initCLI() {
 
     registry.push_back({ "brake_mode",
         []() { return String(settings.get().brakeMode); },
-        [](String v) { settings.get().brakeMode = (uint8_t)clampInt(v.toInt(), 0, 3); }
+        [](String v) { settings.get().brakeMode = (uint8_t)clampInt(v.toInt(), BRAKE_OFF, BRAKE_TACH); }
     });
 
     registry.push_back({ "brake_duration",
@@ -1813,6 +2022,39 @@ void initCLI() {
         }
     });
 
+    registry.push_back({ "fir_profile",
+        []() { return String(settings.getCurrentSpeedSettings().firProfile); },
+        [](String v) {
+            settings.getCurrentSpeedSettings().firProfile = (uint8_t)clampInt(v.toInt(), FIR_GENTLE, FIR_CUSTOM);
+            motor.applySettings();
+        }
+    });
+
+    // Custom FIR design inputs; they take effect when this speed's FIR profile is Custom.
+    registry.push_back({ "fir_cutoff",
+        []() { return String(settings.get().firCutoffHz[settings.get().currentSpeed], 0); },
+        [](String v) {
+            settings.get().firCutoffHz[settings.get().currentSpeed] = clampFloat(v.toFloat(), 100.0f, 45000.0f);
+            motor.applySettings();
+        }
+    });
+
+    registry.push_back({ "fir_width",
+        []() { return String(settings.get().firTransitionHz[settings.get().currentSpeed], 0); },
+        [](String v) {
+            settings.get().firTransitionHz[settings.get().currentSpeed] = clampFloat(v.toFloat(), 100.0f, 50000.0f);
+            motor.applySettings();
+        }
+    });
+
+    registry.push_back({ "fir_taps",
+        []() { return String(settings.get().firTaps[settings.get().currentSpeed]); },
+        [](String v) {
+            settings.get().firTaps[settings.get().currentSpeed] = (uint8_t)clampInt(v.toInt(), FIR_MIN_TAPS, FIR_MAX_TAPS);
+            motor.applySettings();
+        }
+    });
+
     registry.push_back({ "reduced_amp",
         []() { return String(settings.getCurrentSpeedSettings().reducedAmplitude); },
         [](String v) { settings.getCurrentSpeedSettings().reducedAmplitude = (uint8_t)clampInt(v.toInt(), 10, 100); }
@@ -1905,6 +2147,8 @@ void handleSerialCommands() {
         if (input == "start") {
             if (motor.isRelayTestMode()) {
                 Serial.println("Exit relay test before starting.");
+            } else if (motor.isDcOffsetNullActive()) {
+                Serial.println("Offset nulling is running. Use 'offset cancel'.");
             } else if (motor.getState() == STATE_STOPPING) {
                 Serial.println("Start blocked until braking completes.");
             } else if (errorHandler.hasCriticalError()) {
@@ -2017,6 +2261,11 @@ void handleSerialCommands() {
         else if (input.startsWith("relay test")) {
             handleRelayTestCommand(input);
         }
+#if DC_OFFSET_NULL_ENABLE
+        else if (input == "offset" || input.startsWith("offset ")) {
+            handleOffsetCommand(input);
+        }
+#endif
         else if (input == "wifi" || input.startsWith("wifi ")) {
             handleWifiCommand(input);
         }
@@ -2053,6 +2302,10 @@ void handleSerialCommands() {
         else if (input == "diag safety") {
             printSafetyDiagnostic();
         }
+        else if (input == "thermal reset") {
+            motor.resetThermalModel();
+            Serial.println("Motor thermal estimate reset to ambient.");
+        }
         
         /*
          * --- Registry Commands ---
@@ -2198,6 +2451,35 @@ void printStatus() {
 
     Serial.print("Brake: ");
     Serial.println(brakeModeName(settings.get().brakeMode));
+    BrakeMetrics brake = motor.getBrakeMetrics();
+    if (brake.stops > 0 || brake.fallbacks > 0 || brake.active) {
+        Serial.print("Tach brake: ");
+        if (brake.active) {
+            Serial.print("braking, ");
+            Serial.print(brake.currentRpm, 2);
+            Serial.print(" RPM, ");
+        }
+        Serial.print("last ");
+        Serial.print(brake.lastStopMs / 1000.0f, 2);
+        Serial.print(" s from ");
+        Serial.print(brake.lastStartRpm, 2);
+        Serial.print(" RPM (");
+        Serial.print(brakeResultName(brake.lastResult));
+        Serial.print("), best ");
+        Serial.print(brake.bestStopMs / 1000.0f, 2);
+        Serial.print(" s, overshoot ");
+        Serial.print(brake.lastOvershootDeg, 1);
+        Serial.print(" deg");
+        if (brake.lastReversed) Serial.print(" reverse");
+        Serial.print(", peak ");
+        Serial.print(brake.peakOvershootRpm, 2);
+        Serial.print(" RPM, stops ");
+        Serial.print(brake.stops);
+        Serial.print(", timeouts ");
+        Serial.print(brake.timeouts);
+        Serial.print(", fallbacks ");
+        Serial.println(brake.fallbacks);
+    }
 
     Serial.print("Output: ");
     Serial.print(powerStage.backendName());
@@ -2227,11 +2509,46 @@ void printStatus() {
     Serial.print(waveform.getSampleRateHz(), 0);
     Serial.println(" Hz");
 #endif
+    uint32_t ddsNumerator = 0;
+    uint16_t ddsDenominator = 0;
+    Serial.print("DDS: 32.32 accumulator, block ");
+    Serial.print(waveform.getBlockLength());
+    Serial.print(" samples, ");
+    if (waveform.getRationalFrequency(ddsNumerator, ddsDenominator)) {
+        Serial.print("exact ");
+        Serial.print(ddsNumerator);
+        if (ddsDenominator > 1) {
+            Serial.print("/");
+            Serial.print(ddsDenominator);
+        }
+        Serial.println(" Hz");
+    } else {
+        Serial.println("rounded increment");
+    }
+#if PWM_DITHER_ENABLE
+    Serial.print("Carrier: spread +/-");
+    Serial.print(PWM_DITHER_PERCENT, 1);
+    Serial.print("%, now ");
+    Serial.print(waveform.getSampleRateHz() * 1024.0f / ((float)waveform.getCarrierWrap() + 1.0f), 0);
+    Serial.print(" Hz, late tops ");
+    Serial.println(waveform.getCarrierDitherLateCount());
+#endif
+    if (settings.getCurrentSpeedSettings().filterType == FILTER_FIR) {
+        const FirKernel& kernel = waveform.getFirKernel(settings.get().currentSpeed);
+        Serial.print("FIR: ");
+        Serial.print(kernel.taps);
+        Serial.print(" taps, ");
+        Serial.print(kernel.stopbandDb, 0);
+        Serial.print(" dB stopband, ");
+        Serial.print(kernel.transitionHz, 0);
+        Serial.println(" Hz transition");
+    }
     for (uint8_t channel = 0; channel < settings.get().phaseMode; channel++) {
         Serial.print("Channel "); Serial.print((char)('A' + channel));
         Serial.print(": phase "); Serial.print(waveform.getAppliedPhaseDegrees(channel), 1);
         Serial.print(" deg, gain "); Serial.print(waveform.getAppliedChannelGainPercent(channel), 1);
         Serial.print("%, headroom "); Serial.print(waveform.getModulationHeadroomPercent(channel), 1);
+        Serial.print("%, limiter -"); Serial.print(waveform.getLimiterReductionPercent(channel), 1);
         Serial.print("%, clips "); Serial.println(waveform.getClippingCount(channel));
     }
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
@@ -2248,9 +2565,89 @@ void printStatus() {
 
     Serial.print("Motor topology: ");
     Serial.println(settings.get().motorTopology);
+    MotorThermalStatus thermal = motor.getThermalStatus();
+    Serial.print("Motor thermal: rise ");
+    Serial.print(thermal.totalRiseC, 1);
+    Serial.print(" C (winding ");
+    Serial.print(thermal.windingRiseC, 1);
+    Serial.print(", frame ");
+    Serial.print(thermal.frameRiseC, 1);
+    Serial.print("), steady ");
+    Serial.print(thermal.steadyRiseC, 1);
+    Serial.print(" C, drive ");
+    Serial.print(thermal.driveLevel * 100.0f, 1);
+    Serial.print("%, derate ");
+    if (thermal.derateEnabled) {
+        Serial.print(thermal.derate * 100.0f, 1);
+        Serial.print("%");
+        if (thermal.derating) Serial.print(" ACTIVE");
+    } else {
+        Serial.print("off");
+    }
+    Serial.print(", events ");
+    Serial.println(thermal.derateEvents);
+#if BUS_VOLTAGE_SENSE_ENABLE
+    BusVoltageStatus bus = motor.getBusVoltageStatus();
+    static const char* const busStateNames[] = {"normal", "dip", "UNDERVOLTAGE", "OVER-VOLTAGE"};
+    Serial.print("DC bus: ");
+    Serial.print(bus.volts, 2);
+    Serial.print(" V ");
+    Serial.print(bus.state <= BUS_VOLTAGE_OVERVOLTAGE ? busStateNames[bus.state] : "?");
+    if (bus.state == BUS_VOLTAGE_DIP) {
+        Serial.print(" ");
+        Serial.print(bus.dipMs, 0);
+        Serial.print(" ms");
+    }
+    Serial.print(", feed-forward ");
+    Serial.print(bus.scale * 100.0f, 1);
+    Serial.print("%, range ");
+    Serial.print(bus.minVolts, 1);
+    Serial.print("-");
+    Serial.print(bus.maxVolts, 1);
+    Serial.println(" V");
+    Serial.print("DC bus events: ");
+    Serial.print(bus.dipsRiddenThrough);
+    Serial.print(" dips ridden through (longest ");
+    Serial.print(bus.longestDipMs, 0);
+    Serial.print(" ms), ");
+    Serial.print(bus.underVoltageEvents);
+    Serial.print(" undervoltage, ");
+    Serial.print(bus.overVoltageEvents);
+    Serial.print(" over-voltage, ");
+    Serial.print(bus.brakeAborts);
+    Serial.println(" braking aborts");
+#endif
+#if DC_OFFSET_NULL_ENABLE
+    printDcOffsetStatus();
+#endif
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     Serial.print("Regenerative braking: ");
-    Serial.println(settings.get().activeBrakingAllowed ? "bus energy path verified" : "inhibited");
+    if (settings.get().activeBrakingAllowed) {
+        Serial.println("bus energy path verified");
+    } else {
+        Serial.println(motor.getBusVoltageStatus().regenGuarded ? "supervised by bus sense" : "inhibited");
+    }
+    Serial.print("Dead-time compensation: ");
+    if (settings.get().bridgeDeadTimeNs > 0) {
+        Serial.print(settings.get().bridgeDeadTimeNs);
+        Serial.print(" ns (");
+        Serial.print(waveform.getDeadTimeCompensationCounts(), 2);
+        Serial.print(" counts), lag ");
+        Serial.print(settings.get().bridgeDeadTimeLagDeg[(uint8_t)motor.getSpeed()], 1);
+        Serial.println(" deg");
+    } else {
+        Serial.println("off");
+    }
+    const BridgeModulationParams& modulation = waveform.getBridgeModulation();
+    static const char* const modulationNames[] = {"sine", "centred", "bottom clamp"};
+    Serial.print("Bridge modulation: ");
+    Serial.print(modulationNames[modulation.mode <= BRIDGE_MODULATION_BOTTOM_CLAMP ? modulation.mode : 0]);
+    Serial.print(", min on ");
+    Serial.print(modulation.minOnCounts);
+    Serial.print(" / off ");
+    Serial.print(modulation.minOffCounts);
+    Serial.print(" counts, reduced samples ");
+    Serial.println(waveform.getBridgeLimitCount());
 #endif
 
     Serial.print("UI Lock: ");
@@ -2440,16 +2837,246 @@ static void printClosedLoopStatus() {
     Serial.print(", lock timeout ");
     Serial.print(metrics.lockTimeoutEvents);
     Serial.print(", amp recovery ");
-    Serial.println(metrics.ampRecoveryEvents);
+    Serial.print(metrics.ampRecoveryEvents);
+    Serial.print(", slip ");
+    Serial.print(metrics.slipEvents);
+    Serial.print(", pull-out ");
+    Serial.println(metrics.pullOutEvents);
     Serial.print("CL Tune: ");
     Serial.print(tuning.stepName);
     Serial.print(" - ");
     Serial.println(tuning.recommendation);
     Serial.print("CL Tune Apply: ");
     Serial.println(tuning.canApplyRecommendation ? "available" : "none");
+
+    ClosedLoopNotchStatus notch = motor.getClosedLoopNotchStatus();
+    Serial.print("CL Notch: ");
+    if (!notch.enabled) {
+        Serial.println("off");
+    } else {
+        for (uint8_t i = 0; i < notch.stages; i++) {
+            if (i > 0) Serial.print("; ");
+            Serial.print(notch.centreHz[i], 2);
+            Serial.print(" Hz, engaged ");
+            Serial.print((int)(notch.engagement[i] * 100.0f + 0.5f));
+            Serial.print("%, ratio ");
+            Serial.print(notch.powerRatio[i], 2);
+        }
+        Serial.println();
+    }
+#if SENSORLESS_SPEED_ENABLE
+    SensorlessSpeedStatus sensorless = speedFeedback.getSensorlessStatus();
+    Serial.print("CL Sensorless: ");
+    if (!sensorless.active) {
+        Serial.println("not selected");
+    } else {
+        Serial.print(sensorless.valid ? "VALID" : "NO SIGNAL");
+        Serial.print(", rotor ");
+        Serial.print(sensorless.electricalHz, 4);
+        Serial.print(" Hz, drive ");
+        Serial.print(sensorless.driveHz, 4);
+        Serial.print(" Hz, slip ");
+        Serial.print(sensorless.slipHz, 4);
+        Serial.print(" Hz, phase ");
+        Serial.print(sensorless.phaseDegrees, 1);
+        Serial.print(" deg, amplitude ");
+        Serial.print(sensorless.amplitude, 0);
+        Serial.print(", crossings ");
+        Serial.print(sensorless.crossings);
+        Serial.print(", rejected ");
+        Serial.print(sensorless.rejectedCrossings);
+        Serial.print(", overruns ");
+        Serial.println(sensorless.overruns);
+    }
+#endif
+    printLoadStepStatus();
+    printStartupKickStatus();
+    printWearStatus();
+    printBaseLearnStatus();
     printClosedLoopHealth();
 }
 
+static void printLoadStepStatus() {
+    LoadStepStatus loadStep = motor.getLoadStepStatus();
+    Serial.print("CL Load Step: ");
+    if (!loadStep.enabled) {
+        Serial.println("off");
+        return;
+    }
+    Serial.print(loadStep.measuring ? "measuring" : (loadStep.armed ? "armed" : "waiting for lock"));
+    Serial.print(loadStep.loaded ? ", stylus down" : ", stylus up");
+    Serial.print(", drops ");
+    Serial.print(loadStep.drops);
+    Serial.print(", lifts ");
+    Serial.print(loadStep.lifts);
+    Serial.print(", boost ");
+    Serial.print((int)((loadStep.boost - 1.0f) * 100.0f + 0.5f));
+    Serial.println("%");
+    Serial.print("CL Load Step Learned: ");
+    for (uint8_t i = 0; i < 3; i++) {
+        if (i > 0) Serial.print(", ");
+        Serial.print(i == 0 ? "33 " : (i == 1 ? "45 " : "78 "));
+        Serial.print(loadStep.learnedHz[i], 4);
+        Serial.print(" Hz");
+    }
+    Serial.print("; last ");
+    if (loadStep.measurements == 0) {
+        Serial.println("none");
+    } else {
+        Serial.print(loadStep.lastMeasuredHz, 4);
+        Serial.println(loadStep.lastSettled ? " Hz settled" : " Hz timed out");
+    }
+}
+
+static const char* startupKickEndName(uint8_t end) {
+    switch (end) {
+        case KICK_END_PULL_IN: return "pulled in";
+        case KICK_END_LEARNED: return "learned length";
+        case KICK_END_TIMEOUT: return "configured length";
+        default: return "no kick";
+    }
+}
+
+static void printStartupKickStatus() {
+    StartupKickStatus kick = motor.getStartupKickStatus();
+    Serial.print("CL Startup: adaptive kick ");
+    Serial.print(kick.enabled ? "on" : "off");
+    Serial.print(", starts ");
+    Serial.print(kick.starts);
+    Serial.print(", pull-ins ");
+    Serial.print(kick.pullIns);
+    if (kick.starts > 0) {
+        Serial.print("; last kick ");
+        Serial.print(kick.lastKickSec, 2);
+        Serial.print(" s, ");
+        Serial.print(startupKickEndName(kick.lastEnd));
+        if (kick.lastRampSec > 0.0f) {
+            Serial.print(", ramp ");
+            Serial.print(kick.lastRampSec, 2);
+            Serial.print(kick.lastRampSlipped ? " s slipped" : " s");
+        }
+        if (kick.tracking) Serial.print(", tracking");
+    }
+    Serial.println();
+    Serial.print("CL Startup Learned: ");
+    for (uint8_t i = 0; i < 3; i++) {
+        if (i > 0) Serial.print(", ");
+        Serial.print(i == 0 ? "33 kick " : (i == 1 ? "45 kick " : "78 kick "));
+        Serial.print(kick.learnedKickSec[i], 2);
+        Serial.print(" s ramp ");
+        Serial.print(kick.learnedRampSec[i], 2);
+        Serial.print(" s");
+    }
+    Serial.println();
+    Serial.print("CL Time to Lock: ");
+    for (uint8_t i = 0; i < 3; i++) {
+        if (i > 0) Serial.print(", ");
+        Serial.print(i == 0 ? "33 " : (i == 1 ? "45 " : "78 "));
+        if (kick.timeToLockSec[i] > 0.0f) {
+            Serial.print(kick.timeToLockSec[i], 2);
+            Serial.print(" s");
+        } else {
+            Serial.print("none");
+        }
+    }
+    Serial.println();
+}
+
+static void printWearTrend(const HealthMetricTrend& trend, const char* label, float scale, uint8_t places, const char* unit) {
+    Serial.print(label);
+    if (trend.samples < 3) {
+        Serial.print(" -");
+        return;
+    }
+    Serial.print(trend.change >= 0.0f ? " +" : " ");
+    Serial.print(trend.change * scale, places);
+    Serial.print(unit);
+    if (trend.worsening) Serial.print("*");
+}
+
+static void printWearStatus() {
+    MotorHealthStatus health = motor.getHealthStatus();
+    Serial.print("CL Wear: ");
+    Serial.print(health.records);
+    Serial.print(" of ");
+    Serial.print(HEALTH_HISTORY_RECORDS);
+    Serial.print(" sessions stored");
+    if (health.sessionActive) {
+        Serial.print("; this session ");
+        Serial.print((unsigned long)health.sessionLockedSec);
+        Serial.print(" s locked");
+    }
+    Serial.println();
+    for (uint8_t i = 0; i < 3; i++) {
+        const HealthTrendResult& trend = health.trend[i];
+        if (trend.sessions == 0) continue;
+        Serial.print(i == 0 ? "CL Wear 33: " : (i == 1 ? "CL Wear 45: " : "CL Wear 78: "));
+        Serial.print(trend.sessions);
+        Serial.print(" sessions over ");
+        Serial.print(trend.spanHours, 1);
+        Serial.print(" h;");
+        printWearTrend(trend.metric[HEALTH_CORRECTION], " correction", 1.0f, 3, " Hz");
+        printWearTrend(trend.metric[HEALTH_LOCK_AMPLITUDE], ", amplitude", 100.0f, 1, "%");
+        printWearTrend(trend.metric[HEALTH_TIME_TO_LOCK], ", lock", 1.0f, 2, " s");
+        printWearTrend(trend.metric[HEALTH_ERROR_RMS], ", error RMS", 1.0f, 4, " rpm");
+        printWearTrend(trend.metric[HEALTH_COAST], ", coast", 1.0f, 1, " s");
+        if (trend.drift == HEALTH_DRIFT_NONE) {
+            Serial.println(trend.sessions < HEALTH_TREND_MIN_SESSIONS ? "; too few sessions to judge" : "; no drift");
+        } else {
+            Serial.print("; drift:");
+            if (trend.drift & HEALTH_DRIFT_BELT) Serial.print(" belt stretch");
+            if (trend.drift & HEALTH_DRIFT_BEARING) Serial.print(" bearing wear");
+            if (trend.drift & HEALTH_DRIFT_STABILITY) Serial.print(" speed stability");
+            Serial.println();
+        }
+    }
+}
+
+static void printBaseLearnStatus() {
+    BaseLearnStatus learn = motor.getBaseLearnStatus();
+    Serial.print("CL Base Learn: ");
+    Serial.print(learn.enabled ? "on" : "off");
+    Serial.print(", ");
+    Serial.print(learn.steps);
+    Serial.print(" steps, ");
+    Serial.print(learn.rollbacks);
+    Serial.print(" rollbacks since boot");
+    if (learn.sharedHalfWidthPpm >= 0.0f) {
+        Serial.print("; shared ratio ");
+        Serial.print(learn.sharedRatioRpmPerHz, 5);
+        Serial.print(" rpm/Hz +/- ");
+        Serial.print(learn.sharedHalfWidthPpm, 0);
+        Serial.print(" ppm");
+    }
+    Serial.println();
+    static const char* const actionNames[] = { "none", "learning", "stepped", "rolled back" };
+    for (uint8_t i = 0; i < 3; i++) {
+        const BaseLearnSpeedStatus& speed = learn.speed[i];
+        if (!(speed.anchorHz > 0.0f)) continue;
+        Serial.print(i == 0 ? "CL Base Learn 33: " : (i == 1 ? "CL Base Learn 45: " : "CL Base Learn 78: "));
+        Serial.print("base ");
+        Serial.print(speed.baseHz, 3);
+        Serial.print(" Hz, set ");
+        Serial.print(speed.anchorHz, 3);
+        Serial.print(" Hz");
+        if (speed.halfWidthPpm >= 0.0f) {
+            Serial.print(", ratio ");
+            Serial.print(speed.ratioRpmPerHz, 5);
+            Serial.print(" +/- ");
+            Serial.print(speed.halfWidthPpm, 0);
+            Serial.print(" ppm over ");
+            Serial.print(speed.weight, 1);
+            Serial.print(" sessions");
+        }
+        Serial.print(", last ");
+        Serial.print(actionNames[speed.lastAction < 4 ? speed.lastAction : 0]);
+        if (speed.lastShared) Serial.print(" (shared)");
+        if (speed.lastBounded) Serial.print(" (limited)");
+        if (speed.onProbation) Serial.print(", on probation");
+        Serial.println();
+    }
+}
+
 static void printClosedLoopHealth() {
     SpeedFeedbackStatus feedback = speedFeedback.getStatus();
 
@@ -2461,7 +3088,52 @@ static void printClosedLoopHealth() {
     Serial.print(feedback.invalidTransitionPercent, 2);
     Serial.print("%, debounced ");
     Serial.print(feedback.debouncedTransitionPercent, 2);
-    Serial.println("%");
+    Serial.print("%, window ");
+    Serial.print(feedback.debounceUs);
+    Serial.print(" us, outlier windows ");
+    Serial.println(feedback.rejectedWindows);
+    if (feedback.dutyTracked) {
+        const PulseDutyStatus& duty = feedback.duty;
+        Serial.print("CL Duty: mean ");
+        Serial.print(duty.meanDuty * 100.0f, 1);
+        Serial.print("%, ");
+        if (duty.baselineValid) {
+            Serial.print("drift ");
+            Serial.print(duty.drift * 100.0f, 1);
+            Serial.print("%, ");
+        } else {
+            Serial.print("baseline pending, ");
+        }
+        Serial.print(duty.slots);
+        Serial.print(" slots ");
+        Serial.print(duty.minSlotDuty * 100.0f, 1);
+        Serial.print("-");
+        Serial.print(duty.maxSlotDuty * 100.0f, 1);
+        Serial.print("%, samples ");
+        Serial.print(duty.samples);
+        Serial.print(", rejected ");
+        Serial.print(duty.rejected);
+        Serial.print(", overruns ");
+        Serial.print(feedback.dutyOverruns);
+        if (duty.warnings == 0) {
+            Serial.println(", OK");
+        } else {
+            if (duty.warnings & PULSE_DUTY_WARN_DRIFT) Serial.print(", DRIFT");
+            if (duty.warnings & PULSE_DUTY_WARN_SPREAD) Serial.print(", SLOT SPREAD");
+            if (duty.warnings & PULSE_DUTY_WARN_MARGINAL) Serial.print(", MARGINAL");
+            Serial.println();
+        }
+    }
+    for (uint8_t i = 0; i < 3; i++) {
+        Serial.print("CL Edges ");
+        Serial.print(speedName((SpeedMode)i));
+        Serial.print(": accepted ");
+        Serial.print(feedback.speedEdges[i].accepted);
+        Serial.print(", debounced ");
+        Serial.print(feedback.speedEdges[i].debounced);
+        Serial.print(", invalid ");
+        Serial.println(feedback.speedEdges[i].invalid);
+    }
 
     Serial.print("CL Intervals: last ");
     Serial.print(feedback.lastIntervalUs);
@@ -2476,6 +3148,72 @@ static void printClosedLoopHealth() {
     Serial.print(" us (");
     Serial.print(feedback.averageJitterPercent, 2);
     Serial.println("%)");
+
+    ClosedLoopMetrics metrics = motor.getClosedLoopMetrics();
+    Serial.print("CL Slip: last ");
+    Serial.print(metrics.lastSlipPercent, 2);
+    Serial.print("%, avg ");
+    Serial.print(metrics.averageSlipPercent, 2);
+    Serial.print("%, peak ");
+    Serial.print(metrics.peakSlipPercent, 2);
+    Serial.print("%, ratio ");
+    Serial.print(metrics.slipRatioRpmPerHz, 5);
+    Serial.print(" RPM/Hz, slipping ");
+    Serial.println(motor.isClosedLoopSlipping() ? "YES" : "NO");
+    Serial.print("CL Slip Events: slip ");
+    Serial.print(metrics.slipEvents);
+    Serial.print(", pull-out ");
+    Serial.print(metrics.pullOutEvents);
+    Serial.print(", samples ");
+    Serial.println(metrics.slipSamples);
+}
+
+static void printCoastDownStatus() {
+    CoastDownStatus coast = motor.getCoastDownStatus();
+    Serial.print("Coast-down: ");
+    Serial.println(coast.message);
+    if (coast.active) {
+        Serial.print("Capturing ");
+        Serial.print(speedName((SpeedMode)coast.speed));
+        Serial.print(": ");
+        Serial.print(coast.elapsedMs / 1000.0f, 1);
+        Serial.print(" s, ");
+        Serial.print(coast.sampleCount);
+        Serial.print(" samples, ");
+        Serial.print(coast.startRpm, 2);
+        Serial.print(" -> ");
+        Serial.print(coast.lastRpm, 2);
+        Serial.println(" rpm");
+    }
+
+    // Stored models are what the seeds use; the time constant is the more intuitive form of the viscous term.
+    for (uint8_t i = 0; i < 3; i++) {
+        CoastDownFitResult model;
+        Serial.print(speedName((SpeedMode)i));
+        if (!motor.getCoastDownModel((SpeedMode)i, model)) {
+            Serial.println(": no model");
+            continue;
+        }
+        Serial.print(": tau ");
+        if (model.viscousPerSec > 0.0f) {
+            Serial.print(1.0f / model.viscousPerSec, 1);
+            Serial.print(" s");
+        } else {
+            Serial.print("none");
+        }
+        Serial.print(", Coulomb ");
+        Serial.print(model.coulombRpmPerSec, 3);
+        Serial.print(" rpm/s, R2 ");
+        Serial.print(model.rSquared, 3);
+        Serial.print(", coast ");
+        Serial.print(coastDownStopSeconds(model, model.startRpm), 1);
+        Serial.print(" s, estimated start ");
+        Serial.print(coastDownSpinUpSeconds(model, model.startRpm, COAST_DOWN_DRIVE_TORQUE_MARGIN), 1);
+        Serial.print(" s, brake ");
+        Serial.print(coastDownBrakeSeconds(model, model.startRpm, COAST_DOWN_BRAKE_TORQUE_MARGIN), 1);
+        Serial.println(" s");
+    }
+    Serial.println("Start and brake estimates assume drive and brake torque; only friction is measured.");
 }
 
 static void printClosedLoopTrend() {
@@ -2538,6 +3276,24 @@ static void printClosedLoopSetupStatus() {
     Serial.print(closedLoopDirectionName(setup.rawDirection));
     Serial.print(" / ");
     Serial.println(closedLoopDirectionName(setup.correctedDirection));
+    if (setup.autoDetect) {
+        Serial.print("Auto detect: ");
+        Serial.print(setup.autoMessage);
+        Serial.print(" (");
+        Serial.print(setup.autoProgressPercent);
+        Serial.println("%)");
+        Serial.print("Intervals: ");
+        Serial.println(setup.autoSamples);
+        Serial.print("Expected counts/rev: ");
+        Serial.println(setup.autoExpectedCountsPerRev, 2);
+        Serial.print("Detected counts/rev: ");
+        Serial.print(setup.autoDetectedCountsPerRev);
+        Serial.print(", correlation ");
+        Serial.print(setup.autoCorrelation, 2);
+        Serial.print(", confidence ");
+        Serial.print(setup.autoConfidence * 100.0f, 0);
+        Serial.println("%");
+    }
     Serial.print("Suggested counts/rev: ");
     Serial.println(setup.suggestedCountsPerRev);
     Serial.print("Suggested reverse: ");
@@ -2556,11 +3312,11 @@ static void handleClosedLoopCommand(const String& input) {
     if (args.empty() || args[0] == "help") {
         Serial.println("Closed-loop commands:");
         Serial.println("cl status - Show live feedback state");
-        Serial.println("cl health - Show sensor transition and jitter health");
+        Serial.println("cl health - Show sensor transition, jitter, and slip health");
         Serial.println("cl trend - Show recent RPM and correction trend samples");
         Serial.println("cl reset - Reset controller and feedback counters");
-        Serial.println("cl setup start - Capture one manual platter revolution");
-        Serial.println("cl setup status - Show captured count and direction");
+        Serial.println("cl setup start - Detect counts/rev while running, or capture one manual revolution when stopped");
+        Serial.println("cl setup status - Show captured count, direction, and detection confidence");
         Serial.println("cl setup apply - Apply suggested counts/rev and reverse direction");
         Serial.println("cl setup stop - Cancel setup capture");
         Serial.println("cl tune start - Start guided closed-loop tuning");
@@ -2570,6 +3326,13 @@ static void handleClosedLoopCommand(const String& input) {
         Serial.println("cl tune suggest - Show current tuning recommendation");
         Serial.println("cl tune stop - Stop guided tuning");
         Serial.println("cl calibrate preview|apply|save - Use stable average correction to tune base frequency");
+        Serial.println("cl coast start - Cut drive and fit the free coast-down at the current speed");
+        Serial.println("cl coast status|stop - Show stored models or cancel a capture");
+        Serial.println("cl coast apply|save - Estimate soft-start, kick, and brake times from the models");
+        Serial.println("cl loadstep status|clear|save - Show or forget the learned needle-drop feed-forward");
+        Serial.println("cl kick status|clear|save - Show or forget the learned startup kick and ramp lengths");
+        Serial.println("cl wear status|clear - Show belt and bearing trends, or forget the history after service");
+        Serial.println("cl learn status|rollback|clear|save - Show base learning, restore the bases you set, or forget the estimates");
         return;
     }
 
@@ -2622,6 +3385,105 @@ static void handleClosedLoopCommand(const String& input) {
         return;
     }
 
+    if (command == "coast") {
+        String coastCommand = args.size() >= 2 ? args[1] : "status";
+        coastCommand.toLowerCase();
+        char message[128];
+        if (coastCommand == "start") {
+            motor.beginCoastDown(message, sizeof(message));
+            Serial.println(message);
+        } else if (coastCommand == "stop" || coastCommand == "cancel") {
+            motor.cancelCoastDown();
+            Serial.println("Coast-down stopped.");
+        } else if (coastCommand == "apply" || coastCommand == "save") {
+            if (!motor.applyCoastDownSeeds(message, sizeof(message))) {
+                Serial.println(message);
+                return;
+            }
+            Serial.println(message);
+            if (coastCommand == "save") {
+                Serial.println(settings.save(true, true) ? "Coast-down models and seeds saved." : "Coast-down save failed.");
+            }
+        } else if (coastCommand == "status") {
+            printCoastDownStatus();
+        } else {
+            Serial.println("Usage: cl coast start|status|stop|apply|save");
+        }
+        return;
+    }
+
+    if (command == "loadstep") {
+        String loadStepCommand = args.size() >= 2 ? args[1] : "status";
+        loadStepCommand.toLowerCase();
+        if (loadStepCommand == "status") {
+            printLoadStepStatus();
+        } else if (loadStepCommand == "clear" || loadStepCommand == "save") {
+            if (loadStepCommand == "clear") {
+                motor.clearLoadStepLearning();
+                Serial.println("Learned load steps cleared.");
+            }
+            Serial.println(settings.save(true, true) ? "Load step learning saved." : "Load step save failed.");
+        } else {
+            Serial.println("Usage: cl loadstep status|clear|save");
+        }
+        return;
+    }
+
+    if (command == "kick") {
+        String kickCommand = args.size() >= 2 ? args[1] : "status";
+        kickCommand.toLowerCase();
+        if (kickCommand == "status") {
+            printStartupKickStatus();
+        } else if (kickCommand == "clear" || kickCommand == "save") {
+            if (kickCommand == "clear") {
+                motor.clearStartupKickLearning();
+                Serial.println("Learned startup kick cleared.");
+            }
+            Serial.println(settings.save(true, true) ? "Startup kick learning saved." : "Startup kick save failed.");
+        } else {
+            Serial.println("Usage: cl kick status|clear|save");
+        }
+        return;
+    }
+
+    if (command == "wear") {
+        String wearCommand = args.size() >= 2 ? args[1] : "status";
+        wearCommand.toLowerCase();
+        if (wearCommand == "status") {
+            printWearStatus();
+        } else if (wearCommand == "clear") {
+            Serial.println(motor.clearHealthHistory() ? "Health history cleared." : "Health history cleared in RAM only.");
+        } else {
+            Serial.println("Usage: cl wear status|clear");
+        }
+        return;
+    }
+
+    if (command == "learn") {
+        String learnCommand = args.size() >= 2 ? args[1] : "status";
+        learnCommand.toLowerCase();
+        if (learnCommand == "status") {
+            printBaseLearnStatus();
+        } else if (learnCommand == "rollback") {
+            char message[96];
+            if (!motor.rollbackBaseLearning(message, sizeof(message))) {
+                Serial.println(message);
+                return;
+            }
+            Serial.println(message);
+            Serial.println(settings.save(true, true) ? "Base frequencies saved." : "Base frequency save failed.");
+        } else if (learnCommand == "clear" || learnCommand == "save") {
+            if (learnCommand == "clear") {
+                motor.clearBaseLearning();
+                Serial.println("Base learning estimates cleared.");
+            }
+            Serial.println(settings.save(true, true) ? "Base learning saved." : "Base learning save failed.");
+        } else {
+            Serial.println("Usage: cl learn status|rollback|clear|save");
+        }
+        return;
+    }
+
     if (command == "tune") {
         String tuneCommand = args.size() >= 2 ? args[1] : "status";
         tuneCommand.toLowerCase();
@@ -2686,8 +3548,13 @@ static void handleClosedLoopCommand(const String& input) {
     setupCommand.toLowerCase();
 
     if (setupCommand == "start") {
-        speedFeedback.beginSetupCapture();
-        Serial.println("Closed-loop setup capture started. Rotate the platter exactly one revolution, then run 'cl setup status'.");
+        float expectedRpm = motor.getSynchronousPlatterRpm();
+        speedFeedback.beginSetupCapture(expectedRpm);
+        if (expectedRpm > 0.0f) {
+            Serial.println("Counts/rev detection started at the running speed. Hold speed steady, then run 'cl setup status'.");
+        } else {
+            Serial.println("Closed-loop setup capture started. Rotate the platter exactly one revolution, then run 'cl setup status'.");
+        }
     } else if (setupCommand == "status") {
         printClosedLoopSetupStatus();
     } else if (setupCommand == "apply") {
@@ -2733,10 +3600,33 @@ static void printSafetyDiagnostic() {
     printDiagCheck("motor topology is valid", g.motorTopology <= MOTOR_TOPOLOGY_THREE_PHASE, ok);
     printDiagCheck("power-stage fault input is clear", !powerStage.hasFault(), ok);
     printDiagCheck("maximum amplitude is within 0-100%", g.maxAmplitude <= 100, ok);
+#if BUS_VOLTAGE_SENSE_ENABLE
+    // A reading outside the limits at rest usually means a wrong divider ratio rather than a real supply fault.
+    printDiagCheck("DC bus reads inside its voltage limits",
+        motor.getBusVoltageStatus().state == BUS_VOLTAGE_NORMAL,
+        ok);
+#endif
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    // Larger dead time than this usually means the value was entered in the wrong unit.
+    printDiagCheck("dead-time compensation is under 5% of the PWM period",
+        (float)g.bridgeDeadTimeNs * 1e-9f * waveform.getSampleRateHz() <= 0.05f,
+        ok);
+#endif
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_LINEAR_PWM && ENABLE_MUTE_RELAYS
     printDiagCheck("relay power-on delay is within 0-10 seconds", g.powerOnRelayDelay <= 10, ok);
 #endif
-    printDiagCheck("brake mode is valid", g.brakeMode <= BRAKE_SOFT_STOP, ok);
+    printDiagCheck("brake mode is valid", g.brakeMode <= BRAKE_TACH, ok);
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (g.brakeMode == BRAKE_TACH) {
+        printDiagCheck("tach braking has closed-loop feedback to follow",
+            g.closedLoopEnabled && g.closedLoopCountsPerRev >= 1,
+            ok);
+    }
+#else
+    if (g.brakeMode == BRAKE_TACH) {
+        Serial.println("INFO: tach braking uses the timed ramp; closed loop is not compiled in");
+    }
+#endif
     printDiagCheck("brake duration is within 0-10 seconds", g.brakeDuration >= 0.0 && g.brakeDuration <= 10.0, ok);
     for (uint8_t speed = 0; speed < 3; speed++) {
         for (uint8_t channel = 0; channel < 4; channel++) {
@@ -2752,13 +3642,31 @@ static void printSafetyDiagnostic() {
         g.ampTempShutdownC <= AMP_TEMP_MAX_C &&
         g.ampTempShutdownC >= g.ampTempWarnC + AMP_TEMP_MIN_SHUTDOWN_MARGIN_C,
         ok);
+    printDiagCheck("motor thermal derate band is ordered",
+        g.thermalDerateStartC >= 1.0f &&
+        g.thermalDerateLimitC > g.thermalDerateStartC &&
+        g.thermalMinDerate >= 10 && g.thermalMinDerate <= 100,
+        ok);
+    printDiagCheck("motor thermal frame time constant is not shorter than winding",
+        g.thermalWindingTauSec >= 5.0f && g.thermalFrameTauSec >= g.thermalWindingTauSec,
+        ok);
 #if CLOSED_LOOP_SPEED_ENABLE
     printDiagCheck("closed-loop control mode is valid",
         g.closedLoopControlMode <= CLOSED_LOOP_CONTROL_CORRECT,
         ok);
     printDiagCheck("closed-loop sensor mode is valid",
-        g.closedLoopSensorMode <= CLOSED_LOOP_SENSOR_QUADRATURE,
+        g.closedLoopSensorMode <= CLOSED_LOOP_SENSOR_LAST,
         ok);
+#if SENSORLESS_SPEED_ENABLE
+    if (g.closedLoopSensorMode == CLOSED_LOOP_SENSOR_SENSORLESS) {
+        // Sensorless RPM is scaled from electrical hertz by each speed's stored target over its base frequency.
+        bool scaleOk = true;
+        for (uint8_t i = 0; i < 3; i++) {
+            if (!(g.speeds[i].frequency > 0.0f) || !(g.closedLoopTargetRpm[i] > 0.0f)) scaleOk = false;
+        }
+        printDiagCheck("sensorless RPM scale has target and base frequency for each speed", scaleOk, ok);
+    }
+#endif
     printDiagCheck("closed-loop counts per revolution is positive",
         g.closedLoopCountsPerRev >= 1,
         ok);
@@ -2799,6 +3707,18 @@ static void printSafetyDiagnostic() {
     printDiagCheck("closed-loop amplitude recovery mode is valid",
         g.closedLoopAmpRecoveryMode <= CLOSED_LOOP_AMP_RECOVERY_RESTORE,
         ok);
+    printDiagCheck("closed-loop slip action and thresholds are valid",
+        g.closedLoopSlipAction <= CLOSED_LOOP_SLIP_STOP &&
+        (g.closedLoopPullOutThresholdPercent == 0.0f ||
+         g.closedLoopPullOutThresholdPercent >= g.closedLoopSlipThresholdPercent),
+        ok);
+    printDiagCheck("closed-loop notch search band is ordered",
+        g.closedLoopNotchMaxHz > g.closedLoopNotchMinHz &&
+        g.closedLoopNotchBandwidthHz > 0.0f,
+        ok);
+    printDiagCheck("load step feed-forward has an integral to carry it",
+        !g.loadStepEnabled || (g.closedLoopTuning[0].ki > 0.0f || g.closedLoopTuning[1].ki > 0.0f || g.closedLoopTuning[2].ki > 0.0f),
+        ok);
 #endif
 
     for (uint8_t i = 0; i < 3; i++) {
@@ -2814,7 +3734,7 @@ static void printSafetyDiagnostic() {
             s.startupKick >= 1 &&
             s.startupKick <= 4 &&
             s.filterType <= FILTER_FIR &&
-            s.firProfile <= FIR_AGGRESSIVE;
+            s.firProfile <= FIR_CUSTOM;
         Serial.print("Speed ");
         Serial.print(i + 1);
         Serial.print(": ");
@@ -2893,13 +3813,18 @@ void printHelp() {
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_LINEAR_PWM && (ENABLE_STANDBY || ENABLE_MUTE_RELAYS)
     Serial.println("relay test <0-N|off>");
 #endif
+#if DC_OFFSET_NULL_ENABLE
+    Serial.println("offset null|status|cancel|clear - Amplifier DC offset nulling");
+#endif
 #if CLOSED_LOOP_SPEED_ENABLE
     Serial.println("cl status|reset|help");
     Serial.println("cl setup start|status|apply|stop");
     Serial.println("cl health|trend");
     Serial.println("cl tune start|next|apply|status|suggest|stop");
+    Serial.println("cl coast start|status|stop|apply|save");
 #endif
     Serial.println("diag safety - Dry-run safety diagnostic");
+    Serial.println("thermal reset - Restart the winding estimate from ambient");
     Serial.println("wifi help|status|wizard|scan|connect");
     Serial.println("error dump, error clear");
     Serial.println("f | factory reset - Request factory reset confirmation");
@@ -3310,6 +4235,10 @@ static void printSettingsDump() {
     Serial.print("Output Backend: "); Serial.println(powerStage.backendName());
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     Serial.print("Regenerative Braking: "); Serial.println(g.activeBrakingAllowed ? "Bus energy path verified" : "Inhibited");
+    Serial.print("Dead Time: "); Serial.print(g.bridgeDeadTimeNs); Serial.print(" ns, lag ");
+    Serial.print(g.bridgeDeadTimeLagDeg[SPEED_33], 1); Serial.print("/");
+    Serial.print(g.bridgeDeadTimeLagDeg[SPEED_45], 1); Serial.print("/");
+    Serial.print(g.bridgeDeadTimeLagDeg[SPEED_78], 1); Serial.println(" deg");
 #endif
     Serial.print("Phase Slew: "); Serial.print(g.phaseSlewDegreesPerSecond); Serial.println(" deg/s");
     Serial.print("Gain Slew: "); Serial.print(g.gainSlewPercentPerSecond); Serial.println(" %/s");
@@ -3325,6 +4254,15 @@ static void printSettingsDump() {
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_LINEAR_PWM && (ENABLE_STANDBY || ENABLE_MUTE_RELAYS)
     Serial.print("Relay Active High: "); Serial.println(g.relayActiveHigh ? "YES" : "NO");
 #endif
+    Serial.print("Motor Thermal: derate ");
+    Serial.print(g.thermalDerateEnabled ? "ON" : "OFF");
+    Serial.print(", tau "); Serial.print(g.thermalWindingTauSec, 0);
+    Serial.print("/"); Serial.print(g.thermalFrameTauSec, 0);
+    Serial.print("s, full-scale rise "); Serial.print(g.thermalFullScaleRiseC, 1);
+    Serial.print("C, winding share "); Serial.print(g.thermalWindingShare);
+    Serial.print("%, band "); Serial.print(g.thermalDerateStartC, 1);
+    Serial.print("-"); Serial.print(g.thermalDerateLimitC, 1);
+    Serial.print("C, floor "); Serial.print(g.thermalMinDerate); Serial.println("%");
     Serial.print("Boot Speed: "); Serial.println(g.bootSpeed);
     Serial.print("Runtime: "); Serial.print(settings.getTotalRuntime()); Serial.println("s");
 #if CLOSED_LOOP_SPEED_ENABLE
@@ -3390,6 +4328,38 @@ static void printSettingsDump() {
     Serial.print(" after ");
     Serial.print(g.closedLoopAmpRecoveryDelayMs);
     Serial.println("ms");
+    Serial.print("Closed Loop Slip: ");
+    Serial.print(closedLoopSlipActionName(g.closedLoopSlipAction));
+    Serial.print(" at ");
+    Serial.print(g.closedLoopSlipThresholdPercent);
+    Serial.print("%, pull-out ");
+    Serial.print(g.closedLoopPullOutThresholdPercent);
+    Serial.print("%, after ");
+    Serial.print(g.closedLoopSlipDetectMs);
+    Serial.println("ms");
+    Serial.print("Closed Loop Notch: ");
+    Serial.print(g.closedLoopNotchEnabled ? "on" : "off");
+    Serial.print(", ");
+    Serial.print(g.closedLoopNotchMinHz, 2);
+    Serial.print("-");
+    Serial.print(g.closedLoopNotchMaxHz, 2);
+    Serial.print(" Hz, width ");
+    Serial.print(g.closedLoopNotchBandwidthHz, 2);
+    Serial.println(" Hz");
+    Serial.print("Load Step Feed-forward: ");
+    Serial.print(g.loadStepEnabled ? "on" : "off");
+    Serial.print(", slope ");
+    Serial.print(g.loadStepSlopeRpmPerSec, 3);
+    Serial.print(" RPM/s, boost ");
+    Serial.print(g.loadStepBoostPercent);
+    Serial.print("% for ");
+    Serial.print(g.loadStepBoostMs);
+    Serial.println("ms");
+    Serial.print("Adaptive Startup Kick: ");
+    Serial.print(g.adaptiveKickEnabled ? "on" : "off");
+    Serial.print(", pull-in at ");
+    Serial.print(g.kickPullInPercent);
+    Serial.println("%");
 #endif
 
     for (int i = 0; i < 3; i++) {
@@ -3498,3 +4468,76 @@ static void handleRelayTestCommand(const String& input) {
     Serial.print("Relay test stage ");
     Serial.println(stage);
 }
+
+#if DC_OFFSET_NULL_ENABLE
+static void printDcOffsetStatus() {
+    DcOffsetStatus offset = motor.getDcOffsetStatus();
+    static const char* const outcomeNames[] = {"not run", "nulled", "NO RESPONSE", "OUT OF RANGE", "NOT CONVERGED", "cancelled"};
+    static const char* const stepNames[] = {"idle", "zero", "measure", "probe"};
+    Serial.print("Offset null: ");
+    if (offset.active) {
+        Serial.print(stepNames[offset.step <= DC_OFFSET_PROBE ? offset.step : 0]);
+        if (offset.selectedChannel >= 0) {
+            Serial.print(" ");
+            Serial.print((char)('A' + offset.selectedChannel));
+        }
+    } else {
+        Serial.print(offset.runs == 0 ? "idle" : (offset.lastSucceeded ? "last run nulled" : "last run incomplete"));
+    }
+    Serial.print(", correction");
+    for (uint8_t ch = 0; ch < MAX_ACTIVE_PHASE_OUTPUTS; ch++) {
+        Serial.print(" ");
+        Serial.print((char)('A' + ch));
+        Serial.print(" ");
+        Serial.print(offset.active ? offset.appliedCounts[ch] : offset.storedCounts[ch], 2);
+    }
+    Serial.println(" counts");
+    if (offset.runs == 0) return;
+    for (uint8_t ch = 0; ch < offset.channels; ch++) {
+        const DcOffsetChannel& result = offset.result[ch];
+        Serial.print("Offset null ");
+        Serial.print((char)('A' + ch));
+        Serial.print(": ");
+        Serial.print(outcomeNames[result.outcome <= DC_OFFSET_CANCELLED ? result.outcome : 0]);
+        if (result.gain != 0.0f) {
+            Serial.print(", residual ");
+            Serial.print(result.residualCounts, 3);
+            Serial.print(" counts, sense gain ");
+            Serial.print(result.gain, 3);
+            Serial.print(", ");
+            Serial.print(result.iterations);
+            Serial.print(" iterations");
+        }
+        Serial.println();
+    }
+}
+
+static void handleOffsetCommand(const String& input) {
+    String arg = input.length() > 6 ? input.substring(7) : String("");
+    arg.trim();
+
+    if (arg == "null") {
+        char message[96];
+        motor.beginDcOffsetNull(message, sizeof(message));
+        Serial.println(message);
+    } else if (arg == "cancel") {
+        if (!motor.isDcOffsetNullActive()) {
+            Serial.println("Offset nulling is not running.");
+            return;
+        }
+        motor.cancelDcOffsetNull();
+        Serial.println("Offset nulling cancelled; unfinished channels keep their earlier correction.");
+    } else if (arg == "clear") {
+        if (motor.isDcOffsetNullActive()) {
+            Serial.println("Cancel offset nulling first.");
+            return;
+        }
+        motor.clearDcOffsetNull();
+        Serial.println("Offset corrections cleared.");
+    } else if (arg == "" || arg == "status") {
+        printDcOffsetStatus();
+    } else {
+        Serial.println("Usage: offset null|status|cancel|clear");
+    }
+}
+#endif
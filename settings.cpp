@@ -7,8 +7,11 @@
  */
 
 #include "settings.h"
+#include "settings_migration.h"
 #include "error_handler.h"
 #include "globals.h"
+#include "fir_design.h"
+#include "dc_offset.h"
 #include <ArduinoJson.h>
 #include <math.h>
 
@@ -59,6 +62,22 @@ struct SettingsBootMarker {
 };
 static_assert(sizeof(SettingsBootMarker) == 12, "SettingsBootMarker storage layout changed.");
 
+/*
+ * Health history file: this header followed by recordCount HealthRecords,
+ * oldest first. The CRC covers the records only. A history written with a
+ * different HEALTH_HISTORY_RECORDS loads its newest records that still fit.
+ */
+struct HealthFileHeader {
+    uint32_t magic;
+    uint16_t formatVersion;
+    uint16_t headerSize;
+    uint16_t recordSize;
+    uint16_t recordCount;
+    uint32_t crc32;
+};
+static_assert(sizeof(HealthFileHeader) == 16, "HealthFileHeader storage layout changed.");
+static const uint16_t HEALTH_FILE_FORMAT_VERSION = 1;
+
 // Legacy layouts preserve exact field order and padding for schema migration. Do not edit these structs unless you are correcting an older schema definition.
 struct SpeedSettingsV9 {
     float frequency;
@@ -460,6 +479,14 @@ void applyMotorPreset(const GlobalSettings& source, GlobalSettings& target) {
     target.vfMidFreq = source.vfMidFreq;
     target.vfMidLevel = source.vfMidLevel;
     target.vfBaseFreq = source.vfBaseFreq;
+    target.thermalWindingTauSec = source.thermalWindingTauSec;
+    target.thermalFrameTauSec = source.thermalFrameTauSec;
+    target.thermalFullScaleRiseC = source.thermalFullScaleRiseC;
+    target.thermalDerateStartC = source.thermalDerateStartC;
+    target.thermalDerateLimitC = source.thermalDerateLimitC;
+    target.thermalDerateEnabled = source.thermalDerateEnabled;
+    target.thermalWindingShare = source.thermalWindingShare;
+    target.thermalMinDerate = source.thermalMinDerate;
 
     for (int i = 0; i < 3; i++) {
         target.speeds[i] = source.speeds[i];
@@ -508,6 +535,27 @@ void applyMotorPreset(const GlobalSettings& source, GlobalSettings& target) {
     target.closedLoopLockTimeoutAction = source.closedLoopLockTimeoutAction;
     target.closedLoopAmpRecoveryMode = source.closedLoopAmpRecoveryMode;
     target.closedLoopAmpRecoveryDelayMs = source.closedLoopAmpRecoveryDelayMs;
+    target.closedLoopSlipAction = source.closedLoopSlipAction;
+    target.closedLoopSlipDetectMs = source.closedLoopSlipDetectMs;
+    target.closedLoopSlipThresholdPercent = source.closedLoopSlipThresholdPercent;
+    target.closedLoopPullOutThresholdPercent = source.closedLoopPullOutThresholdPercent;
+    target.closedLoopNotchBandwidthHz = source.closedLoopNotchBandwidthHz;
+    target.closedLoopNotchMinHz = source.closedLoopNotchMinHz;
+    target.closedLoopNotchMaxHz = source.closedLoopNotchMaxHz;
+    target.closedLoopNotchEnabled = source.closedLoopNotchEnabled;
+    target.loadStepSlopeRpmPerSec = source.loadStepSlopeRpmPerSec;
+    target.loadStepBoostMs = source.loadStepBoostMs;
+    target.loadStepEnabled = source.loadStepEnabled;
+    target.loadStepBoostPercent = source.loadStepBoostPercent;
+    target.adaptiveKickEnabled = source.adaptiveKickEnabled;
+    target.kickPullInPercent = source.kickPullInPercent;
+    target.baseLearnEnabled = source.baseLearnEnabled;
+    // The lag belongs to the motor; the dead time itself belongs to the bridge board and stays with the controller.
+    memcpy(target.bridgeDeadTimeLagDeg, source.bridgeDeadTimeLagDeg, sizeof(target.bridgeDeadTimeLagDeg));
+    // Custom FIR inputs travel with the per-speed filter choice they belong to.
+    memcpy(target.firCutoffHz, source.firCutoffHz, sizeof(target.firCutoffHz));
+    memcpy(target.firTransitionHz, source.firTransitionHz, sizeof(target.firTransitionHz));
+    memcpy(target.firTaps, source.firTaps, sizeof(target.firTaps));
 }
 
 void copyFromV5(const GlobalSettingsV5& source, GlobalSettings& target) {
@@ -567,6 +615,7 @@ void copyFromV5(const GlobalSettingsV5& source, GlobalSettings& target) {
     setClosedLoopDefaults(target);
     setOutputArchitectureMigrationDefaults(target);
     setOutputTuningDefaults(target);
+    setSchema13Defaults(target);
 }
 
 void copyFromV6(const GlobalSettingsV6& source, GlobalSettings& target) {
@@ -652,6 +701,7 @@ void copyFromV6(const GlobalSettingsV6& source, GlobalSettings& target) {
     copyGlobalClosedLoopTuningToSpeeds(target);
     setOutputArchitectureMigrationDefaults(target);
     setOutputTuningDefaults(target);
+    setSchema13Defaults(target);
 }
 
 void copyFromV7(const GlobalSettingsV7& source, GlobalSettings& target) {
@@ -754,6 +804,7 @@ void copyFromV7(const GlobalSettingsV7& source, GlobalSettings& target) {
     copyGlobalClosedLoopTuningToSpeeds(target);
     setOutputArchitectureMigrationDefaults(target);
     setOutputTuningDefaults(target);
+    setSchema13Defaults(target);
 }
 
 void copyFromV8(const GlobalSettingsV8& source, GlobalSettings& target) {
@@ -776,6 +827,7 @@ void copyFromV10(const GlobalSettingsV10& source, GlobalSettings& target) {
     target.outputConfigReserved = 0;
     setOutputTuningDefaults(target);
     target.vfBaseFreq = DEFAULT_VF_BASE_FREQUENCY_HZ;
+    setSchema13Defaults(target);
 }
 
 void copyFromV11(const GlobalSettingsV11& source, GlobalSettings& target) {
@@ -784,11 +836,13 @@ void copyFromV11(const GlobalSettingsV11& source, GlobalSettings& target) {
     target.schemaVersion = SETTINGS_SCHEMA_VERSION;
     target.outputConfigReserved = 0;
     target.vfBaseFreq = DEFAULT_VF_BASE_FREQUENCY_HZ;
+    setSchema13Defaults(target);
 }
 
-uint32_t settingsCrc32(const uint8_t* data, size_t length) {
+uint32_t settingsCrc32(const uint8_t* data, size_t length, uint32_t previous = 0) {
     // Standard reflected CRC-32 used only for flash payload integrity. It is not a security primitive; it just rejects partial writes and corrupted blobs.
-    uint32_t crc = 0xFFFFFFFFUL;
+    // Passing the previous result continues the CRC, so a payload written in pieces can be checked as one.
+    uint32_t crc = ~previous;
     for (size_t i = 0; i < length; i++) {
         crc ^= data[i];
         for (uint8_t bit = 0; bit < 8; bit++) {
@@ -957,6 +1011,19 @@ bool readSettingsBlob(const char* path, uint32_t magic, GlobalSettings& target,
         return true;
     }
 
+    if (header.schemaVersion == 12 && header.payloadSize == sizeof(GlobalSettingsV12)) {
+        GlobalSettingsV12 legacy;
+        if (f.read((uint8_t*)&legacy, sizeof(legacy)) != sizeof(legacy)) {
+            f.close();
+            return false;
+        }
+        f.close();
+        if (settingsCrc32((const uint8_t*)&legacy, sizeof(legacy)) != header.crc32) return false;
+        copyFromV12(legacy, target);
+        if (migrated) *migrated = true;
+        return true;
+    }
+
     f.close();
     return false;
 }
@@ -972,13 +1039,32 @@ bool loadSettingsBlob(const char* path, uint32_t magic, GlobalSettings& target,
     return false;
 }
 
+// Rename the current file to .bak, then promote the temp file, so a reset at any point leaves a readable copy.
+bool promoteSidecarFile(const char* path, const char* tmpPath, const char* backupPath) {
+    LittleFS.remove(backupPath);
+    bool hadOriginal = LittleFS.exists(path);
+    if (hadOriginal && !LittleFS.rename(path, backupPath)) {
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+
+    if (!LittleFS.rename(tmpPath, path)) {
+        if (hadOriginal) LittleFS.rename(backupPath, path);
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+
+    if (hadOriginal) LittleFS.remove(backupPath);
+    return true;
+}
+
 bool writeSettingsBlob(const char* path, uint32_t magic, const GlobalSettings& source) {
     char tmpPath[40];
     char backupPath[40];
     if (!makeSidecarPath(path, ".tmp", tmpPath, sizeof(tmpPath))) return false;
     if (!makeSidecarPath(path, ".bak", backupPath, sizeof(backupPath))) return false;
 
-    // Write to a temp file first, then rename the current file to .bak, then promote the temp file. This avoids leaving no readable copy after reset.
+    // Write to a temp file first, then promote it. This avoids leaving no readable copy after reset.
     LittleFS.remove(tmpPath);
 
     File f = LittleFS.open(tmpPath, "w");
@@ -1001,21 +1087,7 @@ bool writeSettingsBlob(const char* path, uint32_t magic, const GlobalSettings& s
         return false;
     }
 
-    LittleFS.remove(backupPath);
-    bool hadOriginal = LittleFS.exists(path);
-    if (hadOriginal && !LittleFS.rename(path, backupPath)) {
-        LittleFS.remove(tmpPath);
-        return false;
-    }
-
-    if (!LittleFS.rename(tmpPath, path)) {
-        if (hadOriginal) LittleFS.rename(backupPath, path);
-        LittleFS.remove(tmpPath);
-        return false;
-    }
-
-    if (hadOriginal) LittleFS.remove(backupPath);
-    return true;
+    return promoteSidecarFile(path, tmpPath, backupPath);
 }
 
 uint8_t readBootMarkerState() {
@@ -1116,6 +1188,10 @@ Settings::Settings() {
     _lastRuntimeUpdate = 0;
     _rollbackApplied = false;
     _bootCandidateActive = false;
+    memset(_health, 0, sizeof(_health));
+    _healthHead = 0;
+    _healthCount = 0;
+    _healthDirty = false;
 }
 
 void Settings::begin() {
@@ -1152,6 +1228,7 @@ void Settings::begin() {
 
     handlePendingRollback();
     load(); // Normal operation
+    loadHealthHistory();
 
     _lastRuntimeUpdate = millis();
 }
@@ -1272,6 +1349,10 @@ bool Settings::factoryReset() {
     }
     // Format filesystem to clear all settings, presets, logs, and boot markers.
     if (!LittleFS.format()) return false;
+    memset(_health, 0, sizeof(_health));
+    _healthHead = 0;
+    _healthCount = 0;
+    _healthDirty = false;
     _rollbackApplied = false;
     _bootCandidateActive = false;
     return resetDefaults();
@@ -1334,6 +1415,23 @@ void Settings::validate() {
     _data.closedLoopPitchResetThresholdRpm = finiteOr(_data.closedLoopPitchResetThresholdRpm, 0.25f);
     _data.closedLoopPlausibilityMinRpm = finiteOr(_data.closedLoopPlausibilityMinRpm, 1.0f);
     _data.closedLoopPlausibilityMaxRpm = finiteOr(_data.closedLoopPlausibilityMaxRpm, 120.0f);
+    _data.closedLoopSlipThresholdPercent = finiteOr(_data.closedLoopSlipThresholdPercent, 3.0f);
+    _data.closedLoopPullOutThresholdPercent = finiteOr(_data.closedLoopPullOutThresholdPercent, 25.0f);
+    _data.thermalWindingTauSec = finiteOr(_data.thermalWindingTauSec, 60.0f);
+    _data.thermalFrameTauSec = finiteOr(_data.thermalFrameTauSec, 900.0f);
+    _data.thermalFullScaleRiseC = finiteOr(_data.thermalFullScaleRiseC, 60.0f);
+    _data.thermalDerateStartC = finiteOr(_data.thermalDerateStartC, 40.0f);
+    _data.thermalDerateLimitC = finiteOr(_data.thermalDerateLimitC, 55.0f);
+    _data.closedLoopNotchBandwidthHz = finiteOr(_data.closedLoopNotchBandwidthHz, 0.3f);
+    _data.closedLoopNotchMinHz = finiteOr(_data.closedLoopNotchMinHz, 0.3f);
+    _data.closedLoopNotchMaxHz = finiteOr(_data.closedLoopNotchMaxHz, 4.0f);
+    _data.loadStepSlopeRpmPerSec = finiteOr(_data.loadStepSlopeRpmPerSec, 0.06f);
+    for (uint8_t i = 0; i < 3; i++) _data.loadStepLearnedHz[i] = finiteOr(_data.loadStepLearnedHz[i], 0.0f);
+    for (uint8_t i = 0; i < 3; i++) _data.bridgeDeadTimeLagDeg[i] = finiteOr(_data.bridgeDeadTimeLagDeg[i], 0.0f);
+    for (uint8_t i = 0; i < 3; i++) {
+        _data.firCutoffHz[i] = finiteOr(_data.firCutoffHz[i], 5000.0f);
+        _data.firTransitionHz[i] = finiteOr(_data.firTransitionHz[i], 5000.0f);
+    }
 
     // Enforce global ranges before per-speed ranges so dependent calculations see sane values.
     if (_data.phaseMode < PHASE_1 || _data.phaseMode > MAX_PHASE_MODE) _data.phaseMode = DEFAULT_PHASE_MODE;
@@ -1350,7 +1448,7 @@ void Settings::validate() {
     if (_data.softStartCurve > 2) _data.softStartCurve = 0;
     if (_data.switchRampDuration < 1) _data.switchRampDuration = 1;
     if (_data.switchRampDuration > 5) _data.switchRampDuration = 5;
-    if (_data.brakeMode > BRAKE_SOFT_STOP) _data.brakeMode = BRAKE_OFF;
+    if (_data.brakeMode > BRAKE_TACH) _data.brakeMode = BRAKE_OFF;
     if (_data.brakeDuration < 0.0) _data.brakeDuration = 0.0;
     if (_data.brakeDuration > 10.0) _data.brakeDuration = 10.0;
     if (_data.brakePulseGap < 0.1) _data.brakePulseGap = 0.1;
@@ -1398,7 +1496,7 @@ void Settings::validate() {
     if (_data.closedLoopControlMode > CLOSED_LOOP_CONTROL_CORRECT) {
         _data.closedLoopControlMode = CLOSED_LOOP_CONTROL_CORRECT;
     }
-    if (_data.closedLoopSensorMode > CLOSED_LOOP_SENSOR_QUADRATURE) {
+    if (_data.closedLoopSensorMode > CLOSED_LOOP_SENSOR_LAST) {
         _data.closedLoopSensorMode = CLOSED_LOOP_SENSOR_PULSE;
     }
     for (uint8_t i = 0; i < 3; i++) {
@@ -1484,6 +1582,113 @@ void Settings::validate() {
         _data.closedLoopAmpRecoveryMode = CLOSED_LOOP_AMP_RECOVERY_OFF;
     }
     if (_data.closedLoopAmpRecoveryDelayMs > 30000) _data.closedLoopAmpRecoveryDelayMs = 30000;
+    if (_data.closedLoopSlipAction > CLOSED_LOOP_SLIP_STOP) {
+        _data.closedLoopSlipAction = CLOSED_LOOP_SLIP_WARN;
+    }
+    if (_data.closedLoopSlipDetectMs < 50) _data.closedLoopSlipDetectMs = 50;
+    if (_data.closedLoopSlipDetectMs > 10000) _data.closedLoopSlipDetectMs = 10000;
+    if (_data.closedLoopSlipThresholdPercent < 0.5f) _data.closedLoopSlipThresholdPercent = 0.5f;
+    if (_data.closedLoopSlipThresholdPercent > 50.0f) _data.closedLoopSlipThresholdPercent = 50.0f;
+    if (_data.closedLoopPullOutThresholdPercent < 0.0f) _data.closedLoopPullOutThresholdPercent = 0.0f;
+    if (_data.closedLoopPullOutThresholdPercent > 100.0f) _data.closedLoopPullOutThresholdPercent = 100.0f;
+    if (_data.closedLoopPullOutThresholdPercent > 0.0f &&
+        _data.closedLoopPullOutThresholdPercent < _data.closedLoopSlipThresholdPercent) {
+        _data.closedLoopPullOutThresholdPercent = _data.closedLoopSlipThresholdPercent;
+    }
+
+    // The frame node must stay slower than the winding node, and derating needs a non-empty band to shape its curve across.
+    if (_data.thermalWindingTauSec < 5.0f) _data.thermalWindingTauSec = 5.0f;
+    if (_data.thermalWindingTauSec > 3600.0f) _data.thermalWindingTauSec = 3600.0f;
+    if (_data.thermalFrameTauSec < _data.thermalWindingTauSec) _data.thermalFrameTauSec = _data.thermalWindingTauSec;
+    if (_data.thermalFrameTauSec > 36000.0f) _data.thermalFrameTauSec = 36000.0f;
+    if (_data.thermalFullScaleRiseC < 5.0f) _data.thermalFullScaleRiseC = 5.0f;
+    if (_data.thermalFullScaleRiseC > 200.0f) _data.thermalFullScaleRiseC = 200.0f;
+    if (_data.thermalDerateStartC < 1.0f) _data.thermalDerateStartC = 1.0f;
+    if (_data.thermalDerateStartC > 150.0f) _data.thermalDerateStartC = 150.0f;
+    if (_data.thermalDerateLimitC < _data.thermalDerateStartC + 1.0f) _data.thermalDerateLimitC = _data.thermalDerateStartC + 1.0f;
+    if (_data.thermalDerateLimitC > 160.0f) _data.thermalDerateLimitC = 160.0f;
+    if (_data.thermalWindingShare > 90) _data.thermalWindingShare = 90;
+    if (_data.thermalMinDerate < 10) _data.thermalMinDerate = 10;
+    if (_data.thermalMinDerate > 100) _data.thermalMinDerate = 100;
+    _data.thermalReserved = 0;
+
+    // The search band needs some width; the notch itself further limits it to below the loop's Nyquist rate.
+    if (_data.closedLoopNotchBandwidthHz < 0.05f) _data.closedLoopNotchBandwidthHz = 0.05f;
+    if (_data.closedLoopNotchBandwidthHz > 2.0f) _data.closedLoopNotchBandwidthHz = 2.0f;
+    if (_data.closedLoopNotchMinHz < 0.05f) _data.closedLoopNotchMinHz = 0.05f;
+    if (_data.closedLoopNotchMinHz > 20.0f) _data.closedLoopNotchMinHz = 20.0f;
+    if (_data.closedLoopNotchMaxHz < _data.closedLoopNotchMinHz + 0.1f) _data.closedLoopNotchMaxHz = _data.closedLoopNotchMinHz + 0.1f;
+    if (_data.closedLoopNotchMaxHz > 25.0f) _data.closedLoopNotchMaxHz = 25.0f;
+    memset(_data.closedLoopNotchReserved, 0, sizeof(_data.closedLoopNotchReserved));
+
+    // A learned step can only add drive after a drop; anything negative or implausibly large is discarded rather than replayed.
+    if (_data.loadStepSlopeRpmPerSec < 0.01f) _data.loadStepSlopeRpmPerSec = 0.01f;
+    if (_data.loadStepSlopeRpmPerSec > 10.0f) _data.loadStepSlopeRpmPerSec = 10.0f;
+    for (uint8_t i = 0; i < 3; i++) {
+        if (_data.loadStepLearnedHz[i] < 0.0f || _data.loadStepLearnedHz[i] > 20.0f) _data.loadStepLearnedHz[i] = 0.0f;
+    }
+    if (_data.loadStepBoostMs > 10000) _data.loadStepBoostMs = 10000;
+    if (_data.loadStepBoostPercent > 50) _data.loadStepBoostPercent = 50;
+
+    // An inductive winding can only delay current, and never by a quarter cycle or more.
+    for (uint8_t i = 0; i < 3; i++) {
+        if (_data.bridgeDeadTimeLagDeg[i] < 0.0f) _data.bridgeDeadTimeLagDeg[i] = 0.0f;
+        if (_data.bridgeDeadTimeLagDeg[i] > 89.0f) _data.bridgeDeadTimeLagDeg[i] = 89.0f;
+    }
+    if (_data.bridgeDeadTimeNs > 2000) _data.bridgeDeadTimeNs = 2000;
+    memset(_data.bridgeDeadTimeReserved, 0, sizeof(_data.bridgeDeadTimeReserved));
+
+    // The designer also limits both edges against the sample rate; these bounds only keep stored values meaningful at any carrier.
+    for (uint8_t i = 0; i < 3; i++) {
+        if (_data.firCutoffHz[i] < 100.0f) _data.firCutoffHz[i] = 100.0f;
+        if (_data.firCutoffHz[i] > 45000.0f) _data.firCutoffHz[i] = 45000.0f;
+        if (_data.firTransitionHz[i] < 100.0f) _data.firTransitionHz[i] = 100.0f;
+        if (_data.firTransitionHz[i] > 50000.0f) _data.firTransitionHz[i] = 50000.0f;
+        if (_data.firTaps[i] < FIR_MIN_TAPS) _data.firTaps[i] = FIR_MIN_TAPS;
+        if (_data.firTaps[i] > FIR_MAX_TAPS) _data.firTaps[i] = FIR_MAX_TAPS;
+    }
+    _data.firDesignReserved = 0;
+
+    // Learned kick and ramp lengths can never exceed the longest kick and ramp the speed settings allow.
+    for (uint8_t i = 0; i < 3; i++) {
+        if (_data.kickLearnedMs[i] > 15000) _data.kickLearnedMs[i] = 0;
+        if (_data.kickRampLearnedMs[i] > 15000) _data.kickRampLearnedMs[i] = 0;
+    }
+    if (_data.kickPullInPercent < 70) _data.kickPullInPercent = 70;
+    if (_data.kickPullInPercent > 99) _data.kickPullInPercent = 99;
+    memset(_data.kickReserved, 0, sizeof(_data.kickReserved));
+
+    // Learner state that is not finite or not positive cannot anchor anything, so that speed starts learning afresh.
+    for (uint8_t i = 0; i < 3; i++) {
+        BaseLearnSpeedModel& m = _data.baseLearn[i];
+        bool plausible = isfinite(m.ratioRpmPerHz) && m.ratioRpmPerHz >= 0.0f &&
+            isfinite(m.ratioSpread) && m.ratioSpread >= 0.0f &&
+            isfinite(m.weight) && m.weight >= 0.0f &&
+            isfinite(m.anchorHz) && m.anchorHz >= 0.0f &&
+            isfinite(m.lastHz) && m.lastHz >= 0.0f &&
+            isfinite(m.previousHz) && m.previousHz >= 0.0f &&
+            isfinite(m.probationAbsHz) && m.probationAbsHz >= 0.0f;
+        if (!plausible) memset(&m, 0, sizeof(m));
+    }
+    memset(_data.baseLearnReserved, 0, sizeof(_data.baseLearnReserved));
+
+    // A stored null beyond the largest correction did not come from a calibration that finished.
+    for (uint8_t i = 0; i < 4; i++) {
+        if (abs(_data.dcOffsetNull[i]) > dcOffsetToStored(DC_OFFSET_MAX_COUNTS, DC_OFFSET_MAX_COUNTS)) _data.dcOffsetNull[i] = 0;
+    }
+
+    // A coast-down model is all or nothing: any implausible term discards that speed's fit rather than seeding timings from it.
+    for (uint8_t i = 0; i < 3; i++) {
+        CoastDownSpeedModel& m = _data.coastDownModel[i];
+        bool plausible = m.valid == 1 &&
+            isfinite(m.viscousPerSec) && m.viscousPerSec >= 0.0f && m.viscousPerSec <= 10.0f &&
+            isfinite(m.coulombRpmPerSec) && m.coulombRpmPerSec >= 0.0f && m.coulombRpmPerSec <= 1000.0f &&
+            isfinite(m.startRpm) && m.startRpm > 0.0f && m.startRpm <= 200.0f &&
+            isfinite(m.rSquared) && m.rSquared >= 0.0f && m.rSquared <= 1.0f &&
+            (m.viscousPerSec > 0.0f || m.coulombRpmPerSec > 0.0f);
+        if (!plausible) memset(&m, 0, sizeof(m));
+        m.reserved = 0;
+    }
 
     for (uint8_t i = 0; i < 3; i++) {
         ClosedLoopSpeedTuning& t = _data.closedLoopTuning[i];
@@ -1567,7 +1772,7 @@ void Settings::validate() {
         if (_data.speeds[i].filterType > FILTER_FIR) _data.speeds[i].filterType = FILTER_NONE;
         if (_data.speeds[i].iirAlpha < 0.01) _data.speeds[i].iirAlpha = 0.01;
         if (_data.speeds[i].iirAlpha > 0.99) _data.speeds[i].iirAlpha = 0.99;
-        if (_data.speeds[i].firProfile > FIR_AGGRESSIVE) _data.speeds[i].firProfile = FIR_GENTLE;
+        if (_data.speeds[i].firProfile > FIR_CUSTOM) _data.speeds[i].firProfile = FIR_GENTLE;
 
         // Normalize phase offsets to one full cycle so DDS phase conversion does not depend on callers wrapping values before saving.
         for(int p=0; p<4; p++) {
@@ -1708,6 +1913,7 @@ void Settings::setDefaults() {
     _data.ampTempShutdownC = AMP_TEMP_SHUTDOWN_C;
     setClosedLoopDefaults(_data);
     setOutputTuningDefaults(_data);
+    setSchema13Defaults(_data);
 }
 
 bool Settings::loadPreset(uint8_t slot) {
@@ -1788,6 +1994,24 @@ bool Settings::exportPresetToJSON(uint8_t slot, String& outStr) {
     doc["vfMF"] = target.vfMidFreq;
     doc["vfML"] = target.vfMidLevel;
     doc["vfBase"] = target.vfBaseFreq;
+    doc["thEn"] = target.thermalDerateEnabled;
+    doc["thWTau"] = target.thermalWindingTauSec;
+    doc["thFTau"] = target.thermalFrameTauSec;
+    doc["thRise"] = target.thermalFullScaleRiseC;
+    doc["thShare"] = target.thermalWindingShare;
+    doc["thStart"] = target.thermalDerateStartC;
+    doc["thLimit"] = target.thermalDerateLimitC;
+    doc["thMin"] = target.thermalMinDerate;
+    JsonArray deadTimeLag = doc["dtLag"].to<JsonArray>();
+    for (int i = 0; i < 3; i++) deadTimeLag.add(target.bridgeDeadTimeLagDeg[i]);
+    JsonArray firCutoff = doc["firCut"].to<JsonArray>();
+    JsonArray firTransition = doc["firTw"].to<JsonArray>();
+    JsonArray firTaps = doc["firTaps"].to<JsonArray>();
+    for (int i = 0; i < 3; i++) {
+        firCutoff.add(target.firCutoffHz[i]);
+        firTransition.add(target.firTransitionHz[i]);
+        firTaps.add(target.firTaps[i]);
+    }
     doc["clEn"] = target.closedLoopEnabled;
     doc["clCtrl"] = target.closedLoopControlMode;
     doc["clMd"] = target.closedLoopSensorMode;
@@ -1831,6 +2055,21 @@ bool Settings::exportPresetToJSON(uint8_t slot, String& outStr) {
     doc["clLockAct"] = target.closedLoopLockTimeoutAction;
     doc["clAmpRec"] = target.closedLoopAmpRecoveryMode;
     doc["clAmpRecMs"] = target.closedLoopAmpRecoveryDelayMs;
+    doc["clSlipAct"] = target.closedLoopSlipAction;
+    doc["clSlipMs"] = target.closedLoopSlipDetectMs;
+    doc["clSlipPct"] = target.closedLoopSlipThresholdPercent;
+    doc["clPullPct"] = target.closedLoopPullOutThresholdPercent;
+    doc["clNotch"] = target.closedLoopNotchEnabled;
+    doc["clNotchBw"] = target.closedLoopNotchBandwidthHz;
+    doc["clNotchMin"] = target.closedLoopNotchMinHz;
+    doc["clNotchMax"] = target.closedLoopNotchMaxHz;
+    doc["ldEn"] = target.loadStepEnabled;
+    doc["ldSlope"] = target.loadStepSlopeRpmPerSec;
+    doc["ldBoost"] = target.loadStepBoostPercent;
+    doc["ldBoostMs"] = target.loadStepBoostMs;
+    doc["akEn"] = target.adaptiveKickEnabled;
+    doc["akPull"] = target.kickPullInPercent;
+    doc["blEn"] = target.baseLearnEnabled;
     JsonArray clTune = doc["clTune"].to<JsonArray>();
     for (int i = 0; i < 3; i++) {
         JsonObject tune = clTune.add<JsonObject>();
@@ -1918,6 +2157,38 @@ bool Settings::importPresetFromJSON(uint8_t slot, const String& jsonStr) {
     if (doc["vfMF"].is<float>()) target.vfMidFreq = doc["vfMF"].as<float>();
     if (doc["vfML"].is<uint8_t>()) target.vfMidLevel = doc["vfML"].as<uint8_t>();
     if (doc["vfBase"].is<float>()) target.vfBaseFreq = doc["vfBase"].as<float>();
+    if (doc["thEn"].is<bool>()) target.thermalDerateEnabled = doc["thEn"].as<bool>();
+    if (doc["thWTau"].is<float>()) target.thermalWindingTauSec = doc["thWTau"].as<float>();
+    if (doc["thFTau"].is<float>()) target.thermalFrameTauSec = doc["thFTau"].as<float>();
+    if (doc["thRise"].is<float>()) target.thermalFullScaleRiseC = doc["thRise"].as<float>();
+    if (doc["thShare"].is<uint8_t>()) target.thermalWindingShare = doc["thShare"].as<uint8_t>();
+    if (doc["thStart"].is<float>()) target.thermalDerateStartC = doc["thStart"].as<float>();
+    if (doc["thLimit"].is<float>()) target.thermalDerateLimitC = doc["thLimit"].as<float>();
+    if (doc["thMin"].is<uint8_t>()) target.thermalMinDerate = doc["thMin"].as<uint8_t>();
+    JsonArray deadTimeLag = doc["dtLag"].as<JsonArray>();
+    if (!deadTimeLag.isNull()) {
+        for (size_t i = 0; i < 3 && i < deadTimeLag.size(); i++) {
+            if (deadTimeLag[i].is<float>()) target.bridgeDeadTimeLagDeg[i] = deadTimeLag[i].as<float>();
+        }
+    }
+    JsonArray firCutoff = doc["firCut"].as<JsonArray>();
+    if (!firCutoff.isNull()) {
+        for (size_t i = 0; i < 3 && i < firCutoff.size(); i++) {
+            if (firCutoff[i].is<float>()) target.firCutoffHz[i] = firCutoff[i].as<float>();
+        }
+    }
+    JsonArray firTransition = doc["firTw"].as<JsonArray>();
+    if (!firTransition.isNull()) {
+        for (size_t i = 0; i < 3 && i < firTransition.size(); i++) {
+            if (firTransition[i].is<float>()) target.firTransitionHz[i] = firTransition[i].as<float>();
+        }
+    }
+    JsonArray firTaps = doc["firTaps"].as<JsonArray>();
+    if (!firTaps.isNull()) {
+        for (size_t i = 0; i < 3 && i < firTaps.size(); i++) {
+            if (firTaps[i].is<uint8_t>()) target.firTaps[i] = firTaps[i].as<uint8_t>();
+        }
+    }
     if (doc["clEn"].is<bool>()) target.closedLoopEnabled = doc["clEn"].as<bool>();
     if (doc["clCtrl"].is<uint8_t>()) target.closedLoopControlMode = doc["clCtrl"].as<uint8_t>();
     if (doc["clMd"].is<uint8_t>()) target.closedLoopSensorMode = doc["clMd"].as<uint8_t>();
@@ -1966,6 +2237,21 @@ bool Settings::importPresetFromJSON(uint8_t slot, const String& jsonStr) {
     if (doc["clLockAct"].is<uint8_t>()) target.closedLoopLockTimeoutAction = doc["clLockAct"].as<uint8_t>();
     if (doc["clAmpRec"].is<uint8_t>()) target.closedLoopAmpRecoveryMode = doc["clAmpRec"].as<uint8_t>();
     if (doc["clAmpRecMs"].is<uint16_t>()) target.closedLoopAmpRecoveryDelayMs = doc["clAmpRecMs"].as<uint16_t>();
+    if (doc["clSlipAct"].is<uint8_t>()) target.closedLoopSlipAction = doc["clSlipAct"].as<uint8_t>();
+    if (doc["clSlipMs"].is<uint16_t>()) target.closedLoopSlipDetectMs = doc["clSlipMs"].as<uint16_t>();
+    if (doc["clSlipPct"].is<float>()) target.closedLoopSlipThresholdPercent = doc["clSlipPct"].as<float>();
+    if (doc["clPullPct"].is<float>()) target.closedLoopPullOutThresholdPercent = doc["clPullPct"].as<float>();
+    if (doc["clNotch"].is<bool>()) target.closedLoopNotchEnabled = doc["clNotch"].as<bool>();
+    if (doc["clNotchBw"].is<float>()) target.closedLoopNotchBandwidthHz = doc["clNotchBw"].as<float>();
+    if (doc["clNotchMin"].is<float>()) target.closedLoopNotchMinHz = doc["clNotchMin"].as<float>();
+    if (doc["clNotchMax"].is<float>()) target.closedLoopNotchMaxHz = doc["clNotchMax"].as<float>();
+    if (doc["ldEn"].is<bool>()) target.loadStepEnabled = doc["ldEn"].as<bool>();
+    if (doc["ldSlope"].is<float>()) target.loadStepSlopeRpmPerSec = doc["ldSlope"].as<float>();
+    if (doc["ldBoost"].is<uint8_t>()) target.loadStepBoostPercent = doc["ldBoost"].as<uint8_t>();
+    if (doc["ldBoostMs"].is<uint16_t>()) target.loadStepBoostMs = doc["ldBoostMs"].as<uint16_t>();
+    if (doc["akEn"].is<bool>()) target.adaptiveKickEnabled = doc["akEn"].as<bool>();
+    if (doc["akPull"].is<uint8_t>()) target.kickPullInPercent = doc["akPull"].as<uint8_t>();
+    if (doc["blEn"].is<bool>()) target.baseLearnEnabled = doc["blEn"].as<bool>();
     JsonArray clTune = doc["clTune"].as<JsonArray>();
     if (!clTune.isNull()) {
         // New preset format stores closed-loop tuning per speed.
@@ -2068,3 +2354,105 @@ uint32_t Settings::getSessionRuntime() {
 uint32_t Settings::getTotalRuntime() {
     return _data.totalRuntime;
 }
+
+void Settings::appendHealthRecord(const HealthRecord& record) {
+    // RAM only; the owner calls saveHealthHistory() once the motor is idle so a session end never waits on flash.
+    _health[_healthHead] = record;
+    _health[_healthHead].valid = 1;
+    _healthHead = (_healthHead + 1) % HEALTH_HISTORY_RECORDS;
+    if (_healthCount < HEALTH_HISTORY_RECORDS) _healthCount++;
+    _healthDirty = true;
+}
+
+void Settings::loadHealthHistory() {
+    memset(_health, 0, sizeof(_health));
+    _healthHead = 0;
+    _healthCount = 0;
+    _healthDirty = false;
+
+    char backupPath[40];
+    const char* paths[2] = { _healthFilename, nullptr };
+    if (makeSidecarPath(_healthFilename, ".bak", backupPath, sizeof(backupPath))) paths[1] = backupPath;
+
+    for (uint8_t p = 0; p < 2 && paths[p]; p++) {
+        File f = LittleFS.open(paths[p], "r");
+        if (!f) continue;
+        HealthFileHeader header;
+        bool ok = f.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+            header.magic == HEALTH_FILE_MAGIC &&
+            header.formatVersion == HEALTH_FILE_FORMAT_VERSION &&
+            header.headerSize == sizeof(HealthFileHeader) &&
+            header.recordSize == sizeof(HealthRecord) &&
+            f.size() == (size_t)header.headerSize + (size_t)header.recordCount * header.recordSize;
+
+        // Records stream straight into the ring; a history longer than the ring keeps its newest records.
+        uint32_t crc = 0;
+        for (uint16_t i = 0; ok && i < header.recordCount; i++) {
+            HealthRecord record;
+            ok = f.read((uint8_t*)&record, sizeof(record)) == sizeof(record);
+            if (!ok) break;
+            crc = settingsCrc32((const uint8_t*)&record, sizeof(record), crc);
+            if (record.valid && record.speed <= SPEED_78) appendHealthRecord(record);
+        }
+        f.close();
+        if (ok && crc == header.crc32) {
+            _healthDirty = false;
+            return;
+        }
+        memset(_health, 0, sizeof(_health));
+        _healthHead = 0;
+        _healthCount = 0;
+        _healthDirty = false;
+    }
+}
+
+bool Settings::saveHealthHistory() {
+    if (safeModeActive) return false;
+    char tmpPath[40];
+    char backupPath[40];
+    if (!makeSidecarPath(_healthFilename, ".tmp", tmpPath, sizeof(tmpPath))) return false;
+    if (!makeSidecarPath(_healthFilename, ".bak", backupPath, sizeof(backupPath))) return false;
+
+    // The ring is written oldest first in up to two runs, so the file never stores a head index.
+    uint16_t first = (_healthHead + HEALTH_HISTORY_RECORDS - _healthCount) % HEALTH_HISTORY_RECORDS;
+    uint16_t firstRun = _healthCount;
+    if (first + firstRun > HEALTH_HISTORY_RECORDS) firstRun = HEALTH_HISTORY_RECORDS - first;
+    uint16_t secondRun = _healthCount - firstRun;
+
+    HealthFileHeader header;
+    header.magic = HEALTH_FILE_MAGIC;
+    header.formatVersion = HEALTH_FILE_FORMAT_VERSION;
+    header.headerSize = sizeof(HealthFileHeader);
+    header.recordSize = sizeof(HealthRecord);
+    header.recordCount = _healthCount;
+    header.crc32 = settingsCrc32((const uint8_t*)&_health[first], firstRun * sizeof(HealthRecord));
+    header.crc32 = settingsCrc32((const uint8_t*)&_health[0], secondRun * sizeof(HealthRecord), header.crc32);
+
+    LittleFS.remove(tmpPath);
+    File f = LittleFS.open(tmpPath, "w");
+    if (!f) return false;
+    bool ok = f.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+    ok = ok && f.write((const uint8_t*)&_health[first], firstRun * sizeof(HealthRecord)) == firstRun * sizeof(HealthRecord);
+    ok = ok && f.write((const uint8_t*)&_health[0], secondRun * sizeof(HealthRecord)) == secondRun * sizeof(HealthRecord);
+    f.close();
+    if (!ok) {
+        LittleFS.remove(tmpPath);
+        return false;
+    }
+    if (!promoteSidecarFile(_healthFilename, tmpPath, backupPath)) return false;
+    _healthDirty = false;
+    return true;
+}
+
+bool Settings::clearHealthHistory() {
+    // For a belt change or bearing service, so the new parts start their own trend.
+    memset(_health, 0, sizeof(_health));
+    _healthHead = 0;
+    _healthCount = 0;
+    _healthDirty = false;
+    if (safeModeActive) return false;
+    char backupPath[40];
+    if (makeSidecarPath(_healthFilename, ".bak", backupPath, sizeof(backupPath))) LittleFS.remove(backupPath);
+    LittleFS.remove(_healthFilename);
+    return !LittleFS.exists(_healthFilename);
+}
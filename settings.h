@@ -13,6 +13,7 @@
 #include <LittleFS.h>
 #include "types.h"
 #include "config.h"
+#include "health_trend.h"
 
 /**
  * @brief Manages persistent configuration using LittleFS.
@@ -66,6 +67,15 @@ public:
     void resetSessionRuntime();
     bool resetTotalRuntime();
 
+    // --- Health History ---
+    // Per-session health records in a bounded ring, oldest overwritten first. Slots past the count are zeroed and marked invalid.
+    void appendHealthRecord(const HealthRecord& record);
+    const HealthRecord* getHealthRecords() const { return _health; }
+    uint16_t getHealthRecordCount() const { return _healthCount; }
+    bool saveHealthHistory();
+    bool clearHealthHistory();
+    bool isHealthHistoryDirty() const { return _healthDirty; }
+
 private:
     // Current live settings. This is written directly as a binary payload, so field changes must be coordinated with types.h/config.h migrations.
     GlobalSettings _data;
@@ -75,6 +85,14 @@ private:
     uint32_t _lastRuntimeUpdate;
     uint32_t _sessionRuntime;
 
+    // Health history is kept in its own file so a session record never rewrites the settings blob.
+    HealthRecord _health[HEALTH_HISTORY_RECORDS];
+    uint16_t _healthHead;
+    uint16_t _healthCount;
+    bool _healthDirty;
+    const char* _healthFilename = "/health.bin";
+    void loadHealthHistory();
+
     // Rollback state guards against a saved setting that lets the firmware boot but fails before waveform generation becomes healthy.
     bool _rollbackApplied;
     bool _bootCandidateActive;
@@ -0,0 +1,112 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "settings_migration.h"
+#include "fir_design.h"
+#include <string.h>
+
+void setClosedLoopSlipDefaults(GlobalSettings& target) {
+    target.closedLoopSlipAction = CLOSED_LOOP_SLIP_WARN;
+    target.closedLoopSlipDetectMs = 300;
+    target.closedLoopSlipThresholdPercent = 3.0f;
+    target.closedLoopPullOutThresholdPercent = 25.0f;
+}
+
+void setCoastDownDefaults(GlobalSettings& target) {
+    // No deck has been identified yet; start/stop timing stays on the hand-tuned values until a coast-down bench run succeeds.
+    memset(target.coastDownModel, 0, sizeof(target.coastDownModel));
+}
+
+void setMotorThermalDefaults(GlobalSettings& target) {
+    // Conservative figures for a small synchronous turntable motor; derating stays off until the user matches them to the motor in use.
+    target.thermalWindingTauSec = 60.0f;
+    target.thermalFrameTauSec = 900.0f;
+    target.thermalFullScaleRiseC = 60.0f;
+    target.thermalDerateStartC = 40.0f;
+    target.thermalDerateLimitC = 55.0f;
+    target.thermalDerateEnabled = false;
+    target.thermalWindingShare = 30;
+    target.thermalMinDerate = 50;
+    target.thermalReserved = 0;
+}
+
+void setClosedLoopNotchDefaults(GlobalSettings& target) {
+    // Off by default: the band covers typical belt and sub-chassis modes, but only a deck with a visible resonance benefits.
+    target.closedLoopNotchBandwidthHz = 0.3f;
+    target.closedLoopNotchMinHz = 0.3f;
+    target.closedLoopNotchMaxHz = 4.0f;
+    target.closedLoopNotchEnabled = false;
+    memset(target.closedLoopNotchReserved, 0, sizeof(target.closedLoopNotchReserved));
+}
+
+void setLoadStepDefaults(GlobalSettings& target) {
+    // Nothing is learned yet, so the first needle drops only measure; feed-forward starts once a step size is known.
+    target.loadStepSlopeRpmPerSec = 0.06f;
+    memset(target.loadStepLearnedHz, 0, sizeof(target.loadStepLearnedHz));
+    target.loadStepBoostMs = 1500;
+    target.loadStepEnabled = false;
+    target.loadStepBoostPercent = 10;
+}
+
+void setBridgeDeadTimeDefaults(GlobalSettings& target) {
+    // The factory dead time comes from the build; the lag is motor specific and starts at zero until tuned.
+    memset(target.bridgeDeadTimeLagDeg, 0, sizeof(target.bridgeDeadTimeLagDeg));
+    target.bridgeDeadTimeNs = POWER_STAGE_DEADTIME_NS;
+    memset(target.bridgeDeadTimeReserved, 0, sizeof(target.bridgeDeadTimeReserved));
+}
+
+void setFirDesignDefaults(GlobalSettings& target) {
+    // Custom starts from the Medium design so switching a speed to Custom does not change its output until edited.
+    for (uint8_t i = 0; i < 3; i++) {
+        target.firCutoffHz[i] = 5000.0f;
+        target.firTransitionHz[i] = 5000.0f;
+        target.firTaps[i] = FIR_MAX_TAPS;
+    }
+    target.firDesignReserved = 0;
+}
+
+void setAdaptiveKickDefaults(GlobalSettings& target) {
+    // Nothing is learned until a start has been watched, so the first start runs the configured kick.
+    memset(target.kickLearnedMs, 0, sizeof(target.kickLearnedMs));
+    memset(target.kickRampLearnedMs, 0, sizeof(target.kickRampLearnedMs));
+    target.adaptiveKickEnabled = true;
+    target.kickPullInPercent = 95;
+    memset(target.kickReserved, 0, sizeof(target.kickReserved));
+}
+
+void setBaseLearnDefaults(GlobalSettings& target) {
+    // An empty model anchors on whatever base is set when the first locked session ends.
+    memset(target.baseLearn, 0, sizeof(target.baseLearn));
+    target.baseLearnEnabled = true;
+    memset(target.baseLearnReserved, 0, sizeof(target.baseLearnReserved));
+}
+
+void setDcOffsetNullDefaults(GlobalSettings& target) {
+    // No correction until the amplifier has been measured.
+    memset(target.dcOffsetNull, 0, sizeof(target.dcOffsetNull));
+}
+
+void setSchema13Defaults(GlobalSettings& target) {
+    setClosedLoopSlipDefaults(target);
+    setCoastDownDefaults(target);
+    setMotorThermalDefaults(target);
+    setClosedLoopNotchDefaults(target);
+    setLoadStepDefaults(target);
+    setBridgeDeadTimeDefaults(target);
+    setFirDesignDefaults(target);
+    setAdaptiveKickDefaults(target);
+    setBaseLearnDefaults(target);
+    setDcOffsetNullDefaults(target);
+}
+
+void copyFromV12(const GlobalSettingsV12& source, GlobalSettings& target) {
+    memset(&target, 0, sizeof(target));
+    memcpy(&target, source.bytes, sizeof(source.bytes));
+    target.schemaVersion = SETTINGS_SCHEMA_VERSION;
+    setSchema13Defaults(target);
+}
@@ -0,0 +1,47 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef SETTINGS_MIGRATION_H
+#define SETTINGS_MIGRATION_H
+
+#include "types.h"
+
+/*
+ * Schema 13 defaults and the schema 12 migration.
+ *
+ * Schema 13 only appended fields after vfBaseFreq, so a schema 12 payload is
+ * byte-for-byte the prefix of the current layout. Migration copies that
+ * prefix and gives every appended field its default. Older migrations and
+ * factory defaults set the same fields through setSchema13Defaults().
+ *
+ * Only types.h is needed, so migration can be checked on a host against a
+ * schema 12 image.
+ */
+struct GlobalSettingsV12 {
+    uint8_t bytes[620];
+};
+
+static_assert(sizeof(GlobalSettingsV12) == 620, "GlobalSettingsV12 must match schema 12 storage size.");
+
+void setClosedLoopSlipDefaults(GlobalSettings& target);
+void setCoastDownDefaults(GlobalSettings& target);
+void setMotorThermalDefaults(GlobalSettings& target);
+void setClosedLoopNotchDefaults(GlobalSettings& target);
+void setLoadStepDefaults(GlobalSettings& target);
+void setBridgeDeadTimeDefaults(GlobalSettings& target);
+void setFirDesignDefaults(GlobalSettings& target);
+void setAdaptiveKickDefaults(GlobalSettings& target);
+void setBaseLearnDefaults(GlobalSettings& target);
+void setDcOffsetNullDefaults(GlobalSettings& target);
+
+// Every field schema 13 added after the schema 12 layout.
+void setSchema13Defaults(GlobalSettings& target);
+
+void copyFromV12(const GlobalSettingsV12& source, GlobalSettings& target);
+
+#endif // SETTINGS_MIGRATION_H
@@ -0,0 +1,63 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "slip_detect.h"
+#include <math.h>
+
+void slipRatioUpdate(SlipRatio& ratio, float nominalRpmPerHz, float outputHz, float measuredRpm, bool locked) {
+    if (ratio.rpmPerHz <= 0.0f) ratio.rpmPerHz = nominalRpmPerHz;
+    if (!locked || outputHz <= 0.0f || !isfinite(measuredRpm)) return;
+
+    // A locked platter is by definition running at the intended speed, so those samples teach the ratio, including any normal belt creep.
+    float observed = measuredRpm / outputHz;
+    if (ratio.learned) {
+        ratio.rpmPerHz += (observed - ratio.rpmPerHz) * SLIP_RATIO_ALPHA;
+    } else {
+        ratio.rpmPerHz = observed;
+        ratio.learned = true;
+    }
+}
+
+float slipPercent(float rpmPerHz, float outputHz, float measuredRpm) {
+    float synchronousRpm = rpmPerHz * outputHz;
+    if (synchronousRpm <= 0.0f) return 0.0f;
+    return ((synchronousRpm - measuredRpm) / synchronousRpm) * 100.0f;
+}
+
+SlipWindow::SlipWindow() {
+    reset();
+}
+
+void SlipWindow::reset() {
+    _open = false;
+    _startMs = 0;
+    _peakPercent = 0.0f;
+}
+
+SlipDetectState SlipWindow::update(uint32_t nowMs, float slip, bool locked, bool ratioLearned,
+                                   const SlipDetectParams& params) {
+    bool pullOutEnabled = params.pullOutThresholdPercent > 0.0f;
+    bool slipping = !locked &&
+                    ((ratioLearned && slip >= params.slipThresholdPercent) ||
+                     (pullOutEnabled && slip >= params.pullOutThresholdPercent));
+    if (!slipping) {
+        reset();
+        return SLIP_DETECT_CLEAR;
+    }
+
+    if (!_open) {
+        _open = true;
+        _startMs = nowMs;
+        _peakPercent = slip;
+        return SLIP_DETECT_PENDING;
+    }
+    if (slip > _peakPercent) _peakPercent = slip;
+    if (nowMs - _startMs < params.detectMs) return SLIP_DETECT_PENDING;
+
+    return pullOutEnabled && _peakPercent >= params.pullOutThresholdPercent ? SLIP_DETECT_PULL_OUT : SLIP_DETECT_SLIP;
+}
@@ -0,0 +1,74 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef SLIP_DETECT_H
+#define SLIP_DETECT_H
+
+#include <stdint.h>
+
+/*
+ * Belt slip and rotor pull-out detection from commanded against measured speed.
+ *
+ * The output frequency sets the synchronous platter speed through a ratio in
+ * RPM per Hz. It starts from the configured target RPM and base frequency and
+ * is learned from locked samples, so the normal creep of a belt becomes part
+ * of the reference rather than reading as slip.
+ *
+ * A sample is slipping when the platter is unlocked and short of the
+ * synchronous speed by more than a threshold. Ordinary slip needs a learned
+ * ratio; pull-out thresholds are wide enough to trust the nominal ratio from
+ * the first sample. A shortfall lasting the detection time is reported as
+ * slip, or as pull-out when its peak crossed the pull-out threshold.
+ *
+ * No Arduino headers are used so slip and pull-out profiles can be simulated on a host.
+ */
+enum SlipDetectState : uint8_t {
+    SLIP_DETECT_CLEAR,    // Running at the synchronous speed
+    SLIP_DETECT_PENDING,  // Short of it, for less than the detection time
+    SLIP_DETECT_SLIP,     // Short of it for the detection time
+    SLIP_DETECT_PULL_OUT  // As above, with a peak beyond the pull-out threshold
+};
+
+struct SlipDetectParams {
+    float slipThresholdPercent;    // Shortfall that counts as slip once the ratio is learned
+    float pullOutThresholdPercent; // Shortfall that counts as pull-out, or 0 to disable
+    uint32_t detectMs;             // Time a shortfall must last before it is reported
+};
+
+// Platter RPM per output Hz at one speed.
+struct SlipRatio {
+    float rpmPerHz;
+    bool learned;
+};
+
+// Slip detection learns the ratio slowly so a single noisy sample cannot move the synchronous-speed reference.
+static const float SLIP_RATIO_ALPHA = 0.05f;
+
+// Seeds an unset ratio from nominalRpmPerHz, then learns from the sample when locked.
+void slipRatioUpdate(SlipRatio& ratio, float nominalRpmPerHz, float outputHz, float measuredRpm, bool locked);
+// Shortfall of measuredRpm from the synchronous speed, in percent.
+float slipPercent(float rpmPerHz, float outputHz, float measuredRpm);
+
+class SlipWindow {
+public:
+    SlipWindow();
+
+    void reset();
+    SlipDetectState update(uint32_t nowMs, float slipPercent, bool locked, bool ratioLearned,
+                           const SlipDetectParams& params);
+
+    bool isOpen() const { return _open; }
+    float getPeakPercent() const { return _peakPercent; }
+
+private:
+    bool _open;
+    uint32_t _startMs;
+    float _peakPercent;
+};
+
+#endif // SLIP_DETECT_H
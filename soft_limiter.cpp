@@ -0,0 +1,16 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "soft_limiter.h"
+
+float softLimiterGain(float gain, float requested, float ceiling, float release) {
+    float target = requested > ceiling ? ceiling / requested : 1.0f;
+    if (!(release < 1.0f)) release = 1.0f;
+    if (target < gain) return target;
+    return gain + ((target - gain) * release);
+}
@@ -0,0 +1,29 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef SOFT_LIMITER_H
+#define SOFT_LIMITER_H
+
+/*
+ * Look-ahead soft limiter for the sine channels.
+ *
+ * Each buffer's peak is known before a sample is generated: amplitude,
+ * supply scale and channel gain. Any reduction needed is applied from the
+ * first sample of the buffer, so the peak is scaled rather than flattened
+ * and no odd harmonics are added. The gain then recovers with the release
+ * time constant once the request falls back under the ceiling.
+ *
+ * No Arduino headers are used so the spectrum of limited and clipped output
+ * can be compared on a host.
+ */
+
+// Gain for the coming buffer from the previous gain, the requested peak, the ceiling, and the fraction of the gap to
+// recover per buffer.
+float softLimiterGain(float gain, float requested, float ceiling, float release);
+
+#endif // SOFT_LIMITER_H
@@ -10,10 +10,20 @@
 #include "settings.h"
 #include "hal.h"
 #include "globals.h"
+#include "error_handler.h"
+#if SENSORLESS_SPEED_ENABLE
+#include "waveform.h"
+#endif
 
 SpeedFeedback speedFeedback;
 SpeedFeedback* SpeedFeedback::_instance = nullptr;
 
+#if CLOSED_LOOP_SPEED_ENABLE
+// Counts/rev detection: a suggestion needs this confidence before it can be applied.
+static const float CPR_DETECT_MIN_CONFIDENCE = 0.5f;
+static const uint16_t CPR_DETECT_MIN_SAMPLES = 6;
+#endif
+
 SpeedFeedback::SpeedFeedback() {
     _instance = this;
     _configured = false;
@@ -48,6 +58,27 @@ SpeedFeedback::SpeedFeedback() {
     _lockTimeMs = 1000;
     _filterAlpha = 0.25f;
     _lockToleranceRpm = 0.05f;
+    _configuredDebounceUs = 0;
+    _pinChangesPerCount = 0;
+    _rejectedWindows = 0;
+    RpmEstimatorParams estimatorParams;
+    estimatorParams.mode = SPEED_ESTIMATOR_MODE;
+    estimatorParams.window = SPEED_ESTIMATOR_WINDOW;
+    estimatorParams.hampelK = SPEED_ESTIMATOR_HAMPEL_K;
+    estimatorParams.minSpreadFraction = SPEED_ESTIMATOR_MIN_SPREAD;
+    _estimator.configure(estimatorParams);
+    _dutyHead = 0;
+    _dutyTail = 0;
+    _dutyOverruns = 0;
+    _dutyRiseUs = 0;
+    _dutyFallUs = 0;
+    _dutyFallSeen = false;
+    _dutyPulsesPerRev = 0;
+    _dutyWarningLogged = false;
+    memset(_speedEdges, 0, sizeof(_speedEdges));
+    _edgeBaseAccepted = 0;
+    _edgeBaseDebounced = 0;
+    _edgeBaseInvalid = 0;
 
     _lastSampleCount = 0;
     _lastSampleMs = 0;
@@ -65,6 +96,34 @@ SpeedFeedback::SpeedFeedback() {
     _setupStartInvalidTransitions = 0;
     _setupStartDebouncedTransitions = 0;
     _setupStartMs = 0;
+#if CLOSED_LOOP_SPEED_ENABLE
+    _cprCaptureActive = false;
+    _cprCaptureCount = 0;
+    _cprState = CPR_DETECT_IDLE;
+    _cprStartMs = 0;
+    _cprExpectedRpm = 0.0f;
+    _cprExpectedCounts = 0.0f;
+    _cprSamples = 0;
+    _cprDetectedCounts = 0;
+    _cprCorrelation = 0.0f;
+    _cprConfidence = 0.0f;
+    _cprMessage = "";
+#endif
+#if SENSORLESS_SPEED_ENABLE
+    SensorlessSpeedParams params;
+    params.sampleHz = (float)SENSORLESS_SAMPLE_HZ;
+    params.hysteresis = SENSORLESS_HYSTERESIS;
+    params.minAmplitude = SENSORLESS_MIN_AMPLITUDE;
+    params.windowCycles = SENSORLESS_WINDOW_CYCLES;
+    params.maxPeriodRatio = SENSORLESS_MAX_PERIOD_RATIO;
+    _sensorless.configure(params);
+    _sensorlessTimerRunning = false;
+    _sensorlessHead = 0;
+    _sensorlessTail = 0;
+    _sensorlessOverruns = 0;
+    _sensorlessCrossings = 0;
+    _sensorlessRejected = 0;
+#endif
 }
 
 void SpeedFeedback::begin() {
@@ -75,6 +134,13 @@ void SpeedFeedback::begin() {
     configure();
     attachInterrupt(digitalPinToInterrupt(PIN_SPEED_SENSOR_A), SpeedFeedback::isrHandler, CHANGE);
     attachInterrupt(digitalPinToInterrupt(PIN_SPEED_SENSOR_B), SpeedFeedback::isrHandler, CHANGE);
+#if SENSORLESS_SPEED_ENABLE
+    adc_init();
+    adc_gpio_init(PIN_SENSORLESS_SENSE);
+    // A negative delay schedules from the previous start, so sample spacing does not stretch with callback time.
+    _sensorlessTimerRunning = add_repeating_timer_us(-(int64_t)(1000000 / SENSORLESS_SAMPLE_HZ),
+                                                     SpeedFeedback::sensorlessTimerCallback, this, &_sensorlessTimer);
+#endif
 #else
     _configured = false;
 #endif
@@ -97,9 +163,30 @@ void SpeedFeedback::configure() {
     _lastAState = a;
     _lastBState = b;
     _lastQuadState = ((uint8_t)a << 1) | (uint8_t)b;
+    _dutyRiseUs = 0;
+    _dutyFallSeen = false;
     interrupts();
 
+#if SPEED_DUTY_TRACK_ENABLE
+    // Slots count pulses, not counted edges. The history survives unrelated settings edits so its baseline stays meaningful.
+    _dutyPulsesPerRev = g.closedLoopPulseEdge == CLOSED_LOOP_EDGE_CHANGE ? g.closedLoopCountsPerRev / 2 : g.closedLoopCountsPerRev;
+    uint16_t slots = _dutyPulsesPerRev > PULSE_DUTY_MAX_SLOTS ? 0 : _dutyPulsesPerRev;
+    if (slots != _duty.getStatus().slots || _duty.getStatus().samples == 0) {
+        PulseDutyParams dutyParams;
+        dutyParams.slots = (uint8_t)slots;
+        dutyParams.alpha = SPEED_DUTY_ALPHA;
+        dutyParams.baselineSamples = SPEED_DUTY_BASELINE_SAMPLES;
+        dutyParams.driftLimit = SPEED_DUTY_DRIFT_LIMIT;
+        dutyParams.marginLow = SPEED_DUTY_MARGIN;
+        dutyParams.marginHigh = 1.0f - SPEED_DUTY_MARGIN;
+        _duty.configure(dutyParams);
+        _dutyWarningLogged = false;
+    }
+#endif
+
     _countsPerRev = g.closedLoopCountsPerRev;
+    _configuredDebounceUs = g.closedLoopDebounceUs;
+    _pinChangesPerCount = tachPinChangesPerCount(g.closedLoopSensorMode, g.closedLoopPulseEdge, g.closedLoopQuadratureMode);
     _timeoutMs = g.closedLoopTimeoutMs;
     _updateIntervalMs = g.closedLoopUpdateIntervalMs;
     _filterAlpha = g.closedLoopFilterAlpha;
@@ -114,6 +201,12 @@ void SpeedFeedback::configure() {
 }
 
 void SpeedFeedback::reset() {
+#if CLOSED_LOOP_SPEED_ENABLE
+    // Resets follow speed changes, starts, and settings edits, any of which invalidates a running counts/rev capture.
+    if (_cprState == CPR_DETECT_CAPTURING || _cprState == CPR_DETECT_ANALYSING) {
+        failCountsPerRevDetect("Speed or settings changed during detection");
+    }
+#endif
     resetCounters();
     resetMeasurements();
 }
@@ -136,7 +229,21 @@ void SpeedFeedback::resetCounters() {
     _intervalJitterSumUs = 0;
     _lastDirection = SPEED_FEEDBACK_DIR_UNKNOWN;
     _lastRawDirection = SPEED_FEEDBACK_DIR_UNKNOWN;
+    _edgeBaseAccepted = 0;
+    _edgeBaseDebounced = 0;
+    _edgeBaseInvalid = 0;
+    _rejectedWindows = 0;
+#if SENSORLESS_SPEED_ENABLE
+    // Queued samples predate the reset; the estimator restarts from the next one.
+    _sensorlessTail = _sensorlessHead;
+    _sensorlessOverruns = 0;
+#endif
     interrupts();
+#if SENSORLESS_SPEED_ENABLE
+    _sensorless.reset();
+    _sensorlessCrossings = 0;
+    _sensorlessRejected = 0;
+#endif
 }
 
 void SpeedFeedback::resetMeasurements() {
@@ -151,9 +258,49 @@ void SpeedFeedback::resetMeasurements() {
     _sampleSequence = 0;
     _signalValid = false;
     _locked = false;
+    _estimator.reset();
 }
 
-void SpeedFeedback::beginSetupCapture() {
+void SpeedFeedback::beginSetupCapture(float expectedRpm) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (isSensorlessMode()) {
+        // Sensorless speed comes from electrical cycles, so there is no sensor count to capture.
+        _cprCaptureActive = false;
+        _setupStartMs = hal.getMillis();
+        failCountsPerRevDetect("Sensorless feedback has no counts/rev to detect");
+        _setupActive = true;
+        return;
+    }
+    if (isfinite(expectedRpm) && expectedRpm > 0.0f) {
+        // Running detection leaves the counters alone so closed-loop control and dropout checks keep their history.
+        noInterrupts();
+        _cprCaptureActive = false;
+        _setupStartCount = _count;
+        _setupStartInvalidTransitions = _invalidTransitions;
+        _setupStartDebouncedTransitions = _debouncedTransitions;
+        interrupts();
+        _setupStartMs = hal.getMillis();
+        _cprStartMs = _setupStartMs;
+        _cprExpectedRpm = expectedRpm;
+        _cprExpectedCounts = 0.0f;
+        _cprSamples = 0;
+        _cprDetectedCounts = 0;
+        _cprCorrelation = 0.0f;
+        _cprConfidence = 0.0f;
+        _cprMessage = "Capturing edge intervals";
+        _cprState = CPR_DETECT_CAPTURING;
+        noInterrupts();
+        _cprCaptureCount = 0;
+        _cprCaptureActive = true;
+        interrupts();
+        _setupActive = true;
+        return;
+    }
+    _cprCaptureActive = false;
+    _cprState = CPR_DETECT_IDLE;
+#else
+    (void)expectedRpm;
+#endif
     // Start with a clean counter window so the suggested counts/rev is the count delta for the user's manual revolution.
     reset();
     noInterrupts();
@@ -166,27 +313,107 @@ void SpeedFeedback::beginSetupCapture() {
 }
 
 void SpeedFeedback::cancelSetupCapture() {
+#if CLOSED_LOOP_SPEED_ENABLE
+    _cprCaptureActive = false;
+    _cprState = CPR_DETECT_IDLE;
+#endif
     _setupActive = false;
 }
 
+void SpeedFeedback::updateCountsPerRevDetect(uint32_t nowMs) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (_cprState == CPR_DETECT_CAPTURING) {
+        uint16_t captured = _cprCaptureCount;
+        uint32_t elapsedMs = nowMs - _cprStartMs;
+        uint32_t captureMs = (uint32_t)((60000.0f * CPR_DETECT_REVOLUTIONS) / _cprExpectedRpm);
+        if (captured < CPR_DETECT_SAMPLES && (elapsedMs < captureMs || captured < CPR_DETECT_MIN_SAMPLES)) {
+            if (elapsedMs >= captureMs * 2UL) failCountsPerRevDetect("Too few edges; check the sensor signal");
+            return;
+        }
+
+        noInterrupts();
+        _cprCaptureActive = false;
+        captured = _cprCaptureCount;
+        interrupts();
+
+        // The first interval may span time before capture started, so analysis begins at the second entry.
+        if (!_cprDetector.begin(&_cprIntervals[1], captured - 1, _cprExpectedRpm)) {
+            failCountsPerRevDetect(_cprDetector.getMessage());
+            return;
+        }
+        _cprSamples = _cprDetector.getSamples();
+        _cprExpectedCounts = _cprDetector.getExpectedCounts();
+        _cprMessage = _cprDetector.getMessage();
+        _cprState = CPR_DETECT_ANALYSING;
+        if (_cprDetector.isFinished()) finishCountsPerRevDetect();
+        return;
+    }
+
+    if (_cprState != CPR_DETECT_ANALYSING) return;
+    if (_cprDetector.analyse(CPR_DETECT_BUDGET)) finishCountsPerRevDetect();
+#else
+    (void)nowMs;
+#endif
+}
+
+void SpeedFeedback::finishCountsPerRevDetect() {
+#if CLOSED_LOOP_SPEED_ENABLE
+    _cprDetectedCounts = _cprDetector.getDetectedCounts();
+    _cprCorrelation = _cprDetector.getCorrelation();
+    _cprConfidence = _cprDetector.getConfidence();
+    _cprMessage = _cprDetector.getMessage();
+    _cprState = _cprDetectedCounts > 0 ? CPR_DETECT_DONE : CPR_DETECT_FAILED;
+#endif
+}
+
+void SpeedFeedback::failCountsPerRevDetect(const char* message) {
+#if CLOSED_LOOP_SPEED_ENABLE
+    _cprCaptureActive = false;
+    _cprConfidence = 0.0f;
+    _cprMessage = message;
+    _cprState = CPR_DETECT_FAILED;
+#else
+    (void)message;
+#endif
+}
+
 void SpeedFeedback::update(float targetRpm) {
     // This method runs on Core 0. It samples ISR counters at the configured interval and turns count delta over elapsed time into RPM.
     _targetRpm = targetRpm;
     ClosedLoopSpeedTuning& tuning = settings.getCurrentClosedLoopTuning();
     _lockTimeMs = tuning.lockTimeMs;
     _lockToleranceRpm = tuning.lockToleranceRpm;
+#if SENSORLESS_SPEED_ENABLE
+    drainSensorlessSamples();
+#endif
+    drainDutySamples(targetRpm);
 
     int32_t count;
     uint32_t lastPulseUs;
+    uint32_t accepted;
+    uint32_t debounced;
+    uint32_t invalid;
     noInterrupts();
     count = _count;
     lastPulseUs = _lastPulseUs;
+    accepted = _acceptedTransitions;
+    debounced = _debouncedTransitions;
+    invalid = _invalidTransitions;
     interrupts();
+    updateEdgeStats(accepted, debounced, invalid);
+    updateDebounceWindow(targetRpm);
 
     uint32_t nowMs = hal.getMillis();
     uint32_t nowUs = hal.getMicros();
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (_cprState == CPR_DETECT_CAPTURING || _cprState == CPR_DETECT_ANALYSING) updateCountsPerRevDetect(nowMs);
+#endif
     uint32_t pulseAgeMs = lastPulseUs == 0 ? UINT32_MAX : (nowUs - lastPulseUs) / 1000UL;
     bool signalValid = _configured && lastPulseUs != 0 && pulseAgeMs <= _timeoutMs;
+    bool sensorless = isSensorlessMode();
+#if SENSORLESS_SPEED_ENABLE
+    if (sensorless) signalValid = signalValid && _sensorless.isValid();
+#endif
 
     if (_lastSampleMs == 0) {
         _lastSampleMs = nowMs;
@@ -209,23 +436,40 @@ void SpeedFeedback::update(float targetRpm) {
     _sampleSequence++;
     _signalValid = signalValid;
 
-    if (!signalValid || _countsPerRev == 0 || elapsedMs == 0) {
+    if (!signalValid || (_countsPerRev == 0 && !sensorless) || elapsedMs == 0) {
         // Drop stale speed estimates immediately when the signal is lost so closed-loop code cannot keep correcting from old RPM data.
         _measuredRpm = 0.0f;
         _filteredRpm = 0.0f;
         _rpmError = _targetRpm;
         _locked = false;
         _lockCandidateStartMs = 0;
+        _estimator.reset();
         return;
     }
 
-    float revolutions = (float)abs(delta) / (float)_countsPerRev;
-    _measuredRpm = revolutions * (60000.0f / (float)elapsedMs);
+    float quantumRpm = 0.0f;
+    if (sensorless) {
+#if SENSORLESS_SPEED_ENABLE
+        // The stored target and base frequency of the selected speed give platter RPM per electrical hertz, so pitch and correction do not leak into the scale.
+        GlobalSettings& g = settings.get();
+        uint8_t speedIndex = g.currentSpeed;
+        float baseHz = g.speeds[speedIndex].frequency;
+        float rpmPerHz = baseHz > 0.0f ? g.closedLoopTargetRpm[speedIndex] / baseHz : 0.0f;
+        _measuredRpm = _sensorless.getElectricalHz() * rpmPerHz;
+#endif
+    } else {
+        float revolutions = (float)abs(delta) / (float)_countsPerRev;
+        _measuredRpm = revolutions * (60000.0f / (float)elapsedMs);
+        quantumRpm = 60000.0f / ((float)_countsPerRev * (float)elapsedMs);
+    }
+    // Readings alternate between neighbouring counts, so half a count of spread is normal; a missed or doubled edge sits further out.
+    float windowRpm = _estimator.update(_measuredRpm, 0.5f * quantumRpm);
+    if (_estimator.lastRejected()) _rejectedWindows++;
     if (_filteredRpm <= 0.0f) {
-        _filteredRpm = _measuredRpm;
+        _filteredRpm = windowRpm;
     } else {
         // Exponential smoothing is intentionally simple and bounded by settings.
-        _filteredRpm += (_measuredRpm - _filteredRpm) * _filterAlpha;
+        _filteredRpm += (windowRpm - _filteredRpm) * _filterAlpha;
     }
     _rpmError = _targetRpm - _filteredRpm;
 
@@ -297,6 +541,81 @@ SpeedFeedbackStatus SpeedFeedback::getStatus() {
     status.lastPulseAgeMs = lastPulseUs == 0 ? UINT32_MAX : (nowUs - lastPulseUs) / 1000UL;
     status.sampleTimeMs = _lastSampleMs;
     status.sampleSequence = _sampleSequence;
+    status.debounceUs = _debounceUs;
+    status.rejectedWindows = _rejectedWindows;
+#if SPEED_DUTY_TRACK_ENABLE
+    status.dutyTracked = _sensorMode == CLOSED_LOOP_SENSOR_PULSE;
+#else
+    status.dutyTracked = false;
+#endif
+    status.dutyOverruns = _dutyOverruns;
+    status.duty = _duty.getStatus();
+    memcpy(status.speedEdges, _speedEdges, sizeof(status.speedEdges));
+    return status;
+}
+
+void SpeedFeedback::updateDebounceWindow(float targetRpm) {
+    uint32_t windowUs = _configuredDebounceUs;
+#if SPEED_DEBOUNCE_ADAPTIVE_ENABLE && CLOSED_LOOP_SPEED_ENABLE
+    // Counts/rev detection runs because the stored count may be wrong, so it keeps the fixed window.
+    if (_cprState != CPR_DETECT_CAPTURING && _cprState != CPR_DETECT_ANALYSING) {
+        TachDebounceParams params;
+        params.periodFraction = SPEED_DEBOUNCE_PERIOD_FRACTION;
+        params.maxFraction = SPEED_DEBOUNCE_MAX_FRACTION;
+        float pulseDuty = 0.0f;
+#if SPEED_DUTY_TRACK_ENABLE
+        if (_sensorMode == CLOSED_LOOP_SENSOR_PULSE) {
+            // Until the duty is known, and below the marginal limit, the window assumes the narrowest healthy pulse.
+            pulseDuty = _duty.getMeanDuty();
+            if (pulseDuty < SPEED_DUTY_MARGIN) pulseDuty = SPEED_DUTY_MARGIN;
+            if (pulseDuty > 1.0f - SPEED_DUTY_MARGIN) pulseDuty = 1.0f - SPEED_DUTY_MARGIN;
+        }
+#endif
+        windowUs = tachDebounceWindowUs(params, _configuredDebounceUs, targetRpm, _countsPerRev, _pinChangesPerCount, pulseDuty);
+    }
+#else
+    (void)targetRpm;
+#endif
+    // A single aligned word store; the ISR sees either window whole.
+    _debounceUs = windowUs;
+}
+
+void SpeedFeedback::updateEdgeStats(uint32_t accepted, uint32_t debounced, uint32_t invalid) {
+    uint8_t speed = settings.get().currentSpeed;
+    if (speed < 3) {
+        _speedEdges[speed].accepted += accepted - _edgeBaseAccepted;
+        _speedEdges[speed].debounced += debounced - _edgeBaseDebounced;
+        _speedEdges[speed].invalid += invalid - _edgeBaseInvalid;
+    }
+    _edgeBaseAccepted = accepted;
+    _edgeBaseDebounced = debounced;
+    _edgeBaseInvalid = invalid;
+}
+
+SensorlessSpeedStatus SpeedFeedback::getSensorlessStatus() {
+    SensorlessSpeedStatus status;
+    status.enabled = SENSORLESS_SPEED_ENABLE != 0;
+    status.active = isSensorlessMode();
+    status.valid = false;
+    status.electricalHz = 0.0f;
+    status.driveHz = 0.0f;
+    status.slipHz = 0.0f;
+    status.phaseDegrees = 0.0f;
+    status.amplitude = 0.0f;
+    status.crossings = 0;
+    status.rejectedCrossings = 0;
+    status.overruns = 0;
+#if SENSORLESS_SPEED_ENABLE
+    status.valid = _sensorless.isValid();
+    status.electricalHz = _sensorless.getElectricalHz();
+    status.driveHz = _sensorless.getDriveHz();
+    status.slipHz = _sensorless.getSlipHz();
+    status.phaseDegrees = _sensorless.getPhaseDegrees();
+    status.amplitude = _sensorless.getAmplitude();
+    status.crossings = _sensorlessCrossings;
+    status.rejectedCrossings = _sensorlessRejected;
+    status.overruns = _sensorlessOverruns;
+#endif
     return status;
 }
 
@@ -331,6 +650,46 @@ SpeedFeedbackSetupStatus SpeedFeedback::getSetupStatus() {
      */
     status.suggestedCountsPerRev = absDelta > 0 && absDelta <= 20000 ? (uint16_t)absDelta : 0;
     status.suggestedReverseDirection = status.rawDirection == SPEED_FEEDBACK_DIR_REVERSE;
+
+    status.autoDetect = false;
+    status.autoState = CPR_DETECT_IDLE;
+    status.autoProgressPercent = 0;
+    status.autoSamples = 0;
+    status.autoDetectedCountsPerRev = 0;
+    status.autoExpectedCountsPerRev = 0.0f;
+    status.autoCorrelation = 0.0f;
+    status.autoConfidence = 0.0f;
+    status.autoMessage = "";
+#if CLOSED_LOOP_SPEED_ENABLE
+    if (_setupActive && _cprState != CPR_DETECT_IDLE) {
+        status.autoDetect = true;
+        status.autoState = _cprState;
+        status.autoExpectedCountsPerRev = _cprExpectedCounts;
+        status.autoDetectedCountsPerRev = _cprDetectedCounts;
+        status.autoCorrelation = _cprCorrelation;
+        status.autoConfidence = _cprConfidence;
+        status.autoMessage = _cprMessage;
+        if (_cprState == CPR_DETECT_CAPTURING) {
+            uint16_t captured = _cprCaptureCount;
+            float captureMs = (60000.0f * CPR_DETECT_REVOLUTIONS) / _cprExpectedRpm;
+            float fraction = (float)status.elapsedMs / captureMs;
+            float sampleFraction = (float)captured / (float)CPR_DETECT_SAMPLES;
+            if (sampleFraction > fraction) fraction = sampleFraction;
+            if (fraction > 1.0f) fraction = 1.0f;
+            status.autoSamples = captured;
+            status.autoProgressPercent = (uint8_t)(fraction * 50.0f);
+        } else if (_cprState == CPR_DETECT_ANALYSING) {
+            status.autoSamples = _cprSamples;
+            status.autoProgressPercent = (uint8_t)(50U + (_cprDetector.getProgressPercent() / 2U));
+        } else {
+            status.autoSamples = _cprSamples;
+            status.autoProgressPercent = 100;
+        }
+        // Running detection replaces the manual count; only a confident result is offered to the apply paths.
+        status.suggestedCountsPerRev = _cprState == CPR_DETECT_DONE && _cprConfidence >= CPR_DETECT_MIN_CONFIDENCE ?
+            _cprDetectedCounts : 0;
+    }
+#endif
     return status;
 }
 
@@ -341,21 +700,33 @@ void SpeedFeedback::isrHandler() {
 void SpeedFeedback::handleInterrupt() {
 #if CLOSED_LOOP_SPEED_ENABLE
     if (!_configured && !_setupActive) return;
+    // Sensorless crossings are counted from update(); stray tach pin edges must not add to them.
+    if (_sensorMode == CLOSED_LOOP_SENSOR_SENSORLESS) return;
 
-    // Debounce is based on accepted edges, not all pin changes, so rejected chatter does not keep extending the debounce window forever.
     uint32_t nowUs = micros();
-    if (_debounceUs > 0 && (nowUs - _lastAcceptedEdgeUs) < _debounceUs) {
+    bool a = digitalRead(PIN_SPEED_SENSOR_A) == HIGH;
+    bool b = digitalRead(PIN_SPEED_SENSOR_B) == HIGH;
+    bool pulse = _sensorMode == CLOSED_LOOP_SENSOR_PULSE;
+    uint8_t previousState = _lastQuadState;
+    uint8_t currentState = ((uint8_t)a << 1) | (uint8_t)b;
+
+    // A pulse sensor only watches A. Every change past the window restarts it, counted or not.
+    TachEdgeAction action = pulse ?
+        tachDebounceEdge(_debounceUs, _lastAcceptedEdgeUs, nowUs, (uint8_t)_lastAState, (uint8_t)a) :
+        tachDebounceEdge(_debounceUs, _lastAcceptedEdgeUs, nowUs, previousState, currentState);
+    if (action == TACH_EDGE_DEBOUNCED) {
         _debouncedTransitions++;
         return;
     }
+    if (action == TACH_EDGE_PASSED) _lastAcceptedEdgeUs = nowUs;
 
-    bool a = digitalRead(PIN_SPEED_SENSOR_A) == HIGH;
-    bool b = digitalRead(PIN_SPEED_SENSOR_B) == HIGH;
-
-    if (_sensorMode == CLOSED_LOOP_SENSOR_PULSE) {
+    if (pulse) {
         bool previousA = _lastAState;
         _lastAState = a;
         _lastBState = b;
+#if SPEED_DUTY_TRACK_ENABLE
+        if (action == TACH_EDGE_PASSED) recordDutyEdge(a, nowUs);
+#endif
         if (!acceptsPulseEdge(previousA, a)) return;
 
         _lastRawDirection = SPEED_FEEDBACK_DIR_FORWARD;
@@ -365,9 +736,7 @@ void SpeedFeedback::handleInterrupt() {
         return;
     }
 
-    uint8_t previousState = _lastQuadState;
-    uint8_t currentState = ((uint8_t)a << 1) | (uint8_t)b;
-    if (currentState == previousState) return;
+    if (action == TACH_EDGE_UNCHANGED) return;
 
     int8_t delta = quadratureDelta(previousState, currentState);
     if (delta == 0) {
@@ -414,16 +783,149 @@ void SpeedFeedback::recordAcceptedTransition(uint32_t nowUs) {
             _intervalJitterSamples++;
         }
         _previousIntervalUs = intervalUs;
+        if (_cprCaptureActive) {
+            // Capture stops itself when full so Core 0 analyses a buffer that no longer changes underneath it.
+            uint16_t index = _cprCaptureCount;
+            _cprIntervals[index] = intervalUs;
+            _cprCaptureCount = index + 1;
+            if (index + 1 >= CPR_DETECT_SAMPLES) _cprCaptureActive = false;
+        }
     }
 
     _acceptedTransitions++;
     _lastPulseUs = nowUs;
-    _lastAcceptedEdgeUs = nowUs;
 #else
     (void)nowUs;
 #endif
 }
 
+void SpeedFeedback::recordDutyEdge(bool rising, uint32_t nowUs) {
+#if CLOSED_LOOP_SPEED_ENABLE && SPEED_DUTY_TRACK_ENABLE
+    if (!rising) {
+        if (_dutyRiseUs != 0) {
+            _dutyFallUs = nowUs;
+            _dutyFallSeen = true;
+        }
+        return;
+    }
+    // A pulse is complete at the next rising edge: high from the last rise to the fall, period from rise to rise.
+    if (_dutyRiseUs != 0 && _dutyFallSeen) {
+        uint16_t head = _dutyHead;
+        uint16_t next = (uint16_t)((head + 1) % SPEED_DUTY_BUFFER_SIZE);
+        if (next == _dutyTail) {
+            _dutyOverruns++;
+        } else {
+            _dutySamples[head].highUs = _dutyFallUs - _dutyRiseUs;
+            _dutySamples[head].periodUs = nowUs - _dutyRiseUs;
+            _dutyHead = next;
+        }
+    }
+    _dutyRiseUs = nowUs;
+    _dutyFallSeen = false;
+#else
+    (void)rising;
+    (void)nowUs;
+#endif
+}
+
+void SpeedFeedback::drainDutySamples(float targetRpm) {
+#if CLOSED_LOOP_SPEED_ENABLE && SPEED_DUTY_TRACK_ENABLE
+    // Pulses are judged against the target speed, so chatter caught by a short fixed window never passes as a narrow pulse.
+    uint32_t expectedUs = 0;
+    if (targetRpm > 0.0f && _dutyPulsesPerRev > 0 && _cprState != CPR_DETECT_CAPTURING && _cprState != CPR_DETECT_ANALYSING) {
+        expectedUs = (uint32_t)(60000000.0f / (targetRpm * (float)_dutyPulsesPerRev));
+    }
+    uint16_t tail = _dutyTail;
+    uint16_t head = _dutyHead;
+    while (tail != head) {
+        // Pulses at no target speed are spin-up, coast or a hand-turned platter and are left out.
+        if (expectedUs != 0) _duty.addSample(_dutySamples[tail].highUs, _dutySamples[tail].periodUs, expectedUs);
+        tail = (uint16_t)((tail + 1) % SPEED_DUTY_BUFFER_SIZE);
+    }
+    _dutyTail = tail;
+
+    uint8_t warnings = _duty.getWarnings();
+    if (warnings != 0 && !_dutyWarningLogged) {
+        // Logged once per history; the live flags stay in the health status.
+        _dutyWarningLogged = true;
+        errorHandler.logEvent(ERR_SPEED_FEEDBACK, (warnings & PULSE_DUTY_WARN_MARGINAL) ?
+            "Tach duty near its limit; check sensor alignment and threshold" :
+            "Tach duty drifting; check strobe ring and sensor");
+    }
+#else
+    (void)targetRpm;
+#endif
+}
+
+bool SpeedFeedback::isSensorlessMode() const {
+#if SENSORLESS_SPEED_ENABLE
+    return _sensorMode == CLOSED_LOOP_SENSOR_SENSORLESS;
+#else
+    return false;
+#endif
+}
+
+#if SENSORLESS_SPEED_ENABLE
+bool SpeedFeedback::sensorlessTimerCallback(repeating_timer_t* timer) {
+    SpeedFeedback* self = (SpeedFeedback*)timer->user_data;
+    if (self) self->sampleSensorless();
+    return true;
+}
+
+void SpeedFeedback::sampleSensorless() {
+    if (!_configured || _sensorMode != CLOSED_LOOP_SENSOR_SENSORLESS) return;
+    uint32_t nowUs = time_us_32();
+    uint32_t drivePhase = waveform.getDrivePhase(nowUs);
+    // The ADC mux is shared with analogRead() callers, which mask interrupts around their own read; restore their selection afterwards.
+    uint previousInput = adc_get_selected_input();
+    adc_select_input(PIN_SENSORLESS_SENSE - 26);
+    uint16_t raw = adc_read();
+    adc_select_input(previousInput);
+
+    uint16_t head = _sensorlessHead;
+    uint16_t next = (uint16_t)((head + 1) % SENSORLESS_BUFFER_SIZE);
+    if (next == _sensorlessTail) {
+        _sensorlessOverruns++;
+        return;
+    }
+    _sensorlessSamples[head].raw = raw;
+    _sensorlessSamples[head].drivePhase = drivePhase;
+    _sensorlessSamples[head].timeUs = nowUs;
+    _sensorlessHead = next;
+}
+
+void SpeedFeedback::drainSensorlessSamples() {
+    if (!isSensorlessMode()) return;
+    uint16_t tail = _sensorlessTail;
+    uint16_t head = _sensorlessHead;
+    while (tail != head) {
+        const SensorlessSample& sample = _sensorlessSamples[tail];
+        uint32_t crossingsBefore = _sensorless.getCrossings();
+        uint32_t rejectedBefore = _sensorless.getRejectedCrossings();
+        _sensorless.addSample((float)sample.raw, sample.drivePhase, sample.timeUs);
+        tail = (uint16_t)((tail + 1) % SENSORLESS_BUFFER_SIZE);
+
+        if (_sensorless.getCrossings() == crossingsBefore) continue;
+        // Each rising crossing is one electrical cycle; it goes through the same counters as a tach edge so dropout and jitter reporting carry over.
+        _sensorlessCrossings++;
+        if (_sensorless.getRejectedCrossings() != rejectedBefore) {
+            _sensorlessRejected++;
+            noInterrupts();
+            _invalidTransitions++;
+            interrupts();
+            continue;
+        }
+        noInterrupts();
+        _lastRawDirection = SPEED_FEEDBACK_DIR_FORWARD;
+        _lastDirection = SPEED_FEEDBACK_DIR_FORWARD;
+        _count++;
+        recordAcceptedTransition(_sensorless.getLastCrossingUs());
+        interrupts();
+    }
+    _sensorlessTail = tail;
+}
+#endif
+
 bool SpeedFeedback::acceptsPulseEdge(bool previousA, bool currentA) const {
     // Pulse tachometer mode can count rising, falling, or both edges depending on the sensor and magnet/slot geometry.
     if (previousA == currentA) return false;
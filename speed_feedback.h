@@ -11,6 +11,18 @@
 
 #include <Arduino.h>
 #include "types.h"
+#include "tach_debounce.h"
+#include "rpm_estimator.h"
+#include "pulse_duty.h"
+#include "cpr_detect.h"
+#if SENSORLESS_SPEED_ENABLE
+#include "sensorless_speed.h"
+extern "C" {
+    #include "pico/stdlib.h"
+    #include "pico/time.h"
+    #include "hardware/adc.h"
+}
+#endif
 
 enum SpeedFeedbackDirection : int8_t {
     SPEED_FEEDBACK_DIR_UNKNOWN = 0,
@@ -18,6 +30,13 @@ enum SpeedFeedbackDirection : int8_t {
     SPEED_FEEDBACK_DIR_REVERSE = -1
 };
 
+// Edge counts while one speed was selected, kept since boot so speeds can be compared.
+struct SpeedFeedbackEdgeStats {
+    uint32_t accepted;
+    uint32_t debounced;
+    uint32_t invalid;
+};
+
 // Runtime tachometer/quadrature snapshot. ISR counters are copied into this struct so UI, serial, and web code can inspect sensor health safely.
 struct SpeedFeedbackStatus {
     bool configured;
@@ -49,9 +68,42 @@ struct SpeedFeedbackStatus {
     uint32_t lastPulseAgeMs;
     uint32_t sampleTimeMs;
     uint32_t sampleSequence;
+    uint32_t debounceUs;                 // Window in use now; follows the target speed when adaptive debounce is built in
+    uint32_t rejectedWindows;            // Feedback windows the outlier stage replaced
+    bool dutyTracked;                    // Pulse mode with duty tracking built in
+    uint32_t dutyOverruns;               // Duty samples dropped because Core 0 fell behind
+    PulseDutyStatus duty;
+    SpeedFeedbackEdgeStats speedEdges[3];
+};
+
+// Sensorless estimator snapshot. In sensorless mode the main status above is filled from the same crossings, so closed-loop code needs no changes.
+struct SensorlessSpeedStatus {
+    bool enabled;
+    bool active;
+    bool valid;
+    float electricalHz;
+    float driveHz;
+    float slipHz;
+    float phaseDegrees;  // Drive phase at the sensed rising crossing; includes any fixed sense-network shift
+    float amplitude;     // Tracked peak in ADC counts
+    uint32_t crossings;
+    uint32_t rejectedCrossings;
+    uint32_t overruns;   // Samples dropped because Core 0 fell a full queue behind
+};
+
+enum CountsPerRevDetectState : uint8_t {
+    CPR_DETECT_IDLE = 0,
+    CPR_DETECT_CAPTURING,
+    CPR_DETECT_ANALYSING,
+    CPR_DETECT_DONE,
+    CPR_DETECT_FAILED
 };
 
-// Temporary capture used by the guided setup workflow. It measures exactly one manual platter revolution and suggests counts/rev plus direction settings.
+/*
+ * Temporary capture used by the guided setup workflow. With the platter at rest
+ * it measures one manual revolution; while the motor runs at a steady speed it
+ * instead detects counts/rev from the repeat period of the edge intervals.
+ */
 struct SpeedFeedbackSetupStatus {
     bool active;
     bool pinAHigh;
@@ -66,6 +118,15 @@ struct SpeedFeedbackSetupStatus {
     bool suggestedReverseDirection;
     uint8_t suggestedSensorMode;
     uint8_t suggestedQuadratureMode;
+    bool autoDetect;
+    uint8_t autoState;                 // CountsPerRevDetectState
+    uint8_t autoProgressPercent;
+    uint16_t autoSamples;
+    uint16_t autoDetectedCountsPerRev; // Best candidate even when confidence is too low to suggest
+    float autoExpectedCountsPerRev;    // From commanded frequency, pulley ratio, and mean edge interval
+    float autoCorrelation;             // Normalised autocorrelation at the detected lag
+    float autoConfidence;              // 0..1; suggestedCountsPerRev is only set above the apply threshold
+    const char* autoMessage;
 };
 
 /*
@@ -81,11 +142,12 @@ public:
     void configure();
     void reset();
     void update(float targetRpm);
-    void beginSetupCapture();
+    void beginSetupCapture(float expectedRpm = 0.0f);
     void cancelSetupCapture();
 
     SpeedFeedbackStatus getStatus();
     SpeedFeedbackSetupStatus getSetupStatus();
+    SensorlessSpeedStatus getSensorlessStatus();
 
 private:
     // attachInterrupt() needs a static thunk; _instance routes it to the single global SpeedFeedback object.
@@ -96,16 +158,29 @@ private:
     void resetCounters();
     void resetMeasurements();
     void recordAcceptedTransition(uint32_t nowUs);
+    void updateDebounceWindow(float targetRpm);
+    void recordDutyEdge(bool rising, uint32_t nowUs);
+    void drainDutySamples(float targetRpm);
+    void updateEdgeStats(uint32_t accepted, uint32_t debounced, uint32_t invalid);
     bool acceptsPulseEdge(bool previousA, bool currentA) const;
     int8_t quadratureDelta(uint8_t previousState, uint8_t currentState) const;
+    void updateCountsPerRevDetect(uint32_t nowMs);
+    void finishCountsPerRevDetect();
+    void failCountsPerRevDetect(const char* message);
     bool shouldCountQuadratureStep(uint8_t previousState, uint8_t currentState) const;
+    bool isSensorlessMode() const;
+#if SENSORLESS_SPEED_ENABLE
+    static bool sensorlessTimerCallback(repeating_timer_t* timer);
+    void sampleSensorless();
+    void drainSensorlessSamples();
+#endif
 
     volatile bool _configured;
     volatile uint8_t _sensorMode;
     volatile uint8_t _pulseEdge;
     volatile uint8_t _quadratureMode;
     volatile bool _reverseDirection;
-    volatile uint16_t _debounceUs;
+    volatile uint32_t _debounceUs;
     volatile int32_t _count;
     volatile uint32_t _lastPulseUs;
     volatile uint32_t _lastAcceptedEdgeUs;
@@ -133,6 +208,37 @@ private:
     uint16_t _lockTimeMs;
     float _filterAlpha;
     float _lockToleranceRpm;
+    uint16_t _configuredDebounceUs;
+    RpmEstimator _estimator;
+    uint32_t _rejectedWindows;
+
+    /*
+     * Pulse duty tracking. The tach ISR times each rising and falling edge
+     * that passes the debounce and queues one high time and period per pulse;
+     * Core 0 drains the queue into the tracker from update(). The ISR only
+     * writes the head and Core 0 only writes the tail.
+     */
+    struct DutySample {
+        uint32_t highUs;
+        uint32_t periodUs;
+    };
+    PulseDutyTracker _duty;
+    DutySample _dutySamples[SPEED_DUTY_BUFFER_SIZE];
+    volatile uint16_t _dutyHead;
+    volatile uint16_t _dutyTail;
+    volatile uint32_t _dutyOverruns;
+    uint32_t _dutyRiseUs;
+    uint32_t _dutyFallUs;
+    bool _dutyFallSeen;
+    uint16_t _dutyPulsesPerRev;
+    bool _dutyWarningLogged;
+    uint8_t _pinChangesPerCount;
+
+    // Per-speed edge statistics, fed from counter deltas in update(); the baselines are the ISR counters already attributed.
+    SpeedFeedbackEdgeStats _speedEdges[3];
+    uint32_t _edgeBaseAccepted;
+    uint32_t _edgeBaseDebounced;
+    uint32_t _edgeBaseInvalid;
 
     int32_t _lastSampleCount;
     uint32_t _lastSampleMs;
@@ -152,6 +258,50 @@ private:
     uint32_t _setupStartInvalidTransitions;
     uint32_t _setupStartDebouncedTransitions;
     uint32_t _setupStartMs;
+
+#if CLOSED_LOOP_SPEED_ENABLE
+    /*
+     * Running counts/rev detection. The ISR fills the interval buffer once and
+     * then stops, so Core 0 can work through the autocorrelation a slice at a
+     * time without racing new edges. The result is copied out once the
+     * detector finishes.
+     */
+    volatile bool _cprCaptureActive;
+    volatile uint16_t _cprCaptureCount;
+    uint32_t _cprIntervals[CPR_DETECT_SAMPLES];
+    uint8_t _cprState;
+    uint32_t _cprStartMs;
+    float _cprExpectedRpm;
+    float _cprExpectedCounts;
+    uint16_t _cprSamples;
+    CprDetector _cprDetector;
+    uint16_t _cprDetectedCounts;
+    float _cprCorrelation;
+    float _cprConfidence;
+    const char* _cprMessage;
+#endif
+
+#if SENSORLESS_SPEED_ENABLE
+    /*
+     * The sampling timer ISR stamps each ADC reading with the drive phase and
+     * queues it; Core 0 drains the queue into the estimator from update(). The
+     * ISR only writes the head and Core 0 only writes the tail.
+     */
+    struct SensorlessSample {
+        uint16_t raw;
+        uint32_t drivePhase;
+        uint32_t timeUs;
+    };
+    SensorlessSpeedEstimator _sensorless;
+    repeating_timer_t _sensorlessTimer;
+    bool _sensorlessTimerRunning;
+    SensorlessSample _sensorlessSamples[SENSORLESS_BUFFER_SIZE];
+    volatile uint16_t _sensorlessHead;
+    volatile uint16_t _sensorlessTail;
+    volatile uint32_t _sensorlessOverruns;
+    uint32_t _sensorlessCrossings;
+    uint32_t _sensorlessRejected;
+#endif
 };
 
 extern SpeedFeedback speedFeedback;
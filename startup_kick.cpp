@@ -0,0 +1,142 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "startup_kick.h"
+#include <math.h>
+
+StartupKickTracker::StartupKickTracker() {
+    _params.pullInFraction = 0.95f;
+    _params.holdSec = 0.2f;
+    _params.slipFraction = 0.1f;
+    _params.feedbackLagSec = 0.0f;
+    _params.lockToleranceRpm = 0.05f;
+    _params.lockHoldSec = 0.5f;
+    _params.learnRate = 0.5f;
+    _params.rampGrowth = 1.25f;
+    _params.maxRampSec = 15.0f;
+    reset();
+}
+
+void StartupKickTracker::configure(const StartupKickParams& params) {
+    _params = params;
+    if (!(_params.pullInFraction > 0.0f) || _params.pullInFraction > 1.0f) _params.pullInFraction = 0.95f;
+    if (!(_params.holdSec >= 0.0f)) _params.holdSec = 0.0f;
+    if (!(_params.slipFraction > 0.0f)) _params.slipFraction = 0.1f;
+    if (!(_params.feedbackLagSec >= 0.0f)) _params.feedbackLagSec = 0.0f;
+    if (!(_params.lockToleranceRpm > 0.0f)) _params.lockToleranceRpm = 0.05f;
+    if (!(_params.lockHoldSec >= 0.0f)) _params.lockHoldSec = 0.0f;
+    if (!(_params.learnRate > 0.0f) || _params.learnRate > 1.0f) _params.learnRate = 1.0f;
+    if (!(_params.rampGrowth >= 1.0f)) _params.rampGrowth = 1.0f;
+    if (!(_params.maxRampSec > 0.0f)) _params.maxRampSec = 15.0f;
+}
+
+void StartupKickTracker::reset() {
+    _phase = KICK_PHASE_IDLE;
+    _kickEnd = KICK_END_NONE;
+    _kickRpm = 0.0f;
+    _targetRpm = 0.0f;
+    _candidateSec = -1.0f;
+    _lastSec = 0.0f;
+    _laggedExpectedRpm = -1.0f;
+    _pulledIn = false;
+    _pullInSec = 0.0f;
+    _kickSec = 0.0f;
+    _rampSec = 0.0f;
+    _rampSlipped = false;
+    _peakSlipRpm = 0.0f;
+    _timeToLockSec = 0.0f;
+}
+
+void StartupKickTracker::begin(float kickRpm, float targetRpm) {
+    reset();
+    _kickRpm = kickRpm > 0.0f ? kickRpm : 0.0f;
+    _targetRpm = targetRpm > 0.0f ? targetRpm : 0.0f;
+    _phase = _kickRpm > 0.0f ? KICK_PHASE_KICK : KICK_PHASE_SETTLE;
+}
+
+bool StartupKickTracker::update(float elapsedSec, float rpm, bool valid, float expectedRpm) {
+    if (!isTracking() || !isfinite(elapsedSec)) return false;
+    float dtSec = elapsedSec - _lastSec;
+    _lastSec = elapsedSec;
+    if (_phase == KICK_PHASE_RAMP && isfinite(expectedRpm)) {
+        // The lag runs on every sample, valid or not, so it stays in step with the measurement filter.
+        if (_laggedExpectedRpm < 0.0f) {
+            _laggedExpectedRpm = expectedRpm;
+        } else if (dtSec > 0.0f) {
+            _laggedExpectedRpm += (dtSec / (_params.feedbackLagSec + dtSec)) * (expectedRpm - _laggedExpectedRpm);
+        }
+    }
+    if (!valid || !isfinite(rpm)) {
+        // A platter too slow to produce pulses has not pulled in or locked, so any run of good samples starts again.
+        _candidateSec = -1.0f;
+        return false;
+    }
+
+    if (_phase == KICK_PHASE_KICK) {
+        if (_pulledIn) return false;
+        if (rpm < _kickRpm * _params.pullInFraction) {
+            _candidateSec = -1.0f;
+            return false;
+        }
+        if (_candidateSec < 0.0f) _candidateSec = elapsedSec;
+        if (elapsedSec - _candidateSec < _params.holdSec) return false;
+        // Pull-in is dated from the first sample of the run, not the end of the hold.
+        _pulledIn = true;
+        _pullInSec = _candidateSec;
+        _candidateSec = -1.0f;
+        return true;
+    }
+
+    if (_phase == KICK_PHASE_RAMP) {
+        if (_laggedExpectedRpm < 0.0f) return false;
+        float slip = fabsf(rpm - _laggedExpectedRpm);
+        if (slip > _peakSlipRpm) _peakSlipRpm = slip;
+        if (_laggedExpectedRpm > 0.0f && slip > _laggedExpectedRpm * _params.slipFraction) _rampSlipped = true;
+        return false;
+    }
+
+    if (fabsf(rpm - _targetRpm) > _params.lockToleranceRpm) {
+        _candidateSec = -1.0f;
+        return false;
+    }
+    if (_candidateSec < 0.0f) _candidateSec = elapsedSec;
+    if (elapsedSec - _candidateSec < _params.lockHoldSec) return false;
+    _timeToLockSec = _candidateSec;
+    _phase = KICK_PHASE_LOCKED;
+    return true;
+}
+
+void StartupKickTracker::endKick(float elapsedSec, StartupKickEnd reason, float rampSec) {
+    if (_phase != KICK_PHASE_KICK) return;
+    _kickEnd = reason;
+    _kickSec = elapsedSec > 0.0f ? elapsedSec : 0.0f;
+    _rampSec = rampSec > 0.0f ? rampSec : 0.0f;
+    _candidateSec = -1.0f;
+    _phase = _rampSec > 0.0f ? KICK_PHASE_RAMP : KICK_PHASE_SETTLE;
+}
+
+void StartupKickTracker::endRamp() {
+    if (_phase != KICK_PHASE_RAMP) return;
+    _candidateSec = -1.0f;
+    _phase = KICK_PHASE_SETTLE;
+}
+
+void StartupKickTracker::abandon() {
+    if (isTracking()) _phase = KICK_PHASE_IDLE;
+}
+
+float StartupKickTracker::learnedKickSec(float previousSec) const {
+    if (!_pulledIn) return previousSec;
+    if (!(previousSec > 0.0f)) return _pullInSec;
+    return previousSec + (_params.learnRate * (_pullInSec - previousSec));
+}
+
+float StartupKickTracker::learnedRampSec() const {
+    float rampSec = _rampSlipped ? _rampSec * _params.rampGrowth : _rampSec;
+    return rampSec > _params.maxRampSec ? _params.maxRampSec : rampSec;
+}
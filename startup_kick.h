@@ -0,0 +1,116 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef STARTUP_KICK_H
+#define STARTUP_KICK_H
+
+#include <stdint.h>
+
+/*
+ * Startup kick pull-in and time-to-lock tracking.
+ *
+ * The kick drives above the run frequency until the platter has pulled into
+ * synchronism with it, then ramps down carrying the platter to speed. A fixed
+ * kick time is too short for a cold bearing and wastes seconds on a warm one,
+ * so the tracker watches measured speed instead:
+ *
+ * - Kick: pulled in once the platter holds the pull-in share of the kick's
+ *   synchronous RPM for the hold time. The owner ends the kick there.
+ * - Ramp: the platter should follow the falling drive. Measured speed further
+ *   than the slip share from the expected speed marks the ramp as too fast.
+ *   The expected speed is put through the same lag as the measurement first,
+ *   so filter delay on a steep ramp is not mistaken for slip.
+ * - Settle: locked once the platter holds within the lock tolerance of the run
+ *   speed for the lock hold time. Time to lock runs from the start of drive.
+ *
+ * The learning helpers turn one start's results into next start's kick and
+ * ramp lengths: the kick follows pull-in times smoothly, a ramp that tracked
+ * is kept, and one that slipped is stretched.
+ *
+ * No Arduino headers are used so cold and warm starts can be simulated on a host.
+ */
+struct StartupKickParams {
+    float pullInFraction;    // Share of the kick's synchronous RPM that counts as pulled in
+    float holdSec;           // Time the platter must stay pulled in before the kick ends
+    float slipFraction;      // Ramp tracking error, as a share of the expected RPM, that counts as a slip
+    float feedbackLagSec;    // Smoothing lag of the measured speed, applied to the expected speed before comparing
+    float lockToleranceRpm;
+    float lockHoldSec;
+    float learnRate;         // Share of each new pull-in time taken into the learned kick
+    float rampGrowth;        // Stretch applied to a ramp that slipped
+    float maxRampSec;
+};
+
+enum StartupKickPhase : uint8_t {
+    KICK_PHASE_IDLE = 0,
+    KICK_PHASE_KICK,
+    KICK_PHASE_RAMP,
+    KICK_PHASE_SETTLE,
+    KICK_PHASE_LOCKED
+};
+
+enum StartupKickEnd : uint8_t {
+    KICK_END_NONE = 0,
+    KICK_END_PULL_IN,   // Feedback saw the platter pull in
+    KICK_END_LEARNED,   // No feedback; a length learned on earlier starts was used
+    KICK_END_TIMEOUT    // Configured kick time ran out first
+};
+
+class StartupKickTracker {
+public:
+    StartupKickTracker();
+
+    void configure(const StartupKickParams& params);
+    void reset();
+    // Starts tracking at the start of drive. kickRpm is zero when there is no kick, which goes straight to settling.
+    void begin(float kickRpm, float targetRpm);
+    // Feeds one speed sample. elapsedSec runs from the start of drive; expectedRpm is the synchronous speed of the drive now.
+    // Returns true on the sample where the kick pulls in or the platter locks.
+    bool update(float elapsedSec, float rpm, bool valid, float expectedRpm);
+    // The owner ended the kick; rampSec of zero skips straight to settling.
+    void endKick(float elapsedSec, StartupKickEnd reason, float rampSec);
+    void endRamp();
+    // Stops tracking without a result, for a stop or speed change before lock.
+    void abandon();
+
+    StartupKickPhase getPhase() const { return _phase; }
+    bool isTracking() const { return _phase != KICK_PHASE_IDLE && _phase != KICK_PHASE_LOCKED; }
+    bool isPulledIn() const { return _pulledIn; }
+    float getPullInSec() const { return _pullInSec; }
+    StartupKickEnd getKickEnd() const { return _kickEnd; }
+    float getKickSec() const { return _kickSec; }
+    float getRampSec() const { return _rampSec; }
+    bool rampSlipped() const { return _rampSlipped; }
+    float getPeakSlipRpm() const { return _peakSlipRpm; }
+    bool isLocked() const { return _phase == KICK_PHASE_LOCKED; }
+    float getTimeToLockSec() const { return _timeToLockSec; }
+
+    // Next start's kick from the learned length and this start's pull-in; unchanged if the kick did not pull in.
+    float learnedKickSec(float previousSec) const;
+    // Next start's ramp from the ramp just used: kept if it tracked, stretched if it slipped.
+    float learnedRampSec() const;
+
+private:
+    StartupKickParams _params;
+    StartupKickPhase _phase;
+    StartupKickEnd _kickEnd;
+    float _kickRpm;
+    float _targetRpm;
+    float _candidateSec;
+    float _lastSec;
+    float _laggedExpectedRpm;
+    bool _pulledIn;
+    float _pullInSec;
+    float _kickSec;
+    float _rampSec;
+    bool _rampSlipped;
+    float _peakSlipRpm;
+    float _timeToLockSec;
+};
+
+#endif // STARTUP_KICK_H
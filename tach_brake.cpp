@@ -0,0 +1,175 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "tach_brake.h"
+#include <math.h>
+#include <string.h>
+
+static const float TACH_BRAKE_RISE_RATIO = 1.15f;
+
+TachBrakeEstimator::TachBrakeEstimator() {
+    memset(&_params, 0, sizeof(_params));
+    begin(_params, 0.0f, 0, 0, 0);
+}
+
+void TachBrakeEstimator::begin(const TachBrakeParams& params, float startRpm, int32_t count, uint32_t edgeMs,
+                               uint32_t startMs) {
+    _params = params;
+    _taperRpm = startRpm * (_params.taperPercent / 100.0f);
+    _minShare = _params.minDrivePercent / 100.0f;
+    _rpm = startRpm;
+    _decelFullRpmPerSec = 0.0f;
+    _windowCount = count;
+    _windowEdgeMs = edgeMs;
+    _startRpm = startRpm;
+    _startMs = startMs;
+    _anchorRpm = startRpm;
+    _anchorMs = (float)startMs;
+    _lowestRpm = startRpm;
+    _risen = false;
+    _extrapolateRpm = startRpm;
+    _extrapolateMs = (float)edgeMs;
+    _shareSum = 0.0f;
+    _shareMs = 0.0f;
+    _lastUpdateMs = startMs;
+    _updated = false;
+}
+
+void TachBrakeEstimator::addSample(int32_t count, uint32_t edgeMs) {
+    if (!(_params.countsPerRev > 0.0f)) return;
+    int32_t counts = count - _windowCount;
+    if (counts < 0) counts = -counts;
+    uint32_t windowMs = edgeMs - _windowEdgeMs;
+    if (counts == 0 || windowMs == 0 || windowMs < _params.minWindowMs || (int32_t)windowMs < 0) return;
+
+    if ((int32_t)(_windowEdgeMs - _startMs) < 0) {
+        addFirstWindow(counts, edgeMs);
+        _windowCount = count;
+        _windowEdgeMs = edgeMs;
+        return;
+    }
+
+    // Edge to edge, the mean speed of a steady deceleration is the speed at the middle of the window.
+    float windowRpm = ((float)counts / _params.countsPerRev) * (60000.0f / (float)windowMs);
+    float midMs = (float)_windowEdgeMs + ((float)windowMs * 0.5f);
+    if (midMs - _anchorMs >= (float)_params.slopeMs && _shareMs > 0.0f) {
+        // Plugging torque follows the drive share, so the deceleration is scaled back to full drive.
+        float meanShare = _shareSum / _shareMs;
+        float decel = (_anchorRpm - windowRpm) * 1000.0f / (midMs - _anchorMs);
+        _decelFullRpmPerSec = meanShare > 0.0f && decel > 0.0f ? decel / meanShare : 0.0f;
+        _anchorRpm = windowRpm;
+        _anchorMs = midMs;
+        _shareSum = 0.0f;
+        _shareMs = 0.0f;
+    }
+    // Reverse drive only slows a forward platter, so a faster window is the platter turning backwards.
+    if (windowRpm > _lowestRpm * TACH_BRAKE_RISE_RATIO) _risen = true;
+    if (windowRpm < _lowestRpm) _lowestRpm = windowRpm;
+    _extrapolateRpm = windowRpm;
+    _extrapolateMs = midMs;
+    _windowCount = count;
+    _windowEdgeMs = edgeMs;
+}
+
+void TachBrakeEstimator::addFirstWindow(int32_t counts, uint32_t edgeMs) {
+    // The first window began at the running speed before braking, so one count already fixes the
+    // deceleration: the rotation since braking began falls short of the steady rotation.
+    float brakedMs = (float)(edgeMs - _startMs);
+    if (brakedMs < (float)_params.slopeMs) return;
+    float revs = (float)counts / _params.countsPerRev;
+    float steadyRevs = _startRpm * (float)(edgeMs - _windowEdgeMs) / 60000.0f;
+    float decel = 2.0f * (steadyRevs - revs) * 60000000.0f / (brakedMs * brakedMs);
+    if (!(decel > 0.0f)) return;
+    float edgeRpm = _startRpm - (decel * brakedMs / 1000.0f);
+    if (edgeRpm <= 0.0f) {
+        // Too little rotation for a steady stop to still be turning forward: the count came after the zero crossing.
+        _risen = true;
+        return;
+    }
+    _decelFullRpmPerSec = decel;
+    _anchorRpm = edgeRpm;
+    _anchorMs = (float)edgeMs;
+    _extrapolateRpm = edgeRpm;
+    _extrapolateMs = (float)edgeMs;
+    _lowestRpm = edgeRpm;
+    _shareSum = 0.0f;
+    _shareMs = 0.0f;
+}
+
+float TachBrakeEstimator::shareAt(float rpm) const {
+    float share = _taperRpm > 0.0f ? rpm / _taperRpm : 1.0f;
+    if (share > 1.0f) share = 1.0f;
+    if (share < _minShare) share = _minShare;
+    return share;
+}
+
+float TachBrakeEstimator::extrapolate(float rpm, float seconds) const {
+    // Full drive down to the taper speed, an exponential decay while drive follows speed, then the minimum drive to zero.
+    float d = _decelFullRpmPerSec;
+    if (rpm > _taperRpm) {
+        float toTaper = (rpm - _taperRpm) / d;
+        if (seconds <= toTaper) return rpm - (d * seconds);
+        seconds -= toTaper;
+        rpm = _taperRpm;
+    }
+    float floorRpm = _taperRpm * _minShare;
+    if (rpm > floorRpm && _taperRpm > 0.0f) {
+        float tau = _taperRpm / d;
+        float toFloor = tau * logf(rpm / floorRpm);
+        if (seconds <= toFloor) return rpm * expf(-seconds / tau);
+        seconds -= toFloor;
+        rpm = floorRpm;
+    }
+    return rpm - (d * _minShare * seconds);
+}
+
+TachBrakeDecision TachBrakeEstimator::update(uint32_t nowMs, uint32_t lastPulseAgeMs) {
+    if (!(_params.countsPerRev > 0.0f)) return TACH_BRAKE_STANDSTILL;
+
+    if (_updated) {
+        float stepMs = (float)(nowMs - _lastUpdateMs);
+        _shareSum += getDriveShare() * stepMs;
+        _shareMs += stepMs;
+    }
+    _lastUpdateMs = nowMs;
+    _updated = true;
+
+    if (_risen) return TACH_BRAKE_REVERSED;
+
+    _rpm = _extrapolateRpm;
+    if (_decelFullRpmPerSec > 0.0f) {
+        float sinceMs = (float)nowMs - _extrapolateMs;
+        if (sinceMs > 0.0f) _rpm = extrapolate(_extrapolateRpm, sinceMs / 1000.0f);
+        if (_rpm <= 0.0f) {
+            _rpm = 0.0f;
+            return TACH_BRAKE_PREDICTED;
+        }
+    }
+    // No count for this long means the platter cannot be turning faster than one count per that interval.
+    if (lastPulseAgeMs > 0) {
+        float boundRpm = 60000.0f / (_params.countsPerRev * (float)lastPulseAgeMs);
+        if (boundRpm < _rpm) _rpm = boundRpm;
+    }
+    if (_rpm <= _params.standstillRpm) return TACH_BRAKE_STANDSTILL;
+
+    // By the next update the platter would already be turning backwards.
+    if (_decelFullRpmPerSec > 0.0f && extrapolate(_rpm, (float)_params.updateMs / 1000.0f) <= 0.0f) {
+        return TACH_BRAKE_PREDICTED;
+    }
+
+    if (_taperRpm > 0.0f && lastPulseAgeMs > 0) {
+        float gapMs = 60000.0f / (_params.countsPerRev * _taperRpm);
+        if (gapMs < (float)_params.minGapMs) gapMs = (float)_params.minGapMs;
+        if ((float)lastPulseAgeMs >= gapMs) return TACH_BRAKE_NO_PULSE;
+    }
+    return TACH_BRAKE_CONTINUE;
+}
+
+float TachBrakeEstimator::getDriveShare() const {
+    return shareAt(_rpm);
+}
@@ -0,0 +1,109 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef TACH_BRAKE_H
+#define TACH_BRAKE_H
+
+#include <stdint.h>
+
+/*
+ * Stop detection for tach-guided braking.
+ *
+ * A reversed field keeps pushing after the platter reaches zero, so drive has
+ * to come off at the stop, not once the sensor has proved it. A pulse sensor
+ * counts reverse rotation as readily as forward rotation, and a coarse one
+ * cannot resolve a low standstill speed in any useful time. At 1 count/rev,
+ * a 0.5 RPM bound takes two minutes without a pulse. Drive is therefore cut
+ * on whichever comes first:
+ *
+ * - Standstill: measured speed at the standstill threshold.
+ * - Predicted: at the measured deceleration the platter stops within one
+ *   update interval, so by the next chance to act it would be reversing.
+ * - No pulse: no count for the interval a platter at the taper speed would
+ *   take between counts, or minGapMs when that is shorter. A slower platter
+ *   is close to its stop under the reverse torque of the taper region.
+ *
+ * - Reversed: a window faster than the slowest one so far. Reverse drive
+ *   only slows a forward platter, so the rise is the platter turning back.
+ *   The same holds when the first count after braking began came too late
+ *   for a steady stop to still be turning forward.
+ *
+ * Speed comes from windows running edge to edge, so count quantisation does
+ * not enter it. The first window starts at the running speed before braking
+ * and fixes the deceleration from a single count. Later decelerations are
+ * taken across windows at least slopeMs apart and scaled to full drive by
+ * the mean drive share over that span. Between windows, speed
+ * is extrapolated through the full, tapering and minimum drive regions, and
+ * capped by the time since the last count.
+ *
+ * No Arduino headers are used so coast and braking profiles can be replayed on a host.
+ */
+enum TachBrakeDecision : uint8_t {
+    TACH_BRAKE_CONTINUE,
+    TACH_BRAKE_STANDSTILL,
+    TACH_BRAKE_PREDICTED,
+    TACH_BRAKE_NO_PULSE,
+    TACH_BRAKE_REVERSED
+};
+
+struct TachBrakeParams {
+    float countsPerRev;
+    float standstillRpm;    // Measured speed treated as stopped
+    float taperPercent;     // Share of the starting speed below which drive tapers
+    float minDrivePercent;  // Smallest share of the drive envelope while still turning
+    uint32_t updateMs;      // Interval between speed samples
+    uint32_t slopeMs;       // Shortest span a deceleration is measured over
+    uint32_t minGapMs;      // Shortest count gap treated as a stop
+    uint32_t minWindowMs;   // Shortest edge-to-edge window, so edge timing jitter stays small against it
+};
+
+class TachBrakeEstimator {
+public:
+    TachBrakeEstimator();
+
+    // count is the feedback count total, edgeMs the time of the count that reached it and startMs
+    // the time braking began.
+    void begin(const TachBrakeParams& params, float startRpm, int32_t count, uint32_t edgeMs, uint32_t startMs);
+    void addSample(int32_t count, uint32_t edgeMs);
+    // lastPulseAgeMs is the time since the last count, or 0 when unknown.
+    TachBrakeDecision update(uint32_t nowMs, uint32_t lastPulseAgeMs);
+
+    float getRpm() const { return _rpm; }
+    float getTaperRpm() const { return _taperRpm; }
+    // Deceleration at full drive in RPM/s, or 0 until one has been measured.
+    float getDecelRpmPerSec() const { return _decelFullRpmPerSec; }
+    // Share of the drive envelope: full above the taper speed, then in proportion to speed.
+    float getDriveShare() const;
+
+private:
+    void addFirstWindow(int32_t counts, uint32_t edgeMs);
+    float shareAt(float rpm) const;
+    float extrapolate(float rpm, float seconds) const;
+
+    TachBrakeParams _params;
+    float _taperRpm;
+    float _minShare;
+    float _rpm;
+    float _decelFullRpmPerSec;
+    int32_t _windowCount;
+    uint32_t _windowEdgeMs;
+    float _startRpm;
+    uint32_t _startMs;
+    float _anchorRpm;
+    float _anchorMs;
+    float _lowestRpm;
+    bool _risen;
+    float _extrapolateRpm;
+    float _extrapolateMs;
+    float _shareSum;
+    float _shareMs;
+    uint32_t _lastUpdateMs;
+    bool _updated;
+};
+
+#endif // TACH_BRAKE_H
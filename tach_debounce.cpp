@@ -0,0 +1,53 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "tach_debounce.h"
+#include <math.h>
+
+// Stored enum values from types.h, repeated here so the module stays free of Arduino headers.
+static const uint8_t SENSOR_PULSE = 0;
+static const uint8_t SENSOR_QUADRATURE = 1;
+static const uint8_t EDGE_CHANGE = 2;
+static const uint8_t QUAD_X1 = 0;
+static const uint8_t QUAD_X2 = 1;
+
+uint8_t tachPinChangesPerCount(uint8_t sensorMode, uint8_t pulseEdge, uint8_t quadratureMode) {
+    if (sensorMode == SENSOR_PULSE) return pulseEdge == EDGE_CHANGE ? 1 : 2;
+    if (sensorMode == SENSOR_QUADRATURE) {
+        if (quadratureMode == QUAD_X1) return 4;
+        if (quadratureMode == QUAD_X2) return 2;
+        return 1;
+    }
+    // Sensorless crossings do not come through the pin interrupt.
+    return 0;
+}
+
+uint32_t tachDebounceWindowUs(const TachDebounceParams& params, uint32_t configuredUs, float targetRpm,
+                              uint16_t countsPerRev, uint8_t pinChangesPerCount, float pulseDuty) {
+    if (!(targetRpm > 0.0f) || !isfinite(targetRpm) || countsPerRev == 0 || pinChangesPerCount == 0) return configuredUs;
+    float intervalUs = 60000000.0f / (targetRpm * (float)countsPerRev * (float)pinChangesPerCount);
+    if (pulseDuty > 0.0f && pulseDuty < 1.0f) {
+        // A pulse has two pin changes per period; the even spacing above gives each side half of it.
+        float shorter = pulseDuty < 0.5f ? pulseDuty : 1.0f - pulseDuty;
+        intervalUs *= 2.0f * shorter;
+    }
+    float window = intervalUs * params.periodFraction;
+    if (window < (float)configuredUs) window = (float)configuredUs;
+    float ceiling = intervalUs * params.maxFraction;
+    if (window > ceiling) window = ceiling;
+    // Above a second the tach is too coarse to debounce by time anyway; the cap only keeps the conversion in range.
+    if (window > 1000000.0f) window = 1000000.0f;
+    return (uint32_t)window;
+}
+
+TachEdgeAction tachDebounceEdge(uint32_t windowUs, uint32_t windowStartUs, uint32_t nowUs, uint8_t previousPins,
+                                uint8_t pins) {
+    // Unsigned difference, so the window holds across the micros() wrap.
+    if (windowUs > 0 && (uint32_t)(nowUs - windowStartUs) < windowUs) return TACH_EDGE_DEBOUNCED;
+    return pins == previousPins ? TACH_EDGE_UNCHANGED : TACH_EDGE_PASSED;
+}
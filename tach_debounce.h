@@ -0,0 +1,72 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef TACH_DEBOUNCE_H
+#define TACH_DEBOUNCE_H
+
+#include <stdint.h>
+
+/*
+ * Speed-tracking debounce window for the tachometer input.
+ *
+ * After an accepted edge, pin changes inside the debounce window are
+ * ignored. A fixed window cannot suit every speed: long enough to hide the
+ * chatter of a slow optical edge at 33⅓, it can swallow real edges of a
+ * fine encoder at 78, and each swallowed edge biases RPM low. A swallowed
+ * pin change is worse than a lost count, because the ISR's idea of the pin
+ * state then goes stale and the next real edge is misread too.
+ *
+ * So the window follows the expected time between pin changes at the target
+ * speed. That is the counted-edge interval divided by the pin changes each
+ * count spans: two for a pulse sensor counting one edge, one for every edge
+ * or quadrature X4, two for X2 and four for X1.
+ *
+ * - The window is a share of that interval, but never shorter than the
+ *   configured debounce, which stays the floor for electrical bounce.
+ * - It is also never longer than a larger share of the interval, so even the
+ *   configured value cannot reach the next real edge.
+ * - With no target speed, or no usable counts/rev, the configured value is
+ *   used unchanged.
+ *
+ * Evenly spaced pin changes are assumed unless the caller knows a pulse
+ * sensor's duty. A narrow pulse puts its two edges much closer than half a
+ * period, and the window is then taken from the shorter side.
+ *
+ * Each pin change that gets past the window restarts it, counted or not,
+ * since the window is sized from the time between pin changes and the
+ * bounce of an uncounted edge has to be held off too. Changes dropped inside
+ * the window do not restart it, so chatter cannot hold it open forever.
+ *
+ * No Arduino headers are used so synthetic chattering edge streams can be run through it on a host.
+ */
+// What the ISR makes of one pin change.
+enum TachEdgeAction : uint8_t {
+    TACH_EDGE_DEBOUNCED = 0, // Inside the window: dropped, and the pin state is left as it was
+    TACH_EDGE_UNCHANGED = 1, // Past the window, but the pins read back as last seen: nothing to decode
+    TACH_EDGE_PASSED = 2     // Past the window and the pins moved: decode it and restart the window from now
+};
+
+struct TachDebounceParams {
+    float periodFraction; // Share of the expected pin-change interval used as the window
+    float maxFraction;    // Share of the interval no window may reach, the configured one included
+};
+
+// Pin changes per counted edge. The arguments take the stored ClosedLoopSensorMode, ClosedLoopPulseEdge and ClosedLoopQuadratureMode values.
+uint8_t tachPinChangesPerCount(uint8_t sensorMode, uint8_t pulseEdge, uint8_t quadratureMode);
+
+// Debounce window in microseconds for a target platter speed, or configuredUs when the speed or scale is unknown.
+// pulseDuty is a pulse sensor's measured high share of each period, or 0 to assume evenly spaced pin changes.
+uint32_t tachDebounceWindowUs(const TachDebounceParams& params, uint32_t configuredUs, float targetRpm,
+                              uint16_t countsPerRev, uint8_t pinChangesPerCount, float pulseDuty = 0.0f);
+
+// Per pin-change decision for the window restarted at windowStartUs. previousPins and pins are the watched pin state
+// last seen and read now: A for a pulse sensor, A and B for quadrature.
+TachEdgeAction tachDebounceEdge(uint32_t windowUs, uint32_t windowStartUs, uint32_t nowUs, uint8_t previousPins,
+                                uint8_t pins);
+
+#endif // TACH_DEBOUNCE_H
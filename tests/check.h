@@ -0,0 +1,41 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Minimal checks for the host tests. Unlike assert() they stay active in
+ * release builds, and a failure prints the location and values before the
+ * test exits non-zero for ctest.
+ */
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                             \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                  \
+    do {                                                                         \
+        double checkActual = (double)(actual);                                   \
+        double checkExpected = (double)(expected);                               \
+        if (!(fabs(checkActual - checkExpected) <= (double)(tolerance))) {       \
+            fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s, %s) failed: %g vs %g\n",  \
+                    __FILE__, __LINE__, #actual, #expected, #tolerance,          \
+                    checkActual, checkExpected);                                 \
+            exit(1);                                                             \
+        }                                                                        \
+    } while (0)
+
+#endif // TESTS_CHECK_H
@@ -0,0 +1,38 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef TESTS_DDS_FIXTURE_H
+#define TESTS_DDS_FIXTURE_H
+
+#include <math.h>
+#include <stdint.h>
+#include "dds_increment.h"
+
+// The PWM clock the DDS tests run against, and the exact phase they measure it by. The counts mirror waveform.cpp.
+
+static const uint32_t PERIOD_COUNTS = 1024;  // PWM_WRAP_VALUE + 1
+static const uint32_t BLOCK_UNIT = 16;       // DMA_BLOCK_UNIT
+
+// The divider setupPWM programs for a 50 kHz carrier.
+static inline DdsClock clockFor(uint32_t clockHz) {
+    DdsClock clock;
+    clock.clockHz = clockHz;
+    clock.divider16 = (uint16_t)lround((double)clockHz * 16.0 / (50000.0 * PERIOD_COUNTS));
+    clock.periodCounts = PERIOD_COUNTS;
+    return clock;
+}
+
+// Exact phase after n samples of numerator/denominator Hz, in 2^64 units per cycle, rounded down.
+static inline uint64_t exactPhase(uint64_t n, uint64_t numerator, uint64_t denominator, const DdsClock& clock) {
+    unsigned __int128 top = (unsigned __int128)numerator * clock.divider16 * clock.periodCounts;
+    unsigned __int128 bottom = (unsigned __int128)denominator * clock.clockHz * 16u;
+    unsigned __int128 remainder = ((unsigned __int128)n * top) % bottom;
+    return (uint64_t)((remainder << 64) / bottom);
+}
+
+#endif
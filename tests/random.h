@@ -0,0 +1,31 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef TESTS_RANDOM_H
+#define TESTS_RANDOM_H
+
+#include <math.h>
+#include <stdint.h>
+
+/*
+ * Seeded generator for the host tests' synthetic signals. A plain LCG keeps
+ * every run, and so every figure a test prints, the same on any host.
+ * Initialise with a seed: Random rng = {1};
+ */
+struct Random {
+    uint32_t state;
+    double uniform() {
+        state = state * 1664525u + 1013904223u;
+        return ((state >> 8) + 0.5) / 16777216.0;
+    }
+    double gaussian() {
+        return sqrt(-2.0 * log(uniform())) * cos(6.283185307179586 * uniform());
+    }
+};
+
+#endif // TESTS_RANDOM_H
@@ -0,0 +1,19 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Host stand-in for the Arduino core: just enough for types.h and config.h to compile in the host tests.
+
+#ifndef TESTS_STUB_ARDUINO_H
+#define TESTS_STUB_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#endif // TESTS_STUB_ARDUINO_H
@@ -0,0 +1,94 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// The speed loop closed around a belt-drive platter with a lightly damped belt resonance, with and without the notch.
+
+#include "check.h"
+#include "adaptive_notch.h"
+
+struct LoopResult {
+    double errorRms;  // Over the last third of the run
+    float centreHz;
+    bool engaged;
+};
+
+// Motor speed follows drive frequency at rpmPerHz; the platter follows the motor through a second-order belt
+// resonance at resonanceHz with damping ratio zeta. A deterministic pseudo-random drag torque excites it, and a PI
+// loop corrects drive frequency at sampleHz as the firmware does.
+static LoopResult runLoop(double resonanceHz, double zeta, bool notchEnabled, double seconds = 300.0) {
+    const double rpmPerHz = 0.6667, targetRpm = 33.3333, baseHz = 50.0;
+    const double kp = 0.08, ki = 0.02, sampleHz = 10.0, dt = 0.001;
+    AdaptiveNotchParams params = {(float)sampleHz, 0.3f, 0.3f, 4.0f, 0.02f, 2.0f};
+    AdaptiveNotchBank notch;
+    notch.configure(params, 1);
+    notch.resetFrequency();
+
+    const double wn = 6.283185307 * resonanceHz;
+    double platter = targetRpm, platterRate = 0.0, correction = 0.0, integral = 0.0;
+    uint32_t noise = 12345;
+    double drag = 0.0, sumSq = 0.0;
+    long samples = 0;
+    long stepsPerSample = (long)(1.0 / (sampleHz * dt));
+    long steps = (long)(seconds / dt);
+    for (long step = 0; step < steps; step++) {
+        if (step % stepsPerSample == 0) {
+            double error = targetRpm - platter;
+            integral += ki * error / sampleHz;
+            double requested = (kp * error) + integral;
+            if (notchEnabled) {
+                notch.track((float)error);
+                requested = notch.apply((float)requested);
+            }
+            correction = requested;
+            if (step * 3 >= steps * 2) {
+                sumSq += error * error;
+                samples++;
+            }
+        }
+        // Drag changes every 50 ms, so the disturbance is broadband across the loop's range.
+        if (step % 50 == 0) {
+            noise = (noise * 1103515245u) + 12345u;
+            drag = (((double)((noise >> 16) & 0x7fff) / 32767.0) - 0.5) * 2.0;
+        }
+        double motor = rpmPerHz * (baseHz + correction);
+        double accel = (wn * wn * (motor - platter)) - (2.0 * zeta * wn * platterRate) + (drag * 40.0);
+        platterRate += accel * dt;
+        platter += platterRate * dt;
+    }
+    LoopResult result;
+    result.errorRms = sqrt(sumSq / (double)(samples > 0 ? samples : 1));
+    result.centreHz = notch.getStage(0).getCentreHz();
+    result.engaged = notch.getStage(0).isEngaged();
+    return result;
+}
+
+static void testTracksBeltResonance() {
+    // Resonances across the default 0.3-4 Hz search range: the centre settles on each and the loop rings less.
+    const double resonances[] = {0.8, 1.2, 2.0, 3.0};
+    for (double hz : resonances) {
+        LoopResult off = runLoop(hz, 0.03, false);
+        LoopResult on = runLoop(hz, 0.03, true);
+        CHECK(on.engaged);
+        CHECK_NEAR(on.centreHz, hz, 0.1);
+        CHECK(on.errorRms < off.errorRms * 0.9);
+    }
+}
+
+static void testStiffDriveLeftAlone() {
+    // A direct-drive platter has no resonance in range, so the notch never engages or changes the loop.
+    LoopResult off = runLoop(20.0, 0.7, false);
+    LoopResult on = runLoop(20.0, 0.7, true);
+    CHECK(!on.engaged);
+    CHECK_NEAR(on.errorRms, off.errorRms, off.errorRms * 0.05);
+}
+
+int main() {
+    testTracksBeltResonance();
+    testStiffDriveLeftAlone();
+    return 0;
+}
@@ -0,0 +1,210 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Base-frequency learning against a synthetic deck: convergence, step and total bounds, rollback and the shared ratio.
+
+#include "check.h"
+#include "base_learn.h"
+#include "random.h"
+
+static const float DECK_RATIO = 0.66666f;   // Platter RPM per drive hertz of the synthetic deck
+static const float TARGET_RPM[3] = {33.3333f, 45.0f, 78.0f};
+
+static BaseLearnParams learnParams() {
+    BaseLearnParams params;
+    params.forget = 0.9f;
+    params.minWeight = 3.0f;
+    params.confidenceFraction = 500e-6f;
+    params.maxStepFraction = 0.005f;
+    params.maxTotalFraction = 0.03f;
+    params.rollbackMarginHz = 0.02f;
+    return params;
+}
+
+// A full-length locked session at zero pitch: the loop corrects the base to what the deck needs, give or take noise.
+static BaseLearnSession session(uint8_t speed, float baseHz, float ratio, float noiseHz, Random& rng) {
+    BaseLearnSession s;
+    s.targetRpm = TARGET_RPM[speed];
+    s.openLoopHz = baseHz;
+    s.correctionHz = (TARGET_RPM[speed] / ratio) - baseHz + (float)(noiseHz * rng.gaussian());
+    s.weight = 1.0f;
+    s.baseHz = baseHz;
+    s.minHz = baseHz * 0.5f;
+    s.maxHz = baseHz * 2.0f;
+    return s;
+}
+
+static void clearAll(BaseLearnSpeed speeds[3]) {
+    for (uint8_t i = 0; i < 3; i++) baseLearnReset(speeds[i]);
+}
+
+static void testConvergesInBoundedSteps() {
+    BaseLearnParams params = learnParams();
+    BaseLearnSpeed speeds[3];
+    clearAll(speeds);
+    Random rng = {11};
+    float baseHz = 50.75f;
+    int steps = 0, rollbacks = 0;
+    float largestStep = 0.0f;
+    for (int n = 0; n < 40; n++) {
+        BaseLearnResult r = baseLearnSession(speeds, 0, session(0, baseHz, DECK_RATIO, 0.003f, rng), params);
+        if (r.action == BASE_LEARN_STEP) {
+            steps++;
+            float step = fabsf(r.baseHz - baseHz) / baseHz;
+            if (step > largestStep) largestStep = step;
+        }
+        if (r.action == BASE_LEARN_ROLLBACK) rollbacks++;
+        baseHz = r.baseHz;
+    }
+    float idealHz = TARGET_RPM[0] / DECK_RATIO;
+    CHECK_NEAR(baseHz, idealHz, 0.005);
+    CHECK(steps >= 3);
+    CHECK(largestStep <= 0.005f + 1e-6f);
+    CHECK(rollbacks == 0);
+}
+
+static void testTotalAndFrequencyLimits() {
+    BaseLearnParams params = learnParams();
+    BaseLearnSpeed speeds[3];
+    clearAll(speeds);
+    Random rng = {12};
+    // The deck wants 10% more than the user's base: learning stops 3% out from it.
+    float baseHz = 50.0f;
+    float ratio = TARGET_RPM[0] / 55.0f;
+    bool bounded = false;
+    for (int n = 0; n < 60; n++) {
+        BaseLearnResult r = baseLearnSession(speeds, 0, session(0, baseHz, ratio, 0.003f, rng), params);
+        if (r.action == BASE_LEARN_STEP && r.bounded) bounded = true;
+        CHECK(r.baseHz <= 51.5f + 1e-3f);
+        baseHz = r.baseHz;
+    }
+    CHECK(bounded);
+    CHECK_NEAR(baseHz, 51.5, 1e-3);
+
+    // The speed's own frequency limit is tighter than the total here.
+    clearAll(speeds);
+    baseHz = 50.0f;
+    for (int n = 0; n < 60; n++) {
+        BaseLearnSession s = session(0, baseHz, ratio, 0.003f, rng);
+        s.maxHz = 50.4f;
+        baseHz = baseLearnSession(speeds, 0, s, params).baseHz;
+        CHECK(baseHz <= 50.4f + 1e-4f);
+    }
+    CHECK_NEAR(baseHz, 50.4, 1e-4);
+}
+
+static void testRollbackAfterDeckChange() {
+    BaseLearnParams params = learnParams();
+    BaseLearnSpeed speeds[3];
+    clearAll(speeds);
+    Random rng = {13};
+    float baseHz = 50.75f;
+    BaseLearnResult r;
+    do {
+        r = baseLearnSession(speeds, 0, session(0, baseHz, DECK_RATIO, 0.003f, rng), params);
+        baseHz = r.baseHz;
+    } while (r.action != BASE_LEARN_STEP);
+    float steppedFrom = speeds[0].previousHz;
+    CHECK(steppedFrom > baseHz);
+    // The belt is swapped before the next session: the step now needs more correction, not less.
+    r = baseLearnSession(speeds, 0, session(0, baseHz, TARGET_RPM[0] / 51.5f, 0.003f, rng), params);
+    CHECK(r.action == BASE_LEARN_ROLLBACK);
+    CHECK_NEAR(r.baseHz, steppedFrom, 1e-6);
+    CHECK(speeds[0].weight == 0.0f);
+    CHECK(baseLearnHalfWidth(speeds[0]) < 0.0f);
+    CHECK(speeds[0].probationAbsHz == 0.0f);
+    // The rollback is not judged again: the next session just starts a new estimate.
+    r = baseLearnSession(speeds, 0, session(0, r.baseHz, TARGET_RPM[0] / 51.5f, 0.003f, rng), params);
+    CHECK(r.action == BASE_LEARN_LEARNING);
+}
+
+static void testUserChangeReanchors() {
+    BaseLearnParams params = learnParams();
+    BaseLearnSpeed speeds[3];
+    clearAll(speeds);
+    Random rng = {14};
+    float baseHz = 50.75f;
+    BaseLearnResult r;
+    do {
+        r = baseLearnSession(speeds, 0, session(0, baseHz, DECK_RATIO, 0.003f, rng), params);
+        baseHz = r.baseHz;
+    } while (r.action != BASE_LEARN_STEP);
+    // A base set by hand ends probation, so a worse next session is not blamed on the learner.
+    r = baseLearnSession(speeds, 0, session(0, 52.0f, DECK_RATIO, 0.003f, rng), params);
+    CHECK(r.action != BASE_LEARN_ROLLBACK);
+    CHECK_NEAR(speeds[0].anchorHz, 52.0, 1e-6);
+}
+
+static void testSharedRatioMovesUnusedSpeed() {
+    BaseLearnParams params = learnParams();
+    BaseLearnSpeed speeds[3];
+    clearAll(speeds);
+    Random rng = {15};
+    float base[3] = {50.0f, 67.5f, 118.0f};
+    for (int n = 0; n < 20; n++) {
+        for (uint8_t sp = 0; sp < 2; sp++) base[sp] = baseLearnSession(speeds, sp, session(sp, base[sp], DECK_RATIO, 0.003f, rng), params).baseHz;
+    }
+    float ratio, halfWidth, weight;
+    CHECK(baseLearnSharedRatio(speeds, ratio, halfWidth, weight));
+    CHECK_NEAR(ratio / DECK_RATIO, 1.0, 50e-6);
+    CHECK(halfWidth > 0.0f && halfWidth < 500e-6f);
+    // One session at 78 is far from confident on its own, so it borrows the shared ratio.
+    BaseLearnResult r = baseLearnSession(speeds, 2, session(2, base[2], DECK_RATIO, 0.003f, rng), params);
+    CHECK(r.action == BASE_LEARN_STEP);
+    CHECK(r.usedShared);
+    float idealHz = TARGET_RPM[2] / DECK_RATIO;
+    CHECK(fabsf(r.baseHz - idealHz) < fabsf(base[2] - idealHz));
+}
+
+static void testCorrectBaseStaysPut() {
+    BaseLearnParams params = learnParams();
+    int wandered = 0;
+    for (uint32_t deck = 0; deck < 100; deck++) {
+        BaseLearnSpeed speeds[3];
+        clearAll(speeds);
+        Random rng = {100 + deck};
+        float idealHz = TARGET_RPM[0] / DECK_RATIO;
+        float baseHz = idealHz;
+        float worst = 0.0f;
+        for (int n = 0; n < 100; n++) {
+            // Sessions of varied length and noisier correction than the convergence test.
+            BaseLearnSession s = session(0, baseHz, DECK_RATIO, 0.01f, rng);
+            s.weight = (float)(0.1 + 0.9 * rng.uniform());
+            baseHz = baseLearnSession(speeds, 0, s, params).baseHz;
+            if (fabsf(baseHz - idealHz) > worst) worst = fabsf(baseHz - idealHz);
+        }
+        if (worst > 0.05f) wandered++;
+    }
+    CHECK(wandered == 0);
+}
+
+static void testRejectsUnusableSessions() {
+    BaseLearnParams params = learnParams();
+    BaseLearnSpeed speeds[3];
+    clearAll(speeds);
+    Random rng = {16};
+    BaseLearnSession s = session(0, 50.0f, DECK_RATIO, 0.0f, rng);
+    CHECK(baseLearnSession(speeds, 3, s, params).action == BASE_LEARN_NONE);
+    s.correctionHz = NAN;
+    CHECK(baseLearnSession(speeds, 0, s, params).action == BASE_LEARN_NONE);
+    s = session(0, 50.0f, DECK_RATIO, 0.0f, rng);
+    s.weight = 0.0f;
+    CHECK(baseLearnSession(speeds, 0, s, params).action == BASE_LEARN_NONE);
+    CHECK(speeds[0].weight == 0.0f);
+}
+
+int main() {
+    testConvergesInBoundedSteps();
+    testTotalAndFrequencyLimits();
+    testRollbackAfterDeckChange();
+    testUserChangeReanchors();
+    testSharedRatioMovesUnusedSpeed();
+    testCorrectBaseStaysPut();
+    testRejectsUnusableSessions();
+    return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Bridge leg placement: duty limits per leg, and the line-to-line voltages the motor actually sees.
+
+#include "check.h"
+#include "bridge_modulation.h"
+
+static const int32_t TOP = 1023;
+static const int32_t MID = 512;
+static const double UNIT = 511.0;
+static const int ANGLES = 3600;
+static const double TWO_PI = 6.283185307179586;
+static const float THREE_PHASE[3] = {0.0f, 120.0f, 240.0f};
+static const float TWIN_PHASE[3] = {0.0f, 180.0f, 270.0f};
+
+struct Sweep {
+    int32_t worstError;    // Largest line-to-line error over every pair of legs, counts
+    bool legsInLimits;     // Every leg fully off or inside the window
+    bool maskAtLimits;     // Every leg the mask reports sits at an edge of the window
+    bool directionKept;    // Reduced line-to-line voltages all shrank by the same ratio, to a count
+    long clippedSamples;
+    long clippedLegs;
+};
+
+// 250 ns and 500 ns at the 50 kHz carrier.
+static BridgeModulationParams limits(uint8_t mode) {
+    BridgeModulationParams params = {mode, bridgeModulationCounts(250.0f, 50000.0f, TOP), bridgeModulationCounts(500.0f, 50000.0f, TOP)};
+    return params;
+}
+
+static Sweep sweep(const BridgeModulationParams& params, const float* phases, double amplitude) {
+    const int32_t low = params.minOnCounts;
+    const int32_t high = TOP - params.minOffCounts;
+    Sweep result = {0, true, true, true, 0, 0};
+    for (int n = 0; n < ANGLES; n++) {
+        int32_t wanted[3], duty[3];
+        for (int leg = 0; leg < 3; leg++) {
+            double angle = TWO_PI * n / ANGLES + phases[leg] * TWO_PI / 360.0;
+            wanted[leg] = MID + (int32_t)lround(UNIT * amplitude * sin(angle));
+            duty[leg] = wanted[leg];
+        }
+        uint8_t clipped = bridgeModulate(duty, 3, TOP, params);
+        if (clipped) result.clippedSamples++;
+
+        double ratio = 0.0;
+        int32_t widest = 0;
+        for (int i = 0; i < 3; i++) {
+            if (duty[i] != 0 && (duty[i] < low || duty[i] > high)) result.legsInLimits = false;
+            if (clipped & (1u << i)) {
+                result.clippedLegs++;
+                if (duty[i] != low && duty[i] != high) result.maskAtLimits = false;
+            }
+            for (int j = i + 1; j < 3; j++) {
+                int32_t error = abs((duty[i] - duty[j]) - (wanted[i] - wanted[j]));
+                if (error > result.worstError) result.worstError = error;
+                if (abs(wanted[i] - wanted[j]) > widest) {
+                    widest = abs(wanted[i] - wanted[j]);
+                    ratio = (double)(duty[i] - duty[j]) / (wanted[i] - wanted[j]);
+                }
+            }
+        }
+        for (int i = 0; i < 3 && widest > 0; i++) {
+            for (int j = i + 1; j < 3; j++) {
+                if (fabs((duty[i] - duty[j]) - ratio * (wanted[i] - wanted[j])) > 1.0) result.directionKept = false;
+            }
+        }
+    }
+    return result;
+}
+
+// Largest amplitude, in steps of 0.005, at which no line-to-line voltage is changed.
+static double cleanLimit(const BridgeModulationParams& params, const float* phases) {
+    double amplitude = 0.5;
+    while (amplitude < 1.5 && sweep(params, phases, amplitude + 0.005).worstError == 0) amplitude += 0.005;
+    return amplitude;
+}
+
+static void testCounts() {
+    CHECK(bridgeModulationCounts(250.0f, 50000.0f, TOP) == 13);
+    CHECK(bridgeModulationCounts(500.0f, 50000.0f, TOP) == 26);
+    CHECK(bridgeModulationCounts(0.0f, 50000.0f, TOP) == 0);
+}
+
+static void testNeutralHold() {
+    for (uint8_t mode = BRIDGE_MODULATION_SINE; mode <= BRIDGE_MODULATION_BOTTOM_CLAMP; mode++) {
+        int32_t duty[3] = {MID, MID, MID};
+        CHECK(bridgeModulate(duty, 3, TOP, limits(mode)) == 0);
+        CHECK(duty[0] == MID && duty[1] == MID && duty[2] == MID);
+    }
+}
+
+static void testLineToLineLimits() {
+    const float* topologies[2] = {THREE_PHASE, TWIN_PHASE};
+    for (int t = 0; t < 2; t++) {
+        for (uint8_t mode = BRIDGE_MODULATION_SINE; mode <= BRIDGE_MODULATION_BOTTOM_CLAMP; mode++) {
+            BridgeModulationParams params = limits(mode);
+            double clean = cleanLimit(params, topologies[t]);
+            double predicted = bridgeModulationPeakLimit(params, TOP, topologies[t], 3);
+            printf("%s mode %u: line-to-line exact up to %.3f, predicted %.3f\n", t == 0 ? "Three-phase" : "Twin-phase", mode, clean, predicted);
+            CHECK(clean >= predicted - 0.005);
+            if (mode != BRIDGE_MODULATION_BOTTOM_CLAMP) CHECK(clean < predicted + 0.01);
+            for (double amplitude = 0.1; amplitude < 1.45; amplitude += 0.1) {
+                Sweep s = sweep(params, topologies[t], amplitude);
+                CHECK(s.legsInLimits);
+                CHECK(s.maskAtLimits);
+                CHECK((s.worstError == 0) == (s.clippedSamples == 0));
+                if (mode != BRIDGE_MODULATION_SINE) CHECK(s.directionKept);
+            }
+        }
+    }
+    // Common-mode placement fits about 2/sqrt(3) of the sine's three-phase voltage.
+    CHECK(cleanLimit(limits(BRIDGE_MODULATION_CENTRED), THREE_PHASE) > 1.1);
+    CHECK(cleanLimit(limits(BRIDGE_MODULATION_SINE), THREE_PHASE) < 0.96);
+}
+
+static void testClippedLegs() {
+    // Sine placement at full scale: only the leg at its peak is clamped, never all three.
+    Sweep sine = sweep(limits(BRIDGE_MODULATION_SINE), THREE_PHASE, 1.0);
+    CHECK(sine.clippedSamples > 0);
+    CHECK(sine.clippedLegs == sine.clippedSamples);
+    // Scaled centred placement holds the highest and lowest legs at the edges; the middle leg is free.
+    Sweep centred = sweep(limits(BRIDGE_MODULATION_CENTRED), THREE_PHASE, 1.3);
+    CHECK(centred.clippedSamples == ANGLES);
+    CHECK(centred.clippedLegs >= 2 * ANGLES && centred.clippedLegs < 3 * ANGLES);
+    CHECK(centred.directionKept);
+}
+
+int main() {
+    testCounts();
+    testNeutralHold();
+    testLineToLineLimits();
+    testClippedLegs();
+    return 0;
+}
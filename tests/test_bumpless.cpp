@@ -0,0 +1,308 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Speed loop handovers with and without bumpless transfer: ramp handover, pitch jump, 33 to 45 switches and Monitor to
+// Correct, on a simulated belt deck.
+
+#include "check.h"
+#include "closed_loop_bumpless.h"
+
+static const double RPM_PER_HZ = 33.3333 / 50.0;  // Synchronous platter RPM per drive hertz
+static const double SLIP = 0.01;                  // Belt and pulley shortfall, growing with drive frequency
+static const double TAU_SEC = 1.5;                // Platter lag behind the drive
+static const double TICK_SEC = 0.01;
+static const int UPDATE_TICKS = 10;               // closedLoopUpdateIntervalMs
+static const double FILTER_ALPHA = 0.25;          // closedLoopFilterAlpha
+static const double ENGAGE_DELAY_SEC = 2.0;       // closedLoopEngageDelayMs
+static const double RAMP_SEC = 2.0;               // switchRampDuration
+static const double WINDOW_SEC = 60.0;
+static const double SETTLE_SEC = 10.0;            // A speed change is measured once the platter has caught up
+static const BumplessGains GAINS = {0.05f, 0.01f, 0.02f, 1.0f};  // Default kp, ki, deadband and integral limit
+static const float CORRECTION_LIMIT_HZ = 3.0f;
+static const float SLEW_HZ_PER_SEC = 0.5f;
+static const float RAMP_KP = 0.02f;
+static const float RAMP_CORRECTION_LIMIT_HZ = 1.0f;
+
+struct Handover {
+    double peakPercent;   // Largest speed deviation from target over the window
+    double rmsPercent;
+    float gapHz;          // PID output at the handover, from the integral it was given, less the correction applied
+    float firstStepHz;    // Change of correction at the first update after the handover
+};
+
+static float clampHz(float hz, float limit) {
+    if (hz > limit) return limit;
+    if (hz < -limit) return -limit;
+    return hz;
+}
+
+static float deadbanded(float errorRpm) {
+    return fabs(errorRpm) < GAINS.deadbandRpm ? 0.0f : errorRpm;
+}
+
+/*
+ * Belt deck and the firmware's speed loop at its default tuning: the filtered measurement, PI with integral and
+ * correction clamps, and the slew limit. Kd is 0 by default, so the derivative never enters. The deck starts settled
+ * at 33 with the integral holding the correction its slip needs.
+ */
+struct Deck {
+    bool bumpless;
+    double platterRpm;
+    double filteredRpm;
+    double targetRpm;
+    double openLoopHz;
+    float integralHz;
+    float correctionHz;
+    float lastErrorRpm;
+    bool engaged;
+    bool firstPending;
+    float handoverHz;
+    int ticks;
+    Handover result;
+    double windowStartSec;
+    double sumSquares;
+    long samples;
+
+    void begin(bool useBumpless) {
+        bumpless = useBumpless;
+        targetRpm = 33.3333;
+        openLoopHz = 50.0;
+        correctionHz = (float)(openLoopHz * SLIP / (1.0 - SLIP));
+        integralHz = correctionHz;
+        platterRpm = targetRpm;
+        filteredRpm = targetRpm;
+        lastErrorRpm = 0.0f;
+        engaged = true;
+        firstPending = false;
+        handoverHz = 0.0f;
+        ticks = 0;
+        result.peakPercent = 0.0;
+        result.rmsPercent = 0.0;
+        result.gapHz = 0.0f;
+        result.firstStepHz = 0.0f;
+        windowStartSec = -1.0;
+        sumSquares = 0.0;
+        samples = 0;
+    }
+
+    double nowSec() const { return ticks * TICK_SEC; }
+
+    float errorRpm() const { return (float)(targetRpm - filteredRpm); }
+
+    // Opens the measurement window settleSec after the handover.
+    void startWindow(double settleSec) {
+        windowStartSec = nowSec() + settleSec;
+    }
+
+    // Engages the loop on the correction applied now. Without bumpless transfer the integral starts from zero.
+    void engage() {
+        float error = errorRpm();
+        integralHz = bumpless ? bumplessIntegralHz(GAINS, correctionHz, error) : 0.0f;
+        handoverHz = correctionHz;
+        result.gapHz = GAINS.kp * deadbanded(error) + integralHz - correctionHz;
+        lastErrorRpm = error;
+        engaged = true;
+        firstPending = true;
+    }
+
+    void pidUpdate() {
+        float dt = (float)(UPDATE_TICKS * TICK_SEC);
+        float error = deadbanded(errorRpm());
+        integralHz = clampHz(integralHz + GAINS.ki * error * dt, GAINS.integralLimitHz);
+        float requested = clampHz(GAINS.kp * error + integralHz, CORRECTION_LIMIT_HZ);
+        float maxStep = SLEW_HZ_PER_SEC * dt;
+        if (requested > correctionHz + maxStep) requested = correctionHz + maxStep;
+        if (requested < correctionHz - maxStep) requested = correctionHz - maxStep;
+        correctionHz = requested;
+        lastErrorRpm = error;
+        if (firstPending) {
+            result.firstStepHz = correctionHz - handoverHz;
+            firstPending = false;
+        }
+    }
+
+    // One 10 ms tick at the given drive frequency; returns true on a loop update tick, after the measurement is taken.
+    bool tick(double driveHz) {
+        platterRpm += (driveHz * RPM_PER_HZ * (1.0 - SLIP) - platterRpm) * (1.0 - exp(-TICK_SEC / TAU_SEC));
+        ticks++;
+        if (windowStartSec >= 0.0 && nowSec() > windowStartSec && nowSec() <= windowStartSec + WINDOW_SEC) {
+            double percent = 100.0 * (platterRpm - targetRpm) / targetRpm;
+            if (fabs(percent) > result.peakPercent) result.peakPercent = fabs(percent);
+            sumSquares += percent * percent;
+            samples++;
+        }
+        if (ticks % UPDATE_TICKS != 0) return false;
+        filteredRpm += FILTER_ALPHA * (platterRpm - filteredRpm);
+        return true;
+    }
+
+    // Runs for the given time at the current open-loop frequency, the loop updating when engaged.
+    void run(double seconds) {
+        double end = nowSec() + seconds - 0.5 * TICK_SEC;
+        while (nowSec() < end) {
+            if (tick(openLoopHz + correctionHz) && engaged) pidUpdate();
+        }
+    }
+
+    // Holds the correction through the engagement delay, then engages on it.
+    void engageAfterDelay() {
+        engaged = false;
+        run(ENGAGE_DELAY_SEC);
+        engage();
+    }
+
+    // Switches to a speed with target RPM, smoothly with the given ramp mode or instantly.
+    void switchSpeed(double newTargetRpm, bool smooth, bool rampTrack) {
+        double newOpenLoopHz = newTargetRpm / RPM_PER_HZ;
+        float carryHz = bumpless ? bumplessCarryHz(correctionHz, (float)openLoopHz, (float)newOpenLoopHz) : 0.0f;
+        double startRpm = targetRpm;
+        if (!smooth) {
+            targetRpm = newTargetRpm;
+            openLoopHz = newOpenLoopHz;
+            correctionHz = carryHz;
+            startWindow(SETTLE_SEC);
+            engageAfterDelay();
+            return;
+        }
+        // The ramp starts from the frequency played, old correction included, and ends on the carried one.
+        double startHz = openLoopHz + correctionHz;
+        engaged = false;
+        correctionHz = 0.0f;
+        float rampCorrectionHz = 0.0f;
+        for (int i = 1; i <= (int)(RAMP_SEC / TICK_SEC + 0.5); i++) {
+            double fraction = i * TICK_SEC / RAMP_SEC;
+            double rampHz = startHz + ((newOpenLoopHz - startHz) + carryHz) * fraction;
+            targetRpm = startRpm + (newTargetRpm - startRpm) * fraction;
+            if (tick(rampHz + rampCorrectionHz) && rampTrack) {
+                rampCorrectionHz = clampHz(RAMP_KP * deadbanded(errorRpm()), RAMP_CORRECTION_LIMIT_HZ);
+            }
+        }
+        targetRpm = newTargetRpm;
+        openLoopHz = newOpenLoopHz;
+        // Without bumpless transfer the ramp's correction is dropped and the delay runs open loop.
+        correctionHz = bumpless ? carryHz + rampCorrectionHz : 0.0f;
+        startWindow(SETTLE_SEC);
+        engageAfterDelay();
+    }
+
+    // A pitch jump past closedLoopPitchResetThresholdRpm: the open-loop frequency follows the pitch at once.
+    void pitchJump(double newTargetRpm) {
+        openLoopHz *= newTargetRpm / targetRpm;
+        targetRpm = newTargetRpm;
+        handoverHz = correctionHz;
+        // Bumpless rebases the integral on the error from before the jump; the old reset zeroed it.
+        integralHz = bumpless ? bumplessIntegralHz(GAINS, correctionHz, lastErrorRpm) : 0.0f;
+        result.gapHz = GAINS.kp * deadbanded(lastErrorRpm) + integralHz - correctionHz;
+        firstPending = true;
+        startWindow(0.0);
+    }
+
+    Handover finish() {
+        run(windowStartSec - nowSec() + WINDOW_SEC + 1.0);
+        result.rmsPercent = samples > 0 ? sqrt(sumSquares / samples) : 0.0;
+        return result;
+    }
+};
+
+typedef void (*Scenario)(Deck& deck);
+
+static void compare(const char* name, Scenario scenario, Handover& reset, Handover& bumpless) {
+    static Deck deck;
+    deck.begin(false);
+    scenario(deck);
+    reset = deck.finish();
+    deck.begin(true);
+    scenario(deck);
+    bumpless = deck.finish();
+    printf("%s: peak %.2f%% -> %.2f%%, rms %.2f%% -> %.2f%%, first step %+.4f -> %+.4f Hz\n", name, reset.peakPercent,
+           bumpless.peakPercent, reset.rmsPercent, bumpless.rmsPercent, reset.firstStepHz, bumpless.firstStepHz);
+    // The integral it is handed makes the PID's output the correction already applied.
+    CHECK_NEAR(bumpless.gapHz, 0.0, 1e-5);
+}
+
+static void rampHandover(Deck& deck) {
+    deck.switchSpeed(45.0, true, true);
+}
+
+static void smoothSwitch(Deck& deck) {
+    deck.switchSpeed(45.0, true, false);
+}
+
+static void instantSwitch(Deck& deck) {
+    deck.switchSpeed(45.0, false, false);
+}
+
+static void pitchJump(Deck& deck) {
+    deck.run(5.0);
+    deck.pitchJump(33.8333);
+}
+
+static void monitorToCorrect(Deck& deck) {
+    // Monitor mode measures without correcting, so the deck runs at its open-loop slip.
+    deck.engaged = false;
+    deck.correctionHz = 0.0f;
+    deck.integralHz = 0.0f;
+    deck.run(30.0);
+    deck.startWindow(0.0);
+    deck.engage();
+}
+
+static void testIntegralBackCalculation() {
+    // The proportional share is taken on the deadbanded error, and the integral clamp still applies.
+    CHECK_NEAR(bumplessIntegralHz(GAINS, 0.5f, 0.4f), 0.5 - 0.05 * 0.4, 1e-6);
+    CHECK_NEAR(bumplessIntegralHz(GAINS, 0.5f, 0.01f), 0.5, 1e-6);
+    CHECK_NEAR(bumplessIntegralHz(GAINS, 2.5f, 0.0f), 1.0, 1e-6);
+    CHECK_NEAR(bumplessIntegralHz(GAINS, -2.5f, 0.0f), -1.0, 1e-6);
+    // A P-only tuning has no integral to hold the correction.
+    BumplessGains pOnly = GAINS;
+    pOnly.ki = 0.0f;
+    CHECK(bumplessIntegralHz(pOnly, 0.5f, 0.0f) == 0.0f);
+}
+
+static void testCarryScaling() {
+    CHECK_NEAR(bumplessCarryHz(0.5f, 50.0f, 67.5f), 0.675, 1e-6);
+    CHECK_NEAR(bumplessCarryHz(-0.3f, 67.5f, 50.0f), -0.3 * 50.0 / 67.5, 1e-6);
+    CHECK(bumplessCarryHz(0.5f, 0.0f, 67.5f) == 0.0f);
+    CHECK(bumplessCarryHz(0.5f, 50.0f, 0.0f) == 0.0f);
+}
+
+static void testHandovers() {
+    Handover reset, bumpless;
+
+    compare("Ramp handover", rampHandover, reset, bumpless);
+    CHECK(bumpless.peakPercent < 0.5 * reset.peakPercent);
+    CHECK(bumpless.rmsPercent < 0.5 * reset.rmsPercent);
+
+    compare("Pitch +0.5 RPM", pitchJump, reset, bumpless);
+    // The peak is the platter's lag to the new target either way; the rebased integral keeps the load share.
+    CHECK(bumpless.rmsPercent < 0.5 * reset.rmsPercent);
+    // Zeroing the integral pulls the correction down as fast as the slew limit allows.
+    CHECK(reset.firstStepHz < -0.049f);
+    CHECK(bumpless.firstStepHz > 0.0f);
+
+    compare("33 to 45 smooth", smoothSwitch, reset, bumpless);
+    CHECK(bumpless.peakPercent < 0.5 * reset.peakPercent);
+    CHECK(bumpless.rmsPercent < 0.25 * reset.rmsPercent);
+
+    compare("33 to 45 instant", instantSwitch, reset, bumpless);
+    CHECK(bumpless.peakPercent < 0.5 * reset.peakPercent);
+    CHECK(bumpless.rmsPercent < 0.25 * reset.rmsPercent);
+
+    compare("Monitor to Correct", monitorToCorrect, reset, bumpless);
+    // The old engage stepped the output by Kp times the error on the first update; now only the integral moves it.
+    CHECK(fabs(bumpless.firstStepHz) < 0.1f * fabs(reset.firstStepHz));
+    // That kick sped up the first pull-in a little; without it the slow default Ki gets there at much the same rate.
+    CHECK(bumpless.rmsPercent < 1.05 * reset.rmsPercent);
+}
+
+int main() {
+    testIntegralBackCalculation();
+    testCarryScaling();
+    testHandovers();
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Simulated DC bus traces sampled through the divider and 10-bit ADC: feed-forward, dip ride-through, and limits.
+
+#include "check.h"
+#include "bus_voltage.h"
+
+static const float SAMPLE_SEC = 0.002f;   // BUS_VOLTAGE_SAMPLE_MS
+static const float DIVIDER = 11.0f;       // BUS_VOLTAGE_DIVIDER_RATIO
+
+static BusVoltageParams defaultParams() {
+    BusVoltageParams params = {12.0f, 0.2f, 0.005f, 0.6f, 1.3f, 16.0f, 9.0f, 0.5f, 0.2f};
+    return params;
+}
+
+// Samples a bus voltage as the firmware does: the divided voltage rounded to a 10-bit count with a little ADC noise.
+static float sampleBus(double volts, uint32_t& noise) {
+    noise = (noise * 1103515245u) + 12345u;
+    double lsbNoise = ((double)((noise >> 16) % 5) - 2.0);
+    int raw = (int)lround((volts / DIVIDER) * 1023.0 / 3.3 + lsbNoise);
+    if (raw < 0) raw = 0;
+    if (raw > 1023) raw = 1023;
+    return busVoltageFromAdc(raw, DIVIDER);
+}
+
+// Bus sagging with load and carrying 100 Hz rectifier ripple.
+static double loadedBus(double t, double baseV, double sagV) {
+    double sag = t < 1.0 ? 0.0 : sagV * (1.0 - exp(-(t - 1.0) / 0.3));
+    return baseV - sag + (0.3 * sin(6.283185307 * 100.0 * t));
+}
+
+static void testAdcConversion() {
+    CHECK_NEAR(busVoltageFromAdc(0, DIVIDER), 0.0, 1e-6);
+    CHECK_NEAR(busVoltageFromAdc(1023, DIVIDER), 36.3, 1e-3);
+    uint32_t noise = 1;
+    CHECK_NEAR(sampleBus(12.0, noise), 12.0, 0.1);
+}
+
+static void testFeedForwardHoldsDeliveredVoltage() {
+    // A 12 V brick sagging by 1.5 V under load, and a 15 V brick: the amplitude scale should hold duty times bus at nominal.
+    const double bases[] = {12.0, 15.0};
+    for (double base : bases) {
+        BusVoltageSupervisor bus;
+        bus.configure(defaultParams());
+        uint32_t noise = 42;
+        double worstDelivered = 0.0;
+        for (int n = 0; n < 2500; n++) {
+            double t = n * SAMPLE_SEC;
+            double volts = loadedBus(t, base, 1.5);
+            CHECK(bus.update(sampleBus(volts, noise), SAMPLE_SEC) == BUS_VOLTAGE_NORMAL);
+            // Once the sag has settled, the delivered fundamental is the scale times the average bus.
+            if (t > 3.0) {
+                double delivered = bus.getScale() * (base - 1.5) / 12.0;
+                if (fabs(delivered - 1.0) > worstDelivered) worstDelivered = fabs(delivered - 1.0);
+            }
+        }
+        CHECK(worstDelivered < 0.01);
+        CHECK_NEAR(bus.getScale(), 12.0 / (base - 1.5), 0.01);
+    }
+
+    // Ripple alone moves the scale by well under a percent.
+    BusVoltageSupervisor bus;
+    bus.configure(defaultParams());
+    uint32_t noise = 7;
+    float lowest = 2.0f, highest = 0.0f;
+    for (int n = 0; n < 1500; n++) {
+        bus.update(sampleBus(loadedBus(n * SAMPLE_SEC, 12.0, 0.0), noise), SAMPLE_SEC);
+        if (n > 500) {
+            if (bus.getScale() < lowest) lowest = bus.getScale();
+            if (bus.getScale() > highest) highest = bus.getScale();
+        }
+    }
+    CHECK(highest - lowest < 0.005f);
+}
+
+static void testScaleLimits() {
+    BusVoltageSupervisor bus;
+    bus.configure(defaultParams());
+    uint32_t noise = 3;
+    // 9.5 V sits above the undervoltage limit but needs more boost than the 1.3 ceiling allows.
+    for (int n = 0; n < 1500; n++) bus.update(sampleBus(9.5, noise), SAMPLE_SEC);
+    CHECK_NEAR(bus.getScale(), 12.0 / 9.5, 0.01);
+    for (int n = 0; n < 1500; n++) bus.update(sampleBus(24.0 * 0.6, noise), SAMPLE_SEC);
+    CHECK_NEAR(bus.getScale(), 12.0 / 14.4, 0.01);
+    BusVoltageParams tight = defaultParams();
+    tight.maxScale = 1.1f;
+    bus.configure(tight);
+    bus.reset();
+    for (int n = 0; n < 1500; n++) bus.update(sampleBus(9.5, noise), SAMPLE_SEC);
+    CHECK_NEAR(bus.getScale(), 1.1, 1e-4);
+}
+
+// Runs a 12 V bus that drops to dipV for dipSec starting at 1 s. Reports the scale before the dip and the highest
+// scale during it.
+static BusVoltageSupervisor runDip(double dipV, double dipSec, float& scaleBefore, float& highestScaleInDip) {
+    BusVoltageSupervisor bus;
+    bus.configure(defaultParams());
+    uint32_t noise = 99;
+    scaleBefore = 0.0f;
+    highestScaleInDip = 0.0f;
+    for (int n = 0; n < 2000; n++) {
+        double t = n * SAMPLE_SEC;
+        bool inDip = t >= 1.0 && t < 1.0 + dipSec;
+        bus.update(sampleBus(inDip ? dipV : 12.0, noise), SAMPLE_SEC);
+        if (t < 1.0) scaleBefore = bus.getScale();
+        else if (inDip && bus.getScale() > highestScaleInDip) highestScaleInDip = bus.getScale();
+    }
+    return bus;
+}
+
+static void testShortDipRidesThrough() {
+    float before, held;
+    BusVoltageSupervisor bus = runDip(7.0, 0.1, before, held);
+    CHECK(bus.getState() == BUS_VOLTAGE_NORMAL);
+    CHECK(bus.getDipsRiddenThrough() == 1);
+    CHECK(bus.getUnderVoltageEvents() == 0);
+    CHECK(bus.getLongestDipSec() > 0.08f && bus.getLongestDipSec() < 0.12f);
+    // The scale freezes once the fast filter sees the dip: no boost sized for a collapsing supply. The few samples
+    // before that move the slow filter by about a percent.
+    CHECK(held >= before);
+    CHECK(held < before + 0.02f);
+    // Sags above the undervoltage limit are not dips at all.
+    bus = runDip(9.6, 0.1, before, held);
+    CHECK(bus.getDipsRiddenThrough() == 0);
+}
+
+static void testLongDipFaults() {
+    float before, held;
+    BusVoltageSupervisor bus = runDip(7.0, 0.5, before, held);
+    CHECK(bus.getUnderVoltageEvents() == 1);
+    CHECK(bus.getDipsRiddenThrough() == 0);
+    // The fault clears once the supply is back above the limit plus hysteresis.
+    CHECK(bus.getState() == BUS_VOLTAGE_NORMAL);
+    CHECK(held < before + 0.02f);
+}
+
+static void testRegenOverVoltage() {
+    BusVoltageSupervisor bus;
+    bus.configure(defaultParams());
+    uint32_t noise = 5;
+    // Braking pumps the bus from 12 V towards 18 V at 100 V/s, then the brake is released and it bleeds back down.
+    double crossedAt = -1.0, reportedAt = -1.0, clearedAt = -1.0;
+    for (int n = 0; n < 2000; n++) {
+        double t = n * SAMPLE_SEC;
+        double volts = 12.0;
+        if (t >= 1.0 && t < 1.06) volts = 12.0 + (100.0 * (t - 1.0));
+        else if (t >= 1.06) volts = 18.0 - (20.0 * (t - 1.06));
+        if (volts < 12.0) volts = 12.0;
+        if (crossedAt < 0.0 && volts >= 16.0) crossedAt = t;
+        BusVoltageState state = bus.update(sampleBus(volts, noise), SAMPLE_SEC);
+        if (reportedAt < 0.0 && state == BUS_VOLTAGE_OVERVOLTAGE) reportedAt = t;
+        if (reportedAt >= 0.0 && clearedAt < 0.0 && state == BUS_VOLTAGE_NORMAL) clearedAt = t;
+    }
+    CHECK(reportedAt >= crossedAt);
+    CHECK(reportedAt - crossedAt < 0.015);
+    CHECK(bus.getOverVoltageEvents() == 1);
+    // Clears only below the limit less hysteresis: 15.5 V is reached at 1.185 s on the way down.
+    CHECK(clearedAt > 1.18 && clearedAt < 1.21);
+    CHECK(bus.getMaxV() > 17.0f);
+}
+
+static void testSpikesAndBadSamples() {
+    BusVoltageSupervisor bus;
+    bus.configure(defaultParams());
+    uint32_t noise = 11;
+    for (int n = 0; n < 1000; n++) {
+        // A single-sample switching spike to 20 V and a single-sample drop to 5 V every 100 ms.
+        double volts = 12.0;
+        if (n % 50 == 10) volts = 20.0;
+        if (n % 50 == 30) volts = 5.0;
+        CHECK(bus.update(sampleBus(volts, noise), SAMPLE_SEC) == BUS_VOLTAGE_NORMAL);
+        bus.update(NAN, SAMPLE_SEC);
+    }
+    CHECK(bus.getOverVoltageEvents() == 0);
+    CHECK(bus.getDipsRiddenThrough() == 0);
+    CHECK_NEAR(bus.getScale(), 1.0, 0.01);
+}
+
+int main() {
+    testAdcConversion();
+    testFeedForwardHoldsDeliveredVoltage();
+    testScaleLimits();
+    testShortDipRidesThrough();
+    testLongDipFaults();
+    testRegenOverVoltage();
+    testSpikesAndBadSamples();
+    return 0;
+}
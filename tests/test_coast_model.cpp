@@ -0,0 +1,148 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Coast-down fit against synthetic decay curves of J dw/dt = -B w - Tc, sampled directly and through a coarse tachometer.
+
+#include "check.h"
+#include "coast_model.h"
+
+// Closed-form coast from w0 with viscous rate b (1/s) and Coulomb deceleration c (rpm/s).
+static double coastRpm(double w0, double b, double c, double t) {
+    if (b <= 0.0) return w0 - (c * t);
+    return ((w0 + (c / b)) * exp(-b * t)) - (c / b);
+}
+
+static double coastStopSec(double w0, double b, double c) {
+    if (b <= 0.0) return w0 / c;
+    return log(1.0 + ((b * w0) / c)) / b;
+}
+
+// Samples the curve every stepSec until it falls below endRpm, with an optional deterministic ripple in percent.
+static CoastDownFitResult fitDirect(double w0, double b, double c, double stepSec, double endRpm, double ripplePercent) {
+    CoastDownFit fit;
+    for (int i = 0;; i++) {
+        double t = i * stepSec;
+        double w = coastRpm(w0, b, c, t);
+        if (w < endRpm) break;
+        double ripple = ripplePercent * 0.01 * ((double)((i * 37) % 17) - 8.0) / 8.0;
+        fit.addSample((float)t, (float)(w * (1.0 + ripple)));
+    }
+    CoastDownFitResult result;
+    fit.solve(result);
+    return result;
+}
+
+// Replays the coast through a tachometer with cpr counts per revolution, timing windows of at least windowCounts counts as the firmware does.
+static CoastDownFitResult fitTach(double w0, double b, double c, int cpr, int windowCounts, double endRpm) {
+    CoastDownFit fit;
+    const double dt = 0.0005;
+    double revs = 0.0;
+    double windowStart = 0.0;
+    int counts = 0;
+    long lastCount = 0;
+    for (double t = 0.0; t < 600.0; t += dt) {
+        double w = coastRpm(w0, b, c, t);
+        if (w <= endRpm) break;
+        revs += w / 60.0 * dt;
+        long count = (long)(revs * cpr);
+        if (count == lastCount) continue;
+        counts += (int)(count - lastCount);
+        lastCount = count;
+        if (counts < windowCounts) continue;
+        double rpm = ((double)counts / cpr) * 60.0 / (t - windowStart);
+        fit.addSample((float)(0.5 * (t + windowStart)), (float)rpm);
+        windowStart = t;
+        counts = 0;
+    }
+    CoastDownFitResult result;
+    fit.solve(result);
+    return result;
+}
+
+static void testMixedFriction() {
+    // A belt-drive platter: 50 s mechanical time constant and 0.3 rpm/s of bearing drag.
+    const double w0 = 33.3333, b = 0.02, c = 0.3;
+    CoastDownFitResult fit = fitDirect(w0, b, c, 0.25, w0 * 0.05, 0.0);
+    CHECK(fit.valid);
+    CHECK_NEAR(fit.viscousPerSec, b, b * 0.01);
+    CHECK_NEAR(fit.coulombRpmPerSec, c, c * 0.01);
+    CHECK(fit.rSquared > 0.999f);
+    CHECK_NEAR(coastDownStopSeconds(fit, (float)w0), coastStopSec(w0, b, c), 0.5);
+}
+
+static void testNoisyTach() {
+    // 1% ripple from an eccentric strobe still leaves both terms within a few percent.
+    const double w0 = 45.0, b = 0.03, c = 0.2;
+    CoastDownFitResult fit = fitDirect(w0, b, c, 0.1, w0 * 0.05, 1.0);
+    CHECK(fit.valid);
+    CHECK_NEAR(fit.viscousPerSec, b, b * 0.05);
+    CHECK_NEAR(fit.coulombRpmPerSec, c, c * 0.1);
+    CHECK(fit.rSquared > 0.99f);
+}
+
+static void testCoarseSensors() {
+    // Windows of four counts on coarse sensors give few, averaged points, but the decay is still identified.
+    const double w0 = 33.3333, b = 0.02, c = 0.3;
+    const int cprs[] = {1, 4, 360};
+    for (int cpr : cprs) {
+        CoastDownFitResult fit = fitTach(w0, b, c, cpr, 4, w0 * 0.05);
+        CHECK(fit.valid);
+        CHECK(fit.rSquared > 0.99f);
+        CHECK_NEAR(coastDownStopSeconds(fit, (float)w0), coastStopSec(w0, b, c), coastStopSec(w0, b, c) * 0.1);
+    }
+}
+
+static void testSingleTerm() {
+    // Pure Coulomb drag: a straight-line decay.
+    CoastDownFitResult coulomb = fitDirect(33.3333, 0.0, 0.5, 0.25, 1.0, 0.0);
+    CHECK(coulomb.valid);
+    CHECK(coulomb.viscousPerSec < 1e-3f);
+    CHECK_NEAR(coulomb.coulombRpmPerSec, 0.5, 0.005);
+
+    // Pure viscous drag: an exponential that never reaches zero.
+    CoastDownFitResult viscous = fitDirect(33.3333, 0.05, 0.0, 0.25, 1.0, 0.0);
+    CHECK(viscous.valid);
+    CHECK_NEAR(viscous.viscousPerSec, 0.05, 0.0005);
+    CHECK(viscous.coulombRpmPerSec < 1e-3f);
+    CHECK_NEAR(coastDownStopSeconds(viscous, 33.3333f), log(100.0) / 0.05, 0.5);
+}
+
+static void testRejectsSpinUp() {
+    // A speed that rises is not a coast and must not produce a model.
+    CoastDownFit fit;
+    for (int i = 0; i < 100; i++) fit.addSample(i * 0.1f, 10.0f + i * 0.2f);
+    CoastDownFitResult result;
+    CHECK(!fit.solve(result));
+    CHECK(!result.valid);
+}
+
+static void testTimingHelpers() {
+    CoastDownFitResult fit = fitDirect(33.3333, 0.02, 0.3, 0.25, 33.3333 * 0.05, 0.0);
+    CHECK(fit.valid);
+
+    // More drive torque means a shorter run-up; no surplus over friction means no estimate.
+    float slow = coastDownSpinUpSeconds(fit, 33.3333f, 2.0f);
+    float fast = coastDownSpinUpSeconds(fit, 33.3333f, 8.0f);
+    CHECK(slow > fast && fast > 0.0f);
+    CHECK(coastDownSpinUpSeconds(fit, 33.3333f, 1.0f) == 0.0f);
+
+    // Braking torque only ever shortens the stop, and zero braking torque is a free coast.
+    float coast = coastDownStopSeconds(fit, 33.3333f);
+    CHECK_NEAR(coastDownBrakeSeconds(fit, 33.3333f, 0.0f), coast, coast * 0.01);
+    CHECK(coastDownBrakeSeconds(fit, 33.3333f, 4.0f) < coast);
+}
+
+int main() {
+    testMixedFriction();
+    testNoisyTach();
+    testCoarseSensors();
+    testSingleTerm();
+    testRejectsSpinUp();
+    testTimingHelpers();
+    return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Running counts/rev detection on synthetic edge intervals: encoders with a once-per-rev defect, coarse sensors with
+// nothing to correlate, and the per-update budget.
+
+#include "check.h"
+#include "random.h"
+#include "cpr_detect.h"
+
+static const int CAPTURE = 1023;      // CPR_DETECT_SAMPLES less the first interval
+static const int REVOLUTIONS = 8;     // CPR_DETECT_REVOLUTIONS
+static const uint32_t BUDGET = 1024;  // CPR_DETECT_BUDGET
+
+struct Capture {
+    uint32_t intervals[CAPTURE];
+    uint16_t count;
+};
+
+/*
+ * Edge intervals of a platter at rpm through a cpr sensor whose slot 0 is widerPercent wider than the rest, with
+ * wow at 0.55 Hz, 0.1% unless given, and gaussian timing jitter. The capture stops at the buffer or after REVOLUTIONS turns.
+ */
+static void capture(Capture& c, int cpr, double rpm, double widerPercent, double jitterUs, uint32_t seed, double wow = 0.001) {
+    Random rng = {seed};
+    double rev = 60e6 / rpm;
+    double narrow = rev / (cpr + widerPercent / 100.0);
+    double t = 0.0;
+    int total = cpr * REVOLUTIONS < CAPTURE ? cpr * REVOLUTIONS : CAPTURE;
+    for (int i = 0; i < total; i++) {
+        double slot = (i % cpr == 0) ? narrow * (1.0 + widerPercent / 100.0) : narrow;
+        double speed = 1.0 + wow * sin(6.283185307179586 * 0.55 * t / 1e6);
+        double interval = slot * speed + jitterUs * rng.gaussian();
+        t += interval;
+        c.intervals[i] = (uint32_t)llround(interval);
+    }
+    c.count = (uint16_t)total;
+}
+
+static CprDetector detect(Capture& c, double expectedRpm, uint32_t budget = BUDGET, int* calls = nullptr) {
+    CprDetector detector;
+    CHECK(detector.begin(c.intervals, c.count, (float)expectedRpm));
+    int n = 0;
+    while (!detector.analyse(budget)) {
+        n++;
+        CHECK(n < 100000);
+    }
+    if (calls) *calls = n + 1;
+    return detector;
+}
+
+static void testEncoderWithDefect() {
+    const int cprs[3] = {36, 100, 300};
+    for (int i = 0; i < 3; i++) {
+        Capture c;
+        // One slot 3% wide, 5 us of jitter on a 33 1/3 RPM platter; the pulley estimate is 4% off.
+        capture(c, cprs[i], 33.333, 3.0, 5.0, 11 + i);
+        CprDetector d = detect(c, 33.333 * 1.04);
+        printf("%d CPR encoder: detected %u, correlation %.2f, confidence %.2f (%s)\n", cprs[i], d.getDetectedCounts(),
+               d.getCorrelation(), d.getConfidence(), d.getMessage());
+        CHECK(d.getDetectedCounts() == cprs[i]);
+        CHECK(d.getConfidence() >= 0.5f);
+    }
+
+    // A doubled edge in the middle of the capture is set aside and does not move the result.
+    Capture c;
+    capture(c, 100, 33.333, 3.0, 5.0, 21);
+    for (int i = c.count - 1; i > 400; i--) c.intervals[i] = c.intervals[i - 1];
+    c.intervals[400] /= 2;
+    c.intervals[401] = c.intervals[400];
+    CprDetector d = detect(c, 33.333);
+    printf("Doubled edge: detected %u, confidence %.2f (%s)\n", d.getDetectedCounts(), d.getConfidence(), d.getMessage());
+    CHECK(d.getDetectedCounts() == 100);
+    CHECK(d.getConfidence() >= 0.5f);
+}
+
+static void testEvenEncoderHasNoRepeat() {
+    // Without a defect nothing repeats once per revolution, and at 100 counts/rev the pulley tolerance spans
+    // several whole counts, so there is no count to fall back on.
+    Capture c;
+    capture(c, 100, 33.333, 0.0, 5.0, 31);
+    CprDetector d = detect(c, 33.333);
+    CHECK(d.getConfidence() < 0.5f);
+}
+
+static void testCoarseSensorRoundsExpectedCount() {
+    for (int cpr = 1; cpr <= 6; cpr++) {
+        Capture c;
+        // Evenly spaced slots on a steady platter: a few intervals per capture, nothing to correlate, 1% pulley error.
+        capture(c, cpr, 33.333, 0.0, 20.0, 40 + cpr, 0.0);
+        CprDetector d = detect(c, 33.333 * 1.01);
+        printf("%d CPR sensor: detected %u, expected %.2f, confidence %.2f (%s)\n", cpr, d.getDetectedCounts(),
+               d.getExpectedCounts(), d.getConfidence(), d.getMessage());
+        CHECK(d.getDetectedCounts() == cpr);
+        CHECK(d.getConfidence() >= 0.5f);
+        CHECK(d.getCorrelation() == 0.0f);
+    }
+    // Halfway between two counts there is nothing to round to.
+    Capture c;
+    capture(c, 2, 33.333, 0.0, 20.0, 51, 0.0);
+    CprDetector d = detect(c, 33.333 * 1.25);
+    CHECK(d.getConfidence() < 0.5f);
+}
+
+static void testBudget() {
+    Capture reference;
+    capture(reference, 100, 33.333, 3.0, 5.0, 61);
+    Capture budgeted = reference;
+    int unboundedCalls = 0, budgetedCalls = 0;
+    CprDetector full = detect(reference, 33.333, 0xFFFFFFFFu, &unboundedCalls);
+    CprDetector sliced = detect(budgeted, 33.333, BUDGET, &budgetedCalls);
+    CHECK(unboundedCalls == 1);
+
+    // Every lag's products, resumed mid-lag between calls: each call but the last spends the whole budget.
+    long macs = 0;
+    for (int lag = 1; lag <= budgeted.count / 3; lag++) macs += budgeted.count - lag;
+    long expectedCalls = (macs + BUDGET - 1) / BUDGET;
+    printf("Budget: %ld multiply-accumulates in %d calls of %u\n", macs, budgetedCalls, BUDGET);
+    CHECK(budgetedCalls == expectedCalls);
+    CHECK(sliced.getDetectedCounts() == full.getDetectedCounts());
+    CHECK(sliced.getCorrelation() == full.getCorrelation());
+    CHECK(sliced.getConfidence() == full.getConfidence());
+
+    // Progress advances with each slice and reads complete at the end.
+    Capture c;
+    capture(c, 100, 33.333, 3.0, 5.0, 61);
+    CprDetector d;
+    CHECK(d.begin(c.intervals, c.count, 33.333f));
+    uint8_t last = d.getProgressPercent();
+    for (int i = 0; i < 50; i++) {
+        d.analyse(BUDGET);
+        CHECK(d.getProgressPercent() >= last);
+        last = d.getProgressPercent();
+    }
+    CHECK(last > 0 && last < 100);
+    while (!d.analyse(BUDGET)) {}
+    CHECK(d.getProgressPercent() == 100);
+}
+
+static void testUnusableCapture() {
+    uint32_t zeros[8] = {0};
+    CprDetector d;
+    CHECK(!d.begin(zeros, 8, 33.333f));
+    uint32_t even[8] = {1800000, 1800000, 1800000, 1800000, 1800000, 1800000, 1800000, 1800000};
+    // Identical intervals have no variance, so the result comes from the expected count straight away.
+    CHECK(d.begin(even, 8, 33.333f));
+    CHECK(d.isFinished());
+    CHECK(d.getDetectedCounts() == 1);
+}
+
+int main() {
+    testEncoderWithDefect();
+    testEvenEncoderHasNoRepeat();
+    testCoarseSensorRoundsExpectedCount();
+    testBudget();
+    testUnusableCapture();
+    return 0;
+}
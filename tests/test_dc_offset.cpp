@@ -0,0 +1,161 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// DC offset nulling against a simulated shared sense: convergence, faults, cancel and storage.
+
+#include "check.h"
+#include "dc_offset.h"
+#include "random.h"
+
+// One sense input behind the mute relays: a 10-bit ADC reading an RC-filtered, noisy view of the connected channel.
+struct SimulatedSense {
+    float offset[4];     // Each amplifier's own output offset, in duty counts
+    float gain[4];       // Sense counts per duty count; negative for an inverting amplifier, 0 when not wired
+    float curve;         // Square-law bend of the sense, counts per count squared
+    float biasCounts;    // Reading with every channel muted
+    float tauMs;
+    float noiseCounts;
+    float filtered;
+    Random rng;
+
+    float read(int8_t channel, const DcOffsetCalibrator& cal) {
+        float target = biasCounts;
+        if (channel >= 0) {
+            float volts = offset[channel] + cal.getAppliedCounts((uint8_t)channel);
+            target += gain[channel] * volts + curve * volts * fabsf(volts);
+        }
+        filtered += (target - filtered) / tauMs;
+        float raw = roundf(filtered + (float)(noiseCounts * rng.gaussian()));
+        return raw < 0.0f ? 0.0f : (raw > 1023.0f ? 1023.0f : raw);
+    }
+};
+
+static DcOffsetParams offsetParams() {
+    DcOffsetParams params;
+    params.settleMs = 300;
+    params.averageMs = 400;
+    params.probeCounts = 8.0f;
+    params.toleranceCounts = 0.1f;
+    params.maxCounts = 40.0f;
+    params.minGain = 0.2f;
+    params.maxIterations = 6;
+    return params;
+}
+
+static SimulatedSense sense(uint32_t seed) {
+    SimulatedSense s = {{3.7f, -6.2f, 11.5f, -0.8f}, {2.0f, 1.6f, -1.8f, 2.4f}, 0.0f, 512.0f, 50.0f, 1.5f, 512.0f, {seed}};
+    return s;
+}
+
+// Runs a calibration at 1 ms sampling, as the motor loop does. Returns the time it took in ms, or 0 if it never ended.
+static uint32_t run(DcOffsetCalibrator& cal, SimulatedSense& s, const float start[4], uint8_t channels) {
+    cal.begin(offsetParams(), channels, start, 0);
+    for (uint32_t now = 1; now < 120000; now++) {
+        if (!cal.update(s.read(cal.getSelectedChannel(), cal), now)) return now;
+    }
+    return 0;
+}
+
+static float trueResidual(const SimulatedSense& s, const DcOffsetCalibrator& cal, uint8_t channel) {
+    return s.offset[channel] + cal.getChannel(channel).offsetCounts;
+}
+
+static void testNullsFourChannels() {
+    const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    SimulatedSense s = sense(21);
+    DcOffsetCalibrator cal;
+    uint32_t firstMs = run(cal, s, zero, 4);
+    CHECK(firstMs > 0 && firstMs < 15000);
+    CHECK(cal.succeeded());
+    float stored[4];
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        CHECK(cal.getChannel(ch).outcome == DC_OFFSET_NULLED);
+        // The measured residual is within tolerance; the real one, without noise, only a little wider.
+        CHECK(fabsf(trueResidual(s, cal, ch)) < 0.2f);
+        stored[ch] = cal.getChannel(ch).offsetCounts;
+    }
+    // The inverting channel's gain came out negative.
+    CHECK(cal.getChannel(2).gain < -1.0f);
+
+    // Re-running from the stored corrections starts inside tolerance and finishes sooner.
+    DcOffsetCalibrator again;
+    uint32_t againMs = run(again, s, stored, 4);
+    CHECK(again.succeeded());
+    CHECK(againMs > 0 && againMs < firstMs);
+    for (uint8_t ch = 0; ch < 4; ch++) CHECK(fabsf(trueResidual(s, again, ch)) < 0.2f);
+}
+
+static void testCurvedSense() {
+    const float zero[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    SimulatedSense s = sense(22);
+    // About 13% bend at the largest offset here, so the probe gain is only a first guess.
+    s.curve = 0.02f;
+    DcOffsetCalibrator cal;
+    CHECK(run(cal, s, zero, 4) > 0);
+    CHECK(cal.succeeded());
+    for (uint8_t ch = 0; ch < 4; ch++) CHECK(fabsf(trueResidual(s, cal, ch)) < 0.2f);
+}
+
+static void testFaultyChannelsKeepStart() {
+    const float start[4] = {1.0f, -2.0f, 0.5f, 0.0f};
+    SimulatedSense s = sense(23);
+    s.gain[1] = 0.0f;        // Not wired to the sense
+    s.offset[2] = 60.0f;     // Too far off to be an offset
+    DcOffsetCalibrator cal;
+    CHECK(run(cal, s, start, 4) > 0);
+    CHECK(!cal.succeeded());
+    CHECK(cal.getChannel(0).outcome == DC_OFFSET_NULLED);
+    CHECK(cal.getChannel(1).outcome == DC_OFFSET_NO_RESPONSE);
+    CHECK(cal.getChannel(1).offsetCounts == start[1]);
+    CHECK(cal.getChannel(2).outcome == DC_OFFSET_OUT_OF_RANGE);
+    CHECK(cal.getChannel(2).offsetCounts == start[2]);
+    CHECK(cal.getChannel(3).outcome == DC_OFFSET_NULLED);
+}
+
+static void testCancelRestoresStart() {
+    const float start[4] = {1.0f, -2.0f, 0.5f, 3.0f};
+    SimulatedSense s = sense(24);
+    DcOffsetCalibrator cal;
+    cal.begin(offsetParams(), 4, start, 0);
+    uint32_t now = 1;
+    // Run until the second channel is being worked on, then stop.
+    while (cal.getSelectedChannel() != 1 || cal.getStep() != DC_OFFSET_PROBE) {
+        cal.update(s.read(cal.getSelectedChannel(), cal), now++);
+        CHECK(now < 60000);
+        if (now >= 60000) return;
+    }
+    cal.cancel();
+    CHECK(!cal.isRunning());
+    CHECK(cal.getChannel(0).outcome == DC_OFFSET_NULLED);
+    for (uint8_t ch = 1; ch < 4; ch++) {
+        CHECK(cal.getChannel(ch).outcome == DC_OFFSET_CANCELLED);
+        CHECK(cal.getAppliedCounts(ch) == start[ch]);
+        CHECK(cal.getChannel(ch).offsetCounts == start[ch]);
+    }
+}
+
+static void testStorage() {
+    float worst = 0.0f;
+    for (float counts = -40.0f; counts <= 40.0f; counts += 0.0137f) {
+        float back = dcOffsetFromStored(dcOffsetToStored(counts, 40.0f));
+        if (fabsf(back - counts) > worst) worst = fabsf(back - counts);
+    }
+    CHECK(worst <= 0.5f / 256.0f + 1e-6f);
+    CHECK(dcOffsetFromStored(dcOffsetToStored(100.0f, 40.0f)) == 40.0f);
+    CHECK(dcOffsetFromStored(dcOffsetToStored(-100.0f, 40.0f)) == -40.0f);
+    CHECK(dcOffsetToStored(NAN, 40.0f) == 0);
+}
+
+int main() {
+    testNullsFourChannels();
+    testCurvedSense();
+    testFaultyChannelsKeepStart();
+    testCancelRestoresStart();
+    testStorage();
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Ping-pong DMA blocks of changing length: the played stream stays continuous in phase, and a new tune reaches the
+// output within two blocks.
+
+#include "check.h"
+#include "dds_fixture.h"
+
+static const int SHORT_BLOCK = 32;  // DMA_BLOCK_SHORT_SAMPLES
+static const int LONG_BLOCK = 512;  // DMA_BLOCK_LONG_SAMPLES
+
+// Core 1's accumulator as fillBuffer keeps it.
+struct Accumulator {
+    uint32_t phase;
+    uint32_t frac;
+    uint64_t remainderAcc;
+};
+
+// Fills one block the way fillBuffer does, recording each sample's 32.32 phase.
+static void fillBlock(Accumulator& acc, const DdsRationalIncrement& inc, int length, uint64_t* out) {
+    uint32_t whole = (uint32_t)(inc.increment >> 32);
+    uint32_t fraction = (uint32_t)inc.increment;
+    for (int i = 0; i < length; i++) {
+        out[i] = ((uint64_t)acc.phase << 32) | acc.frac;
+        ddsAdvance(acc.phase, acc.frac, whole, fraction);
+    }
+    uint32_t carry = ddsBlockCarry(inc.unitCarry, inc.unitRemainder, inc.denominator, length / (int)BLOCK_UNIT, acc.remainderAcc);
+    uint64_t phase = (((uint64_t)acc.phase << 32) | acc.frac) + carry;
+    acc.phase = (uint32_t)(phase >> 32);
+    acc.frac = (uint32_t)phase;
+}
+
+static void testLengthChangesAreSeamless() {
+    DdsClock clock = clockFor(125000000);
+    DdsRationalIncrement inc;
+    CHECK(ddsRationalIncrement(100, 3, false, clock, BLOCK_UNIT, inc));
+    CHECK(inc.denominator != 0);
+
+    // Ping-pong buffers allocated at the long length. DMA plays one while the other is refilled, and each is re-armed
+    // with the length it was filled with.
+    static uint64_t buffers[2][LONG_BLOCK];
+    int bufferLength[2] = {0, 0};
+    Accumulator acc = {0, 0, 0};
+    uint32_t noise = 2024;
+    bool lowLatency = false;
+    int changes = 0;
+    uint64_t played = 0;
+    int32_t previousSample = 0;
+    int worstStep = 0;
+    fillBlock(acc, inc, LONG_BLOCK, buffers[0]);
+    bufferLength[0] = LONG_BLOCK;
+    fillBlock(acc, inc, LONG_BLOCK, buffers[1]);
+    bufferLength[1] = LONG_BLOCK;
+
+    for (int block = 0; block < 200000; block++) {
+        int playing = block & 1;
+        for (int i = 0; i < bufferLength[playing]; i++) {
+            uint64_t phase = buffers[playing][i];
+            uint64_t exact = exactPhase(played, 100, 3, clock);
+            // Within a block the remainder waits for the block end, so a sample trails by under one LSB per sample.
+            CHECK(exact - phase <= (uint64_t)LONG_BLOCK);
+            // The waveform itself: no jump between any two played samples, at block boundaries included.
+            int32_t sample = (int32_t)lround(sin((double)(phase >> 32) * (6.283185307179586 / 4294967296.0)) * 511.0);
+            if (played > 0 && abs(sample - previousSample) > worstStep) worstStep = abs(sample - previousSample);
+            previousSample = sample;
+            played++;
+        }
+
+        // The buffer just played is refilled with the length the drive state asks for now.
+        noise = (noise * 1103515245u) + 12345u;
+        if (((noise >> 16) & 31) == 0) {
+            lowLatency = !lowLatency;
+            changes++;
+        }
+        int length = lowLatency ? SHORT_BLOCK : LONG_BLOCK;
+        fillBlock(acc, inc, length, buffers[playing]);
+        bufferLength[playing] = length;
+    }
+    CHECK(changes > 5000);
+    CHECK(played > 30000000ull);
+    // 100/3 Hz at 50 kHz moves a 511 sine by at most 2.2 counts per sample.
+    CHECK(worstStep <= 3);
+    // At a block end the accumulator is exact.
+    CHECK(((uint64_t)acc.phase << 32 | acc.frac) == exactPhase(played + (uint64_t)bufferLength[0] + bufferLength[1], 100, 3, clock));
+}
+
+static void testTuneChangeLatency() {
+    // Event model: a buffer is refilled from the current tune as soon as it finishes playing, then waits for the other
+    // buffer to play. A tune issued during a block is picked up at that block's end and heard one block later.
+    uint32_t noise = 77;
+    const int modes[] = {SHORT_BLOCK, LONG_BLOCK};
+    for (int length : modes) {
+        // Start from the other length so the change-over blocks are covered as well.
+        int bufferLength[2];
+        bufferLength[0] = length == SHORT_BLOCK ? LONG_BLOCK : SHORT_BLOCK;
+        bufferLength[1] = bufferLength[0];
+        uint64_t now = 0;
+        int worstLatency = 0;
+        for (int block = 0; block < 20000; block++) {
+            int playing = block & 1;
+            uint64_t start = now;
+            now += (uint64_t)bufferLength[playing];
+            noise = (noise * 1103515245u) + 12345u;
+            uint64_t issued = start + (noise >> 16) % (uint64_t)bufferLength[playing];
+            int latency = (int)(now + (uint64_t)bufferLength[1 - playing] - issued);
+            if (block > 2 && latency > worstLatency) worstLatency = latency;
+            bufferLength[playing] = length;
+        }
+        CHECK(worstLatency <= 2 * length);
+        // About a millisecond at the 50 kHz carrier once blocks are short.
+        if (length == SHORT_BLOCK) CHECK(worstLatency <= 64);
+    }
+}
+
+static void testRoundedPathIsSeamlessToo() {
+    // Frequencies with no small fraction have no remainder to carry; block boundaries are plain sample steps.
+    DdsRationalIncrement inc;
+    inc.increment = ddsRoundedIncrement(47.1234f, ddsSampleRateHz(clockFor(125000000)));
+    inc.denominator = 0;
+    inc.unitCarry = 0;
+    inc.unitRemainder = 0;
+    Accumulator acc = {0, 0, 0};
+    static uint64_t block[LONG_BLOCK];
+    uint64_t expected = 0;
+    const int lengths[] = {SHORT_BLOCK, LONG_BLOCK, SHORT_BLOCK, SHORT_BLOCK, LONG_BLOCK};
+    for (int length : lengths) {
+        fillBlock(acc, inc, length, block);
+        for (int i = 0; i < length; i++) {
+            CHECK(block[i] == expected);
+            expected += inc.increment;
+        }
+    }
+}
+
+int main() {
+    testLengthChangesAreSeamless();
+    testTuneChangeLatency();
+    testRoundedPathIsSeamlessToo();
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Long DDS runs: accumulated phase error of the 32-bit, rounded 32.32, and rational 32.32 increments against the exact
+// target frequency.
+
+#include "check.h"
+#include "dds_fixture.h"
+
+static const uint64_t RUN_SAMPLES = 1ull << 33; // About 48 hours at the 50 kHz carrier
+
+static double phaseErrorDegrees(uint64_t simulated, uint64_t exact) {
+    return (double)(int64_t)(simulated - exact) * (360.0 / 18446744073709551616.0);
+}
+
+// Runs the rational increment the way the buffer fill does: whole increments per sample, the remainder per block unit.
+static uint64_t runRational(const DdsRationalIncrement& inc, bool reverse, uint64_t samples) {
+    uint64_t phase = 0;
+    uint64_t remainderAcc = 0;
+    uint64_t unitStep = inc.increment * BLOCK_UNIT;
+    for (uint64_t unit = 0; unit < samples / BLOCK_UNIT; unit++) {
+        uint64_t carry = inc.unitCarry;
+        if (inc.denominator != 0) {
+            remainderAcc += inc.unitRemainder;
+            if (remainderAcc >= inc.denominator) {
+                remainderAcc -= inc.denominator;
+                carry++;
+            }
+        }
+        phase += unitStep + (reverse ? (uint64_t)0 - carry : carry);
+    }
+    return phase;
+}
+
+static void testRationalFrequencies() {
+    uint64_t h, k;
+    CHECK(ddsRationalFrequency(50.0f, 1000, h, k) && h == 50 && k == 1);
+    CHECK(ddsRationalFrequency(67.5f, 1000, h, k) && h == 135 && k == 2);
+    CHECK(ddsRationalFrequency(100.0f / 3.0f, 1000, h, k) && h == 100 && k == 3);
+    CHECK(ddsRationalFrequency(-45.0f, 1000, h, k) && h == 45 && k == 1);
+    // Denominators above the cap, and frequencies with no small fraction, stay on the rounded path.
+    CHECK(!ddsRationalFrequency(100.0f / 3.0f, 2, h, k));
+    CHECK(!ddsRationalFrequency(50.0001f, 1000, h, k));
+    CHECK(!ddsRationalFrequency(NAN, 1000, h, k));
+}
+
+static void testIncrementEdges() {
+    DdsClock clock = clockFor(125000000);
+    DdsRationalIncrement inc;
+    // At or above the sample rate there is no increment below one cycle.
+    CHECK(!ddsRationalIncrement(60000, 1, false, clock, BLOCK_UNIT, inc));
+    // A frequency that divides the sample rate evenly needs no carried remainder.
+    double rate = ddsSampleRateHz(clock);
+    CHECK(ddsRationalIncrement(0, 1, false, clock, BLOCK_UNIT, inc) && inc.increment == 0 && inc.denominator == 0);
+    CHECK(ddsRoundedIncrement(NAN, rate) == 0);
+    CHECK(ddsRoundedIncrement(50.0f, 0.0) == 0);
+}
+
+static void testLongRunPhaseError() {
+    const uint32_t clocks[] = {125000000, 150000000};
+    const float freqs[] = {50.0f, 67.5f, 100.0f / 3.0f};
+    printf("Phase error after %llu samples, degrees:\n", (unsigned long long)RUN_SAMPLES);
+    printf("  clock     freq        32-bit      32.32 rounded  32.32 rational\n");
+    for (uint32_t clockHz : clocks) {
+        DdsClock clock = clockFor(clockHz);
+        double rate = ddsSampleRateHz(clock);
+        for (float freq : freqs) {
+            uint64_t h, k;
+            CHECK(ddsRationalFrequency(freq, 1000, h, k));
+            uint64_t exact = exactPhase(RUN_SAMPLES, h, k, clock);
+
+            uint32_t inc32 = (uint32_t)llround((double)freq * 4294967296.0 / rate);
+            uint32_t phase32 = (uint32_t)(RUN_SAMPLES * inc32);
+            double error32 = phaseErrorDegrees((uint64_t)phase32 << 32, exact);
+
+            double errorRounded = phaseErrorDegrees(RUN_SAMPLES * ddsRoundedIncrement(freq, rate), exact);
+
+            DdsRationalIncrement inc;
+            CHECK(ddsRationalIncrement(h, k, false, clock, BLOCK_UNIT, inc));
+            double errorRational = phaseErrorDegrees(runRational(inc, false, RUN_SAMPLES), exact);
+            printf("  %3u MHz  %9.6f  %11.4g  %13.4g  %14.4g\n", clockHz / 1000000, (double)freq, error32, errorRounded,
+                   errorRational);
+
+            // The rational accumulator lands on the exact phase, rounded down to the LSB.
+            CHECK(errorRational == 0.0);
+            // A 32-bit increment drifts by degrees over a long run; the rounded 32.32 one only does where the float
+            // frequency itself is off, as 33.333332 is from 100/3.
+            CHECK(fabs(error32) > 1.0);
+            if (k == 1 || k == 2) CHECK(fabs(errorRounded) < 1e-4);
+        }
+    }
+}
+
+static void testReverseRun() {
+    DdsClock clock = clockFor(125000000);
+    DdsRationalIncrement inc;
+    CHECK(ddsRationalIncrement(100, 3, true, clock, BLOCK_UNIT, inc));
+    const uint64_t samples = 1ull << 28;
+    uint64_t exact = exactPhase(samples, 100, 3, clock);
+    // Reverse runs the same phase backwards. The remainder is subtracted, so the result is the exact phase rounded
+    // towards the start rather than down.
+    uint64_t reversed = runRational(inc, true, samples);
+    double error = phaseErrorDegrees((uint64_t)0 - reversed, exact);
+    CHECK(fabs(error) < 1e-15);
+}
+
+int main() {
+    testRationalFrequencies();
+    testIncrementEdges();
+    testLongRunPhaseError();
+    testReverseRun();
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// FIR designer against reference Kaiser designs, and the integer symmetric filter against the designed response.
+
+#include "check.h"
+#include "fir_design.h"
+#include "output_filter.h"
+
+struct ReferenceDesign {
+    float sampleRateHz;
+    FirDesignParams params;
+    uint8_t referenceTaps;   // Kaiser's order estimate, before the tap budget applies
+    uint8_t taps;            // Length after the tap budget
+    double half[FIR_MAX_HALF_TAPS];
+    double cutoffDb;         // Reference response at the cutoff
+    double stopbandEdgeDb;   // Reference response at cutoff + transition / 2
+};
+
+// scipy.signal.firwin(taps, cutoff, window=('kaiser', kaiser_beta(stopband)), fs=rate), outer tap first; lengths
+// from scipy.signal.kaiserord(stopband, transition / (rate / 2)).
+static const ReferenceDesign REFERENCES[] = {
+    {50000.0f, {8000.0f, 8000.0f, 32, 50.0f}, 20, 20,
+     {-0.00023297, 0.00371251, 0.00918172, 0.00423953, -0.01914878, -0.04328944, -0.02528713, 0.06495853, 0.20121418,
+      0.30465184}, -6.037, -60.46},
+    {50000.0f, {4000.0f, 3000.0f, 32, 50.0f}, 50, 32,
+     {0.00114231, 0.00181004, 0.00169822, 0.0, -0.00374577, -0.00916715, -0.01473805, -0.01783545, -0.01527868,
+      -0.00427315, 0.01650654, 0.04607240, 0.08087320, 0.11532737, 0.14306493, 0.15854323}, -5.978, -22.08},
+    {20000.0f, {3000.0f, 4000.0f, 16, 40.0f}, 13, 13,
+     {-0.00460233, -0.01968032, -0.02325268, 0.02250951, 0.12851422, 0.24689097, 0.29924125}, -6.066, -46.17},
+    {100000.0f, {10000.0f, 8000.0f, 12, 60.0f}, 47, 12,
+     {-0.00042151, 0.00308658, 0.02682743, 0.08437802, 0.16348583, 0.22264364}, -4.745, -9.705},
+    {50000.0f, {5000.0f, 6000.0f, 7, 45.0f}, 23, 7,
+     {0.01390792, 0.09883024, 0.23476144, 0.30500082}, -2.647, -7.036},
+};
+static const int REFERENCE_COUNT = (int)(sizeof(REFERENCES) / sizeof(REFERENCES[0]));
+
+// Amplitude of a sine at freqHz after the integer filter path, relative to its input, in dB.
+static double measuredResponseDb(const FirKernel& kernel, double freqHz, double sampleRateHz) {
+    const double amplitude = 10000.0;
+    const double twoPi = 6.283185307179586;
+    OutputFilter filter;
+    double sinSum = 0.0, cosSum = 0.0;
+    // Whole cycles only, so the correlation does not leak at low frequencies.
+    int settle = 2 * FIR_MAX_TAPS;
+    int count = (int)lround(ceil(20000.0 * freqHz / sampleRateHz) * sampleRateHz / freqHz);
+    for (int n = 0; n < settle + count; n++) {
+        double phase = twoPi * freqHz * n / sampleRateHz;
+        float in = (float)lround(amplitude * sin(phase));
+        float out = filter.process(in, OUTPUT_FILTER_FIR, 0.5f, kernel, OUTPUT_FILTER_FIR, 0.5f, kernel, 1.0f);
+        if (n >= settle) {
+            sinSum += out * sin(phase);
+            cosSum += out * cos(phase);
+        }
+    }
+    double measured = 2.0 * sqrt(sinSum * sinSum + cosSum * cosSum) / count;
+    return 20.0 * log10(measured / amplitude);
+}
+
+static void testCoefficientsMatchReference() {
+    for (int d = 0; d < REFERENCE_COUNT; d++) {
+        const ReferenceDesign& ref = REFERENCES[d];
+        FirKernel kernel;
+        CHECK(designLowPassFir(ref.params, ref.sampleRateHz, kernel));
+        CHECK(kernel.taps == ref.taps);
+        // Unconstrained designs take Kaiser's length; capped ones stop at the budget.
+        CHECK(kernel.taps == (ref.referenceTaps < ref.params.tapBudget ? ref.referenceTaps : ref.params.tapBudget));
+        int halfCount = (kernel.taps + 1) / 2;
+        int32_t total = 0;
+        for (int i = 0; i < halfCount; i++) {
+            // Q15 rounding, with the leftover folded into the centre tap.
+            CHECK_NEAR(kernel.half[i] / 32768.0, ref.half[i], 3e-4);
+            bool centreTap = (kernel.taps & 1) && i == halfCount - 1;
+            total += centreTap ? kernel.half[i] : 2 * kernel.half[i];
+        }
+        CHECK(total == 32768);
+    }
+}
+
+static void testResponseMatchesReference() {
+    for (int d = 0; d < REFERENCE_COUNT; d++) {
+        const ReferenceDesign& ref = REFERENCES[d];
+        FirKernel kernel;
+        designLowPassFir(ref.params, ref.sampleRateHz, kernel);
+        float cutoff = ref.params.cutoffHz;
+        float edge = cutoff + ref.params.transitionHz * 0.5f;
+        CHECK_NEAR(firResponseDb(kernel, cutoff, ref.sampleRateHz), ref.cutoffDb, 0.05);
+        // Q15 coefficients put a floor near -90 dB, so deep stopband values are compared more loosely.
+        CHECK_NEAR(firResponseDb(kernel, edge, ref.sampleRateHz), ref.stopbandEdgeDb, ref.stopbandEdgeDb < -40.0 ? 1.5 : 0.1);
+        CHECK_NEAR(firResponseDb(kernel, 33.85f, ref.sampleRateHz), 0.0, 0.01);
+
+        // The width reported with a kernel is where its stopband starts. Kaiser's estimate runs a few dB short for
+        // kernels this short: 2.6 dB at 13 taps and 40 dB, 3.6 dB at 12 taps and 60 dB, 4.4 dB at 7 taps and 45 dB.
+        float worst = -200.0f;
+        for (float f = cutoff + kernel.transitionHz * 0.5f; f < ref.sampleRateHz * 0.5f; f += 10.0f) {
+            float db = firResponseDb(kernel, f, ref.sampleRateHz);
+            if (db > worst) worst = db;
+        }
+        CHECK(worst < -(kernel.stopbandDb - 5.0f));
+    }
+}
+
+static void testIntegerPathMatchesDesign() {
+    for (int d = 0; d < REFERENCE_COUNT; d++) {
+        const ReferenceDesign& ref = REFERENCES[d];
+        FirKernel kernel;
+        designLowPassFir(ref.params, ref.sampleRateHz, kernel);
+        const double freqs[4] = {33.85, ref.params.cutoffHz * 0.5, ref.params.cutoffHz, ref.params.cutoffHz + ref.params.transitionHz * 0.5};
+        for (int f = 0; f < 4; f++) {
+            double designed = firResponseDb(kernel, (float)freqs[f], ref.sampleRateHz);
+            double measured = measuredResponseDb(kernel, freqs[f], ref.sampleRateHz);
+            CHECK_NEAR(measured, designed, designed < -40.0 ? 2.0 : 0.05);
+        }
+    }
+}
+
+static void testRejectsUnusableRate() {
+    FirKernel kernel;
+    FirDesignParams params = {8000.0f, 8000.0f, 32, 50.0f};
+    CHECK(!designLowPassFir(params, 0.0f, kernel));
+    CHECK(kernel.taps == 0);
+    CHECK(!designLowPassFir(params, NAN, kernel));
+    CHECK(firResponseDb(kernel, 1000.0f, 50000.0f) == 0.0f);
+    // Out-of-range budgets are clamped rather than trusted.
+    params.tapBudget = 200;
+    CHECK(designLowPassFir(params, 50000.0f, kernel));
+    CHECK(kernel.taps <= FIR_MAX_TAPS);
+    params.tapBudget = 0;
+    designLowPassFir(params, 50000.0f, kernel);
+    CHECK(kernel.taps == FIR_MIN_TAPS);
+}
+
+int main() {
+    testCoefficientsMatchReference();
+    testResponseMatchesReference();
+    testIntegerPathMatchesDesign();
+    testRejectsUnusableRate();
+    return 0;
+}
@@ -0,0 +1,138 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Needle drops and lifts replayed through the speed loop: detection, step learning, and the feed-forward path
+// through the slew limit.
+
+#include "check.h"
+#include "load_step.h"
+
+struct DropSession {
+    int drops;
+    int lifts;
+    float learnedHz;
+    double peakSagRpm[4];     // Largest slow error after each drop
+    double sagRpmSec[4];      // Slow error integrated over the ten seconds after each drop
+};
+
+// Platter speed lags drive frequency with a 0.5 s time constant and slips by slipRpm while the stylus is down.
+// Sensor noise and 0.55 Hz wow ride on the measurement. The loop runs at 10 Hz with the firmware's PI, integral clamp,
+// correction clamp and slew limit, and handles drops and lifts as the motor does. exemptFeedForward selects whether
+// the learned step passes the slew limit whole or is rate limited like any other change.
+static DropSession replaySession(double slipRpm, double slewHzPerSec, bool exemptFeedForward) {
+    const double rpmPerHz = 0.6667, targetRpm = 33.3333, tau = 0.5;
+    const double kp = 0.5, ki = 0.3, integralLimit = 1.0, correctionLimit = 3.0;
+    const double dt = 0.1;
+    LoadStepParams params = {0.06f, 3, 0.03f, 3, 2.0f, 2.0f, 30.0f};
+    LoadStepDetector detector;
+    detector.configure(params);
+
+    DropSession session = {0, 0, 0.0f, {0.0, 0.0, 0.0, 0.0}, {0.0, 0.0, 0.0, 0.0}};
+    double platter = targetRpm, integral = 0.0, correction = 0.0;
+    float appliedHz = 0.0f;
+    bool loaded = false;
+    uint32_t noise = 777;
+    // Side one: drop at 20 s, lift at 80 s; repeated every 100 s.
+    for (int step = 0; step < 4000; step++) {
+        double t = step * dt;
+        double cycle = fmod(t, 100.0);
+        bool down = cycle >= 20.0 && cycle < 80.0;
+        int dropIndex = (int)(t / 100.0);
+
+        // The platter settles within each 100 ms update, so integrate it finely.
+        double driveRpm = rpmPerHz * (50.0 + correction) - (down ? slipRpm : 0.0);
+        for (int i = 0; i < 10; i++) platter += (driveRpm - platter) * (dt / 10.0) / tau;
+        noise = (noise * 1103515245u) + 12345u;
+        double jitter = (((double)((noise >> 16) & 0x7fff) / 32767.0) - 0.5) * 0.01;
+        double measured = platter + jitter + (0.005 * sin(6.283185307 * 0.55 * t));
+        double error = targetRpm - measured;
+        bool locked = fabs(error) <= 0.05;
+
+        LoadStepEvent event = detector.update((float)error, (float)dt, locked, (float)integral);
+        double integralBefore = integral;
+        if (event == LOAD_STEP_DROP) {
+            session.drops++;
+            if (session.learnedHz > 0.0f) {
+                integral += session.learnedHz;
+                appliedHz = session.learnedHz;
+                loaded = true;
+            }
+        } else if (event == LOAD_STEP_LIFT) {
+            session.lifts++;
+            if (loaded) integral -= appliedHz;
+            loaded = false;
+        }
+        if (integral > integralLimit) integral = integralLimit;
+        if (integral < -integralLimit) integral = -integralLimit;
+        double feedForward = integral - integralBefore;
+        LoadStepEvent measuredEvent;
+        float stepHz;
+        bool settled;
+        if (detector.takeMeasurement(measuredEvent, stepHz, settled) && measuredEvent == LOAD_STEP_DROP && stepHz > 0.0f) {
+            session.learnedHz = session.learnedHz > 0.0f ? session.learnedHz + (0.5f * (stepHz - session.learnedHz)) : stepHz;
+        }
+
+        integral += ki * error * dt;
+        if (integral > integralLimit) integral = integralLimit;
+        if (integral < -integralLimit) integral = -integralLimit;
+        double requested = (kp * error) + integral;
+        if (requested > correctionLimit) requested = correctionLimit;
+        if (requested < -correctionLimit) requested = -correctionLimit;
+        correction = loadStepSlewLimit((float)correction, (float)requested, (float)(slewHzPerSec * dt),
+                                       exemptFeedForward ? (float)feedForward : 0.0f);
+
+        if (down && cycle < 30.0 && dropIndex < 4) {
+            if (error > session.peakSagRpm[dropIndex]) session.peakSagRpm[dropIndex] = error;
+            if (error > 0.0) session.sagRpmSec[dropIndex] += error * dt;
+        }
+    }
+    return session;
+}
+
+static void testSlewLimit() {
+    // Without feed-forward the change is limited either way; a feed-forward step is added on top of the limit.
+    CHECK_NEAR(loadStepSlewLimit(0.0f, 1.0f, 0.05f, 0.0f), 0.05f, 1e-6f);
+    CHECK_NEAR(loadStepSlewLimit(0.0f, -1.0f, 0.05f, 0.0f), -0.05f, 1e-6f);
+    CHECK_NEAR(loadStepSlewLimit(0.0f, 0.32f, 0.05f, 0.3f), 0.32f, 1e-6f);
+    CHECK_NEAR(loadStepSlewLimit(0.0f, 1.0f, 0.05f, 0.3f), 0.35f, 1e-6f);
+    CHECK_NEAR(loadStepSlewLimit(0.3f, 0.0f, 0.05f, -0.3f), 0.0f, 1e-6f);
+    // No limit configured.
+    CHECK_NEAR(loadStepSlewLimit(0.0f, 1.0f, 0.0f, 0.0f), 1.0f, 1e-6f);
+}
+
+static void testDetectsAndLearns() {
+    // Every drop and lift is seen through the noise and wow, and the learned step matches the slip it carries.
+    DropSession session = replaySession(0.2, 0.5, true);
+    CHECK(session.drops == 4);
+    CHECK(session.lifts == 4);
+    CHECK_NEAR(session.learnedHz, 0.2 / 0.6667, 0.2 / 0.6667 * 0.2);
+}
+
+static void testFeedForwardBeatsSlewLimit() {
+    // With a slow slew limit, the learned step must arrive whole to shorten the sag after the second drop.
+    DropSession limited = replaySession(0.2, 0.05, false);
+    DropSession exempt = replaySession(0.2, 0.05, true);
+    CHECK(limited.drops == 4 && exempt.drops == 4);
+    // The first drop only learns, so both runs see the same sag there.
+    CHECK_NEAR(exempt.sagRpmSec[0], limited.sagRpmSec[0], limited.sagRpmSec[0] * 0.05);
+    for (int i = 1; i < 4; i++) {
+        CHECK(exempt.sagRpmSec[i] < limited.sagRpmSec[i] * 0.8);
+        CHECK(exempt.sagRpmSec[i] < exempt.sagRpmSec[0] * 0.6);
+        CHECK(exempt.peakSagRpm[i] < exempt.peakSagRpm[0]);
+    }
+    // Held back by the slew limit, the integral overshoots and teaches a step well above the slip; whole, it does not.
+    CHECK_NEAR(exempt.learnedHz, 0.2 / 0.6667, 0.2 / 0.6667 * 0.2);
+    CHECK(limited.learnedHz > exempt.learnedHz * 1.3f);
+}
+
+int main() {
+    testSlewLimit();
+    testDetectsAndLearns();
+    testFeedForwardBeatsSlewLimit();
+    return 0;
+}
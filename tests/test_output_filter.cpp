@@ -0,0 +1,174 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Per-speed tune crossfade during a speed ramp: torque-proxy continuity against publishing the new tune at once.
+
+#include "check.h"
+#include "output_filter.h"
+
+static const double SAMPLE_RATE = 50000.0;
+static const int BLOCK = 32;              // DMA_BLOCK_SHORT_SAMPLES while ramping
+static const int LOOP_SAMPLES = 500;      // The motor loop publishes the ramp every 10 ms
+static const double PHASE_SLEW = 180.0;   // Default phase slew, degrees per second
+static const double GAIN_SLEW = 0.5;      // Default gain slew, full scale per second
+static const double TWO_PI = 6.283185307179586;
+static const double ACC_PER_DEGREE = 4294967296.0 / 360.0;
+
+struct SpeedTune {
+    double frequency;
+    double offsetDegrees[2];
+    double gain[2];
+    uint8_t filter;
+    float iirAlpha;
+};
+
+struct RampResult {
+    double largestStep;   // Largest sample-to-sample change of the torque proxy
+    double lowestProxy;
+    double highestProxy;
+};
+
+// Two-phase drive ramped from one speed's tune to the other's over a second. The torque proxy is the sum over phases
+// of the filtered output times sin(theta + the phase's nominal offset), 1.0 for an undisturbed drive.
+static RampResult runRamp(const SpeedTune& from, const SpeedTune& to, bool crossfade) {
+    const int rampSamples = (int)SAMPLE_RATE;
+    const double nominal[2] = {0.0, 90.0};
+    OutputFilter filters[2];
+    FirKernel noKernel = {};
+    double theta = 0.0;
+    double appliedOffset[2] = {from.offsetDegrees[0], from.offsetDegrees[1]};
+    double appliedGain[2] = {from.gain[0], from.gain[1]};
+    double targetOffset[2] = {from.offsetDegrees[0], from.offsetDegrees[1]};
+    double targetGain[2] = {from.gain[0], from.gain[1]};
+    uint8_t filterType = from.filter, fromFilterType = from.filter;
+    float iirAlpha = from.iirAlpha, fromIirAlpha = from.iirAlpha;
+    float blend = 1.0f;
+    bool crossfadeActive = false;
+    float lastOutput[2] = {0.0f, 0.0f};
+    RampResult result = {0.0, 10.0, -10.0};
+    double previousProxy = 0.0;
+
+    // A second of the outgoing tune settles the filters before the ramp starts.
+    for (int n = -rampSamples; n < rampSamples + 10000; n++) {
+        double progress = n < 0 ? 0.0 : (n >= rampSamples ? 1.0 : (double)n / rampSamples);
+        if (n >= 0 && n % LOOP_SAMPLES == 0) {
+            // Core 0 publishes a tune: the whole new one at the start without crossfade, the blend every loop with it.
+            if (crossfade && progress < 1.0) {
+                for (int k = 0; k < 2; k++) {
+                    uint32_t acc = crossfadePhaseOffset((uint32_t)(from.offsetDegrees[k] * ACC_PER_DEGREE),
+                                                        (uint32_t)(to.offsetDegrees[k] * ACC_PER_DEGREE), (float)progress);
+                    targetOffset[k] = acc / ACC_PER_DEGREE;
+                    targetGain[k] = crossfadeLevel((float)from.gain[k], (float)to.gain[k], (float)progress);
+                }
+                fromFilterType = from.filter;
+                fromIirAlpha = from.iirAlpha;
+                filterType = to.filter;
+                iirAlpha = to.iirAlpha;
+                bool same = from.filter == to.filter && from.iirAlpha == to.iirAlpha;
+                blend = same ? 1.0f : (float)progress;
+            } else {
+                for (int k = 0; k < 2; k++) {
+                    targetOffset[k] = to.offsetDegrees[k];
+                    targetGain[k] = to.gain[k];
+                }
+                filterType = to.filter;
+                iirAlpha = to.iirAlpha;
+                blend = 1.0f;
+            }
+        }
+        if (n % BLOCK == 0) {
+            // Core 1 takes the tune at a block start and slews offsets and gains at the global rates.
+            bool crossfading = blend < 1.0f;
+            if (crossfading && !crossfadeActive) {
+                for (int k = 0; k < 2; k++) filters[k].beginCrossfade(fromFilterType, lastOutput[k]);
+            }
+            crossfadeActive = crossfading;
+            double phaseStep = PHASE_SLEW * BLOCK / SAMPLE_RATE, gainStep = GAIN_SLEW * BLOCK / SAMPLE_RATE;
+            for (int k = 0; k < 2; k++) {
+                double dOffset = targetOffset[k] - appliedOffset[k];
+                appliedOffset[k] += dOffset > phaseStep ? phaseStep : (dOffset < -phaseStep ? -phaseStep : dOffset);
+                double dGain = targetGain[k] - appliedGain[k];
+                appliedGain[k] += dGain > gainStep ? gainStep : (dGain < -gainStep ? -gainStep : dGain);
+            }
+        }
+
+        double frequency = from.frequency + ((to.frequency - from.frequency) * progress);
+        theta += TWO_PI * frequency / SAMPLE_RATE;
+        double proxy = 0.0;
+        for (int k = 0; k < 2; k++) {
+            float drive = (float)(511.0 * appliedGain[k] * sin(theta + (appliedOffset[k] * TWO_PI / 360.0)));
+            float out = filters[k].process(drive, filterType, iirAlpha, noKernel, fromFilterType, fromIirAlpha, noKernel, blend);
+            lastOutput[k] = out;
+            proxy += (out / 511.0) * sin(theta + (nominal[k] * TWO_PI / 360.0));
+        }
+        if (n >= 0) {
+            if (fabs(proxy - previousProxy) > result.largestStep) result.largestStep = fabs(proxy - previousProxy);
+            if (proxy < result.lowestProxy) result.lowestProxy = proxy;
+            if (proxy > result.highestProxy) result.highestProxy = proxy;
+        }
+        previousProxy = proxy;
+    }
+    return result;
+}
+
+static void testBlendHelpers() {
+    // 350 to 10 degrees goes through zero, not through 180.
+    uint32_t from = (uint32_t)(350.0 * ACC_PER_DEGREE), to = (uint32_t)(10.0 * ACC_PER_DEGREE);
+    CHECK_NEAR(crossfadePhaseOffset(from, to, 0.5f) / ACC_PER_DEGREE, 0.0, 1e-3);
+    CHECK_NEAR(crossfadePhaseOffset(from, to, 0.25f) / ACC_PER_DEGREE, 355.0, 1e-3);
+    CHECK(crossfadePhaseOffset(from, to, 0.0f) == from);
+    CHECK(crossfadePhaseOffset(from, to, 1.0f) == to);
+    CHECK(crossfadePhaseOffset(from, to, NAN) == from);
+    CHECK_NEAR(crossfadeLevel(1.0f, 1.15f, 0.5f), 1.075, 1e-6);
+    CHECK(crossfadeLevel(1.0f, 1.15f, 2.0f) == 1.15f);
+}
+
+static void testFilterCrossfadeStartsFromRunningOutput() {
+    FirKernel noKernel = {};
+    OutputFilter filter;
+    float last = 0.0f;
+    for (int n = 0; n < 100; n++) last = filter.process(300.0f, OUTPUT_FILTER_NONE, 0.5f, noKernel, OUTPUT_FILTER_NONE, 0.5f, noKernel, 1.0f);
+    // An incoming IIR starts from the last output, so blending into it does not pull the output towards zero.
+    filter.beginCrossfade(OUTPUT_FILTER_NONE, last);
+    float out = filter.process(300.0f, OUTPUT_FILTER_IIR, 0.05f, noKernel, OUTPUT_FILTER_NONE, 0.5f, noKernel, 0.5f);
+    CHECK_NEAR(out, 300.0, 1e-3);
+    // With no blend the IIR runs alone.
+    out = filter.process(400.0f, OUTPUT_FILTER_IIR, 0.05f, noKernel, OUTPUT_FILTER_NONE, 0.5f, noKernel, 1.0f);
+    CHECK_NEAR(out, 305.0, 1e-3);
+}
+
+static void testRampTorqueContinuity() {
+    // 33 to 45 on a two-phase motor: the new speed adds a 10 degree trim and 15% gain on phase B, and an IIR.
+    SpeedTune slow = {25.07, {0.0, 90.0}, {1.0, 1.0}, OUTPUT_FILTER_NONE, 0.5f};
+    SpeedTune fast = {33.85, {0.0, 100.0}, {1.0, 1.15}, OUTPUT_FILTER_IIR, 0.05f};
+    RampResult swapped = runRamp(slow, fast, false);
+    RampResult blended = runRamp(slow, fast, true);
+    printf("Torque proxy over the ramp: swap largest step %.4f range %.3f..%.3f; crossfade largest step %.4f range %.3f..%.3f\n",
+           swapped.largestStep, swapped.lowestProxy, swapped.highestProxy, blended.largestStep, blended.lowestProxy,
+           blended.highestProxy);
+    // Publishing at once restarts the IIR from an empty state: torque collapses for several milliseconds.
+    CHECK(swapped.lowestProxy < 0.5);
+    CHECK(swapped.largestStep > 0.02);
+    // The crossfade keeps torque within the trim's own change and free of steps.
+    CHECK(blended.lowestProxy > 0.9);
+    CHECK(blended.highestProxy < 1.25);
+    CHECK(blended.largestStep < swapped.largestStep * 0.1);
+
+    // And back down: the outgoing IIR keeps its state while its weight falls.
+    swapped = runRamp(fast, slow, false);
+    blended = runRamp(fast, slow, true);
+    CHECK(blended.lowestProxy > 0.9);
+    CHECK(blended.largestStep <= swapped.largestStep);
+}
+
+int main() {
+    testBlendHelpers();
+    testFilterCrossfadeStartsFromRunningOutput();
+    testRampTorqueContinuity();
+    return 0;
+}
@@ -0,0 +1,215 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Pulse tach duty tracking on simulated marginal signals: dirtying slots, threshold drift and a chattering optical edge.
+
+#include "check.h"
+#include "pulse_duty.h"
+#include "tach_debounce.h"
+#include "random.h"
+
+static const float TARGET_RPM = 33.333f;
+static const uint32_t CONFIGURED_DEBOUNCE_US = 50;
+static const float DUTY_MARGIN = 0.1f;   // SPEED_DUTY_MARGIN
+
+/*
+ * SpeedFeedback's pulse path counting rising edges: each pin change goes through the ISR's tachDebounceEdge, then the
+ * duty edge pairing and the Core 0 drain into the tracker against the period expected at the target speed. The window
+ * follows the measured duty as updateDebounceWindow does.
+ */
+struct TachModel {
+    PulseDutyTracker tracker;
+    uint16_t slots;
+    bool adaptiveWindow;
+    uint32_t debounceUs;
+    uint32_t lastAcceptedUs;
+    bool lastA;
+    uint32_t riseUs;
+    uint32_t fallUs;
+    bool fallSeen;
+    long counted;
+    long debounced;
+
+    void begin(uint16_t pulsesPerRev, bool adaptive) {
+        PulseDutyParams params = {(uint8_t)pulsesPerRev, 0.05f, 256, 0.08f, DUTY_MARGIN, 1.0f - DUTY_MARGIN};
+        tracker.configure(params);
+        slots = pulsesPerRev;
+        adaptiveWindow = adaptive;
+        debounceUs = CONFIGURED_DEBOUNCE_US;
+        lastAcceptedUs = 0;
+        lastA = false;
+        riseUs = 0;
+        fallUs = 0;
+        fallSeen = false;
+        counted = 0;
+        debounced = 0;
+    }
+
+    void updateWindow() {
+        if (!adaptiveWindow) return;
+        TachDebounceParams params = {0.25f, 0.5f};
+        float duty = tracker.getMeanDuty();
+        if (duty < DUTY_MARGIN) duty = DUTY_MARGIN;
+        if (duty > 1.0f - DUTY_MARGIN) duty = 1.0f - DUTY_MARGIN;
+        debounceUs = tachDebounceWindowUs(params, CONFIGURED_DEBOUNCE_US, TARGET_RPM, slots, 2, duty);
+    }
+
+    void pinChange(uint32_t nowUs, bool a) {
+        TachEdgeAction action = tachDebounceEdge(debounceUs, lastAcceptedUs, nowUs, (uint8_t)lastA, (uint8_t)a);
+        if (action == TACH_EDGE_DEBOUNCED) {
+            debounced++;
+            return;
+        }
+        lastA = a;
+        if (action == TACH_EDGE_UNCHANGED) return;
+        lastAcceptedUs = nowUs;
+        if (!a) {
+            if (riseUs != 0) {
+                fallUs = nowUs;
+                fallSeen = true;
+            }
+            return;
+        }
+        if (riseUs != 0 && fallSeen) {
+            uint32_t expectedUs = (uint32_t)(60000000.0f / (TARGET_RPM * (float)slots));
+            tracker.addSample(fallUs - riseUs, nowUs - riseUs, expectedUs);
+        }
+        riseUs = nowUs;
+        fallSeen = false;
+        counted++;
+    }
+
+    // One real transition, followed by bounces that flip the pin back and forth every 300 us.
+    void transition(double tUs, bool level, int bounces) {
+        pinChange((uint32_t)tUs, level);
+        for (int b = 0; b < bounces; b++) {
+            pinChange((uint32_t)(tUs + 300.0 + 600.0 * b), !level);
+            pinChange((uint32_t)(tUs + 600.0 + 600.0 * b), level);
+        }
+    }
+};
+
+typedef float (*SlotDuty)(int slot, double fraction);
+
+struct RunResult {
+    long pulses;
+    long counted;
+    double firstWarningSec[3];   // Drift, spread, marginal; -1 when never raised
+    PulseDutyStatus status;
+};
+
+// Drives the model with a strobe of the given slot count for the given time; fraction runs 0 to 1 over the run.
+static RunResult runStrobe(uint16_t slots, double seconds, SlotDuty duty, int bounces, bool adaptive, uint32_t seed) {
+    static TachModel model;
+    model.begin(slots, adaptive);
+    model.updateWindow();
+    Random rng = {seed};
+    double period = 60000000.0 / (TARGET_RPM * slots);
+    double t = 100000.0;
+    double nextUpdate = t;
+    RunResult result = {0, 0, {-1.0, -1.0, -1.0}, PulseDutyStatus()};
+    long pulses = (long)(seconds * 1e6 / period);
+    for (long n = 0; n < pulses; n++) {
+        double fraction = (double)n / pulses;
+        double jittered = period * (1.0 + 0.002 * (2.0 * rng.uniform() - 1.0));
+        model.transition(t, true, bounces);
+        model.transition(t + duty((int)(n % slots), fraction) * jittered, false, bounces);
+        t += jittered;
+        if (t >= nextUpdate) {
+            nextUpdate += 100000.0;
+            model.updateWindow();
+            uint8_t warnings = model.tracker.getWarnings();
+            for (int w = 0; w < 3; w++) {
+                if ((warnings & (1 << w)) && result.firstWarningSec[w] < 0.0) result.firstWarningSec[w] = t / 1e6;
+            }
+        }
+    }
+    result.pulses = pulses;
+    result.counted = model.counted;
+    result.status = model.tracker.getStatus();
+    return result;
+}
+
+static float healthyDuty(int slot, double) {
+    return 0.5f + 0.02f * (float)sin(slot * 2.4);
+}
+
+static float dirtyingSlot(int slot, double fraction) {
+    // Slot 7 closes up from 50% to 30% over the run.
+    return slot == 7 ? (float)(0.5 - 0.2 * fraction) : healthyDuty(slot, fraction);
+}
+
+static float driftingThreshold(int slot, double fraction) {
+    return healthyDuty(slot, fraction) - (float)(0.42 * fraction);
+}
+
+static float opticalDuty(int, double) {
+    return 0.3f;
+}
+
+static void testHealthyStrobeRaisesNothing() {
+    RunResult r = runStrobe(36, 1200.0, healthyDuty, 0, true, 1);
+    CHECK(r.counted == r.pulses);
+    CHECK(r.status.baselineValid);
+    CHECK(r.status.warnings == 0);
+    CHECK(r.firstWarningSec[0] < 0.0 && r.firstWarningSec[1] < 0.0 && r.firstWarningSec[2] < 0.0);
+    CHECK_NEAR(r.status.meanDuty, 0.5, 0.01);
+    CHECK(r.status.rejected == 0);
+}
+
+static void testDirtySlotRaisesSpread() {
+    RunResult r = runStrobe(36, 1200.0, dirtyingSlot, 0, true, 2);
+    printf("Dirtying slot: spread warning at %.0f s, slot range %.3f-%.3f\n", r.firstWarningSec[1], r.status.minSlotDuty, r.status.maxSlotDuty);
+    // The slot is caught well before it nears the marginal limit, and no edge has been lost by then.
+    CHECK(r.firstWarningSec[1] > 0.0 && r.firstWarningSec[1] < 900.0);
+    CHECK(r.firstWarningSec[0] < 0.0);
+    CHECK(r.firstWarningSec[2] < 0.0);
+    CHECK(r.counted == r.pulses);
+    CHECK_NEAR(r.status.minSlotDuty, 0.3, 0.02);
+}
+
+static void testThresholdDriftRaisesDrift() {
+    RunResult r = runStrobe(36, 1200.0, driftingThreshold, 0, true, 3);
+    printf("Drifting threshold: drift warning at %.0f s, marginal at %.0f s\n", r.firstWarningSec[0], r.firstWarningSec[2]);
+    CHECK(r.firstWarningSec[0] > 0.0);
+    CHECK(r.firstWarningSec[2] > r.firstWarningSec[0] + 300.0);
+    CHECK(r.counted == r.pulses);
+}
+
+static void testChatteringOpticalEdge() {
+    // One slot per revolution at 30% duty, three bounces on every edge.
+    RunResult fixed = runStrobe(1, 1200.0, opticalDuty, 3, false, 4);
+    RunResult adaptive = runStrobe(1, 1200.0, opticalDuty, 3, true, 4);
+    printf("Chattering optical: fixed window counts %ld of %ld, %u rejected; duty-aware counts %ld, mean %.3f, %u rejected\n",
+           fixed.counted, fixed.pulses, fixed.status.rejected, adaptive.counted, adaptive.status.meanDuty,
+           adaptive.status.rejected);
+    // A 50 us window lets every bounce through: the count runs away and the bounce pulses are all rejected.
+    CHECK(fixed.counted > 3 * fixed.pulses);
+    CHECK(fixed.status.rejected > (uint32_t)fixed.pulses);
+    // The window taken from the pulse's short side holds off the bounce on both edges.
+    CHECK(adaptive.counted == adaptive.pulses);
+    CHECK(adaptive.status.rejected == 0);
+    CHECK_NEAR(adaptive.status.meanDuty, 0.3, 0.005);
+}
+
+static void testNarrowPulseWindow() {
+    TachDebounceParams params = {0.25f, 0.5f};
+    uint32_t even = tachDebounceWindowUs(params, 50, TARGET_RPM, 1, 2, 0.0f);
+    uint32_t narrow = tachDebounceWindowUs(params, 50, TARGET_RPM, 1, 2, 0.1f);
+    CHECK_NEAR(narrow, even * 0.2, 2.0);
+    CHECK(tachDebounceWindowUs(params, 50, TARGET_RPM, 1, 2, 0.9f) == narrow);
+}
+
+int main() {
+    testHealthyStrobeRaisesNothing();
+    testDirtySlotRaisesSpread();
+    testThresholdDriftRaisesDrift();
+    testChatteringOpticalEdge();
+    testNarrowPulseWindow();
+    return 0;
+}
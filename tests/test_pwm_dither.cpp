@@ -0,0 +1,236 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Spread-spectrum carrier: generator spread, exact phase, and spectra of the generated PWM edge timing.
+
+#include "check.h"
+#include "dds_increment.h"
+#include "pwm_dither.h"
+
+static const uint8_t PERIOD_BITS = 10;
+static const uint16_t SPAN = 41;                 // PWM_DITHER_PERCENT of 4 on a 1024-count period
+static const double COUNT_HZ = 51.2e6;           // Counter clock giving a 50 kHz nominal carrier
+static const double DRIVE_HZ = 50.0;
+static const double AMPLITUDE = 0.8;
+static const int BLOCK = 512;
+static const int BLOCKS = 128;
+static const int SAMPLES = BLOCK * BLOCKS;
+static const double TWO_PI = 6.283185307179586;
+
+enum CarrierMode { CARRIER_FIXED, CARRIER_DITHERED, CARRIER_UNCOMPENSATED };
+
+// One PWM period: the output is high from start for width counts.
+struct Pulse {
+    double start;
+    int32_t width;
+    int32_t period;
+};
+
+static Pulse pulses[SAMPLES];
+
+/*
+ * Mirrors WaveformGenerator::fillBuffer's dither path: each block plays at the top the previous fill chose, its last
+ * sample at the next block's. Steps and duties are rescaled to each sample's period and the dropped step bits are
+ * carried between blocks. Returns false if the accumulator ever leaves the exact phase at a block boundary.
+ */
+static bool synthesise(CarrierMode mode) {
+    PwmDither dither;
+    PwmDitherParams params = {PERIOD_BITS, mode == CARRIER_FIXED ? (uint16_t)0 : SPAN};
+    dither.configure(params, 0x9E3779B9u);
+    uint64_t step = (uint64_t)((DRIVE_HZ / (COUNT_HZ / 1024.0)) * 18446744073709551616.0);
+    uint32_t phase = 0, frac = 0, remainderAcc = 0;
+    uint16_t wrap = dither.nominalWrap();
+    unsigned __int128 totalCounts = 0;
+    bool exact = true;
+    double t = 0.0;
+    for (int b = 0; b < BLOCKS; b++) {
+        uint16_t nextWrap = dither.nextWrap();
+        uint32_t remainder, lastRemainder;
+        uint64_t scaled = pwmDitherScaleStep(step, wrap, PERIOD_BITS, remainder);
+        uint64_t lastScaled = pwmDitherScaleStep(step, nextWrap, PERIOD_BITS, lastRemainder);
+        if (mode == CARRIER_UNCOMPENSATED) {
+            scaled = lastScaled = step;
+            remainder = lastRemainder = 0;
+        }
+        remainderAcc += remainder * (uint32_t)(BLOCK - 1) + lastRemainder;
+        for (int i = 0; i < BLOCK; i++) {
+            bool last = i == BLOCK - 1;
+            uint16_t top = last ? nextWrap : wrap;
+            uint64_t s = last ? lastScaled : scaled;
+            double angle = TWO_PI * ((((uint64_t)phase << 32) | frac) / 18446744073709551616.0);
+            int32_t duty = 512 + (int32_t)lround(AMPLITUDE * 511.0 * sin(angle));
+            if (mode != CARRIER_UNCOMPENSATED) duty = pwmDitherScaleDuty(duty, pwmDitherDutyScaleQ16(top, PERIOD_BITS));
+            Pulse& p = pulses[b * BLOCK + i];
+            p.start = t;
+            p.width = duty;
+            p.period = top + 1;
+            t += top + 1;
+            totalCounts += (unsigned)top + 1u;
+            ddsAdvance(phase, frac, (uint32_t)(s >> 32), (uint32_t)s);
+        }
+        uint64_t acc = ((uint64_t)phase << 32) | frac;
+        acc += remainderAcc >> PERIOD_BITS;
+        remainderAcc &= (1u << PERIOD_BITS) - 1u;
+        phase = (uint32_t)(acc >> 32);
+        frac = (uint32_t)acc;
+        // Phase is a share of a cycle per nominal sample time, so elapsed counts fix the exact phase.
+        uint64_t exactPhase = (uint64_t)(((unsigned __int128)step * totalCounts) >> PERIOD_BITS);
+        if (mode != CARRIER_UNCOMPENSATED && acc != exactPhase) exact = false;
+        wrap = nextWrap;
+    }
+    return exact;
+}
+
+static double window[SAMPLES];
+
+// Hann for carrier segments, Blackman-Harris for the whole record at baseband, at each pulse's centre.
+static void fillWindow(int first, int count, bool baseband) {
+    double spanStart = pulses[first].start;
+    const Pulse& end = pulses[first + count - 1];
+    double span = end.start + end.period - spanStart;
+    for (int i = first; i < first + count; i++) {
+        double x = (pulses[i].start + pulses[i].period * 0.5 - spanStart) / span;
+        window[i] = baseband
+            ? 0.35875 - 0.48829 * cos(TWO_PI * x) + 0.14128 * cos(2.0 * TWO_PI * x) - 0.01168 * cos(3.0 * TWO_PI * x)
+            : 0.5 - 0.5 * cos(TWO_PI * x);
+    }
+}
+
+/*
+ * Windowed spectrum magnitude of the pulse train at freqHz, as a sine amplitude in duty fraction. Pulse edges sit
+ * on whole counts, so rotations come from a table in half counts rather than trigonometry per pulse. Baseband takes
+ * each pulse's area at its centre, exact to parts per million at these frequencies; the carrier band integrates
+ * each rectangle exactly.
+ */
+static double magnitude(double freqHz, int first, int count, bool baseband) {
+    static double tableRe[2 * 1200], tableIm[2 * 1200];
+    double w = TWO_PI * freqHz / COUNT_HZ;
+    for (int k = 0; k < 2 * 1200; k++) {
+        tableRe[k] = cos(w * k * 0.5);
+        tableIm[k] = -sin(w * k * 0.5);
+    }
+    double rotRe = 1.0, rotIm = 0.0;   // e^(-jw(start - first start))
+    double re = 0.0, im = 0.0, norm = 0.0;
+    for (int i = first; i < first + count; i++) {
+        const Pulse& p = pulses[i];
+        norm += window[i] * p.period;
+        if (baseband) {
+            double cRe = tableRe[p.width], cIm = tableIm[p.width];
+            re += window[i] * p.width * (rotRe * cRe - rotIm * cIm);
+            im += window[i] * p.width * (rotRe * cIm + rotIm * cRe);
+        } else {
+            // Integral of e^(-jwt) over the rectangle: (e^(-jw start) - e^(-jw (start + width))) / jw.
+            double eRe = rotRe * tableRe[2 * p.width] - rotIm * tableIm[2 * p.width];
+            double eIm = rotRe * tableIm[2 * p.width] + rotIm * tableRe[2 * p.width];
+            re += window[i] * (rotIm - eIm) / w;
+            im -= window[i] * (rotRe - eRe) / w;
+        }
+        double nRe = rotRe * tableRe[2 * p.period] - rotIm * tableIm[2 * p.period];
+        rotIm = rotRe * tableIm[2 * p.period] + rotIm * tableRe[2 * p.period];
+        rotRe = nRe;
+    }
+    return 2.0 * sqrt(re * re + im * im) / norm;
+}
+
+struct Spectrum {
+    double carrierPeakDb;   // Highest averaged bin within 5% of the carrier
+    double fundamental;
+    double worstSpurDbc;    // Highest baseband bin to 2 kHz away from the fundamental
+};
+
+static Spectrum analyse() {
+    Spectrum result;
+    const int segment = 4096;
+    const int segments = SAMPLES / segment;
+    const double bin = COUNT_HZ / (segment * 1024.0);
+    double peak = 0.0;
+    for (int s = 0; s < segments; s++) fillWindow(s * segment, segment, false);
+    for (int k = -205; k <= 205; k++) {
+        double power = 0.0;
+        for (int s = 0; s < segments; s++) {
+            double m = magnitude(50000.0 + k * bin, s * segment, segment, false);
+            power += m * m;
+        }
+        if (power / segments > peak) peak = power / segments;
+    }
+    result.carrierPeakDb = 10.0 * log10(peak);
+    fillWindow(0, SAMPLES, true);
+    result.fundamental = magnitude(DRIVE_HZ, 0, SAMPLES, true);
+    double worst = 0.0;
+    for (double f = 20.0; f <= 2000.0; f += 2.5) {
+        if (fabs(f - DRIVE_HZ) < 10.0) continue;
+        double m = magnitude(f, 0, SAMPLES, true);
+        if (m > worst) worst = m;
+    }
+    result.worstSpurDbc = 20.0 * log10(worst / result.fundamental);
+    return result;
+}
+
+static void testGeneratorSpread() {
+    PwmDither dither;
+    PwmDitherParams params = {PERIOD_BITS, SPAN};
+    dither.configure(params, 0x9E3779B9u);
+    const int draws = 2 * SPAN + 1;
+    static int bins[2 * SPAN + 1];
+    const int total = draws * 2000;
+    int low = 1023, high = 1023;
+    for (int n = 0; n < total; n++) {
+        int wrap = dither.nextWrap();
+        if (wrap < low) low = wrap;
+        if (wrap > high) high = wrap;
+        if (wrap >= 1023 - SPAN && wrap <= 1023 + SPAN) bins[wrap - (1023 - SPAN)]++;
+    }
+    CHECK(low == 1023 - SPAN);
+    CHECK(high == 1023 + SPAN);
+    for (int i = 0; i < draws; i++) CHECK(abs(bins[i] - 2000) < 200);
+
+    // The band never reaches a quarter of the period, and no span means the nominal top.
+    params.spanCounts = 1000;
+    dither.configure(params, 1);
+    for (int n = 0; n < 1000; n++) CHECK(abs((int)dither.nextWrap() - 1023) <= 256);
+    params.spanCounts = 0;
+    dither.configure(params, 1);
+    CHECK(dither.nextWrap() == 1023);
+}
+
+static void testScaling() {
+    // Duty keeps its fraction of the period; the step keeps its rate per count, with the truncated bits returned.
+    CHECK(pwmDitherScaleDuty(512, pwmDitherDutyScaleQ16(1023, PERIOD_BITS)) == 512);
+    CHECK(pwmDitherScaleDuty(512, pwmDitherDutyScaleQ16(1063, PERIOD_BITS)) == 532);
+    CHECK(pwmDitherScaleDuty(-100, pwmDitherDutyScaleQ16(983, PERIOD_BITS)) == -96);
+    uint32_t remainder;
+    uint64_t step = 0x0000000100000003ull;
+    CHECK(pwmDitherScaleStep(step, 1023, PERIOD_BITS, remainder) == step && remainder == 0);
+    uint64_t scaled = pwmDitherScaleStep(step, 1063, PERIOD_BITS, remainder);
+    CHECK((((unsigned __int128)scaled << PERIOD_BITS) + remainder) == (unsigned __int128)step * 1064u);
+}
+
+static void testSpectra() {
+    CHECK(synthesise(CARRIER_FIXED));
+    Spectrum fixed = analyse();
+    CHECK(synthesise(CARRIER_DITHERED));
+    Spectrum dithered = analyse();
+    synthesise(CARRIER_UNCOMPENSATED);
+    Spectrum uncompensated = analyse();
+    printf("Carrier peak %.1f dB fixed, %.1f dB dithered; worst spur to 2 kHz %.1f dBc fixed, %.1f dBc dithered, %.1f dBc uncompensated; fundamental %+.4f%%\n",
+           fixed.carrierPeakDb, dithered.carrierPeakDb, fixed.worstSpurDbc, dithered.worstSpurDbc, uncompensated.worstSpurDbc,
+           100.0 * (dithered.fundamental / fixed.fundamental - 1.0));
+    // Spreading lowers the carrier tone well beyond window effects.
+    CHECK(dithered.carrierPeakDb < fixed.carrierPeakDb - 10.0);
+    // With compensation the drive is as clean as on a fixed carrier; without it the jitter shows up as spurs.
+    CHECK(dithered.worstSpurDbc < fixed.worstSpurDbc + 3.0);
+    CHECK(uncompensated.worstSpurDbc > dithered.worstSpurDbc + 10.0);
+    CHECK_NEAR(dithered.fundamental / fixed.fundamental, 1.0, 2e-4);
+}
+
+int main() {
+    testGeneratorSpread();
+    testScaling();
+    testSpectra();
+    return 0;
+}
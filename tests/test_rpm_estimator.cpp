@@ -0,0 +1,145 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// RPM outlier stage benchmark: variance, bias, step latency and glitch rejection in front of the exponential filter.
+
+#include "check.h"
+#include "rpm_estimator.h"
+#include "random.h"
+
+static const double WINDOW_SEC = 0.1;
+static const float ALPHA = 0.25f;
+static const int WINDOWS = 3000;         // 300 s of 100 ms windows
+static const int STEP_WINDOW = 2000;     // Speed change from 33.2 to 45 RPM after 200 s
+
+struct Benchmark {
+    double biasRpm;      // Mean error over the steady stretch before the step
+    double rmsRpm;
+    double peakRpm;
+    double latencySec;   // From the step to 90% of the change
+    int rejected;
+};
+
+static RpmEstimatorParams estimatorParams(uint8_t mode) {
+    RpmEstimatorParams params;
+    params.mode = mode;
+    params.window = 5;
+    params.hampelK = 3.0f;
+    params.minSpreadFraction = 0.002f;
+    return params;
+}
+
+/*
+ * Counts edges from a platter with 0.1% wow, like SpeedFeedback::update: one count delta per window, converted to
+ * RPM, through the outlier stage and the exponential filter. In glitch runs 2% of windows gain or lose 1-4 counts
+ * from doubled or missed edges.
+ */
+static Benchmark benchmark(uint8_t mode, uint16_t countsPerRev, bool glitches, uint32_t seed) {
+    RpmEstimator estimator;
+    estimator.configure(estimatorParams(mode));
+    Random rng = {seed};
+    double position = 0.0;   // Revolutions
+    long counted = 0;
+    double filtered = 0.0;
+    double sum = 0.0, sumSq = 0.0, peak = 0.0;
+    int steady = 0;
+    Benchmark result = {0.0, 0.0, 0.0, -1.0, 0};
+    for (int w = 0; w < WINDOWS; w++) {
+        double base = w < STEP_WINDOW ? 33.2 : 45.0;
+        double t = w * WINDOW_SEC;
+        double rpm = base * (1.0 + 0.001 * sin(6.283185307179586 * 0.55 * t));
+        position += rpm / 60.0 * WINDOW_SEC;
+        long edges = (long)floor(position * countsPerRev);
+        long delta = edges - counted;
+        counted = edges;
+        if (glitches && rng.uniform() < 0.02) {
+            long error = 1 + (long)(rng.uniform() * 4.0);
+            delta += rng.uniform() < 0.5 ? -error : error;
+        }
+        float measured = (float)((double)delta / countsPerRev * 60.0 / WINDOW_SEC);
+        float quantum = (float)(60.0 / (countsPerRev * WINDOW_SEC));
+        float windowRpm = estimator.update(measured, 0.5f * quantum);
+        if (estimator.lastRejected()) result.rejected++;
+        filtered = filtered <= 0.0 ? windowRpm : filtered + (windowRpm - filtered) * ALPHA;
+
+        // Skip start-up; errors are against the true speed over the window.
+        if (w >= 50 && w < STEP_WINDOW) {
+            double error = filtered - rpm;
+            sum += error;
+            sumSq += error * error;
+            if (fabs(error) > peak) peak = fabs(error);
+            steady++;
+        }
+        if (w >= STEP_WINDOW && result.latencySec < 0.0 && filtered >= 33.2 + 0.9 * (45.0 - 33.2)) {
+            result.latencySec = (w - STEP_WINDOW + 1) * WINDOW_SEC;
+        }
+    }
+    result.biasRpm = sum / steady;
+    result.rmsRpm = sqrt(sumSq / steady);
+    result.peakRpm = peak;
+    return result;
+}
+
+static void testGlitchRejection() {
+    const char* names[4] = {"EMA", "median", "Hampel", "trimmed mean"};
+    Benchmark coarse[4], coarseClean[4], fine[4];
+    for (uint8_t mode = 0; mode < 4; mode++) {
+        coarse[mode] = benchmark(mode, 36, true, 7);
+        coarseClean[mode] = benchmark(mode, 36, false, 7);
+        fine[mode] = benchmark(mode, 360, true, 7);
+        printf("%-12s 36 CPR glitches bias %+.3f rms %.3f peak %.2f; clean bias %+.3f rms %.3f; 360 CPR glitches rms %.3f peak %.2f; 90%% step %.1f s\n",
+               names[mode], coarse[mode].biasRpm, coarse[mode].rmsRpm, coarse[mode].peakRpm, coarseClean[mode].biasRpm,
+               coarseClean[mode].rmsRpm, fine[mode].rmsRpm, fine[mode].peakRpm, coarse[mode].latencySec);
+    }
+    const Benchmark& ema = coarse[RPM_ESTIMATOR_OFF];
+    const Benchmark& hampel = coarse[RPM_ESTIMATOR_HAMPEL];
+    // Glitched windows no longer reach the filter: far less variance and a peak a few times smaller.
+    CHECK(hampel.rmsRpm < ema.rmsRpm * 0.5);
+    CHECK(hampel.peakRpm < ema.peakRpm * 0.35);
+    CHECK(fine[RPM_ESTIMATOR_HAMPEL].rmsRpm < fine[RPM_ESTIMATOR_OFF].rmsRpm * 0.7);
+    CHECK(fine[RPM_ESTIMATOR_HAMPEL].peakRpm < fine[RPM_ESTIMATOR_OFF].peakRpm * 0.5);
+    CHECK(hampel.rejected > 0);
+    // On a clean signal the half-count spread floor keeps Hampel from touching the normal count alternation.
+    CHECK(coarseClean[RPM_ESTIMATOR_HAMPEL].rejected == 0);
+    CHECK_NEAR(coarseClean[RPM_ESTIMATOR_HAMPEL].rmsRpm, coarseClean[RPM_ESTIMATOR_OFF].rmsRpm, 1e-9);
+    CHECK(fabs(coarseClean[RPM_ESTIMATOR_HAMPEL].biasRpm) < 0.02);
+    // Median and trimmed mean settle on whole counts, so they carry a bias Hampel does not.
+    CHECK(fabs(coarseClean[RPM_ESTIMATOR_MEDIAN].biasRpm) > fabs(coarseClean[RPM_ESTIMATOR_HAMPEL].biasRpm) + 0.05);
+    // A real step is not mistaken for a glitch for long.
+    for (uint8_t mode = 1; mode < 4; mode++) {
+        CHECK(coarse[mode].latencySec > 0.0);
+        CHECK(coarse[mode].latencySec <= ema.latencySec + 0.25);
+    }
+}
+
+static void testSingleGlitchReplaced() {
+    RpmEstimator estimator;
+    estimator.configure(estimatorParams(RPM_ESTIMATOR_HAMPEL));
+    // 360 CPR at 100 ms: half a count is 0.833 RPM.
+    const float readings[6] = {33.33f, 33.33f, 50.0f, 33.33f, 33.33f, 33.33f};
+    for (int i = 0; i < 6; i++) {
+        float out = estimator.update(readings[i], 0.833f);
+        if (i == 2) {
+            CHECK(estimator.lastRejected());
+            CHECK_NEAR(out, 33.33, 1e-3);
+        }
+    }
+    // Reset forgets the history, so the next reading passes.
+    estimator.reset();
+    CHECK(estimator.update(50.0f, 0.833f) == 50.0f);
+    CHECK(!estimator.lastRejected());
+    // Off passes everything.
+    estimator.configure(estimatorParams(RPM_ESTIMATOR_OFF));
+    for (int i = 0; i < 6; i++) CHECK(estimator.update(readings[i], 0.833f) == readings[i]);
+}
+
+int main() {
+    testGlitchRejection();
+    testSingleGlitchReplaced();
+    return 0;
+}
@@ -0,0 +1,128 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Simulated sense-winding waveforms through the sensorless estimator: a locked rotor, a pulled-out rotor, noise,
+// signal loss, and a coast with the drive off.
+
+#include "check.h"
+#include "sensorless_speed.h"
+
+struct Waveform {
+    double driveHz;
+    double rotorHz;       // Electrical frequency of the rotor; equal to driveHz while it holds synchronism
+    double loadAngleDeg;  // Rotor lag behind the drive while locked
+    double amplitude;     // Sensed peak in ADC counts
+    double noise;         // Peak of the added noise in ADC counts
+};
+
+static const double SAMPLE_HZ = 4000.0;
+
+// Feeds seconds of 12-bit samples centred at mid-scale, with the DDS phase of the drive at each sample.
+static void feed(SensorlessSpeedEstimator& estimator, const Waveform& w, double& time, double seconds, uint32_t& noise) {
+    long samples = (long)(seconds * SAMPLE_HZ);
+    for (long i = 0; i < samples; i++) {
+        double drivePhase = fmod(w.driveHz * time, 1.0);
+        double rotorPhase = w.rotorHz == w.driveHz ? drivePhase - (w.loadAngleDeg / 360.0) : fmod(w.rotorHz * time, 1.0);
+        noise = (noise * 1103515245u) + 12345u;
+        double n = (((double)((noise >> 16) & 0x7fff) / 32767.0) - 0.5) * 2.0 * w.noise;
+        double value = 2048.0 + (w.amplitude * sin(6.283185307179586 * rotorPhase)) + n;
+        estimator.addSample((float)value, (uint32_t)(drivePhase * 4294967296.0), (uint32_t)llround(time * 1e6));
+        time += 1.0 / SAMPLE_HZ;
+    }
+}
+
+static SensorlessSpeedParams defaultParams() {
+    SensorlessSpeedParams params = {(float)SAMPLE_HZ, 0.2f, 20.0f, 6, 1.6f};
+    return params;
+}
+
+static double wrapDegrees(double degrees) {
+    while (degrees > 180.0) degrees -= 360.0;
+    while (degrees < -180.0) degrees += 360.0;
+    return degrees;
+}
+
+static void testLockedRotorReadsDrive() {
+    // A synchronous rotor turns at the drive frequency whatever the load, so load shows only as phase.
+    // This is why sensorless mode supervises and never corrects speed: there is no speed error to read.
+    SensorlessSpeedEstimator estimator;
+    estimator.configure(defaultParams());
+    double time = 0.0;
+    uint32_t noise = 1;
+    Waveform light = {50.0, 50.0, 10.0, 600.0, 0.0};
+    feed(estimator, light, time, 2.0, noise);
+    CHECK(estimator.isValid());
+    CHECK_NEAR(estimator.getElectricalHz(), 50.0, 0.02);
+    CHECK_NEAR(estimator.getSlipHz(), 0.0, 0.02);
+    float lightPhase = estimator.getPhaseDegrees();
+
+    Waveform heavy = {50.0, 50.0, 30.0, 600.0, 0.0};
+    feed(estimator, heavy, time, 2.0, noise);
+    CHECK(estimator.isValid());
+    CHECK_NEAR(estimator.getElectricalHz(), 50.0, 0.02);
+    CHECK_NEAR(wrapDegrees(estimator.getPhaseDegrees() - lightPhase), 20.0, 2.0);
+    CHECK(estimator.getRejectedCrossings() == 0);
+}
+
+static void testPullOutSeen() {
+    // Out of step the rotor falls behind the drive; the slip and a steadily walking phase are what supervision acts on.
+    SensorlessSpeedEstimator estimator;
+    estimator.configure(defaultParams());
+    double time = 0.0;
+    uint32_t noise = 2;
+    Waveform slipping = {50.0, 47.0, 0.0, 600.0, 0.0};
+    feed(estimator, slipping, time, 2.0, noise);
+    CHECK(estimator.isValid());
+    CHECK_NEAR(estimator.getElectricalHz(), 47.0, 0.05);
+    CHECK_NEAR(estimator.getSlipHz(), 3.0, 0.05);
+    float before = estimator.getPhaseDegrees();
+    feed(estimator, slipping, time, 0.1, noise);
+    // Three hertz of slip walks the phase by 108 degrees in 100 ms, give or take the phase smoothing.
+    CHECK(fabs(wrapDegrees(estimator.getPhaseDegrees() - before)) > 60.0);
+}
+
+static void testNoiseAndLoss() {
+    // Noise at a tenth of the signal stays inside the hysteresis band; a vanished signal reads as lost, not as zero speed.
+    SensorlessSpeedEstimator estimator;
+    estimator.configure(defaultParams());
+    double time = 0.0;
+    uint32_t noise = 3;
+    Waveform noisy = {16.6667, 16.6667, 15.0, 300.0, 30.0};
+    // Until the amplitude tracker has warmed up the hysteresis band is narrow, so start-up may reject a few crossings.
+    feed(estimator, noisy, time, 1.0, noise);
+    uint32_t warmUpRejected = estimator.getRejectedCrossings();
+    feed(estimator, noisy, time, 2.0, noise);
+    CHECK(estimator.isValid());
+    CHECK_NEAR(estimator.getElectricalHz(), 16.6667, 0.05);
+    CHECK(estimator.getRejectedCrossings() == warmUpRejected);
+
+    Waveform lost = {16.6667, 16.6667, 15.0, 0.0, 2.0};
+    feed(estimator, lost, time, 3.0, noise);
+    CHECK(!estimator.isValid());
+}
+
+static void testCoastWithDriveOff() {
+    // With the drive stopped the DDS phase stands still, and crossings are checked against each other instead.
+    SensorlessSpeedEstimator estimator;
+    estimator.configure(defaultParams());
+    double time = 0.0;
+    uint32_t noise = 4;
+    Waveform coast = {0.0, 40.0, 0.0, 500.0, 0.0};
+    feed(estimator, coast, time, 1.0, noise);
+    CHECK(estimator.isValid());
+    CHECK_NEAR(estimator.getElectricalHz(), 40.0, 0.05);
+    CHECK(estimator.getDriveHz() < 1.0f);
+}
+
+int main() {
+    testLockedRotorReadsDrive();
+    testPullOutSeen();
+    testNoiseAndLoss();
+    testCoastWithDriveOff();
+    return 0;
+}
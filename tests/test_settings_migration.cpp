@@ -0,0 +1,133 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Migration of a schema 12 settings image to the current layout.
+
+#include "check.h"
+#include "fir_design.h"
+#include "settings_migration.h"
+#include <stddef.h>
+
+// Field offsets in the released schema 12 layout. The current struct must keep every one of them.
+struct Schema12Field {
+    const char* name;
+    size_t offset;
+    size_t current;
+};
+
+#define SCHEMA12_FIELD(field, offset) { #field, offset, offsetof(GlobalSettings, field) }
+
+static const Schema12Field SCHEMA12_FIELDS[] = {
+    SCHEMA12_FIELD(schemaVersion, 0),
+    SCHEMA12_FIELD(phaseMode, 4),
+    SCHEMA12_FIELD(maxAmplitude, 8),
+    SCHEMA12_FIELD(brakeMode, 12),
+    SCHEMA12_FIELD(brakeDuration, 16),
+    SCHEMA12_FIELD(speeds, 52),
+    SCHEMA12_FIELD(presetNames, 220),
+    SCHEMA12_FIELD(totalRuntime, 308),
+    SCHEMA12_FIELD(closedLoopEnabled, 351),
+    SCHEMA12_FIELD(closedLoopTargetRpm, 356),
+    SCHEMA12_FIELD(closedLoopCountsPerRev, 368),
+    SCHEMA12_FIELD(closedLoopKp, 400),
+    SCHEMA12_FIELD(closedLoopAmpRecoveryDelayMs, 470),
+    SCHEMA12_FIELD(closedLoopTuning, 472),
+    SCHEMA12_FIELD(closedLoopPitchTargetMode, 604),
+    SCHEMA12_FIELD(phaseSlewDegreesPerSecond, 608),
+    SCHEMA12_FIELD(gainSlewPercentPerSecond, 612),
+    SCHEMA12_FIELD(vfBaseFreq, 616),
+};
+
+template <typename T>
+static void put(GlobalSettingsV12& image, size_t offset, T value) {
+    memcpy(&image.bytes[offset], &value, sizeof(value));
+}
+
+// A schema 12 image as a unit running that firmware would have saved it: every byte set, and known values in named fields.
+static GlobalSettingsV12 schema12Image() {
+    GlobalSettingsV12 image;
+    for (size_t i = 0; i < sizeof(image.bytes); i++) image.bytes[i] = (uint8_t)(i * 7u + 3u);
+    put<uint32_t>(image, 0, 12);
+    put<uint8_t>(image, 4, 3);
+    put<uint8_t>(image, 8, 87);
+    put<float>(image, 16, 2.5f);
+    put<float>(image, 52, 50.0f);
+    memcpy(&image.bytes[220], "Garrard 301", 12);
+    put<uint32_t>(image, 308, 123456);
+    put<uint8_t>(image, 351, 1);
+    put<float>(image, 356, 33.3333f);
+    put<uint16_t>(image, 368, 180);
+    put<float>(image, 400, 0.35f);
+    put<uint8_t>(image, 604, 1);
+    put<float>(image, 616, 58.66f);
+    return image;
+}
+
+static void testLayoutIsPrefix() {
+    CHECK(sizeof(GlobalSettings) == GLOBAL_SETTINGS_STORAGE_SIZE);
+    for (const Schema12Field& field : SCHEMA12_FIELDS) {
+        if (field.offset != field.current) {
+            fprintf(stderr, "%s moved from %zu to %zu\n", field.name, field.offset, field.current);
+            CHECK(field.offset == field.current);
+        }
+    }
+    // Schema 13 appends straight after the last schema 12 field.
+    CHECK(offsetof(GlobalSettings, closedLoopSlipAction) == sizeof(GlobalSettingsV12));
+}
+
+static void testSchema12Migration() {
+    GlobalSettingsV12 image = schema12Image();
+    GlobalSettings migrated;
+    memset(&migrated, 0xA5, sizeof(migrated));
+    copyFromV12(image, migrated);
+
+    // Everything schema 12 stored comes across untouched apart from the version.
+    CHECK(migrated.schemaVersion == SETTINGS_SCHEMA_VERSION);
+    CHECK(memcmp((const uint8_t*)&migrated + 4, &image.bytes[4], sizeof(image.bytes) - 4) == 0);
+    CHECK(migrated.phaseMode == 3);
+    CHECK(migrated.maxAmplitude == 87);
+    CHECK(migrated.brakeDuration == 2.5f);
+    CHECK(migrated.speeds[0].frequency == 50.0f);
+    CHECK(strcmp(migrated.presetNames[0], "Garrard 301") == 0);
+    CHECK(migrated.totalRuntime == 123456);
+    CHECK(migrated.closedLoopEnabled);
+    CHECK(migrated.closedLoopTargetRpm[0] == 33.3333f);
+    CHECK(migrated.closedLoopCountsPerRev == 180);
+    CHECK(migrated.closedLoopKp == 0.35f);
+    CHECK(migrated.closedLoopPitchTargetMode == 1);
+    CHECK(migrated.vfBaseFreq == 58.66f);
+
+    // Every appended field takes its default, matching a factory reset.
+    GlobalSettings defaults;
+    memset(&defaults, 0, sizeof(defaults));
+    setSchema13Defaults(defaults);
+    size_t appended = sizeof(GlobalSettings) - sizeof(GlobalSettingsV12);
+    CHECK(memcmp((const uint8_t*)&migrated + sizeof(GlobalSettingsV12),
+                 (const uint8_t*)&defaults + sizeof(GlobalSettingsV12), appended) == 0);
+
+    // Features that change the drive stay off until the user turns them on.
+    CHECK(migrated.closedLoopSlipAction == CLOSED_LOOP_SLIP_WARN);
+    CHECK(!migrated.thermalDerateEnabled);
+    CHECK(!migrated.closedLoopNotchEnabled);
+    CHECK(!migrated.loadStepEnabled);
+    CHECK(migrated.bridgeDeadTimeNs == POWER_STAGE_DEADTIME_NS);
+    for (int i = 0; i < 3; i++) {
+        CHECK(migrated.coastDownModel[i].valid == 0);
+        CHECK(migrated.loadStepLearnedHz[i] == 0.0f);
+        CHECK(migrated.bridgeDeadTimeLagDeg[i] == 0.0f);
+        CHECK(migrated.firTaps[i] == FIR_MAX_TAPS);
+        CHECK(migrated.kickLearnedMs[i] == 0);
+        CHECK(migrated.baseLearn[i].ratioRpmPerHz == 0.0f);
+    }
+}
+
+int main() {
+    testLayoutIsPrefix();
+    testSchema12Migration();
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Slip and pull-out detection against synthetic speed profiles at 33 1/3 RPM from a 50 Hz drive.
+
+#include "check.h"
+#include "slip_detect.h"
+
+static const float OUTPUT_HZ = 50.0f;
+static const float NOMINAL_RATIO = 33.3333f / 50.0f;
+static const uint32_t SAMPLE_MS = 50;
+
+static SlipDetectParams defaultParams() {
+    SlipDetectParams params;
+    params.slipThresholdPercent = 3.0f;
+    params.pullOutThresholdPercent = 25.0f;
+    params.detectMs = 300;
+    return params;
+}
+
+// Small deterministic ripple standing in for tach noise.
+static float ripple(uint32_t i) {
+    return 0.05f * (float)((int32_t)((i * 7919u) % 11u) - 5) / 5.0f;
+}
+
+struct Run {
+    SlipRatio ratio;
+    SlipWindow window;
+    uint32_t nowMs;
+    uint32_t sample;
+};
+
+static void startRun(Run& run) {
+    run.ratio.rpmPerHz = 0.0f;
+    run.ratio.learned = false;
+    run.window.reset();
+    run.nowMs = 0;
+    run.sample = 0;
+}
+
+// Feeds samples at rpm for durationMs and returns the most severe state seen.
+static SlipDetectState feed(Run& run, float rpm, bool locked, uint32_t durationMs, const SlipDetectParams& params) {
+    SlipDetectState worst = SLIP_DETECT_CLEAR;
+    for (uint32_t t = 0; t < durationMs; t += SAMPLE_MS) {
+        float measured = rpm + ripple(run.sample++);
+        slipRatioUpdate(run.ratio, NOMINAL_RATIO, OUTPUT_HZ, measured, locked);
+        float slip = slipPercent(run.ratio.rpmPerHz, OUTPUT_HZ, measured);
+        SlipDetectState state = run.window.update(run.nowMs, slip, locked, run.ratio.learned, params);
+        if (state > worst) worst = state;
+        run.nowMs += SAMPLE_MS;
+    }
+    return worst;
+}
+
+static void testCreepIsLearned() {
+    // 2% belt creep is normal running, so a locked run absorbs it into the ratio.
+    SlipDetectParams params = defaultParams();
+    Run run;
+    startRun(run);
+    float creepRpm = 33.3333f * 0.98f;
+    CHECK(feed(run, creepRpm, true, 10000, params) == SLIP_DETECT_CLEAR);
+    CHECK(run.ratio.learned);
+    CHECK_NEAR(run.ratio.rpmPerHz, creepRpm / OUTPUT_HZ, 0.002);
+
+    // Losing lock at the same speed is not slip once the creep is learned.
+    CHECK(feed(run, creepRpm, false, 2000, params) == SLIP_DETECT_CLEAR);
+}
+
+static void testBeltSlip() {
+    SlipDetectParams params = defaultParams();
+    Run run;
+    startRun(run);
+    feed(run, 33.3333f, true, 5000, params);
+
+    // A 6% shortfall shorter than the detection time stays pending.
+    CHECK(feed(run, 33.3333f * 0.94f, false, 250, params) == SLIP_DETECT_PENDING);
+    CHECK(feed(run, 33.3333f, false, 500, params) == SLIP_DETECT_CLEAR);
+    CHECK(!run.window.isOpen());
+
+    // Held past the detection time it is reported as slip, not pull-out.
+    CHECK(feed(run, 33.3333f * 0.94f, false, 600, params) == SLIP_DETECT_SLIP);
+    CHECK_NEAR(run.window.getPeakPercent(), 6.0, 0.5);
+}
+
+static void testSlipNeedsLearnedRatio() {
+    // Before any locked sample the nominal ratio is not trusted for ordinary slip.
+    SlipDetectParams params = defaultParams();
+    Run run;
+    startRun(run);
+    CHECK(feed(run, 33.3333f * 0.9f, false, 2000, params) == SLIP_DETECT_CLEAR);
+    CHECK(!run.ratio.learned);
+}
+
+static void testPullOut() {
+    // A rotor falling out of step loses far more than the pull-out threshold and is trusted from the nominal ratio.
+    SlipDetectParams params = defaultParams();
+    Run run;
+    startRun(run);
+    CHECK(feed(run, 33.3333f * 0.5f, false, 600, params) == SLIP_DETECT_PULL_OUT);
+
+    // A slip that deepens into pull-out is classified by its peak.
+    startRun(run);
+    feed(run, 33.3333f, true, 5000, params);
+    CHECK(feed(run, 33.3333f * 0.95f, false, 150, params) == SLIP_DETECT_PENDING);
+    CHECK(feed(run, 33.3333f * 0.6f, false, 400, params) == SLIP_DETECT_PULL_OUT);
+
+    // With pull-out disabled the same profile is plain slip.
+    params.pullOutThresholdPercent = 0.0f;
+    startRun(run);
+    feed(run, 33.3333f, true, 5000, params);
+    CHECK(feed(run, 33.3333f * 0.6f, false, 600, params) == SLIP_DETECT_SLIP);
+}
+
+static void testLockedSamplesNeverSlip() {
+    // Locked samples teach the ratio and are never reported, whatever the nominal setting says.
+    SlipDetectParams params = defaultParams();
+    Run run;
+    startRun(run);
+    CHECK(feed(run, 33.3333f * 0.7f, true, 2000, params) == SLIP_DETECT_CLEAR);
+}
+
+int main() {
+    testCreepIsLearned();
+    testBeltSlip();
+    testSlipNeedsLearnedRatio();
+    testPullOut();
+    testLockedSamplesNeverSlip();
+    return 0;
+}
@@ -0,0 +1,152 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Look-ahead limiting against hard clipping: line-to-line spectrum of a simulated three-phase bridge, with the
+// limiter's ceiling taken from the leg placement.
+
+#include "check.h"
+#include "bridge_modulation.h"
+#include "soft_limiter.h"
+
+static const int32_t TOP = 1023;
+static const int32_t MID = 512;
+static const double UNIT = 511.0;
+static const int SAMPLES_PER_CYCLE = 1000;  // 50 Hz at the 50 kHz carrier
+static const int BLOCK = 512;
+static const double RELEASE = 512.0 / (50000.0 * 0.1);  // SOFT_LIMITER_RELEASE_MS of 100 ms per block
+static const double TWO_PI = 6.283185307179586;
+
+struct BridgeRun {
+    double fundamental;  // Line-to-line A-B fundamental, counts
+    double thd;          // Harmonics 2-25 over the fundamental
+    int reducedSamples;  // Samples over the whole run where placement had to reduce or clamp the drive
+};
+
+// Three legs 120 degrees apart driven at requested(block) of full scale for 40 cycles; the spectrum is taken over the
+// last 10. A ceiling of 0 turns the limiter off.
+static BridgeRun runBridge(uint8_t mode, double (*requested)(int block), double ceiling) {
+    BridgeModulationParams params = {mode, 0, 0};
+    const double phases[3] = {0.0, 120.0, 240.0};
+    const int cycles = 40, measured = 10;
+    double gain = 1.0;
+    double re[26] = {0.0}, im[26] = {0.0};
+    BridgeRun run = {0.0, 0.0, 0};
+    for (int n = 0; n < cycles * SAMPLES_PER_CYCLE; n++) {
+        double want = requested(n / BLOCK);
+        if (n % BLOCK == 0 && ceiling > 0.0) gain = softLimiterGain((float)gain, (float)want, (float)ceiling, (float)RELEASE);
+        double scale = want * (ceiling > 0.0 ? gain : 1.0);
+        int32_t duty[3];
+        for (int leg = 0; leg < 3; leg++) {
+            double angle = (TWO_PI * n / SAMPLES_PER_CYCLE) + (phases[leg] * TWO_PI / 360.0);
+            duty[leg] = MID + (int32_t)lround(UNIT * scale * sin(angle));
+        }
+        if (bridgeModulate(duty, 3, TOP, params)) run.reducedSamples++;
+        if (n >= (cycles - measured) * SAMPLES_PER_CYCLE) {
+            double lineToLine = (double)(duty[0] - duty[1]);
+            for (int h = 1; h <= 25; h++) {
+                double angle = (TWO_PI * h * n) / SAMPLES_PER_CYCLE;
+                re[h] += lineToLine * cos(angle);
+                im[h] += lineToLine * sin(angle);
+            }
+        }
+    }
+    double norm = 2.0 / (measured * SAMPLES_PER_CYCLE);
+    run.fundamental = hypot(re[1], im[1]) * norm;
+    double harmonics = 0.0;
+    for (int h = 2; h <= 25; h++) harmonics += (re[h] * re[h] + im[h] * im[h]) * norm * norm;
+    run.thd = sqrt(harmonics) / run.fundamental;
+    return run;
+}
+
+static double steady110(int) { return 1.10; }
+static double steady130(int) { return 1.30; }
+// A start kick: 0.8 of full scale, boosted to 1.4 for twenty blocks, then back.
+static double kick(int block) { return block >= 20 && block < 40 ? 1.40 : 0.80; }
+
+static void testPeakLimit() {
+    const float threePhase[3] = {0.0f, 120.0f, 240.0f};
+    BridgeModulationParams sine = {BRIDGE_MODULATION_SINE, 0, 0};
+    BridgeModulationParams centred = {BRIDGE_MODULATION_CENTRED, 0, 0};
+    BridgeModulationParams clamp = {BRIDGE_MODULATION_BOTTOM_CLAMP, 0, 0};
+    CHECK_NEAR(bridgeModulationPeakLimit(sine, TOP, threePhase, 3), 1.0, 1e-6);
+    // 1022 / (sqrt(3) * 511): the 2/sqrt(3) line-to-line gain of centred placement, less a count for rounding.
+    CHECK_NEAR(bridgeModulationPeakLimit(centred, TOP, threePhase, 3), 2.0 / sqrt(3.0), 1e-3);
+    CHECK_NEAR(bridgeModulationPeakLimit(clamp, TOP, threePhase, 3), 2.0 / sqrt(3.0), 1e-3);
+    // Two legs in antiphase gain nothing; legs in phase keep the per-leg window.
+    const float antiphase[2] = {0.0f, 180.0f};
+    CHECK_NEAR(bridgeModulationPeakLimit(centred, TOP, antiphase, 2), 1.0, 1e-4);
+    const float inPhase[2] = {30.0f, 30.0f};
+    CHECK_NEAR(bridgeModulationPeakLimit(centred, TOP, inPhase, 2), 1.0, 1e-6);
+    // Minimum on and off times narrow the window, and sine placement is bound by the nearer rail.
+    BridgeModulationParams limited = {BRIDGE_MODULATION_SINE, 13, 25};
+    CHECK_NEAR(bridgeModulationPeakLimit(limited, TOP, threePhase, 3), (1023.0 - 25.0 - 512.0) / 511.0, 1e-5);
+    limited.mode = BRIDGE_MODULATION_CENTRED;
+    CHECK_NEAR(bridgeModulationPeakLimit(limited, TOP, threePhase, 3), (1023.0 - 25.0 - 13.0 - 1.0) / (sqrt(3.0) * 511.0), 1e-4);
+}
+
+static void testLimiterGain() {
+    CHECK_NEAR(softLimiterGain(1.0f, 0.9f, 1.0f, 0.1f), 1.0, 1e-6);
+    // Reduction is immediate, recovery by the release fraction per buffer.
+    CHECK_NEAR(softLimiterGain(1.0f, 1.25f, 1.0f, 0.1f), 0.8, 1e-6);
+    CHECK_NEAR(softLimiterGain(0.8f, 0.5f, 1.0f, 0.1f), 0.82, 1e-6);
+    CHECK_NEAR(softLimiterGain(0.8f, 0.5f, 1.0f, 2.0f), 1.0, 1e-6);
+}
+
+static void testSineBridgeClipsWithoutLimiter() {
+    // Sine placement at 110%: hard clipping against the rails adds odd harmonics to every winding.
+    BridgeRun clipped = runBridge(BRIDGE_MODULATION_SINE, steady110, 0.0);
+    BridgeModulationParams sine = {BRIDGE_MODULATION_SINE, 0, 0};
+    const float threePhase[3] = {0.0f, 120.0f, 240.0f};
+    BridgeRun limited = runBridge(BRIDGE_MODULATION_SINE, steady110, bridgeModulationPeakLimit(sine, TOP, threePhase, 3));
+    CHECK(clipped.reducedSamples > 0);
+    CHECK(clipped.thd > 0.01);
+    CHECK(limited.reducedSamples == 0);
+    CHECK(limited.thd < 0.002);
+    CHECK(limited.thd < clipped.thd * 0.1);
+}
+
+static void testCentredCeilingKeepsHeadroom() {
+    BridgeModulationParams centred = {BRIDGE_MODULATION_CENTRED, 0, 0};
+    const float threePhase[3] = {0.0f, 120.0f, 240.0f};
+    double limit = bridgeModulationPeakLimit(centred, TOP, threePhase, 3);
+    // A ceiling of full scale throws the placement's headroom away: 110% is limited to 100%.
+    BridgeRun fullScale = runBridge(BRIDGE_MODULATION_CENTRED, steady110, 1.0);
+    BridgeRun placed = runBridge(BRIDGE_MODULATION_CENTRED, steady110, limit);
+    CHECK(fullScale.reducedSamples == 0);
+    CHECK(placed.reducedSamples == 0);
+    CHECK_NEAR(fullScale.fundamental, sqrt(3.0) * UNIT * 1.0, 2.0);
+    CHECK_NEAR(placed.fundamental, sqrt(3.0) * UNIT * 1.10, 2.0);
+    CHECK(placed.thd < 0.002);
+
+    // Beyond the placement's reach the limiter scales cleanly where placement alone would reduce sample by sample.
+    BridgeRun unlimited = runBridge(BRIDGE_MODULATION_CENTRED, steady130, 0.0);
+    BridgeRun limited = runBridge(BRIDGE_MODULATION_CENTRED, steady130, limit);
+    CHECK(unlimited.reducedSamples > 0);
+    CHECK(limited.reducedSamples == 0);
+    CHECK(limited.thd < unlimited.thd * 0.2);
+    CHECK_NEAR(limited.fundamental, sqrt(3.0) * UNIT * limit, 3.0);
+}
+
+static void testKickIsLimitedAhead() {
+    BridgeModulationParams centred = {BRIDGE_MODULATION_CENTRED, 0, 0};
+    const float threePhase[3] = {0.0f, 120.0f, 240.0f};
+    BridgeRun limited = runBridge(BRIDGE_MODULATION_CENTRED, kick, bridgeModulationPeakLimit(centred, TOP, threePhase, 3));
+    BridgeRun unlimited = runBridge(BRIDGE_MODULATION_CENTRED, kick, 0.0);
+    // The limiter never lets a sample past the placement limit, through the kick and its release.
+    CHECK(limited.reducedSamples == 0);
+    CHECK(unlimited.reducedSamples > 0);
+}
+
+int main() {
+    testPeakLimit();
+    testLimiterGain();
+    testSineBridgeClipsWithoutLimiter();
+    testCentredCeilingKeepsHeadroom();
+    testKickIsLimitedAhead();
+    return 0;
+}
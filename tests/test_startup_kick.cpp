@@ -0,0 +1,196 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Startup kick on cold and warm bearings: fixed kick length against ending at pull-in and learning the ramp.
+
+#include "check.h"
+#include "startup_kick.h"
+
+static const float TARGET_RPM = 33.333f;
+static const float KICK_FACTOR = 1.5f;
+static const float KICK_SEC = 6.0f;          // Configured kick length, the upper limit once adaptive
+static const float RAMP_SEC = 0.3f;          // Configured kick ramp
+static const float SAMPLE_SEC = 0.1f;        // Closed-loop update interval
+static const float FILTER_ALPHA = 0.25f;     // Closed-loop speed filter
+static const float FULL_TORQUE_RPM_PER_SEC = 100.0f;
+static const float BRAKE_SHARE = 0.3f;       // Motor torque available to hold the platter back while in synchronism
+static const float COLD_FRICTION = 0.6f;
+static const float WARM_FRICTION = 0.2f;
+
+// Synchronous platter: it accelerates towards the drive with the torque left over from friction and follows it once
+// there. A drive falling faster than motor and friction can slow the platter pulls it out of synchronism, and it then
+// coasts on friction alone until it meets the drive again.
+struct Platter {
+    float friction;
+    float rpm;
+    bool synchronous;
+
+    void step(float driveRpm, float dtSec) {
+        float rise = FULL_TORQUE_RPM_PER_SEC * (1.0f - friction) * dtSec;
+        float fall = FULL_TORQUE_RPM_PER_SEC * (friction + (synchronous ? BRAKE_SHARE : 0.0f)) * dtSec;
+        float error = driveRpm - rpm;
+        if (error > rise) {
+            rpm += rise;
+        } else if (error < -fall) {
+            rpm -= fall;
+            synchronous = false;
+        } else {
+            rpm = driveRpm;
+            synchronous = true;
+        }
+    }
+};
+
+struct Learned {
+    float kickSec;
+    float rampSec;
+};
+
+struct StartResult {
+    float kickSec;
+    float rampSec;
+    bool rampSlipped;
+    float timeToLockSec;
+};
+
+static StartupKickParams kickParams() {
+    StartupKickParams params;
+    params.pullInFraction = 0.95f;
+    params.holdSec = 0.2f;
+    params.slipFraction = 0.1f;
+    params.feedbackLagSec = SAMPLE_SEC * (1.0f - FILTER_ALPHA) / FILTER_ALPHA;
+    params.lockToleranceRpm = 0.05f;
+    params.lockHoldSec = 3.0f;
+    params.learnRate = 0.5f;
+    params.rampGrowth = 1.25f;
+    params.maxRampSec = 15.0f;
+    return params;
+}
+
+// One start from rest, mirroring MotorController: the kick runs until pull-in when adaptive (or the configured time
+// when fixed), then the learned or configured ramp carries the drive down to the run speed.
+static StartResult runStart(float friction, bool adaptive, Learned& learned) {
+    const float dtSec = 0.001f;
+    StartupKickTracker tracker;
+    tracker.configure(kickParams());
+    float kickRpm = TARGET_RPM * KICK_FACTOR;
+    tracker.begin(kickRpm, TARGET_RPM);
+    Platter platter = {friction, 0.0f, false};
+    float rampSec = adaptive && learned.rampSec > 0.0f ? learned.rampSec : RAMP_SEC;
+    float driveRpm = kickRpm;
+    float measuredRpm = 0.0f;
+    float kickEndSec = -1.0f;
+    float nextSampleSec = SAMPLE_SEC;
+    StartResult result = {0.0f, rampSec, false, 0.0f};
+
+    for (int n = 1; n <= 30000 && !tracker.isLocked(); n++) {
+        float t = n * dtSec;
+        if (kickEndSec < 0.0f && t >= KICK_SEC) {
+            kickEndSec = t;
+            tracker.endKick(t, KICK_END_TIMEOUT, rampSec);
+        }
+        if (kickEndSec >= 0.0f) {
+            float progress = (t - kickEndSec) / rampSec;
+            if (progress >= 1.0f) {
+                progress = 1.0f;
+                tracker.endRamp();
+            }
+            driveRpm = kickRpm + ((TARGET_RPM - kickRpm) * progress);
+        }
+        platter.step(driveRpm, dtSec);
+
+        if (t + 1e-6f >= nextSampleSec) {
+            nextSampleSec += SAMPLE_SEC;
+            measuredRpm += FILTER_ALPHA * (platter.rpm - measuredRpm);
+            bool event = tracker.update(t, measuredRpm, true, driveRpm);
+            if (event && adaptive && tracker.getPhase() == KICK_PHASE_KICK) {
+                kickEndSec = t;
+                tracker.endKick(t, KICK_END_PULL_IN, rampSec);
+            }
+        }
+    }
+    result.kickSec = tracker.getKickSec();
+    result.rampSlipped = tracker.rampSlipped();
+    result.timeToLockSec = tracker.isLocked() ? tracker.getTimeToLockSec() : -1.0f;
+    if (adaptive) {
+        learned.kickSec = tracker.learnedKickSec(learned.kickSec);
+        if (tracker.isPulledIn()) learned.rampSec = tracker.learnedRampSec();
+    }
+    return result;
+}
+
+static void testColdAndWarmStarts() {
+    const float frictions[6] = {COLD_FRICTION, COLD_FRICTION, WARM_FRICTION, WARM_FRICTION, WARM_FRICTION, COLD_FRICTION};
+    Learned fixedLearned = {0.0f, 0.0f}, learned = {0.0f, 0.0f};
+    StartResult fixed[6], adaptive[6];
+    float learnedKick[6];
+    for (int i = 0; i < 6; i++) {
+        fixed[i] = runStart(frictions[i], false, fixedLearned);
+        adaptive[i] = runStart(frictions[i], true, learned);
+        learnedKick[i] = learned.kickSec;
+        printf("%s start: fixed lock %.1f s%s; adaptive kick %.2f s, ramp %.2f s%s, lock %.1f s\n",
+               frictions[i] == COLD_FRICTION ? "cold" : "warm", fixed[i].timeToLockSec, fixed[i].rampSlipped ? " (ramp slipped)" : "",
+               adaptive[i].kickSec, adaptive[i].rampSec, adaptive[i].rampSlipped ? " (slipped)" : "", adaptive[i].timeToLockSec);
+    }
+
+    for (int i = 0; i < 6; i++) {
+        CHECK(fixed[i].timeToLockSec > 0.0f);
+        CHECK(adaptive[i].timeToLockSec > 0.0f);
+        // The fixed kick always runs its configured length; pull-in ends the adaptive one well before.
+        CHECK_NEAR(fixed[i].kickSec, KICK_SEC, 0.01);
+        CHECK(adaptive[i].kickSec < KICK_SEC - 1.0f);
+        CHECK(adaptive[i].timeToLockSec < fixed[i].timeToLockSec - 1.0f);
+    }
+    // A cold bearing takes longer to pull in than a warm one.
+    CHECK(adaptive[0].kickSec > adaptive[2].kickSec + 0.3f);
+
+    // The warm platter cannot be slowed as fast as the configured ramp: it slips on every fixed start, and on the first
+    // adaptive one, after which the stretched ramp is kept because it tracks.
+    CHECK(!fixed[0].rampSlipped);
+    CHECK(fixed[2].rampSlipped && fixed[3].rampSlipped && fixed[4].rampSlipped);
+    CHECK(adaptive[2].rampSlipped);
+    CHECK_NEAR(adaptive[3].rampSec, RAMP_SEC * 1.25f, 1e-4);
+    CHECK(!adaptive[3].rampSlipped && !adaptive[4].rampSlipped && !adaptive[5].rampSlipped);
+    CHECK_NEAR(adaptive[5].rampSec, adaptive[3].rampSec, 1e-6);
+
+    // The learned kick follows pull-in times halfway each start, falling over the warm run and rising again when cold.
+    CHECK(learnedKick[4] < learnedKick[1]);
+    CHECK(learnedKick[5] > learnedKick[4]);
+}
+
+static void testTrackerEdgeCases() {
+    StartupKickTracker tracker;
+    tracker.configure(kickParams());
+    tracker.begin(50.0f, TARGET_RPM);
+    // Missing pulses restart the pull-in hold, so a flicker of speed does not end the kick.
+    CHECK(!tracker.update(1.0f, 49.0f, true, 50.0f));
+    CHECK(!tracker.update(1.1f, 0.0f, false, 50.0f));
+    CHECK(!tracker.update(1.2f, 49.0f, true, 50.0f));
+    CHECK(!tracker.update(1.3f, 49.0f, true, 50.0f));
+    CHECK(tracker.update(1.45f, 49.0f, true, 50.0f));
+    CHECK_NEAR(tracker.getPullInSec(), 1.2, 1e-6);
+    // A start that never pulled in leaves the learned kick alone.
+    StartupKickTracker timedOut;
+    timedOut.configure(kickParams());
+    timedOut.begin(50.0f, TARGET_RPM);
+    timedOut.endKick(6.0f, KICK_END_TIMEOUT, 0.3f);
+    CHECK(timedOut.learnedKickSec(4.0f) == 4.0f);
+    // No kick goes straight to settling, and a stop abandons without a time to lock.
+    StartupKickTracker plain;
+    plain.configure(kickParams());
+    plain.begin(0.0f, TARGET_RPM);
+    CHECK(plain.getPhase() == KICK_PHASE_SETTLE);
+    plain.abandon();
+    CHECK(!plain.isTracking() && !plain.isLocked());
+}
+
+int main() {
+    testColdAndWarmStarts();
+    testTrackerEdgeCases();
+    return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Tach braking replayed against a platter under reverse-field torque, seen through 1, 4 and 360 count/rev sensors.
+
+#include "check.h"
+#include "tach_brake.h"
+
+struct BrakeReplay {
+    TachBrakeDecision decision;
+    double cutSec;
+    double cutRpm;
+    double coastDeg;    // Forward rotation after drive came off
+    double reverseDeg;  // Backward rotation from the furthest forward point
+};
+
+// Plugging deceleration plugRpmPerSec at full drive, scaled by the estimator's drive share, on top of the coast
+// J dw/dt = -B w - Tc. phase is the fraction of a count already turned when braking begins. With keepDriving
+// set, drive stays on past the estimator's decision so a reversal can be watched for.
+static BrakeReplay replay(int cpr, double plugRpmPerSec, double phase, bool keepDriving = false) {
+    const double b = 0.02, c = 0.3, dt = 0.0005, timeoutSec = 20.0;
+    TachBrakeParams params = {(float)cpr, 0.5f, 30.0f, 10.0f, 100, 200, 500, 100};
+    double w = 33.3333;
+    double revs = phase / cpr;
+    double travel = revs;
+    double lastPulseSec = -revs / (w / 60.0);
+    long count = 0;
+    TachBrakeEstimator estimator;
+    estimator.begin(params, (float)w, 0, (uint32_t)(int32_t)llround(lastPulseSec * 1000.0), 0);
+
+    BrakeReplay result = {TACH_BRAKE_CONTINUE, 0.0, 0.0, 0.0, 0.0};
+    bool cut = false;
+    double share = 1.0, peakRevs = revs, cutRevs = revs;
+    for (long step = 0; step * dt < 40.0; step++) {
+        double t = step * dt;
+        double drive = cut ? 0.0 : -plugRpmPerSec * share;
+        double drag = -(b * w) - (w > 0.0 ? c : (w < 0.0 ? -c : 0.0));
+        double next = w + ((drive + drag) * dt);
+        if (w == 0.0 && fabs(drive) <= c) next = 0.0;
+        if (cut && ((w > 0.0 && next < 0.0) || (w < 0.0 && next > 0.0))) next = 0.0;
+        w = next;
+        revs += w / 60.0 * dt;
+        travel += fabs(w) / 60.0 * dt;
+        if (revs > peakRevs) peakRevs = revs;
+        // A pulse sensor counts rotation either way.
+        long counted = (long)floor(travel * cpr);
+        if (counted != count) {
+            count = counted;
+            lastPulseSec = t;
+        }
+        long ms = step / 2;
+        if (cut || step % 20 != 0) continue;
+
+        estimator.addSample((int32_t)count, (uint32_t)llround(lastPulseSec * 1000.0));
+        TachBrakeDecision decision = estimator.update((uint32_t)ms, (uint32_t)((t - lastPulseSec) * 1000.0));
+        share = estimator.getDriveShare();
+        if (keepDriving) {
+            if (decision == TACH_BRAKE_REVERSED) {
+                result.decision = decision;
+                result.cutSec = t;
+                result.cutRpm = w;
+                cut = true;
+            }
+            continue;
+        }
+        if (decision != TACH_BRAKE_CONTINUE || t >= timeoutSec) {
+            result.decision = decision;
+            result.cutSec = t;
+            result.cutRpm = w;
+            cutRevs = revs;
+            cut = true;
+        }
+    }
+    result.coastDeg = peakRevs > cutRevs ? (peakRevs - cutRevs) * 360.0 : 0.0;
+    result.reverseDeg = (peakRevs - revs) * 360.0;
+    return result;
+}
+
+static void testGentleStop() {
+    // About seven seconds of plugging. A 0.5 RPM bound alone would need 120 s without a pulse at 1 count/rev and
+    // 30 s at 4, both past the 20 s timeout; the pulse gap and predicted stop cut drive near the zero crossing.
+    const int cprs[] = {1, 4, 360};
+    const double coastLimitDeg[] = {30.0, 300.0, 5.0};
+    const double phases[] = {0.1, 0.6, 0.95};
+    for (int i = 0; i < 3; i++) {
+        for (double phase : phases) {
+            BrakeReplay r = replay(cprs[i], 5.0, phase);
+            CHECK(r.decision != TACH_BRAKE_CONTINUE);
+            CHECK(r.cutSec < 10.0);
+            CHECK(r.cutRpm >= 0.0);
+            CHECK(r.coastDeg < coastLimitDeg[i]);
+            CHECK(r.reverseDeg < 1.0);
+        }
+    }
+}
+
+static void testFirmStop() {
+    // About two seconds of plugging. The first count after braking fixes the deceleration on the 4 count/rev sensor.
+    const int cprs[] = {4, 360};
+    const double coastLimitDeg[] = {100.0, 5.0};
+    const double phases[] = {0.1, 0.6, 0.95};
+    for (int i = 0; i < 2; i++) {
+        for (double phase : phases) {
+            BrakeReplay r = replay(cprs[i], 20.0, phase);
+            CHECK(r.decision != TACH_BRAKE_CONTINUE);
+            CHECK(r.cutSec < 3.0);
+            CHECK(r.cutRpm >= 0.0);
+            CHECK(r.coastDeg < coastLimitDeg[i]);
+            CHECK(r.reverseDeg < 1.0);
+        }
+    }
+}
+
+static void testHardStopIsPredicted() {
+    // Half a second of plugging leaves no time for the speed to be seen low; the fine sensor predicts the stop.
+    const double phases[] = {0.1, 0.6, 0.95};
+    for (double phase : phases) {
+        BrakeReplay r = replay(360, 60.0, phase);
+        CHECK(r.decision == TACH_BRAKE_PREDICTED);
+        CHECK(r.cutRpm >= 0.0 && r.cutRpm < 2.0);
+        CHECK(r.reverseDeg < 1.0);
+    }
+}
+
+static void testReversalSeen() {
+    // Held on past the stop, the platter turns back and the rising count rate is reported as a reversal.
+    const int cprs[] = {4, 360};
+    for (int cpr : cprs) {
+        BrakeReplay r = replay(cpr, 5.0, 0.6, true);
+        CHECK(r.decision == TACH_BRAKE_REVERSED);
+        CHECK(r.cutRpm < 0.0);
+    }
+}
+
+static void testNoSensor() {
+    // Without a count rate there is nothing to brake against, so the stop is immediate.
+    TachBrakeParams params = {0.0f, 0.5f, 30.0f, 10.0f, 100, 200, 500, 100};
+    TachBrakeEstimator estimator;
+    estimator.begin(params, 33.3333f, 0, 0, 0);
+    CHECK(estimator.update(10, 10) == TACH_BRAKE_STANDSTILL);
+}
+
+int main() {
+    testGentleStop();
+    testFirmStop();
+    testHardStopIsPredicted();
+    testReversalSeen();
+    testNoSensor();
+    return 0;
+}
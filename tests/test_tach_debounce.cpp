@@ -0,0 +1,165 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Tach debounce on chattering edge streams: a bouncing one-slot optical sensor and a 360 CPR encoder, through the
+// per-edge decision and the speed-tracking window the ISR uses.
+
+#include "check.h"
+#include "tach_debounce.h"
+#include "random.h"
+
+static const float SPEED_RPM[3] = {33.3333f, 45.0f, 78.0f};
+static const TachDebounceParams PARAMS = {0.25f, 0.5f};  // SPEED_DEBOUNCE_PERIOD_FRACTION, SPEED_DEBOUNCE_MAX_FRACTION
+
+// A pulse input counting rising edges, driven one pin change at a time the way handleInterrupt sees them.
+struct TachInput {
+    uint32_t windowUs;
+    uint32_t windowStartUs;
+    uint8_t lastA;
+    long accepted;
+    long debounced;
+
+    void begin(uint32_t window) {
+        windowUs = window;
+        windowStartUs = 0;
+        lastA = 0;
+        accepted = 0;
+        debounced = 0;
+    }
+
+    void pinChange(uint32_t nowUs, uint8_t a) {
+        TachEdgeAction action = tachDebounceEdge(windowUs, windowStartUs, nowUs, lastA, a);
+        if (action == TACH_EDGE_DEBOUNCED) {
+            debounced++;
+            return;
+        }
+        if (action == TACH_EDGE_PASSED) windowStartUs = nowUs;
+        uint8_t previousA = lastA;
+        lastA = a;
+        if (!previousA && a) accepted++;
+    }
+};
+
+struct StreamResult {
+    long edges;       // Real rising edges
+    long bounces;     // Pin changes that were chatter
+    long accepted;
+    long debounced;
+};
+
+// One real transition followed by up to maxBounces chatter pulses, all within bounceSpanUs of it.
+static void edge(TachInput& input, Random& rng, double tUs, uint8_t level, int maxBounces, double bounceSpanUs,
+                 long& bounces) {
+    input.pinChange((uint32_t)tUs, level);
+    int pulses = 1 + (int)(rng.uniform() * maxBounces);
+    double step = bounceSpanUs / (2.0 * pulses);
+    double t = tUs;
+    for (int i = 0; i < 2 * pulses; i++) {
+        t += step * (0.5 + rng.uniform());
+        input.pinChange((uint32_t)t, (i & 1) ? level : (uint8_t)!level);
+        bounces++;
+    }
+}
+
+// A pulse sensor at 50% duty with every edge chattering, run for the given revolutions.
+static StreamResult runStream(uint32_t windowUs, float rpm, uint16_t countsPerRev, int maxBounces, double bounceSpanUs,
+                              long revolutions, uint32_t seed) {
+    TachInput input;
+    input.begin(windowUs);
+    Random rng = {seed};
+    double period = 60000000.0 / (rpm * countsPerRev);
+    double t = 2000000.0;  // Well past any window from the zero start
+    StreamResult result = {0, 0, 0, 0};
+    for (long n = 0; n < revolutions * countsPerRev; n++) {
+        double jittered = period * (1.0 + 0.002 * (2.0 * rng.uniform() - 1.0));
+        edge(input, rng, t, 1, maxBounces, bounceSpanUs, result.bounces);
+        edge(input, rng, t + 0.5 * jittered, 0, maxBounces, bounceSpanUs, result.bounces);
+        t += jittered;
+        result.edges++;
+    }
+    result.accepted = input.accepted;
+    result.debounced = input.debounced;
+    return result;
+}
+
+static void testEdgeDecision() {
+    CHECK(tachDebounceEdge(50, 1000, 1049, 0, 1) == TACH_EDGE_DEBOUNCED);
+    CHECK(tachDebounceEdge(50, 1000, 1050, 0, 1) == TACH_EDGE_PASSED);
+    CHECK(tachDebounceEdge(50, 1000, 1050, 1, 1) == TACH_EDGE_UNCHANGED);
+    // Even an unchanged read inside the window counts as debounced; the ISR never got to look at it.
+    CHECK(tachDebounceEdge(50, 1000, 1010, 1, 1) == TACH_EDGE_DEBOUNCED);
+    CHECK(tachDebounceEdge(0, 1000, 1000, 2, 3) == TACH_EDGE_PASSED);
+    // The window holds across the micros() wrap.
+    CHECK(tachDebounceEdge(50, 0xFFFFFFF0u, 0x10u, 0, 1) == TACH_EDGE_DEBOUNCED);
+    CHECK(tachDebounceEdge(50, 0xFFFFFFF0u, 0x22u, 0, 1) == TACH_EDGE_PASSED);
+}
+
+static void testUncountedEdgeRestartsWindow() {
+    // Rising edges are counted, but the falling edge's bounce is held off too: one real pulse, chatter after both.
+    TachInput input;
+    input.begin(100);
+    input.pinChange(1000, 1);
+    input.pinChange(1040, 0);
+    input.pinChange(1080, 1);
+    input.pinChange(5000, 0);
+    input.pinChange(5060, 1);
+    input.pinChange(5090, 0);
+    CHECK(input.accepted == 1);
+    CHECK(input.debounced == 4);
+    CHECK(input.lastA == 0);
+    // The next real edge is read against the right pin state and counted.
+    input.pinChange(9000, 1);
+    CHECK(input.accepted == 2);
+}
+
+static void testOneSlotOptical() {
+    // One slot per revolution, up to four chatter pulses over 3 ms on every edge.
+    for (int speed = 0; speed < 3; speed++) {
+        uint32_t adaptiveUs = tachDebounceWindowUs(PARAMS, 50, SPEED_RPM[speed], 1, 2);
+        StreamResult fixed = runStream(50, SPEED_RPM[speed], 1, 4, 3000.0, 200, 10 + speed);
+        StreamResult adaptive = runStream(adaptiveUs, SPEED_RPM[speed], 1, 4, 3000.0, 200, 10 + speed);
+        printf("1 CPR optical at %.1f: 50 us window accepts %ld of %ld, %ld debounced; %u us window accepts %ld, %ld debounced of %ld bounces\n",
+               SPEED_RPM[speed], fixed.accepted, fixed.edges, fixed.debounced, (unsigned)adaptiveUs, adaptive.accepted,
+               adaptive.debounced, adaptive.bounces);
+        // The bounces are hundreds of microseconds apart, so a fixed 50 us window counts many of them as slots.
+        CHECK(fixed.accepted > fixed.edges * 3 / 2);
+        // A window taken from the revolution holds off all of them, at every speed.
+        CHECK(adaptiveUs > 3000);
+        CHECK(adaptive.accepted == adaptive.edges);
+        CHECK(adaptive.debounced == adaptive.bounces);
+    }
+}
+
+static void testFineEncoderAt78() {
+    // 360 CPR at 78 RPM: pin changes about 1.07 ms apart, each followed by up to two chatter pulses within 120 us.
+    const float rpm = SPEED_RPM[2];
+    uint32_t adaptiveUs = tachDebounceWindowUs(PARAMS, 50, rpm, 360, 2);
+    StreamResult shortFixed = runStream(50, rpm, 360, 2, 120.0, 100, 20);
+    StreamResult adaptive = runStream(adaptiveUs, rpm, 360, 2, 120.0, 100, 20);
+    // A window configured for the slow optical sensor would sit across the next real edge; the cap keeps it clear.
+    uint32_t cappedUs = tachDebounceWindowUs(PARAMS, 3000, rpm, 360, 2);
+    StreamResult longFixed = runStream(3000, rpm, 360, 2, 120.0, 100, 20);
+    StreamResult capped = runStream(cappedUs, rpm, 360, 2, 120.0, 100, 20);
+    printf("360 CPR at 78: of %ld edges, 50 us accepts %ld, %u us accepts %ld (%ld debounced of %ld bounces), 3000 us accepts %ld, capped %u us accepts %ld\n",
+           adaptive.edges, shortFixed.accepted, (unsigned)adaptiveUs, adaptive.accepted, adaptive.debounced,
+           adaptive.bounces, longFixed.accepted, (unsigned)cappedUs, capped.accepted);
+    CHECK(shortFixed.accepted > shortFixed.edges);
+    CHECK(adaptive.accepted == adaptive.edges);
+    CHECK(adaptive.debounced == adaptive.bounces);
+    CHECK(longFixed.accepted < longFixed.edges / 2);
+    CHECK(cappedUs < 600);
+    CHECK(capped.accepted == capped.edges);
+}
+
+int main() {
+    testEdgeDecision();
+    testUncountedEdgeRestartsWindow();
+    testOneSlotOptical();
+    testFineEncoderAt78();
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+// Winding temperature estimate and derating against synthetic duty cycles.
+
+#include "check.h"
+#include "thermal_model.h"
+
+static MotorThermalParams defaultParams() {
+    // The firmware defaults.
+    MotorThermalParams params;
+    params.windingTauSec = 60.0f;
+    params.frameTauSec = 900.0f;
+    params.fullScaleRiseC = 60.0f;
+    params.windingShare = 0.3f;
+    params.derateStartC = 40.0f;
+    params.derateLimitC = 55.0f;
+    params.minDerate = 0.5f;
+    params.derateSlewPerSec = 0.02f;
+    return params;
+}
+
+static MotorThermalParams noDerateParams() {
+    MotorThermalParams params = defaultParams();
+    params.derateStartC = 1000.0f;
+    params.derateLimitC = 1001.0f;
+    return params;
+}
+
+static void run(MotorThermalModel& model, float seconds, float dtSec, float drive) {
+    for (float t = 0.0f; t < seconds; t += dtSec) model.update(dtSec, drive);
+}
+
+static void testSteadyRiseIsSquareLaw() {
+    MotorThermalModel model;
+    model.configure(noDerateParams());
+    run(model, 3.0f * 3600.0f, 1.0f, 1.0f);
+    CHECK_NEAR(model.getRiseC(), 60.0, 0.5);
+    CHECK_NEAR(model.getWindingRiseC(), 18.0, 0.1);
+
+    // Half drive is a quarter of the copper loss.
+    model.reset();
+    run(model, 3.0f * 3600.0f, 1.0f, 0.5f);
+    CHECK_NEAR(model.getRiseC(), 15.0, 0.2);
+    CHECK_NEAR(model.getSteadyRiseC(), 15.0, 0.01);
+}
+
+static void testTimeConstants() {
+    // After one winding time constant the fast node has covered 63% of its share while the frame has barely moved.
+    MotorThermalModel model;
+    model.configure(noDerateParams());
+    run(model, 60.0f, 0.1f, 1.0f);
+    CHECK_NEAR(model.getWindingRiseC(), 18.0 * (1.0 - exp(-1.0)), 0.2);
+    CHECK_NEAR(model.getFrameRiseC(), 42.0 * (1.0 - exp(-60.0 / 900.0)), 0.2);
+}
+
+static void testUpdateRateIndependence() {
+    // The exact first-order step gives the same temperature for fast and slow update loops.
+    MotorThermalModel fast;
+    MotorThermalModel slow;
+    fast.configure(noDerateParams());
+    slow.configure(noDerateParams());
+    run(fast, 600.0f, 0.01f, 0.8f);
+    run(slow, 600.0f, 10.0f, 0.8f);
+    CHECK_NEAR(fast.getRiseC(), slow.getRiseC(), 0.2);
+}
+
+static void testIntermittentDuty() {
+    // One minute on, one minute off at full drive averages to half the loss; the slow frame node sees the mean.
+    MotorThermalModel model;
+    model.configure(noDerateParams());
+    float peak = 0.0f;
+    for (int cycle = 0; cycle < 120; cycle++) {
+        run(model, 60.0f, 0.5f, 1.0f);
+        if (model.getRiseC() > peak) peak = model.getRiseC();
+        run(model, 60.0f, 0.5f, 0.0f);
+    }
+    CHECK_NEAR(model.getFrameRiseC(), 21.0, 1.5);
+    // The winding ripples above the mean but stays well short of continuous full drive.
+    CHECK(peak > 30.0f && peak < 45.0f);
+
+    // Switched off, both nodes cool back towards ambient.
+    run(model, 3.0f * 3600.0f, 1.0f, 0.0f);
+    CHECK(model.getRiseC() < 0.5f);
+}
+
+static void testDerateHoldsBelowLimit() {
+    // Drive scaled by the model's own multiplier, as the motor controller applies it.
+    MotorThermalModel model;
+    model.configure(defaultParams());
+    const float dt = 0.1f;
+    float previous = model.getDerate();
+    float peakRise = 0.0f;
+    for (float t = 0.0f; t < 4.0f * 3600.0f; t += dt) {
+        model.update(dt, model.getDerate());
+        float derate = model.getDerate();
+        CHECK(fabsf(derate - previous) <= 0.02f * dt + 1e-6f);
+        CHECK(derate >= 0.5f - 1e-6f && derate <= 1.0f);
+        previous = derate;
+        if (model.getRiseC() > peakRise) peakRise = model.getRiseC();
+    }
+    CHECK(model.getDerate() < 0.95f);
+    CHECK(peakRise < 55.0f);
+    CHECK(model.getRiseC() > 40.0f);
+
+    // Cooling brings the multiplier back to unity.
+    run(model, 3.0f * 3600.0f, 1.0f, 0.0f);
+    CHECK_NEAR(model.getDerate(), 1.0, 1e-6);
+}
+
+static void testDerateCurve() {
+    MotorThermalModel model;
+    model.configure(defaultParams());
+    CHECK(model.targetDerate(40.0f) == 1.0f);
+    CHECK_NEAR(model.targetDerate(47.5f), 0.75, 1e-5);
+    CHECK(model.targetDerate(55.0f) == 0.5f);
+    CHECK(model.targetDerate(80.0f) == 0.5f);
+}
+
+static void testRejectsBadInput() {
+    MotorThermalModel model;
+    model.configure(noDerateParams());
+    model.update(1.0f, NAN);
+    model.update(NAN, 1.0f);
+    model.update(-1.0f, 1.0f);
+    CHECK(model.getRiseC() == 0.0f);
+    model.update(1.0f, 4.0f);
+    CHECK(model.getDrive() == 1.0f);
+}
+
+int main() {
+    testSteadyRiseIsSquareLaw();
+    testTimeConstants();
+    testUpdateRateIndependence();
+    testIntermittentDuty();
+    testDerateHoldsBelowLimit();
+    testDerateCurve();
+    testRejectsBadInput();
+    return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#include "thermal_model.h"
+#include <math.h>
+
+MotorThermalModel::MotorThermalModel() {
+    _params.windingTauSec = 60.0f;
+    _params.frameTauSec = 900.0f;
+    _params.fullScaleRiseC = 60.0f;
+    _params.windingShare = 0.3f;
+    _params.derateStartC = 40.0f;
+    _params.derateLimitC = 55.0f;
+    _params.minDerate = 0.5f;
+    _params.derateSlewPerSec = 0.02f;
+    reset();
+}
+
+void MotorThermalModel::configure(const MotorThermalParams& params) {
+    _params = params;
+}
+
+void MotorThermalModel::reset() {
+    _windingRiseC = 0.0f;
+    _frameRiseC = 0.0f;
+    _drive = 0.0f;
+    _derate = 1.0f;
+}
+
+static float settleToward(float value, float target, float dtSec, float tauSec) {
+    // Exact first-order step, so long or irregular update gaps cannot overshoot.
+    if (!(tauSec > 0.0f)) return target;
+    return target + ((value - target) * expf(-dtSec / tauSec));
+}
+
+void MotorThermalModel::update(float dtSec, float drive) {
+    if (!isfinite(dtSec) || dtSec <= 0.0f) return;
+    if (!isfinite(drive) || drive < 0.0f) drive = 0.0f;
+    if (drive > 1.0f) drive = 1.0f;
+    _drive = drive;
+
+    float heating = drive * drive * _params.fullScaleRiseC;
+    _windingRiseC = settleToward(_windingRiseC, heating * _params.windingShare, dtSec, _params.windingTauSec);
+    _frameRiseC = settleToward(_frameRiseC, heating * (1.0f - _params.windingShare), dtSec, _params.frameTauSec);
+
+    // The multiplier is slewed so derating never produces an audible amplitude step.
+    float target = targetDerate(getRiseC());
+    float step = _params.derateSlewPerSec * dtSec;
+    if (target < _derate - step) {
+        _derate -= step;
+    } else if (target > _derate + step) {
+        _derate += step;
+    } else {
+        _derate = target;
+    }
+}
+
+float MotorThermalModel::getSteadyRiseC() const {
+    return _drive * _drive * _params.fullScaleRiseC;
+}
+
+float MotorThermalModel::targetDerate(float riseC) const {
+    if (riseC <= _params.derateStartC) return 1.0f;
+    if (riseC >= _params.derateLimitC || _params.derateLimitC <= _params.derateStartC) return _params.minDerate;
+    // Smoothstep keeps the first and last few degrees gentle so the output eases in and out of derating.
+    float x = (riseC - _params.derateStartC) / (_params.derateLimitC - _params.derateStartC);
+    float shaped = x * x * (3.0f - (2.0f * x));
+    return 1.0f - ((1.0f - _params.minDerate) * shaped);
+}
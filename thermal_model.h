@@ -0,0 +1,64 @@
+/*
+ * TT Control, advanced sinusoidal control of multi-phase turntable motors
+ * Created by Ashley Cox at The Blind Man’s Workshop
+ * https://theblindmansworkshop.com
+ * No part of this code may be used or reproduced for commercial purposes without written permission and contractual agreement
+ * All external libraries and frameworks are the property of their respective authors and governed by their respective licenses
+ */
+
+#ifndef THERMAL_MODEL_H
+#define THERMAL_MODEL_H
+
+#include <stdint.h>
+
+/*
+ * Two-node I²t estimate of winding temperature rise above ambient.
+ *
+ * Copper loss follows the square of drive current, and with the V/f curve
+ * already folded into the applied amplitude, current tracks that amplitude.
+ * Heating is therefore normalised so a continuous full-scale drive of 1.0
+ * settles at fullScaleRiseC. The rise is split between a fast winding-to-frame
+ * node and a slow frame-to-ambient node, each a first-order lag:
+ *
+ *     rise = windingOverFrame + frameOverAmbient
+ *
+ * This file deliberately avoids Arduino headers so synthetic duty cycles can
+ * be replayed through the model on a host.
+ */
+struct MotorThermalParams {
+    float windingTauSec;
+    float frameTauSec;
+    float fullScaleRiseC;   // Steady rise at continuous full drive
+    float windingShare;     // 0-1 share of that rise across the winding node
+    float derateStartC;     // Rise where derating begins
+    float derateLimitC;     // Rise where derating reaches minDerate
+    float minDerate;        // 0-1 floor for the output multiplier
+    float derateSlewPerSec; // Fastest change of the output multiplier
+};
+
+class MotorThermalModel {
+public:
+    MotorThermalModel();
+
+    void configure(const MotorThermalParams& params);
+    void reset();
+    // drive is the normalised output amplitude (0-1) averaged over dtSec.
+    void update(float dtSec, float drive);
+
+    float getRiseC() const { return _windingRiseC + _frameRiseC; }
+    float getWindingRiseC() const { return _windingRiseC; }
+    float getFrameRiseC() const { return _frameRiseC; }
+    float getDrive() const { return _drive; }
+    float getSteadyRiseC() const;
+    float getDerate() const { return _derate; }
+    float targetDerate(float riseC) const;
+
+private:
+    MotorThermalParams _params;
+    float _windingRiseC; // Winding above frame
+    float _frameRiseC;   // Frame above ambient
+    float _drive;
+    float _derate;
+};
+
+#endif // THERMAL_MODEL_H
@@ -53,17 +53,20 @@ enum FilterType {
     FILTER_FIR  // Finite Impulse Response (Convolution)
 };
 
+// Named profiles are fixed design inputs; Custom uses the per-speed cutoff, width and tap budget in GlobalSettings.
 enum FirProfile {
     FIR_GENTLE,
     FIR_MEDIUM,
-    FIR_AGGRESSIVE
+    FIR_AGGRESSIVE,
+    FIR_CUSTOM
 };
 
 enum BrakeMode : int {
     BRAKE_OFF,
     BRAKE_PULSE, // Pulsed reverse torque
     BRAKE_RAMP,   // Linear frequency ramp down
-    BRAKE_SOFT_STOP // Active coasting down to a cutoff frequency
+    BRAKE_SOFT_STOP, // Active coasting down to a cutoff frequency
+    BRAKE_TACH  // Reverse torque shaped by measured speed until standstill
 };
 
 enum RampType {
@@ -79,9 +82,17 @@ enum ScreensaverMode {
 
 enum ClosedLoopSensorMode {
     CLOSED_LOOP_SENSOR_PULSE = 0,
-    CLOSED_LOOP_SENSOR_QUADRATURE = 1
+    CLOSED_LOOP_SENSOR_QUADRATURE = 1,
+    CLOSED_LOOP_SENSOR_SENSORLESS = 2
 };
 
+// Sensorless mode is only selectable in builds that sample the sense input.
+#if SENSORLESS_SPEED_ENABLE
+#define CLOSED_LOOP_SENSOR_LAST CLOSED_LOOP_SENSOR_SENSORLESS
+#else
+#define CLOSED_LOOP_SENSOR_LAST CLOSED_LOOP_SENSOR_QUADRATURE
+#endif
+
 enum ClosedLoopControlMode {
     CLOSED_LOOP_CONTROL_MONITOR = 0,
     CLOSED_LOOP_CONTROL_CORRECT = 1
@@ -127,6 +138,13 @@ enum ClosedLoopPitchTargetMode {
     CLOSED_LOOP_PITCH_TARGET_FOLLOW = 1
 };
 
+enum ClosedLoopSlipAction {
+    CLOSED_LOOP_SLIP_IGNORE = 0,
+    CLOSED_LOOP_SLIP_WARN = 1,
+    CLOSED_LOOP_SLIP_BOOST = 2,
+    CLOSED_LOOP_SLIP_STOP = 3
+};
+
 /*
  * --- Data Structures ---
  * The settings structs below are written directly to LittleFS. Field order,
@@ -163,7 +181,7 @@ struct SpeedSettings {
     // Digital Filters
     uint8_t filterType; // 0=None, 1=IIR, 2=FIR
     float iirAlpha;
-    uint8_t firProfile; // 0=Gentle, 1=Medium, 2=Aggressive
+    uint8_t firProfile; // 0=Gentle, 1=Medium, 2=Aggressive, 3=Custom
 };
 
 // PID-like closed-loop parameters are duplicated per speed. That lets a deck use gentler correction at one RPM and tighter correction at another.
@@ -181,6 +199,28 @@ struct ClosedLoopSpeedTuning {
     uint16_t lockTimeMs;
 };
 
+// Coast-down identification for one speed. Rates are inertia-normalised: viscousPerSec is B/J and coulombRpmPerSec is Tc/J.
+struct CoastDownSpeedModel {
+    float viscousPerSec;
+    float coulombRpmPerSec;
+    float startRpm; // Measured speed when drive was cut
+    float rSquared; // Fit quality, 0-1
+    uint16_t sampleCount;
+    uint8_t valid;
+    uint8_t reserved;
+};
+
+// Base-frequency learner state for one speed. Field for field the same as BaseLearnSpeed in base_learn.h.
+struct BaseLearnSpeedModel {
+    float ratioRpmPerHz;  // Learned platter RPM per drive hertz, 0 when nothing is learned
+    float ratioSpread;
+    float weight;
+    float anchorHz;       // Base the user last set
+    float lastHz;
+    float previousHz;     // Base before a step on probation
+    float probationAbsHz;
+};
+
 // Top-level persisted settings. Keep new fields grouped by feature and update settings.cpp, menus, serial registry, web JSON, and schema migration together.
 struct GlobalSettings {
     // Version is checked before using binary contents from LittleFS.
@@ -330,6 +370,66 @@ struct GlobalSettings {
 
     // Frequency at which the V/f curve reaches the full configured drive amplitude.
     float vfBaseFreq;
+
+    // Slip detection compares measured platter speed with the synchronous speed implied by the commanded output frequency.
+    uint8_t closedLoopSlipAction; // 0=Ignore, 1=Warn, 2=Restore full amplitude, 3=Stop
+    uint16_t closedLoopSlipDetectMs;
+    float closedLoopSlipThresholdPercent;
+    float closedLoopPullOutThresholdPercent;
+
+    // Measured deck mechanics rather than a tune, so motor presets leave these untouched.
+    CoastDownSpeedModel coastDownModel[3]; // 33, 45, 78
+
+    // Winding I²t model. The estimate always runs; derating only trims drive while running when enabled.
+    float thermalWindingTauSec;
+    float thermalFrameTauSec;
+    float thermalFullScaleRiseC; // Steady rise above ambient at continuous full drive
+    float thermalDerateStartC;   // Rise above ambient
+    float thermalDerateLimitC;   // Rise above ambient
+    bool thermalDerateEnabled;
+    uint8_t thermalWindingShare; // 0-100% of the full-scale rise across the winding node
+    uint8_t thermalMinDerate;    // 10-100% output floor
+    uint8_t thermalReserved;
+
+    // Adaptive notch on the closed-loop correction. Frequencies are platter-speed oscillation, not output frequency.
+    float closedLoopNotchBandwidthHz;
+    float closedLoopNotchMinHz;
+    float closedLoopNotchMaxHz;
+    bool closedLoopNotchEnabled;
+    uint8_t closedLoopNotchReserved[3];
+
+    // Needle-drop feed-forward. The learned step is measured deck behaviour per speed, so motor presets leave it untouched.
+    float loadStepSlopeRpmPerSec;  // Error slope that counts as a load step
+    float loadStepLearnedHz[3];    // 33, 45, 78; zero until a step has been measured
+    uint16_t loadStepBoostMs;      // Amplitude boost fade time after a needle drop
+    bool loadStepEnabled;
+    uint8_t loadStepBoostPercent;  // 0-50% extra drive at the moment of the drop
+
+    // Bridge dead-time compensation. Phase current lags the drive by an angle that grows with frequency, so each speed keeps its own.
+    float bridgeDeadTimeLagDeg[3]; // 33, 45, 78; current lag behind the drive voltage
+    uint16_t bridgeDeadTimeNs;     // 0 disables compensation
+    uint8_t bridgeDeadTimeReserved[2];
+
+    // Custom FIR design inputs per speed, used when a speed's FIR profile is Custom.
+    float firCutoffHz[3];     // 33, 45, 78; -6 dB point
+    float firTransitionHz[3]; // Passband edge to stopband edge
+    uint8_t firTaps[3];       // Tap budget, 4-32; the designer may use fewer
+    uint8_t firDesignReserved;
+
+    // Adaptive startup kick. Learned lengths are measured on this deck and are not carried by presets.
+    uint16_t kickLearnedMs[3];     // 33, 45, 78; smoothed pull-in time, 0 until a start has pulled in
+    uint16_t kickRampLearnedMs[3]; // Kick ramp that last carried the platter down without slipping
+    bool adaptiveKickEnabled;      // End the kick at pull-in and reuse learned lengths
+    uint8_t kickPullInPercent;     // Share of the kick's synchronous speed that counts as pulled in
+    uint8_t kickReserved[2];
+
+    // Base-frequency learning. The learned state belongs to this deck and is not carried by presets.
+    BaseLearnSpeedModel baseLearn[3]; // 33, 45, 78
+    bool baseLearnEnabled;            // Let locked sessions step the base frequency
+    uint8_t baseLearnReserved[3];
+
+    // Linear-amplifier DC offset nulls. Measured on this amplifier and not carried by presets.
+    int16_t dcOffsetNull[4];          // A-D, duty correction in 1/256 PWM count steps
 };
 
 #pragma pack(pop)
@@ -337,6 +437,8 @@ struct GlobalSettings {
 // These assertions catch accidental storage-layout changes during compilation.
 static_assert(sizeof(SpeedSettings) == SPEED_SETTINGS_STORAGE_SIZE, "Update SPEED_SETTINGS_STORAGE_SIZE when SpeedSettings changes.");
 static_assert(sizeof(ClosedLoopSpeedTuning) == CLOSED_LOOP_TUNING_STORAGE_SIZE, "Update CLOSED_LOOP_TUNING_STORAGE_SIZE when ClosedLoopSpeedTuning changes.");
+static_assert(sizeof(CoastDownSpeedModel) == COAST_DOWN_MODEL_STORAGE_SIZE, "Update COAST_DOWN_MODEL_STORAGE_SIZE when CoastDownSpeedModel changes.");
+static_assert(sizeof(BaseLearnSpeedModel) == BASE_LEARN_MODEL_STORAGE_SIZE, "Update BASE_LEARN_MODEL_STORAGE_SIZE when BaseLearnSpeedModel changes.");
 static_assert(sizeof(GlobalSettings) == GLOBAL_SETTINGS_STORAGE_SIZE,
     "Update GLOBAL_SETTINGS_STORAGE_SIZE and storage handling when GlobalSettings changes.");
 
@@ -60,7 +60,7 @@ static void drawCenteredClassic(const char* text, int y, uint8_t scale = 1) {
 
 // The dashboard uses four-character state labels so the top row still has space for frequency and the lock icon on a 128px display.
 static const char* dashboardStateLabel() {
-    if (motor.isRelayTestMode()) return "TEST";
+    if (motor.isRelayTestMode() || motor.isDcOffsetNullActive()) return "TEST";
     if (motor.isSpeedRamping()) return "RAMP";
 
     switch (motor.getState()) {
@@ -407,7 +407,7 @@ void UserInterface::handleInput() {
         // Keep the per-speed menu shadow aligned with the motor speed when the hardware speed button is used while inside the menu.
         if (_inMenu) {
              menuShadowSpeedIndex = (int)motor.getSpeed();
-             menuShadowSettings = settings.get().speeds[menuShadowSpeedIndex];
+             loadMenuShadowSettings();
              extern void updateSpeedLabel();
              updateSpeedLabel();
         }
@@ -15,13 +15,27 @@
 // Global pointer for ISR access. Only one WaveformGenerator exists in this sketch, so a static thunk is simpler than passing context through the IRQ API.
 static WaveformGenerator* _waveformInstance = nullptr;
 static const uint16_t PWM_WRAP_VALUE = 1023;
+static const uint8_t PWM_PERIOD_BITS = 10; // PWM_WRAP_VALUE + 1 is 1 << PWM_PERIOD_BITS, so dither rescaling is a shift
 static const float FALLBACK_SAMPLE_RATE_HZ = 50000.0f;
 static const double DDS_ACCUMULATOR_SCALE = 4294967296.0;
 
-// FIR coefficients are normalized to roughly unity gain so filtering does not change the requested output amplitude.
-const float FIR_COEFFS_GENTLE[8] = {0.0, 0.0, 0.1, 0.4, 0.4, 0.1, 0.0, 0.0};
-const float FIR_COEFFS_MEDIUM[8] = {0.05, 0.05, 0.1, 0.3, 0.3, 0.1, 0.05, 0.05};
-const float FIR_COEFFS_AGGRESSIVE[8] = {0.1, 0.1, 0.1, 0.2, 0.2, 0.1, 0.1, 0.1};
+// Design inputs behind the named FIR profiles: cutoff, transition width and tap budget. Custom reads its inputs from settings.
+static const FirDesignParams FIR_PROFILE_DESIGNS[3] = {
+    { 8000.0f, 8000.0f, FIR_MAX_TAPS, FIR_DESIGN_STOPBAND_DB }, // Gentle
+    { 5000.0f, 5000.0f, FIR_MAX_TAPS, FIR_DESIGN_STOPBAND_DB }, // Medium
+    { 2500.0f, 4000.0f, FIR_MAX_TAPS, FIR_DESIGN_STOPBAND_DB }  // Aggressive
+};
+static_assert((FIR_MAX_TAPS & (FIR_MAX_TAPS - 1)) == 0, "FIR history indexing needs a power-of-two tap limit.");
+static_assert((int)FILTER_NONE == (int)OUTPUT_FILTER_NONE && (int)FILTER_IIR == (int)OUTPUT_FILTER_IIR && (int)FILTER_FIR == (int)OUTPUT_FILTER_FIR, "Output filter types must match FilterType.");
+
+static bool sameFirKernel(const FirKernel& a, const FirKernel& b) {
+    return a.taps == b.taps && memcmp(a.half, b.half, sizeof(a.half)) == 0;
+}
+
+static bool sameFirDesignInputs(const FirDesignParams& a, const FirDesignParams& b) {
+    return a.cutoffHz == b.cutoffHz && a.transitionHz == b.transitionHz &&
+        a.tapBudget == b.tapBudget && a.stopbandDb == b.stopbandDb;
+}
 
 WaveformGenerator::WaveformGenerator() {
     _enabled = false;
@@ -37,12 +51,26 @@ WaveformGenerator::WaveformGenerator() {
     _stateA.frequency = 50.0;
     _stateA.amplitude = 0.0;
     _stateA.phaseInc = 0;
+    _stateA.phaseIncFrac = 0;
+    _stateA.phaseDenominator = 0;
+    _stateA.unitPhaseRemainder = 0;
+    _stateA.unitPhaseCarry = 0;
+    _stateA.phaseReverse = false;
+    _stateA.rationalNumerator = 0;
+    _stateA.rationalDenominator = 0;
     _stateA.filterType = FILTER_NONE;
     _stateA.iirAlpha = 0.0;
-    _stateA.firProfile = FIR_GENTLE;
+    memset(&_stateA.firKernel, 0, sizeof(_stateA.firKernel));
+    _stateA.fromFilterType = FILTER_NONE;
+    _stateA.fromIirAlpha = 0.0;
+    memset(&_stateA.fromFirKernel, 0, sizeof(_stateA.fromFirKernel));
+    _stateA.filterBlend = 1.0f;
     _stateA.activePhaseOutputs = DEFAULT_PHASE_MODE;
     _stateA.phaseSlewDegreesPerSecond = 180.0f;
     _stateA.gainSlewPercentPerSecond = 50.0f;
+    _stateA.deadTimeScaleQ16 = 0;
+    _stateA.deadTimeLagAcc = 0;
+    _stateA.peakLimit = 1.0f;
     for(int i=0; i<4; i++) {
         _stateA.phaseOffsets[i] = 0;
         _stateA.channelGain[i] = 1.0f;
@@ -56,20 +84,43 @@ WaveformGenerator::WaveformGenerator() {
     
     _lutSize = LUT_MAX_SIZE;
     _sampleRateHz = FALLBACK_SAMPLE_RATE_HZ;
+    _clockHz = 0;
+    _clockDivider16 = 0;
+    for (int i = 0; i < 3; i++) {
+        memset(&_firDesign[i], 0, sizeof(_firDesign[i]));
+        memset(&_firDesignInputs[i], 0, sizeof(_firDesignInputs[i]));
+        _firDesignRateHz[i] = 0.0f;
+    }
+    _deadTimeSoftLut = deadTimeSoftLut(POWER_STAGE_DEADTIME_SOFT_DEG, 511);
+    _deadTimeCounts = 0.0f;
+    configureBridgeModulation();
+    _bridgeLimitCount = 0;
+    _supplyScale = 1.0f;
+    _bufferSupplyScale = 1.0f;
+    for (int i = 0; i < 4; i++) {
+        _bufferChannelScale[i] = 0.0f;
+        _limiterGain[i] = 1.0f;
+        _dcOffsetNull[i] = 0;
+        _dcNullResidue[i] = 0;
+    }
     
     // Initialize per-channel state
     for(int i=0; i<4; i++) {
         _phaseAcc[i] = 0; // Only _phaseAcc[0] is used as master, others are derived
-        _iirPrev[i] = 0.0;
+        _outputFilter[i].reset();
         _lastSamples[i] = 0;
-        for(int j=0; j<8; j++) _firBuffer[i][j] = 0;
     }
-    _firIndex = 0;
+    _phaseFrac = 0;
+    _phaseRemainderAcc = 0;
+    _crossfadeActive = false;
     _appliedTuningInitialized = false;
     // Number of top accumulator bits used as the LUT index.
     _lutShift = 32 - (int)log2(_lutSize);
     
     _currentBufferIndex = 0;
+    _bufferLength[0] = DMA_BUFFER_SIZE;
+    _bufferLength[1] = DMA_BUFFER_SIZE;
+    _lowLatency = false;
     _lastBufferFillMs = 0;
     _bufferFillCount = 0;
     _dmaIrqCount = 0;
@@ -78,6 +129,26 @@ WaveformGenerator::WaveformGenerator() {
     _slice1RearmPending[0] = false;
     _slice1RearmPending[1] = false;
     _dmaStarted = false;
+    for (int i = 0; i < 2; i++) {
+        _bufferStartPhase[i] = 0;
+        _bufferPhaseInc[i] = 0;
+    }
+    _phaseRefSequence = 0;
+    _phaseRefAcc = 0;
+    _phaseRefInc = 0;
+    _phaseRefUs = 0;
+    PwmDitherParams ditherParams;
+    ditherParams.periodBits = PWM_PERIOD_BITS;
+#if PWM_DITHER_ENABLE
+    ditherParams.spanCounts = (uint16_t)lroundf((float)(PWM_WRAP_VALUE + 1) * (PWM_DITHER_PERCENT / 100.0f));
+#else
+    ditherParams.spanCounts = 0;
+#endif
+    _dither.configure(ditherParams, 0x9E3779B9u);
+    _bufferWrap[0] = PWM_WRAP_VALUE;
+    _bufferWrap[1] = PWM_WRAP_VALUE;
+    _ditherRemainderAcc = 0;
+    _ditherLateCount = 0;
 }
 
 void WaveformGenerator::begin() {
@@ -120,17 +191,25 @@ void WaveformGenerator::setupPWM() {
      * increment uses the resulting sample rate, keeping RP2040 and RP2350
      * builds on the configured carrier and motor frequency at any supported
      * system-clock selection.
+     *
+     * The hardware divider is 8.4 fixed point. It is rounded and programmed
+     * here rather than passed as a float the SDK truncates, so the sample rate
+     * the DDS works from is the one the carrier actually runs at.
      */
-    float clockDivider = (float)clock_get_hz(clk_sys) /
-        (PWM_CARRIER_FREQUENCY_HZ * ((float)PWM_WRAP_VALUE + 1.0f));
-    if (!isfinite(clockDivider) || clockDivider < 1.0f) clockDivider = 1.0f;
-    if (clockDivider > 255.0f) clockDivider = 255.0f;
+    uint32_t clockHz = clock_get_hz(clk_sys);
+    float divider16 = roundf((float)clockHz * 16.0f /
+        (PWM_CARRIER_FREQUENCY_HZ * ((float)PWM_WRAP_VALUE + 1.0f)));
+    if (!isfinite(divider16) || divider16 < 16.0f) divider16 = 16.0f;
+    if (divider16 > 4095.0f) divider16 = 4095.0f;
+    _clockHz = clockHz;
+    _clockDivider16 = (uint16_t)divider16;
     pwm_config_set_wrap(&config, PWM_WRAP_VALUE);
-    pwm_config_set_clkdiv(&config, clockDivider);
-    _sampleRateHz = ((float)clock_get_hz(clk_sys) / clockDivider) / ((float)PWM_WRAP_VALUE + 1.0f);
+    pwm_config_set_clkdiv_int_frac(&config, (uint8_t)(_clockDivider16 >> 4), (uint8_t)(_clockDivider16 & 0x0F));
+    _sampleRateHz = (float)exactSampleRateHz();
     if (!isfinite(_sampleRateHz) || _sampleRateHz <= 0.0f) {
         _sampleRateHz = FALLBACK_SAMPLE_RATE_HZ;
     }
+    configureBridgeModulation();
     
     // Configure both carrier slices while stopped, then align their counters before enabling them in one register write.
     pwm_init(_pwmSlice0, &config, false);
@@ -236,10 +315,12 @@ void __not_in_flash_func(WaveformGenerator::dmaInterruptHandler)() {
                 _waveformInstance->_dmaDesyncCount++;
                 _waveformInstance->_slice1RearmPending[0] = true;
             } else {
-                _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan2, _waveformInstance->_dmaBufferSlice1[0]);
+                _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan2, _waveformInstance->_dmaBufferSlice1[0], _waveformInstance->_bufferLength[0]);
                 _waveformInstance->_slice1RearmPending[0] = false;
             }
-            _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan0, _waveformInstance->_dmaBufferSlice0[0]);
+            _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan0, _waveformInstance->_dmaBufferSlice0[0], _waveformInstance->_bufferLength[0]);
+            _waveformInstance->loadCarrierWrap(1);
+            _waveformInstance->publishPhaseReference(1);
             
             // Signal that Buffer 0 is free to be refilled
             _waveformInstance->_currentBufferIndex = 0; 
@@ -257,10 +338,12 @@ void __not_in_flash_func(WaveformGenerator::dmaInterruptHandler)() {
                 _waveformInstance->_dmaDesyncCount++;
                 _waveformInstance->_slice1RearmPending[1] = true;
             } else {
-                _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan3, _waveformInstance->_dmaBufferSlice1[1]);
+                _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan3, _waveformInstance->_dmaBufferSlice1[1], _waveformInstance->_bufferLength[1]);
                 _waveformInstance->_slice1RearmPending[1] = false;
             }
-            _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan1, _waveformInstance->_dmaBufferSlice0[1]);
+            _waveformInstance->rearmDmaChannel(_waveformInstance->_dmaChan1, _waveformInstance->_dmaBufferSlice0[1], _waveformInstance->_bufferLength[1]);
+            _waveformInstance->loadCarrierWrap(0);
+            _waveformInstance->publishPhaseReference(0);
             
             // Signal that Buffer 1 is free to be refilled
             _waveformInstance->_currentBufferIndex = 1;
@@ -285,11 +368,11 @@ void __not_in_flash_func(WaveformGenerator::update)() {
     // any deferred slice-1 re-arm here rather than leaving the ping-pong chain
     // permanently exhausted after that harmless completion skew.
     if (_slice1RearmPending[0] && !chan2Busy) {
-        rearmDmaChannel(_dmaChan2, _dmaBufferSlice1[0]);
+        rearmDmaChannel(_dmaChan2, _dmaBufferSlice1[0], _bufferLength[0]);
         _slice1RearmPending[0] = false;
     }
     if (_slice1RearmPending[1] && !chan3Busy) {
-        rearmDmaChannel(_dmaChan3, _dmaBufferSlice1[1]);
+        rearmDmaChannel(_dmaChan3, _dmaBufferSlice1[1], _bufferLength[1]);
         _slice1RearmPending[1] = false;
     }
     
@@ -331,17 +414,42 @@ void __not_in_flash_func(WaveformGenerator::fillBuffer)(int bufferIndex) {
     _lastBufferFillMs = millis();
     _bufferFillCount++;
 
+    /*
+     * The block length is chosen per buffer. Both channels that play this
+     * buffer are idle and already re-armed here, so their transfer counts can
+     * change without touching the block DMA is playing. The accumulator runs
+     * on from the last sample either way, so a length change is seamless.
+     */
+    int length = _lowLatency ? DMA_BLOCK_SHORT_SAMPLES : DMA_BLOCK_LONG_SAMPLES;
+    if (length != _bufferLength[bufferIndex]) {
+        _bufferLength[bufferIndex] = (uint16_t)length;
+        dma_channel_set_trans_count(bufferIndex == 0 ? _dmaChan0 : _dmaChan1, length, false);
+        dma_channel_set_trans_count(bufferIndex == 0 ? _dmaChan2 : _dmaChan3, length, false);
+    }
+
+    // This buffer plays at the top chosen by the last fill; its last sample already plays at the next buffer's.
+    uint16_t wrap = _bufferWrap[bufferIndex];
+    uint16_t nextWrap = _dither.nextWrap();
+    _bufferWrap[bufferIndex ^ 1] = nextWrap;
+
     if (!enabledAtomic()) {
         // Bridge inputs idle at neutral common-mode duty; the hardware enable remains the real safety interlock. Linear builds retain the legacy zero-duty idle.
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
-        const uint32_t disabledSliceWord = (512u << 16) | 512u;
+        const uint32_t neutral = ((uint32_t)wrap + 1u) / 2u;
+        const uint32_t lastNeutral = ((uint32_t)nextWrap + 1u) / 2u;
+        const uint32_t disabledSliceWord = (neutral << 16) | neutral;
+        const uint32_t lastSliceWord = (lastNeutral << 16) | lastNeutral;
 #else
         const uint32_t disabledSliceWord = 0;
+        const uint32_t lastSliceWord = 0;
 #endif
-        for (int i = 0; i < DMA_BUFFER_SIZE; i++) {
-            _dmaBufferSlice0[bufferIndex][i] = disabledSliceWord;
-            _dmaBufferSlice1[bufferIndex][i] = disabledSliceWord;
+        for (int i = 0; i < length; i++) {
+            uint32_t word = i == length - 1 ? lastSliceWord : disabledSliceWord;
+            _dmaBufferSlice0[bufferIndex][i] = word;
+            _dmaBufferSlice1[bufferIndex][i] = word;
         }
+        _bufferStartPhase[bufferIndex] = _phaseAcc[0];
+        _bufferPhaseInc[bufferIndex] = 0;
         return;
     }
 
@@ -353,24 +461,87 @@ void __not_in_flash_func(WaveformGenerator::fillBuffer)(int bufferIndex) {
             _activeState = _pendingState;
             _pendingState = temp;
             *_pendingState = *((WaveformState*)_activeState);
+            // The remainder is a fraction of the old denominator; dropping it costs under one 2^-64 cycle.
+            _phaseRemainderAcc = 0;
+            _ditherRemainderAcc = 0;
             storeSwapPending(false);
         }
         unlockState();
     }
     
     const volatile WaveformState* state = _activeState;
-    updateAppliedTuning(state);
+    bool crossfading = state->filterBlend < 1.0f;
+    if (crossfading && !_crossfadeActive) {
+        // An incoming IIR's settling transient is small and enters at near-zero weight.
+        for (int ch = 0; ch < 4; ch++) _outputFilter[ch].beginCrossfade((uint8_t)state->fromFilterType, _lastSamples[ch]);
+    }
+    _crossfadeActive = crossfading;
+    updateAppliedTuning(state, length);
+    _bufferSupplyScale = _supplyScale;
+    updateSoftLimiter(state, length);
+    _bufferStartPhase[bufferIndex] = _phaseAcc[0];
+    _bufferPhaseInc[bufferIndex] = state->phaseInc;
+
+    uint32_t stepInc = state->phaseInc;
+    uint32_t stepFrac = state->phaseIncFrac;
+#if PWM_DITHER_ENABLE
+    /*
+     * A sample lasts wrap + 1 counts, so the phase step and the duty follow
+     * the top. Per microsecond the phase still advances at the nominal rate,
+     * so the phase reference keeps the nominal step and sample rate.
+     */
+    uint32_t lastInc;
+    uint32_t lastFrac;
+    {
+        uint64_t step = ((uint64_t)state->phaseInc << 32) | state->phaseIncFrac;
+        if (state->phaseReverse) step = (uint64_t)0 - step;
+        uint32_t remainder;
+        uint32_t lastRemainder;
+        uint64_t scaled = pwmDitherScaleStep(step, wrap, PWM_PERIOD_BITS, remainder);
+        uint64_t lastScaled = pwmDitherScaleStep(step, nextWrap, PWM_PERIOD_BITS, lastRemainder);
+        _ditherRemainderAcc += remainder * (uint32_t)(length - 1) + lastRemainder;
+        if (state->phaseReverse) {
+            scaled = (uint64_t)0 - scaled;
+            lastScaled = (uint64_t)0 - lastScaled;
+        }
+        stepInc = (uint32_t)(scaled >> 32);
+        stepFrac = (uint32_t)scaled;
+        lastInc = (uint32_t)(lastScaled >> 32);
+        lastFrac = (uint32_t)lastScaled;
+    }
+    uint32_t dutyScale = pwmDitherDutyScaleQ16(wrap, PWM_PERIOD_BITS);
+    int32_t top = wrap;
+#else
+    const int32_t top = wrap;
+#endif
+#if DC_OFFSET_NULL_ENABLE
+    int32_t dcNull[4];
+    for (int ch = 0; ch < 4; ch++) dcNull[ch] = _dcOffsetNull[ch];
+#endif
     
-    for (int i = 0; i < DMA_BUFFER_SIZE; i++) {
+    for (int i = 0; i < length; i++) {
+#if PWM_DITHER_ENABLE
+        if (i == length - 1) {
+            stepInc = lastInc;
+            stepFrac = lastFrac;
+            dutyScale = pwmDitherDutyScaleQ16(nextWrap, PWM_PERIOD_BITS);
+            top = nextWrap;
+        }
+#endif
         // Calculate samples for enabled phases; unused channels stay at the neutral sample before the 512 PWM offset is applied.
         int16_t samples[4];
+        int32_t deadTime[4] = {0, 0, 0, 0};
         for (int ch = 0; ch < 4; ch++) {
             samples[ch] = (ch < state->activePhaseOutputs) ? generateSample(ch) : 0;
             _lastSamples[ch] = samples[ch];
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+            // Unused legs sit at neutral and carry no predictable current, so only driven phases are compensated.
+            if (ch < state->activePhaseOutputs) deadTime[ch] = deadTimeCompensation(state, ch);
+#endif
         }
         
-        // Advance the master phase once per sample. Per-channel phase offsets are added inside generateSample().
-        _phaseAcc[0] += state->phaseInc;
+        // Advance the 32.32 master phase once per sample. Per-channel phase offsets are added inside generateSample().
+        ddsAdvance(_phaseAcc[0], _phaseFrac, stepInc, stepFrac);
         
         /*
          * Pack into 32-bit words for DMA
@@ -384,20 +555,91 @@ void __not_in_flash_func(WaveformGenerator::fillBuffer)(int bufferIndex) {
         int32_t valC = 512 + samples[2];
         int32_t valD = 512 + samples[3];
 
+        // Bridge leg placement moves peaks away from the rails, so there clipping is counted where placement has to reduce the drive.
+#if OUTPUT_STAGE_TYPE != OUTPUT_STAGE_3PWM_BRIDGE || BRIDGE_MODULATION_MODE == 0
         if (valA < 0 || valA > 1023) _clippingCount[0]++;
         if (valB < 0 || valB > 1023) _clippingCount[1]++;
         if (valC < 0 || valC > 1023) _clippingCount[2]++;
         if (valD < 0 || valD > 1023) _clippingCount[3]++;
+#endif
+
+#if DC_OFFSET_NULL_ENABLE
+        // Whole counts of the null go out now and the fraction waits, so the average duty carries the whole correction.
+        int32_t* vals[4] = {&valA, &valB, &valC, &valD};
+        for (int ch = 0; ch < 4; ch++) {
+            _dcNullResidue[ch] += dcNull[ch];
+            int32_t whole = _dcNullResidue[ch] >> 8;
+            _dcNullResidue[ch] -= whole * 256;
+            *vals[ch] += whole;
+        }
+#endif
+
+#if PWM_DITHER_ENABLE
+        // Same duty fraction of this sample's period. Dead time is a fixed number of counts, so it is added unscaled.
+        valA = pwmDitherScaleDuty(valA, dutyScale);
+        valB = pwmDitherScaleDuty(valB, dutyScale);
+        valC = pwmDitherScaleDuty(valC, dutyScale);
+        valD = pwmDitherScaleDuty(valD, dutyScale);
+#endif
+
+        // Dead-time correction is added after the clip check: using it at full modulation is expected, not a tune problem.
+        valA += deadTime[0];
+        valB += deadTime[1];
+        valC += deadTime[2];
+        valD += deadTime[3];
+
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+        // Driven legs are placed together so their differences, the winding voltages, survive the duty limits.
+        {
+            int32_t legs[4] = {valA, valB, valC, valD};
+            uint8_t driven = state->activePhaseOutputs < 4 ? state->activePhaseOutputs : 4;
+            uint8_t clipped = bridgeModulate(legs, driven, top, _bridgeModulation);
+            if (clipped) {
+                _bridgeLimitCount++;
+#if BRIDGE_MODULATION_MODE != 0
+                for (int ch = 0; ch < driven; ch++) {
+                    if (clipped & (1u << ch)) _clippingCount[ch]++;
+                }
+#endif
+            }
+            valA = legs[0];
+            valB = legs[1];
+            valC = legs[2];
+            valD = legs[3];
+        }
+#endif
         
-        // Clamp to the 10-bit PWM range after offsetting the signed samples.
-        if (valA < 0) valA = 0; else if (valA > 1023) valA = 1023;
-        if (valB < 0) valB = 0; else if (valB > 1023) valB = 1023;
-        if (valC < 0) valC = 0; else if (valC > 1023) valC = 1023;
-        if (valD < 0) valD = 0; else if (valD > 1023) valD = 1023;
+        // Clamp to the PWM range after offsetting the signed samples.
+        if (valA < 0) valA = 0; else if (valA > top) valA = top;
+        if (valB < 0) valB = 0; else if (valB > top) valB = top;
+        if (valC < 0) valC = 0; else if (valC > top) valC = top;
+        if (valD < 0) valD = 0; else if (valD > top) valD = top;
         
         _dmaBufferSlice0[bufferIndex][i] = ((uint32_t)valB << 16) | (uint32_t)valA;
         _dmaBufferSlice1[bufferIndex][i] = ((uint32_t)valD << 16) | (uint32_t)valC;
     }
+
+    // Rational synthesis: add this buffer's share of the increment remainder, one block unit at a time.
+    uint32_t carry = ddsBlockCarry(state->unitPhaseCarry, state->unitPhaseRemainder, state->phaseDenominator,
+                                   length / DMA_BLOCK_UNIT, _phaseRemainderAcc);
+    if (state->phaseDenominator != 0) {
+#if PWM_DITHER_ENABLE
+        // The carry is under 16 LSBs per unit of nominal time, so it follows the buffer's real length in 32 bits, rounded to under one LSB per buffer.
+        uint32_t blockCounts = (uint32_t)(length - 1) * ((uint32_t)wrap + 1u) + (uint32_t)nextWrap + 1u;
+        uint32_t nominalCounts = (uint32_t)length << PWM_PERIOD_BITS;
+        carry = (carry * blockCounts + nominalCounts / 2u) / nominalCounts;
+#endif
+    }
+#if PWM_DITHER_ENABLE
+    carry += _ditherRemainderAcc >> PWM_PERIOD_BITS;
+    _ditherRemainderAcc &= (1u << PWM_PERIOD_BITS) - 1u;
+#endif
+    if (carry != 0) {
+        uint64_t phase = ((uint64_t)_phaseAcc[0] << 32) | _phaseFrac;
+        phase += state->phaseReverse ? (uint64_t)0 - carry : (uint64_t)carry;
+        _phaseAcc[0] = (uint32_t)(phase >> 32);
+        _phaseFrac = (uint32_t)phase;
+    }
 }
 
 void WaveformGenerator::generateLUT() {
@@ -418,10 +660,12 @@ void WaveformGenerator::unlockState() {
 
 void WaveformGenerator::configure(const SpeedSettings& s) {
     // Configure phase and filtering without changing the current frequency.
+    const FirKernel& kernel = designFirKernel(settings.get().currentSpeed, s.firProfile);
     lockState();
     _pendingState->filterType = (FilterType)s.filterType;
     _pendingState->iirAlpha = isfinite(s.iirAlpha) ? s.iirAlpha : 0.5f;
-    _pendingState->firProfile = (FirProfile)s.firProfile;
+    _pendingState->firKernel = kernel;
+    _pendingState->filterBlend = 1.0f;
     
     for(int i=0; i<4; i++) {
         _pendingState->phaseOffsets[i] = phaseOffsetToAccumulator(s.phaseOffset[i]);
@@ -429,6 +673,46 @@ void WaveformGenerator::configure(const SpeedSettings& s) {
     }
     _pendingState->phaseSlewDegreesPerSecond = settings.get().phaseSlewDegreesPerSecond;
     _pendingState->gainSlewPercentPerSecond = settings.get().gainSlewPercentPerSecond;
+    loadDeadTimeCompensation(_pendingState);
+    loadPeakLimit(_pendingState);
+    storeSwapPending(true);
+    unlockState();
+}
+
+void WaveformGenerator::crossfadeTune(uint8_t fromSpeed, uint8_t toSpeed, float progress) {
+    if (fromSpeed > SPEED_78) fromSpeed = SPEED_33;
+    if (toSpeed > SPEED_78) toSpeed = SPEED_33;
+    if (!(progress > 0.0f)) progress = 0.0f;
+    if (progress > 1.0f) progress = 1.0f;
+    GlobalSettings& g = settings.get();
+    const SpeedSettings& from = g.speeds[fromSpeed];
+    const SpeedSettings& to = g.speeds[toSpeed];
+    const FirKernel& fromKernel = designFirKernel(fromSpeed, from.firProfile);
+    const FirKernel& toKernel = designFirKernel(toSpeed, to.firProfile);
+
+    lockState();
+    _pendingState->filterType = (FilterType)to.filterType;
+    _pendingState->iirAlpha = isfinite(to.iirAlpha) ? to.iirAlpha : 0.5f;
+    _pendingState->firKernel = toKernel;
+    _pendingState->fromFilterType = (FilterType)from.filterType;
+    _pendingState->fromIirAlpha = isfinite(from.iirAlpha) ? from.iirAlpha : 0.5f;
+    _pendingState->fromFirKernel = fromKernel;
+    bool sameFilter = from.filterType == to.filterType &&
+        (to.filterType != FILTER_IIR || _pendingState->fromIirAlpha == _pendingState->iirAlpha) &&
+        (to.filterType != FILTER_FIR || sameFirKernel(fromKernel, toKernel));
+    _pendingState->filterBlend = sameFilter ? 1.0f : progress;
+
+    for (int i = 0; i < 4; i++) {
+        _pendingState->phaseOffsets[i] = crossfadePhaseOffset(phaseOffsetToAccumulator(from.phaseOffset[i]),
+            phaseOffsetToAccumulator(to.phaseOffset[i]), progress);
+        _pendingState->channelGain[i] = crossfadeLevel((float)from.channelAmplitude[i], (float)to.channelAmplitude[i], progress) / 100.0f;
+    }
+    loadDeadTimeCompensation(_pendingState);
+    loadPeakLimit(_pendingState);
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    _pendingState->deadTimeLagAcc = crossfadePhaseOffset(phaseOffsetToAccumulator(g.bridgeDeadTimeLagDeg[fromSpeed]),
+        phaseOffsetToAccumulator(g.bridgeDeadTimeLagDeg[toSpeed]), progress);
+#endif
     storeSwapPending(true);
     unlockState();
 }
@@ -446,7 +730,7 @@ void WaveformGenerator::setFrequency(float freq) {
     if (freq < -MAX_OUTPUT_FREQUENCY_HZ) freq = -MAX_OUTPUT_FREQUENCY_HZ;
     lockState();
     _pendingState->frequency = freq;
-    _pendingState->phaseInc = frequencyToPhaseIncrement(freq);
+    loadPhaseIncrement(_pendingState, freq);
     storeSwapPending(true);
     unlockState();
 }
@@ -467,13 +751,15 @@ void WaveformGenerator::updateSettings(float freq, const SpeedSettings& s, uint8
     if (!isfinite(freq)) freq = 0.0f;
     if (freq > MAX_OUTPUT_FREQUENCY_HZ) freq = MAX_OUTPUT_FREQUENCY_HZ;
     if (freq < -MAX_OUTPUT_FREQUENCY_HZ) freq = -MAX_OUTPUT_FREQUENCY_HZ;
+    const FirKernel& kernel = designFirKernel(settings.get().currentSpeed, s.firProfile);
     lockState();
     _pendingState->frequency = freq;
-    _pendingState->phaseInc = frequencyToPhaseIncrement(freq);
+    loadPhaseIncrement(_pendingState, freq);
     
     _pendingState->filterType = (FilterType)s.filterType;
     _pendingState->iirAlpha = isfinite(s.iirAlpha) ? s.iirAlpha : 0.5f;
-    _pendingState->firProfile = (FirProfile)s.firProfile;
+    _pendingState->firKernel = kernel;
+    _pendingState->filterBlend = 1.0f;
     if (phaseMode < PHASE_1 || phaseMode > MAX_ACTIVE_PHASE_OUTPUTS) phaseMode = DEFAULT_PHASE_MODE;
     _pendingState->activePhaseOutputs = phaseMode;
     
@@ -483,11 +769,67 @@ void WaveformGenerator::updateSettings(float freq, const SpeedSettings& s, uint8
     }
     _pendingState->phaseSlewDegreesPerSecond = settings.get().phaseSlewDegreesPerSecond;
     _pendingState->gainSlewPercentPerSecond = settings.get().gainSlewPercentPerSecond;
+    loadDeadTimeCompensation(_pendingState);
+    loadPeakLimit(_pendingState);
     
     storeSwapPending(true);
     unlockState();
 }
 
+const FirKernel& WaveformGenerator::designFirKernel(uint8_t speed, uint8_t profile) {
+    if (speed > SPEED_78) speed = SPEED_33;
+    FirDesignParams inputs;
+    if (profile < FIR_CUSTOM) {
+        inputs = FIR_PROFILE_DESIGNS[profile];
+    } else {
+        const GlobalSettings& g = settings.get();
+        inputs.cutoffHz = g.firCutoffHz[speed];
+        inputs.transitionHz = g.firTransitionHz[speed];
+        inputs.tapBudget = g.firTaps[speed];
+        inputs.stopbandDb = FIR_DESIGN_STOPBAND_DB;
+    }
+    // Speed changes and ramps ask for kernels every control tick; the design itself only reruns after an edit.
+    if (_firDesign[speed].taps == 0 || _firDesignRateHz[speed] != _sampleRateHz ||
+        !sameFirDesignInputs(_firDesignInputs[speed], inputs)) {
+        designLowPassFir(inputs, _sampleRateHz, _firDesign[speed]);
+        _firDesignInputs[speed] = inputs;
+        _firDesignRateHz[speed] = _sampleRateHz;
+    }
+    return _firDesign[speed];
+}
+
+const FirKernel& WaveformGenerator::getFirKernel(uint8_t speed) {
+    if (speed > SPEED_78) speed = SPEED_33;
+    return designFirKernel(speed, settings.get().speeds[speed].firProfile);
+}
+
+void WaveformGenerator::setSupplyScale(float scale) {
+    if (!isfinite(scale) || scale <= 0.0f) scale = 1.0f;
+    _supplyScale = scale;
+}
+
+float WaveformGenerator::getSupplyScale() const {
+    return _supplyScale;
+}
+
+void WaveformGenerator::setLowLatency(bool lowLatency) {
+    _lowLatency = lowLatency;
+}
+
+void WaveformGenerator::setDcOffsetNull(int channel, int16_t steps) {
+    if (channel < 0 || channel >= 4) return;
+    _dcOffsetNull[channel] = steps;
+}
+
+int16_t WaveformGenerator::getDcOffsetNull(int channel) const {
+    if (channel < 0 || channel >= 4) return 0;
+    return _dcOffsetNull[channel];
+}
+
+uint16_t WaveformGenerator::getBlockLength() const {
+    return _bufferLength[_currentBufferIndex ^ 1];
+}
+
 void WaveformGenerator::setEnabled(bool e) {
     storeEnabled(e);
     if (!e) {
@@ -520,6 +862,101 @@ uint32_t WaveformGenerator::getDmaDesyncCount() const {
     return _dmaDesyncCount;
 }
 
+uint16_t WaveformGenerator::getCarrierWrap() const {
+    return _bufferWrap[_currentBufferIndex];
+}
+
+uint32_t WaveformGenerator::getCarrierDitherLateCount() const {
+    return _ditherLateCount;
+}
+
+void __not_in_flash_func(WaveformGenerator::loadCarrierWrap)(int playingBuffer) {
+    /*
+     * Called in the IRQ that ends the other buffer: its last sample latched at
+     * the wrap still to come, and this top latches with it. If the playing
+     * channel has already moved, that wrap has passed and the top is one
+     * sample late.
+     */
+    uint16_t wrap = _bufferWrap[playingBuffer];
+    if (pwm_hw->slice[_pwmSlice0].top == wrap) return;
+    pwm_set_wrap(_pwmSlice0, wrap);
+    pwm_set_wrap(_pwmSlice1, wrap);
+    int playingChannel = playingBuffer == 0 ? _dmaChan0 : _dmaChan1;
+    if (dma_channel_hw_addr(playingChannel)->transfer_count != _bufferLength[playingBuffer]) _ditherLateCount++;
+}
+
+void __not_in_flash_func(WaveformGenerator::publishPhaseReference)(int playingBuffer) {
+    _phaseRefSequence = _phaseRefSequence + 1;
+    __dmb();
+    _phaseRefAcc = _bufferStartPhase[playingBuffer];
+    _phaseRefInc = _bufferPhaseInc[playingBuffer];
+    _phaseRefUs = time_us_32();
+    __dmb();
+    _phaseRefSequence = _phaseRefSequence + 1;
+}
+
+uint32_t WaveformGenerator::getDrivePhase(uint32_t nowUs) const {
+    uint32_t acc = 0;
+    uint32_t inc = 0;
+    uint32_t refUs = nowUs;
+    // The writer runs in the Core 1 DMA IRQ and never waits on Core 0, so a few retries always find a stable copy.
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint32_t sequence = _phaseRefSequence;
+        __dmb();
+        acc = _phaseRefAcc;
+        inc = _phaseRefInc;
+        refUs = _phaseRefUs;
+        __dmb();
+        if ((sequence & 1u) == 0 && sequence == _phaseRefSequence) break;
+    }
+    // Whole samples advance the accumulator exactly; only the sub-sample remainder is rounded.
+    float samples = (float)(nowUs - refUs) * _sampleRateHz * 1e-6f;
+    uint32_t wholeSamples = (uint32_t)samples;
+    return acc + (inc * wholeSamples) + (uint32_t)((float)inc * (samples - (float)wholeSamples));
+}
+
+void WaveformGenerator::loadDeadTimeCompensation(WaveformState* target) {
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    // The correction itself is described in dead_time.h. Called with the state lock held.
+    GlobalSettings& g = settings.get();
+    uint8_t speedIndex = g.currentSpeed < 3 ? g.currentSpeed : 0;
+    float counts = deadTimeCounts((float)g.bridgeDeadTimeNs, _sampleRateHz, PWM_WRAP_VALUE);
+    target->deadTimeScaleQ16 = deadTimeScaleQ16(counts, _deadTimeSoftLut);
+    target->deadTimeLagAcc = phaseOffsetToAccumulator(g.bridgeDeadTimeLagDeg[speedIndex]);
+    _deadTimeCounts = counts;
+#else
+    target->deadTimeScaleQ16 = 0;
+    target->deadTimeLagAcc = 0;
+#endif
+}
+
+int32_t __not_in_flash_func(WaveformGenerator::deadTimeCompensation)(const volatile WaveformState* state, int channel) const {
+    // With no drive there is no current to correct, and the zero-amplitude neutral hold must stay exact.
+    if (state->deadTimeScaleQ16 == 0 || !(state->amplitude > 0.0f) || !(_appliedChannelGain[channel] > 0.0f)) return 0;
+    // Current lags the drive in time, so it trails in phase when running backwards as well.
+    uint32_t phase = _phaseAcc[0] + _appliedPhaseOffsets[channel];
+    uint32_t currentPhase = state->frequency >= 0.0f ? phase - state->deadTimeLagAcc : phase + state->deadTimeLagAcc;
+    // Near the current zero its sign is uncertain, so the correction ramps through zero instead of stepping.
+    return deadTimeCorrection(_lut[currentPhase >> _lutShift], _deadTimeSoftLut, state->deadTimeScaleQ16);
+}
+
+void WaveformGenerator::configureBridgeModulation() {
+    // Counts are taken at the nominal top; a dithered top changes the period, not the count rate.
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    _bridgeModulation.mode = BRIDGE_MODULATION_MODE;
+    _bridgeModulation.minOnCounts = bridgeModulationCounts(BRIDGE_MIN_ON_NS, _sampleRateHz, PWM_WRAP_VALUE);
+    _bridgeModulation.minOffCounts = bridgeModulationCounts(BRIDGE_MIN_OFF_NS, _sampleRateHz, PWM_WRAP_VALUE);
+#else
+    _bridgeModulation.mode = BRIDGE_MODULATION_SINE;
+    _bridgeModulation.minOnCounts = 0;
+    _bridgeModulation.minOffCounts = 0;
+#endif
+}
+
+float WaveformGenerator::getDeadTimeCompensationCounts() const {
+    return _deadTimeCounts;
+}
+
 float WaveformGenerator::getSampleRateHz() const {
     return _sampleRateHz;
 }
@@ -537,11 +974,49 @@ uint32_t WaveformGenerator::getClippingCount(int channel) const {
 float WaveformGenerator::getModulationHeadroomPercent(int channel) {
     if (channel < 0 || channel >= 4) return 0.0f;
     lockState();
-    float headroom = 100.0f - (_pendingState->amplitude * _pendingState->channelGain[channel] * 100.0f);
+    float headroom = (_pendingState->peakLimit - (_pendingState->amplitude * _supplyScale * _pendingState->channelGain[channel])) * 100.0f;
     unlockState();
     return headroom;
 }
 
+float WaveformGenerator::getLimiterReductionPercent(int channel) const {
+    return channel >= 0 && channel < 4 ? (1.0f - _limiterGain[channel]) * 100.0f : 0.0f;
+}
+
+void WaveformGenerator::updateSoftLimiter(const volatile WaveformState* state, int length) {
+    /*
+     * The drive is a sine whose peak for the coming buffer is known before a
+     * sample is generated: amplitude, latched supply scale and slewed channel
+     * gain. That is the limiter's look-ahead; see soft_limiter.h. The ceiling
+     * is a share of what the output stage can place, so a bridge with
+     * centred placement keeps its line-to-line headroom.
+     */
+    float release = (float)length / (_sampleRateHz * (SOFT_LIMITER_RELEASE_MS / 1000.0f));
+    float ceiling = SOFT_LIMITER_CEILING * state->peakLimit;
+    for (int channel = 0; channel < 4; channel++) {
+        float requested = state->amplitude * _bufferSupplyScale * _appliedChannelGain[channel];
+#if SOFT_LIMITER_ENABLE
+        float gain = softLimiterGain(_limiterGain[channel], requested, ceiling, release);
+#else
+        float gain = 1.0f;
+#endif
+        _limiterGain[channel] = gain;
+        _bufferChannelScale[channel] = requested * gain;
+    }
+}
+
+void WaveformGenerator::loadPeakLimit(WaveformState* target) const {
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    // Taken from the target offsets; while they slew the placement still scales any excess evenly.
+    float phases[4];
+    uint8_t legs = target->activePhaseOutputs < 4 ? target->activePhaseOutputs : 4;
+    for (int i = 0; i < legs; i++) phases[i] = (float)(((double)target->phaseOffsets[i] * 360.0) / DDS_ACCUMULATOR_SCALE);
+    target->peakLimit = bridgeModulationPeakLimit(_bridgeModulation, PWM_WRAP_VALUE, phases, legs);
+#else
+    target->peakLimit = 1.0f;
+#endif
+}
+
 float WaveformGenerator::getAppliedPhaseDegrees(int channel) const {
     if (channel < 0 || channel >= 4) return 0.0f;
     return ((double)_appliedPhaseOffsets[channel] * 360.0) / DDS_ACCUMULATOR_SCALE;
@@ -551,11 +1026,11 @@ float WaveformGenerator::getAppliedChannelGainPercent(int channel) const {
     return channel >= 0 && channel < 4 ? _appliedChannelGain[channel] * 100.0f : 0.0f;
 }
 
-void WaveformGenerator::updateAppliedTuning(const volatile WaveformState* state) {
+void WaveformGenerator::updateAppliedTuning(const volatile WaveformState* state, int length) {
     if (!_appliedTuningInitialized || state->phaseSlewDegreesPerSecond <= 0.0f) {
         for (int channel = 0; channel < 4; channel++) _appliedPhaseOffsets[channel] = state->phaseOffsets[channel];
     } else {
-        double maxStepD = state->phaseSlewDegreesPerSecond * ((double)DMA_BUFFER_SIZE / _sampleRateHz) *
+        double maxStepD = state->phaseSlewDegreesPerSecond * ((double)length / _sampleRateHz) *
             (DDS_ACCUMULATOR_SCALE / 360.0);
         int32_t maxStep = (int32_t)fmax(1.0, fmin(maxStepD, 2147483647.0));
         for (int channel = 0; channel < 4; channel++) {
@@ -569,7 +1044,7 @@ void WaveformGenerator::updateAppliedTuning(const volatile WaveformState* state)
     if (!_appliedTuningInitialized || state->gainSlewPercentPerSecond <= 0.0f) {
         for (int channel = 0; channel < 4; channel++) _appliedChannelGain[channel] = state->channelGain[channel];
     } else {
-        float maxGainStep = (state->gainSlewPercentPerSecond / 100.0f) * ((float)DMA_BUFFER_SIZE / _sampleRateHz);
+        float maxGainStep = (state->gainSlewPercentPerSecond / 100.0f) * ((float)length / _sampleRateHz);
         for (int channel = 0; channel < 4; channel++) {
             float delta = state->channelGain[channel] - _appliedChannelGain[channel];
             if (delta > maxGainStep) delta = maxGainStep;
@@ -580,16 +1055,63 @@ void WaveformGenerator::updateAppliedTuning(const volatile WaveformState* state)
     _appliedTuningInitialized = true;
 }
 
-uint32_t WaveformGenerator::frequencyToPhaseIncrement(float freq) const {
+double WaveformGenerator::exactSampleRateHz() const {
+    double rate = ddsSampleRateHz(ddsClock());
+    return rate > 0.0 ? rate : FALLBACK_SAMPLE_RATE_HZ;
+}
+
+DdsClock WaveformGenerator::ddsClock() const {
+    DdsClock clock;
+    clock.clockHz = _clockHz;
+    clock.divider16 = _clockDivider16;
+    clock.periodCounts = (uint32_t)PWM_WRAP_VALUE + 1u;
+    return clock;
+}
+
+void WaveformGenerator::loadPhaseIncrement(WaveformState* target, float freq) const {
     if (!isfinite(freq)) freq = 0.0f;
-    float sampleRate = _sampleRateHz;
-    if (!isfinite(sampleRate) || sampleRate <= 0.0f) sampleRate = FALLBACK_SAMPLE_RATE_HZ;
+    target->phaseDenominator = 0;
+    target->unitPhaseRemainder = 0;
+    target->unitPhaseCarry = 0;
+    target->phaseReverse = freq < 0.0f;
+    target->rationalNumerator = 0;
+    target->rationalDenominator = 0;
+    if (loadRationalPhaseIncrement(target, freq)) return;
 
-    double incD = (double)freq * (DDS_ACCUMULATOR_SCALE / (double)sampleRate);
-    if (!isfinite(incD)) return 0;
+    uint64_t inc = ddsRoundedIncrement(freq, exactSampleRateHz());
+    target->phaseInc = (uint32_t)(inc >> 32);
+    target->phaseIncFrac = (uint32_t)inc;
+}
 
-    int64_t inc = llround(incD);
-    return (uint32_t)inc;
+bool WaveformGenerator::loadRationalPhaseIncrement(WaveformState* target, float freq) const {
+#if DDS_RATIONAL_SYNTHESIS_ENABLE
+    // The remainder is carried per block unit, so only compares and subtracts run in the IRQ. See dds_increment.h.
+    uint64_t numerator;
+    uint64_t denominator;
+    DdsRationalIncrement exact;
+    if (!ddsRationalFrequency(freq, DDS_RATIONAL_MAX_DENOMINATOR, numerator, denominator)) return false;
+    if (!ddsRationalIncrement(numerator, denominator, target->phaseReverse, ddsClock(), DMA_BLOCK_UNIT, exact)) return false;
+    target->phaseInc = (uint32_t)(exact.increment >> 32);
+    target->phaseIncFrac = (uint32_t)exact.increment;
+    target->phaseDenominator = exact.denominator;
+    target->unitPhaseCarry = exact.unitCarry;
+    target->unitPhaseRemainder = exact.unitRemainder;
+    target->rationalNumerator = (uint32_t)numerator;
+    target->rationalDenominator = (uint16_t)denominator;
+    return true;
+#else
+    (void)target;
+    (void)freq;
+    return false;
+#endif
+}
+
+bool WaveformGenerator::getRationalFrequency(uint32_t& numerator, uint16_t& denominator) {
+    lockState();
+    numerator = _pendingState->rationalNumerator;
+    denominator = _pendingState->rationalDenominator;
+    unlockState();
+    return denominator != 0;
 }
 
 uint32_t WaveformGenerator::phaseOffsetToAccumulator(float degrees) const {
@@ -601,8 +1123,8 @@ uint32_t WaveformGenerator::phaseOffsetToAccumulator(float degrees) const {
     return (uint32_t)scaled;
 }
 
-void __not_in_flash_func(WaveformGenerator::rearmDmaChannel)(int channel, const uint32_t* readAddr) {
-    dma_channel_set_trans_count(channel, DMA_BUFFER_SIZE, false);
+void __not_in_flash_func(WaveformGenerator::rearmDmaChannel)(int channel, const uint32_t* readAddr, uint16_t length) {
+    dma_channel_set_trans_count(channel, length, false);
     dma_channel_set_read_addr(channel, readAddr, false);
     _dmaRearmCount++;
 }
@@ -638,33 +1160,9 @@ int16_t __not_in_flash_func(WaveformGenerator::generateSample)(int channel) {
     int16_t s2 = _lut[nextIndex];
     
     int32_t val = s1 + (((s2 - s1) * (int32_t)frac) >> 10);
-    val = (int32_t)(val * state->amplitude * _appliedChannelGain[channel]);
-    
-    if (state->filterType == FILTER_IIR) {
-        // Lightweight one-pole smoothing for users who need gentler edges.
-        float alpha = state->iirAlpha;
-        float out = alpha * val + (1.0 - alpha) * _iirPrev[channel];
-        _iirPrev[channel] = out;
-        val = (int16_t)out;
-    }
-    else if (state->filterType == FILTER_FIR) {
-        // The FIR history is per channel so phase outputs do not bleed together.
-        for (int i = 7; i > 0; i--) {
-            _firBuffer[channel][i] = _firBuffer[channel][i-1];
-        }
-        _firBuffer[channel][0] = val;
-        
-        float sum = 0;
-        const float* coeffs;
-        if (state->firProfile == FIR_GENTLE) coeffs = FIR_COEFFS_GENTLE;
-        else if (state->firProfile == FIR_MEDIUM) coeffs = FIR_COEFFS_MEDIUM;
-        else coeffs = FIR_COEFFS_AGGRESSIVE;
-        
-        for (int i = 0; i < 8; i++) {
-            sum += _firBuffer[channel][i] * coeffs[i];
-        }
-        val = (int16_t)sum;
-    }
-    
-    return (int16_t)val;
+    val = (int32_t)(val * _bufferChannelScale[channel]);
+
+    return (int16_t)_outputFilter[channel].process((float)val, (uint8_t)state->filterType, state->iirAlpha,
+        const_cast<const FirKernel&>(state->firKernel), (uint8_t)state->fromFilterType, state->fromIirAlpha,
+        const_cast<const FirKernel&>(state->fromFirKernel), state->filterBlend);
 }
@@ -13,6 +13,13 @@
 #include "config.h"
 #include "types.h"
 #include "globals.h"
+#include "fir_design.h"
+#include "pwm_dither.h"
+#include "bridge_modulation.h"
+#include "dead_time.h"
+#include "dds_increment.h"
+#include "soft_limiter.h"
+#include "output_filter.h"
 
 extern "C" {
     #include "pico/stdlib.h"
@@ -21,6 +28,7 @@ extern "C" {
     #include "hardware/pwm.h"
     #include "hardware/irq.h"
     #include "pico/critical_section.h"
+    #include "hardware/sync.h"
 }
 
 /**
@@ -31,7 +39,7 @@ extern "C" {
  * Supports:
  * - Variable frequency and amplitude
  * - Phase offsets
- * - Digital filtering (IIR/FIR)
+ * - Digital filtering (IIR, or linear-phase FIR designed on the device)
  * - PWM output generation
  */
 class WaveformGenerator {
@@ -54,8 +62,28 @@ public:
     void setAmplitude(float amp); // 0.0 to 1.0
     
     void updateSettings(float freq, const SpeedSettings& s, uint8_t phaseMode);
+    /*
+     * Blend the per-speed tune from one speed to another while a speed change
+     * ramps the frequency. Phase offsets, channel gains and dead-time lag are
+     * interpolated, and the two speeds' filters run side by side with their
+     * outputs mixed, so nothing steps mid-ramp. progress runs 0 to 1 with the
+     * ramp; updateSettings() ends the blend.
+     */
+    void crossfadeTune(uint8_t fromSpeed, uint8_t toSpeed, float progress);
     
     void setEnabled(bool enabled);
+
+    // Supply feed-forward multiplier, nominal bus over measured. Core 1 latches it once per buffer.
+    void setSupplyScale(float scale);
+    float getSupplyScale() const;
+
+    // Linear-amplifier DC offset null for one channel, in 1/256 duty-count steps. Core 1 latches it once per buffer.
+    void setDcOffsetNull(int channel, int16_t steps);
+    int16_t getDcOffsetNull(int channel) const;
+
+    // Short DMA blocks while the drive is changing so updates reach the output sooner; long blocks otherwise.
+    void setLowLatency(bool lowLatency);
+    uint16_t getBlockLength() const;
     
     // --- Configuration ---
     void configure(const SpeedSettings& settings);
@@ -71,17 +99,46 @@ public:
     uint32_t getDmaRearmCount() const;
     uint32_t getDmaDesyncCount() const;
     float getSampleRateHz() const;
+    // Spread-spectrum carrier: the counter top the last filled block plays at, and blocks whose top latched a sample late.
+    uint16_t getCarrierWrap() const;
+    uint32_t getCarrierDitherLateCount() const;
+    // True when the pending frequency is synthesised exactly as numerator/denominator Hz.
+    bool getRationalFrequency(uint32_t& numerator, uint16_t& denominator);
     bool isDmaRunning() const;
     uint32_t getClippingCount(int channel) const;
     float getModulationHeadroomPercent(int channel);
+    // How far the soft limiter is holding this channel below its requested level, 0 when it is idle.
+    float getLimiterReductionPercent(int channel) const;
     float getAppliedPhaseDegrees(int channel) const;
     float getAppliedChannelGainPercent(int channel) const;
+    float getDeadTimeCompensationCounts() const;
+    // Bridge duty limits in PWM counts, and samples whose line-to-line voltage they reduced.
+    const BridgeModulationParams& getBridgeModulation() const { return _bridgeModulation; }
+    uint32_t getBridgeLimitCount() const { return _bridgeLimitCount; }
+    // Kernel the FIR filter uses for a speed, designed from that speed's profile at the current sample rate. Core 0 only.
+    const FirKernel& getFirKernel(uint8_t speed);
+
+    // Master DDS phase extrapolated to nowUs from the buffer DMA is playing. Safe to call from Core 0 and its ISRs.
+    uint32_t getDrivePhase(uint32_t nowUs) const;
 
 private:
     // Double-buffered configuration state. Frequency, phase, amplitude, and filters are copied as a unit so Core 1 never sees a partially changed tune.
     struct WaveformState {
         float frequency;
-        uint32_t phaseInc;
+        uint32_t phaseInc;        // Whole accumulator units per sample
+        uint32_t phaseIncFrac;    // Fraction of a unit per sample; with phaseInc this is a 32.32 increment
+        /*
+         * Rational synthesis only, otherwise phaseDenominator is 0. The exact
+         * increment also has a remainder below the fraction LSB; per block unit
+         * it comes to unitPhaseCarry LSBs plus unitPhaseRemainder over
+         * phaseDenominator, which Core 1 accumulates.
+         */
+        uint64_t phaseDenominator;
+        uint64_t unitPhaseRemainder;
+        uint32_t unitPhaseCarry;
+        bool phaseReverse;
+        uint32_t rationalNumerator; // Frequency as numerator over rationalDenominator Hz, for diagnostics
+        uint16_t rationalDenominator;
         uint32_t phaseOffsets[4];
         float channelGain[4];
         float phaseSlewDegreesPerSecond;
@@ -89,8 +146,16 @@ private:
         float amplitude; // 0.0 - 1.0
         FilterType filterType;
         float iirAlpha;
-        FirProfile firProfile;
+        FirKernel firKernel;
+        // Filter of the speed being left during a crossfade, mixed in by 1 - filterBlend.
+        FilterType fromFilterType;
+        float fromIirAlpha;
+        FirKernel fromFirKernel;
+        float filterBlend; // 1.0 outside a crossfade
         uint8_t activePhaseOutputs;
+        float peakLimit;          // Largest channel peak the output stage places without clipping, 1.0 = full-scale sine
+        int32_t deadTimeScaleQ16; // Dead-time counts per LUT unit inside the soft zone, Q16; 0 disables compensation
+        uint32_t deadTimeLagAcc;  // Phase current lag behind the drive, in accumulator units
     };
     
     WaveformState _stateA;
@@ -110,12 +175,16 @@ private:
     
     // Internal sample history maintained only by Core 1. The master accumulator is channel 0; other channels derive phase by adding offsets.
     uint32_t _phaseAcc[4];
-    float _iirPrev[4];
-    float _firBuffer[4][8]; // [Channel][Tap]
-    uint8_t _firIndex;
+    uint32_t _phaseFrac;            // Low word of the 32.32 master accumulator
+    uint64_t _phaseRemainderAcc;    // Rational remainder carried between buffers, over phaseDenominator
+    OutputFilter _outputFilter[4];
+    bool _crossfadeActive;
     volatile int16_t _lastSamples[4];
     uint32_t _appliedPhaseOffsets[4];
     float _appliedChannelGain[4];
+    float _bufferSupplyScale;
+    float _bufferChannelScale[4];   // Amplitude, supply, channel gain and limiter combined for this buffer
+    volatile float _limiterGain[4]; // Soft-limiter gain per channel, 1.0 when idle
     bool _appliedTuningInitialized;
     volatile uint32_t _clippingCount[4];
     
@@ -123,9 +192,17 @@ private:
     int _lutSize;
     int _lutShift;
     float _sampleRateHz;
+    uint32_t _clockHz;          // System clock the PWM divider was derived from
+    uint16_t _clockDivider16;   // PWM divider in 8.4 fixed point, as programmed
+
+    // Core 0 design cache per speed, redesigned only when its inputs or the sample rate change.
+    FirKernel _firDesign[3];
+    FirDesignParams _firDesignInputs[3];
+    float _firDesignRateHz[3];
     
     // DMA / PWM State
-    static const int DMA_BUFFER_SIZE = 256; // Number of samples per buffer
+    static const int DMA_BUFFER_SIZE = DMA_BLOCK_LONG_SAMPLES; // Allocated samples per buffer; the played block may be shorter
+    static const int DMA_BLOCK_UNIT = 16; // Block lengths are whole units so rational DDS carries stay per unit
     /*
      * 2 Slices, 2 Buffers per slice (Ping-Pong), Buffer Size
      * Slice 0 controls Phase A & B (GPIO 0, 1)
@@ -144,6 +221,8 @@ private:
     uint _pwmSlice1;
     
     volatile int _currentBufferIndex; // Last buffer freed by DMA IRQ, 0 or 1
+    volatile uint16_t _bufferLength[2]; // Samples filled into each buffer and programmed as its transfer count
+    volatile bool _lowLatency;          // Core 0 request for short blocks while the drive is changing
     volatile uint32_t _lastBufferFillMs;
     volatile uint32_t _bufferFillCount;
     volatile uint32_t _dmaIrqCount;
@@ -151,18 +230,69 @@ private:
     volatile uint32_t _dmaDesyncCount;
     volatile bool _slice1RearmPending[2];
     bool _dmaStarted;
+
+    // Published by Core 0 outside the state lock; a single float store is atomic, and a buffer using the previous value is harmless.
+    volatile float _supplyScale;
+
+    // DC offset nulls, published like the supply scale. The fraction below one count is carried per channel from sample to sample.
+    volatile int16_t _dcOffsetNull[4];
+    int32_t _dcNullResidue[4];
+
+    // Dead-time soft zone in LUT units, and the compensation last published from Core 0 for diagnostics.
+    int32_t _deadTimeSoftLut;
+    volatile float _deadTimeCounts;
+
+    // Bridge leg placement and duty limits, fixed once the carrier is configured.
+    BridgeModulationParams _bridgeModulation;
+    volatile uint32_t _bridgeLimitCount;
+
+    /*
+     * Drive phase reference for sensorless feedback. Each buffer records the
+     * accumulator and increment it started from; the DMA IRQ publishes them
+     * with a timestamp when that buffer starts playing. The sequence count is
+     * odd while Core 1 is writing so Core 0 readers can retry a torn copy.
+     */
+    uint32_t _bufferStartPhase[2];
+    uint32_t _bufferPhaseInc[2];
+    volatile uint32_t _phaseRefSequence;
+    volatile uint32_t _phaseRefAcc;
+    volatile uint32_t _phaseRefInc;
+    volatile uint32_t _phaseRefUs;
+
+    /*
+     * Spread-spectrum carrier. TOP is double-buffered like CC, so a top written
+     * in the IRQ that ends a buffer latches together with that buffer's last
+     * sample. Each fill therefore picks the next buffer's top and scales its
+     * own last sample for it. What rescaling the phase step drops below the
+     * accumulator LSB is carried between buffers.
+     */
+    PwmDither _dither;
+    volatile uint16_t _bufferWrap[2];
+    uint32_t _ditherRemainderAcc;
+    volatile uint32_t _ditherLateCount;
     
     void generateLUT();
     void lockState();
     void unlockState();
     void fillBuffer(int bufferIndex);
+    void loadCarrierWrap(int playingBuffer);
     int16_t generateSample(int channel);
+    const FirKernel& designFirKernel(uint8_t speed, uint8_t profile);
     void setupPWM();
     void setupDMA();
-    uint32_t frequencyToPhaseIncrement(float freq) const;
+    double exactSampleRateHz() const;
+    DdsClock ddsClock() const;
+    void loadPhaseIncrement(WaveformState* target, float freq) const;
+    bool loadRationalPhaseIncrement(WaveformState* target, float freq) const;
     uint32_t phaseOffsetToAccumulator(float degrees) const;
-    void rearmDmaChannel(int channel, const uint32_t* readAddr);
-    void updateAppliedTuning(const volatile WaveformState* state);
+    void rearmDmaChannel(int channel, const uint32_t* readAddr, uint16_t length);
+    void publishPhaseReference(int playingBuffer);
+    void loadDeadTimeCompensation(WaveformState* target);
+    void loadPeakLimit(WaveformState* target) const;
+    void configureBridgeModulation();
+    int32_t deadTimeCompensation(const volatile WaveformState* state, int channel) const;
+    void updateAppliedTuning(const volatile WaveformState* state, int length);
+    void updateSoftLimiter(const volatile WaveformState* state, int length);
     bool enabledAtomic() const;
     bool swapPendingAtomic() const;
     void storeEnabled(bool enabled);
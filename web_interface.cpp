@@ -294,7 +294,7 @@ const networkFieldGroups=[
 ["Setup AP",["apSsid","apPassword","apChannel"]],
 ["Web access",["readOnlyMode","deviceLockEnabled","webPin","webHomePage"]]
 ];
-const presetGlobalMap={pm:"phaseMode",maxAmp:"maxAmplitude",ssCurve:"softStartCurve",vfBlend:"vfBlend",vfLF:"vfLowFreq",vfLL:"vfLowLevel",vfMF:"vfMidFreq",vfML:"vfMidLevel",vfBase:"vfBaseFreq",clEn:"closedLoopEnabled",clCtrl:"closedLoopControlMode",clMd:"closedLoopSensorMode",clCpr:"closedLoopCountsPerRev",clEdge:"closedLoopPulseEdge",clQuad:"closedLoopQuadratureMode",clRev:"closedLoopReverseDirection",clDir:"closedLoopDirectionFaultAction",clDb:"closedLoopDebounceUs",clTo:"closedLoopTimeoutMs",clEng:"closedLoopEngageDelayMs",clUpd:"closedLoopUpdateIntervalMs",clAlpha:"closedLoopFilterAlpha",clDbnd:"closedLoopDeadbandRpm",clLock:"closedLoopLockToleranceRpm",clLockMs:"closedLoopLockTimeMs",clKp:"closedLoopKp",clKi:"closedLoopKi",clKd:"closedLoopKd",clILim:"closedLoopIntegralLimitHz",clCLim:"closedLoopCorrectionLimitHz",clSlew:"closedLoopSlewLimitHzPerSec",clDrop:"closedLoopDropoutAction",clReqSig:"closedLoopRequireSignalBeforeEngage",clReqNear:"closedLoopRequireNearTargetBeforeEngage",clEngTol:"closedLoopEngageToleranceRpm",clRamp:"closedLoopRampMode",clRampKp:"closedLoopRampKp",clRampLim:"closedLoopRampCorrectionLimitHz",clPitchMode:"closedLoopPitchTargetMode",clPitchSlew:"closedLoopPitchSlewRpmPerSec",clPitchReset:"closedLoopPitchResetThresholdRpm",clSatMs:"closedLoopSaturationTimeMs",clSatAct:"closedLoopSaturationAction",clMinRpm:"closedLoopPlausibilityMinRpm",clMaxRpm:"closedLoopPlausibilityMaxRpm",clPlausAct:"closedLoopPlausibilityAction",clLockTo:"closedLoopLockTimeoutMs",clLockAct:"closedLoopLockTimeoutAction",clAmpRec:"closedLoopAmpRecoveryMode",clAmpRecMs:"closedLoopAmpRecoveryDelayMs",brkMd:"brakeMode",brkDur:"brakeDuration",brkPG:"brakePulseGap",brkSF:"brakeStartFreq",brkStF:"brakeStopFreq",brkCut:"softStopCutoff"};
+const presetGlobalMap={pm:"phaseMode",maxAmp:"maxAmplitude",ssCurve:"softStartCurve",vfBlend:"vfBlend",vfLF:"vfLowFreq",vfLL:"vfLowLevel",vfMF:"vfMidFreq",vfML:"vfMidLevel",vfBase:"vfBaseFreq",thEn:"thermalDerateEnabled",thWTau:"thermalWindingTauSec",thFTau:"thermalFrameTauSec",thRise:"thermalFullScaleRiseC",thShare:"thermalWindingShare",thStart:"thermalDerateStartC",thLimit:"thermalDerateLimitC",thMin:"thermalMinDerate",clEn:"closedLoopEnabled",clCtrl:"closedLoopControlMode",clMd:"closedLoopSensorMode",clCpr:"closedLoopCountsPerRev",clEdge:"closedLoopPulseEdge",clQuad:"closedLoopQuadratureMode",clRev:"closedLoopReverseDirection",clDir:"closedLoopDirectionFaultAction",clDb:"closedLoopDebounceUs",clTo:"closedLoopTimeoutMs",clEng:"closedLoopEngageDelayMs",clUpd:"closedLoopUpdateIntervalMs",clAlpha:"closedLoopFilterAlpha",clDbnd:"closedLoopDeadbandRpm",clLock:"closedLoopLockToleranceRpm",clLockMs:"closedLoopLockTimeMs",clKp:"closedLoopKp",clKi:"closedLoopKi",clKd:"closedLoopKd",clILim:"closedLoopIntegralLimitHz",clCLim:"closedLoopCorrectionLimitHz",clSlew:"closedLoopSlewLimitHzPerSec",clDrop:"closedLoopDropoutAction",clReqSig:"closedLoopRequireSignalBeforeEngage",clReqNear:"closedLoopRequireNearTargetBeforeEngage",clEngTol:"closedLoopEngageToleranceRpm",clRamp:"closedLoopRampMode",clRampKp:"closedLoopRampKp",clRampLim:"closedLoopRampCorrectionLimitHz",clPitchMode:"closedLoopPitchTargetMode",clPitchSlew:"closedLoopPitchSlewRpmPerSec",clPitchReset:"closedLoopPitchResetThresholdRpm",clSatMs:"closedLoopSaturationTimeMs",clSatAct:"closedLoopSaturationAction",clMinRpm:"closedLoopPlausibilityMinRpm",clMaxRpm:"closedLoopPlausibilityMaxRpm",clPlausAct:"closedLoopPlausibilityAction",clLockTo:"closedLoopLockTimeoutMs",clLockAct:"closedLoopLockTimeoutAction",clAmpRec:"closedLoopAmpRecoveryMode",clAmpRecMs:"closedLoopAmpRecoveryDelayMs",clSlipAct:"closedLoopSlipAction",clSlipMs:"closedLoopSlipDetectMs",clSlipPct:"closedLoopSlipThresholdPercent",clPullPct:"closedLoopPullOutThresholdPercent",clNotch:"closedLoopNotchEnabled",clNotchBw:"closedLoopNotchBandwidthHz",clNotchMin:"closedLoopNotchMinHz",clNotchMax:"closedLoopNotchMaxHz",ldEn:"loadStepEnabled",ldSlope:"loadStepSlopeRpmPerSec",ldBoost:"loadStepBoostPercent",ldBoostMs:"loadStepBoostMs",akEn:"adaptiveKickEnabled",akPull:"kickPullInPercent",blEn:"baseLearnEnabled",brkMd:"brakeMode",brkDur:"brakeDuration",brkPG:"brakePulseGap",brkSF:"brakeStartFreq",brkStF:"brakeStopFreq",brkCut:"softStopCutoff"};
 presetGlobalMap.top="motorTopology";presetGlobalMap.phSlew="phaseSlewDegreesPerSecond";presetGlobalMap.gainSlew="gainSlewPercentPerSecond";
 const presetSpeedMap={f:"frequency",minF:"minFrequency",maxF:"maxFrequency",ssD:"softStartDuration",rAmp:"reducedAmplitude",aDly:"amplitudeDelay",kick:"startupKick",kDur:"startupKickDuration",kRmp:"startupKickRampDuration",fTyp:"filterType",iir:"iirAlpha",fir:"firProfile"};
 const $=id=>document.getElementById(id);
@@ -347,7 +347,7 @@ function mergeReportInto(target,source,prefix){source.items.forEach(i=>reportIss
 function validateSpeedRelationship(r,s,path){if(!s)return;const min=s.minFrequency??s.minF,max=s.maxFrequency??s.maxF,f=s.frequency??s.f;if(typeof min==="number"&&typeof max==="number"&&min>max)reportIssue(r,"error",path,"Minimum frequency is higher than maximum frequency.");if(typeof f==="number"&&typeof min==="number"&&typeof max==="number"&&(f<min||f>max))reportIssue(r,"error",path,"Frequency is outside this speed's minimum and maximum range.")}
 function validateSettingsImportObject(obj){const r=newReport();if(!obj||typeof obj!=="object"||Array.isArray(obj)){reportIssue(r,"error","settings","Settings import must be a JSON object.");return r}const g=obj.global;if(!g||typeof g!=="object"||Array.isArray(g))reportIssue(r,"error","settings.global","Global settings object is missing.");else{Object.keys(g).forEach(k=>{if(k!=="schemaVersion"&&!findField(globalFields(),k)&&k!=="totalRuntime")reportIssue(r,"warn",`settings.global.${k}`,"This setting is not used by this firmware.");});globalFields().forEach(f=>{if(Object.prototype.hasOwnProperty.call(g,f.k))validateImportField(r,f,g[f.k],`settings.global.${f.k}`)})}const speeds=obj.speeds;if(!Array.isArray(speeds))reportIssue(r,"error","settings.speeds","Speeds must be an array.");else{if(speeds.length!==3)reportIssue(r,"warn","settings.speeds","Expected three speed entries.");speeds.slice(0,3).forEach((s,i)=>{if(!s||typeof s!=="object"||Array.isArray(s)){reportIssue(r,"error",`settings.speeds.${i}`,"Speed entry must be an object.");return}Object.keys(s).forEach(k=>{if(k!=="phaseOffset"&&!findField(speedFields,k))reportIssue(r,"warn",`settings.speeds.${i}.${k}`,"This speed setting is not used by this firmware.");});speedFields.forEach(f=>{if(f.k.startsWith("phase"))return;if(Object.prototype.hasOwnProperty.call(s,f.k))validateImportField(r,f,s[f.k],`settings.speeds.${i}.${f.k}`)});if(Object.prototype.hasOwnProperty.call(s,"phaseOffset")){if(!Array.isArray(s.phaseOffset))reportIssue(r,"error",`settings.speeds.${i}.phaseOffset`,"Phase offsets must be an array.");else s.phaseOffset.slice(0,4).forEach((v,p)=>validateImportField(r,findField(speedFields,`phase${p}`),v,`settings.speeds.${i}.phaseOffset.${p}`))}validateSpeedRelationship(r,s,`settings.speeds.${i}`)})}return r}
 function validateNetworkImportObject(cfg){const r=newReport();if(!cfg||typeof cfg!=="object"||Array.isArray(cfg)){reportIssue(r,"error","network.config","Network config must be a JSON object.");return r}Object.keys(cfg).forEach(k=>{if(!["passwordSet","apPasswordSet","webPinSet"].includes(k)&&!findField(networkFields,k))reportIssue(r,"warn",`network.config.${k}`,"This network setting is not used by this firmware.");});networkFields.forEach(f=>{if(Object.prototype.hasOwnProperty.call(cfg,f.k))validateImportField(r,f,cfg[f.k],`network.config.${f.k}`)});if(Number(cfg.mode)!==0&&!cfg.ssid)reportIssue(r,"error","network.config.ssid","SSID is required for station mode.");if(cfg.dhcp===false)["staticIp","gateway","subnet","dns"].forEach(k=>{if(!cfg[k])reportIssue(r,"error",`network.config.${k}`,"Required when DHCP is off.")});if(!cfg.apSsid)reportIssue(r,"error","network.config.apSsid","Setup AP SSID is required.");return r}
-function validatePresetImportObject(obj){const r=newReport();if(!obj||typeof obj!=="object"||Array.isArray(obj)){reportIssue(r,"error","preset","Preset import must be a JSON object.");return r}Object.keys(obj).forEach(k=>{if(k!=="speeds"&&k!=="clT"&&k!=="clTune"&&!presetGlobalMap[k])reportIssue(r,"warn",k,"This preset key is not used by this firmware.");});Object.keys(presetGlobalMap).forEach(k=>{if(Object.prototype.hasOwnProperty.call(obj,k)){const field=findField(globalFields(),presetGlobalMap[k]);if(field)validateImportField(r,field,obj[k],k)}});if(Object.prototype.hasOwnProperty.call(obj,"clT")){if(!Array.isArray(obj.clT))reportIssue(r,"error","clT","Closed-loop target RPM values must be an array.");else["closedLoopTargetRpm33","closedLoopTargetRpm45","closedLoopTargetRpm78"].forEach((k,i)=>{if(i<obj.clT.length)validateImportField(r,findField(globalFields(),k),obj.clT[i],`clT.${i}`)})}if(Object.prototype.hasOwnProperty.call(obj,"clTune")){if(!Array.isArray(obj.clTune))reportIssue(r,"error","clTune","Closed-loop tuning must be an array.");else if(obj.clTune.length>3)reportIssue(r,"warn","clTune","Only the first three closed-loop tuning entries are imported.")}if(Object.prototype.hasOwnProperty.call(obj,"speeds")){if(!Array.isArray(obj.speeds))reportIssue(r,"error","speeds","Speeds must be an array.");else{if(obj.speeds.length>3)reportIssue(r,"warn","speeds","Only the first three speed entries are imported.");obj.speeds.slice(0,3).forEach((s,i)=>{if(!s||typeof s!=="object"||Array.isArray(s)){reportIssue(r,"error",`speeds.${i}`,"Speed entry must be an object.");return}Object.keys(s).forEach(k=>{if(k!=="ph"&&!presetSpeedMap[k])reportIssue(r,"warn",`speeds.${i}.${k}`,"This preset speed key is not used by this firmware.");});Object.keys(presetSpeedMap).forEach(k=>{if(Object.prototype.hasOwnProperty.call(s,k)){const field=findField(speedFields,presetSpeedMap[k]);if(field)validateImportField(r,field,s[k],`speeds.${i}.${k}`)}});if(Object.prototype.hasOwnProperty.call(s,"ph")){if(!Array.isArray(s.ph))reportIssue(r,"error",`speeds.${i}.ph`,"Phase offsets must be an array.");else s.ph.slice(0,4).forEach((v,p)=>validateImportField(r,findField(speedFields,`phase${p}`),v,`speeds.${i}.ph.${p}`))}validateSpeedRelationship(r,s,`speeds.${i}`)})}}else reportIssue(r,"warn","speeds","No speed entries are included; missing fields will stay unchanged in the target preset.");return r}
+function validatePresetImportObject(obj){const r=newReport();if(!obj||typeof obj!=="object"||Array.isArray(obj)){reportIssue(r,"error","preset","Preset import must be a JSON object.");return r}Object.keys(obj).forEach(k=>{if(k!=="speeds"&&k!=="clT"&&k!=="clTune"&&k!=="dtLag"&&k!=="firCut"&&k!=="firTw"&&k!=="firTaps"&&!presetGlobalMap[k])reportIssue(r,"warn",k,"This preset key is not used by this firmware.");});Object.keys(presetGlobalMap).forEach(k=>{if(Object.prototype.hasOwnProperty.call(obj,k)){const field=findField(globalFields(),presetGlobalMap[k]);if(field)validateImportField(r,field,obj[k],k)}});if(Object.prototype.hasOwnProperty.call(obj,"clT")){if(!Array.isArray(obj.clT))reportIssue(r,"error","clT","Closed-loop target RPM values must be an array.");else["closedLoopTargetRpm33","closedLoopTargetRpm45","closedLoopTargetRpm78"].forEach((k,i)=>{if(i<obj.clT.length)validateImportField(r,findField(globalFields(),k),obj.clT[i],`clT.${i}`)})}if(Object.prototype.hasOwnProperty.call(obj,"dtLag")){if(!Array.isArray(obj.dtLag))reportIssue(r,"error","dtLag","Dead-time lag values must be an array.");else["bridgeDeadTimeLagDeg33","bridgeDeadTimeLagDeg45","bridgeDeadTimeLagDeg78"].forEach((k,i)=>{const field=findField(globalFields(),k);if(field&&i<obj.dtLag.length)validateImportField(r,field,obj.dtLag[i],`dtLag.${i}`)})}[["firCut","firCutoffHz","FIR cutoff"],["firTw","firTransitionHz","FIR transition width"],["firTaps","firTaps","FIR tap budget"]].forEach(([key,base,label])=>{if(Object.prototype.hasOwnProperty.call(obj,key)){if(!Array.isArray(obj[key]))reportIssue(r,"error",key,`${label} values must be an array.`);else["33","45","78"].forEach((n,i)=>{const field=findField(globalFields(),base+n);if(field&&i<obj[key].length)validateImportField(r,field,obj[key][i],`${key}.${i}`)})}})if(Object.prototype.hasOwnProperty.call(obj,"clTune")){if(!Array.isArray(obj.clTune))reportIssue(r,"error","clTune","Closed-loop tuning must be an array.");else if(obj.clTune.length>3)reportIssue(r,"warn","clTune","Only the first three closed-loop tuning entries are imported.")}if(Object.prototype.hasOwnProperty.call(obj,"speeds")){if(!Array.isArray(obj.speeds))reportIssue(r,"error","speeds","Speeds must be an array.");else{if(obj.speeds.length>3)reportIssue(r,"warn","speeds","Only the first three speed entries are imported.");obj.speeds.slice(0,3).forEach((s,i)=>{if(!s||typeof s!=="object"||Array.isArray(s)){reportIssue(r,"error",`speeds.${i}`,"Speed entry must be an object.");return}Object.keys(s).forEach(k=>{if(k!=="ph"&&!presetSpeedMap[k])reportIssue(r,"warn",`speeds.${i}.${k}`,"This preset speed key is not used by this firmware.");});Object.keys(presetSpeedMap).forEach(k=>{if(Object.prototype.hasOwnProperty.call(s,k)){const field=findField(speedFields,presetSpeedMap[k]);if(field)validateImportField(r,field,s[k],`speeds.${i}.${k}`)}});if(Object.prototype.hasOwnProperty.call(s,"ph")){if(!Array.isArray(s.ph))reportIssue(r,"error",`speeds.${i}.ph`,"Phase offsets must be an array.");else s.ph.slice(0,4).forEach((v,p)=>validateImportField(r,findField(speedFields,`phase${p}`),v,`speeds.${i}.ph.${p}`))}validateSpeedRelationship(r,s,`speeds.${i}`)})}}else reportIssue(r,"warn","speeds","No speed entries are included; missing fields will stay unchanged in the target preset.");return r}
 function validateBackupObject(b){const r=newReport();if(!b||typeof b!=="object"||Array.isArray(b)){reportIssue(r,"error","backup","Backup import must be a JSON object.");return r}if(b.settings)mergeReportInto(r,validateSettingsImportObject(b.settings),"settings");else reportIssue(r,"warn","settings","No motor settings are included.");if(b.network&&b.network.config){mergeReportInto(r,validateNetworkImportObject(b.network.config),"network");reportIssue(r,"info","network","Wi-Fi passwords and the web PIN are intentionally not imported from backups.");}if(Array.isArray(b.presets)){b.presets.forEach((p,i)=>{if(!p||typeof p!=="object"){reportIssue(r,"error",`presets.${i}`,"Preset entry must be an object.");return}if(typeof p.slot!=="number"||p.slot<0||p.slot>=5)reportIssue(r,"error",`presets.${i}.slot`,"Preset slot must be 0 through 4.");if(p.json){try{mergeReportInto(r,validatePresetImportObject(JSON.parse(p.json)),`presets.${i}.json`)}catch(e){reportIssue(r,"error",`presets.${i}.json`,"Preset JSON is not valid.")}}})}else if(b.presets!==undefined)reportIssue(r,"error","presets","Presets must be an array.");if(!r.errors&&!r.warnings)reportIssue(r,"info","import","Validation passed with no issues.");return r}
 function renderReport(el,title,r,extra=""){if(!el)return;el.classList.remove("hide");const summary=`${r.errors} error${r.errors===1?"":"s"}, ${r.warnings} warning${r.warnings===1?"":"s"}, ${r.infos} note${r.infos===1?"":"s"}`;el.innerHTML=`<h3>${esc(title)}</h3><p>${esc(summary)}</p>${extra}${r.items.map(i=>`<div class="report-item report-${i.kind==="warn"?"warn":i.kind}"><strong>${esc(i.kind==="warn"?"Warning":i.kind==="error"?"Error":"Note")}:</strong> ${esc(i.path)} - ${esc(i.msg)}</div>`).join("")}`}
 function speedComparable(s){const out={phaseOffset:[...s.phaseOffset],channelAmplitude:[...s.channelAmplitude]};speedFields.forEach(f=>{if(!f.k.startsWith("phase")&&!f.k.startsWith("gain"))out[f.k]=s[f.k]});return out}
@@ -383,10 +383,21 @@ if(!cl.enabled)return "off";
 const mode=optionLabel("closedLoopControlMode",cl.controlMode),pitchMode=optionLabel("closedLoopPitchTargetMode",cl.pitchTargetMode),rpm=cl.signalValid?`${Number(cl.filteredRpm||0).toFixed(3)} RPM`:"no signal",state=cl.active?(cl.locked?"locked":"active"):"idle";
 const target=`target ${Number(cl.targetRpm||0).toFixed(3)} RPM (${pitchMode})`;
 const pitchOffset=Number(cl.pitchOffsetRpm||0);
-const flags=[Math.abs(pitchOffset)>0.0005?`pitch ${pitchOffset>=0?"+":""}${pitchOffset.toFixed(3)} RPM`:"",cl.saturated?"saturated":"",cl.ampRecoveryActive?"amplitude recovery":"",cl.setup&&cl.setup.active?"setup active":"",cl.tuning&&cl.tuning.active?`tune ${cl.tuning.stepName}`:""].filter(Boolean).join(", ");
+const flags=[Math.abs(pitchOffset)>0.0005?`pitch ${pitchOffset>=0?"+":""}${pitchOffset.toFixed(3)} RPM`:"",cl.saturated?"saturated":"",cl.ampRecoveryActive?"amplitude recovery":"",cl.slipping?"slipping":"",cl.setup&&cl.setup.active?"setup active":"",cl.tuning&&cl.tuning.active?`tune ${cl.tuning.stepName}`:""].filter(Boolean).join(", ");
 return `${mode}: ${rpm}, ${target}, ${state}, correction ${Number(cl.correctionHz||0).toFixed(3)} Hz${flags?`, ${flags}`:""}`}
 function closedLoopTileHtml(cl){if(!cl||!cl.compiled)return "";const main=!cl.enabled?"Off":cl.signalValid?`${Number(cl.filteredRpm||0).toFixed(3)} RPM`:"No signal",mode=optionLabel("closedLoopControlMode",cl.controlMode),detail=!cl.enabled?"feedback disabled":`${mode}, ${cl.active?(cl.locked?"locked":"active"):"idle"}, ${Number(cl.correctionHz||0).toFixed(3)} Hz`;return `<div class="dash-tile"><span>Closed loop</span><strong>${esc(main)}</strong><span>${esc(detail)}</span></div>`}
-function telemetryHtml(){const a=statusData.amp.enabled?`${statusData.amp.temperatureC.toFixed(1)} C, ${statusData.amp.state}`:"not enabled",clText=closedLoopStatusText(statusData.motor.closedLoop);return `<div class="telemetry-grid"><div><div class="legend" aria-label="Telemetry series"><label><input type="checkbox" data-series="frequency"${telemetrySeries.frequency?" checked":""}> Frequency</label><label><input type="checkbox" data-series="pitch"${telemetrySeries.pitch?" checked":""}> Pitch</label><label><input type="checkbox" data-series="amp"${telemetrySeries.amp?" checked":""}> Amp temp</label><label><input type="checkbox" data-series="rpm"${telemetrySeries.rpm?" checked":""}> Measured RPM</label></div><canvas class="chart" id="telemetryChart" width="720" height="240" role="img" aria-label="Live telemetry chart"></canvas></div><div id="telemetryReadout"><h3>Live telemetry</h3><p>Frequency: ${statusData.motor.frequency.toFixed(2)} Hz</p><p>Pitch: ${statusData.motor.pitch.toFixed(2)} percent</p><p>Motion progress: ${Math.round(statusData.motor.motionProgress*100)} percent</p><p>Closed loop: ${esc(clText)}</p><p>Amplifier: ${esc(a)}</p></div></div>`}
+function brakeMetricsHtml(b){if(!b||!(b.stops||b.fallbacks||b.active))return"";const result=["none","standstill","reversal","timeout","predicted stop","no pulse"][b.lastResult]||"none";return `<p>Tach brake: ${b.active?`braking at ${Number(b.currentRpm||0).toFixed(2)} RPM, `:""}last ${(Number(b.lastStopMs||0)/1000).toFixed(2)} s from ${Number(b.lastStartRpm||0).toFixed(2)} RPM (${result}), best ${(Number(b.bestStopMs||0)/1000).toFixed(2)} s</p><p>Overshoot: ${Number(b.lastOvershootDeg||0).toFixed(1)} deg${b.lastReversed?" reverse":""}, peak ${Number(b.peakOvershootRpm||0).toFixed(2)} RPM${b.settling?", watching":""}; ${Number(b.stops||0)} stops, ${Number(b.timeouts||0)} timeouts, ${Number(b.fallbacks||0)} timed fallbacks</p>`}
+function closedLoopNotchText(n){if(!n||!n.enabled)return"off";const st=n.stages||[];return st.length?st.map(x=>`${Number(x.centreHz||0).toFixed(2)} Hz, ${Math.round(Number(x.engagement||0)*100)} percent engaged, ratio ${Number(x.powerRatio||0).toFixed(2)}`).join("; "):"idle"}
+function sensorlessText(s){if(!s||!s.active)return"not selected";return `${s.valid?"valid":"no signal"}, rotor ${Number(s.electricalHz||0).toFixed(3)} Hz, drive ${Number(s.driveHz||0).toFixed(3)} Hz, slip ${Number(s.slipHz||0).toFixed(3)} Hz, phase ${Number(s.phaseDegrees||0).toFixed(1)} deg, amplitude ${Math.round(Number(s.amplitude||0))}, ${Number(s.rejectedCrossings||0)} rejected, ${Number(s.overruns||0)} overruns`}
+function pulseDutyText(d){const pct=x=>`${(Number(x||0)*100).toFixed(1)}%`,warn=[d.warnings&1?"mean drifting":"",d.warnings&2?"slots spreading":"",d.warnings&4?"marginal signal":""].filter(Boolean).join(", ");return `mean ${pct(d.mean)}${d.baselineValid?`, drift ${pct(d.drift)}`:", baseline pending"}, ${Number(d.slots||0)} slots ${pct(d.minSlot)}-${pct(d.maxSlot)}, ${Number(d.samples||0)} samples, ${Number(d.rejected||0)} rejected${warn?` - ${warn}`:", OK"}`}
+function wearText(w){if(!w)return"none";const drift=d=>[d&1?"belt stretch":"",d&2?"bearing wear":"",d&4?"speed stability":""].filter(Boolean).join(", "),fmt=[[1,3," Hz"],[100,1,"%"],[1,2," s"],[1,4," RPM"],[1,1," s"]],names=["correction","amplitude","lock","error RMS","coast"],speeds=(w.speeds||[]).map((s,i)=>{if(!Number(s.sessions))return"";const ch=(s.change||[]).map((x,m)=>`${names[m]} ${Number(x)>=0?"+":""}${(Number(x||0)*fmt[m][0]).toFixed(fmt[m][1])}${fmt[m][2]}${(Number(s.worsening)>>m)&1?"*":""}`).join(", ");return `${speedNames[i]||i}: ${Number(s.sessions)} sessions over ${Number(s.spanHours||0).toFixed(1)} h, ${ch}; ${Number(s.drift)?"drift "+drift(Number(s.drift)):Number(s.sessions)<Number(w.minSessions||0)?"too few sessions":"no drift"}`}).filter(Boolean).join(" | ");return `${Number(w.records||0)} of ${Number(w.capacity||0)} sessions${w.sessionActive?`, this session ${Math.round(Number(w.sessionLockedSec||0))} s locked`:""}${speeds?"; "+speeds:""}`}
+function baseLearnText(b){if(!b)return"none";const acts=["none","learning","stepped","rolled back"],speeds=(b.speeds||[]).map((s,i)=>{if(!(Number(s.anchorHz)>0))return"";return `${speedNames[i]||i}: base ${Number(s.baseHz||0).toFixed(3)} Hz (set ${Number(s.anchorHz||0).toFixed(3)})${Number(s.ppm)>=0?`, ratio ${Number(s.ratio||0).toFixed(4)} RPM/Hz +/-${Math.round(Number(s.ppm||0))} ppm over ${Number(s.weight||0).toFixed(1)} sessions`:""}, last ${acts[Number(s.last)]||"none"}${s.shared?" (shared)":""}${s.bounded?" (limited)":""}${s.probation?", on probation":""}`}).filter(Boolean).join(" | ");return `${b.enabled?"on":"off"}, ${Number(b.steps||0)} steps, ${Number(b.rollbacks||0)} rollbacks${Number(b.sharedPpm)>=0?`, shared ratio ${Number(b.sharedRatio||0).toFixed(4)} +/-${Math.round(Number(b.sharedPpm||0))} ppm`:""}${speeds?"; "+speeds:""}`}
+function startupKickText(k){if(!k)return"none";const ends=["no kick","pulled in","learned length","configured length"],lock=(k.timeToLockSec||[]).map((x,i)=>`${speedNames[i]||i} ${Number(x)>0?Number(x).toFixed(2)+" s":"none"}`).join(", "),learned=(k.learnedKickSec||[]).map((x,i)=>`${speedNames[i]||i} ${Number(x||0).toFixed(2)}/${Number((k.learnedRampSec||[])[i]||0).toFixed(2)} s`).join(", ");return `${k.enabled?"adaptive":"fixed"}, ${Number(k.starts||0)} starts, ${Number(k.pullIns||0)} pull-ins; last ${ends[k.lastEnd]||"no kick"} at ${Number(k.lastKickSec||0).toFixed(2)} s${k.lastRampSlipped?", ramp slipped":""}; kick/ramp ${learned}; time to lock ${lock}`}
+function offsetNullCard(o){if(!o)return"";const steps=["idle","zero","measure","probe"],outcomes=["not run","nulled","no response","out of range","not converged","cancelled"],rows=(o.channels||[]).map((c,i)=>`<p>${"ABCD"[i]}: ${Number(o.active?c.appliedCounts:c.storedCounts||0).toFixed(2)} counts, ${esc(outcomes[c.outcome]||"not run")}${c.gain?`, residual ${Number(c.residualCounts||0).toFixed(3)}`:""}</p>`).join("");return `<div class="bench-card"><h3>Amplifier offset</h3><p>Status: ${o.active?`${esc(steps[o.step]||"-")}${o.selectedChannel>=0?" "+"ABCD"[o.selectedChannel]:""}`:(Number(o.runs||0)?(o.lastSucceeded?"last run nulled":"last run incomplete"):"idle")}</p>${rows}<div class="button-row"><button data-bench="offsetNull">Null offsets</button><button data-bench="offsetCancel">Cancel</button><button data-bench="offsetClear">Clear</button></div></div>`}
+function loadStepText(l){if(!l||!l.enabled)return"off";const learned=(l.learnedHz||[]).map((x,i)=>`${speedNames[i]||i} ${Number(x||0).toFixed(4)} Hz`).join(", ");return `${l.measuring?"measuring":(l.armed?"armed":"waiting for lock")}, stylus ${l.loaded?"down":"up"}, ${Number(l.drops||0)} drops, ${Number(l.lifts||0)} lifts; learned ${learned||"none"}`}
+function busVoltageText(b){if(!b)return"-";const st=["normal","dip","undervoltage","over-voltage"][b.state]||"-";return `${Number(b.volts||0).toFixed(2)} V ${st}, feed-forward ${Math.round(Number(b.scale||1)*100)} percent, range ${Number(b.minVolts||0).toFixed(1)}-${Number(b.maxVolts||0).toFixed(1)} V, ${Number(b.dipsRiddenThrough||0)} dips ridden through (longest ${Math.round(Number(b.longestDipMs||0))} ms), ${Number(b.underVoltageEvents||0)} undervoltage, ${Number(b.overVoltageEvents||0)} over-voltage, ${Number(b.brakeAborts||0)} braking aborts`}
+function motorThermalText(t){if(!t)return"-";return `rise ${Number(t.totalRiseC||0).toFixed(1)} C (steady ${Number(t.steadyRiseC||0).toFixed(1)} C), drive ${Math.round(Number(t.driveLevel||0)*100)} percent, derate ${t.derateEnabled?`${Math.round(Number(t.derate||1)*100)} percent${t.derating?" active":""}`:"off"}`}
+function telemetryHtml(){const a=statusData.amp.enabled?`${statusData.amp.temperatureC.toFixed(1)} C, ${statusData.amp.state}`:"not enabled",clText=closedLoopStatusText(statusData.motor.closedLoop);return `<div class="telemetry-grid"><div><div class="legend" aria-label="Telemetry series"><label><input type="checkbox" data-series="frequency"${telemetrySeries.frequency?" checked":""}> Frequency</label><label><input type="checkbox" data-series="pitch"${telemetrySeries.pitch?" checked":""}> Pitch</label><label><input type="checkbox" data-series="amp"${telemetrySeries.amp?" checked":""}> Amp temp</label><label><input type="checkbox" data-series="rpm"${telemetrySeries.rpm?" checked":""}> Measured RPM</label></div><canvas class="chart" id="telemetryChart" width="720" height="240" role="img" aria-label="Live telemetry chart"></canvas></div><div id="telemetryReadout"><h3>Live telemetry</h3><p>Frequency: ${statusData.motor.frequency.toFixed(2)} Hz</p><p>Pitch: ${statusData.motor.pitch.toFixed(2)} percent</p><p>Motion progress: ${Math.round(statusData.motor.motionProgress*100)} percent</p><p>Closed loop: ${esc(clText)}</p><p>Motor thermal: ${motorThermalText(statusData.motor.thermal)}</p>${statusData.motor.bus?`<p>DC bus: ${esc(busVoltageText(statusData.motor.bus))}</p>`:""}<p>Amplifier: ${esc(a)}</p></div></div>`}
 function drawSeries(ctx,vals,color,min,max){if(vals.length<2)return;const w=720,h=220,pad=28,range=Math.max(max-min,0.001);ctx.strokeStyle=color;ctx.lineWidth=2;ctx.beginPath();vals.forEach((v,i)=>{const x=pad+i*(w-pad*2)/(vals.length-1),y=h-pad-((v-min)/range)*(h-pad*2);if(i===0)ctx.moveTo(x,y);else ctx.lineTo(x,y)});ctx.stroke()}
 function drawTelemetry(){const c=$("telemetryChart");if(!c||!telemetry.length)return;document.querySelectorAll("[data-series]").forEach(el=>el.onchange=()=>{telemetrySeries[el.dataset.series]=el.checked;drawTelemetry()});const ctx=c.getContext("2d"),style=getComputedStyle(document.body),w=720,h=240,pad=32;ctx.clearRect(0,0,w,h);ctx.strokeStyle=style.getPropertyValue("--line");ctx.lineWidth=1;for(let i=0;i<=4;i++){const y=20+i*42;ctx.beginPath();ctx.moveTo(pad,y);ctx.lineTo(w-pad,y);ctx.stroke()}for(let i=0;i<=6;i++){const x=pad+i*(w-pad*2)/6;ctx.beginPath();ctx.moveTo(x,20);ctx.lineTo(x,188);ctx.stroke()}ctx.strokeRect(pad,20,w-pad*2,168);ctx.fillStyle=style.getPropertyValue("--muted");ctx.fillText("newer",w-pad-38,214);ctx.fillText("older",pad,214);const f=telemetry.map(x=>x.f),p=telemetry.map(x=>x.p),a=telemetry.filter(x=>x.a!==null).map(x=>x.a),rpm=telemetry.filter(x=>x.rpm!==null).map(x=>x.rpm);if(telemetrySeries.frequency)drawSeries(ctx,f,style.getPropertyValue("--accent"),Math.min(...f),Math.max(...f));if(telemetrySeries.pitch)drawSeries(ctx,p,style.getPropertyValue("--good"),-50,50);if(telemetrySeries.amp&&a.length)drawSeries(ctx,a,style.getPropertyValue("--warn"),20,90);if(telemetrySeries.rpm&&rpm.length)drawSeries(ctx,rpm,style.getPropertyValue("--danger"),0,120);let lx=pad;[["frequency","Frequency","--accent"],["pitch","Pitch","--good"],["amp","Amp temp","--warn"],["rpm","Measured RPM","--danger"]].forEach(([k,l,cvar])=>{if(!telemetrySeries[k])return;ctx.fillStyle=style.getPropertyValue(cvar);ctx.fillRect(lx,222,12,4);ctx.fillStyle=style.getPropertyValue("--muted");ctx.fillText(l,lx+16,228);lx+=k==="rpm"?130:95})}
 function bytesText(v){v=Number(v||0);return v>=1048576?(v/1048576).toFixed(1)+" MB":Math.round(v/1024)+" KB"}
@@ -396,7 +407,7 @@ function syncDashboardModeButtons(){document.querySelectorAll("[data-mode]").for
 function systemDashboardHtml(mode){const s=statusData.system||{},cpu=s.cpu||{},mem=s.memory||{},flash=s.flash||{};if(mode==="cpu")return `<h2>CPU</h2><div class="dash-grid"><div class="dash-tile"><span>Core 0</span><strong>${Number(cpu.core0Percent||0).toFixed(0)}%</strong></div><div class="dash-tile"><span>Waveform core</span><strong>${Number(cpu.waveformPercent||0).toFixed(0)}%</strong></div></div>`;if(mode==="memory")return `<h2>Memory</h2><div class="dash-grid"><div class="dash-tile"><span>Heap used</span><strong>${bytesText(mem.heapUsedBytes)}</strong><div class="progress"><i style="width:${pctText(mem.heapUsedBytes,mem.heapTotalBytes)}"></i></div></div><div class="dash-tile"><span>Heap free</span><strong>${bytesText(mem.heapFreeBytes)}</strong></div><div class="dash-tile"><span>PSRAM used</span><strong>${bytesText(mem.psramUsedBytes)}</strong></div><div class="dash-tile"><span>PSRAM free</span><strong>${bytesText(mem.psramFreeBytes)}</strong></div></div>`;return `<h2>Flash</h2><div class="dash-grid"><div class="dash-tile"><span>Flash total</span><strong>${bytesText(flash.totalBytes)}</strong></div><div class="dash-tile"><span>Sketch</span><strong>${bytesText(flash.sketchUsedBytes)} / ${bytesText(flash.sketchCapacityBytes)}</strong><div class="progress"><i style="width:${pctText(flash.sketchUsedBytes,flash.sketchCapacityBytes)}"></i></div></div><div class="dash-tile"><span>Filesystem</span><strong>${flash.filesystemMounted?`${bytesText(flash.filesystemUsedBytes)} / ${bytesText(flash.filesystemTotalBytes)}`:"not mounted"}</strong><div class="progress"><i style="width:${pctText(flash.filesystemUsedBytes,flash.filesystemTotalBytes)}"></i></div></div></div>`}
 function renderDashboard(){if(!statusData||currentTab!=="dashboard")return;syncDashboardModeButtons();const b=$("dashboardBody");if(b.contains(document.activeElement))return;const m=statusData.motor,amp=statusData.amp.enabled?`${statusData.amp.temperatureC.toFixed(1)} C`:"Off",cls=statusClass(m.state),motion=Math.round(m.motionProgress*100),name=speedNames[m.speed]||m.speedName||"-";const hero=`<div class="drive-hero"><div class="drive-primary"><div class="platter" aria-hidden="true"></div><div><span class="status-chip ${cls}">${esc(m.state)}</span><div class="drive-speed">${esc(name)}</div><span class="net">Selected speed</span></div></div><div class="drive-readouts"><div class="readout"><span>Frequency</span><strong>${m.frequency.toFixed(2)} Hz</strong></div><div class="readout"><span>Pitch</span><strong>${m.pitch.toFixed(2)}%</strong></div><div class="readout"><span>Motion</span><strong>${motion}%</strong></div><div class="readout"><span>Amplifier</span><strong>${esc(amp)}</strong></div></div></div>`;const clTile=closedLoopTileHtml(m.closedLoop);if(["cpu","memory","flash"].includes(dashboardMode)){b.innerHTML=systemDashboardHtml(dashboardMode);return}if(dashboardMode==="dim"){b.innerHTML=hero;return}if(dashboardMode==="stats"){b.innerHTML=`${hero}<h2>Runtime and telemetry</h2><div class="dash-grid"><div class="dash-tile"><span>Session</span><strong>${statusData.runtime.session}s</strong></div><div class="dash-tile"><span>Total</span><strong>${statusData.runtime.total}s</strong></div>${clTile}</div>${telemetryHtml()}`;drawTelemetry();return}if(dashboardMode==="scope"){b.innerHTML=`${hero}<h2>Phase scope</h2><canvas class="scope" id="scopeCanvas" width="180" height="180" role="img" aria-label="Phase A and B position; numeric values follow"></canvas><p>Phase A: ${statusData.scope.a}, Phase B: ${statusData.scope.b}</p>${telemetryHtml()}`;const c=$("scopeCanvas"),x=c.getContext("2d"),style=getComputedStyle(document.body);x.clearRect(0,0,180,180);x.strokeStyle=style.getPropertyValue("--line");x.strokeRect(20,20,140,140);x.fillStyle=style.getPropertyValue("--accent");x.beginPath();x.arc(90+statusData.scope.a/8,90-statusData.scope.b/8,5,0,Math.PI*2);x.fill();drawTelemetry();return}b.innerHTML=`${hero}${clTile?`<div class="dash-grid">${clTile}</div>`:""}${telemetryHtml()}`;drawTelemetry()}
 function renderStatus(){if(!statusData)return;const m=statusData.motor,ampText=statusData.amp.enabled?(statusData.amp.thermalOk?"OK":"TRIPPED"):"Off",name=speedNames[m.speed]||m.speedName||"-";if(lastState&&lastState!==m.state)addEvent(`Motor state ${m.state}`);if(lastSpeed>=0&&lastSpeed!==m.speed)addEvent(`Speed ${name}`);if(lastAmpState&&lastAmpState!==ampText)addEvent(`Amplifier ${ampText}`);lastState=m.state;lastSpeed=m.speed;lastAmpState=ampText;$("state").textContent=m.state;$("speed").textContent=name;$("frequency").textContent=m.frequency.toFixed(2)+" Hz";$("pitch").textContent=m.pitch.toFixed(2)+"%";$("ampState").textContent=ampText;$("safetyState").textContent=m.state;$("safetyDetail").textContent=`${name} · ${m.frequency.toFixed(2)} Hz · pitch ${m.pitch.toFixed(2)}%`;const cls=statusClass(m.state);$("state").closest(".metric").className=`metric ${cls}`;$("speed").closest(".metric").className=`metric ${m.running?"ok":"warn"}`;$("frequency").closest(".metric").className=`metric ${m.speedRamping?"warn":m.running?"ok":""}`;$("pitch").closest(".metric").className=`metric ${Math.abs(m.pitch)>0.01?"warn":""}`;$("ampState").closest(".metric").className=`metric ${ampText==="TRIPPED"?"bad":ampText==="OK"?"ok":""}`;if($("simplePitch")&&document.activeElement!==$("simplePitch"))$("simplePitch").value=m.pitch.toFixed(1);pushTelemetry();renderDashboard();renderBench();setLockedUI()}
-function renderPowerStage(){if(!statusData||currentTab!=="powerstage")return;const root=$("powerStageBody"),m=statusData.motor,o=m.output||{},metrics=o.metrics||{},count=Math.max(1,Math.min(4,Number(settingsData?.global?.phaseMode||o.channels?.length||3))),channels=(o.channels||[]).slice(0,count),cx=120,cy=120,r=82;const colours=["var(--accent)","var(--good)","var(--warn)","var(--danger)"];let svg=`<svg viewBox="0 0 240 240" role="img" aria-label="Applied phase vectors" style="width:min(100%,24rem);height:auto"><circle cx="${cx}" cy="${cy}" r="${r}" fill="none" stroke="var(--line)"/>`;channels.forEach((c,i)=>{const a=Number(c.appliedPhase||0)*Math.PI/180,len=r*Math.max(.1,Number(c.appliedGain||100)/150),x=cx+Math.cos(a)*len,y=cy-Math.sin(a)*len;svg+=`<line x1="${cx}" y1="${cy}" x2="${x.toFixed(1)}" y2="${y.toFixed(1)}" stroke="${colours[i]}" stroke-width="4"/><text x="${x.toFixed(1)}" y="${y.toFixed(1)}" fill="var(--text)">${String.fromCharCode(65+i)}</text>`});svg+="</svg>";const rows=channels.map((c,i)=>`<tr><th>${String.fromCharCode(65+i)}</th><td>${Number(c.targetPhase||0).toFixed(1)}°</td><td>${Number(c.appliedPhase||0).toFixed(1)}°</td><td>${Number(c.targetGain||0)}%</td><td>${Number(c.appliedGain||0).toFixed(1)}%</td><td>${Number(c.headroom||0).toFixed(1)}%</td><td>${Number(c.clippingCount||0)}</td></tr>`).join("");const fault=o.lastFault||{};root.innerHTML=`<div class="panel section-head"><h2>Power stage</h2><p><span class="status-chip ${m.driverFault?"bad":m.driverEnabled?"ok":"warn"}">${esc(o.state||m.outputBackend)}</span> ${esc(m.outputBackend||"")}</p></div><div class="settings-grid"><div class="panel"><h3>Phase vectors</h3>${svg}</div><div class="panel"><h3>Lifecycle counters</h3><p>Successful enables: ${Number(metrics.successfulEnables||0)} / ${Number(metrics.enableAttempts||0)}</p><p>Faults: ${Number(metrics.faultCount||0)} total, ${Number(metrics.wakeFaultCount||0)} during wake, ${Number(metrics.runningFaultCount||0)} while running.</p></div></div><div class="panel"><h3>Live modulation</h3><div style="overflow:auto"><table><thead><tr><th>Channel</th><th>Target phase</th><th>Applied phase</th><th>Target gain</th><th>Applied gain</th><th>Headroom</th><th>Clips</th></tr></thead><tbody>${rows}</tbody></table></div></div><div class="panel"><h3>Last driver fault</h3><p>${fault.valid?`At ${Number(fault.timestampMs)} ms; origin state ${Number(fault.originState)}, motor state ${Number(fault.motorState)}, speed ${Number(fault.speed)}, ${Number(fault.frequencyHz||0).toFixed(2)} Hz, waveform buffer ${Number(fault.bufferFillCount||0)}.`:"No driver fault snapshot recorded this boot."}</p></div>`}
+function renderPowerStage(){if(!statusData||currentTab!=="powerstage")return;const root=$("powerStageBody"),m=statusData.motor,o=m.output||{},metrics=o.metrics||{},count=Math.max(1,Math.min(4,Number(settingsData?.global?.phaseMode||o.channels?.length||3))),channels=(o.channels||[]).slice(0,count),cx=120,cy=120,r=82;const colours=["var(--accent)","var(--good)","var(--warn)","var(--danger)"];let svg=`<svg viewBox="0 0 240 240" role="img" aria-label="Applied phase vectors" style="width:min(100%,24rem);height:auto"><circle cx="${cx}" cy="${cy}" r="${r}" fill="none" stroke="var(--line)"/>`;channels.forEach((c,i)=>{const a=Number(c.appliedPhase||0)*Math.PI/180,len=r*Math.max(.1,Number(c.appliedGain||100)/150),x=cx+Math.cos(a)*len,y=cy-Math.sin(a)*len;svg+=`<line x1="${cx}" y1="${cy}" x2="${x.toFixed(1)}" y2="${y.toFixed(1)}" stroke="${colours[i]}" stroke-width="4"/><text x="${x.toFixed(1)}" y="${y.toFixed(1)}" fill="var(--text)">${String.fromCharCode(65+i)}</text>`});svg+="</svg>";const rows=channels.map((c,i)=>`<tr><th>${String.fromCharCode(65+i)}</th><td>${Number(c.targetPhase||0).toFixed(1)}°</td><td>${Number(c.appliedPhase||0).toFixed(1)}°</td><td>${Number(c.targetGain||0)}%</td><td>${Number(c.appliedGain||0).toFixed(1)}%</td><td>${Number(c.headroom||0).toFixed(1)}%</td><td>${Number(c.limiter||0)>0.05?`-${Number(c.limiter).toFixed(1)}%`:"idle"}</td><td>${Number(c.clippingCount||0)}</td></tr>`).join("");const fault=o.lastFault||{};root.innerHTML=`<div class="panel section-head"><h2>Power stage</h2><p><span class="status-chip ${m.driverFault?"bad":m.driverEnabled?"ok":"warn"}">${esc(o.state||m.outputBackend)}</span> ${esc(m.outputBackend||"")}</p></div><div class="settings-grid"><div class="panel"><h3>Phase vectors</h3>${svg}</div><div class="panel"><h3>Lifecycle counters</h3><p>Successful enables: ${Number(metrics.successfulEnables||0)} / ${Number(metrics.enableAttempts||0)}</p><p>Faults: ${Number(metrics.faultCount||0)} total, ${Number(metrics.wakeFaultCount||0)} during wake, ${Number(metrics.runningFaultCount||0)} while running.</p></div></div><div class="panel"><h3>Live modulation</h3><div style="overflow:auto"><table><thead><tr><th>Channel</th><th>Target phase</th><th>Applied phase</th><th>Target gain</th><th>Applied gain</th><th>Headroom</th><th>Limiter</th><th>Clips</th></tr></thead><tbody>${rows}</tbody></table></div></div><div class="panel"><h3>Last driver fault</h3><p>${fault.valid?`At ${Number(fault.timestampMs)} ms; origin state ${Number(fault.originState)}, motor state ${Number(fault.motorState)}, speed ${Number(fault.speed)}, ${Number(fault.frequencyHz||0).toFixed(2)} Hz, waveform buffer ${Number(fault.bufferFillCount||0)}.`:"No driver fault snapshot recorded this boot."}</p></div>`}
 function adaptOutputStatus(){
 if(!statusData)return;
 const bridge=String(statusData.motor?.outputBackend||"").toLowerCase().includes("bridge"),label=bridge?"Driver status":"Output status";
@@ -414,8 +425,8 @@ async function loadStatus(){statusData=await api("/api/status");renderStatus();r
 function startStatusStream(){if(!("EventSource" in window)){setInterval(loadStatus,1000);return}let fallback=false;const es=new EventSource("/api/events");es.addEventListener("status",e=>{try{statusData=JSON.parse(e.data);renderStatus();renderPowerStage();adaptOutputStatus()}catch(err){}});es.onerror=()=>{if(!fallback&&!telemetry.length){fallback=true;es.close();setInterval(loadStatus,1000)}}}
 async function setSpeedControl(speed){if(Number(speed)===2&&!is78Enabled()){const msg=disabled78Message();alert(msg);setLive(msg);return}await control("setSpeed",{speed:Number(speed)})}
 async function control(action,extra={}){const enteringEcoStandby=action==="toggleStandby"&&isEcoStandbyMode()&&!isStandbyActive();const result=await api("/api/control",{method:"POST",headers:{"Content-Type":"application/json"},body:JSON.stringify(Object.assign({action},extra))});addEvent(`Command ${action}`);if(result.calibration?.message)setLive(result.calibration.message);if(enteringEcoStandby){if(statusData&&statusData.motor){statusData.motor.standby=true;statusData.motor.state="STANDBY";statusData.motor.running=false}setLive("Eco standby active. Wake from the device controls to reconnect Wi-Fi.");renderStatus();return result}await loadStatus();return result}
-function currentPresetShape(){const g=settingsComparable(currentSettings(false)).global,out={pm:g.phaseMode,top:g.motorTopology,phSlew:g.phaseSlewDegreesPerSecond,gainSlew:g.gainSlewPercentPerSecond,maxAmp:g.maxAmplitude,ssCurve:g.softStartCurve,vfBlend:g.vfBlend,vfLF:g.vfLowFreq,vfLL:g.vfLowLevel,vfMF:g.vfMidFreq,vfML:g.vfMidLevel,vfBase:g.vfBaseFreq,brkMd:g.brakeMode,brkDur:g.brakeDuration,brkPG:g.brakePulseGap,brkSF:g.brakeStartFreq,brkStF:g.brakeStopFreq,brkCut:g.softStopCutoff,speeds:settingsData.speeds.map(s=>({f:s.frequency,minF:s.minFrequency,maxF:s.maxFrequency,ph:[...s.phaseOffset],gain:[...s.channelAmplitude],ssD:s.softStartDuration,rAmp:s.reducedAmplitude,aDly:s.amplitudeDelay,kick:s.startupKick,kDur:s.startupKickDuration,kRmp:s.startupKickRampDuration,fTyp:s.filterType,iir:s.iirAlpha,fir:s.firProfile}))};if(g.closedLoopEnabled!==undefined){const tune=settingsData.speeds.map(s=>({db:s.closedLoopDeadbandRpm,lock:s.closedLoopLockToleranceRpm,lockMs:s.closedLoopLockTimeMs,kp:s.closedLoopKp,ki:s.closedLoopKi,kd:s.closedLoopKd,iLim:s.closedLoopIntegralLimitHz,cLim:s.closedLoopCorrectionLimitHz,slew:s.closedLoopSlewLimitHzPerSec,rKp:s.closedLoopRampKp,rLim:s.closedLoopRampCorrectionLimitHz}));Object.assign(out,{clEn:g.closedLoopEnabled,clCtrl:g.closedLoopControlMode,clMd:g.closedLoopSensorMode,clT:[g.closedLoopTargetRpm33,g.closedLoopTargetRpm45,g.closedLoopTargetRpm78],clCpr:g.closedLoopCountsPerRev,clEdge:g.closedLoopPulseEdge,clQuad:g.closedLoopQuadratureMode,clRev:g.closedLoopReverseDirection,clDir:g.closedLoopDirectionFaultAction,clDb:g.closedLoopDebounceUs,clTo:g.closedLoopTimeoutMs,clEng:g.closedLoopEngageDelayMs,clUpd:g.closedLoopUpdateIntervalMs,clAlpha:g.closedLoopFilterAlpha,clDbnd:tune[0].db,clLock:tune[0].lock,clLockMs:tune[0].lockMs,clKp:tune[0].kp,clKi:tune[0].ki,clKd:tune[0].kd,clILim:tune[0].iLim,clCLim:tune[0].cLim,clSlew:tune[0].slew,clDrop:g.closedLoopDropoutAction,clReqSig:g.closedLoopRequireSignalBeforeEngage,clReqNear:g.closedLoopRequireNearTargetBeforeEngage,clEngTol:g.closedLoopEngageToleranceRpm,clRamp:g.closedLoopRampMode,clRampKp:tune[0].rKp,clRampLim:tune[0].rLim,clPitchMode:g.closedLoopPitchTargetMode,clTune:tune,clPitchSlew:g.closedLoopPitchSlewRpmPerSec,clPitchReset:g.closedLoopPitchResetThresholdRpm,clSatMs:g.closedLoopSaturationTimeMs,clSatAct:g.closedLoopSaturationAction,clMinRpm:g.closedLoopPlausibilityMinRpm,clMaxRpm:g.closedLoopPlausibilityMaxRpm,clPlausAct:g.closedLoopPlausibilityAction,clLockTo:g.closedLoopLockTimeoutMs,clLockAct:g.closedLoopLockTimeoutAction,clAmpRec:g.closedLoopAmpRecoveryMode,clAmpRecMs:g.closedLoopAmpRecoveryDelayMs})}return out}
-function presetPathLabel(path){const names={pm:"Phase mode",maxAmp:"Maximum amplitude",ssCurve:"Soft start curve",vfBlend:"V/f blend",vfLF:"V/f low frequency",vfLL:"V/f low level",vfMF:"V/f mid frequency",vfML:"V/f mid level",vfBase:"V/f base frequency",clEn:"Closed-loop enabled",clCtrl:"Closed-loop control mode",clMd:"Closed-loop sensor mode",clCpr:"Closed-loop counts per revolution",clEdge:"Closed-loop pulse edge",clQuad:"Closed-loop quadrature decode",clRev:"Closed-loop reverse direction",clDir:"Closed-loop direction fault",clDb:"Closed-loop debounce",clTo:"Closed-loop timeout",clEng:"Closed-loop engage delay",clUpd:"Closed-loop update interval",clAlpha:"Closed-loop filter alpha",clDbnd:"Closed-loop deadband",clLock:"Closed-loop lock tolerance",clLockMs:"Closed-loop lock time",clKp:"Closed-loop Kp",clKi:"Closed-loop Ki",clKd:"Closed-loop Kd",clILim:"Closed-loop integral limit",clCLim:"Closed-loop correction limit",clSlew:"Closed-loop slew limit",clDrop:"Closed-loop dropout action",clReqSig:"Closed-loop require signal",clReqNear:"Closed-loop require near target",clEngTol:"Closed-loop engage tolerance",clRamp:"Closed-loop ramp correction",clRampKp:"Closed-loop ramp Kp",clRampLim:"Closed-loop ramp correction limit",clPitchMode:"Closed-loop pitch target mode",clPitchSlew:"Closed-loop pitch target slew",clPitchReset:"Closed-loop pitch reset threshold",clSatMs:"Closed-loop saturation time",clSatAct:"Closed-loop saturation action",clMinRpm:"Closed-loop minimum plausible RPM",clMaxRpm:"Closed-loop maximum plausible RPM",clPlausAct:"Closed-loop plausibility action",clLockTo:"Closed-loop lock timeout",clLockAct:"Closed-loop lock timeout action",clAmpRec:"Closed-loop amplitude recovery",clAmpRecMs:"Closed-loop amplitude recovery delay",brkMd:"Brake mode",brkDur:"Brake duration",brkPG:"Brake pulse gap",brkSF:"Brake start frequency",brkStF:"Brake stop frequency",brkCut:"Soft stop cutoff",f:"Frequency",minF:"Minimum frequency",maxF:"Maximum frequency",ssD:"Soft start duration",rAmp:"Reduced amplitude",aDly:"Amplitude delay",kick:"Startup kick",kDur:"Startup kick duration",kRmp:"Startup kick ramp",fTyp:"Filter type",iir:"IIR alpha",fir:"FIR profile"};const p=path.split(".");if(p[0]==="clT")return `${speedNames[Number(p[1])]} target RPM`;if(p[0]==="speeds"){if(p[2]==="ph")return `${speedNames[Number(p[1])]} phase ${Number(p[3])+1} offset`;return `${speedNames[Number(p[1])]} ${names[p[2]]||p[2]}`}return names[path]||path}
+function currentPresetShape(){const g=settingsComparable(currentSettings(false)).global,out={pm:g.phaseMode,top:g.motorTopology,phSlew:g.phaseSlewDegreesPerSecond,gainSlew:g.gainSlewPercentPerSecond,maxAmp:g.maxAmplitude,ssCurve:g.softStartCurve,vfBlend:g.vfBlend,vfLF:g.vfLowFreq,vfLL:g.vfLowLevel,vfMF:g.vfMidFreq,vfML:g.vfMidLevel,vfBase:g.vfBaseFreq,thEn:g.thermalDerateEnabled,thWTau:g.thermalWindingTauSec,thFTau:g.thermalFrameTauSec,thRise:g.thermalFullScaleRiseC,thShare:g.thermalWindingShare,thStart:g.thermalDerateStartC,thLimit:g.thermalDerateLimitC,thMin:g.thermalMinDerate,brkMd:g.brakeMode,brkDur:g.brakeDuration,brkPG:g.brakePulseGap,brkSF:g.brakeStartFreq,brkStF:g.brakeStopFreq,brkCut:g.softStopCutoff,speeds:settingsData.speeds.map(s=>({f:s.frequency,minF:s.minFrequency,maxF:s.maxFrequency,ph:[...s.phaseOffset],gain:[...s.channelAmplitude],ssD:s.softStartDuration,rAmp:s.reducedAmplitude,aDly:s.amplitudeDelay,kick:s.startupKick,kDur:s.startupKickDuration,kRmp:s.startupKickRampDuration,fTyp:s.filterType,iir:s.iirAlpha,fir:s.firProfile}))};if(g.bridgeDeadTimeLagDeg33!==undefined)out.dtLag=[g.bridgeDeadTimeLagDeg33,g.bridgeDeadTimeLagDeg45,g.bridgeDeadTimeLagDeg78];if(g.firCutoffHz33!==undefined){out.firCut=[g.firCutoffHz33,g.firCutoffHz45,g.firCutoffHz78];out.firTw=[g.firTransitionHz33,g.firTransitionHz45,g.firTransitionHz78];out.firTaps=[g.firTaps33,g.firTaps45,g.firTaps78]}if(g.closedLoopEnabled!==undefined){const tune=settingsData.speeds.map(s=>({db:s.closedLoopDeadbandRpm,lock:s.closedLoopLockToleranceRpm,lockMs:s.closedLoopLockTimeMs,kp:s.closedLoopKp,ki:s.closedLoopKi,kd:s.closedLoopKd,iLim:s.closedLoopIntegralLimitHz,cLim:s.closedLoopCorrectionLimitHz,slew:s.closedLoopSlewLimitHzPerSec,rKp:s.closedLoopRampKp,rLim:s.closedLoopRampCorrectionLimitHz}));Object.assign(out,{clEn:g.closedLoopEnabled,clCtrl:g.closedLoopControlMode,clMd:g.closedLoopSensorMode,clT:[g.closedLoopTargetRpm33,g.closedLoopTargetRpm45,g.closedLoopTargetRpm78],clCpr:g.closedLoopCountsPerRev,clEdge:g.closedLoopPulseEdge,clQuad:g.closedLoopQuadratureMode,clRev:g.closedLoopReverseDirection,clDir:g.closedLoopDirectionFaultAction,clDb:g.closedLoopDebounceUs,clTo:g.closedLoopTimeoutMs,clEng:g.closedLoopEngageDelayMs,clUpd:g.closedLoopUpdateIntervalMs,clAlpha:g.closedLoopFilterAlpha,clDbnd:tune[0].db,clLock:tune[0].lock,clLockMs:tune[0].lockMs,clKp:tune[0].kp,clKi:tune[0].ki,clKd:tune[0].kd,clILim:tune[0].iLim,clCLim:tune[0].cLim,clSlew:tune[0].slew,clDrop:g.closedLoopDropoutAction,clReqSig:g.closedLoopRequireSignalBeforeEngage,clReqNear:g.closedLoopRequireNearTargetBeforeEngage,clEngTol:g.closedLoopEngageToleranceRpm,clRamp:g.closedLoopRampMode,clRampKp:tune[0].rKp,clRampLim:tune[0].rLim,clPitchMode:g.closedLoopPitchTargetMode,clTune:tune,clPitchSlew:g.closedLoopPitchSlewRpmPerSec,clPitchReset:g.closedLoopPitchResetThresholdRpm,clSatMs:g.closedLoopSaturationTimeMs,clSatAct:g.closedLoopSaturationAction,clMinRpm:g.closedLoopPlausibilityMinRpm,clMaxRpm:g.closedLoopPlausibilityMaxRpm,clPlausAct:g.closedLoopPlausibilityAction,clLockTo:g.closedLoopLockTimeoutMs,clLockAct:g.closedLoopLockTimeoutAction,clAmpRec:g.closedLoopAmpRecoveryMode,clAmpRecMs:g.closedLoopAmpRecoveryDelayMs,clSlipAct:g.closedLoopSlipAction,clSlipMs:g.closedLoopSlipDetectMs,clSlipPct:g.closedLoopSlipThresholdPercent,clPullPct:g.closedLoopPullOutThresholdPercent,clNotch:g.closedLoopNotchEnabled,clNotchBw:g.closedLoopNotchBandwidthHz,clNotchMin:g.closedLoopNotchMinHz,clNotchMax:g.closedLoopNotchMaxHz,ldEn:g.loadStepEnabled,ldSlope:g.loadStepSlopeRpmPerSec,ldBoost:g.loadStepBoostPercent,ldBoostMs:g.loadStepBoostMs,akEn:g.adaptiveKickEnabled,akPull:g.kickPullInPercent,blEn:g.baseLearnEnabled})}return out}
+function presetPathLabel(path){const names={pm:"Phase mode",maxAmp:"Maximum amplitude",ssCurve:"Soft start curve",vfBlend:"V/f blend",vfLF:"V/f low frequency",vfLL:"V/f low level",vfMF:"V/f mid frequency",vfML:"V/f mid level",vfBase:"V/f base frequency",clEn:"Closed-loop enabled",clCtrl:"Closed-loop control mode",clMd:"Closed-loop sensor mode",clCpr:"Closed-loop counts per revolution",clEdge:"Closed-loop pulse edge",clQuad:"Closed-loop quadrature decode",clRev:"Closed-loop reverse direction",clDir:"Closed-loop direction fault",clDb:"Closed-loop debounce",clTo:"Closed-loop timeout",clEng:"Closed-loop engage delay",clUpd:"Closed-loop update interval",clAlpha:"Closed-loop filter alpha",clDbnd:"Closed-loop deadband",clLock:"Closed-loop lock tolerance",clLockMs:"Closed-loop lock time",clKp:"Closed-loop Kp",clKi:"Closed-loop Ki",clKd:"Closed-loop Kd",clILim:"Closed-loop integral limit",clCLim:"Closed-loop correction limit",clSlew:"Closed-loop slew limit",clDrop:"Closed-loop dropout action",clReqSig:"Closed-loop require signal",clReqNear:"Closed-loop require near target",clEngTol:"Closed-loop engage tolerance",clRamp:"Closed-loop ramp correction",clRampKp:"Closed-loop ramp Kp",clRampLim:"Closed-loop ramp correction limit",clPitchMode:"Closed-loop pitch target mode",clPitchSlew:"Closed-loop pitch target slew",clPitchReset:"Closed-loop pitch reset threshold",clSatMs:"Closed-loop saturation time",clSatAct:"Closed-loop saturation action",clMinRpm:"Closed-loop minimum plausible RPM",clMaxRpm:"Closed-loop maximum plausible RPM",clPlausAct:"Closed-loop plausibility action",clLockTo:"Closed-loop lock timeout",clLockAct:"Closed-loop lock timeout action",clAmpRec:"Closed-loop amplitude recovery",clAmpRecMs:"Closed-loop amplitude recovery delay",clNotch:"Closed-loop adaptive notch",clNotchBw:"Closed-loop notch width",clNotchMin:"Closed-loop notch search from",clNotchMax:"Closed-loop notch search to",ldEn:"Needle-drop feed-forward",ldSlope:"Needle-drop slope threshold",ldBoost:"Needle-drop drive boost",ldBoostMs:"Needle-drop boost time",akEn:"Adaptive startup kick",akPull:"Startup kick pull-in point",blEn:"Base frequency learning",brkMd:"Brake mode",brkDur:"Brake duration",brkPG:"Brake pulse gap",brkSF:"Brake start frequency",brkStF:"Brake stop frequency",brkCut:"Soft stop cutoff",f:"Frequency",minF:"Minimum frequency",maxF:"Maximum frequency",ssD:"Soft start duration",rAmp:"Reduced amplitude",aDly:"Amplitude delay",kick:"Startup kick",kDur:"Startup kick duration",kRmp:"Startup kick ramp",fTyp:"Filter type",iir:"IIR alpha",fir:"FIR profile"};const p=path.split(".");if(p[0]==="clT")return `${speedNames[Number(p[1])]} target RPM`;if(p[0]==="dtLag")return `${speedNames[Number(p[1])]} dead-time current lag`;if(p[0]==="firCut")return `${speedNames[Number(p[1])]} FIR cutoff`;if(p[0]==="firTw")return `${speedNames[Number(p[1])]} FIR transition width`;if(p[0]==="firTaps")return `${speedNames[Number(p[1])]} FIR tap budget`;if(p[0]==="speeds"){if(p[2]==="ph")return `${speedNames[Number(p[1])]} phase ${Number(p[3])+1} offset`;return `${speedNames[Number(p[1])]} ${names[p[2]]||p[2]}`}return names[path]||path}
 function renderPresetDiff(slot,title,d,report=null){const box=$(`presetPreview${slot}`);if(!box)return;box.classList.remove("hide");const diffText=d&&d.length?d.slice(0,36).map(x=>`${presetPathLabel(x.path)}: ${displayValue(x.path,x.from)} -> ${displayValue(x.path,x.to)}`).join("\n")+(d.length>36?`\n${d.length-36} more changes.`:""):"No differences from current motor settings.";if(report){renderReport(box,title,report,`<h4>Previewed changes</h4><pre>${esc(diffText)}</pre>`);return}box.textContent=`${title}\n${diffText}`}
 function mergePresetShape(base,patch){const out=clone(base);function merge(a,b){Object.keys(b||{}).forEach(k=>{if(b[k]&&typeof b[k]==="object"&&!Array.isArray(b[k])){a[k]=a[k]||{};merge(a[k],b[k])}else a[k]=b[k]})}merge(out,patch);return out}
 async function previewPreset(slot,sourceText=null,title="Preset load preview"){const box=$(`presetPreview${slot}`);let json=sourceText;if(!json){try{const res=await api("/api/preset",{method:"POST",headers:{"Content-Type":"application/json"},body:JSON.stringify({slot,action:"export"})});json=res.json}catch(e){if(box){box.classList.remove("hide");box.textContent=e.message}setLive(e.message);return null}}let parsed;try{parsed=JSON.parse(json)}catch(e){if(box){box.classList.remove("hide");box.innerHTML=`<h3>${esc(title)}</h3><div class="report-item report-error"><strong>Error:</strong> Preset JSON is not valid.</div>`}return null}const report=validatePresetImportObject(parsed),current=currentPresetShape(),target=sourceText?mergePresetShape(current,parsed):parsed,d=diffs(current,target);renderPresetDiff(slot,title,d,report);return{diff:d,report}}
@@ -423,19 +434,19 @@ async function loadPresets(){presetsData=await api("/api/presets");fillPresetCom
 async function presetAction(slot,action){let body={slot,action};if(action==="preview"){await previewPreset(slot);return}if(action==="previewImport"){await previewPreset(slot,$(`presetText${slot}`).value,"Import validation report");return}if(action==="load"){const r=await previewPreset(slot);if(!r||r.report.errors||!confirm("Load this preset into the live settings?"))return}if(action==="rename")body.name=$(`presetName${slot}`).value;if(action==="import"){const r=await previewPreset(slot,$(`presetText${slot}`).value,"Import validation report");if(!r||r.report.errors){setLive("Fix preset import errors before importing");return}if(!confirm(`Import this JSON into the preset slot?\n\n${r.report.warnings} warning${r.report.warnings===1?"":"s"} will be accepted.`))return;body.json=$(`presetText${slot}`).value}if(action==="clear"&&!confirm("Clear this preset?"))return;const res=await api("/api/preset",{method:"POST",headers:{"Content-Type":"application/json"},body:JSON.stringify(body)});if(action==="export")$(`presetText${slot}`).value=res.json||"";await loadPresets();await loadSettings();setLive("Preset action complete")}
 function fillPresetCompare(){["compareA","compareB"].forEach(id=>{const el=$(id);if(!el||el.children.length)return;for(let i=0;i<5;i++){const o=document.createElement("option");o.value=i;o.textContent=`Slot ${i+1}`;el.appendChild(o)}});if($("compareB"))$("compareB").value="1"}
 async function comparePresetSlots(){const a=Number($("compareA").value),b=Number($("compareB").value),box=$("presetCompare");try{const ja=JSON.parse((await api("/api/preset",{method:"POST",headers:{"Content-Type":"application/json"},body:JSON.stringify({slot:a,action:"export"})})).json),jb=JSON.parse((await api("/api/preset",{method:"POST",headers:{"Content-Type":"application/json"},body:JSON.stringify({slot:b,action:"export"})})).json),d=diffs(ja,jb);box.classList.remove("hide");box.textContent=d.length?d.map(x=>`${presetPathLabel(x.path)}: ${displayValue(x.path,x.from)} -> ${displayValue(x.path,x.to)}`).join("\n"):"Preset slots match."}catch(e){box.classList.remove("hide");box.textContent=e.message}}
-async function loadDiagnostics(){const d=await api("/api/diagnostics");diagnosticsData=d;const sys=d.system||{},cpu=sys.cpu||{},mem=sys.memory||{},flash=sys.flash||{},wave=sys.waveform||{},disp=d.display||{},body=$("diagnosticsBody");body.innerHTML=`<h2>Diagnostics</h2><div class="tool-grid"><div><h3>Build</h3><p>Firmware: ${esc(d.firmware)}</p><p>Build: ${esc(d.buildDate)}</p><p>Safe mode: ${d.safeMode?"yes":"no"}</p><p>Display: ${esc(disp.driver||"unknown")} via ${esc(disp.transport||"unknown")} / ${esc(disp.wiringProfile||"unknown")}, ${Number(disp.width||0)}x${Number(disp.height||0)}, ${disp.available?(disp.powered?"on":"sleeping"):disp.driver==="Headless"?"headless":"unavailable"}</p><p>Display capabilities: panel ${disp.physicalPanel?"yes":"no"}, power ${disp.powerControl?"yes":"no"}, brightness ${disp.brightnessControl?"yes":"no"}, colour ${disp.colourPanel?"yes":"no"}</p></div><div><h3>System</h3><p>CPU: core 0 ${Number(cpu.core0Percent||0).toFixed(0)}%, waveform ${Number(cpu.waveformPercent||0).toFixed(0)}%</p><p>Waveform: fill age ${Number(wave.bufferFillAgeMs||0)} ms, DMA ${wave.dmaRunning?"running":"idle"}</p><p>Heap: ${bytesText(mem.heapUsedBytes)} used, ${bytesText(mem.heapFreeBytes)} free</p><p>Sketch: ${bytesText(flash.sketchUsedBytes)} / ${bytesText(flash.sketchCapacityBytes)}</p><p>Filesystem: ${flash.filesystemMounted?`${bytesText(flash.filesystemUsedBytes)} / ${bytesText(flash.filesystemTotalBytes)}`:"not mounted"}</p></div><div><h3>Network</h3><p>${esc(d.network.status)} ${esc(d.network.ip||"")}</p><p>RSSI: ${d.network.rssi} dBm</p><p>Clients: ${d.network.clients}</p><p>Standby: ${esc(d.network.standbyModeText||optionLabel("standbyMode",d.network.standbyMode??0))}${d.network.ecoStandbySuspended?" (Wi-Fi suspended)":""}</p><p>Read-only mode: ${d.network.readOnlyMode?"on":"off"}</p><p>Device lock: ${d.network.deviceLockEnabled?"on":"off"}</p></div><div><h3>Amplifier</h3><p>${d.amp.enabled?`${Number(d.amp.temperatureC).toFixed(1)} C, thermal ${d.amp.thermalOk?"OK":"TRIPPED"}, warn ${Number(d.amp.warnC).toFixed(0)} C, shutdown ${Number(d.amp.shutdownC).toFixed(0)} C`:"not enabled"}</p></div></div><h3>Feature flags</h3><div class="log">${Object.keys(d.flags).map(k=>`${k}: ${d.flags[k]}`).join("\n")}</div><h3>Pins</h3><div class="log">${Object.keys(d.pins).map(k=>`${k}: GP${d.pins[k]}`).join("\n")}</div><h3>Files</h3><div class="log">settings: ${d.files.settings}\nknown-good: ${d.files.knownGood}\nboot marker: ${d.files.bootMarker}\nnetwork: ${d.files.network}\nerrors: ${d.files.errors}\npresets: ${d.files.presets.map(p=>`slot ${p.slot+1}=${p.stored}`).join(", ")}</div>`;renderEventFeed();renderBench()}
+async function loadDiagnostics(){const d=await api("/api/diagnostics");diagnosticsData=d;const sys=d.system||{},cpu=sys.cpu||{},mem=sys.memory||{},flash=sys.flash||{},wave=sys.waveform||{},disp=d.display||{},body=$("diagnosticsBody");body.innerHTML=`<h2>Diagnostics</h2><div class="tool-grid"><div><h3>Build</h3><p>Firmware: ${esc(d.firmware)}</p><p>Build: ${esc(d.buildDate)}</p><p>Safe mode: ${d.safeMode?"yes":"no"}</p><p>Display: ${esc(disp.driver||"unknown")} via ${esc(disp.transport||"unknown")} / ${esc(disp.wiringProfile||"unknown")}, ${Number(disp.width||0)}x${Number(disp.height||0)}, ${disp.available?(disp.powered?"on":"sleeping"):disp.driver==="Headless"?"headless":"unavailable"}</p><p>Display capabilities: panel ${disp.physicalPanel?"yes":"no"}, power ${disp.powerControl?"yes":"no"}, brightness ${disp.brightnessControl?"yes":"no"}, colour ${disp.colourPanel?"yes":"no"}</p></div><div><h3>System</h3><p>CPU: core 0 ${Number(cpu.core0Percent||0).toFixed(0)}%, waveform ${Number(cpu.waveformPercent||0).toFixed(0)}%</p><p>Waveform: fill age ${Number(wave.bufferFillAgeMs||0)} ms, DMA ${wave.dmaRunning?"running":"idle"}</p><p>Heap: ${bytesText(mem.heapUsedBytes)} used, ${bytesText(mem.heapFreeBytes)} free</p><p>Sketch: ${bytesText(flash.sketchUsedBytes)} / ${bytesText(flash.sketchCapacityBytes)}</p><p>Filesystem: ${flash.filesystemMounted?`${bytesText(flash.filesystemUsedBytes)} / ${bytesText(flash.filesystemTotalBytes)}`:"not mounted"}</p></div><div><h3>Network</h3><p>${esc(d.network.status)} ${esc(d.network.ip||"")}</p><p>RSSI: ${d.network.rssi} dBm</p><p>Clients: ${d.network.clients}</p><p>Standby: ${esc(d.network.standbyModeText||optionLabel("standbyMode",d.network.standbyMode??0))}${d.network.ecoStandbySuspended?" (Wi-Fi suspended)":""}</p><p>Read-only mode: ${d.network.readOnlyMode?"on":"off"}</p><p>Device lock: ${d.network.deviceLockEnabled?"on":"off"}</p></div><div><h3>Amplifier</h3><p>${d.amp.enabled?`${Number(d.amp.temperatureC).toFixed(1)} C, thermal ${d.amp.thermalOk?"OK":"TRIPPED"}, warn ${Number(d.amp.warnC).toFixed(0)} C, shutdown ${Number(d.amp.shutdownC).toFixed(0)} C`:"not enabled"}</p></div>${d.tachDuty?`<div><h3>Tach pulses</h3><p>${d.tachDuty.tracked?esc(pulseDutyText(d.tachDuty)):"Duty is tracked in pulse mode only"}</p></div>`:""}</div><h3>Feature flags</h3><div class="log">${Object.keys(d.flags).map(k=>`${k}: ${d.flags[k]}`).join("\n")}</div><h3>Pins</h3><div class="log">${Object.keys(d.pins).map(k=>`${k}: GP${d.pins[k]}`).join("\n")}</div><h3>Files</h3><div class="log">settings: ${d.files.settings}\nknown-good: ${d.files.knownGood}\nboot marker: ${d.files.bootMarker}\nnetwork: ${d.files.network}\nerrors: ${d.files.errors}\npresets: ${d.files.presets.map(p=>`slot ${p.slot+1}=${p.stored}`).join(", ")}</div>`;renderEventFeed();renderBench()}
 function relayStageOptions(){const count=Math.max(0,Number(statusData?.motor?.relayStageCount||0));let out="";for(let i=0;i<count;i++)out+=`<option value="${i}">Stage ${i}</option>`;return out}
 function benchReportText(){
 const m=statusData?.motor||{},n=statusData?.network||{},a=statusData?.amp||{},d=diagnosticsData,clObj=m.closedLoop||{},cl=closedLoopStatusText(clObj),met=clObj.metrics||{},tune=clObj.tuning||{},health=clObj.health||{},trend=clObj.trend||[],lastTrend=trend[trend.length-1]||{},lockPct=met.validSamples?Math.round((met.lockedSamples||0)*100/met.validSamples):0;
-return[`TT Control bench report`,new Date().toISOString(),`State: ${m.state||"-"}`,`Speed: ${speedNames[m.speed]||m.speedName||"-"}`,`Frequency: ${m.frequency!==undefined?m.frequency.toFixed(2):"-"} Hz`,`Pitch: ${m.pitch!==undefined?m.pitch.toFixed(2):"-"}%`,`Closed loop: ${cl}`,`Closed-loop pitch target: ${optionLabel("closedLoopPitchTargetMode",clObj.pitchTargetMode)} reference ${Number(clObj.referenceTargetRpm||0).toFixed(3)} RPM, offset ${Number(clObj.pitchOffsetRpm||0).toFixed(3)} RPM`,`Closed-loop tuning: ${tune.stepName||"Idle"} - ${tune.recommendation||"-"}`,`Closed-loop stability: lock ${lockPct}%, avg abs ${Number(met.averageAbsErrorRpm||0).toFixed(3)} RPM, peak ${Number(met.peakAbsErrorRpm||0).toFixed(3)} RPM`,`Closed-loop events: ${Number(met.dropoutEvents||0)} dropouts, ${Number(met.saturationEvents||0)} saturation, ${Number(met.directionFaultEvents||0)} direction, ${Number(met.plausibilityEvents||0)} plausibility`,`Sensor health: accepted ${Number(health.acceptedTransitions||0)} of ${Number(health.totalTransitions||0)}, invalid ${Number(health.invalidTransitionPercent||0).toFixed(1)}%, debounced ${Number(health.debouncedTransitionPercent||0).toFixed(1)}%, jitter ${Number(health.averageJitterPercent||0).toFixed(2)}%`,`Trend: ${trend.length} samples${trend.length?`, latest error ${Number(lastTrend.errorRpm||0).toFixed(3)} RPM, correction ${Number(lastTrend.correctionHz||0).toFixed(3)} Hz`:""}`,`Relay test: ${m.relayTest?"on":"off"} stage ${m.relayStage??"-"}`,`Amp: ${a.enabled?(Number(a.temperatureC).toFixed(1)+" C, thermal "+(a.thermalOk?"OK":"TRIPPED")):"not enabled"}`,`Network: ${n.status||"-"} ${n.ip||""}`,d?`Firmware: ${d.firmware} ${d.buildDate}`:"Firmware: not loaded",d?`Pins: ${Object.keys(d.pins).map(k=>`${k}=GP${d.pins[k]}`).join(", ")}`:"Pins: not loaded"].join("\n")}
+return[`TT Control bench report`,new Date().toISOString(),`State: ${m.state||"-"}`,`Speed: ${speedNames[m.speed]||m.speedName||"-"}`,`Frequency: ${m.frequency!==undefined?m.frequency.toFixed(2):"-"} Hz`,`Pitch: ${m.pitch!==undefined?m.pitch.toFixed(2):"-"}%`,`Closed loop: ${cl}`,`Closed-loop pitch target: ${optionLabel("closedLoopPitchTargetMode",clObj.pitchTargetMode)} reference ${Number(clObj.referenceTargetRpm||0).toFixed(3)} RPM, offset ${Number(clObj.pitchOffsetRpm||0).toFixed(3)} RPM`,`Closed-loop tuning: ${tune.stepName||"Idle"} - ${tune.recommendation||"-"}`,`Closed-loop stability: lock ${lockPct}%, avg abs ${Number(met.averageAbsErrorRpm||0).toFixed(3)} RPM, peak ${Number(met.peakAbsErrorRpm||0).toFixed(3)} RPM`,`Closed-loop events: ${Number(met.dropoutEvents||0)} dropouts, ${Number(met.saturationEvents||0)} saturation, ${Number(met.directionFaultEvents||0)} direction, ${Number(met.plausibilityEvents||0)} plausibility, ${Number(met.slipEvents||0)} slip, ${Number(met.pullOutEvents||0)} pull-out`,`Closed-loop slip: last ${Number(met.lastSlipPercent||0).toFixed(2)}%, avg ${Number(met.averageSlipPercent||0).toFixed(2)}%, peak ${Number(met.peakSlipPercent||0).toFixed(2)}%, ratio ${Number(met.slipRatioRpmPerHz||0).toFixed(5)} RPM/Hz`,`Sensor health: accepted ${Number(health.acceptedTransitions||0)} of ${Number(health.totalTransitions||0)}, invalid ${Number(health.invalidTransitionPercent||0).toFixed(1)}%, debounced ${Number(health.debouncedTransitionPercent||0).toFixed(1)}%, jitter ${Number(health.averageJitterPercent||0).toFixed(2)}%`,`Trend: ${trend.length} samples${trend.length?`, latest error ${Number(lastTrend.errorRpm||0).toFixed(3)} RPM, correction ${Number(lastTrend.correctionHz||0).toFixed(3)} Hz`:""}`,`Relay test: ${m.relayTest?"on":"off"} stage ${m.relayStage??"-"}`,`Amp: ${a.enabled?(Number(a.temperatureC).toFixed(1)+" C, thermal "+(a.thermalOk?"OK":"TRIPPED")):"not enabled"}`,`Network: ${n.status||"-"} ${n.ip||""}`,d?`Firmware: ${d.firmware} ${d.buildDate}`:"Firmware: not loaded",d?`Pins: ${Object.keys(d.pins).map(k=>`${k}=GP${d.pins[k]}`).join(", ")}`:"Pins: not loaded"].join("\n")}
 function renderBench(){
 const root=$("benchBody");
 if(!root||currentTab!=="bench")return;
 if(root.contains(document.activeElement))return;
-const m=statusData?.motor||{},a=statusData?.amp||{},ampText=a.enabled?`${Number(a.temperatureC).toFixed(1)} C, ${a.thermalOk?"OK":"TRIPPED"}`:"not enabled",cl=m.closedLoop||{},setup=cl.setup||{},clTile=closedLoopTileHtml(cl);
+const m=statusData?.motor||{},a=statusData?.amp||{},ampText=a.enabled?`${Number(a.temperatureC).toFixed(1)} C, ${a.thermalOk?"OK":"TRIPPED"}`:"not enabled",cl=m.closedLoop||{},setup=cl.setup||{},coast=cl.coastDown||{},clTile=closedLoopTileHtml(cl);
 const metrics=cl.metrics||{},tune=cl.tuning||{},health=cl.health||{},trend=cl.trend||[],lastTrend=trend[trend.length-1]||{},lockPct=metrics.validSamples?Math.round((metrics.lockedSamples||0)*100/metrics.validSamples):0;
-const clSetupCard=cl.compiled?`<div class="bench-card"><h3>Closed-loop setup</h3><p>Status: ${esc(cl.enabled?closedLoopStatusText(cl):"off")}</p><p>Pitch target: ${esc(optionLabel("closedLoopPitchTargetMode",cl.pitchTargetMode))}, reference ${Number(cl.referenceTargetRpm||0).toFixed(3)} RPM, offset ${Number(cl.pitchOffsetRpm||0).toFixed(3)} RPM</p><p>Setup: ${setup.active?`${Number(setup.countDelta||0)} counts, ${Number(setup.invalidDelta||0)} invalid, ${Number(setup.debouncedDelta||0)} debounced`:"idle"}</p><p>Suggested counts/rev: ${Number(setup.suggestedCountsPerRev||0)}</p><p>Pins: A ${setup.pinAHigh?"high":"low"}, B ${setup.pinBHigh?"high":"low"}</p><p>Tune: ${esc(tune.stepName||"Idle")} - ${esc(tune.recommendation||"-")}</p><p>Stability: lock ${lockPct}%, avg ${Number(metrics.averageAbsErrorRpm||0).toFixed(3)} RPM, peak ${Number(metrics.peakAbsErrorRpm||0).toFixed(3)} RPM, correction ${Number(metrics.averageCorrectionHz||0).toFixed(3)} Hz</p><p>Events: ${Number(metrics.dropoutEvents||0)} dropouts, ${Number(metrics.saturationEvents||0)} saturation</p><p>Sensor: ${Number(health.acceptedTransitions||0)} accepted, invalid ${Number(health.invalidTransitionPercent||0).toFixed(1)}%, debounced ${Number(health.debouncedTransitionPercent||0).toFixed(1)}%, jitter ${Number(health.averageJitterPercent||0).toFixed(2)}%</p><p>Trend: ${trend.length} samples${trend.length?`, error ${Number(lastTrend.errorRpm||0).toFixed(3)} RPM, correction ${Number(lastTrend.correctionHz||0).toFixed(3)} Hz`:""}</p><div class="button-row"><button data-bench="closedLoopReset">Reset controller</button><button data-bench="closedLoopSetupStart">Start setup</button><button data-bench="closedLoopSetupApply">Apply setup</button><button data-bench="closedLoopSetupStop">Stop setup</button><button data-bench="closedLoopTuneStart">Tune start</button><button data-bench="closedLoopTuneNext">Tune next</button><button data-bench="closedLoopTuneApply"${tune.canApplyRecommendation?"":" disabled"}>Tune apply</button><button data-bench="closedLoopTuneStop">Tune stop</button><button data-bench="closedLoopBasePreview">Preview base</button><button data-bench="closedLoopBaseApply">Apply base</button><button data-bench="closedLoopBaseSave">Save base</button></div></div>`:"";
-root.innerHTML=`<div class="panel section-head"><h2>Bench test</h2><div class="dash-grid"><div class="dash-tile"><span>Motor state</span><strong>${esc(m.state||"-")}</strong></div><div class="dash-tile"><span>Relay test</span><strong>${m.relayTest?"On":"Off"}</strong></div><div class="dash-tile"><span>Amplifier</span><strong>${esc(ampText)}</strong></div>${clTile}</div></div><div class="bench-grid"><div class="bench-card"><h3>Pre-check</h3><div class="button-row"><button id="benchRefresh">Refresh diagnostics</button><button class="danger" data-bench="emergencyStop">Emergency stop</button><button data-bench="stop">Stop</button></div><p>Safe mode: ${diagnosticsData?.safeMode?"yes":"no"}</p><p>Network: ${esc(statusData?.network?.status||"-")} ${esc(statusData?.network?.ip||"")}</p></div><div class="bench-card"><h3>Relay outputs</h3><div class="field"><label for="benchRelayStage">Relay output</label><select id="benchRelayStage">${relayStageOptions()}</select></div><div class="button-row"><button data-bench="relayTest">Set output</button><button data-bench="relayOff">All off</button></div></div><div class="bench-card"><h3>Brake test</h3><div class="button-row"><button class="good" data-bench="start">Start motor</button><button class="danger" data-bench="stop">Brake stop</button><button class="danger" data-bench="emergencyStop">Emergency stop</button></div></div><div class="bench-card"><h3>Speed and pitch</h3><div class="button-row"><button data-bench-speed="0">33 RPM</button><button data-bench-speed="1">45 RPM</button><button data-bench-speed="2">78 RPM</button><button data-bench="resetPitch">Reset pitch</button></div><div class="field"><label for="benchPitch">Pitch percent</label><input id="benchPitch" type="number" min="-50" max="50" step="0.1" value="${m.pitch!==undefined?Number(m.pitch).toFixed(1):"0"}"></div><button id="benchSetPitch">Set pitch</button></div>${clSetupCard}<div class="bench-card"><h3>Report</h3><div class="button-row"><button id="benchMakeReport">Generate report</button></div><textarea id="benchReport" aria-label="Bench test report">${esc(benchReportText())}</textarea></div></div>`;
+const clSetupCard=cl.compiled?`<div class="bench-card"><h3>Closed-loop setup</h3><p>Status: ${esc(cl.enabled?closedLoopStatusText(cl):"off")}</p><p>Pitch target: ${esc(optionLabel("closedLoopPitchTargetMode",cl.pitchTargetMode))}, reference ${Number(cl.referenceTargetRpm||0).toFixed(3)} RPM, offset ${Number(cl.pitchOffsetRpm||0).toFixed(3)} RPM</p><p>Setup: ${setup.active?`${Number(setup.countDelta||0)} counts, ${Number(setup.invalidDelta||0)} invalid, ${Number(setup.debouncedDelta||0)} debounced`:"idle"}</p>${setup.autoDetect?`<p>Auto detect: ${esc(setup.autoMessage||"-")} (${Number(setup.autoProgressPercent||0)}%), expected ${Number(setup.autoExpectedCountsPerRev||0).toFixed(1)}, detected ${Number(setup.autoDetectedCountsPerRev||0)}, confidence ${Math.round(Number(setup.autoConfidence||0)*100)}%</p>`:""}<p>Suggested counts/rev: ${Number(setup.suggestedCountsPerRev||0)}</p><p>Pins: A ${setup.pinAHigh?"high":"low"}, B ${setup.pinBHigh?"high":"low"}</p><p>Tune: ${esc(tune.stepName||"Idle")} - ${esc(tune.recommendation||"-")}</p><p>Stability: lock ${lockPct}%, avg ${Number(metrics.averageAbsErrorRpm||0).toFixed(3)} RPM, peak ${Number(metrics.peakAbsErrorRpm||0).toFixed(3)} RPM, correction ${Number(metrics.averageCorrectionHz||0).toFixed(3)} Hz</p><p>Events: ${Number(metrics.dropoutEvents||0)} dropouts, ${Number(metrics.saturationEvents||0)} saturation, ${Number(metrics.slipEvents||0)} slip, ${Number(metrics.pullOutEvents||0)} pull-out</p><p>Slip: last ${Number(metrics.lastSlipPercent||0).toFixed(2)}%, peak ${Number(metrics.peakSlipPercent||0).toFixed(2)}%</p><p>Notch: ${esc(closedLoopNotchText(cl.notch))}</p><p>Needle drop: ${esc(loadStepText(cl.loadStep))}</p><p>Startup: ${esc(startupKickText(cl.startupKick))}</p><p>Wear: ${esc(wearText(cl.wear))}</p><p>Base learning: ${esc(baseLearnText(cl.baseLearn))}</p>${cl.sensorless&&cl.sensorless.enabled?`<p>Sensorless: ${esc(sensorlessText(cl.sensorless))}</p>`:""}<p>Sensor: ${Number(health.acceptedTransitions||0)} accepted, invalid ${Number(health.invalidTransitionPercent||0).toFixed(1)}%, debounced ${Number(health.debouncedTransitionPercent||0).toFixed(1)}%, jitter ${Number(health.averageJitterPercent||0).toFixed(2)}%, window ${Number(health.debounceUs||0)} us, ${Number(health.rejectedWindows||0)} outlier windows</p>${health.duty&&health.duty.tracked?`<p>Pulse duty: ${esc(pulseDutyText(health.duty))}</p>`:""}<p>Edges by speed: ${(health.speedEdges||[]).map((x,i)=>`${esc(speedNames[i]||i)} ${Number(x.accepted||0)} accepted, ${Number(x.debounced||0)} debounced, ${Number(x.invalid||0)} invalid`).join("; ")||"none"}</p><p>Trend: ${trend.length} samples${trend.length?`, error ${Number(lastTrend.errorRpm||0).toFixed(3)} RPM, correction ${Number(lastTrend.correctionHz||0).toFixed(3)} Hz`:""}</p><p>Coast-down: ${esc(coast.message||"Idle")}${coast.active?`, ${Number(coast.sampleCount||0)} samples, ${Number(coast.lastRpm||0).toFixed(2)} RPM`:""}</p><p>Coast models: ${(coast.models||[]).map((x,i)=>`${esc(speedNames[i]||i)} ${x.valid?`${Number(x.stopSec||0).toFixed(1)} s, R2 ${Number(x.rSquared||0).toFixed(3)}`:"none"}`).join(", ")||"none"}</p><div class="button-row"><button data-bench="closedLoopReset">Reset controller</button><button data-bench="closedLoopSetupStart">Start setup</button><button data-bench="closedLoopSetupApply">Apply setup</button><button data-bench="closedLoopSetupStop">Stop setup</button><button data-bench="closedLoopTuneStart">Tune start</button><button data-bench="closedLoopTuneNext">Tune next</button><button data-bench="closedLoopTuneApply"${tune.canApplyRecommendation?"":" disabled"}>Tune apply</button><button data-bench="closedLoopTuneStop">Tune stop</button><button data-bench="closedLoopBasePreview">Preview base</button><button data-bench="closedLoopBaseApply">Apply base</button><button data-bench="closedLoopBaseSave">Save base</button><button data-bench="coastDownStart">Coast-down</button><button data-bench="coastDownStop">Stop coast</button><button data-bench="coastDownApply">Apply coast estimates</button><button data-bench="coastDownSave">Save coast estimates</button><button data-bench="loadStepClear">Forget needle drops</button><button data-bench="startupKickClear">Forget startup kick</button><button data-bench="wearClear">Forget wear history</button><button data-bench="baseLearnRollback">Undo learned base</button><button data-bench="baseLearnClear">Forget base learning</button></div></div>`:"";
+root.innerHTML=`<div class="panel section-head"><h2>Bench test</h2><div class="dash-grid"><div class="dash-tile"><span>Motor state</span><strong>${esc(m.state||"-")}</strong></div><div class="dash-tile"><span>Relay test</span><strong>${m.relayTest?"On":"Off"}</strong></div><div class="dash-tile"><span>Amplifier</span><strong>${esc(ampText)}</strong></div>${clTile}</div></div><div class="bench-grid"><div class="bench-card"><h3>Pre-check</h3><div class="button-row"><button id="benchRefresh">Refresh diagnostics</button><button class="danger" data-bench="emergencyStop">Emergency stop</button><button data-bench="stop">Stop</button></div><p>Safe mode: ${diagnosticsData?.safeMode?"yes":"no"}</p><p>Network: ${esc(statusData?.network?.status||"-")} ${esc(statusData?.network?.ip||"")}</p></div><div class="bench-card"><h3>Relay outputs</h3><div class="field"><label for="benchRelayStage">Relay output</label><select id="benchRelayStage">${relayStageOptions()}</select></div><div class="button-row"><button data-bench="relayTest">Set output</button><button data-bench="relayOff">All off</button></div></div>${offsetNullCard(m.offsetNull)}<div class="bench-card"><h3>Brake test</h3><div class="button-row"><button class="good" data-bench="start">Start motor</button><button class="danger" data-bench="stop">Brake stop</button><button class="danger" data-bench="emergencyStop">Emergency stop</button></div>${brakeMetricsHtml(m.brake)}</div><div class="bench-card"><h3>Speed and pitch</h3><div class="button-row"><button data-bench-speed="0">33 RPM</button><button data-bench-speed="1">45 RPM</button><button data-bench-speed="2">78 RPM</button><button data-bench="resetPitch">Reset pitch</button></div><div class="field"><label for="benchPitch">Pitch percent</label><input id="benchPitch" type="number" min="-50" max="50" step="0.1" value="${m.pitch!==undefined?Number(m.pitch).toFixed(1):"0"}"></div><button id="benchSetPitch">Set pitch</button></div>${clSetupCard}<div class="bench-card"><h3>Report</h3><div class="button-row"><button id="benchMakeReport">Generate report</button></div><textarea id="benchReport" aria-label="Bench test report">${esc(benchReportText())}</textarea></div></div>`;
 const relaySelect=$("benchRelayStage");
 if(relaySelect){
 if(Number(m.relayStageCount||0)>0)relaySelect.value=String(m.relayStage||0);
@@ -447,7 +458,7 @@ relaySelect.closest(".bench-card")?.remove();
 $("benchRefresh").onclick=()=>loadDiagnostics().catch(e=>setLive(e.message));
 $("benchSetPitch").onclick=()=>control("setPitch",{pitch:Number($("benchPitch").value)}).catch(e=>setLive(e.message));
 $("benchMakeReport").onclick=()=>{$("benchReport").value=benchReportText()};
-document.querySelectorAll("[data-bench]").forEach(b=>b.onclick=()=>{const action=b.dataset.bench;if((action==="start"||action==="relayTest")&&!confirm("Run this bench test action now?"))return;const extra=action==="relayTest"?{stage:Number($("benchRelayStage").value)}:{};control(action,extra).catch(e=>setLive(e.message))});
+document.querySelectorAll("[data-bench]").forEach(b=>b.onclick=()=>{const action=b.dataset.bench;if((action==="start"||action==="relayTest"||action==="coastDownStart"||action==="offsetNull")&&!confirm("Run this bench test action now?"))return;const extra=action==="relayTest"?{stage:Number($("benchRelayStage").value)}:{};control(action,extra).catch(e=>setLive(e.message))});
 document.querySelectorAll("[data-bench-speed]").forEach(b=>b.onclick=()=>setSpeedControl(b.dataset.benchSpeed).catch(e=>setLive(e.message)));
 setLockedUI();
 }
@@ -773,6 +784,7 @@ static const char* speedName(SpeedMode speed) {
 
 static const char* motorStateName() {
     if (motor.isRelayTestMode()) return "RELAY TEST";
+    if (motor.isDcOffsetNullActive()) return "OFFSET NULL";
     switch (motor.getState()) {
         case STATE_STANDBY: return "STANDBY";
         case STATE_STOPPED: return "STOPPED";
@@ -859,6 +871,18 @@ static void streamSystemMetrics(Print& out, bool& first) {
     writeUIntProp(out, nestedFirst, "bufferFillAgeMs", lastFillMs == 0 ? 0 : now - lastFillMs);
     writeUIntProp(out, nestedFirst, "bufferFillCount", waveform.getBufferFillCount());
     writeFloatProp(out, nestedFirst, "sampleRateHz", waveform.getSampleRateHz());
+    writeUIntProp(out, nestedFirst, "blockSamples", waveform.getBlockLength());
+#if PWM_DITHER_ENABLE
+    writeFloatProp(out, nestedFirst, "carrierDitherPercent", PWM_DITHER_PERCENT);
+#else
+    writeFloatProp(out, nestedFirst, "carrierDitherPercent", 0.0f);
+#endif
+    writeUIntProp(out, nestedFirst, "carrierWrap", waveform.getCarrierWrap());
+    writeUIntProp(out, nestedFirst, "carrierDitherLateCount", waveform.getCarrierDitherLateCount());
+    bool firActive = settings.getCurrentSpeedSettings().filterType == FILTER_FIR;
+    const FirKernel& firKernel = waveform.getFirKernel(settings.get().currentSpeed);
+    writeUIntProp(out, nestedFirst, "firTaps", firActive ? firKernel.taps : 0);
+    writeFloatProp(out, nestedFirst, "firTransitionHz", firActive ? firKernel.transitionHz : 0.0f);
     writeUIntProp(out, nestedFirst, "dmaIrqCount", waveform.getDmaIrqCount());
     writeUIntProp(out, nestedFirst, "dmaRearmCount", waveform.getDmaRearmCount());
     writeUIntProp(out, nestedFirst, "dmaDesyncCount", waveform.getDmaDesyncCount());
@@ -1007,6 +1031,7 @@ static void streamOptions(Print& out) {
     streamOptionPair(out, first, FIR_GENTLE, "Gentle");
     streamOptionPair(out, first, FIR_MEDIUM, "Medium");
     streamOptionPair(out, first, FIR_AGGRESSIVE, "Aggressive");
+    streamOptionPair(out, first, FIR_CUSTOM, "Custom");
     out.write(']');
 
     beginArrayProp(out, firstOptionSet, "softStartCurve");
@@ -1028,6 +1053,7 @@ static void streamOptions(Print& out) {
     streamOptionPair(out, first, BRAKE_PULSE, "Pulse");
     streamOptionPair(out, first, BRAKE_RAMP, "Ramp");
     streamOptionPair(out, first, BRAKE_SOFT_STOP, "Soft stop");
+    streamOptionPair(out, first, BRAKE_TACH, "Tach-guided");
     out.write(']');
 
 #if CLOSED_LOOP_SPEED_ENABLE
@@ -1041,6 +1067,9 @@ static void streamOptions(Print& out) {
     first = true;
     streamOptionPair(out, first, CLOSED_LOOP_SENSOR_PULSE, "Pulse tach");
     streamOptionPair(out, first, CLOSED_LOOP_SENSOR_QUADRATURE, "Quadrature");
+#if SENSORLESS_SPEED_ENABLE
+    streamOptionPair(out, first, CLOSED_LOOP_SENSOR_SENSORLESS, "Sensorless back-EMF");
+#endif
     out.write(']');
 
     beginArrayProp(out, firstOptionSet, "closedLoopPulseEdge");
@@ -1089,6 +1118,14 @@ static void streamOptions(Print& out) {
     streamOptionPair(out, first, CLOSED_LOOP_AMP_RECOVERY_WARN, "Warn");
     streamOptionPair(out, first, CLOSED_LOOP_AMP_RECOVERY_RESTORE, "Restore full amplitude");
     out.write(']');
+
+    beginArrayProp(out, firstOptionSet, "closedLoopSlipAction");
+    first = true;
+    streamOptionPair(out, first, CLOSED_LOOP_SLIP_IGNORE, "Ignore");
+    streamOptionPair(out, first, CLOSED_LOOP_SLIP_WARN, "Warn");
+    streamOptionPair(out, first, CLOSED_LOOP_SLIP_BOOST, "Restore full amplitude");
+    streamOptionPair(out, first, CLOSED_LOOP_SLIP_STOP, "Stop");
+    out.write(']');
 #endif
 
     beginArrayProp(out, firstOptionSet, "screensaverMode");
@@ -1264,6 +1301,29 @@ static void streamGlobalGroups(Print& out) {
     streamNumberField(out, firstField, "gainSlewPercentPerSecond", "Gain slew", 0, 1000, 5, "Maximum rate for live per-channel gain changes. Zero applies changes immediately.", "percent/sec");
     endFieldGroup(out);
 
+#if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
+    beginFieldGroup(out, firstGroup, "Bridge Dead Time");
+    firstField = true;
+    streamNumberField(out, firstField, "bridgeDeadTimeNs", "Driver dead time", 0, 2000, 10, "Dead time inserted by the bridge driver between high and low switches. The lost duty is added back by current direction. Zero disables compensation.", "ns", true);
+    streamNumberField(out, firstField, "bridgeDeadTimeLagDeg33", "33 current lag", 0, 89, 1, "How far phase current trails the drive at 33 RPM. Tune for the lowest motor vibration or current distortion.", "degrees", true);
+    streamNumberField(out, firstField, "bridgeDeadTimeLagDeg45", "45 current lag", 0, 89, 1, "How far phase current trails the drive at 45 RPM.", "degrees", true);
+    streamNumberField(out, firstField, "bridgeDeadTimeLagDeg78", "78 current lag", 0, 89, 1, "How far phase current trails the drive at 78 RPM.", "degrees", true);
+    endFieldGroup(out);
+#endif
+
+    beginFieldGroup(out, firstGroup, "FIR Design");
+    firstField = true;
+    streamNumberField(out, firstField, "firCutoffHz33", "33 cutoff", 100, 45000, 100, "Custom FIR -6 dB point at 33 RPM. Set it below the PWM carrier and any output filter resonance.", "Hz");
+    streamNumberField(out, firstField, "firTransitionHz33", "33 transition", 100, 50000, 100, "Width from passband to stopband. Narrower needs more taps.", "Hz");
+    streamNumberField(out, firstField, "firTaps33", "33 tap budget", FIR_MIN_TAPS, FIR_MAX_TAPS, 1, "Longest kernel allowed. The designer uses fewer when the width allows and widens the transition when it runs out.");
+    streamNumberField(out, firstField, "firCutoffHz45", "45 cutoff", 100, 45000, 100, "Custom FIR -6 dB point at 45 RPM.", "Hz");
+    streamNumberField(out, firstField, "firTransitionHz45", "45 transition", 100, 50000, 100, nullptr, "Hz");
+    streamNumberField(out, firstField, "firTaps45", "45 tap budget", FIR_MIN_TAPS, FIR_MAX_TAPS, 1);
+    streamNumberField(out, firstField, "firCutoffHz78", "78 cutoff", 100, 45000, 100, "Custom FIR -6 dB point at 78 RPM.", "Hz");
+    streamNumberField(out, firstField, "firTransitionHz78", "78 transition", 100, 50000, 100, nullptr, "Hz");
+    streamNumberField(out, firstField, "firTaps78", "78 tap budget", FIR_MIN_TAPS, FIR_MAX_TAPS, 1);
+    endFieldGroup(out);
+
     beginFieldGroup(out, firstGroup, "Motor Amplitude");
     firstField = true;
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
@@ -1279,6 +1339,18 @@ static void streamGlobalGroups(Print& out) {
     streamNumberField(out, firstField, "vfBaseFreq", "V/f base frequency", MIN_OUTPUT_FREQUENCY_HZ, MAX_OUTPUT_FREQUENCY_HZ, 1, "Frequency at which the V/f curve reaches full output.", "Hz", true);
     endFieldGroup(out);
 
+    beginFieldGroup(out, firstGroup, "Motor Thermal");
+    firstField = true;
+    streamCheckboxField(out, firstField, "thermalDerateEnabled", "Thermal derating", "Trim running drive when the estimated winding rise enters the derate band. The estimate is reported either way.", true);
+    streamNumberField(out, firstField, "thermalWindingTauSec", "Winding time constant", 5, 3600, 5, "How quickly the winding itself heats and cools.", "sec", true);
+    streamNumberField(out, firstField, "thermalFrameTauSec", "Frame time constant", 5, 36000, 30, "How quickly the motor body heats and cools. Never shorter than the winding constant.", "sec", true);
+    streamNumberField(out, firstField, "thermalFullScaleRiseC", "Full-drive rise", 5, 200, 1, "Steady temperature rise above ambient at 100% drive held indefinitely.", "C", true);
+    streamNumberField(out, firstField, "thermalWindingShare", "Winding share", 0, 90, 1, "Part of the full-drive rise that sits across the fast winding stage.", "percent", true);
+    streamNumberField(out, firstField, "thermalDerateStartC", "Derate start", 1, 150, 1, "Estimated rise at which drive trimming begins.", "C", true);
+    streamNumberField(out, firstField, "thermalDerateLimitC", "Derate limit", 2, 160, 1, "Estimated rise at which drive reaches the derate floor.", "C", true);
+    streamNumberField(out, firstField, "thermalMinDerate", "Derate floor", 10, 100, 1, "Lowest running drive multiplier. Keep high enough for the platter to hold speed.", "percent", true);
+    endFieldGroup(out);
+
     beginFieldGroup(out, firstGroup, "Motor Ramping");
     firstField = true;
     streamSelectField(out, firstField, "rampType", "Ramp type", "rampType", "Acceleration curve used for speed changes.");
@@ -1293,8 +1365,8 @@ static void streamGlobalGroups(Print& out) {
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     streamCheckboxField(out, firstField, "activeBrakingAllowed", "Regenerative braking safe", "Confirm that the DC bus has a verified path for absorbing returned braking energy. This permits the selected active braking mode; it does not select one.", true);
 #endif
-    streamSelectField(out, firstField, "brakeMode", "Brake mode", "brakeMode", "How the motor is stopped.", true);
-    streamNumberField(out, firstField, "brakeDuration", "Brake duration", 0, 10, 0.1f, "Braking or ramp-down duration.", "sec", true);
+    streamSelectField(out, firstField, "brakeMode", "Brake mode", "brakeMode", "How the motor is stopped. Tach-guided braking needs closed-loop feedback and otherwise uses the timed ramp.", true);
+    streamNumberField(out, firstField, "brakeDuration", "Brake duration", 0, 10, 0.1f, "Braking or ramp-down duration. Tach-guided braking ends at measured standstill instead.", "sec", true);
     streamNumberField(out, firstField, "brakePulseGap", "Brake pulse gap", 0.1f, 2, 0.1f, "Gap between brake pulses.", "sec", true);
     streamNumberField(out, firstField, "brakeStartFreq", "Brake start frequency", 10, 200, 1, "Starting frequency for active braking.", "Hz", true);
     streamNumberField(out, firstField, "brakeStopFreq", "Brake stop frequency", 0, 50, 1, "Final frequency for active braking.", "Hz", true);
@@ -1345,6 +1417,33 @@ static void streamGlobalGroups(Print& out) {
     streamNumberField(out, firstField, "closedLoopPitchResetThresholdRpm", "Pitch reset threshold", 0, 20, 0.1f, "RPM target jump that resets the controller state.", "RPM", true);
     endFieldGroup(out);
 
+    beginFieldGroup(out, firstGroup, "Closed Loop Notch");
+    firstField = true;
+    streamCheckboxField(out, firstField, "closedLoopNotchEnabled", "Adaptive notch", "Track a belt or suspension resonance in the speed error and filter it out of the correction, so Kp and Ki can stay higher.", true);
+    streamNumberField(out, firstField, "closedLoopNotchMinHz", "Search from", 0.05f, 20, 0.05f, "Lowest platter oscillation frequency the notch will follow.", "Hz", true);
+    streamNumberField(out, firstField, "closedLoopNotchMaxHz", "Search to", 0.15f, 25, 0.05f, "Highest oscillation frequency followed. Capped below half the controller update rate.", "Hz", true);
+    streamNumberField(out, firstField, "closedLoopNotchBandwidthHz", "Notch width", 0.05f, 2, 0.05f, "Width of the notch. Narrow notches cost less phase near crossover but take longer to settle.", "Hz", true);
+    endFieldGroup(out);
+
+    beginFieldGroup(out, firstGroup, "Closed Loop Needle Drop");
+    firstField = true;
+    streamCheckboxField(out, firstField, "loadStepEnabled", "Needle-drop feed-forward", "Detect stylus drops and lifts from the speed error and add the correction learned from earlier drops at once, instead of waiting for the integral.", true);
+    streamNumberField(out, firstField, "loadStepSlopeRpmPerSec", "Slope threshold", 0.01f, 10, 0.01f, "How fast the speed error must grow to count as a load step. Raise it if ordinary wow triggers drops.", "RPM/s", true);
+    streamNumberField(out, firstField, "loadStepBoostPercent", "Drive boost", 0, 50, 1, "Extra drive amplitude at a needle drop, fading out over the boost time. 0 disables the boost.", "%", true);
+    streamNumberField(out, firstField, "loadStepBoostMs", "Boost time", 0, 10000, 100, "Time for the drive boost to fade back to normal.", "ms", true);
+    endFieldGroup(out);
+
+    beginFieldGroup(out, firstGroup, "Closed Loop Startup");
+    firstField = true;
+    streamCheckboxField(out, firstField, "adaptiveKickEnabled", "Adaptive startup kick", "End the startup kick as soon as the platter pulls in, and reuse the kick and ramp lengths that worked on earlier starts. The configured kick duration stays the longest kick.", true);
+    streamNumberField(out, firstField, "kickPullInPercent", "Pull-in point", 70, 99, 1, "Share of the kick's synchronous speed the platter must hold before the kick ends.", "%", true);
+    endFieldGroup(out);
+
+    beginFieldGroup(out, firstGroup, "Closed Loop Base Learning");
+    firstField = true;
+    streamCheckboxField(out, firstField, "baseLearnEnabled", "Learn base frequency", "Move each speed's base frequency, in small steps, toward the frequency locked sessions show it needs. Learning stays within a few percent of the base you set, and a step that makes correction worse is undone.", true);
+    endFieldGroup(out);
+
     beginFieldGroup(out, firstGroup, "Closed Loop Safety");
     firstField = true;
     streamSelectField(out, firstField, "closedLoopDropoutAction", "Dropout action", "closedLoopDropoutAction", "Action when the feedback signal is lost after engagement.", true);
@@ -1357,6 +1456,10 @@ static void streamGlobalGroups(Print& out) {
     streamSelectField(out, firstField, "closedLoopLockTimeoutAction", "Lock timeout action", "closedLoopFaultAction", "Action when feedback does not lock within the configured time.", true);
     streamSelectField(out, firstField, "closedLoopAmpRecoveryMode", "Amplitude recovery", "closedLoopAmpRecoveryMode", "Warn or restore full amplitude if reduced-amplitude mode cannot hold lock.", true);
     streamNumberField(out, firstField, "closedLoopAmpRecoveryDelayMs", "Amplitude recovery delay", 0, 30000, 100, "Out-of-lock time after amplitude reduction before recovery action runs.", "ms", true);
+    streamSelectField(out, firstField, "closedLoopSlipAction", "Slip action", "closedLoopSlipAction", "Action when measured speed stays below the synchronous speed of the commanded frequency.", true);
+    streamNumberField(out, firstField, "closedLoopSlipThresholdPercent", "Slip threshold", 0.5f, 50, 0.1f, "Shortfall against the learned synchronous speed that counts as belt slip.", "%", true);
+    streamNumberField(out, firstField, "closedLoopPullOutThresholdPercent", "Pull-out threshold", 0, 100, 1, "Shortfall reported as rotor pull-out, even before a ratio has been learned. Zero disables it.", "%", true);
+    streamNumberField(out, firstField, "closedLoopSlipDetectMs", "Slip detect time", 50, 10000, 50, "Time slip must persist before the slip action runs.", "ms", true);
     endFieldGroup(out);
 #endif
 
@@ -1435,7 +1538,7 @@ static void streamSpeedFields(Print& out) {
     streamNumberField(out, firstField, "startupKickRampDuration", "Startup kick ramp", 0, 15, 0.1f, "Ramp-out duration for startup kick.", "sec", true);
     streamSelectField(out, firstField, "filterType", "Filter type", "filterType", "Digital smoothing filter for speed changes.");
     streamNumberField(out, firstField, "iirAlpha", "IIR alpha", 0.01f, 0.99f, 0.01f, "IIR smoothing coefficient.");
-    streamSelectField(out, firstField, "firProfile", "FIR profile", "firProfile", "FIR smoothing profile.");
+    streamSelectField(out, firstField, "firProfile", "FIR profile", "firProfile", "FIR low-pass design. Custom uses this speed's cutoff, width and tap budget from FIR Design.");
 #if CLOSED_LOOP_SPEED_ENABLE
     streamNumberField(out, firstField, "closedLoopDeadbandRpm", "Closed-loop deadband", 0, 5, 0.01f, "RPM error band ignored by the controller for this speed.", "RPM", true);
     streamNumberField(out, firstField, "closedLoopLockToleranceRpm", "Closed-loop lock tolerance", 0.01f, 5, 0.01f, "RPM tolerance used to declare lock for this speed.", "RPM", true);
@@ -1936,6 +2039,70 @@ void WebInterface::populateStatus(JsonDocument& doc) {
     motorJson["driverEnabled"] = powerStage.isEnabled();
     motorJson["driverEnablePending"] = powerStage.isEnablePending();
     motorJson["driverFault"] = powerStage.hasFault();
+    MotorThermalStatus thermal = motor.getThermalStatus();
+    JsonObject thermalJson = motorJson["thermal"].to<JsonObject>();
+    thermalJson["derateEnabled"] = thermal.derateEnabled;
+    thermalJson["derating"] = thermal.derating;
+    thermalJson["driveLevel"] = thermal.driveLevel;
+    thermalJson["windingRiseC"] = thermal.windingRiseC;
+    thermalJson["frameRiseC"] = thermal.frameRiseC;
+    thermalJson["totalRiseC"] = thermal.totalRiseC;
+    thermalJson["steadyRiseC"] = thermal.steadyRiseC;
+    thermalJson["derate"] = thermal.derate;
+    thermalJson["derateEvents"] = thermal.derateEvents;
+#if BUS_VOLTAGE_SENSE_ENABLE
+    BusVoltageStatus bus = motor.getBusVoltageStatus();
+    JsonObject busJson = motorJson["bus"].to<JsonObject>();
+    busJson["state"] = (int)bus.state;
+    busJson["volts"] = bus.volts;
+    busJson["fastVolts"] = bus.fastVolts;
+    busJson["scale"] = bus.scale;
+    busJson["minVolts"] = bus.minVolts;
+    busJson["maxVolts"] = bus.maxVolts;
+    busJson["dipMs"] = bus.dipMs;
+    busJson["longestDipMs"] = bus.longestDipMs;
+    busJson["dipsRiddenThrough"] = bus.dipsRiddenThrough;
+    busJson["underVoltageEvents"] = bus.underVoltageEvents;
+    busJson["overVoltageEvents"] = bus.overVoltageEvents;
+    busJson["brakeAborts"] = bus.brakeAborts;
+    busJson["regenGuarded"] = bus.regenGuarded;
+#endif
+#if DC_OFFSET_NULL_ENABLE
+    DcOffsetStatus offset = motor.getDcOffsetStatus();
+    JsonObject offsetJson = motorJson["offsetNull"].to<JsonObject>();
+    offsetJson["active"] = offset.active;
+    offsetJson["step"] = offset.step;
+    offsetJson["selectedChannel"] = offset.selectedChannel;
+    offsetJson["zeroCounts"] = offset.zeroCounts;
+    offsetJson["lastSucceeded"] = offset.lastSucceeded;
+    offsetJson["runs"] = offset.runs;
+    JsonArray offsetChannels = offsetJson["channels"].to<JsonArray>();
+    for (uint8_t ch = 0; ch < MAX_ACTIVE_PHASE_OUTPUTS; ch++) {
+        JsonObject channel = offsetChannels.add<JsonObject>();
+        channel["storedCounts"] = offset.storedCounts[ch];
+        channel["appliedCounts"] = offset.appliedCounts[ch];
+        channel["residualCounts"] = offset.result[ch].residualCounts;
+        channel["gain"] = offset.result[ch].gain;
+        channel["iterations"] = offset.result[ch].iterations;
+        channel["outcome"] = ch < offset.channels ? offset.result[ch].outcome : (uint8_t)DC_OFFSET_NOT_RUN;
+    }
+#endif
+    BrakeMetrics brake = motor.getBrakeMetrics();
+    JsonObject brakeJson = motorJson["brake"].to<JsonObject>();
+    brakeJson["active"] = brake.active;
+    brakeJson["settling"] = brake.settling;
+    brakeJson["lastResult"] = brake.lastResult;
+    brakeJson["lastReversed"] = brake.lastReversed;
+    brakeJson["stops"] = brake.stops;
+    brakeJson["timeouts"] = brake.timeouts;
+    brakeJson["fallbacks"] = brake.fallbacks;
+    brakeJson["lastStopMs"] = brake.lastStopMs;
+    brakeJson["bestStopMs"] = brake.bestStopMs;
+    brakeJson["lastStartRpm"] = brake.lastStartRpm;
+    brakeJson["currentRpm"] = brake.currentRpm;
+    brakeJson["lastOvershootDeg"] = brake.lastOvershootDeg;
+    brakeJson["lastOvershootRpm"] = brake.lastOvershootRpm;
+    brakeJson["peakOvershootRpm"] = brake.peakOvershootRpm;
     JsonObject outputJson = motorJson["output"].to<JsonObject>();
     outputJson["state"] = powerStage.stateName();
     outputJson["stateCode"] = (int)powerStage.state();
@@ -1955,6 +2122,7 @@ void WebInterface::populateStatus(JsonDocument& doc) {
         channelJson["targetGain"] = outputSpeed.channelAmplitude[channel];
         channelJson["appliedGain"] = waveform.getAppliedChannelGainPercent(channel);
         channelJson["headroom"] = waveform.getModulationHeadroomPercent(channel);
+        channelJson["limiter"] = waveform.getLimiterReductionPercent(channel);
         channelJson["clippingCount"] = waveform.getClippingCount(channel);
     }
     PowerStageFaultSnapshot faultSnapshot = powerStage.faultSnapshot();
@@ -1991,6 +2159,7 @@ void WebInterface::populateStatus(JsonDocument& doc) {
     closedLoop["active"] = motor.isClosedLoopActive();
     closedLoop["saturated"] = motor.isClosedLoopSaturated();
     closedLoop["ampRecoveryActive"] = motor.isClosedLoopAmpRecoveryActive();
+    closedLoop["slipping"] = motor.isClosedLoopSlipping();
     closedLoop["targetRpm"] = motor.getClosedLoopTargetRpm();
     closedLoop["requestedTargetRpm"] = motor.getClosedLoopRequestedTargetRpm();
     closedLoop["rampTargetRpm"] = motor.getClosedLoopRampTargetRpm();
@@ -2026,6 +2195,30 @@ void WebInterface::populateStatus(JsonDocument& doc) {
     healthJson["averageIntervalUs"] = feedback.averageIntervalUs;
     healthJson["averageJitterUs"] = feedback.averageJitterUs;
     healthJson["averageJitterPercent"] = feedback.averageJitterPercent;
+    healthJson["debounceUs"] = feedback.debounceUs;
+    healthJson["rejectedWindows"] = feedback.rejectedWindows;
+    JsonObject dutyJson = healthJson["duty"].to<JsonObject>();
+    dutyJson["tracked"] = feedback.dutyTracked;
+    dutyJson["samples"] = feedback.duty.samples;
+    dutyJson["rejected"] = feedback.duty.rejected;
+    dutyJson["overruns"] = feedback.dutyOverruns;
+    dutyJson["slots"] = feedback.duty.slots;
+    dutyJson["baselineValid"] = feedback.duty.baselineValid;
+    dutyJson["mean"] = feedback.duty.meanDuty;
+    dutyJson["baseline"] = feedback.duty.baselineDuty;
+    dutyJson["drift"] = feedback.duty.drift;
+    dutyJson["minSlot"] = feedback.duty.minSlotDuty;
+    dutyJson["maxSlot"] = feedback.duty.maxSlotDuty;
+    dutyJson["spread"] = feedback.duty.slotSpread;
+    dutyJson["baselineSpread"] = feedback.duty.baselineSpread;
+    dutyJson["warnings"] = feedback.duty.warnings;
+    JsonArray speedEdgesJson = healthJson["speedEdges"].to<JsonArray>();
+    for (uint8_t i = 0; i < 3; i++) {
+        JsonObject edgeJson = speedEdgesJson.add<JsonObject>();
+        edgeJson["accepted"] = feedback.speedEdges[i].accepted;
+        edgeJson["debounced"] = feedback.speedEdges[i].debounced;
+        edgeJson["invalid"] = feedback.speedEdges[i].invalid;
+    }
     JsonObject setupJson = closedLoop["setup"].to<JsonObject>();
     setupJson["active"] = setup.active;
     setupJson["pinAHigh"] = setup.pinAHigh;
@@ -2038,6 +2231,34 @@ void WebInterface::populateStatus(JsonDocument& doc) {
     setupJson["correctedDirection"] = setup.correctedDirection;
     setupJson["suggestedCountsPerRev"] = setup.suggestedCountsPerRev;
     setupJson["suggestedReverseDirection"] = setup.suggestedReverseDirection;
+    setupJson["autoDetect"] = setup.autoDetect;
+    setupJson["autoState"] = setup.autoState;
+    setupJson["autoProgressPercent"] = setup.autoProgressPercent;
+    setupJson["autoSamples"] = setup.autoSamples;
+    setupJson["autoDetectedCountsPerRev"] = setup.autoDetectedCountsPerRev;
+    setupJson["autoExpectedCountsPerRev"] = setup.autoExpectedCountsPerRev;
+    setupJson["autoCorrelation"] = setup.autoCorrelation;
+    setupJson["autoConfidence"] = setup.autoConfidence;
+    setupJson["autoMessage"] = setup.autoMessage;
+    CoastDownStatus coast = motor.getCoastDownStatus();
+    JsonObject coastJson = closedLoop["coastDown"].to<JsonObject>();
+    coastJson["active"] = coast.active;
+    coastJson["speed"] = coast.speed;
+    coastJson["elapsedMs"] = coast.elapsedMs;
+    coastJson["sampleCount"] = coast.sampleCount;
+    coastJson["startRpm"] = coast.startRpm;
+    coastJson["lastRpm"] = coast.lastRpm;
+    coastJson["message"] = coast.message;
+    JsonArray coastModels = coastJson["models"].to<JsonArray>();
+    for (uint8_t i = 0; i < 3; i++) {
+        CoastDownFitResult model;
+        JsonObject modelJson = coastModels.add<JsonObject>();
+        modelJson["valid"] = motor.getCoastDownModel((SpeedMode)i, model);
+        modelJson["viscousPerSec"] = model.viscousPerSec;
+        modelJson["coulombRpmPerSec"] = model.coulombRpmPerSec;
+        modelJson["rSquared"] = model.rSquared;
+        modelJson["stopSec"] = coastDownStopSeconds(model, model.startRpm);
+    }
     ClosedLoopTuningStatus tuning = motor.getClosedLoopTuningStatus();
     ClosedLoopMetrics metrics = tuning.metrics;
     JsonObject metricsJson = closedLoop["metrics"].to<JsonObject>();
@@ -2053,12 +2274,123 @@ void WebInterface::populateStatus(JsonDocument& doc) {
     metricsJson["plausibilityEvents"] = metrics.plausibilityEvents;
     metricsJson["lockTimeoutEvents"] = metrics.lockTimeoutEvents;
     metricsJson["ampRecoveryEvents"] = metrics.ampRecoveryEvents;
+    metricsJson["slipEvents"] = metrics.slipEvents;
+    metricsJson["pullOutEvents"] = metrics.pullOutEvents;
+    metricsJson["slipSamples"] = metrics.slipSamples;
     metricsJson["errorSignChanges"] = metrics.errorSignChanges;
     metricsJson["averageErrorRpm"] = metrics.averageErrorRpm;
     metricsJson["averageAbsErrorRpm"] = metrics.averageAbsErrorRpm;
     metricsJson["peakAbsErrorRpm"] = metrics.peakAbsErrorRpm;
     metricsJson["lastErrorRpm"] = metrics.lastErrorRpm;
     metricsJson["averageCorrectionHz"] = metrics.averageCorrectionHz;
+    metricsJson["lastSlipPercent"] = metrics.lastSlipPercent;
+    metricsJson["averageSlipPercent"] = metrics.averageSlipPercent;
+    metricsJson["peakSlipPercent"] = metrics.peakSlipPercent;
+    metricsJson["slipRatioRpmPerHz"] = metrics.slipRatioRpmPerHz;
+    ClosedLoopNotchStatus notch = motor.getClosedLoopNotchStatus();
+    JsonObject notchJson = closedLoop["notch"].to<JsonObject>();
+    notchJson["enabled"] = notch.enabled;
+    JsonArray notchStages = notchJson["stages"].to<JsonArray>();
+    for (uint8_t i = 0; i < notch.stages; i++) {
+        JsonObject stageJson = notchStages.add<JsonObject>();
+        stageJson["centreHz"] = notch.centreHz[i];
+        stageJson["engagement"] = notch.engagement[i];
+        stageJson["powerRatio"] = notch.powerRatio[i];
+    }
+    LoadStepStatus loadStep = motor.getLoadStepStatus();
+    JsonObject loadStepJson = closedLoop["loadStep"].to<JsonObject>();
+    loadStepJson["enabled"] = loadStep.enabled;
+    loadStepJson["armed"] = loadStep.armed;
+    loadStepJson["measuring"] = loadStep.measuring;
+    loadStepJson["loaded"] = loadStep.loaded;
+    loadStepJson["drops"] = loadStep.drops;
+    loadStepJson["lifts"] = loadStep.lifts;
+    loadStepJson["measurements"] = loadStep.measurements;
+    loadStepJson["lastMeasuredHz"] = loadStep.lastMeasuredHz;
+    loadStepJson["lastSettled"] = loadStep.lastSettled;
+    loadStepJson["boost"] = loadStep.boost;
+    JsonArray learnedJson = loadStepJson["learnedHz"].to<JsonArray>();
+    for (uint8_t i = 0; i < 3; i++) learnedJson.add(loadStep.learnedHz[i]);
+    StartupKickStatus startupKick = motor.getStartupKickStatus();
+    JsonObject startupKickJson = closedLoop["startupKick"].to<JsonObject>();
+    startupKickJson["enabled"] = startupKick.enabled;
+    startupKickJson["tracking"] = startupKick.tracking;
+    startupKickJson["phase"] = startupKick.phase;
+    startupKickJson["lastEnd"] = startupKick.lastEnd;
+    startupKickJson["lastKickSec"] = startupKick.lastKickSec;
+    startupKickJson["lastPullInSec"] = startupKick.lastPullInSec;
+    startupKickJson["lastRampSec"] = startupKick.lastRampSec;
+    startupKickJson["lastRampSlipped"] = startupKick.lastRampSlipped;
+    startupKickJson["starts"] = startupKick.starts;
+    startupKickJson["pullIns"] = startupKick.pullIns;
+    JsonArray timeToLockJson = startupKickJson["timeToLockSec"].to<JsonArray>();
+    JsonArray learnedKickJson = startupKickJson["learnedKickSec"].to<JsonArray>();
+    JsonArray learnedRampJson = startupKickJson["learnedRampSec"].to<JsonArray>();
+    for (uint8_t i = 0; i < 3; i++) {
+        timeToLockJson.add(startupKick.timeToLockSec[i]);
+        learnedKickJson.add(startupKick.learnedKickSec[i]);
+        learnedRampJson.add(startupKick.learnedRampSec[i]);
+    }
+    MotorHealthStatus wear = motor.getHealthStatus();
+    JsonObject wearJson = closedLoop["wear"].to<JsonObject>();
+    wearJson["records"] = wear.records;
+    wearJson["capacity"] = HEALTH_HISTORY_RECORDS;
+    wearJson["minSessions"] = HEALTH_TREND_MIN_SESSIONS;
+    wearJson["sessionActive"] = wear.sessionActive;
+    wearJson["sessionSpeed"] = wear.sessionSpeed;
+    wearJson["sessionLockedSec"] = wear.sessionLockedSec;
+    JsonArray wearSpeeds = wearJson["speeds"].to<JsonArray>();
+    for (uint8_t i = 0; i < 3; i++) {
+        const HealthTrendResult& trend = wear.trend[i];
+        JsonObject speedJson = wearSpeeds.add<JsonObject>();
+        speedJson["sessions"] = trend.sessions;
+        speedJson["spanHours"] = trend.spanHours;
+        speedJson["drift"] = trend.drift;
+        // Metric order: correction Hz, lock amplitude, time to lock s, error RMS rpm, coast s.
+        JsonArray changeJson = speedJson["change"].to<JsonArray>();
+        JsonArray tStatJson = speedJson["tStat"].to<JsonArray>();
+        uint8_t worsening = 0;
+        for (uint8_t m = 0; m < HEALTH_METRIC_COUNT; m++) {
+            changeJson.add(trend.metric[m].change);
+            tStatJson.add(trend.metric[m].tStat);
+            if (trend.metric[m].worsening) worsening |= (uint8_t)(1 << m);
+        }
+        speedJson["worsening"] = worsening;
+    }
+    BaseLearnStatus baseLearn = motor.getBaseLearnStatus();
+    JsonObject baseLearnJson = closedLoop["baseLearn"].to<JsonObject>();
+    baseLearnJson["enabled"] = baseLearn.enabled;
+    baseLearnJson["sharedRatio"] = baseLearn.sharedRatioRpmPerHz;
+    baseLearnJson["sharedPpm"] = baseLearn.sharedHalfWidthPpm;
+    baseLearnJson["steps"] = baseLearn.steps;
+    baseLearnJson["rollbacks"] = baseLearn.rollbacks;
+    JsonArray baseLearnSpeeds = baseLearnJson["speeds"].to<JsonArray>();
+    for (uint8_t i = 0; i < 3; i++) {
+        const BaseLearnSpeedStatus& speed = baseLearn.speed[i];
+        JsonObject speedJson = baseLearnSpeeds.add<JsonObject>();
+        speedJson["ratio"] = speed.ratioRpmPerHz;
+        speedJson["ppm"] = speed.halfWidthPpm;
+        speedJson["weight"] = speed.weight;
+        speedJson["anchorHz"] = speed.anchorHz;
+        speedJson["baseHz"] = speed.baseHz;
+        speedJson["probation"] = speed.onProbation;
+        speedJson["last"] = speed.lastAction;
+        speedJson["shared"] = speed.lastShared;
+        speedJson["bounded"] = speed.lastBounded;
+    }
+    SensorlessSpeedStatus sensorless = speedFeedback.getSensorlessStatus();
+    JsonObject sensorlessJson = closedLoop["sensorless"].to<JsonObject>();
+    sensorlessJson["enabled"] = sensorless.enabled;
+    sensorlessJson["active"] = sensorless.active;
+    sensorlessJson["valid"] = sensorless.valid;
+    sensorlessJson["electricalHz"] = sensorless.electricalHz;
+    sensorlessJson["driveHz"] = sensorless.driveHz;
+    sensorlessJson["slipHz"] = sensorless.slipHz;
+    sensorlessJson["phaseDegrees"] = sensorless.phaseDegrees;
+    sensorlessJson["amplitude"] = sensorless.amplitude;
+    sensorlessJson["crossings"] = sensorless.crossings;
+    sensorlessJson["rejectedCrossings"] = sensorless.rejectedCrossings;
+    sensorlessJson["overruns"] = sensorless.overruns;
     JsonObject tuneJson = closedLoop["tuning"].to<JsonObject>();
     tuneJson["active"] = tuning.active;
     tuneJson["step"] = tuning.step;
@@ -2190,6 +2522,83 @@ void WebInterface::streamStatus(Print& out) {
     writeBoolProp(out, objectFirst, "driverEnabled", powerStage.isEnabled());
     writeBoolProp(out, objectFirst, "driverEnablePending", powerStage.isEnablePending());
     writeBoolProp(out, objectFirst, "driverFault", powerStage.hasFault());
+    MotorThermalStatus thermal = motor.getThermalStatus();
+    beginObjectProp(out, objectFirst, "thermal");
+    bool thermalFirst = true;
+    writeBoolProp(out, thermalFirst, "derateEnabled", thermal.derateEnabled);
+    writeBoolProp(out, thermalFirst, "derating", thermal.derating);
+    writeFloatProp(out, thermalFirst, "driveLevel", thermal.driveLevel);
+    writeFloatProp(out, thermalFirst, "windingRiseC", thermal.windingRiseC);
+    writeFloatProp(out, thermalFirst, "frameRiseC", thermal.frameRiseC);
+    writeFloatProp(out, thermalFirst, "totalRiseC", thermal.totalRiseC);
+    writeFloatProp(out, thermalFirst, "steadyRiseC", thermal.steadyRiseC);
+    writeFloatProp(out, thermalFirst, "derate", thermal.derate);
+    writeUIntProp(out, thermalFirst, "derateEvents", thermal.derateEvents);
+    out.write('}');
+#if BUS_VOLTAGE_SENSE_ENABLE
+    BusVoltageStatus bus = motor.getBusVoltageStatus();
+    beginObjectProp(out, objectFirst, "bus");
+    bool busFirst = true;
+    writeUIntProp(out, busFirst, "state", (uint32_t)bus.state);
+    writeFloatProp(out, busFirst, "volts", bus.volts);
+    writeFloatProp(out, busFirst, "fastVolts", bus.fastVolts);
+    writeFloatProp(out, busFirst, "scale", bus.scale);
+    writeFloatProp(out, busFirst, "minVolts", bus.minVolts);
+    writeFloatProp(out, busFirst, "maxVolts", bus.maxVolts);
+    writeFloatProp(out, busFirst, "dipMs", bus.dipMs);
+    writeFloatProp(out, busFirst, "longestDipMs", bus.longestDipMs);
+    writeUIntProp(out, busFirst, "dipsRiddenThrough", bus.dipsRiddenThrough);
+    writeUIntProp(out, busFirst, "underVoltageEvents", bus.underVoltageEvents);
+    writeUIntProp(out, busFirst, "overVoltageEvents", bus.overVoltageEvents);
+    writeUIntProp(out, busFirst, "brakeAborts", bus.brakeAborts);
+    writeBoolProp(out, busFirst, "regenGuarded", bus.regenGuarded);
+    out.write('}');
+#endif
+#if DC_OFFSET_NULL_ENABLE
+    DcOffsetStatus offset = motor.getDcOffsetStatus();
+    beginObjectProp(out, objectFirst, "offsetNull");
+    bool offsetFirst = true;
+    writeBoolProp(out, offsetFirst, "active", offset.active);
+    writeUIntProp(out, offsetFirst, "step", offset.step);
+    writeIntProp(out, offsetFirst, "selectedChannel", offset.selectedChannel);
+    writeFloatProp(out, offsetFirst, "zeroCounts", offset.zeroCounts);
+    writeBoolProp(out, offsetFirst, "lastSucceeded", offset.lastSucceeded);
+    writeUIntProp(out, offsetFirst, "runs", offset.runs);
+    beginArrayProp(out, offsetFirst, "channels");
+    bool channelFirst = true;
+    for (uint8_t ch = 0; ch < MAX_ACTIVE_PHASE_OUTPUTS; ch++) {
+        writeComma(out, channelFirst);
+        out.write('{');
+        bool first = true;
+        writeFloatProp(out, first, "storedCounts", offset.storedCounts[ch]);
+        writeFloatProp(out, first, "appliedCounts", offset.appliedCounts[ch]);
+        writeFloatProp(out, first, "residualCounts", offset.result[ch].residualCounts);
+        writeFloatProp(out, first, "gain", offset.result[ch].gain);
+        writeUIntProp(out, first, "iterations", offset.result[ch].iterations);
+        writeUIntProp(out, first, "outcome", ch < offset.channels ? offset.result[ch].outcome : (uint8_t)DC_OFFSET_NOT_RUN);
+        out.write('}');
+    }
+    out.write(']');
+    out.write('}');
+#endif
+    BrakeMetrics brake = motor.getBrakeMetrics();
+    beginObjectProp(out, objectFirst, "brake");
+    bool brakeFirst = true;
+    writeBoolProp(out, brakeFirst, "active", brake.active);
+    writeBoolProp(out, brakeFirst, "settling", brake.settling);
+    writeUIntProp(out, brakeFirst, "lastResult", brake.lastResult);
+    writeBoolProp(out, brakeFirst, "lastReversed", brake.lastReversed);
+    writeUIntProp(out, brakeFirst, "stops", brake.stops);
+    writeUIntProp(out, brakeFirst, "timeouts", brake.timeouts);
+    writeUIntProp(out, brakeFirst, "fallbacks", brake.fallbacks);
+    writeUIntProp(out, brakeFirst, "lastStopMs", brake.lastStopMs);
+    writeUIntProp(out, brakeFirst, "bestStopMs", brake.bestStopMs);
+    writeFloatProp(out, brakeFirst, "lastStartRpm", brake.lastStartRpm);
+    writeFloatProp(out, brakeFirst, "currentRpm", brake.currentRpm);
+    writeFloatProp(out, brakeFirst, "lastOvershootDeg", brake.lastOvershootDeg);
+    writeFloatProp(out, brakeFirst, "lastOvershootRpm", brake.lastOvershootRpm);
+    writeFloatProp(out, brakeFirst, "peakOvershootRpm", brake.peakOvershootRpm);
+    out.write('}');
     beginObjectProp(out, objectFirst, "output");
     bool outputFirst = true;
     writeStringProp(out, outputFirst, "state", powerStage.stateName());
@@ -2215,6 +2624,7 @@ void WebInterface::streamStatus(Print& out) {
         writeIntProp(out, valueFirst, "targetGain", outputSpeed.channelAmplitude[channel]);
         writeFloatProp(out, valueFirst, "appliedGain", waveform.getAppliedChannelGainPercent(channel));
         writeFloatProp(out, valueFirst, "headroom", waveform.getModulationHeadroomPercent(channel));
+        writeFloatProp(out, valueFirst, "limiter", waveform.getLimiterReductionPercent(channel));
         writeUIntProp(out, valueFirst, "clippingCount", waveform.getClippingCount(channel));
         out.write('}');
     }
@@ -2258,6 +2668,7 @@ void WebInterface::streamStatus(Print& out) {
     writeBoolProp(out, nestedFirst, "active", motor.isClosedLoopActive());
     writeBoolProp(out, nestedFirst, "saturated", motor.isClosedLoopSaturated());
     writeBoolProp(out, nestedFirst, "ampRecoveryActive", motor.isClosedLoopAmpRecoveryActive());
+    writeBoolProp(out, nestedFirst, "slipping", motor.isClosedLoopSlipping());
     writeFloatProp(out, nestedFirst, "targetRpm", motor.getClosedLoopTargetRpm());
     writeFloatProp(out, nestedFirst, "requestedTargetRpm", motor.getClosedLoopRequestedTargetRpm());
     writeFloatProp(out, nestedFirst, "rampTargetRpm", motor.getClosedLoopRampTargetRpm());
@@ -2294,6 +2705,37 @@ void WebInterface::streamStatus(Print& out) {
     writeUIntProp(out, healthFirst, "averageIntervalUs", feedback.averageIntervalUs);
     writeUIntProp(out, healthFirst, "averageJitterUs", feedback.averageJitterUs);
     writeFloatProp(out, healthFirst, "averageJitterPercent", feedback.averageJitterPercent);
+    writeUIntProp(out, healthFirst, "debounceUs", feedback.debounceUs);
+    writeUIntProp(out, healthFirst, "rejectedWindows", feedback.rejectedWindows);
+    beginObjectProp(out, healthFirst, "duty");
+    bool dutyFirst = true;
+    writeBoolProp(out, dutyFirst, "tracked", feedback.dutyTracked);
+    writeUIntProp(out, dutyFirst, "samples", feedback.duty.samples);
+    writeUIntProp(out, dutyFirst, "rejected", feedback.duty.rejected);
+    writeUIntProp(out, dutyFirst, "overruns", feedback.dutyOverruns);
+    writeUIntProp(out, dutyFirst, "slots", feedback.duty.slots);
+    writeBoolProp(out, dutyFirst, "baselineValid", feedback.duty.baselineValid);
+    writeFloatProp(out, dutyFirst, "mean", feedback.duty.meanDuty);
+    writeFloatProp(out, dutyFirst, "baseline", feedback.duty.baselineDuty);
+    writeFloatProp(out, dutyFirst, "drift", feedback.duty.drift);
+    writeFloatProp(out, dutyFirst, "minSlot", feedback.duty.minSlotDuty);
+    writeFloatProp(out, dutyFirst, "maxSlot", feedback.duty.maxSlotDuty);
+    writeFloatProp(out, dutyFirst, "spread", feedback.duty.slotSpread);
+    writeFloatProp(out, dutyFirst, "baselineSpread", feedback.duty.baselineSpread);
+    writeUIntProp(out, dutyFirst, "warnings", feedback.duty.warnings);
+    out.write('}');
+    beginArrayProp(out, healthFirst, "speedEdges");
+    bool speedEdgesFirst = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        writeComma(out, speedEdgesFirst);
+        out.write('{');
+        bool edgeFirst = true;
+        writeUIntProp(out, edgeFirst, "accepted", feedback.speedEdges[i].accepted);
+        writeUIntProp(out, edgeFirst, "debounced", feedback.speedEdges[i].debounced);
+        writeUIntProp(out, edgeFirst, "invalid", feedback.speedEdges[i].invalid);
+        out.write('}');
+    }
+    out.write(']');
     out.write('}');
     beginObjectProp(out, nestedFirst, "setup");
     bool setupFirst = true;
@@ -2308,6 +2750,42 @@ void WebInterface::streamStatus(Print& out) {
     writeIntProp(out, setupFirst, "correctedDirection", setup.correctedDirection);
     writeUIntProp(out, setupFirst, "suggestedCountsPerRev", setup.suggestedCountsPerRev);
     writeBoolProp(out, setupFirst, "suggestedReverseDirection", setup.suggestedReverseDirection);
+    writeBoolProp(out, setupFirst, "autoDetect", setup.autoDetect);
+    writeUIntProp(out, setupFirst, "autoState", setup.autoState);
+    writeUIntProp(out, setupFirst, "autoProgressPercent", setup.autoProgressPercent);
+    writeUIntProp(out, setupFirst, "autoSamples", setup.autoSamples);
+    writeUIntProp(out, setupFirst, "autoDetectedCountsPerRev", setup.autoDetectedCountsPerRev);
+    writeFloatProp(out, setupFirst, "autoExpectedCountsPerRev", setup.autoExpectedCountsPerRev);
+    writeFloatProp(out, setupFirst, "autoCorrelation", setup.autoCorrelation);
+    writeFloatProp(out, setupFirst, "autoConfidence", setup.autoConfidence);
+    writeStringProp(out, setupFirst, "autoMessage", setup.autoMessage);
+    out.write('}');
+    CoastDownStatus coast = motor.getCoastDownStatus();
+    beginObjectProp(out, nestedFirst, "coastDown");
+    bool coastFirst = true;
+    writeBoolProp(out, coastFirst, "active", coast.active);
+    writeUIntProp(out, coastFirst, "speed", coast.speed);
+    writeUIntProp(out, coastFirst, "elapsedMs", coast.elapsedMs);
+    writeUIntProp(out, coastFirst, "sampleCount", coast.sampleCount);
+    writeFloatProp(out, coastFirst, "startRpm", coast.startRpm);
+    writeFloatProp(out, coastFirst, "lastRpm", coast.lastRpm);
+    writeStringProp(out, coastFirst, "message", coast.message);
+    beginArrayProp(out, coastFirst, "models");
+    bool modelsFirst = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        CoastDownFitResult model;
+        bool valid = motor.getCoastDownModel((SpeedMode)i, model);
+        writeComma(out, modelsFirst);
+        out.write('{');
+        bool modelFirst = true;
+        writeBoolProp(out, modelFirst, "valid", valid);
+        writeFloatProp(out, modelFirst, "viscousPerSec", model.viscousPerSec);
+        writeFloatProp(out, modelFirst, "coulombRpmPerSec", model.coulombRpmPerSec);
+        writeFloatProp(out, modelFirst, "rSquared", model.rSquared);
+        writeFloatProp(out, modelFirst, "stopSec", coastDownStopSeconds(model, model.startRpm));
+        out.write('}');
+    }
+    out.write(']');
     out.write('}');
 
     ClosedLoopTuningStatus tuning = motor.getClosedLoopTuningStatus();
@@ -2326,12 +2804,171 @@ void WebInterface::streamStatus(Print& out) {
     writeUIntProp(out, metricsFirst, "plausibilityEvents", metrics.plausibilityEvents);
     writeUIntProp(out, metricsFirst, "lockTimeoutEvents", metrics.lockTimeoutEvents);
     writeUIntProp(out, metricsFirst, "ampRecoveryEvents", metrics.ampRecoveryEvents);
+    writeUIntProp(out, metricsFirst, "slipEvents", metrics.slipEvents);
+    writeUIntProp(out, metricsFirst, "pullOutEvents", metrics.pullOutEvents);
+    writeUIntProp(out, metricsFirst, "slipSamples", metrics.slipSamples);
     writeUIntProp(out, metricsFirst, "errorSignChanges", metrics.errorSignChanges);
     writeFloatProp(out, metricsFirst, "averageErrorRpm", metrics.averageErrorRpm);
     writeFloatProp(out, metricsFirst, "averageAbsErrorRpm", metrics.averageAbsErrorRpm);
     writeFloatProp(out, metricsFirst, "peakAbsErrorRpm", metrics.peakAbsErrorRpm);
     writeFloatProp(out, metricsFirst, "lastErrorRpm", metrics.lastErrorRpm);
     writeFloatProp(out, metricsFirst, "averageCorrectionHz", metrics.averageCorrectionHz);
+    writeFloatProp(out, metricsFirst, "lastSlipPercent", metrics.lastSlipPercent);
+    writeFloatProp(out, metricsFirst, "averageSlipPercent", metrics.averageSlipPercent);
+    writeFloatProp(out, metricsFirst, "peakSlipPercent", metrics.peakSlipPercent);
+    writeFloatProp(out, metricsFirst, "slipRatioRpmPerHz", metrics.slipRatioRpmPerHz);
+    out.write('}');
+
+    ClosedLoopNotchStatus notch = motor.getClosedLoopNotchStatus();
+    beginObjectProp(out, nestedFirst, "notch");
+    bool notchFirst = true;
+    writeBoolProp(out, notchFirst, "enabled", notch.enabled);
+    beginArrayProp(out, notchFirst, "stages");
+    bool stagesFirst = true;
+    for (uint8_t i = 0; i < notch.stages; i++) {
+        writeComma(out, stagesFirst);
+        out.write('{');
+        bool stageFirst = true;
+        writeFloatProp(out, stageFirst, "centreHz", notch.centreHz[i]);
+        writeFloatProp(out, stageFirst, "engagement", notch.engagement[i]);
+        writeFloatProp(out, stageFirst, "powerRatio", notch.powerRatio[i]);
+        out.write('}');
+    }
+    out.write(']');
+    out.write('}');
+
+    LoadStepStatus loadStep = motor.getLoadStepStatus();
+    beginObjectProp(out, nestedFirst, "loadStep");
+    bool loadStepFirst = true;
+    writeBoolProp(out, loadStepFirst, "enabled", loadStep.enabled);
+    writeBoolProp(out, loadStepFirst, "armed", loadStep.armed);
+    writeBoolProp(out, loadStepFirst, "measuring", loadStep.measuring);
+    writeBoolProp(out, loadStepFirst, "loaded", loadStep.loaded);
+    writeUIntProp(out, loadStepFirst, "drops", loadStep.drops);
+    writeUIntProp(out, loadStepFirst, "lifts", loadStep.lifts);
+    writeUIntProp(out, loadStepFirst, "measurements", loadStep.measurements);
+    writeFloatProp(out, loadStepFirst, "lastMeasuredHz", loadStep.lastMeasuredHz);
+    writeBoolProp(out, loadStepFirst, "lastSettled", loadStep.lastSettled);
+    writeFloatProp(out, loadStepFirst, "boost", loadStep.boost);
+    beginArrayProp(out, loadStepFirst, "learnedHz");
+    bool learnedFirst = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        writeComma(out, learnedFirst);
+        writeFloatValue(out, loadStep.learnedHz[i]);
+    }
+    out.write(']');
+    out.write('}');
+
+    StartupKickStatus startupKick = motor.getStartupKickStatus();
+    beginObjectProp(out, nestedFirst, "startupKick");
+    bool startupKickFirst = true;
+    writeBoolProp(out, startupKickFirst, "enabled", startupKick.enabled);
+    writeBoolProp(out, startupKickFirst, "tracking", startupKick.tracking);
+    writeUIntProp(out, startupKickFirst, "phase", startupKick.phase);
+    writeUIntProp(out, startupKickFirst, "lastEnd", startupKick.lastEnd);
+    writeFloatProp(out, startupKickFirst, "lastKickSec", startupKick.lastKickSec);
+    writeFloatProp(out, startupKickFirst, "lastPullInSec", startupKick.lastPullInSec);
+    writeFloatProp(out, startupKickFirst, "lastRampSec", startupKick.lastRampSec);
+    writeBoolProp(out, startupKickFirst, "lastRampSlipped", startupKick.lastRampSlipped);
+    writeUIntProp(out, startupKickFirst, "starts", startupKick.starts);
+    writeUIntProp(out, startupKickFirst, "pullIns", startupKick.pullIns);
+    const char* startupArrays[3] = { "timeToLockSec", "learnedKickSec", "learnedRampSec" };
+    const float* startupValues[3] = { startupKick.timeToLockSec, startupKick.learnedKickSec, startupKick.learnedRampSec };
+    for (uint8_t a = 0; a < 3; a++) {
+        beginArrayProp(out, startupKickFirst, startupArrays[a]);
+        bool valueFirst = true;
+        for (uint8_t i = 0; i < 3; i++) {
+            writeComma(out, valueFirst);
+            writeFloatValue(out, startupValues[a][i]);
+        }
+        out.write(']');
+    }
+    out.write('}');
+
+    MotorHealthStatus wear = motor.getHealthStatus();
+    beginObjectProp(out, nestedFirst, "wear");
+    bool wearFirst = true;
+    writeUIntProp(out, wearFirst, "records", wear.records);
+    writeUIntProp(out, wearFirst, "capacity", HEALTH_HISTORY_RECORDS);
+    writeUIntProp(out, wearFirst, "minSessions", HEALTH_TREND_MIN_SESSIONS);
+    writeBoolProp(out, wearFirst, "sessionActive", wear.sessionActive);
+    writeUIntProp(out, wearFirst, "sessionSpeed", wear.sessionSpeed);
+    writeFloatProp(out, wearFirst, "sessionLockedSec", wear.sessionLockedSec);
+    beginArrayProp(out, wearFirst, "speeds");
+    bool wearSpeedsFirst = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        const HealthTrendResult& trend = wear.trend[i];
+        writeComma(out, wearSpeedsFirst);
+        out.write('{');
+        bool speedFirst = true;
+        writeUIntProp(out, speedFirst, "sessions", trend.sessions);
+        writeFloatProp(out, speedFirst, "spanHours", trend.spanHours);
+        writeUIntProp(out, speedFirst, "drift", trend.drift);
+        uint8_t worsening = 0;
+        beginArrayProp(out, speedFirst, "change");
+        bool changeFirst = true;
+        for (uint8_t m = 0; m < HEALTH_METRIC_COUNT; m++) {
+            writeComma(out, changeFirst);
+            writeFloatValue(out, trend.metric[m].change);
+            if (trend.metric[m].worsening) worsening |= (uint8_t)(1 << m);
+        }
+        out.write(']');
+        beginArrayProp(out, speedFirst, "tStat");
+        bool tStatFirst = true;
+        for (uint8_t m = 0; m < HEALTH_METRIC_COUNT; m++) {
+            writeComma(out, tStatFirst);
+            writeFloatValue(out, trend.metric[m].tStat);
+        }
+        out.write(']');
+        writeUIntProp(out, speedFirst, "worsening", worsening);
+        out.write('}');
+    }
+    out.write(']');
+    out.write('}');
+
+    BaseLearnStatus baseLearn = motor.getBaseLearnStatus();
+    beginObjectProp(out, nestedFirst, "baseLearn");
+    bool baseLearnFirst = true;
+    writeBoolProp(out, baseLearnFirst, "enabled", baseLearn.enabled);
+    writeFloatProp(out, baseLearnFirst, "sharedRatio", baseLearn.sharedRatioRpmPerHz);
+    writeFloatProp(out, baseLearnFirst, "sharedPpm", baseLearn.sharedHalfWidthPpm);
+    writeUIntProp(out, baseLearnFirst, "steps", baseLearn.steps);
+    writeUIntProp(out, baseLearnFirst, "rollbacks", baseLearn.rollbacks);
+    beginArrayProp(out, baseLearnFirst, "speeds");
+    bool baseLearnSpeedsFirst = true;
+    for (uint8_t i = 0; i < 3; i++) {
+        const BaseLearnSpeedStatus& speed = baseLearn.speed[i];
+        writeComma(out, baseLearnSpeedsFirst);
+        out.write('{');
+        bool speedFirst = true;
+        writeFloatProp(out, speedFirst, "ratio", speed.ratioRpmPerHz);
+        writeFloatProp(out, speedFirst, "ppm", speed.halfWidthPpm);
+        writeFloatProp(out, speedFirst, "weight", speed.weight);
+        writeFloatProp(out, speedFirst, "anchorHz", speed.anchorHz);
+        writeFloatProp(out, speedFirst, "baseHz", speed.baseHz);
+        writeBoolProp(out, speedFirst, "probation", speed.onProbation);
+        writeUIntProp(out, speedFirst, "last", speed.lastAction);
+        writeBoolProp(out, speedFirst, "shared", speed.lastShared);
+        writeBoolProp(out, speedFirst, "bounded", speed.lastBounded);
+        out.write('}');
+    }
+    out.write(']');
+    out.write('}');
+
+    SensorlessSpeedStatus sensorless = speedFeedback.getSensorlessStatus();
+    beginObjectProp(out, nestedFirst, "sensorless");
+    bool sensorlessFirst = true;
+    writeBoolProp(out, sensorlessFirst, "enabled", sensorless.enabled);
+    writeBoolProp(out, sensorlessFirst, "active", sensorless.active);
+    writeBoolProp(out, sensorlessFirst, "valid", sensorless.valid);
+    writeFloatProp(out, sensorlessFirst, "electricalHz", sensorless.electricalHz);
+    writeFloatProp(out, sensorlessFirst, "driveHz", sensorless.driveHz);
+    writeFloatProp(out, sensorlessFirst, "slipHz", sensorless.slipHz);
+    writeFloatProp(out, sensorlessFirst, "phaseDegrees", sensorless.phaseDegrees);
+    writeFloatProp(out, sensorlessFirst, "amplitude", sensorless.amplitude);
+    writeUIntProp(out, sensorlessFirst, "crossings", sensorless.crossings);
+    writeUIntProp(out, sensorlessFirst, "rejectedCrossings", sensorless.rejectedCrossings);
+    writeUIntProp(out, sensorlessFirst, "overruns", sensorless.overruns);
     out.write('}');
 
     beginObjectProp(out, nestedFirst, "tuning");
@@ -2489,9 +3126,22 @@ void WebInterface::handleSettingsGet() {
     global["motorTopology"] = g.motorTopology;
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
     global["activeBrakingAllowed"] = g.activeBrakingAllowed;
+    global["bridgeDeadTimeNs"] = g.bridgeDeadTimeNs;
+    global["bridgeDeadTimeLagDeg33"] = g.bridgeDeadTimeLagDeg[SPEED_33];
+    global["bridgeDeadTimeLagDeg45"] = g.bridgeDeadTimeLagDeg[SPEED_45];
+    global["bridgeDeadTimeLagDeg78"] = g.bridgeDeadTimeLagDeg[SPEED_78];
 #endif
     global["phaseSlewDegreesPerSecond"] = g.phaseSlewDegreesPerSecond;
     global["gainSlewPercentPerSecond"] = g.gainSlewPercentPerSecond;
+    global["firCutoffHz33"] = g.firCutoffHz[SPEED_33];
+    global["firCutoffHz45"] = g.firCutoffHz[SPEED_45];
+    global["firCutoffHz78"] = g.firCutoffHz[SPEED_78];
+    global["firTransitionHz33"] = g.firTransitionHz[SPEED_33];
+    global["firTransitionHz45"] = g.firTransitionHz[SPEED_45];
+    global["firTransitionHz78"] = g.firTransitionHz[SPEED_78];
+    global["firTaps33"] = g.firTaps[SPEED_33];
+    global["firTaps45"] = g.firTaps[SPEED_45];
+    global["firTaps78"] = g.firTaps[SPEED_78];
     global["maxAmplitude"] = g.maxAmplitude;
     global["softStartCurve"] = g.softStartCurve;
     global["smoothSwitching"] = g.smoothSwitching;
@@ -2541,6 +3191,14 @@ void WebInterface::handleSettingsGet() {
     global["vfMidFreq"] = g.vfMidFreq;
     global["vfMidLevel"] = g.vfMidLevel;
     global["vfBaseFreq"] = g.vfBaseFreq;
+    global["thermalDerateEnabled"] = g.thermalDerateEnabled;
+    global["thermalWindingTauSec"] = g.thermalWindingTauSec;
+    global["thermalFrameTauSec"] = g.thermalFrameTauSec;
+    global["thermalFullScaleRiseC"] = g.thermalFullScaleRiseC;
+    global["thermalWindingShare"] = g.thermalWindingShare;
+    global["thermalDerateStartC"] = g.thermalDerateStartC;
+    global["thermalDerateLimitC"] = g.thermalDerateLimitC;
+    global["thermalMinDerate"] = g.thermalMinDerate;
 #if CLOSED_LOOP_SPEED_ENABLE
     global["closedLoopEnabled"] = g.closedLoopEnabled;
     global["closedLoopControlMode"] = g.closedLoopControlMode;
@@ -2575,6 +3233,21 @@ void WebInterface::handleSettingsGet() {
     global["closedLoopLockTimeoutAction"] = g.closedLoopLockTimeoutAction;
     global["closedLoopAmpRecoveryMode"] = g.closedLoopAmpRecoveryMode;
     global["closedLoopAmpRecoveryDelayMs"] = g.closedLoopAmpRecoveryDelayMs;
+    global["closedLoopSlipAction"] = g.closedLoopSlipAction;
+    global["closedLoopSlipDetectMs"] = g.closedLoopSlipDetectMs;
+    global["closedLoopSlipThresholdPercent"] = g.closedLoopSlipThresholdPercent;
+    global["closedLoopPullOutThresholdPercent"] = g.closedLoopPullOutThresholdPercent;
+    global["closedLoopNotchEnabled"] = g.closedLoopNotchEnabled;
+    global["closedLoopNotchBandwidthHz"] = g.closedLoopNotchBandwidthHz;
+    global["closedLoopNotchMinHz"] = g.closedLoopNotchMinHz;
+    global["closedLoopNotchMaxHz"] = g.closedLoopNotchMaxHz;
+    global["loadStepEnabled"] = g.loadStepEnabled;
+    global["loadStepSlopeRpmPerSec"] = g.loadStepSlopeRpmPerSec;
+    global["loadStepBoostPercent"] = g.loadStepBoostPercent;
+    global["loadStepBoostMs"] = g.loadStepBoostMs;
+    global["adaptiveKickEnabled"] = g.adaptiveKickEnabled;
+    global["kickPullInPercent"] = g.kickPullInPercent;
+    global["baseLearnEnabled"] = g.baseLearnEnabled;
 #endif
     global["bootSpeed"] = g.bootSpeed;
 #if AMP_MONITOR_ENABLE
@@ -2652,14 +3325,27 @@ void WebInterface::handleSettingsPost() {
         setByte(global, "motorTopology", g.motorTopology, MOTOR_TOPOLOGY_CUSTOM, MOTOR_TOPOLOGY_THREE_PHASE);
 #if OUTPUT_STAGE_TYPE == OUTPUT_STAGE_3PWM_BRIDGE
         setBool(global, "activeBrakingAllowed", g.activeBrakingAllowed);
+        setUInt16(global, "bridgeDeadTimeNs", g.bridgeDeadTimeNs, 0, 2000);
+        setFloat(global, "bridgeDeadTimeLagDeg33", g.bridgeDeadTimeLagDeg[SPEED_33], 0.0f, 89.0f);
+        setFloat(global, "bridgeDeadTimeLagDeg45", g.bridgeDeadTimeLagDeg[SPEED_45], 0.0f, 89.0f);
+        setFloat(global, "bridgeDeadTimeLagDeg78", g.bridgeDeadTimeLagDeg[SPEED_78], 0.0f, 89.0f);
 #endif
         setFloat(global, "phaseSlewDegreesPerSecond", g.phaseSlewDegreesPerSecond, 0.0f, 3600.0f);
         setFloat(global, "gainSlewPercentPerSecond", g.gainSlewPercentPerSecond, 0.0f, 1000.0f);
+        setFloat(global, "firCutoffHz33", g.firCutoffHz[SPEED_33], 100.0f, 45000.0f);
+        setFloat(global, "firCutoffHz45", g.firCutoffHz[SPEED_45], 100.0f, 45000.0f);
+        setFloat(global, "firCutoffHz78", g.firCutoffHz[SPEED_78], 100.0f, 45000.0f);
+        setFloat(global, "firTransitionHz33", g.firTransitionHz[SPEED_33], 100.0f, 50000.0f);
+        setFloat(global, "firTransitionHz45", g.firTransitionHz[SPEED_45], 100.0f, 50000.0f);
+        setFloat(global, "firTransitionHz78", g.firTransitionHz[SPEED_78], 100.0f, 50000.0f);
+        setByte(global, "firTaps33", g.firTaps[SPEED_33], FIR_MIN_TAPS, FIR_MAX_TAPS);
+        setByte(global, "firTaps45", g.firTaps[SPEED_45], FIR_MIN_TAPS, FIR_MAX_TAPS);
+        setByte(global, "firTaps78", g.firTaps[SPEED_78], FIR_MIN_TAPS, FIR_MAX_TAPS);
         setByte(global, "maxAmplitude", g.maxAmplitude, 0, 100);
         setByte(global, "softStartCurve", g.softStartCurve, 0, 2);
         setBool(global, "smoothSwitching", g.smoothSwitching);
         setByte(global, "switchRampDuration", g.switchRampDuration, 1, 5);
-        setByte(global, "brakeMode", g.brakeMode, 0, BRAKE_SOFT_STOP);
+        setByte(global, "brakeMode", g.brakeMode, 0, BRAKE_TACH);
         setFloat(global, "brakeDuration", g.brakeDuration, 0.0f, 10.0f);
         setFloat(global, "brakePulseGap", g.brakePulseGap, 0.1f, 2.0f);
         setFloat(global, "brakeStartFreq", g.brakeStartFreq, 10.0f, 200.0f);
@@ -2704,10 +3390,18 @@ void WebInterface::handleSettingsPost() {
         setFloat(global, "vfMidFreq", g.vfMidFreq, 0.0f, 100.0f);
         setByte(global, "vfMidLevel", g.vfMidLevel, 0, 100);
         setFloat(global, "vfBaseFreq", g.vfBaseFreq, MIN_OUTPUT_FREQUENCY_HZ, MAX_OUTPUT_FREQUENCY_HZ);
+        setBool(global, "thermalDerateEnabled", g.thermalDerateEnabled);
+        setFloat(global, "thermalWindingTauSec", g.thermalWindingTauSec, 5.0f, 3600.0f);
+        setFloat(global, "thermalFrameTauSec", g.thermalFrameTauSec, 5.0f, 36000.0f);
+        setFloat(global, "thermalFullScaleRiseC", g.thermalFullScaleRiseC, 5.0f, 200.0f);
+        setByte(global, "thermalWindingShare", g.thermalWindingShare, 0, 90);
+        setFloat(global, "thermalDerateStartC", g.thermalDerateStartC, 1.0f, 150.0f);
+        setFloat(global, "thermalDerateLimitC", g.thermalDerateLimitC, 2.0f, 160.0f);
+        setByte(global, "thermalMinDerate", g.thermalMinDerate, 10, 100);
 #if CLOSED_LOOP_SPEED_ENABLE
         setBool(global, "closedLoopEnabled", g.closedLoopEnabled);
         setByte(global, "closedLoopControlMode", g.closedLoopControlMode, CLOSED_LOOP_CONTROL_MONITOR, CLOSED_LOOP_CONTROL_CORRECT);
-        setByte(global, "closedLoopSensorMode", g.closedLoopSensorMode, CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_QUADRATURE);
+        setByte(global, "closedLoopSensorMode", g.closedLoopSensorMode, CLOSED_LOOP_SENSOR_PULSE, CLOSED_LOOP_SENSOR_LAST);
         setFloat(global, "closedLoopTargetRpm33", g.closedLoopTargetRpm[SPEED_33], 1.0f, 120.0f);
         setFloat(global, "closedLoopTargetRpm45", g.closedLoopTargetRpm[SPEED_45], 1.0f, 120.0f);
         setFloat(global, "closedLoopTargetRpm78", g.closedLoopTargetRpm[SPEED_78], 1.0f, 120.0f);
@@ -2763,6 +3457,21 @@ void WebInterface::handleSettingsPost() {
         setByte(global, "closedLoopLockTimeoutAction", g.closedLoopLockTimeoutAction, CLOSED_LOOP_FAULT_IGNORE, CLOSED_LOOP_FAULT_STOP);
         setByte(global, "closedLoopAmpRecoveryMode", g.closedLoopAmpRecoveryMode, CLOSED_LOOP_AMP_RECOVERY_OFF, CLOSED_LOOP_AMP_RECOVERY_RESTORE);
         setUInt16(global, "closedLoopAmpRecoveryDelayMs", g.closedLoopAmpRecoveryDelayMs, 0, 30000);
+        setByte(global, "closedLoopSlipAction", g.closedLoopSlipAction, CLOSED_LOOP_SLIP_IGNORE, CLOSED_LOOP_SLIP_STOP);
+        setUInt16(global, "closedLoopSlipDetectMs", g.closedLoopSlipDetectMs, 50, 10000);
+        setFloat(global, "closedLoopSlipThresholdPercent", g.closedLoopSlipThresholdPercent, 0.5f, 50.0f);
+        setFloat(global, "closedLoopPullOutThresholdPercent", g.closedLoopPullOutThresholdPercent, 0.0f, 100.0f);
+        setBool(global, "closedLoopNotchEnabled", g.closedLoopNotchEnabled);
+        setFloat(global, "closedLoopNotchBandwidthHz", g.closedLoopNotchBandwidthHz, 0.05f, 2.0f);
+        setFloat(global, "closedLoopNotchMinHz", g.closedLoopNotchMinHz, 0.05f, 20.0f);
+        setFloat(global, "closedLoopNotchMaxHz", g.closedLoopNotchMaxHz, 0.15f, 25.0f);
+        setBool(global, "loadStepEnabled", g.loadStepEnabled);
+        setFloat(global, "loadStepSlopeRpmPerSec", g.loadStepSlopeRpmPerSec, 0.01f, 10.0f);
+        setByte(global, "loadStepBoostPercent", g.loadStepBoostPercent, 0, 50);
+        setUInt16(global, "loadStepBoostMs", g.loadStepBoostMs, 0, 10000);
+        setBool(global, "adaptiveKickEnabled", g.adaptiveKickEnabled);
+        setByte(global, "kickPullInPercent", g.kickPullInPercent, 70, 99);
+        setBool(global, "baseLearnEnabled", g.baseLearnEnabled);
 #endif
         setByte(global, "bootSpeed", g.bootSpeed, 0, 3);
 #if AMP_MONITOR_ENABLE
@@ -2821,7 +3530,7 @@ void WebInterface::handleSettingsPost() {
             setFloat(speed, "startupKickRampDuration", s.startupKickRampDuration, 0.0f, 15.0f);
             setByte(speed, "filterType", s.filterType, FILTER_NONE, FILTER_FIR);
             setFloat(speed, "iirAlpha", s.iirAlpha, 0.01f, 0.99f);
-            setByte(speed, "firProfile", s.firProfile, FIR_GENTLE, FIR_AGGRESSIVE);
+            setByte(speed, "firProfile", s.firProfile, FIR_GENTLE, FIR_CUSTOM);
 #if CLOSED_LOOP_SPEED_ENABLE
             ClosedLoopSpeedTuning& t = g.closedLoopTuning[i];
             setFloat(speed, "closedLoopDeadbandRpm", t.deadbandRpm, 0.0f, 5.0f);
@@ -2957,7 +3666,8 @@ void WebInterface::handleControl() {
     } else if (strcmp(action, "closedLoopReset") == 0) {
         motor.resetClosedLoop();
     } else if (strcmp(action, "closedLoopSetupStart") == 0) {
-        speedFeedback.beginSetupCapture();
+        // A running motor gets counts/rev detection; a stopped one falls back to the manual one-revolution capture.
+        speedFeedback.beginSetupCapture(motor.getSynchronousPlatterRpm());
     } else if (strcmp(action, "closedLoopSetupApply") == 0) {
         SpeedFeedbackSetupStatus setup = speedFeedback.getSetupStatus();
         if (!setup.active || setup.suggestedCountsPerRev == 0) {
@@ -2985,6 +3695,57 @@ void WebInterface::handleControl() {
         }
     } else if (strcmp(action, "closedLoopTuneStop") == 0) {
         motor.cancelClosedLoopTuning();
+    } else if (strcmp(action, "coastDownStart") == 0) {
+        includeCalibration = true;
+        if (!motor.beginCoastDown(calibrationMessage, sizeof(calibrationMessage))) {
+            sendError(409, calibrationMessage);
+            return;
+        }
+    } else if (strcmp(action, "coastDownStop") == 0) {
+        motor.cancelCoastDown();
+    } else if (strcmp(action, "coastDownApply") == 0 || strcmp(action, "coastDownSave") == 0) {
+        includeCalibration = true;
+        if (!motor.applyCoastDownSeeds(calibrationMessage, sizeof(calibrationMessage))) {
+            sendError(409, calibrationMessage);
+            return;
+        }
+        if (strcmp(action, "coastDownSave") == 0 && !settings.save(false, true)) {
+            sendError(500, "Coast-down estimates applied in RAM but could not be saved");
+            return;
+        }
+    } else if (strcmp(action, "wearClear") == 0) {
+        if (!motor.clearHealthHistory()) {
+            sendError(500, "Health history cleared in RAM but the file could not be removed");
+            return;
+        }
+    } else if (strcmp(action, "baseLearnRollback") == 0) {
+        char message[96];
+        if (!motor.rollbackBaseLearning(message, sizeof(message))) {
+            sendError(409, message);
+            return;
+        }
+        if (!settings.save(false, true)) {
+            sendError(500, "Base frequencies restored in RAM but could not be saved");
+            return;
+        }
+    } else if (strcmp(action, "baseLearnClear") == 0) {
+        motor.clearBaseLearning();
+        if (!settings.save(false, true)) {
+            sendError(500, "Base learning cleared in RAM but could not be saved");
+            return;
+        }
+    } else if (strcmp(action, "startupKickClear") == 0) {
+        motor.clearStartupKickLearning();
+        if (!settings.save(false, true)) {
+            sendError(500, "Learned startup kick cleared in RAM but could not be saved");
+            return;
+        }
+    } else if (strcmp(action, "loadStepClear") == 0) {
+        motor.clearLoadStepLearning();
+        if (!settings.save(false, true)) {
+            sendError(500, "Learned load steps cleared in RAM but could not be saved");
+            return;
+        }
     } else if (strcmp(action, "closedLoopBasePreview") == 0) {
         includeCalibration = true;
         if (!motor.getBaseFrequencyCalibration(calibrationCurrentHz, calibrationProposedHz,
@@ -3025,6 +3786,20 @@ void WebInterface::handleControl() {
             return;
         }
         motor.setRelayTestStage(stage);
+    } else if (strcmp(action, "offsetNull") == 0) {
+        char message[96];
+        if (!motor.beginDcOffsetNull(message, sizeof(message))) {
+            sendError(409, message);
+            return;
+        }
+    } else if (strcmp(action, "offsetCancel") == 0) {
+        motor.cancelDcOffsetNull();
+    } else if (strcmp(action, "offsetClear") == 0) {
+        if (motor.isDcOffsetNullActive()) {
+            sendError(409, "Cancel offset nulling first");
+            return;
+        }
+        motor.clearDcOffsetNull();
     } else if (strcmp(action, "relayOff") == 0) {
         if (motor.getRelayTestStageCount() == 0) {
             sendError(409, "Relay test is not available in this output configuration");
@@ -3307,6 +4082,7 @@ void WebInterface::handleDiagnosticsGet() {
     flags["ENABLE_4_CHANNEL_SUPPORT"] = ENABLE_4_CHANNEL_SUPPORT;
     flags["PITCH_CONTROL_ENABLE"] = PITCH_CONTROL_ENABLE;
     flags["CLOSED_LOOP_SPEED_ENABLE"] = CLOSED_LOOP_SPEED_ENABLE;
+    flags["SPEED_DUTY_TRACK_ENABLE"] = SPEED_DUTY_TRACK_ENABLE;
     flags["SERIAL_MONITOR_ENABLE"] = SERIAL_MONITOR_ENABLE;
     flags["SETTINGS_SCHEMA_VERSION"] = SETTINGS_SCHEMA_VERSION;
     flags["NETWORK_CONFIG_VERSION"] = NETWORK_CONFIG_VERSION;
@@ -3336,6 +4112,21 @@ void WebInterface::handleDiagnosticsGet() {
     displayInfo["brightnessControl"] = displayCapabilities.brightnessControl;
     displayInfo["colourPanel"] = displayCapabilities.colourPanel;
 
+#if CLOSED_LOOP_SPEED_ENABLE
+    SpeedFeedbackStatus feedback = speedFeedback.getStatus();
+    JsonObject tachDuty = doc["tachDuty"].to<JsonObject>();
+    tachDuty["tracked"] = feedback.dutyTracked;
+    tachDuty["samples"] = feedback.duty.samples;
+    tachDuty["rejected"] = feedback.duty.rejected;
+    tachDuty["slots"] = feedback.duty.slots;
+    tachDuty["baselineValid"] = feedback.duty.baselineValid;
+    tachDuty["mean"] = feedback.duty.meanDuty;
+    tachDuty["drift"] = feedback.duty.drift;
+    tachDuty["minSlot"] = feedback.duty.minSlotDuty;
+    tachDuty["maxSlot"] = feedback.duty.maxSlotDuty;
+    tachDuty["warnings"] = feedback.duty.warnings;
+#endif
+
     JsonObject pins = doc["pins"].to<JsonObject>();
     pins["PWM A"] = PIN_PWM_PHASE_A;
     pins["PWM B"] = PIN_PWM_PHASE_B;